@@ -0,0 +1,116 @@
+#include "ConstantUploadTracker.h"
+
+// ============================================================================
+// 构造
+// ============================================================================
+ConstantUploadTracker::ConstantUploadTracker(uint32_t frameCount, uint32_t evictAfterFrames)
+    : m_frameCount(frameCount > 0 ? frameCount : 1)
+    , m_evictAfterFrames(evictAfterFrames > 0 ? evictAfterFrames : 1)
+    , m_stamps(m_frameCount)
+{
+}
+
+// ============================================================================
+// 帧边界与槽位回收
+// ============================================================================
+void ConstantUploadTracker::BeginFrame(uint32_t frameIndex)
+{
+    m_frameIndex = frameIndex % m_frameCount;
+    ++m_frameSerial;
+    m_stats = ConstantUploadStats{};
+
+    if (m_frameSerial <= m_evictAfterFrames)
+    {
+        return;
+    }
+
+    const uint64_t oldest = m_frameSerial - m_evictAfterFrames;
+    for (uint32_t slot = 0; slot < (uint32_t)m_slotKeys.size(); ++slot)
+    {
+        if (m_slotKeys[slot] == nullptr || m_slotLastUsed[slot] >= oldest)
+        {
+            continue;
+        }
+
+        // 释放后槽位的旧内容对任何新对象都无效
+        m_keyToSlot.erase(m_slotKeys[slot]);
+        m_slotKeys[slot] = nullptr;
+        for (std::vector<uint64_t>& stamps : m_stamps)
+        {
+            stamps[slot] = 0;
+        }
+        m_freeSlots.push_back(slot);
+    }
+}
+
+uint32_t ConstantUploadTracker::AcquireSlot(const void* key)
+{
+    auto it = m_keyToSlot.find(key);
+    uint32_t slot;
+    if (it != m_keyToSlot.end())
+    {
+        slot = it->second;
+    }
+    else
+    {
+        if (!m_freeSlots.empty())
+        {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        else
+        {
+            slot = (uint32_t)m_slotKeys.size();
+            m_slotKeys.push_back(nullptr);
+            m_slotLastUsed.push_back(0);
+            for (std::vector<uint64_t>& stamps : m_stamps)
+            {
+                stamps.push_back(0);
+            }
+        }
+
+        m_slotKeys[slot] = key;
+        m_keyToSlot[key] = slot;
+    }
+
+    m_slotLastUsed[slot] = m_frameSerial;
+    return slot;
+}
+
+// ============================================================================
+// 脏检查
+// ============================================================================
+bool ConstantUploadTracker::NeedsUpload(uint32_t slot, uint64_t stamp)
+{
+    uint64_t& current = m_stamps[m_frameIndex][slot];
+    if (current == stamp)
+    {
+        ++m_stats.ObjectsSkipped;
+        return false;
+    }
+
+    current = stamp;
+    ++m_stats.ObjectsWritten;
+    return true;
+}
+
+void ConstantUploadTracker::InvalidateFrame(uint32_t frameIndex)
+{
+    std::vector<uint64_t>& stamps = m_stamps[frameIndex % m_frameCount];
+    for (uint64_t& stamp : stamps)
+    {
+        stamp = 0;
+    }
+}
+
+void ConstantUploadTracker::Clear()
+{
+    m_keyToSlot.clear();
+    m_slotKeys.clear();
+    m_slotLastUsed.clear();
+    m_freeSlots.clear();
+    for (std::vector<uint64_t>& stamps : m_stamps)
+    {
+        stamps.clear();
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 每帧常量上传统计
+struct ConstantUploadStats
+{
+    uint32_t ObjectsWritten = 0;   // 常量有变化、实际写入的对象数
+    uint32_t ObjectsSkipped = 0;   // 与该帧副本中已有内容相同而跳过的对象数
+    uint32_t PassWrites = 0;
+    uint64_t BytesWritten = 0;     // 本帧写入上传内存的总字节数
+};
+
+// 对象常量的持久槽位与脏标记。
+// 每个对象占一个固定槽位，常量缓冲按帧上下文各有一份副本（GPU 读上一份时 CPU 写下一份）；
+// 每份副本记录每个槽位上次写入时的版本戳，戳不同才需要重新写入。
+// 不依赖 D3D12，可以在没有 GPU 的环境下按帧模拟，检查写入次数与字节数。
+class ConstantUploadTracker
+{
+public:
+    // evictAfterFrames：连续这么多帧未出现的对象释放槽位（被剔除太久或已删除）
+    ConstantUploadTracker(uint32_t frameCount, uint32_t evictAfterFrames);
+
+    // 切换到 frameIndex 对应的副本，清零统计并回收长期未用的槽位
+    void BeginFrame(uint32_t frameIndex);
+
+    // 取得 key 的槽位（没有则分配），并记为本帧使用
+    uint32_t AcquireSlot(const void* key);
+
+    // 当前副本中该槽位的戳与 stamp 不同则记录 stamp 并返回 true（调用者随后写入）。
+    // stamp 为 0 保留给“未写入”，调用者应保证有效戳非 0。
+    bool NeedsUpload(uint32_t slot, uint64_t stamp);
+
+    // 某份副本的缓冲被换掉（例如扩容）后，其中所有槽位都需要重写
+    void InvalidateFrame(uint32_t frameIndex);
+    // 释放全部槽位
+    void Clear();
+
+    void AddBytesWritten(uint64_t bytes) { m_stats.BytesWritten += bytes; }
+    void CountPassWrite() { ++m_stats.PassWrites; }
+
+    // 当前最大槽位数（副本缓冲至少需要容纳这么多槽位）
+    uint32_t GetSlotCapacity() const { return (uint32_t)m_slotKeys.size(); }
+    size_t GetLiveSlotCount() const { return m_keyToSlot.size(); }
+    const ConstantUploadStats& GetStats() const { return m_stats; }
+
+private:
+    uint32_t m_frameCount;
+    uint32_t m_evictAfterFrames;
+    uint32_t m_frameIndex = 0;
+    uint64_t m_frameSerial = 0;
+
+    std::unordered_map<const void*, uint32_t> m_keyToSlot;
+    std::vector<const void*> m_slotKeys;           // 空槽为 nullptr
+    std::vector<uint64_t> m_slotLastUsed;          // 最近一次使用的帧序号
+    std::vector<uint32_t> m_freeSlots;
+    std::vector<std::vector<uint64_t>> m_stamps;   // [副本][槽位]
+
+    ConstantUploadStats m_stats;
+};
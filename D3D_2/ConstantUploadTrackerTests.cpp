@@ -0,0 +1,182 @@
+#include "SelfTest.h"
+#include "ConstantUploadTracker.h"
+#include "ShaderConstants.h"
+
+// ============================================================================
+// ConstantUploadTracker：按 RecordScenePass 的方式逐帧模拟，检查每帧写入的对象数与字节数
+// ============================================================================
+namespace
+{
+    const uint32_t FrameCount = 3;
+    const uint32_t EvictAfterFrames = 8;
+
+    struct SimObject
+    {
+        uint64_t Version = 1;
+        bool HasTexture = false;
+    };
+
+    // 与 D3DManager 一致：每份帧副本各记一个 pass 戳，对象戳为 (Version << 1) | 是否有纹理，
+    // 每帧还要写一张按绘制顺序排列的槽位下标表
+    struct FrameSimulator
+    {
+        ConstantUploadTracker Tracker{ FrameCount, EvictAfterFrames };
+        uint64_t PassStamps[FrameCount] = {};
+        uint64_t PassVersion = 1;
+        uint32_t Frame = 0;
+
+        uint32_t NextFrameIndex() const { return Frame % FrameCount; }
+
+        ConstantUploadStats Run(const std::vector<SimObject*>& visible)
+        {
+            const uint32_t frameIndex = Frame++ % FrameCount;
+            Tracker.BeginFrame(frameIndex);
+            if (PassStamps[frameIndex] != PassVersion)
+            {
+                PassStamps[frameIndex] = PassVersion;
+                Tracker.CountPassWrite();
+                Tracker.AddBytesWritten(sizeof(PassConstants));
+            }
+            for (SimObject* obj : visible)
+            {
+                const uint32_t slot = Tracker.AcquireSlot(obj);
+                if (Tracker.NeedsUpload(slot, (obj->Version << 1) | (obj->HasTexture ? 1u : 0u)))
+                {
+                    Tracker.AddBytesWritten(sizeof(ObjectConstants));
+                }
+            }
+            Tracker.AddBytesWritten(visible.size() * sizeof(uint32_t));
+            return Tracker.GetStats();
+        }
+    };
+
+    uint64_t TableBytes(size_t count)
+    {
+        return count * sizeof(uint32_t);
+    }
+}
+
+void TestConstantUploadTracker(SelfTestContext& ctx)
+{
+    std::vector<SimObject> objects(100);
+    std::vector<SimObject*> all;
+    for (SimObject& obj : objects)
+    {
+        all.push_back(&obj);
+    }
+
+    FrameSimulator sim;
+
+    // 静态场景：前 FrameCount 帧每份副本各写一遍全部对象和 pass，之后对象常量 0 字节
+    for (uint32_t f = 0; f < FrameCount; ++f)
+    {
+        const ConstantUploadStats stats = sim.Run(all);
+        SELF_CHECK(ctx, stats.ObjectsWritten == 100 && stats.PassWrites == 1);
+        SELF_CHECK(ctx, stats.BytesWritten == 100 * sizeof(ObjectConstants) + sizeof(PassConstants) + TableBytes(100));
+    }
+    for (int f = 0; f < 5; ++f)
+    {
+        const ConstantUploadStats stats = sim.Run(all);
+        SELF_CHECK(ctx, stats.ObjectsWritten == 0 && stats.ObjectsSkipped == 100 && stats.PassWrites == 0);
+        SELF_CHECK(ctx, stats.BytesWritten == TableBytes(100));
+    }
+    SELF_CHECK(ctx, sim.Tracker.GetSlotCapacity() == 100 && sim.Tracker.GetLiveSlotCount() == 100);
+
+    // 移动一个对象：之后每份副本各重写这一个对象一次，然后回到 0
+    objects[42].Version++;
+    for (uint32_t f = 0; f < FrameCount; ++f)
+    {
+        const ConstantUploadStats stats = sim.Run(all);
+        SELF_CHECK(ctx, stats.ObjectsWritten == 1 && stats.ObjectsSkipped == 99);
+        SELF_CHECK(ctx, stats.BytesWritten == sizeof(ObjectConstants) + TableBytes(100));
+    }
+    SELF_CHECK(ctx, sim.Run(all).ObjectsWritten == 0);
+
+    // 每帧都在动的对象：每帧恰好一个对象的字节
+    for (int f = 0; f < 6; ++f)
+    {
+        objects[7].Version++;
+        const ConstantUploadStats stats = sim.Run(all);
+        SELF_CHECK(ctx, stats.ObjectsWritten == 1 && stats.BytesWritten == sizeof(ObjectConstants) + TableBytes(100));
+    }
+    for (uint32_t f = 0; f < FrameCount; ++f)
+    {
+        sim.Run(all);
+    }
+
+    // 只改纹理有无（版本不变）也要重写
+    objects[3].HasTexture = true;
+    SELF_CHECK(ctx, sim.Run(all).ObjectsWritten == 1);
+    for (uint32_t f = 1; f < FrameCount; ++f)
+    {
+        sim.Run(all);
+    }
+
+    // 视图投影变化：只重写 pass 常量，对象常量不动
+    sim.PassVersion++;
+    for (uint32_t f = 0; f < FrameCount; ++f)
+    {
+        const ConstantUploadStats stats = sim.Run(all);
+        SELF_CHECK(ctx, stats.PassWrites == 1 && stats.ObjectsWritten == 0);
+        SELF_CHECK(ctx, stats.BytesWritten == sizeof(PassConstants) + TableBytes(100));
+    }
+    SELF_CHECK(ctx, sim.Run(all).PassWrites == 0);
+
+    // 某份副本的缓冲被换掉（扩容）：只有这份副本重写全部对象
+    sim.Tracker.InvalidateFrame(sim.NextFrameIndex());
+    SELF_CHECK(ctx, sim.Run(all).ObjectsWritten == 100);
+    SELF_CHECK(ctx, sim.Run(all).ObjectsWritten == 0);
+    SELF_CHECK(ctx, sim.Run(all).ObjectsWritten == 0);
+    SELF_CHECK(ctx, sim.Run(all).ObjectsWritten == 0);
+
+    // 短暂被剔除（少于回收阈值）：槽位保留，重新出现时不用重写
+    std::vector<SimObject*> withoutTail(all.begin(), all.begin() + 90);
+    for (uint32_t f = 0; f < EvictAfterFrames - 1; ++f)
+    {
+        sim.Run(withoutTail);
+    }
+    SELF_CHECK(ctx, sim.Tracker.GetLiveSlotCount() == 100);
+    for (uint32_t f = 0; f < FrameCount; ++f)
+    {
+        SELF_CHECK(ctx, sim.Run(all).ObjectsWritten == 0);
+    }
+
+    // 长期被剔除：槽位被回收，重新出现时每份副本都要重写（版本没变也一样）
+    for (uint32_t f = 0; f < EvictAfterFrames + 1; ++f)
+    {
+        sim.Run(withoutTail);
+    }
+    SELF_CHECK(ctx, sim.Tracker.GetLiveSlotCount() == 90);
+    for (uint32_t f = 0; f < FrameCount; ++f)
+    {
+        SELF_CHECK(ctx, sim.Run(all).ObjectsWritten == 10);
+    }
+    SELF_CHECK(ctx, sim.Run(all).ObjectsWritten == 0);
+    SELF_CHECK(ctx, sim.Tracker.GetSlotCapacity() == 100);
+
+    // 回收的槽位给新对象复用：戳与旧主人相同也必须写入，容量不增长
+    {
+        for (uint32_t f = 0; f < EvictAfterFrames + 1; ++f)
+        {
+            sim.Run(withoutTail);
+        }
+        std::vector<SimObject> newcomers(10);
+        std::vector<SimObject*> mixed = withoutTail;
+        for (size_t i = 0; i < newcomers.size(); ++i)
+        {
+            newcomers[i] = objects[90 + i];
+            mixed.push_back(&newcomers[i]);
+        }
+        for (uint32_t f = 0; f < FrameCount; ++f)
+        {
+            SELF_CHECK(ctx, sim.Run(mixed).ObjectsWritten == 10);
+        }
+        SELF_CHECK(ctx, sim.Run(mixed).ObjectsWritten == 0);
+        SELF_CHECK(ctx, sim.Tracker.GetSlotCapacity() == 100 && sim.Tracker.GetLiveSlotCount() == 100);
+    }
+
+    // Clear 释放全部槽位，之后按新对象处理
+    sim.Tracker.Clear();
+    SELF_CHECK(ctx, sim.Tracker.GetLiveSlotCount() == 0 && sim.Tracker.GetSlotCapacity() == 0);
+    SELF_CHECK(ctx, sim.Run(all).ObjectsWritten == 100);
+}
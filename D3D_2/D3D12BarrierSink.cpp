@@ -0,0 +1,39 @@
+#include "D3D12BarrierSink.h"
+#include "d3dx12.h"
+
+void D3D12BarrierSink::Submit(const RenderGraph& graph, const RGBarrier* barriers, size_t count)
+{
+    if (!m_list || count == 0)
+    {
+        return;
+    }
+
+    m_barriers.clear();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const RGBarrier& barrier = barriers[i];
+        ID3D12Resource* resource = static_cast<ID3D12Resource*>(graph.GetUserHandle(barrier.Resource));
+
+        switch (barrier.Type)
+        {
+        case RGBarrier::Transition:
+            m_barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(
+                resource,
+                (D3D12_RESOURCE_STATES)barrier.Before,
+                (D3D12_RESOURCE_STATES)barrier.After));
+            break;
+        case RGBarrier::Aliasing:
+        {
+            ID3D12Resource* before = barrier.AliasBefore != InvalidRGResource ?
+                static_cast<ID3D12Resource*>(graph.GetUserHandle(barrier.AliasBefore)) : nullptr;
+            m_barriers.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(before, resource));
+            break;
+        }
+        case RGBarrier::UnorderedAccess:
+            m_barriers.push_back(CD3DX12_RESOURCE_BARRIER::UAV(resource));
+            break;
+        }
+    }
+
+    m_list->ResourceBarrier((UINT)m_barriers.size(), m_barriers.data());
+}
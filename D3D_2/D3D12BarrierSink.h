@@ -0,0 +1,23 @@
+#pragma once
+
+#include <windows.h>
+#include <d3d12.h>
+#include <vector>
+#include "RenderGraph.h"
+
+// IRenderGraphBarrierSink 的 D3D12 实现：把一个 pass 的全部屏障翻译后一次 ResourceBarrier 提交。
+// 资源的 userHandle 必须是 ID3D12Resource*
+class D3D12BarrierSink : public IRenderGraphBarrierSink
+{
+public:
+    explicit D3D12BarrierSink(ID3D12GraphicsCommandList* list = nullptr) : m_list(list) {}
+
+    // pass 可以在执行中切换后续屏障写入的命令列表（例如收尾列表）
+    void SetCommandList(ID3D12GraphicsCommandList* list) { m_list = list; }
+
+    void Submit(const RenderGraph& graph, const RGBarrier* barriers, size_t count) override;
+
+private:
+    ID3D12GraphicsCommandList* m_list;
+    std::vector<D3D12_RESOURCE_BARRIER> m_barriers;
+};
@@ -0,0 +1,80 @@
+#include "D3D12DescriptorHeapSource.h"
+
+void D3D12DescriptorHeapSource::Initialize(ID3D12Device* device)
+{
+    m_device = device;
+    m_descriptorSize = device ? device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV) : 0;
+}
+
+// ============================================================================
+// 创建/销毁堆
+// ============================================================================
+bool D3D12DescriptorHeapSource::CreateHeap(uint32_t capacity, DescriptorHeapPage& out)
+{
+    if (!m_device)
+    {
+        return false;
+    }
+
+    HeapPair* pair = new HeapPair();
+
+    D3D12_DESCRIPTOR_HEAP_DESC desc = {};
+    desc.NumDescriptors = capacity;
+    desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+    if (FAILED(m_device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&pair->Staging))))
+    {
+        delete pair;
+        return false;
+    }
+
+    desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    if (FAILED(m_device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&pair->Visible))))
+    {
+        delete pair;
+        return false;
+    }
+
+    out.CpuBase = pair->Staging->GetCPUDescriptorHandleForHeapStart().ptr;
+    out.GpuBase = pair->Visible->GetGPUDescriptorHandleForHeapStart().ptr;
+    out.Capacity = capacity;
+    out.Handle = pair;
+    return true;
+}
+
+void D3D12DescriptorHeapSource::DestroyHeap(const DescriptorHeapPage& heap)
+{
+    delete static_cast<HeapPair*>(heap.Handle);
+}
+
+// ============================================================================
+// 复制与发布
+// ============================================================================
+void D3D12DescriptorHeapSource::Copy(const DescriptorHeapPage& dst, uint32_t dstOffset,
+    const DescriptorHeapPage& src, uint32_t srcOffset, uint32_t count)
+{
+    // 只复制暂存堆，迁移结束后由分配器统一 Publish 到可见堆
+    D3D12_CPU_DESCRIPTOR_HANDLE dstHandle = { (SIZE_T)(dst.CpuBase + (uint64_t)dstOffset * m_descriptorSize) };
+    D3D12_CPU_DESCRIPTOR_HANDLE srcHandle = { (SIZE_T)(src.CpuBase + (uint64_t)srcOffset * m_descriptorSize) };
+    m_device->CopyDescriptorsSimple(count, dstHandle, srcHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+}
+
+void D3D12DescriptorHeapSource::Publish(const DescriptorHeapPage& heap, uint32_t offset, uint32_t count)
+{
+    HeapPair* pair = static_cast<HeapPair*>(heap.Handle);
+    if (!pair)
+    {
+        return;
+    }
+
+    D3D12_CPU_DESCRIPTOR_HANDLE dstHandle = pair->Visible->GetCPUDescriptorHandleForHeapStart();
+    dstHandle.ptr += (SIZE_T)offset * m_descriptorSize;
+    D3D12_CPU_DESCRIPTOR_HANDLE srcHandle = { (SIZE_T)(heap.CpuBase + (uint64_t)offset * m_descriptorSize) };
+    m_device->CopyDescriptorsSimple(count, dstHandle, srcHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+}
+
+ID3D12DescriptorHeap* D3D12DescriptorHeapSource::GetShaderVisibleHeap(const DescriptorHeapPage& heap)
+{
+    HeapPair* pair = static_cast<HeapPair*>(heap.Handle);
+    return pair ? pair->Visible.Get() : nullptr;
+}
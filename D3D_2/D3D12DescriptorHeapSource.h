@@ -0,0 +1,35 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl/client.h>
+#include <d3d12.h>
+#include "DescriptorAllocator.h"
+
+// IDescriptorHeapSource 的 D3D12 实现：每个堆由一个 CPU 端暂存堆和一个着色器可见堆组成。
+// 描述符先写入暂存堆（CpuBase），Publish 时复制到可见堆；迁移也从暂存堆读取，
+// 避免从着色器可见堆（可能是写合并内存）回读。
+class D3D12DescriptorHeapSource : public IDescriptorHeapSource
+{
+public:
+    void Initialize(ID3D12Device* device);
+
+    bool CreateHeap(uint32_t capacity, DescriptorHeapPage& out) override;
+    void DestroyHeap(const DescriptorHeapPage& heap) override;
+    uint32_t GetDescriptorSize() const override { return m_descriptorSize; }
+    void Copy(const DescriptorHeapPage& dst, uint32_t dstOffset,
+        const DescriptorHeapPage& src, uint32_t srcOffset, uint32_t count) override;
+    void Publish(const DescriptorHeapPage& heap, uint32_t offset, uint32_t count) override;
+
+    // 绑定到命令列表用的着色器可见堆
+    static ID3D12DescriptorHeap* GetShaderVisibleHeap(const DescriptorHeapPage& heap);
+
+private:
+    struct HeapPair
+    {
+        Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> Staging;
+        Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> Visible;
+    };
+
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    uint32_t m_descriptorSize = 0;
+};
@@ -0,0 +1,52 @@
+#include "D3D12Fence.h"
+
+D3D12Fence::~D3D12Fence()
+{
+    if (m_event)
+    {
+        CloseHandle(m_event);
+        m_event = nullptr;
+    }
+}
+
+bool D3D12Fence::Initialize(ID3D12Device* device, ID3D12CommandQueue* queue)
+{
+    if (FAILED(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence))))
+        return false;
+
+    m_event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (m_event == nullptr)
+        return false;
+
+    m_queue = queue;
+    m_lastSignaled = 0;
+    return true;
+}
+
+uint64_t D3D12Fence::Signal()
+{
+    if (!m_queue)
+    {
+        return m_lastSignaled;
+    }
+
+    ++m_lastSignaled;
+    m_queue->Signal(m_fence.Get(), m_lastSignaled);
+    return m_lastSignaled;
+}
+
+uint64_t D3D12Fence::GetCompletedValue() const
+{
+    return m_fence ? m_fence->GetCompletedValue() : m_lastSignaled;
+}
+
+void D3D12Fence::WaitForValue(uint64_t value)
+{
+    if (!m_fence || m_fence->GetCompletedValue() >= value)
+    {
+        return;
+    }
+
+    m_fence->SetEventOnCompletion(value, m_event);
+    WaitForSingleObject(m_event, INFINITE);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl/client.h>
+#include <d3d12.h>
+#include "FrameSync.h"
+
+// IFence 的 D3D12 实现：ID3D12Fence + 命令队列 + 等待事件
+class D3D12Fence : public IFence
+{
+public:
+    D3D12Fence() = default;
+    ~D3D12Fence();
+
+    D3D12Fence(const D3D12Fence&) = delete;
+    D3D12Fence& operator=(const D3D12Fence&) = delete;
+
+    bool Initialize(ID3D12Device* device, ID3D12CommandQueue* queue);
+
+    uint64_t Signal() override;
+    uint64_t GetCompletedValue() const override;
+    void WaitForValue(uint64_t value) override;
+    uint64_t GetLastSignaledValue() const override { return m_lastSignaled; }
+
+    ID3D12Fence* Get() const { return m_fence.Get(); }
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12Fence> m_fence;
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_queue;
+    HANDLE m_event = nullptr;
+    uint64_t m_lastSignaled = 0;
+};
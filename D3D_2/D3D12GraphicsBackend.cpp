@@ -0,0 +1,331 @@
+#include "D3D12GraphicsBackend.h"
+#include "d3dx12.h"
+
+// ============================================================================
+// 命令列表
+// ============================================================================
+bool D3D12CommandList::Initialize(ID3D12Device* device, uint32_t allocatorCount, const D3D12GraphicsBackend* owner)
+{
+    m_owner = owner;
+    m_allocators.resize(allocatorCount > 0 ? allocatorCount : 1);
+    for (auto& allocator : m_allocators)
+    {
+        if (FAILED(device->CreateCommandAllocator(
+            D3D12_COMMAND_LIST_TYPE_DIRECT,
+            IID_PPV_ARGS(&allocator))))
+            return false;
+    }
+
+    if (FAILED(device->CreateCommandList(
+        0,
+        D3D12_COMMAND_LIST_TYPE_DIRECT,
+        m_allocators[0].Get(),
+        nullptr,
+        IID_PPV_ARGS(&m_list))))
+        return false;
+
+    // 创建时处于录制状态，关闭后由 Begin 统一重置
+    m_list->Close();
+    m_barrierSink.SetCommandList(m_list.Get());
+    return true;
+}
+
+void D3D12CommandList::Begin(uint32_t allocator, GpuHandle pipeline)
+{
+    ID3D12CommandAllocator* commandAllocator = m_allocators[allocator].Get();
+    commandAllocator->Reset();
+    m_list->Reset(commandAllocator, reinterpret_cast<ID3D12PipelineState*>(pipeline));
+}
+
+void D3D12CommandList::End()
+{
+    m_list->Close();
+}
+
+void D3D12CommandList::Submit(const RenderGraph& graph, const RGBarrier* barriers, size_t count)
+{
+    m_barrierSink.Submit(graph, barriers, count);
+}
+
+void D3D12CommandList::SetViewport(const GpuViewport& viewport)
+{
+    D3D12_VIEWPORT vp = { viewport.X, viewport.Y, viewport.Width, viewport.Height, viewport.MinDepth, viewport.MaxDepth };
+    m_list->RSSetViewports(1, &vp);
+}
+
+void D3D12CommandList::SetScissorRect(const GpuRect& rect)
+{
+    D3D12_RECT rc = { rect.Left, rect.Top, rect.Right, rect.Bottom };
+    m_list->RSSetScissorRects(1, &rc);
+}
+
+void D3D12CommandList::SetRenderTarget(uint64_t rtv, uint64_t dsv)
+{
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = { (SIZE_T)rtv };
+    D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle = { (SIZE_T)dsv };
+    m_list->OMSetRenderTargets(1, &rtvHandle, false, &dsvHandle);
+}
+
+void D3D12CommandList::ClearRenderTarget(uint64_t rtv, const float color[4])
+{
+    D3D12_CPU_DESCRIPTOR_HANDLE handle = { (SIZE_T)rtv };
+    m_list->ClearRenderTargetView(handle, color, 0, nullptr);
+}
+
+void D3D12CommandList::ClearDepthStencil(uint64_t dsv, float depth, uint8_t stencil)
+{
+    D3D12_CPU_DESCRIPTOR_HANDLE handle = { (SIZE_T)dsv };
+    m_list->ClearDepthStencilView(handle,
+        D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, depth, stencil, 0, nullptr);
+}
+
+void D3D12CommandList::SetRootSignature(GpuHandle rootSignature)
+{
+    m_list->SetGraphicsRootSignature(reinterpret_cast<ID3D12RootSignature*>(rootSignature));
+}
+
+void D3D12CommandList::SetDescriptorHeap(const DescriptorHeapPage& heap)
+{
+    ID3D12DescriptorHeap* heaps[] = { D3D12DescriptorHeapSource::GetShaderVisibleHeap(heap) };
+    m_list->SetDescriptorHeaps(_countof(heaps), heaps);
+}
+
+void D3D12CommandList::SetPipelineState(GpuHandle pipeline)
+{
+    m_list->SetPipelineState(reinterpret_cast<ID3D12PipelineState*>(pipeline));
+}
+
+void D3D12CommandList::SetRootConstant(uint32_t parameter, uint32_t value)
+{
+    m_list->SetGraphicsRoot32BitConstant(parameter, value, 0);
+}
+
+void D3D12CommandList::SetRootConstantBuffer(uint32_t parameter, uint64_t address)
+{
+    m_list->SetGraphicsRootConstantBufferView(parameter, address);
+}
+
+void D3D12CommandList::SetRootShaderResource(uint32_t parameter, uint64_t address)
+{
+    m_list->SetGraphicsRootShaderResourceView(parameter, address);
+}
+
+void D3D12CommandList::SetRootDescriptorTable(uint32_t parameter, uint64_t gpuDescriptor)
+{
+    D3D12_GPU_DESCRIPTOR_HANDLE handle = { gpuDescriptor };
+    m_list->SetGraphicsRootDescriptorTable(parameter, handle);
+}
+
+void D3D12CommandList::SetVertexBuffer(const GpuVertexBufferView& view)
+{
+    D3D12_VERTEX_BUFFER_VIEW vbv = { view.Address, view.SizeInBytes, view.StrideInBytes };
+    m_list->IASetVertexBuffers(0, 1, &vbv);
+}
+
+void D3D12CommandList::SetIndexBuffer(const GpuIndexBufferView& view)
+{
+    D3D12_INDEX_BUFFER_VIEW ibv = { view.Address, view.SizeInBytes,
+        view.IndexSize == 4 ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT };
+    m_list->IASetIndexBuffer(&ibv);
+}
+
+void D3D12CommandList::SetPrimitiveTopology(GpuTopology)
+{
+    m_list->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+void D3D12CommandList::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount,
+    uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+{
+    m_list->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
+
+void D3D12CommandList::CopyBuffer(const GpuBuffer& dst, uint64_t dstOffset,
+    const GpuBuffer& src, uint64_t srcOffset, uint64_t size)
+{
+    m_list->CopyBufferRegion(reinterpret_cast<ID3D12Resource*>(dst.Handle), dstOffset,
+        reinterpret_cast<ID3D12Resource*>(src.Handle), srcOffset, size);
+}
+
+void D3D12CommandList::WriteTimestamp(uint32_t query)
+{
+    if (ID3D12QueryHeap* heap = m_owner->GetTimestampHeap())
+    {
+        m_list->EndQuery(heap, D3D12_QUERY_TYPE_TIMESTAMP, query);
+    }
+}
+
+void D3D12CommandList::ResolveTimestamps(uint32_t first, uint32_t count)
+{
+    if (ID3D12QueryHeap* heap = m_owner->GetTimestampHeap())
+    {
+        m_list->ResolveQueryData(heap, D3D12_QUERY_TYPE_TIMESTAMP, first, count,
+            m_owner->GetTimestampReadback(), (UINT64)first * sizeof(uint64_t));
+    }
+}
+
+// ============================================================================
+// 后端
+// ============================================================================
+bool D3D12GraphicsBackend::Initialize(ID3D12Device* device, ID3D12CommandQueue* queue)
+{
+    m_device = device;
+    m_queue = queue;
+    if (!m_fence.Initialize(device, queue))
+        return false;
+
+    m_uploadPages.Initialize(device);
+    m_descriptorHeaps.Initialize(device);
+    return true;
+}
+
+IGraphicsCommandList* D3D12GraphicsBackend::CreateCommandList(uint32_t allocatorCount)
+{
+    auto list = std::make_unique<D3D12CommandList>();
+    if (!list->Initialize(m_device.Get(), allocatorCount, this))
+    {
+        return nullptr;
+    }
+    m_lists.push_back(std::move(list));
+    return m_lists.back().get();
+}
+
+bool D3D12GraphicsBackend::CreateBuffer(uint64_t size, GpuMemory memory, GpuBuffer& out)
+{
+    out = GpuBuffer{};
+
+    const bool upload = (memory == GpuMemory::Upload);
+    CD3DX12_HEAP_PROPERTIES heapProps(upload ? D3D12_HEAP_TYPE_UPLOAD : D3D12_HEAP_TYPE_DEFAULT);
+    CD3DX12_RESOURCE_DESC bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+
+    ID3D12Resource* resource = nullptr;
+    if (FAILED(m_device->CreateCommittedResource(
+        &heapProps,
+        D3D12_HEAP_FLAG_NONE,
+        &bufferDesc,
+        upload ? D3D12_RESOURCE_STATE_GENERIC_READ : D3D12_RESOURCE_STATE_COMMON,
+        nullptr,
+        IID_PPV_ARGS(&resource))))
+    {
+        return false;
+    }
+
+    // 上传堆一直映射，与上传页相同
+    if (upload)
+    {
+        void* mapped = nullptr;
+        CD3DX12_RANGE readRange(0, 0);
+        if (FAILED(resource->Map(0, &readRange, &mapped)))
+        {
+            resource->Release();
+            return false;
+        }
+        out.Cpu = static_cast<uint8_t*>(mapped);
+    }
+
+    out.Handle = ToGpuHandle(resource);
+    out.Address = resource->GetGPUVirtualAddress();
+    out.Size = size;
+    return true;
+}
+
+void D3D12GraphicsBackend::DestroyBuffer(const GpuBuffer& buffer)
+{
+    ID3D12Resource* resource = reinterpret_cast<ID3D12Resource*>(buffer.Handle);
+    if (resource)
+    {
+        if (buffer.Cpu)
+        {
+            resource->Unmap(0, nullptr);
+        }
+        resource->Release();
+    }
+}
+
+void D3D12GraphicsBackend::Submit(IGraphicsCommandList* const* lists, uint32_t count)
+{
+    m_submitLists.clear();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        m_submitLists.push_back(D3D12CommandList::Native(lists[i]));
+    }
+    m_queue->ExecuteCommandLists((UINT)m_submitLists.size(), m_submitLists.data());
+}
+
+void D3D12GraphicsBackend::Present()
+{
+    if (m_swapChain)
+    {
+        m_swapChain->Present(0, 0);
+    }
+}
+
+// ============================================================================
+// 时间戳查询
+// ============================================================================
+bool D3D12GraphicsBackend::CreateTimestampQueries(uint32_t count)
+{
+    D3D12_QUERY_HEAP_DESC heapDesc = {};
+    heapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+    heapDesc.Count = count;
+    if (FAILED(m_device->CreateQueryHeap(&heapDesc, IID_PPV_ARGS(&m_timestampHeap))))
+        return false;
+
+    CD3DX12_HEAP_PROPERTIES readbackHeap(D3D12_HEAP_TYPE_READBACK);
+    CD3DX12_RESOURCE_DESC bufferDesc = CD3DX12_RESOURCE_DESC::Buffer((UINT64)count * sizeof(uint64_t));
+    if (FAILED(m_device->CreateCommittedResource(
+        &readbackHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &bufferDesc,
+        D3D12_RESOURCE_STATE_COPY_DEST,
+        nullptr,
+        IID_PPV_ARGS(&m_timestampReadback))))
+    {
+        m_timestampHeap.Reset();
+        return false;
+    }
+
+    m_timestampCount = count;
+    return true;
+}
+
+bool D3D12GraphicsBackend::ReadTimestamps(uint32_t first, uint32_t count, uint64_t* out)
+{
+    if (!m_timestampReadback || first + count > m_timestampCount)
+        return false;
+
+    // 只映射要读的范围；写入范围为空
+    CD3DX12_RANGE readRange((SIZE_T)first * sizeof(uint64_t), (SIZE_T)(first + count) * sizeof(uint64_t));
+    void* mapped = nullptr;
+    if (FAILED(m_timestampReadback->Map(0, &readRange, &mapped)))
+        return false;
+
+    memcpy(out, static_cast<const uint8_t*>(mapped) + readRange.Begin, (size_t)count * sizeof(uint64_t));
+
+    CD3DX12_RANGE writeRange(0, 0);
+    m_timestampReadback->Unmap(0, &writeRange);
+    return true;
+}
+
+uint64_t D3D12GraphicsBackend::GetTimestampFrequency()
+{
+    UINT64 frequency = 0;
+    if (FAILED(m_queue->GetTimestampFrequency(&frequency)))
+        return 0;
+    return frequency;
+}
+
+bool D3D12GraphicsBackend::GetTimestampCalibration(uint64_t& gpuTimestamp, uint64_t& cpuNanoseconds)
+{
+    UINT64 gpu = 0, cpu = 0;
+    if (FAILED(m_queue->GetClockCalibration(&gpu, &cpu)))
+        return false;
+
+    // CPU 值是 QPC 刻度；steady_clock 同样基于 QPC，按相同方式换成纳秒即可对齐
+    LARGE_INTEGER qpcFrequency;
+    QueryPerformanceFrequency(&qpcFrequency);
+    const uint64_t frequency = (uint64_t)qpcFrequency.QuadPart;
+    gpuTimestamp = gpu;
+    cpuNanoseconds = (cpu / frequency) * 1000000000ull + (cpu % frequency) * 1000000000ull / frequency;
+    return true;
+}
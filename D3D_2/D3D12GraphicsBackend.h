@@ -0,0 +1,110 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl/client.h>
+#include <dxgi1_6.h>
+#include <d3d12.h>
+#include <memory>
+#include <vector>
+#include "GraphicsBackend.h"
+#include "D3D12Fence.h"
+#include "D3D12UploadPageSource.h"
+#include "D3D12DescriptorHeapSource.h"
+#include "D3D12BarrierSink.h"
+
+class D3D12GraphicsBackend;
+
+// IGraphicsCommandList 的 D3D12 实现：一条直接命令列表 + 若干命令分配器
+class D3D12CommandList : public IGraphicsCommandList
+{
+public:
+    bool Initialize(ID3D12Device* device, uint32_t allocatorCount, const D3D12GraphicsBackend* owner);
+
+    void Begin(uint32_t allocator, GpuHandle pipeline) override;
+    void End() override;
+
+    void Submit(const RenderGraph& graph, const RGBarrier* barriers, size_t count) override;
+
+    void SetViewport(const GpuViewport& viewport) override;
+    void SetScissorRect(const GpuRect& rect) override;
+    void SetRenderTarget(uint64_t rtv, uint64_t dsv) override;
+    void ClearRenderTarget(uint64_t rtv, const float color[4]) override;
+    void ClearDepthStencil(uint64_t dsv, float depth, uint8_t stencil) override;
+
+    void SetRootSignature(GpuHandle rootSignature) override;
+    void SetDescriptorHeap(const DescriptorHeapPage& heap) override;
+    void SetPipelineState(GpuHandle pipeline) override;
+    void SetRootConstant(uint32_t parameter, uint32_t value) override;
+    void SetRootConstantBuffer(uint32_t parameter, uint64_t address) override;
+    void SetRootShaderResource(uint32_t parameter, uint64_t address) override;
+    void SetRootDescriptorTable(uint32_t parameter, uint64_t gpuDescriptor) override;
+
+    void SetVertexBuffer(const GpuVertexBufferView& view) override;
+    void SetIndexBuffer(const GpuIndexBufferView& view) override;
+    void SetPrimitiveTopology(GpuTopology topology) override;
+    void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount,
+        uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) override;
+
+    void CopyBuffer(const GpuBuffer& dst, uint64_t dstOffset,
+        const GpuBuffer& src, uint64_t srcOffset, uint64_t size) override;
+
+    void WriteTimestamp(uint32_t query) override;
+    void ResolveTimestamps(uint32_t first, uint32_t count) override;
+
+    ID3D12GraphicsCommandList* Get() const { return m_list.Get(); }
+    // 只有 D3D12 才有的路径（纹理上传）直接录制原生列表；调用者须确认后端是 D3D12
+    static ID3D12GraphicsCommandList* Native(IGraphicsCommandList* list)
+    {
+        return static_cast<D3D12CommandList*>(list)->Get();
+    }
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_list;
+    std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> m_allocators;
+    D3D12BarrierSink m_barrierSink;
+    const D3D12GraphicsBackend* m_owner = nullptr;
+};
+
+// IGraphicsBackend 的 D3D12 实现：设备与直接队列由 D3DManager 创建后交给后端，
+// 交换链创建后再通过 SetSwapChain 交给后端用于 Present
+class D3D12GraphicsBackend : public IGraphicsBackend
+{
+public:
+    bool Initialize(ID3D12Device* device, ID3D12CommandQueue* queue);
+    void SetSwapChain(IDXGISwapChain3* swapChain) { m_swapChain = swapChain; }
+
+    IGraphicsCommandList* CreateCommandList(uint32_t allocatorCount) override;
+
+    bool CreateBuffer(uint64_t size, GpuMemory memory, GpuBuffer& out) override;
+    void DestroyBuffer(const GpuBuffer& buffer) override;
+
+    void Submit(IGraphicsCommandList* const* lists, uint32_t count) override;
+    void Present() override;
+
+    IFence& GetFence() override { return m_fence; }
+    IUploadPageSource& GetUploadPageSource() override { return m_uploadPages; }
+    IDescriptorHeapSource& GetDescriptorHeapSource() override { return m_descriptorHeaps; }
+
+    bool CreateTimestampQueries(uint32_t count) override;
+    bool ReadTimestamps(uint32_t first, uint32_t count, uint64_t* out) override;
+    uint64_t GetTimestampFrequency() override;
+    bool GetTimestampCalibration(uint64_t& gpuTimestamp, uint64_t& cpuNanoseconds) override;
+
+    // 时间戳查询堆与回读缓冲（CreateTimestampQueries 之前为空）
+    ID3D12QueryHeap* GetTimestampHeap() const { return m_timestampHeap.Get(); }
+    ID3D12Resource* GetTimestampReadback() const { return m_timestampReadback.Get(); }
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_queue;
+    Microsoft::WRL::ComPtr<IDXGISwapChain3> m_swapChain;
+    D3D12Fence m_fence;
+    D3D12UploadPageSource m_uploadPages;
+    D3D12DescriptorHeapSource m_descriptorHeaps;
+    std::vector<std::unique_ptr<D3D12CommandList>> m_lists;
+    std::vector<ID3D12CommandList*> m_submitLists;
+
+    Microsoft::WRL::ComPtr<ID3D12QueryHeap> m_timestampHeap;
+    Microsoft::WRL::ComPtr<ID3D12Resource> m_timestampReadback;
+    uint32_t m_timestampCount = 0;
+};
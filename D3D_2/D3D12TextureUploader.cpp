@@ -0,0 +1,172 @@
+#include "D3D12TextureUploader.h"
+#include "d3dx12.h"
+#include "FrameProfiler.h"
+#include <vector>
+
+using Microsoft::WRL::ComPtr;
+
+D3D12TextureUploader::~D3D12TextureUploader()
+{
+    WaitIdle();
+}
+
+bool D3D12TextureUploader::Initialize(ID3D12Device* device)
+{
+    D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+    queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+    queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+    if (FAILED(device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_queue))))
+        return false;
+    m_queue->SetName(L"Texture Copy Queue");
+
+    if (!m_fence.Initialize(device, m_queue.Get()))
+        return false;
+
+    for (uint32_t i = 0; i < AllocatorCount; ++i)
+    {
+        if (FAILED(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&m_allocators[i]))))
+            return false;
+    }
+
+    if (FAILED(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, m_allocators[0].Get(), nullptr,
+        IID_PPV_ARGS(&m_list))))
+        return false;
+    m_list->Close();
+
+    m_pageSource.Initialize(device);
+    m_staging = std::make_unique<LinearUploadAllocator>(m_pageSource, StagingPageSize);
+    m_device = device;
+    return true;
+}
+
+bool D3D12TextureUploader::BeginBatch()
+{
+    if (m_recording)
+    {
+        return true;
+    }
+
+    // 顺带回收已完成批次的上传页
+    m_staging->BeginFrame(m_fence.GetCompletedValue());
+
+    ID3D12CommandAllocator* allocator = m_allocators[m_allocatorIndex].Get();
+    m_fence.WaitForValue(m_allocatorFences[m_allocatorIndex]);
+    if (FAILED(allocator->Reset()) || FAILED(m_list->Reset(allocator, nullptr)))
+    {
+        return false;
+    }
+
+    m_recording = true;
+    return true;
+}
+
+bool D3D12TextureUploader::Upload(const DecodedImage& image, uint64_t& texture)
+{
+    PROFILE_SCOPE("RecordTextureUpload");
+
+    if (!m_device || image.Width == 0 || image.Height == 0 || !BeginBatch())
+    {
+        return false;
+    }
+
+    // 没有 mip 链时只有第 0 级
+    const UINT mipLevels = image.Levels.empty() ? 1 : (UINT)image.Levels.size();
+    CD3DX12_RESOURCE_DESC texDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+        GetDxgiFormat(image.Format), image.Width, image.Height, 1, (UINT16)mipLevels);
+    CD3DX12_HEAP_PROPERTIES defaultHeap(D3D12_HEAP_TYPE_DEFAULT);
+
+    ComPtr<ID3D12Resource> resource;
+    HRESULT hr = m_device->CreateCommittedResource(
+        &defaultHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &texDesc,
+        D3D12_RESOURCE_STATE_COMMON,
+        nullptr,
+        IID_PPV_ARGS(&resource));
+    if (FAILED(hr))
+    {
+        return false;
+    }
+
+    // 各级的摆放（GetCopyableFootprints）以 512 字节对齐的起点为基准
+    UINT64 uploadSize = GetRequiredIntermediateSize(resource.Get(), 0, mipLevels);
+    UploadAllocation staging;
+    if (!m_staging->Allocate(uploadSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, staging))
+    {
+        return false;
+    }
+
+    std::vector<D3D12_SUBRESOURCE_DATA> subResources(mipLevels);
+    for (UINT i = 0; i < mipLevels; ++i)
+    {
+        const MipLevel level = image.Levels.empty() ? MipLevel{ image.Width, image.Height, 0 } : image.Levels[i];
+        subResources[i].pData = image.Pixels.data() + level.Offset;
+        subResources[i].RowPitch = (LONG_PTR)GetRowPitch(image.Format, level.Width);
+        subResources[i].SlicePitch = subResources[i].RowPitch * GetRowCount(image.Format, level.Height);
+    }
+    ID3D12Resource* page = static_cast<ID3D12Resource*>(staging.PageHandle);
+    if (UpdateSubresources(m_list.Get(), resource.Get(), page, staging.PageOffset, 0, mipLevels, subResources.data()) == 0)
+    {
+        return false;
+    }
+
+    texture = reinterpret_cast<uint64_t>(resource.Detach());
+    return true;
+}
+
+uint64_t D3D12TextureUploader::Flush()
+{
+    if (!m_recording)
+    {
+        return m_fence.GetLastSignaledValue();
+    }
+
+    m_list->Close();
+    ID3D12CommandList* lists[] = { m_list.Get() };
+    m_queue->ExecuteCommandLists(1, lists);
+    m_recording = false;
+
+    const uint64_t fenceValue = m_fence.Signal();
+    m_allocatorFences[m_allocatorIndex] = fenceValue;
+    m_allocatorIndex = (m_allocatorIndex + 1) % AllocatorCount;
+    m_staging->EndFrame(fenceValue);
+    return fenceValue;
+}
+
+void D3D12TextureUploader::Release(uint64_t texture)
+{
+    TakeTexture(texture);
+}
+
+ComPtr<ID3D12Resource> D3D12TextureUploader::TakeTexture(uint64_t texture)
+{
+    ComPtr<ID3D12Resource> resource;
+    resource.Attach(reinterpret_cast<ID3D12Resource*>(texture));
+    return resource;
+}
+
+DXGI_FORMAT D3D12TextureUploader::GetDxgiFormat(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1:
+        return DXGI_FORMAT_BC1_UNORM;
+    case TextureFormat::BC3:
+        return DXGI_FORMAT_BC3_UNORM;
+    case TextureFormat::BC7:
+        return DXGI_FORMAT_BC7_UNORM;
+    default:
+        return DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+}
+
+void D3D12TextureUploader::WaitIdle()
+{
+    // 录了一半的批次照常提交，保证已交出的纹理句柄都有内容
+    Flush();
+    m_fence.WaitForValue(m_fence.GetLastSignaledValue());
+    if (m_staging)
+    {
+        m_staging->ReleaseAll();
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl/client.h>
+#include <d3d12.h>
+#include <memory>
+#include "TextureLoader.h"
+#include "D3D12Fence.h"
+#include "D3D12UploadPageSource.h"
+#include "UploadAllocator.h"
+
+// ITextureUploader 的 D3D12 实现：独立的拷贝队列、栅栏和命令列表。
+// 纹理在 COMMON 状态创建，拷贝时隐式提升为 COPY_DEST，拷贝队列执行完衰减回 COMMON，
+// 图形队列采样时再隐式提升为 PIXEL_SHADER_RESOURCE，两条队列都不需要显式屏障。
+// 图形队列只在拷贝栅栏完成后才引用这些纹理（TextureLoader 负责），所以队列之间也不需要 Wait。
+// 上传数据不再每张纹理建一个上传缓冲，而是从分页的 LinearUploadAllocator 分配：一个批次相当于一帧，
+// 用过的页挂在 Flush 发出的拷贝栅栏值上，完成后由下一批次回收复用
+class D3D12TextureUploader : public ITextureUploader
+{
+public:
+    D3D12TextureUploader() = default;
+    ~D3D12TextureUploader();
+
+    D3D12TextureUploader(const D3D12TextureUploader&) = delete;
+    D3D12TextureUploader& operator=(const D3D12TextureUploader&) = delete;
+
+    bool Initialize(ID3D12Device* device);
+
+    bool Upload(const DecodedImage& image, uint64_t& texture) override;
+    uint64_t Flush() override;
+    IFence& GetFence() override { return m_fence; }
+    void Release(uint64_t texture) override;
+
+    // 等拷贝队列空闲并释放全部上传页
+    void WaitIdle();
+
+    // 取出纹理句柄持有的引用（调用后句柄失效）
+    static Microsoft::WRL::ComPtr<ID3D12Resource> TakeTexture(uint64_t texture);
+    // 纹理与 SRV 使用的格式
+    static DXGI_FORMAT GetDxgiFormat(TextureFormat format);
+
+private:
+    bool BeginBatch();
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_queue;
+    D3D12Fence m_fence;
+
+    // 分配器轮流使用，复用前等它上次提交的批次完成
+    static const uint32_t AllocatorCount = 3;
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> m_allocators[AllocatorCount];
+    uint64_t m_allocatorFences[AllocatorCount] = {};
+    uint32_t m_allocatorIndex = 0;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_list;
+    bool m_recording = false;
+
+    // 上传页（常见纹理的完整 mip 链放得下，更大的单独建页，回收时销毁）
+    static const uint64_t StagingPageSize = 16ull * 1024 * 1024;
+    D3D12UploadPageSource m_pageSource;
+    std::unique_ptr<LinearUploadAllocator> m_staging;
+};
@@ -0,0 +1,52 @@
+#include "D3D12UploadPageSource.h"
+#include "d3dx12.h"
+
+// ============================================================================
+// 创建/销毁上传页
+// ============================================================================
+bool D3D12UploadPageSource::CreatePage(uint64_t size, UploadPage& out)
+{
+    if (!m_device)
+    {
+        return false;
+    }
+
+    CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
+    CD3DX12_RESOURCE_DESC bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+
+    ID3D12Resource* resource = nullptr;
+    if (FAILED(m_device->CreateCommittedResource(
+        &heapProps,
+        D3D12_HEAP_FLAG_NONE,
+        &bufferDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&resource))))
+    {
+        return false;
+    }
+
+    // 上传堆可以一直映射，CPU 写入后 GPU 直接读取
+    void* mapped = nullptr;
+    if (FAILED(resource->Map(0, nullptr, &mapped)))
+    {
+        resource->Release();
+        return false;
+    }
+
+    out.CpuBase = static_cast<uint8_t*>(mapped);
+    out.GpuBase = resource->GetGPUVirtualAddress();
+    out.Size = size;
+    out.Handle = resource;
+    return true;
+}
+
+void D3D12UploadPageSource::DestroyPage(const UploadPage& page)
+{
+    ID3D12Resource* resource = static_cast<ID3D12Resource*>(page.Handle);
+    if (resource)
+    {
+        resource->Unmap(0, nullptr);
+        resource->Release();
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl/client.h>
+#include <d3d12.h>
+#include "UploadAllocator.h"
+
+// IUploadPageSource 的 D3D12 实现：每页是一个上传堆上的提交资源，创建后一直保持映射
+class D3D12UploadPageSource : public IUploadPageSource
+{
+public:
+    void Initialize(ID3D12Device* device) { m_device = device; }
+
+    bool CreatePage(uint64_t size, UploadPage& out) override;
+    void DestroyPage(const UploadPage& page) override;
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+};
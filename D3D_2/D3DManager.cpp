@@ -1,18 +1,22 @@
 #include "D3DManager.h"
 #include "PrimitiveShape.h"
+#include "FrameProfiler.h"
 #include <comdef.h>
 #include"TransformDialog.h"
-#include <wincodec.h>
-//#include <commctrl.h> // ӹã˴ɲ
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+//#include <commctrl.h> // 若后续加工具条可用；此处可不加
 
-#pragma comment(lib, "windowscodecs.lib")
 #pragma comment(lib, "dxguid.lib")
 
 
 using namespace DirectX;
 
 // ============================================================================
-// 캯
+// 构造函数和析构函数
 // ============================================================================
 D3DManager::D3DManager()
     : m_hWnd(nullptr)
@@ -32,13 +36,15 @@ D3DManager::~D3DManager()
 }
 
 // ============================================================================
-// ʼ D3D12
+// 初始化 D3D12
 // ============================================================================
 bool D3DManager::InitD3D(HWND hWnd, int width, int height)
 {
     m_hWnd = hWnd;
     m_clientWidth = width;
     m_clientHeight = height;
+    m_backBufferWidth = width;
+    m_backBufferHeight = height;
 
     if (!CreateDevice()) return false;
     if (!CreateCommandObjects()) return false;
@@ -47,89 +53,385 @@ bool D3DManager::InitD3D(HWND hWnd, int width, int height)
     if (!CreateRenderTargets()) return false;
     if (!CreateDepthStencil()) return false;
 
-    m_commandList->Close();
-    ID3D12CommandList* cmdsLists[] = { m_commandList.Get() };
-    m_commandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
-    FlushCommandQueue();
-
+    // 着色器与 PSO 优先从磁盘缓存取，记录耗时以便对比冷/热缓存的启动时间
+    auto pipelineStart = std::chrono::steady_clock::now();
     if (!CompileShaders()) return false;
     if (!BuildRootSignature()) return false;
     if (!BuildPSO()) return false;
+    double pipelineMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pipelineStart).count();
+
+    char cacheLog[160];
+    sprintf_s(cacheLog, "Shader cache: %u hit / %u miss, pipeline cache: %u hit / %u miss, %.1f ms\n",
+        m_shaderCache->GetHitCount(), m_shaderCache->GetMissCount(),
+        m_pipelineCache->GetHitCount(), m_pipelineCache->GetMissCount(), pipelineMs);
+    OutputDebugStringA(cacheLog);
+
+    // 本次没有用到的条目可能属于另一个构建或正在运行的另一个实例，只删长期无人读写的和旧格式的
+    const std::chrono::hours maxAge(24 * CacheEntryMaxAgeDays);
+    m_shaderCache->RemoveUnused(maxAge);
+    m_pipelineCache->RemoveUnused(maxAge);
+    if (!BuildConstantBuffers()) return false;
+    if (!BuildShapeGeometry()) return false;
+    if (!CreateDefaultTexture()) return false;
+
+    SetViewport(width, height);
+    return true;
+}
+
+bool D3DManager::InitHeadless(int width, int height)
+{
+    m_clientWidth = width;
+    m_clientHeight = height;
+    m_backBufferWidth = width;
+    m_backBufferHeight = height;
+
+    auto backend = std::make_unique<NullGraphicsBackend>();
+    m_nullBackend = backend.get();
+    m_backend = std::move(backend);
+    if (!CreateFrameResources()) return false;
+
+    // 没有根签名和 PSO，录制时用编号代替
+    m_rootSignatureHandle = 1;
+    for (uint32_t v = 0; v < ShaderVariant::VariantCount; ++v)
+    {
+        m_pipelineHandles[v] = v + 1;
+    }
+
     if (!BuildConstantBuffers()) return false;
     if (!BuildShapeGeometry()) return false;
     if (!CreateDefaultTexture()) return false;
 
-    m_screenViewport.TopLeftX = 0;
-    m_screenViewport.TopLeftY = 0;
+    SetViewport(width, height);
+    return true;
+}
+
+void D3DManager::SetViewport(int width, int height)
+{
+    m_screenViewport.X = 0.0f;
+    m_screenViewport.Y = 0.0f;
     m_screenViewport.Width = static_cast<float>(width);
     m_screenViewport.Height = static_cast<float>(height);
     m_screenViewport.MinDepth = 0.0f;
     m_screenViewport.MaxDepth = 1.0f;
 
     m_scissorRect = { 0, 0, width, height };
-
-    return true;
 }
 
-bool D3DManager::LoadTextureForObject(SceneObject* obj)
+void D3DManager::LoadTextureForObject(SceneObject* obj)
 {
     if (!obj)
     {
-        return false;
+        return;
     }
 
-    const std::wstring& path = obj->GetTexturePath();
+    // 纹理创建要用命令列表，交给渲染线程；路径按值捕获，之后对象再被编辑也不受影响
+    const SceneObject* key = obj;
+    std::wstring path = obj->GetTexturePath();
+    PostRenderCommand([this, key, path]()
+    {
+        LoadTexture(key, path);
+    });
+}
+
+bool D3DManager::LoadTexture(const SceneObject* key, const std::wstring& path)
+{
+    PROFILE_SCOPE("LoadTexture");
+
     if (path.empty())
     {
-        ReleaseTexture(obj);
+        DestroyTexture(key);
         return true;
     }
 
-    int srvIndex = 0;
-    bool newIndex = false;
-    auto it = m_objectSrvIndex.find(obj);
-    if (it != m_objectSrvIndex.end())
+    // 录制后端没有纹理上传
+    if (!m_textureLoader || !m_textureUploader)
     {
-        srvIndex = it->second;
+        return false;
     }
-    else
+
+    // 同一文件（规范路径 + 大小 + 修改时间）只解码、上传一次，所有对象共用纹理与 SRV
+    std::wstring cacheKey;
+    if (!MakeTextureCacheKey(path, cacheKey))
+    {
+        return false;
+    }
+
+    bool created = false;
+    const TextureCacheId id = m_textureCache.Acquire(cacheKey, created);
+    // 同一对象之前的未完成请求作废（对象继续显示当前纹理，直到新纹理驻留）
+    ReleasePendingTexture(key);
+    if (m_textureCache.Find(id)->Resident)
+    {
+        SetObjectTexture(key, id);
+        return true;
+    }
+
+    m_objectPendingTextures[key] = id;
+    if (created)
+    {
+        // 先只加载较粗的级，尽快有图可用；之后由流式驻留按屏幕尺寸换级
+        m_texturePaths[id] = path;
+        m_textureLoader->Request(id, path, m_textureStreamer.GetMinResidentSize());
+    }
+    return true;
+}
+
+void D3DManager::SetTextureStreamingBudget(uint64_t bytes)
+{
+    PostRenderCommand([this, bytes]()
+    {
+        m_textureStreamer.SetBudget(bytes);
+    });
+}
+
+void D3DManager::UpdateTextureLoads()
+{
+    if (!m_textureLoader || !m_textureUploader)
+    {
+        return;
+    }
+
+    m_loadedTextures.clear();
+    m_textureLoader->Update(*m_textureUploader, m_loadedTextures);
+    m_frameTextureUploads += m_textureLoader->GetLastUploadCount();
+    m_frameTextureUploadBytes += m_textureLoader->GetLastUploadBytes();
+
+    for (const TextureLoadResult& result : m_loadedTextures)
     {
-        newIndex = true;
-        if (!m_freeSrvIndices.empty())
+        const TextureCacheId id = (TextureCacheId)result.Key;
+        const TextureCacheEntry* entry = m_textureCache.Find(id);
+        if (entry && entry->Resident)
         {
-            srvIndex = m_freeSrvIndices.back();
-            m_freeSrvIndices.pop_back();
+            InstallStreamedTexture(id, result);
+            continue;
         }
-        else
+
+        const TextureCacheId resident = result.Succeeded ? InstallTexture(id, result) : InvalidTextureCacheId;
+        if (resident == InvalidTextureCacheId)
+        {
+            // 解码或创建失败：等待它的对象保留原来的纹理
+            OutputDebugStringA("Texture load failed\n");
+        }
+        else if (resident == id && m_textureCache.Find(id))
         {
-            srvIndex = m_nextSrvIndex++;
+            m_textureStreamer.Register(id, result.Format, result.SourceWidth, result.SourceHeight,
+                result.SourceMipLevels, result.FirstMip);
         }
 
-        if (srvIndex >= (int)MaxTextureCount)
+        // 等待这个条目的对象换上纹理。内容与已驻留的纹理相同时条目被合并，引用已随之转到 resident
+        for (auto it = m_objectPendingTextures.begin(); it != m_objectPendingTextures.end();)
         {
-            return false;
+            if (it->second != id)
+            {
+                ++it;
+                continue;
+            }
+
+            const SceneObject* key = it->first;
+            it = m_objectPendingTextures.erase(it);
+            if (resident != InvalidTextureCacheId)
+            {
+                SetObjectTexture(key, resident);
+            }
+            else
+            {
+                ReleaseTextureReference(id);
+            }
         }
-        m_objectSrvIndex[obj] = srvIndex;
+    }
+}
+
+TextureCacheId D3DManager::InstallTexture(TextureCacheId id, const TextureLoadResult& result)
+{
+    ComPtr<ID3D12Resource> texture;
+    DescriptorRangeId range = InvalidDescriptorRange;
+    if (!CreateTextureView(result, texture, range))
+    {
+        return InvalidTextureCacheId;
+    }
+    return m_textureCache.SetResident(id, reinterpret_cast<uint64_t>(texture.Detach()), range, result.Bytes, result.ContentHash);
+}
+
+void D3DManager::InstallStreamedTexture(TextureCacheId id, const TextureLoadResult& result)
+{
+    // 失败时保留当前纹理，之后不再为它换级
+    if (!result.Succeeded)
+    {
+        m_textureStreamer.OnLoadFailed(id);
+        return;
+    }
+    // 文件在登记后被改写时内容对不上，新结果的级号没有意义（拷贝已完成、从未被采样，可以直接释放）
+    if (result.ContentHash != m_textureCache.Find(id)->ContentHash)
+    {
+        D3D12TextureUploader::TakeTexture(result.Texture);
+        m_textureStreamer.OnLoadFailed(id);
+        return;
     }
 
     ComPtr<ID3D12Resource> texture;
-    if (!CreateTextureFromFile(path, texture, GetSrvCpuHandle(srvIndex)))
+    DescriptorRangeId range = InvalidDescriptorRange;
+    if (!CreateTextureView(result, texture, range))
+    {
+        m_textureStreamer.OnLoadFailed(id);
+        return;
+    }
+
+    // 旧纹理与旧描述符可能仍被在途帧使用，由释放回调延迟回收
+    m_textureStreamer.OnLoaded(id, result.FirstMip);
+    if (!m_textureCache.UpdateResident(id, reinterpret_cast<uint64_t>(texture.Detach()), range, result.Bytes))
+    {
+        return;
+    }
+    for (const auto& pair : m_objectTextures)
     {
-        if (newIndex)
+        if (pair.second == id)
         {
-            m_objectSrvIndex.erase(obj);
-            m_freeSrvIndices.push_back(srvIndex);
+            m_objectSrvRanges[pair.first] = range;
         }
+    }
+}
+
+bool D3DManager::CreateTextureView(const TextureLoadResult& result, ComPtr<ID3D12Resource>& texture, DescriptorRangeId& range)
+{
+    texture = D3D12TextureUploader::TakeTexture(result.Texture);
+
+    // 堆放不下时分配器会迁移到更大的堆，新堆在下一次录制时绑定
+    if (!m_srvAllocator->AllocatePersistent(1, range))
+    {
+        range = InvalidDescriptorRange;
         return false;
     }
 
-    m_objectTextures[obj] = texture;
+    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    srvDesc.Format = D3D12TextureUploader::GetDxgiFormat(result.Format);
+    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+    srvDesc.Texture2D.MipLevels = result.MipLevels ? result.MipLevels : 1;
+    m_d3dDevice->CreateShaderResourceView(texture.Get(), &srvDesc, GetSrvCpuHandle(m_srvAllocator->GetOffset(range)));
+    m_srvAllocator->Publish(range);
     return true;
 }
 
+void D3DManager::SetObjectTexture(const SceneObject* key, TextureCacheId id)
+{
+    // 接管调用者的一份引用；换下的旧条目放掉引用（旧描述符可能仍被在途帧引用，由缓存延迟回收）
+    const DescriptorRangeId range = m_textureCache.Find(id)->View;
+    auto it = m_objectTextures.find(key);
+    if (it != m_objectTextures.end())
+    {
+        const TextureCacheId previous = it->second;
+        it->second = id;
+        ReleaseTextureReference(previous);
+    }
+    else
+    {
+        m_objectTextures[key] = id;
+    }
+    m_objectSrvRanges[key] = range;
+}
+
+void D3DManager::ReleasePendingTexture(const SceneObject* key)
+{
+    auto it = m_objectPendingTextures.find(key);
+    if (it != m_objectPendingTextures.end())
+    {
+        const TextureCacheId id = it->second;
+        m_objectPendingTextures.erase(it);
+        ReleaseTextureReference(id);
+    }
+}
+
+void D3DManager::ReleaseTextureReference(TextureCacheId id)
+{
+    // 还没加载完就没人要了：取消加载
+    if (m_textureCache.Release(id) && m_textureLoader)
+    {
+        m_textureLoader->Cancel(id);
+    }
+}
+
+void D3DManager::ReleaseCachedTexture(uint64_t texture, uint32_t view)
+{
+    // 缓存淘汰/合并掉的纹理：在途帧可能仍在采样它和它的描述符，等栅栏完成后再回收
+    ComPtr<ID3D12Resource> resource = D3D12TextureUploader::TakeTexture(texture);
+    const DescriptorRangeId range = view;
+    m_frameRing->DeferRelease([this, resource, range]() mutable
+    {
+        resource.Reset();
+        m_srvAllocator->FreePersistent(range);
+    });
+}
+
+void D3DManager::OnTextureErased(TextureCacheId id)
+{
+    // 被淘汰或合并掉的条目：不再换级，在途的换级请求作废
+    m_textureStreamer.Unregister(id);
+    m_texturePaths.erase(id);
+    if (m_textureLoader)
+    {
+        m_textureLoader->Cancel(id);
+    }
+}
+
+void D3DManager::UpdateTextureStreaming(const RenderSnapshot& snapshot)
+{
+    m_frameStreamRequests = 0;
+    if (!m_textureLoader || !m_textureUploader)
+    {
+        return;
+    }
+    PROFILE_SCOPE("TextureStreaming");
+
+    // 投影尺寸按包围球直径估计，距离取球面最近处（宁可偏清晰）；proj._22 = 1 / tan(fovY / 2)
+    const float nearZ = 1.0f;   // 与 UpdateCamera 中的投影参数一致
+    const float pixelsPerUnit = snapshot.Proj._22 * m_screenViewport.Height * 0.5f;
+    const XMVECTOR eye = XMLoadFloat3(&snapshot.Pass.EyePosW);
+    m_textureStreamer.BeginFrame(++m_streamFrame);
+    for (const RenderItem* item : m_visibleItems)
+    {
+        auto it = m_objectTextures.find(item->Key);
+        if (it == m_objectTextures.end() || !SamplesTexture(*item, true))
+        {
+            continue;
+        }
+        const float distance = XMVectorGetX(XMVector3Length(XMLoadFloat3(&item->Position) - eye)) - item->BoundingRadius;
+        const float depth = distance > nearZ ? distance : nearZ;
+        m_textureStreamer.ReportUsage(it->second, 2.0f * item->BoundingRadius * pixelsPerUnit / depth);
+    }
+
+    m_streamRequests.clear();
+    m_textureStreamer.Update(m_streamRequests);
+    for (const TextureStreamRequest& request : m_streamRequests)
+    {
+        if (request.Cancel)
+        {
+            m_textureLoader->Cancel(request.Id);
+            continue;
+        }
+        auto itPath = m_texturePaths.find(request.Id);
+        if (itPath != m_texturePaths.end())
+        {
+            m_textureLoader->Request(request.Id, itPath->second, request.MaxSize);
+        }
+        else
+        {
+            m_textureStreamer.OnLoadFailed(request.Id);
+        }
+    }
+    m_frameStreamRequests = (uint32_t)m_streamRequests.size();
+}
+
 bool D3DManager::CreateDefaultTexture()
 {
-    //  1x1 ɫΪռλ
+    // 录制后端没有纹理：槽位照常分配和绑定，只是不写描述符
+    if (!m_d3dDevice)
+    {
+        m_srvAllocator->Publish(m_defaultSrv);
+        return true;
+    }
+
+    // 创建 1x1 白色纹理作为占位符
     UINT color = 0xFFFFFFFF;
 
     CD3DX12_RESOURCE_DESC texDesc = CD3DX12_RESOURCE_DESC::Tex2D(
@@ -167,19 +469,23 @@ bool D3DManager::CreateDefaultTexture()
     subResource.RowPitch = sizeof(UINT);
     subResource.SlicePitch = subResource.RowPitch;
 
-    m_commandAllocator->Reset();
-    m_commandList->Reset(m_commandAllocator.Get(), nullptr);
+    m_commandList->Begin(ImmediateAllocator, NullGpuHandle);
 
-    UpdateSubresources(m_commandList.Get(), m_defaultTexture.Get(), uploadBuffer.Get(), 0, 0, 1, &subResource);
-    auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-        m_defaultTexture.Get(),
-        D3D12_RESOURCE_STATE_COPY_DEST,
-        D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-    m_commandList->ResourceBarrier(1, &barrier);
+    RenderGraph graph;
+    RGResource target = graph.Import("DefaultTexture",
+        ResourceState::CopyDest, ResourceState::PixelShaderResource, m_defaultTexture.Get());
+    uint32_t upload = graph.AddPass("Upload", [&]()
+    {
+        UpdateSubresources(D3D12CommandList::Native(m_commandList), m_defaultTexture.Get(), uploadBuffer.Get(), 0, 0, 1, &subResource);
+    });
+    graph.Write(upload, target, ResourceState::CopyDest, true);
+    graph.Compile();
+
+    graph.Execute(*m_commandList);
+    graph.SubmitFinalBarriers(*m_commandList);
 
-    m_commandList->Close();
-    ID3D12CommandList* cmdsLists[] = { m_commandList.Get() };
-    m_commandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+    m_commandList->End();
+    m_backend->Submit(&m_commandList, 1);
     FlushCommandQueue();
 
     D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
@@ -189,27 +495,28 @@ bool D3DManager::CreateDefaultTexture()
     srvDesc.Texture2D.MostDetailedMip = 0;
     srvDesc.Texture2D.MipLevels = 1;
 
-    m_d3dDevice->CreateShaderResourceView(m_defaultTexture.Get(), &srvDesc, GetSrvCpuHandle(0));
+    m_d3dDevice->CreateShaderResourceView(m_defaultTexture.Get(), &srvDesc, GetSrvCpuHandle(m_srvAllocator->GetOffset(m_defaultSrv)));
+    m_srvAllocator->Publish(m_defaultSrv);
 
     return true;
 }
 
 void D3DManager::MoveCamera(float dx, float dy, float dz)
 {
-    // dx, dy, dz ʾֲϵеλƣ
-   // x:  (+x)y:  (+y)z: ǰ (+z)
+    // dx, dy, dz 表示相机局部坐标系中的位移：
+   // x: 右 (+x)，y: 上 (+y)，z: 前 (+z)
 
-   // ǰ
+   // 当前相机参数
     XMVECTOR eye = XMLoadFloat3(&m_eyePos);
     XMVECTOR target = XMLoadFloat3(&m_lookAt);
     XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
 
-    // ġǰҡϡϵ
-    XMVECTOR forward = XMVector3Normalize(target - eye);            // ǰ
-    XMVECTOR right = XMVector3Normalize(XMVector3Cross(up, forward)); // ҷ
-    XMVECTOR camUp = XMVector3Normalize(XMVector3Cross(forward, right)); // Ϸ
+    // 计算相机的“前、右、上”方向（世界坐标系）
+    XMVECTOR forward = XMVector3Normalize(target - eye);            // 相机前方向
+    XMVECTOR right = XMVector3Normalize(XMVector3Cross(up, forward)); // 相机右方向
+    XMVECTOR camUp = XMVector3Normalize(XMVector3Cross(forward, right)); // 正交化后的上方向
 
-    // ݾֲλϳλ
+    // 根据局部位移组合成世界位移
     XMVECTOR delta = XMVectorZero();
     if (dx != 0.0f)
     {
@@ -224,42 +531,68 @@ void D3DManager::MoveCamera(float dx, float dy, float dz)
         delta += forward * dz;
     }
 
-    //  eye  lookAt߷򲻱䣩
+    // 更新 eye 和 lookAt（保持视线方向不变）
     eye += delta;
     target += delta;
 
     XMStoreFloat3(&m_eyePos, eye);
     XMStoreFloat3(&m_lookAt, target);
+    m_sceneDirty = true;
 }
 
 void D3DManager::DeleteSelectedObject()
 {
-    if (!m_selectedObject)
+    if (!m_selectedObject && !m_selection.Any())
     {
         return;
     }
 
-    //  vector ɾѡж
-    for (auto it = m_sceneObjects.begin(); it != m_sceneObjects.end(); ++it)
+    // 按选中位集一次性压缩 vector（保持其余对象顺序）
+    size_t write = 0;
+    for (size_t i = 0; i < m_sceneObjects.size(); ++i)
     {
-        if (it->get() == m_selectedObject)
+        SceneObject* obj = m_sceneObjects[i].get();
+        if (m_selection.Test(i) || obj == m_selectedObject)
+        {
+            ReleaseTexture(obj);
+
+            auto itHandle = m_spatialHandles.find(obj);
+            if (itHandle != m_spatialHandles.end())
+            {
+                m_spatialGrid.Remove(itHandle->second);
+                m_spatialHandles.erase(itHandle);
+            }
+
+            auto itBroadphase = m_broadphaseHandles.find(obj);
+            if (itBroadphase != m_broadphaseHandles.end())
+            {
+                m_broadphase.Remove(itBroadphase->second);
+                m_broadphaseHandles.erase(itBroadphase);
+            }
+            continue;
+        }
+
+        if (write != i)
         {
-            ReleaseTexture(it->get());
-            m_sceneObjects.erase(it);
-            break;
+            m_sceneObjects[write] = std::move(m_sceneObjects[i]);
+            m_sceneObjects[write]->SetSceneIndex((uint32_t)write);
         }
+        ++write;
     }
+    m_sceneObjects.resize(write);
 
+    m_selection.Clear();
     m_selectedObject = nullptr;
+    m_sceneDirty = true;
 }
 
 // ============================================================================
-// 豸
+// 创建设备
 // ============================================================================
 bool D3DManager::CreateDevice()
 {
 #if defined(DEBUG) || defined(_DEBUG)
-    // õԲ
+    // 启用调试层
     ComPtr<ID3D12Debug> debugController;
     if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&debugController))))
     {
@@ -267,18 +600,18 @@ bool D3DManager::CreateDevice()
     }
 #endif
 
-    //  DXGI Factory
+    // 创建 DXGI Factory
     if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&m_dxgiFactory))))
         return false;
 
-    // ԴӲ豸
+    // 尝试创建硬件设备
     HRESULT hardwareResult = D3D12CreateDevice(
         nullptr,
         D3D_FEATURE_LEVEL_11_0,
         IID_PPV_ARGS(&m_d3dDevice)
     );
 
-    // ʧܣʹ WARP 豸
+    // 如果失败，使用 WARP 设备
     if (FAILED(hardwareResult))
     {
         ComPtr<IDXGIAdapter> pWarpAdapter;
@@ -293,15 +626,7 @@ bool D3DManager::CreateDevice()
         }
     }
 
-    //  Fence
-    if (FAILED(m_d3dDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence))))
-        return false;
-
-    m_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-    if (m_fenceEvent == nullptr)
-        return false;
-
-    // ѯС
+    // 查询描述符大小
     m_rtvDescriptorSize = m_d3dDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
     m_dsvDescriptorSize = m_d3dDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
     m_cbvSrvUavDescriptorSize = m_d3dDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
@@ -310,11 +635,11 @@ bool D3DManager::CreateDevice()
 }
 
 // ============================================================================
-// 
+// 创建命令对象
 // ============================================================================
 bool D3DManager::CreateCommandObjects()
 {
-    // 
+    // 创建命令队列
     D3D12_COMMAND_QUEUE_DESC queueDesc = {};
     queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
     queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
@@ -322,32 +647,90 @@ bool D3DManager::CreateCommandObjects()
     if (FAILED(m_d3dDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_commandQueue))))
         return false;
 
-    // 
-    if (FAILED(m_d3dDevice->CreateCommandAllocator(
-        D3D12_COMMAND_LIST_TYPE_DIRECT,
-        IID_PPV_ARGS(&m_commandAllocator))))
+    // D3D12 后端：栅栏、上传页、描述符堆与命令列表都由它创建
+    auto backend = std::make_unique<D3D12GraphicsBackend>();
+    if (!backend->Initialize(m_d3dDevice.Get(), m_commandQueue.Get()))
         return false;
+    m_d3d12Backend = backend.get();
+    m_backend = std::move(backend);
 
-    // б
-    if (FAILED(m_d3dDevice->CreateCommandList(
-        0,
-        D3D12_COMMAND_LIST_TYPE_DIRECT,
-        m_commandAllocator.Get(),
-        nullptr,
-        IID_PPV_ARGS(&m_commandList))))
+    // 纹理上传用独立的拷贝队列，不占用图形队列
+    m_textureUploader = std::make_unique<D3D12TextureUploader>();
+    if (!m_textureUploader->Initialize(m_d3dDevice.Get()))
+        return false;
+
+    return CreateFrameResources();
+}
+
+bool D3DManager::CreateFrameResources()
+{
+    m_frameRing = std::make_unique<FrameRing>(m_backend->GetFence(), FrameCount);
+
+    // 解码完成时唤醒按需渲染的渲染线程来上传
+    m_textureLoader = std::make_unique<TextureLoader>(m_textureDecoder, &m_threadPool);
+    m_textureLoader->SetDecodedCallback([this]()
+    {
+        m_frameInvalidator.Invalidate(InvalidateReason::Resources);
+    });
+    // 纹理块压缩后存盘，再次加载同一内容时跳过解码与压缩
+    m_encodedTextureCache = std::make_unique<BlobCache>(GetShaderCacheDirectory() / L"Textures", TextureCacheFormatVersion);
+    m_textureLoader->SetEncodedCache(m_encodedTextureCache.get());
+    m_textureCache.SetEraseCallback([this](TextureCacheId id)
+    {
+        OnTextureErased(id);
+    });
+    m_uploadAllocator = std::make_unique<LinearUploadAllocator>(m_backend->GetUploadPageSource(), UploadPageSize);
+
+    // SRV 堆（默认纹理 + 每个对象一张，不够时自动扩容）
+    m_srvAllocator = std::make_unique<DescriptorAllocator>(m_backend->GetDescriptorHeapSource(),
+        TransientSrvCapacity, MaxSrvCapacity);
+    if (!m_srvAllocator->Initialize(InitialSrvCapacity))
+        return false;
+    if (!m_srvAllocator->AllocatePersistent(1, m_defaultSrv))
+        return false;
+
+    // 主列表每个帧上下文一个分配器，另加一个给一次性录制
+    m_commandList = m_backend->CreateCommandList(FrameCount + 1);
+    if (!m_commandList)
+        return false;
+
+    // 并行录制用的命令列表，以及提交收尾用的一条；列表提交后即可重置，跨帧共用
+    for (UINT i = 0; i < MaxRecordChunks; ++i)
+    {
+        m_chunkLists[i] = m_backend->CreateCommandList(FrameCount);
+        if (!m_chunkLists[i])
+            return false;
+    }
+
+    m_epilogueList = m_backend->CreateCommandList(FrameCount);
+    if (!m_epilogueList)
         return false;
 
+    // 不支持时间戳查询时只是没有 GPU 轨道，不影响渲染
+    if (!m_gpuProfiler.Initialize(*m_backend, FrameCount))
+    {
+        OutputDebugStringA("GPU timestamp queries unavailable, GPU profiling disabled\n");
+    }
+
+    // 块数不超过命令列表数和线程数（调用线程也参与录制）
+    UINT chunkLimit = m_threadPool.GetWorkerCount() + 1;
+    if (chunkLimit > MaxRecordChunks)
+    {
+        chunkLimit = MaxRecordChunks;
+    }
+    m_parallelRecorder.Configure(chunkLimit, MinRecordChunkCost);
+
     return true;
 }
 
 // ============================================================================
-// 
+// 创建交换链
 // ============================================================================
 bool D3DManager::CreateSwapChain()
 {
     DXGI_SWAP_CHAIN_DESC sd = {};
-    sd.BufferDesc.Width = m_clientWidth;
-    sd.BufferDesc.Height = m_clientHeight;
+    sd.BufferDesc.Width = m_backBufferWidth;
+    sd.BufferDesc.Height = m_backBufferHeight;
     sd.BufferDesc.RefreshRate.Numerator = 60;
     sd.BufferDesc.RefreshRate.Denominator = 1;
     sd.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -370,15 +753,16 @@ bool D3DManager::CreateSwapChain()
         return false;
 
     swapChain.As(&m_swapChain);
+    m_d3d12Backend->SetSwapChain(m_swapChain.Get());
     return true;
 }
 
 // ============================================================================
-// 
+// 创建描述符堆
 // ============================================================================
 bool D3DManager::CreateDescriptorHeaps()
 {
-    // RTV 
+    // RTV 堆
     D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
     rtvHeapDesc.NumDescriptors = SwapChainBufferCount;
     rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
@@ -387,7 +771,7 @@ bool D3DManager::CreateDescriptorHeaps()
     if (FAILED(m_d3dDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&m_rtvHeap))))
         return false;
 
-    // DSV 
+    // DSV 堆
     D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc = {};
     dsvHeapDesc.NumDescriptors = 1;
     dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
@@ -396,7 +780,7 @@ bool D3DManager::CreateDescriptorHeaps()
     if (FAILED(m_d3dDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&m_dsvHeap))))
         return false;
 
-    // CBV 
+    // CBV 堆
     D3D12_DESCRIPTOR_HEAP_DESC cbvHeapDesc = {};
     cbvHeapDesc.NumDescriptors = 1;
     cbvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
@@ -405,19 +789,11 @@ bool D3DManager::CreateDescriptorHeaps()
     if (FAILED(m_d3dDevice->CreateDescriptorHeap(&cbvHeapDesc, IID_PPV_ARGS(&m_cbvHeap))))
         return false;
 
-    // SRV ѣĬ + ÿһţ
-    D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
-    srvHeapDesc.NumDescriptors = MaxTextureCount;
-    srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    if (FAILED(m_d3dDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&m_srvHeap))))
-        return false;
-
     return true;
 }
 
 // ============================================================================
-// ȾĿͼ
+// 创建渲染目标视图
 // ============================================================================
 bool D3DManager::CreateRenderTargets()
 {
@@ -436,15 +812,15 @@ bool D3DManager::CreateRenderTargets()
 }
 
 // ============================================================================
-// ģ建
+// 创建深度模板缓冲区
 // ============================================================================
 bool D3DManager::CreateDepthStencil()
 {
     D3D12_RESOURCE_DESC depthStencilDesc = {};
     depthStencilDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
     depthStencilDesc.Alignment = 0;
-    depthStencilDesc.Width = m_clientWidth;
-    depthStencilDesc.Height = m_clientHeight;
+    depthStencilDesc.Width = m_backBufferWidth;
+    depthStencilDesc.Height = m_backBufferHeight;
     depthStencilDesc.DepthOrArraySize = 1;
     depthStencilDesc.MipLevels = 1;
     depthStencilDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
@@ -460,11 +836,12 @@ bool D3DManager::CreateDepthStencil()
 
     CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_DEFAULT);
 
+    // 直接以 DEPTH_WRITE 创建：帧图把深度缓冲当作常驻于该状态的外部资源
     if (FAILED(m_d3dDevice->CreateCommittedResource(
         &heapProps,
         D3D12_HEAP_FLAG_NONE,
         &depthStencilDesc,
-        D3D12_RESOURCE_STATE_COMMON,
+        D3D12_RESOURCE_STATE_DEPTH_WRITE,
         &optClear,
         IID_PPV_ARGS(&m_depthStencilBuffer))))
         return false;
@@ -475,78 +852,469 @@ bool D3DManager::CreateDepthStencil()
         DepthStencilView()
     );
 
-    // תԴ״̬
-    CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-        m_depthStencilBuffer.Get(),
-        D3D12_RESOURCE_STATE_COMMON,
-        D3D12_RESOURCE_STATE_DEPTH_WRITE
-    );
-    m_commandList->ResourceBarrier(1, &barrier);
-
     return true;
 }
 
 // ============================================================================
-// ɫ
+// 编译着色器
 // ============================================================================
 bool D3DManager::CompileShaders()
 {
-    UINT compileFlags = 0;
-#if defined(DEBUG) || defined(_DEBUG)
-    compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
-#endif
+    std::filesystem::path cacheDir = GetShaderCacheDirectory();
+    m_shaderCache = std::make_unique<BlobCache>(cacheDir / L"Shaders", ShaderCacheFormatVersion);
+    m_pipelineCache = std::make_unique<BlobCache>(cacheDir / L"Pipelines", PipelineCacheFormatVersion);
 
-    ComPtr<ID3DBlob> errors;
+    std::vector<uint8_t> source;
+    std::filesystem::path sourcePath;
+    if (!LoadShaderSource(source, sourcePath))
+    {
+        OutputDebugStringA("Shaders.hlsl not found\n");
+        return false;
+    }
 
-    // 붥ɫ
-    HRESULT hr = D3DCompileFromFile(
-        L"Shaders.hlsl",
-        nullptr,
-        D3D_COMPILE_STANDARD_FILE_INCLUDE,
-        "VS", "vs_5_0",
-        compileFlags, 0,
-        &m_vsByteCode,
-        &errors
-    );
+    if (!CompileShaderCached(*m_shaderCache, source, sourcePath, "VS", "vs_5_0", {}, m_vsByteCode, m_vsKey))
+        return false;
+    for (uint32_t v = 0; v < ShaderVariant::VariantCount; ++v)
+    {
+        if (!CompileShaderCached(*m_shaderCache, source, sourcePath, "PS", "ps_5_0",
+            ShaderVariant::GetDefines(v), m_psByteCodes[v], m_psKeys[v]))
+            return false;
+    }
 
-    if (errors != nullptr)
+    return true;
+}
+
+bool D3DManager::PrecompileShaders()
+{
+    std::vector<uint8_t> source;
+    std::filesystem::path sourcePath;
+    if (!LoadShaderSource(source, sourcePath))
     {
-        OutputDebugStringA((char*)errors->GetBufferPointer());
+        return false;
     }
-    if (FAILED(hr)) return false;
 
-    // ɫ
-    hr = D3DCompileFromFile(
-        L"Shaders.hlsl",
-        nullptr,
-        D3D_COMPILE_STANDARD_FILE_INCLUDE,
-        "PS", "ps_5_0",
-        compileFlags, 0,
-        &m_psByteCode,
-        &errors
-    );
+    // 编译 CompileShaders 用到的全部着色器，返回耗时（毫秒），失败返回负数
+    auto compileAll = [&](BlobCache& cache)
+    {
+        auto start = std::chrono::steady_clock::now();
+        ComPtr<ID3DBlob> byteCode;
+        uint64_t key = 0;
+        if (!CompileShaderCached(cache, source, sourcePath, "VS", "vs_5_0", {}, byteCode, key))
+        {
+            return -1.0;
+        }
+        for (uint32_t v = 0; v < ShaderVariant::VariantCount; ++v)
+        {
+            if (!CompileShaderCached(cache, source, sourcePath, "PS", "ps_5_0", ShaderVariant::GetDefines(v), byteCode, key))
+            {
+                return -1.0;
+            }
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
 
-    if (errors != nullptr)
+    BlobCache cache(GetShaderCacheDirectory() / L"Shaders", ShaderCacheFormatVersion);
+    const double ms = compileAll(cache);
+    if (ms < 0.0)
     {
-        OutputDebugStringA((char*)errors->GetBufferPointer());
+        return false;
     }
-    if (FAILED(hr)) return false;
 
+    // 冷/热对比放在临时目录里，不影响真正的缓存
+    std::error_code ec;
+    const std::filesystem::path scratch = std::filesystem::temp_directory_path(ec) / L"D3D_2-ShaderCacheColdWarm";
+    std::filesystem::remove_all(scratch, ec);
+    double coldMs = 0.0, warmMs = 0.0;
+    {
+        BlobCache cold(scratch, ShaderCacheFormatVersion);
+        coldMs = compileAll(cold);
+    }
+    {
+        BlobCache warm(scratch, ShaderCacheFormatVersion);
+        warmMs = compileAll(warm);
+    }
+    std::filesystem::remove_all(scratch, ec);
+    if (coldMs < 0.0 || warmMs < 0.0)
+    {
+        return false;
+    }
+
+    char report[384];
+    sprintf_s(report,
+        "Shader cache: %u shaders, %u hit / %u miss, %.1f ms\n"
+        "  startup compile: cold cache %.1f ms, warm cache %.1f ms (%.1fx)\n",
+        1 + ShaderVariant::VariantCount, cache.GetHitCount(), cache.GetMissCount(), ms,
+        coldMs, warmMs, warmMs > 0.0 ? coldMs / warmMs : 0.0);
+    printf("%s", report);
+    fflush(stdout);
+    OutputDebugStringA(report);
     return true;
 }
 
-// ============================================================================
-// ǩ
-// ============================================================================
-bool D3DManager::BuildRootSignature()
+bool D3DManager::RunHeadlessBenchmark(int objectCount, int frameCount)
 {
-    CD3DX12_DESCRIPTOR_RANGE srvRange;
-    srvRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
+    if (objectCount < 0 || frameCount <= 0)
+    {
+        return false;
+    }
 
-    CD3DX12_ROOT_PARAMETER slotRootParameter[3];
-    slotRootParameter[0].InitAsConstantBufferView(0); // b0: per-object
-    slotRootParameter[1].InitAsConstantBufferView(1); // b1: per-pass (light/camera)
+    D3DManager manager;
+    if (!manager.InitHeadless(1280, 720))
+    {
+        return false;
+    }
+
+    manager.AddBenchmarkGrid(objectCount);
+    manager.PublishSnapshot();
+
+    double minMs = DBL_MAX, maxMs = 0.0, totalMs = 0.0;
+    for (int f = 0; f < frameCount; ++f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        manager.Render();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        minMs = ms < minMs ? ms : minMs;
+        maxMs = ms > maxMs ? ms : maxMs;
+        totalMs += ms;
+    }
+
+    const NullGraphicsBackend* backend = manager.GetNullBackend();
+    const NullBackendStats& stats = backend->GetFrameStats();
+    char report[512];
+    sprintf_s(report,
+        "Headless benchmark: %d objects, %d frames, CPU frame min %.3f / avg %.3f / max %.3f ms\n"
+        "  last frame: %u lists, %llu commands, %llu bytes, %u draws, %llu instances, %u barriers\n"
+        "  binds: %u pipeline, %u table, %u root, %u vb, %u ib; hash %016llx\n",
+        objectCount, frameCount, minMs, totalMs / frameCount, maxMs,
+        stats.CommandLists, (unsigned long long)stats.Commands, (unsigned long long)stats.StreamBytes,
+        stats.Draws, (unsigned long long)stats.Instances, stats.Barriers,
+        stats.PipelineBinds, stats.DescriptorTableBinds, stats.RootParameterBinds,
+        stats.VertexBufferBinds, stats.IndexBufferBinds, (unsigned long long)backend->GetFrameHash());
+    printf("%s", report);
+    OutputDebugStringA(report);
+
+    // 窗口内的每帧统计，与录制后端的计数互相印证
+    RenderStatsSummary summary;
+    manager.GetRenderStats(summary);
+    std::string statsText;
+    FormatRenderStats(summary, statsText);
+    printf("%s", statsText.c_str());
+    fflush(stdout);
+    OutputDebugStringA(statsText.c_str());
+
+    manager.Cleanup();
+    return true;
+}
+
+bool D3DManager::RunSoftwareRender(const std::wstring& path, int width, int height, int objectCount)
+{
+    if (width <= 0 || height <= 0 || objectCount < 0)
+    {
+        return false;
+    }
+
+    D3DManager manager;
+    if (!manager.InitHeadless(width, height))
+    {
+        return false;
+    }
+    manager.AddBenchmarkGrid(objectCount);
+
+    // 第一帧生成形状网格、分配分块缓冲，不计时
+    if (!manager.RenderSoftwareFrame())
+    {
+        manager.Cleanup();
+        return false;
+    }
+
+    const int frameCount = 10;
+    double minMs = DBL_MAX, totalMs = 0.0;
+    for (int f = 0; f < frameCount; ++f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        manager.RenderSoftwareFrame();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        minMs = ms < minMs ? ms : minMs;
+        totalMs += ms;
+    }
+
+    const SoftwareRasterStats& stats = manager.GetSoftwareRenderStats();
+    const bool saved = manager.m_softwareRasterizer.SaveBmp(std::filesystem::path(path));
+    char report[512];
+    sprintf_s(report,
+        "Software render: %dx%d, %d objects, %d frames, min %.2f / avg %.2f ms (%.2f frames/s)\n"
+        "  last frame: %u draws, %u triangles, %u binned, %llu shaded pixels\n"
+        "  geometry %.2f / binning %.2f / raster %.2f ms; %s\n",
+        width, height, objectCount, frameCount, minMs, totalMs / frameCount, 1000.0 * frameCount / totalMs,
+        stats.Draws, stats.Triangles, stats.BinnedTriangles, (unsigned long long)stats.ShadedPixels,
+        stats.GeometryMs, stats.BinningMs, stats.RasterMs, saved ? "saved" : "save failed");
+    printf("%s", report);
+    fflush(stdout);
+    OutputDebugStringA(report);
+
+    manager.Cleanup();
+    return saved;
+}
+
+bool D3DManager::RunMipBenchmark(int size, int iterations)
+{
+    if (size <= 0 || iterations <= 0)
+    {
+        return false;
+    }
+
+    const uint32_t width = (uint32_t)size, height = (uint32_t)size;
+    std::vector<uint8_t> source;
+    MakeBenchmarkImage(width, height, source);
+
+    static const struct { MipFilter Filter; bool Srgb; const char* Name; } cases[] = {
+        { MipFilter::Box, false, "box/linear" },
+        { MipFilter::Box, true, "box/sRGB" },
+        { MipFilter::Kaiser, false, "kaiser/linear" },
+        { MipFilter::Kaiser, true, "kaiser/sRGB" } };
+
+    std::string report = "Mip benchmark: " + std::to_string(width) + "x" + std::to_string(height) +
+        ", " + std::to_string(iterations) + " iterations\n";
+    std::vector<uint8_t> pixels;
+    std::vector<MipLevel> levels;
+    for (const auto& c : cases)
+    {
+        MipSettings settings;
+        settings.Filter = c.Filter;
+        settings.SrgbColor = c.Srgb;
+
+        double totalMs = 0.0;
+        for (int i = 0; i < iterations; ++i)
+        {
+            pixels.assign(source.begin(), source.end());
+            auto start = std::chrono::steady_clock::now();
+            GenerateMipChain(pixels, width, height, settings, levels);
+            totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        // 吞吐按第 0 级的像素数计
+        char line[160];
+        sprintf_s(line, "  %-14s %u levels, avg %.3f ms, %.1f MP/s\n", c.Name, (uint32_t)levels.size(),
+            totalMs / iterations, (double)width * height * iterations / (totalMs * 1000.0));
+        report += line;
+    }
+
+    printf("%s", report.c_str());
+    fflush(stdout);
+    OutputDebugStringA(report.c_str());
+    return true;
+}
+
+bool D3DManager::RunCompressionBenchmark(int size, int iterations)
+{
+    if (size <= 0 || iterations <= 0)
+    {
+        return false;
+    }
+
+    const uint32_t width = (uint32_t)size, height = (uint32_t)size;
+    std::vector<uint8_t> chain;
+    MakeBenchmarkImage(width, height, chain);
+    std::vector<MipLevel> rgbaLevels;
+    GenerateMipChain(chain, width, height, MipSettings(), rgbaLevels);
+
+    ThreadPool pool;
+    const std::filesystem::path cacheDir = std::filesystem::temp_directory_path() / L"D3D_2_CompressionBenchmark";
+    BlobCache cache(cacheDir, TextureCacheFormatVersion);
+
+    static const struct { TextureFormat Format; const char* Name; } formats[] = {
+        { TextureFormat::BC1, "BC1" }, { TextureFormat::BC3, "BC3" }, { TextureFormat::BC7, "BC7" } };
+    static const struct { CompressionQuality Quality; const char* Name; } qualities[] = {
+        { CompressionQuality::Fast, "fast" }, { CompressionQuality::Normal, "normal" }, { CompressionQuality::High, "high" } };
+
+    char line[256];
+    sprintf_s(line, "Compression benchmark: %ux%u, %u levels, %.2f MB as RGBA8, %d iterations, %u worker threads\n",
+        width, height, (uint32_t)rgbaLevels.size(), chain.size() / (1024.0 * 1024.0), iterations, pool.GetWorkerCount());
+    std::string report = line;
+
+    std::vector<MipLevel> levels;
+    std::vector<uint8_t> blocks, loaded;
+    std::vector<uint8_t> decoded((size_t)width * height * 4);
+    for (const auto& format : formats)
+    {
+        for (const auto& quality : qualities)
+        {
+            double encodeMs = 0.0;
+            for (int i = 0; i < iterations; ++i)
+            {
+                levels = rgbaLevels;
+                auto start = std::chrono::steady_clock::now();
+                CompressMipChain(format.Format, quality.Quality, chain, levels, blocks, &pool);
+                encodeMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            }
+
+            // 第 0 级的误差，RGB 与 alpha 分开
+            DecompressLevel(format.Format, blocks.data(), width, height, decoded.data());
+            double rgbError = 0.0, alphaError = 0.0;
+            for (size_t p = 0; p < decoded.size(); p += 4)
+            {
+                for (int c = 0; c < 4; ++c)
+                {
+                    const double d = (double)decoded[p + c] - (double)chain[p + c];
+                    (c < 3 ? rgbError : alphaError) += d * d;
+                }
+            }
+            const double pixelCount = (double)width * height;
+            const double rgbPsnr = rgbError > 0.0 ? 10.0 * log10(255.0 * 255.0 * pixelCount * 3.0 / rgbError) : 99.0;
+            const double alphaPsnr = alphaError > 0.0 ? 10.0 * log10(255.0 * 255.0 * pixelCount / alphaError) : 99.0;
+
+            // 再次加载时读缓存的耗时（含内容哈希校验），与编码耗时对比
+            const uint64_t key = ((uint64_t)format.Format << 8) | (uint64_t)quality.Quality;
+            cache.Store(key, blocks.data(), blocks.size());
+            auto loadStart = std::chrono::steady_clock::now();
+            cache.Load(key, loaded);
+            const double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+
+            sprintf_s(line, "  %s %-6s encode %8.2f ms (%6.1f MP/s), PSNR rgb %5.2f / alpha %5.2f dB, "
+                "%6.2f MB (%4.1f%%), cache load %6.2f ms\n",
+                format.Name, quality.Name, encodeMs / iterations, pixelCount * iterations / (encodeMs * 1000.0),
+                rgbPsnr, alphaPsnr, blocks.size() / (1024.0 * 1024.0), 100.0 * blocks.size() / chain.size(), loadMs);
+            report += line;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(cacheDir, ec);
+
+    printf("%s", report.c_str());
+    fflush(stdout);
+    OutputDebugStringA(report.c_str());
+    return true;
+}
+
+void D3DManager::MakeBenchmarkImage(uint32_t width, uint32_t height, std::vector<uint8_t>& out)
+{
+    // 8 像素的棋盘格叠加渐变：既有硬边也有平滑区域，alpha 沿对角线渐变
+    out.resize((size_t)width * height * 4);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            uint8_t* p = &out[((size_t)y * width + x) * 4];
+            const bool checker = (((x / 8) ^ (y / 8)) & 1) != 0;
+            p[0] = (uint8_t)(checker ? 180 + x * 75 / width : 30 + y * 60 / height);
+            p[1] = (uint8_t)(x * 255 / width);
+            p[2] = (uint8_t)(y * 255 / height);
+            p[3] = (uint8_t)((uint64_t)(x + y) * 255 / (width + height));
+        }
+    }
+}
+
+bool D3DManager::CompileShaderCached(BlobCache& cache, const std::vector<uint8_t>& source,
+    const std::filesystem::path& sourcePath, const char* entry, const char* profile,
+    const std::vector<ShaderDefine>& defines, ComPtr<ID3DBlob>& out, uint64_t& outKey)
+{
+    UINT compileFlags = 0;
+#if defined(DEBUG) || defined(_DEBUG)
+    compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+    // Shaders.hlsl 没有 #include，源文件内容哈希就覆盖了全部输入
+    const uint64_t sourceHash = HashBytes(source.data(), source.size());
+    outKey = MakeShaderKey(sourceHash, entry, profile, defines, compileFlags);
+
+    std::vector<uint8_t> cached;
+    if (cache.Load(outKey, cached) && SUCCEEDED(D3DCreateBlob(cached.size(), &out)))
+    {
+        memcpy(out->GetBufferPointer(), cached.data(), cached.size());
+        return true;
+    }
+
+    std::vector<D3D_SHADER_MACRO> macros;
+    for (const ShaderDefine& define : defines)
+    {
+        macros.push_back({ define.Name.c_str(), define.Value.c_str() });
+    }
+    macros.push_back({ nullptr, nullptr });
+
+    ComPtr<ID3DBlob> errors;
+    HRESULT hr = D3DCompile(
+        source.data(), source.size(),
+        sourcePath.u8string().c_str(),
+        macros.data(),
+        D3D_COMPILE_STANDARD_FILE_INCLUDE,
+        entry, profile,
+        compileFlags, 0,
+        &out,
+        &errors
+    );
+
+    if (errors != nullptr)
+    {
+        OutputDebugStringA((char*)errors->GetBufferPointer());
+    }
+    if (FAILED(hr)) return false;
+
+    cache.Store(outKey, out->GetBufferPointer(), out->GetBufferSize());
+    return true;
+}
+
+std::filesystem::path D3DManager::GetExecutableDirectory()
+{
+    wchar_t modulePath[MAX_PATH] = {};
+    DWORD length = GetModuleFileNameW(nullptr, modulePath, MAX_PATH);
+    if (length == 0 || length == MAX_PATH)
+    {
+        return std::filesystem::current_path();
+    }
+    return std::filesystem::path(modulePath).parent_path();
+}
+
+std::filesystem::path D3DManager::GetShaderCacheDirectory()
+{
+    // 程序目录可能不可写（例如装在 Program Files 下），优先放在本地应用数据目录
+    wchar_t localAppData[MAX_PATH] = {};
+    DWORD length = GetEnvironmentVariableW(L"LOCALAPPDATA", localAppData, MAX_PATH);
+    if (length > 0 && length < MAX_PATH)
+    {
+        return std::filesystem::path(localAppData) / L"D3D_2" / L"ShaderCache";
+    }
+    return GetExecutableDirectory() / L"ShaderCache";
+}
+
+bool D3DManager::LoadShaderSource(std::vector<uint8_t>& source, std::filesystem::path& path)
+{
+    // 先按可执行文件所在目录解析，不再依赖启动时的工作目录；找不到时退回工作目录（从 IDE 启动）
+    const std::filesystem::path candidates[] =
+    {
+        GetExecutableDirectory() / L"Shaders.hlsl",
+        std::filesystem::current_path() / L"Shaders.hlsl",
+    };
+
+    for (const std::filesystem::path& candidate : candidates)
+    {
+        std::ifstream file(candidate, std::ios::binary);
+        if (!file)
+        {
+            continue;
+        }
+
+        source.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        path = candidate;
+        return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// 构建根签名
+// ============================================================================
+bool D3DManager::BuildRootSignature()
+{
+    CD3DX12_DESCRIPTOR_RANGE srvRange;
+    srvRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
+
+    CD3DX12_ROOT_PARAMETER slotRootParameter[5];
+    slotRootParameter[0].InitAsConstants(1, 0); // b0: per-draw（槽位表起始下标）
+    slotRootParameter[1].InitAsConstantBufferView(1); // b1: per-pass (view-proj/light/camera)
     slotRootParameter[2].InitAsDescriptorTable(1, &srvRange, D3D12_SHADER_VISIBILITY_PIXEL);
+    slotRootParameter[3].InitAsShaderResourceView(1); // t1: 实例数据 StructuredBuffer（按持久槽位）
+    slotRootParameter[4].InitAsShaderResourceView(2, 0, D3D12_SHADER_VISIBILITY_VERTEX); // t2: 本帧槽位下标表
 
     CD3DX12_STATIC_SAMPLER_DESC sampler(0, D3D12_FILTER_MIN_MAG_MIP_LINEAR);
 
@@ -572,6 +1340,8 @@ bool D3DManager::BuildRootSignature()
     }
     if (FAILED(hr)) return false;
 
+    m_rootSignatureHash = HashBytes(serializedRootSig->GetBufferPointer(), serializedRootSig->GetBufferSize());
+
     if (FAILED(m_d3dDevice->CreateRootSignature(
         0,
         serializedRootSig->GetBufferPointer(),
@@ -579,22 +1349,23 @@ bool D3DManager::BuildRootSignature()
         IID_PPV_ARGS(&m_rootSignature))))
         return false;
 
+    m_rootSignatureHandle = ToGpuHandle(m_rootSignature.Get());
     return true;
 }
 
 // ============================================================================
-// ״̬
+// 构建管线状态对象
 // ============================================================================
 bool D3DManager::BuildPSO()
 {
-    // 벼
+    // 顶点输入布局
     D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
     {
-        // λƫ 0
+        // 位置在偏移 0
      { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT,    0, 0,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-     // ƫ 12
+     // 法线在偏移 12
      { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT,    0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-     // ɫƫ 24
+     // 颜色在偏移 24
     { "COLOR",    0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
     };
 
@@ -602,7 +1373,6 @@ bool D3DManager::BuildPSO()
     psoDesc.InputLayout = { inputElementDescs, _countof(inputElementDescs) };
     psoDesc.pRootSignature = m_rootSignature.Get();
     psoDesc.VS = { m_vsByteCode->GetBufferPointer(), m_vsByteCode->GetBufferSize() };
-    psoDesc.PS = { m_psByteCode->GetBufferPointer(), m_psByteCode->GetBufferSize() };
 
     psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
     psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
@@ -615,109 +1385,123 @@ bool D3DManager::BuildPSO()
     psoDesc.SampleDesc.Count = 1;
     psoDesc.SampleDesc.Quality = 0;
 
-    if (FAILED(m_d3dDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pipelineState))))
-        return false;
+    // 缓存的 PSO 块只对同一适配器、同一驱动有效，键里带上两者
+    uint64_t commonKey = HashBytes(&m_vsKey, sizeof(m_vsKey));
+    commonKey = HashBytes(&m_rootSignatureHash, sizeof(m_rootSignatureHash), commonKey);
+    commonKey = HashBytes(&PipelineDescVersion, sizeof(PipelineDescVersion), commonKey);
+    uint64_t adapterHash = GetAdapterHash();
+    commonKey = HashBytes(&adapterHash, sizeof(adapterHash), commonKey);
 
-    return true;
-}
+    // 各变体只有像素着色器不同
+    for (uint32_t v = 0; v < ShaderVariant::VariantCount; ++v)
+    {
+        psoDesc.PS = { m_psByteCodes[v]->GetBufferPointer(), m_psByteCodes[v]->GetBufferSize() };
+        psoDesc.CachedPSO = {};
+        const uint64_t pipelineKey = HashBytes(&m_psKeys[v], sizeof(m_psKeys[v]), commonKey);
 
-// ============================================================================
-// 
-// ============================================================================
-bool D3DManager::BuildConstantBuffers()
-{
-    // 256 
-        m_objCBByteSize = (sizeof(ObjectConstants) + 255) & ~255;
+        std::vector<uint8_t> cached;
+        if (m_pipelineCache->Load(pipelineKey, cached))
+        {
+            psoDesc.CachedPSO = { cached.data(), cached.size() };
+            if (SUCCEEDED(m_d3dDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pipelineStates[v]))))
+            {
+                m_pipelineHandles[v] = ToGpuHandle(m_pipelineStates[v].Get());
+                continue;
+            }
 
-    UINT bufferSize = m_objCBByteSize * MaxObjects;
+            // 驱动拒绝了缓存块（例如同版本号的驱动重装）：丢弃后按无缓存创建
+            psoDesc.CachedPSO = {};
+            m_pipelineCache->Remove(pipelineKey);
+        }
 
-    CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
-    CD3DX12_RESOURCE_DESC bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(bufferSize);
+        if (FAILED(m_d3dDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pipelineStates[v]))))
+            return false;
+        m_pipelineHandles[v] = ToGpuHandle(m_pipelineStates[v].Get());
 
-    if (FAILED(m_d3dDevice->CreateCommittedResource(
-        &heapProps,
-        D3D12_HEAP_FLAG_NONE,
-        &bufferDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&m_objectCB))))
-    {
-        return false;
+        ComPtr<ID3DBlob> pipelineBlob;
+        if (SUCCEEDED(m_pipelineStates[v]->GetCachedBlob(&pipelineBlob)))
+        {
+            m_pipelineCache->Store(pipelineKey, pipelineBlob->GetBufferPointer(), pipelineBlob->GetBufferSize());
+        }
     }
 
-    if (FAILED(m_objectCB->Map(0, nullptr, reinterpret_cast<void**>(&m_cbMappedData))))
-        return false;
+    return true;
+}
 
-    // ֻһ CBV ָ bufferʵʹʱƫ
-    D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc = {};
-    cbvDesc.BufferLocation = m_objectCB->GetGPUVirtualAddress();
-    cbvDesc.SizeInBytes = m_objCBByteSize; // ǩõֻʼλãΪһС
+uint64_t D3DManager::GetAdapterHash() const
+{
+    // 厂商/设备/修订号 + 用户态驱动版本
+    DXGI_ADAPTER_DESC desc = {};
+    LARGE_INTEGER driverVersion = {};
+    ComPtr<IDXGIAdapter> adapter;
+    if (SUCCEEDED(m_dxgiFactory->EnumAdapterByLuid(m_d3dDevice->GetAdapterLuid(), IID_PPV_ARGS(&adapter))))
+    {
+        adapter->GetDesc(&desc);
+        adapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &driverVersion);
+    }
 
-    m_d3dDevice->CreateConstantBufferView(
-        &cbvDesc,
-        m_cbvHeap->GetCPUDescriptorHandleForHeapStart());
+    uint64_t hash = HashBytes(&desc.VendorId, sizeof(desc.VendorId));
+    hash = HashBytes(&desc.DeviceId, sizeof(desc.DeviceId), hash);
+    hash = HashBytes(&desc.SubSysId, sizeof(desc.SubSysId), hash);
+    hash = HashBytes(&desc.Revision, sizeof(desc.Revision), hash);
+    return HashBytes(&driverVersion.QuadPart, sizeof(driverVersion.QuadPart), hash);
+}
 
-    // -------- per-pass CB (b1) --------
-    m_passCBByteSize = (sizeof(PassConstants) + 255) & ~255;
+// ============================================================================
+// 构建常量缓冲区
+// ============================================================================
+bool D3DManager::BuildConstantBuffers()
+{
+    // 实例数据作为 StructuredBuffer 读取，按结构体大小紧密排列
+    m_objCBByteSize = sizeof(ObjectConstants);
 
-    CD3DX12_RESOURCE_DESC passDesc = CD3DX12_RESOURCE_DESC::Buffer(m_passCBByteSize);
-    if (FAILED(m_d3dDevice->CreateCommittedResource(
-        &heapProps,
-        D3D12_HEAP_FLAG_NONE,
-        &passDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&m_passCB))))
-    {
-        return false;
-    }
+    // per-pass CB (b1)：根 CBV 地址需要 256 字节对齐（每页起始天然对齐）
+    m_passCBByteSize = (sizeof(PassConstants) + 255) & ~255;
 
-    if (FAILED(m_passCB->Map(0, nullptr, reinterpret_cast<void**>(&m_passCbMappedData))))
+    // 每个帧上下文一份 pass 常量；对象常量副本在 Render 中按槽位数按需扩容
+    for (UINT f = 0; f < FrameCount; ++f)
     {
-        return false;
+        if (!m_backend->GetUploadPageSource().CreatePage(m_passCBByteSize, m_frames[f].PassPage))
+            return false;
     }
-
     return true;
 }
 
 // ============================================================================
-// ״
+// 构建所有形状几何体
 // ============================================================================
 bool D3DManager::BuildShapeGeometry()
 {
-    // б
-    m_commandAllocator->Reset();
-    m_commandList->Reset(m_commandAllocator.Get(), nullptr);
+    m_commandList->Begin(ImmediateAllocator, NullGpuHandle);
 
-    // ģ
+    // 创建几何体模板
     m_sphereTemplate = std::make_shared<PrimitiveShape>();
-    if (!m_sphereTemplate->Initialize(m_d3dDevice.Get(), m_commandList.Get(), (int)ShapeType::Sphere))
+    if (!m_sphereTemplate->Initialize(*m_backend, *m_commandList, (int)ShapeType::Sphere))
         return false;
 
     m_cylinderTemplate = std::make_shared<PrimitiveShape>();
-    if (!m_cylinderTemplate->Initialize(m_d3dDevice.Get(), m_commandList.Get(), (int)ShapeType::Cylinder))
+    if (!m_cylinderTemplate->Initialize(*m_backend, *m_commandList, (int)ShapeType::Cylinder))
         return false;
 
     m_planeTemplate = std::make_shared<PrimitiveShape>();
-    if (!m_planeTemplate->Initialize(m_d3dDevice.Get(), m_commandList.Get(), (int)ShapeType::Plane))
+    if (!m_planeTemplate->Initialize(*m_backend, *m_commandList, (int)ShapeType::Plane))
         return false;
 
     m_cubeTemplate = std::make_shared<PrimitiveShape>();
-    if (!m_cubeTemplate->Initialize(m_d3dDevice.Get(), m_commandList.Get(), (int)ShapeType::Cube))
+    if (!m_cubeTemplate->Initialize(*m_backend, *m_commandList, (int)ShapeType::Cube))
         return false;
 
     m_tetrahedronTemplate = std::make_shared<PrimitiveShape>();
-    if (!m_tetrahedronTemplate->Initialize(m_d3dDevice.Get(), m_commandList.Get(), (int)ShapeType::Tetrahedron))
+    if (!m_tetrahedronTemplate->Initialize(*m_backend, *m_commandList, (int)ShapeType::Tetrahedron))
         return false;
 
-    // ִб
-    m_commandList->Close();
-    ID3D12CommandList* cmdsLists[] = { m_commandList.Get() };
-    m_commandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+    // 执行命令列表
+    m_commandList->End();
+    m_backend->Submit(&m_commandList, 1);
 
     FlushCommandQueue();
 
-    // ͷϴ
+    // 释放上传缓冲区
     m_sphereTemplate->DisposeUploaders();
     m_cylinderTemplate->DisposeUploaders();
     m_planeTemplate->DisposeUploaders();
@@ -728,8 +1512,25 @@ bool D3DManager::BuildShapeGeometry()
 }
 
 // ============================================================================
-// Ӷ󵽳
+// 添加对象到场景
 // ============================================================================
+void D3DManager::AddBenchmarkGrid(int objectCount)
+{
+    static const ShapeType shapes[] = {
+        ShapeType::Sphere, ShapeType::Cylinder, ShapeType::Plane, ShapeType::Cube, ShapeType::Tetrahedron };
+    int side = 1;
+    while (side * side < objectCount)
+    {
+        ++side;
+    }
+    for (int i = 0; i < objectCount; ++i)
+    {
+        float x = (float)(i % side - side / 2) * 2.0f;
+        float z = (float)(i / side - side / 2) * 2.0f;
+        AddObject(shapes[i % _countof(shapes)], XMFLOAT3(x, 0.0f, z));
+    }
+}
+
 void D3DManager::AddObject(ShapeType type, const XMFLOAT3& position)
 {
     auto shapeTemplate = GetShapeTemplate(type);
@@ -737,25 +1538,39 @@ void D3DManager::AddObject(ShapeType type, const XMFLOAT3& position)
     {
         auto obj = std::make_unique<SceneObject>(type, shapeTemplate);
         obj->SetPosition(position);
+        m_spatialHandles[obj.get()] = m_spatialGrid.Insert(obj.get(), position, obj->GetBoundingRadius());
+
+        XMFLOAT3 boxMin, boxMax;
+        obj->GetWorldAABB(boxMin, boxMax);
+        m_broadphaseHandles[obj.get()] = m_broadphase.Insert(obj.get(), boxMin, boxMax);
+        obj->SetSceneIndex((uint32_t)m_sceneObjects.size());
         m_sceneObjects.push_back(std::move(obj));
+        m_sceneDirty = true;
     }
 }
 
 // ============================================================================
-// ճ
+// 清空场景
 // ============================================================================
 void D3DManager::ClearScene()
 {
     m_sceneObjects.clear();
-    m_objectTextures.clear();
-    m_objectSrvIndex.clear();
-    m_freeSrvIndices.clear();
-    m_nextSrvIndex = 1;
+    m_spatialGrid.Clear();
+    m_spatialHandles.clear();
+    m_broadphase.Clear();
+    m_broadphaseHandles.clear();
+    PostRenderCommand([this]()
+    {
+        DestroyAllTextures();
+    });
+
+    m_selection.Clear();
     m_selectedObject = nullptr;
+    m_sceneDirty = true;
 }
 
 // ============================================================================
-// ȡ״ģ
+// 获取形状模板
 // ============================================================================
 std::shared_ptr<PrimitiveShape> D3DManager::GetShapeTemplate(ShapeType type)
 {
@@ -776,20 +1591,19 @@ void D3DManager::OnMouseDoubleClick(int x, int y)
     {
         return;
     }
+    m_sceneDirty = true;
 
-    // ûѡж˫Ҳʰȡһ
+    // 如果没有选中对象，双击也尝试拾取一次
     if (!m_selectedObject)
     {
         SceneObject* pickedObj = PickObject(x, y);
         if (pickedObj)
         {
-            if (m_selectedObject)
-            {
-                m_selectedObject->SetSelected(false);
-            }
+            ClearSelection();
 
             m_selectedObject = pickedObj;
             m_selectedObject->SetSelected(true);
+            m_selection.Set(FindObjectIndex(pickedObj));
         }
     }
 
@@ -798,128 +1612,693 @@ void D3DManager::OnMouseDoubleClick(int x, int y)
         return;
     }
     else {
-        // ԶԻ
+        // 弹出属性对话框
 		if (ShowTransformDialog(m_hWnd, m_selectedObject))
 		{
+			UpdateSpatialEntry(m_selectedObject);
 			LoadTextureForObject(m_selectedObject);
 		}
     }
 }
 
-void D3DManager::ShowLightSettingsDialog()
+void D3DManager::ShowLightSettingsDialog()
+{
+    if (!m_hWnd)
+    {
+        return;
+    }
+    if (ShowLightDialog(m_hWnd, m_lightSettings))
+    {
+        m_sceneDirty = true;
+    }
+
+}
+
+// ============================================================================
+// 渲染函数
+// ============================================================================
+void D3DManager::Render()
+{
+    PROFILE_SCOPE("Render");
+    const uint64_t frameStart = FrameProfiler::Now();
+    m_frameTextureUploads = 0;
+    m_frameTextureUploadBytes = 0;
+
+    // 先取快照再执行命令：快照发布之前投递的命令此时一定已在队列中
+    const RenderSnapshot& snapshot = m_snapshots.Acquire();
+    {
+        PROFILE_SCOPE("RenderCommands");
+        m_renderCommands.Drain();
+    }
+    UpdateTextureLoads();
+
+    // 取下一个帧上下文；只有 CPU 领先 GPU 整整一圈时才会等待
+    {
+        PROFILE_SCOPE("WaitFrameContext");
+        m_frameIndex = m_frameRing->BeginFrame();
+    }
+    FrameContext& frame = m_frames[m_frameIndex];
+    m_gpuProfiler.BeginFrame(m_frameIndex);
+
+    m_commandList->Begin(m_frameIndex, m_pipelineHandles[0]);
+    const uint32_t gpuFrameScope = m_gpuProfiler.BeginScope(*m_commandList, "GpuFrame");
+    uint32_t gpuSceneScope = GpuProfiler::InvalidScope;
+
+    // 回收 GPU 已经用完的上传页，切换到本帧的常量副本
+    const uint64_t completedFence = m_backend->GetFence().GetCompletedValue();
+    m_uploadAllocator->BeginFrame(completedFence);
+    m_srvAllocator->BeginFrame(completedFence);
+    m_constantTracker.BeginFrame(m_frameIndex);
+
+    // 帧图：各 pass 声明对后台缓冲/深度缓冲的读写，屏障由编译结果合并后提交
+    m_frameGraph.Reset();
+    RGResource backBuffer = m_frameGraph.Import("BackBuffer",
+        ResourceState::Present, ResourceState::Present, CurrentBackBuffer());
+    RGResource depthStencil = m_frameGraph.Import("DepthStencil",
+        ResourceState::DepthWrite, ResourceState::DepthWrite, m_depthStencilBuffer.Get());
+
+    uint32_t clearPass = m_frameGraph.AddPass("Clear", [this]()
+    {
+        const uint32_t gpuScope = m_gpuProfiler.BeginScope(*m_commandList, "Clear");
+        const float clearColor[] = { 0.2f, 0.3f, 0.4f, 1.0f };
+        m_commandList->ClearRenderTarget(CurrentBackBufferView().ptr, clearColor);
+        m_commandList->ClearDepthStencil(DepthStencilView().ptr, 1.0f, 0);
+        m_gpuProfiler.EndScope(*m_commandList, gpuScope);
+    });
+    m_frameGraph.Write(clearPass, backBuffer, ResourceState::RenderTarget, true);
+    m_frameGraph.Write(clearPass, depthStencil, ResourceState::DepthWrite, true);
+
+    uint32_t scenePass = m_frameGraph.AddPass("Scene", [this, &snapshot, &frame, &gpuSceneScope]()
+    {
+        // 绘制在各录制块的列表里，结束时间戳写在之后提交的收尾列表开头
+        gpuSceneScope = m_gpuProfiler.BeginScope(*m_commandList, "Scene");
+        RecordScenePass(snapshot, frame);
+    });
+    m_frameGraph.Write(scenePass, backBuffer, ResourceState::RenderTarget);
+    m_frameGraph.Write(scenePass, depthStencil, ResourceState::DepthWrite);
+
+    {
+        PROFILE_SCOPE("FrameGraph");
+        m_frameGraph.Compile();
+        m_frameGraph.Execute(*m_commandList);
+    }
+
+    // 收尾列表：外部资源切回帧图声明的最终状态（后台缓冲回到 PRESENT）
+    m_epilogueList->Begin(m_frameIndex, NullGpuHandle);
+    m_gpuProfiler.EndScope(*m_epilogueList, gpuSceneScope);
+    m_frameGraph.SubmitFinalBarriers(*m_epilogueList);
+    m_gpuProfiler.EndScope(*m_epilogueList, gpuFrameScope);
+    m_gpuProfiler.EndFrame(*m_epilogueList);
+    m_epilogueList->End();
+
+    // 按块顺序一次提交：主列表 + 各录制块 + 收尾列表
+    IGraphicsCommandList* cmdsLists[MaxRecordChunks + 2];
+    UINT listCount = 0;
+    cmdsLists[listCount++] = m_commandList;
+    for (size_t c = 0; c < m_parallelRecorder.GetChunks().size(); ++c)
+    {
+        cmdsLists[listCount++] = m_chunkLists[c];
+    }
+    cmdsLists[listCount++] = m_epilogueList;
+    {
+        PROFILE_SCOPE("Submit");
+        m_backend->Submit(cmdsLists, listCount);
+    }
+
+    {
+        PROFILE_SCOPE("Present");
+        m_backend->Present();
+    }
+    m_currBackBuffer = (m_currBackBuffer + 1) % SwapChainBufferCount;
+
+    // 记录本帧栅栏，不再等待 GPU；本帧用过的上传页等这个栅栏完成后再复用
+    const uint64_t frameFence = m_frameRing->EndFrame();
+    m_uploadAllocator->EndFrame(frameFence);
+    m_srvAllocator->EndFrame(frameFence);
+
+    RecordFrameStats(snapshot, frameStart);
+
+    // 还有待上传或拷贝在途的纹理：没有别的失效也要继续出帧来推进（解码完成由回调唤醒）
+    if (m_textureLoader && m_textureLoader->NeedsUpdate())
+    {
+        m_frameInvalidator.Invalidate(InvalidateReason::Resources);
+    }
+}
+
+void D3DManager::RecordFrameStats(const RenderSnapshot& snapshot, uint64_t frameStart)
+{
+    RenderFrameStats stats;
+    stats[RenderCounter::CpuFrameMs] = (double)(FrameProfiler::Now() - frameStart) / 1e6;
+    stats[RenderCounter::GpuFrameMs] = m_gpuProfiler.GetLastMilliseconds("GpuFrame");
+
+    stats[RenderCounter::DrawCalls] = m_drawStats.Draws;
+    stats[RenderCounter::Instances] = m_drawStats.Instances;
+    stats[RenderCounter::Indices] = (double)m_drawStats.Indices;
+    stats[RenderCounter::Triangles] = (double)(m_drawStats.Indices / 3); // 只有三角形列表
+    stats[RenderCounter::PipelineBinds] = m_drawStats.PipelineBinds;
+    stats[RenderCounter::GeometryBinds] = m_drawStats.GeometryBinds;
+    stats[RenderCounter::RootParameterSets] = m_drawStats.RootParameterSets;
+    stats[RenderCounter::DescriptorTableBinds] = m_drawStats.DescriptorTableBinds;
+
+    const ConstantUploadStats& constants = m_constantTracker.GetStats();
+    stats[RenderCounter::ConstantBytes] = (double)constants.BytesWritten;
+    stats[RenderCounter::ObjectsWritten] = constants.ObjectsWritten;
+    stats[RenderCounter::TextureUploads] = m_frameTextureUploads;
+    stats[RenderCounter::TextureUploadBytes] = (double)m_frameTextureUploadBytes;
+    stats[RenderCounter::TextureMemory] = (double)m_textureCache.GetStats().ResidentBytes;
+    stats[RenderCounter::TextureStreamRequests] = m_frameStreamRequests;
+
+    stats[RenderCounter::SceneObjects] = snapshot.SceneObjectCount;
+    stats[RenderCounter::FrustumCulled] = snapshot.SceneObjectCount - (double)snapshot.Items.size();
+    stats[RenderCounter::OcclusionCulled] = (double)(snapshot.Items.size() - m_visibleItems.size());
+    stats[RenderCounter::Visible] = (double)m_visibleItems.size();
+
+    std::lock_guard<std::mutex> lock(m_renderStatsMutex);
+    m_renderStats.Push(stats);
+}
+
+void D3DManager::GetRenderStats(RenderStatsSummary& out) const
+{
+    std::lock_guard<std::mutex> lock(m_renderStatsMutex);
+    m_renderStats.Summarize(out);
+}
+
+void D3DManager::ResetRenderStats()
+{
+    std::lock_guard<std::mutex> lock(m_renderStatsMutex);
+    m_renderStats.Clear();
+}
+
+// ============================================================================
+// 场景 pass：准备绘制数据并在工作线程上录制各块命令列表
+// ============================================================================
+void D3DManager::RecordScenePass(const RenderSnapshot& snapshot, FrameContext& frame)
+{
+    PROFILE_SCOPE("RecordScenePass");
+
+    // 主命令列表只负责开头的屏障与清屏，绘制由各录制块的命令列表完成
+    m_commandList->End();
+
+    m_frameRtv = CurrentBackBufferView().ptr;
+    m_frameDsv = DepthStencilView().ptr;
+
+    // per-pass 常量（b1）：本帧副本中的版本落后时才重写，由各录制块各自绑定
+    if (frame.PassStamp != snapshot.PassVersion)
+    {
+        memcpy(frame.PassPage.CpuBase, &snapshot.Pass, sizeof(PassConstants));
+        frame.PassStamp = snapshot.PassVersion;
+        m_constantTracker.CountPassWrite();
+        m_constantTracker.AddBytesWritten(sizeof(PassConstants));
+    }
+
+    // 视锥剔除已在发布快照时完成（见 PublishSnapshot）
+    XMMATRIX viewProj = XMLoadFloat4x4(&snapshot.View) * XMLoadFloat4x4(&snapshot.Proj);
+    m_visibleItems.clear();
+    m_visibleItems.reserve(snapshot.Items.size());
+    for (const RenderItem& item : snapshot.Items)
+    {
+        m_visibleItems.push_back(&item);
+    }
+
+    if (snapshot.OcclusionCulling)
+    {
+        PROFILE_SCOPE("OcclusionCull");
+        CullOccludedObjects(viewProj, snapshot.Pass.EyePosW);
+    }
+
+    // 剔除后仍可见的对象决定纹理需要的 mip
+    UpdateTextureStreaming(snapshot);
+
+    // 生成排序键并基数排序：同着色器变体/几何体/纹理的对象相邻，不透明对象由近到远
+    const float nearZ = 1.0f;   // 与 UpdateCamera 中的投影参数一致
+    const float farZ = 1000.0f;
+    XMMATRIX view = XMLoadFloat4x4(&snapshot.View);
+
+    {
+        PROFILE_SCOPE("SortDraws");
+        m_renderQueue.Clear();
+        m_renderQueue.Reserve(m_visibleItems.size());
+        for (size_t i = 0; i < m_visibleItems.size(); ++i)
+        {
+            const RenderItem* obj = m_visibleItems[i];
+
+            // 偏移在迁移后会变，每帧重新查询
+            uint32_t srvIndex = m_srvAllocator->GetOffset(m_defaultSrv);
+            auto it = m_objectSrvRanges.find(obj->Key);
+            if (it != m_objectSrvRanges.end())
+            {
+                srvIndex = m_srvAllocator->GetOffset(it->second);
+            }
+
+            float viewZ = XMVectorGetZ(XMVector3TransformCoord(XMLoadFloat3(&obj->Position), view));
+            float depth01 = (viewZ - nearZ) / (farZ - nearZ);
+
+            static_assert(ShaderVariant::VariantCount <= (1u << DrawKey::PipelineBits), "shader variants must fit in the pipeline key field");
+            // 变体由对象常量中的映射方式/样式/是否采样纹理决定，与 UpdateObjectCB 写入的值一致
+            const uint32_t variant = ShaderVariant::Select((int)obj->Mapping, (int)obj->Style,
+                SamplesTexture(*obj, it != m_objectSrvRanges.end()));
+
+            m_renderQueue.Add(DrawKey::Make(0, variant, (uint32_t)obj->Type, srvIndex, depth01), (uint32_t)i);
+        }
+        m_renderQueue.Sort();
+    }
+
+    // 对象常量放在持久槽位里，只重写本帧副本中已过期的槽位；
+    // 每帧只按排序顺序写一份槽位下标表，同一批次的实例在表中连续
+    const std::vector<DrawItem>& drawItems = m_renderQueue.GetItems();
+    m_itemSlots.resize(m_visibleItems.size());
+    for (const DrawItem& item : drawItems)
+    {
+        m_itemSlots[item.ObjectIndex] = m_constantTracker.AcquireSlot(m_visibleItems[item.ObjectIndex]->Key);
+    }
+
+    bool haveInstances = !drawItems.empty() &&
+        EnsureInstanceCapacity(frame, m_constantTracker.GetSlotCapacity()) &&
+        m_uploadAllocator->Allocate((uint64_t)drawItems.size() * sizeof(uint32_t), 16, m_frameInstanceSlots);
+    if (haveInstances)
+    {
+        PROFILE_SCOPE("UpdateObjectCB");
+        uint32_t* slotTable = reinterpret_cast<uint32_t*>(m_frameInstanceSlots.Cpu);
+        for (size_t k = 0; k < drawItems.size(); ++k)
+        {
+            const uint32_t objectIndex = drawItems[k].ObjectIndex;
+            const RenderItem& obj = *m_visibleItems[objectIndex];
+            const uint32_t slot = m_itemSlots[objectIndex];
+            slotTable[k] = slot;
+
+            // 版本号全局唯一，对象删除后地址被复用也不会误判为未变化
+            const bool hasTexture = HasTexture(obj.Key);
+            const uint64_t stamp = (obj.Version << 1) | (hasTexture ? 1u : 0u);
+            if (m_constantTracker.NeedsUpload(slot, stamp))
+            {
+                UpdateObjectCB(obj, hasTexture, frame.InstancePage.CpuBase + (size_t)slot * m_objCBByteSize);
+                m_constantTracker.AddBytesWritten(sizeof(ObjectConstants));
+            }
+        }
+        m_constantTracker.AddBytesWritten(drawItems.size() * sizeof(uint32_t));
+
+        // 共享着色器变体、几何体模板和纹理的相邻对象合并为一次实例化绘制
+        m_renderQueue.BuildBatches(0, m_drawBatches);
+    }
+    else
+    {
+        m_drawBatches.clear();
+    }
+
+    // 估算每个批次的录制代价（命令数），按代价切块后在线程池上并行录制
+    m_batchCosts.resize(m_drawBatches.size());
+    for (size_t i = 0; i < m_drawBatches.size(); ++i)
+    {
+        uint64_t cost = 2; // 根常量 + 绘制
+        if (i > 0 && DrawKey::Pipeline(m_drawBatches[i].StateKey) != DrawKey::Pipeline(m_drawBatches[i - 1].StateKey))
+        {
+            cost += 1;
+        }
+        if (i == 0 || DrawKey::Srv(m_drawBatches[i].StateKey) != DrawKey::Srv(m_drawBatches[i - 1].StateKey))
+        {
+            cost += 1;
+        }
+        if (i == 0 || DrawKey::Shape(m_drawBatches[i].StateKey) != DrawKey::Shape(m_drawBatches[i - 1].StateKey))
+        {
+            cost += 2;
+        }
+        m_batchCosts[i] = cost;
+    }
+
+    PROFILE_SCOPE("RecordDraws");
+    m_parallelRecorder.Partition(m_batchCosts);
+    m_parallelRecorder.Record(*this, &m_threadPool);
+
+    m_drawStats = DrawStateStats{};
+    for (size_t c = 0; c < m_parallelRecorder.GetChunks().size(); ++c)
+    {
+        m_drawStats.Add(m_chunkStateCaches[c].GetStats());
+    }
+}
+
+// ============================================================================
+// 分块录制（IDrawRecorder 实现，可能在工作线程上执行）
+// ============================================================================
+void D3DManager::BeginChunk(uint32_t chunkIndex)
+{
+    IGraphicsCommandList* list = m_chunkLists[chunkIndex];
+    list->Begin(m_frameIndex, m_pipelineHandles[0]);
+
+    // 每条命令列表的状态相互独立，公共状态需要各自设置
+    list->SetViewport(m_screenViewport);
+    list->SetScissorRect(m_scissorRect);
+    list->SetRenderTarget(m_frameRtv, m_frameDsv);
+    list->SetRootSignature(m_rootSignatureHandle);
+    list->SetDescriptorHeap(m_srvAllocator->GetHeap());
+
+    list->SetRootConstantBuffer(1, CurrentPassCBAddress());
+    list->SetRootShaderResource(3, CurrentInstanceBufferAddress());
+    list->SetRootShaderResource(4, m_frameInstanceSlots.Gpu);
+
+    DrawStateCache& cache = m_chunkStateCaches[chunkIndex];
+    cache.Reset();
+    cache.NotePipeline(0); // Begin 时已绑定变体 0
+    cache.CountRootParameters(3);
+}
+
+void D3DManager::RecordBatch(uint32_t chunkIndex, uint32_t batchIndex)
+{
+    IGraphicsCommandList* list = m_chunkLists[chunkIndex];
+    DrawStateCache& cache = m_chunkStateCaches[chunkIndex];
+
+    const DrawBatch& batch = m_drawBatches[batchIndex];
+    const std::vector<DrawItem>& items = m_renderQueue.GetItems();
+    const RenderItem* first = m_visibleItems[items[batch.FirstItem].ObjectIndex];
+    PrimitiveShape* shape = first->Shape;
+    if (!shape)
+    {
+        return;
+    }
+
+    if (cache.SetPipeline(DrawKey::Pipeline(batch.StateKey)))
+    {
+        list->SetPipelineState(m_pipelineHandles[DrawKey::Pipeline(batch.StateKey)]);
+    }
+
+    uint32_t srvIndex = DrawKey::Srv(batch.StateKey);
+    if (cache.SetDescriptorTable(srvIndex))
+    {
+        list->SetRootDescriptorTable(2, GetSrvGpuHandle(srvIndex));
+    }
+
+    if (cache.SetGeometry(DrawKey::Shape(batch.StateKey)))
+    {
+        list->SetVertexBuffer(shape->GetVertexBufferView());
+        list->SetIndexBuffer(shape->GetIndexBufferView());
+    }
+
+    if (cache.SetTopology((uint32_t)GpuTopology::TriangleList))
+    {
+        list->SetPrimitiveTopology(GpuTopology::TriangleList);
+    }
+
+    list->SetRootConstant(0, batch.FirstItem);
+    list->DrawIndexedInstanced(shape->GetIndexCount(), batch.ItemCount, 0, 0, 0);
+    cache.CountRootParameters(1);
+    cache.CountDraw(batch.ItemCount, shape->GetIndexCount());
+}
+
+void D3DManager::EndChunk(uint32_t chunkIndex)
+{
+    m_chunkLists[chunkIndex]->End();
+}
+
+// ============================================================================
+// 软件遮挡剔除
+// ============================================================================
+void D3DManager::CullOccludedObjects(FXMMATRIX viewProj, const XMFLOAT3& eyePos)
+{
+    // 遮挡体：屏幕上足够大的立方体和平面，按投影尺寸取前若干个
+    const size_t MaxOccluders = 32;
+    const float MinOccluderSize = 0.05f;
+
+    XMVECTOR eye = XMLoadFloat3(&eyePos);
+    std::vector<std::pair<float, const RenderItem*>> occluders;
+    for (const RenderItem* obj : m_visibleItems)
+    {
+        ShapeType type = obj->Type;
+        if ((type != ShapeType::Cube && type != ShapeType::Plane) || !obj->Shape)
+        {
+            continue;
+        }
+
+        float distance = XMVectorGetX(XMVector3Length(XMLoadFloat3(&obj->Position) - eye));
+        float size = obj->BoundingRadius / (distance > 1.0f ? distance : 1.0f);
+        if (size >= MinOccluderSize)
+        {
+            occluders.emplace_back(size, obj);
+        }
+    }
+
+    if (occluders.empty())
+    {
+        m_occlusionCuller.BeginFrame(viewProj);
+        return;
+    }
+
+    std::sort(occluders.begin(), occluders.end(),
+        [](const std::pair<float, const RenderItem*>& a, const std::pair<float, const RenderItem*>& b)
+        {
+            return a.first > b.first;
+        });
+    if (occluders.size() > MaxOccluders)
+    {
+        occluders.resize(MaxOccluders);
+    }
+
+    m_occlusionCuller.BeginFrame(viewProj);
+    for (const auto& entry : occluders)
+    {
+        PrimitiveShape* shape = entry.second->Shape;
+        m_occlusionCuller.AddOccluder(XMLoadFloat4x4(&entry.second->World),
+            shape->GetCpuPositions(), shape->GetCpuIndices());
+    }
+    m_occlusionCuller.RasterizeOccluders(&m_threadPool);
+
+    // 被遮挡体：视锥剔除后剩下的全部对象
+    size_t count = m_visibleItems.size();
+    std::vector<XMFLOAT3> centers(count);
+    std::vector<float> radii(count);
+    std::vector<uint8_t> visible(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        centers[i] = m_visibleItems[i]->Position;
+        radii[i] = m_visibleItems[i]->BoundingRadius;
+    }
+    m_occlusionCuller.TestOccludees(centers.data(), radii.data(), count, visible.data(), &m_threadPool);
+
+    size_t writeIndex = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (visible[i])
+        {
+            m_visibleItems[writeIndex++] = m_visibleItems[i];
+        }
+    }
+    m_visibleItems.resize(writeIndex);
+}
+
+// ============================================================================
+// 场景快照与渲染线程
+// ============================================================================
+void D3DManager::PublishSnapshot()
+{
+    if (!m_sceneDirty)
+    {
+        return;
+    }
+    PROFILE_SCOPE("PublishSnapshot");
+    m_sceneDirty = false;
+
+    UpdateCamera();
+
+    // pass 常量在 UI 线程打包；与上次发布的不同才递增版本，渲染线程据此决定是否重写
+    XMMATRIX viewProj = XMLoadFloat4x4(&m_view) * XMLoadFloat4x4(&m_proj);
+    PassConstants pass{};
+    BuildPassConstants(pass);
+    uint32_t reasons = InvalidateReason::Scene;
+    if (m_passVersion == 0 || memcmp(&pass, &m_publishedPass, sizeof(PassConstants)) != 0)
+    {
+        m_publishedPass = pass;
+        ++m_passVersion;
+        reasons |= InvalidateReason::View;
+    }
+
+    RenderSnapshot& snapshot = m_snapshots.BeginWrite();
+    snapshot.View = m_view;
+    snapshot.Proj = m_proj;
+    snapshot.Pass = m_publishedPass;
+    snapshot.PassVersion = m_passVersion;
+    snapshot.OcclusionCulling = m_occlusionCulling;
+    snapshot.SceneObjectCount = (uint32_t)m_sceneObjects.size();
+
+    // 可见集只取决于相机和场景，两者都归 UI 线程所有，发布时顺带做视锥剔除
+    m_frustumObjects.clear();
+    m_spatialGrid.QueryFrustum(Frustum::FromViewProj(viewProj), m_frustumObjects);
+
+    snapshot.Items.resize(m_frustumObjects.size());
+    for (size_t i = 0; i < m_frustumObjects.size(); ++i)
+    {
+        FillRenderItem(*m_frustumObjects[i], snapshot.Items[i]);
+    }
+
+    m_snapshots.Publish();
+    m_frameInvalidator.Invalidate(reasons);
+}
+
+void D3DManager::BuildPassConstants(PassConstants& pass) const
+{
+    XMMATRIX viewProj = XMLoadFloat4x4(&m_view) * XMLoadFloat4x4(&m_proj);
+    XMStoreFloat4x4(&pass.ViewProj, XMMatrixTranspose(viewProj));
+    pass.LightPosW = XMFLOAT3(m_lightSettings.PosX, m_lightSettings.PosY, m_lightSettings.PosZ);
+    pass.Ambient = m_lightSettings.Ambient;
+    pass.Diffuse = m_lightSettings.Diffuse;
+    pass.Specular = m_lightSettings.Specular;
+    pass.Shininess = m_lightSettings.Shininess;
+    pass.EyePosW = m_eyePos;
+}
+
+void D3DManager::FillRenderItem(const SceneObject& obj, RenderItem& item)
+{
+    item.Key = &obj;
+    item.Version = obj.GetVersion();
+    item.Shape = obj.GetShape();
+    item.Type = obj.GetType();
+    XMStoreFloat4x4(&item.World, obj.GetWorldMatrix());
+    item.Position = obj.GetPosition();
+    item.BoundingRadius = obj.GetBoundingRadius();
+    item.Selected = obj.IsSelected();
+    item.Mat = obj.GetMaterial();
+    item.Mapping = obj.GetTextureMappingMode();
+    item.Style = obj.GetTextureStyle();
+}
+
+void D3DManager::PostRenderCommand(std::function<void()> command, uint32_t reason)
+{
+    // 命令在渲染线程的下一帧开头执行，需要唤醒它
+    m_renderCommands.Push(std::move(command));
+    m_frameInvalidator.Invalidate(reason);
+}
+
+void D3DManager::StartRenderThread()
+{
+    if (m_renderThread.joinable())
+    {
+        return;
+    }
+
+    m_frameInvalidator.Reset();
+    m_sceneDirty = true;
+    PublishSnapshot();
+
+    // 没有失效时阻塞在 WaitForFrame 里，不占 CPU 也不让 GPU 空转
+    m_renderThread = std::thread([this]()
+    {
+        FrameProfiler::Instance().SetThreadName("Render");
+        while (m_frameInvalidator.WaitForFrame() != 0)
+        {
+            Render();
+        }
+    });
+}
+
+void D3DManager::StopRenderThread()
 {
-    if (!m_hWnd)
+    if (!m_renderThread.joinable())
     {
         return;
     }
-    (void)ShowLightDialog(m_hWnd, m_lightSettings);
 
+    m_frameInvalidator.Stop();
+    m_renderThread.join();
+
+    // 渲染线程退出后由调用线程接管：执行剩下的命令（如纹理释放）
+    m_renderCommands.Drain();
 }
 
 // ============================================================================
-// Ⱦ
+// 软件渲染导出
 // ============================================================================
-void D3DManager::Render()
+bool D3DManager::SaveSoftwareRender(const std::wstring& path)
 {
-    m_commandAllocator->Reset();
-    m_commandList->Reset(m_commandAllocator.Get(), m_pipelineState.Get());
-
-    m_commandList->RSSetViewports(1, &m_screenViewport);
-    m_commandList->RSSetScissorRects(1, &m_scissorRect);
-
-    CD3DX12_RESOURCE_BARRIER barrier1 = CD3DX12_RESOURCE_BARRIER::Transition(
-        CurrentBackBuffer(),
-        D3D12_RESOURCE_STATE_PRESENT,
-        D3D12_RESOURCE_STATE_RENDER_TARGET
-    );
-    m_commandList->ResourceBarrier(1, &barrier1);
-
-    const float clearColor[] = { 0.2f, 0.3f, 0.4f, 1.0f };
-    m_commandList->ClearRenderTargetView(CurrentBackBufferView(), clearColor, 0, nullptr);
-    m_commandList->ClearDepthStencilView(DepthStencilView(),
-        D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
+    PROFILE_SCOPE("SaveSoftwareRender");
 
-    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = CurrentBackBufferView();
-    D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle = DepthStencilView();
-    m_commandList->OMSetRenderTargets(1, &rtvHandle, false, &dsvHandle);
+    return RenderSoftwareFrame() && m_softwareRasterizer.SaveBmp(std::filesystem::path(path));
+}
 
-    m_commandList->SetGraphicsRootSignature(m_rootSignature.Get());
+bool D3DManager::RenderSoftwareFrame()
+{
 
-    ID3D12DescriptorHeap* heaps[] = { m_srvHeap.Get() };
-    m_commandList->SetDescriptorHeaps(_countof(heaps), heaps);
+    if (m_clientWidth <= 0 || m_clientHeight <= 0 ||
+        !m_softwareRasterizer.Resize(m_clientWidth, m_clientHeight))
+    {
+        return false;
+    }
 
     UpdateCamera();
-
-    // ² per-pass b1
     PassConstants pass{};
-    pass.LightPosW = DirectX::XMFLOAT3(m_lightSettings.PosX, m_lightSettings.PosY, m_lightSettings.PosZ);
-    pass.Ambient = m_lightSettings.Ambient;
-    pass.Diffuse = m_lightSettings.Diffuse;
-    pass.Specular = m_lightSettings.Specular;
-    pass.Shininess = m_lightSettings.Shininess;
-    pass.EyePosW = m_eyePos;
-
-    memcpy(m_passCbMappedData, &pass, sizeof(pass));
-    m_commandList->SetGraphicsRootConstantBufferView(1, m_passCB->GetGPUVirtualAddress());
-    UINT objIndex = 0;
+    BuildPassConstants(pass);
 
-    for (auto& obj : m_sceneObjects)
+    XMMATRIX view = XMLoadFloat4x4(&m_view);
+    XMMATRIX viewProj = view * XMLoadFloat4x4(&m_proj);
+    std::vector<SceneObject*> objects;
+    m_spatialGrid.QueryFrustum(Frustum::FromViewProj(viewProj), objects);
+
+    // 同一图片只解码一次；解码失败的对象与 GPU 端纹理未加载时一样不采样
+    std::unordered_map<std::wstring, SoftwareTexture> textures;
+    std::vector<std::pair<float, SoftwareDraw>> sorted;
+    sorted.reserve(objects.size());
+    for (const SceneObject* obj : objects)
     {
-        if (objIndex >= MaxObjects)
-            break; // ҪԽ
-
-        // ¸ö CB
-        UpdateObjectCB(obj.get(), objIndex);
-
-        // ΪöӦ CBV GPU ַ
-        D3D12_GPU_VIRTUAL_ADDRESS objCBAddress =
-            m_objectCB->GetGPUVirtualAddress() + objIndex * m_objCBByteSize;
-
-        m_commandList->SetGraphicsRootConstantBufferView(0, objCBAddress);
-
-        int srvIndex = 0;
-        auto it = m_objectSrvIndex.find(obj.get());
-        if (it != m_objectSrvIndex.end())
+        int type = (int)obj->GetType();
+        if (type <= 0 || type >= (int)_countof(m_softwareMeshes))
         {
-            srvIndex = it->second;
+            continue;
         }
-        m_commandList->SetGraphicsRootDescriptorTable(2, GetSrvGpuHandle(srvIndex));
-
-        PrimitiveShape* shape = obj->GetShape();
-        if (shape)
+        SoftwareMesh& mesh = m_softwareMeshes[type];
+        if (mesh.Indices.empty() && !GenerateShapeGeometry(type, mesh.Vertices, mesh.Indices))
         {
-            D3D12_VERTEX_BUFFER_VIEW vbv = shape->GetVertexBufferView();
-            D3D12_INDEX_BUFFER_VIEW ibv = shape->GetIndexBufferView();
-
-            m_commandList->IASetVertexBuffers(0, 1, &vbv);
-            m_commandList->IASetIndexBuffer(&ibv);
-            m_commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-            m_commandList->DrawIndexedInstanced(shape->GetIndexCount(), 1, 0, 0, 0);
+            continue;
         }
 
-        ++objIndex;
-    }
+        RenderItem item;
+        FillRenderItem(*obj, item);
 
-    CD3DX12_RESOURCE_BARRIER barrier2 = CD3DX12_RESOURCE_BARRIER::Transition(
-        CurrentBackBuffer(),
-        D3D12_RESOURCE_STATE_RENDER_TARGET,
-        D3D12_RESOURCE_STATE_PRESENT
-    );
-    m_commandList->ResourceBarrier(1, &barrier2);
+        const SoftwareTexture* texture = nullptr;
+        if (item.Style == TextureStyle::ImagePlaceholder && !obj->GetTexturePath().empty())
+        {
+            auto it = textures.find(obj->GetTexturePath());
+            if (it == textures.end())
+            {
+                it = textures.emplace(obj->GetTexturePath(), SoftwareTexture{}).first;
+                DecodedImage image;
+                if (m_textureDecoder.DecodeFile(it->first, image))
+                {
+                    SoftwareTexture& decoded = it->second;
+                    decoded.Width = image.Width;
+                    decoded.Height = image.Height;
+                    decoded.Pixels = std::move(image.Pixels);
+                }
+            }
+            if (!it->second.Pixels.empty())
+            {
+                texture = &it->second;
+            }
+        }
 
-    m_commandList->Close();
+        SoftwareDraw draw;
+        draw.Mesh = &mesh;
+        draw.Texture = texture;
+        UpdateObjectCB(item, texture != nullptr, reinterpret_cast<uint8_t*>(&draw.Constants));
 
-    ID3D12CommandList* cmdsLists[] = { m_commandList.Get() };
-    m_commandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+        // 由近到远画，与 GPU 端的排序一样减少被覆盖像素的着色
+        float depth = XMVectorGetZ(XMVector3TransformCoord(XMLoadFloat3(&item.Position), view));
+        sorted.emplace_back(depth, draw);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [](const std::pair<float, SoftwareDraw>& a, const std::pair<float, SoftwareDraw>& b)
+        {
+            return a.first < b.first;
+        });
 
-    m_swapChain->Present(0, 0);
-    m_currBackBuffer = (m_currBackBuffer + 1) % SwapChainBufferCount;
+    std::vector<SoftwareDraw> draws;
+    draws.reserve(sorted.size());
+    for (const auto& entry : sorted)
+    {
+        draws.push_back(entry.second);
+    }
 
-    FlushCommandQueue();
+    m_softwareRasterizer.Render(pass, draws, &m_threadPool);
+    return true;
 }
 
 // ============================================================================
-// 
+// 更新摄像机
 // ============================================================================
 void D3DManager::UpdateCamera()
 {
@@ -940,19 +2319,19 @@ void D3DManager::UpdateCamera()
 }
 
 // ============================================================================
-// ³
+// 更新常量缓冲区
 // ============================================================================
-void D3DManager::UpdateObjectCB(SceneObject* obj, UINT objectIndex)
+int D3DManager::SamplesTexture(const RenderItem& item, bool hasTexture)
 {
-    XMMATRIX world = obj->GetWorldMatrix();
-    XMMATRIX view = XMLoadFloat4x4(&m_view);
-    XMMATRIX proj = XMLoadFloat4x4(&m_proj);
-    XMMATRIX worldViewProj = world * view * proj;
+    return (item.Style == TextureStyle::ImagePlaceholder && hasTexture) ? 1 : 0;
+}
 
+void D3DManager::UpdateObjectCB(const RenderItem& item, bool hasTexture, uint8_t* dest)
+{
     ObjectConstants objConstants{};
-    XMStoreFloat4x4(&objConstants.WorldViewProj, XMMatrixTranspose(worldViewProj));
+    XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(XMLoadFloat4x4(&item.World)));
 
-    if (obj->IsSelected())
+    if (item.Selected)
     {
         objConstants.HighlightColor = XMFLOAT4(1.0f, 1.0f, 0.0f, 0.3f);
     }
@@ -961,55 +2340,118 @@ void D3DManager::UpdateObjectCB(SceneObject* obj, UINT objectIndex)
         objConstants.HighlightColor = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
     }
 
-    const auto& mat = obj->GetMaterial();
+    const auto& mat = item.Mat;
     objConstants.BaseColor = mat.BaseColor;
     objConstants.SpecularStrength = mat.SpecularStrength;
     objConstants.MatShininess = mat.Shininess;
 
-    const auto mapping = obj->GetTextureMappingMode();
-    objConstants.TexMappingMode = (int)mapping;
-    objConstants.TexStyle = (int)obj->GetTextureStyle();
-    objConstants.HasTexture = (objConstants.TexStyle == (int)TextureStyle::ImagePlaceholder && HasTexture(obj)) ? 1 : 0;
+    objConstants.TexMappingMode = (int)item.Mapping;
+    objConstants.TexStyle = (int)item.Style;
+    objConstants.HasTexture = SamplesTexture(item, hasTexture);
 
-    // ȸĬϣԺŽԻ
+    // 先给默认：可以后放进对话框参数
     objConstants.TexScale = 1.0f;
     objConstants.TexOffsetU = 0.0f;
     objConstants.TexOffsetV = 0.0f;
 
-    UINT offset = objectIndex * m_objCBByteSize;
-    memcpy(m_cbMappedData + offset, &objConstants, sizeof(ObjectConstants));
+    memcpy(dest, &objConstants, sizeof(ObjectConstants));
+}
+
+bool D3DManager::EnsureInstanceCapacity(FrameContext& frame, uint32_t slotCount)
+{
+    if (slotCount <= frame.InstanceCapacity)
+    {
+        return true;
+    }
+
+    uint32_t capacity = frame.InstanceCapacity * 2;
+    if (capacity < slotCount)
+    {
+        capacity = slotCount;
+    }
+    if (capacity < MaxObjects)
+    {
+        capacity = MaxObjects;
+    }
+
+    UploadPage page;
+    IUploadPageSource& pages = m_backend->GetUploadPageSource();
+    if (!pages.CreatePage((uint64_t)capacity * m_objCBByteSize, page))
+    {
+        return false;
+    }
+
+    // 旧副本可能仍被在途帧读取，等栅栏完成后再销毁；新副本里的槽位全部需要重写
+    if (frame.InstancePage.Handle)
+    {
+        UploadPage oldPage = frame.InstancePage;
+        m_frameRing->DeferRelease([&pages, oldPage]()
+        {
+            pages.DestroyPage(oldPage);
+        });
+    }
+    frame.InstancePage = page;
+    frame.InstanceCapacity = capacity;
+    m_constantTracker.InvalidateFrame(m_frameIndex);
+    return true;
+}
+
+uint64_t D3DManager::CurrentInstanceBufferAddress() const
+{
+    return m_frames[m_frameIndex].InstancePage.GpuBase;
+}
+
+uint64_t D3DManager::CurrentPassCBAddress() const
+{
+    return m_frames[m_frameIndex].PassPage.GpuBase;
 }
 
 // ============================================================================
-// 갴¼
+// 鼠标按下事件
 // ============================================================================
 void D3DManager::OnMouseDown(int x, int y)
 {
     m_isDragging = true;
+    m_sceneDirty = true;
     m_lastMouseX = x;
     m_lastMouseY = y;
 
+    if (m_boxSelectMode)
+    {
+        // 框选：记录起点，松开时按矩形统一查询
+        m_isBoxSelecting = true;
+        m_boxStartX = x;
+        m_boxStartY = y;
+        return;
+    }
+
     SceneObject* pickedObj = PickObject(x, y);
+    int pickedIndex = FindObjectIndex(pickedObj);
 
-    if (m_selectedObject)
+    // 点中已选集合中的对象：保留整组，后续拖动整体移动
+    if (pickedIndex >= 0 && m_selection.Test(pickedIndex))
     {
-        m_selectedObject->SetSelected(false);
+        m_selectedObject = pickedObj;
+        return;
     }
 
+    ClearSelection();
+
     m_selectedObject = pickedObj;
     if (m_selectedObject)
     {
         m_selectedObject->SetSelected(true);
-        //MessageBox(m_hWnd, L"ѡж", L"Pick", MB_OK); // 
+        m_selection.Set(pickedIndex);
+        //MessageBox(m_hWnd, L"选中对象", L"Pick", MB_OK); // 调试用
     }
     else
     {
-        //MessageBox(m_hWnd, L"δѡκζ", L"Pick", MB_OK); // 
+        //MessageBox(m_hWnd, L"未选中任何对象", L"Pick", MB_OK); // 调试用
     }
 }
 
 // ============================================================================
-// ƶ¼
+// 鼠标移动事件
 // ============================================================================
 void D3DManager::OnMouseMove(int x, int y)
 {
@@ -1017,24 +2459,34 @@ void D3DManager::OnMouseMove(int x, int y)
     int dx = x - m_lastMouseX;
     int dy = y - m_lastMouseY;
 
-    // ѡжʱ϶
-    if (m_selectedObject)
+    if (m_isBoxSelecting)
+    {
+        // 框选进行中：只记录当前角点
+        m_lastMouseX = x;
+        m_lastMouseY = y;
+        return;
+    }
+
+    m_sceneDirty = true;
+
+    // 选中对象时：拖动物体（整组）
+    if (m_selection.Any())
     {
-        // ϵƽѡ
-         // dx: ҷdy: ϷĻΪ
-        float moveScale = 0.01f; //  -> 絥λıе
+        // 按相机坐标系平移选中物体
+         // dx: 沿相机右方向，dy: 沿相机上方向（屏幕向下为负）
+        float moveScale = 0.01f; // 鼠标像素 -> 世界单位的比例，可自行调节
 
-        // ǰ
+        // 当前相机参数
         XMVECTOR eye = XMLoadFloat3(&m_eyePos);
         XMVECTOR target = XMLoadFloat3(&m_lookAt);
         XMVECTOR worldUp = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
 
-        // ǰ//Ϸ꣩
+        // 相机前/右/上方向（世界坐标）
         XMVECTOR forward = XMVector3Normalize(target - eye);
         XMVECTOR right = XMVector3Normalize(XMVector3Cross(worldUp, forward));
         XMVECTOR camUp = XMVector3Normalize(XMVector3Cross(forward, right));
 
-        // ƶռλ
+        // 根据鼠标移动计算世界空间位移
         XMVECTOR delta = XMVectorZero();
         if (dx != 0)
         {
@@ -1042,46 +2494,41 @@ void D3DManager::OnMouseMove(int x, int y)
         }
         if (dy != 0)
         {
-            delta += camUp * (-dy * moveScale); // ĻΪϷȡ -dy
+            delta += camUp * (-dy * moveScale); // 屏幕向下为正，所以上方向取 -dy
         }
 
-        XMFLOAT3 currentPos = m_selectedObject->GetPosition();
-        XMVECTOR pos = XMLoadFloat3(&currentPos);
-        pos += delta;
-        XMStoreFloat3(&currentPos, pos);
-
-        m_selectedObject->SetPosition(currentPos);
+        TranslateSelection(delta);
     }
     else
     {
-        // δѡжʱת
-        //  m_lookAt Ϊģ Y  X ת eyePos
-        float rotateSpeed = 0.005f; // 
+        // 未选中对象时：旋转摄像机
+        // 以 m_lookAt 为中心，绕 Y 轴和 X 轴旋转 eyePos
+        float rotateSpeed = 0.005f; // 调整灵敏度
 
-        float yaw = -dx * rotateSpeed; // ˮƽ
-        float pitch = -dy * rotateSpeed; // ֱ
+        float yaw = -dx * rotateSpeed; // 水平
+        float pitch = -dy * rotateSpeed; // 垂直
 
-        // eyePos ĵ
+        // eyePos 相对中心点的向量
         XMVECTOR center = XMLoadFloat3(&m_lookAt);
         XMVECTOR eye = XMLoadFloat3(&m_eyePos);
         XMVECTOR offset = eye - center;
 
-        //  Y תˮƽ
+        // 绕 Y 轴旋转（水平）
         XMMATRIX rotY = XMMatrixRotationY(yaw);
         offset = XMVector3TransformNormal(offset, rotY);
 
-        // 㵱ǰĵľǣ pitch ת
+        // 计算当前到中心的距离和仰角，避免 pitch 过大翻转
         XMVECTOR rVec = offset;
         float radius = XMVectorGetX(XMVector3Length(rVec));
 
         if (radius > 0.0001f)
         {
-            //  offset ת꣬ pitch
+            // 把 offset 转换到球坐标，限制 pitch
             float cx = XMVectorGetX(offset);
             float cy = XMVectorGetY(offset);
             float cz = XMVectorGetZ(offset);
 
-            float theta = atan2f(cz, cx);         // ˮƽ
+            float theta = atan2f(cz, cx);         // 水平角
             float phi = acosf(cy / radius);     // 0..pi
 
             phi += pitch;
@@ -1090,7 +2537,7 @@ void D3DManager::OnMouseMove(int x, int y)
             if (phi < phiMin) phi = phiMin;
             if (phi > phiMax) phi = phiMax;
 
-            // תصѿ
+            // 重新由球坐标转回笛卡尔坐标
             float sinPhi = sinf(phi);
             float cosPhi = cosf(phi);
             float cosTheta = cosf(theta);
@@ -1103,7 +2550,7 @@ void D3DManager::OnMouseMove(int x, int y)
             offset = XMVectorSet(nx, ny, nz, 0.0f);
         }
 
-        //  eyePos
+        // 更新 eyePos
         eye = center + offset;
         XMStoreFloat3(&m_eyePos, eye);
     }
@@ -1113,56 +2560,67 @@ void D3DManager::OnMouseMove(int x, int y)
 }
 
 // ============================================================================
-// ͷ¼
+// 鼠标释放事件
 // ============================================================================
 void D3DManager::OnMouseUp()
 {
+    if (m_isBoxSelecting)
+    {
+        SelectInRect(m_boxStartX, m_boxStartY, m_lastMouseX, m_lastMouseY);
+        m_isBoxSelecting = false;
+        m_sceneDirty = true;
+    }
+
     m_isDragging = false;
 }
 
 // ============================================================================
-// ¼
+// 鼠标滚轮事件
 // ============================================================================
 void D3DManager::OnMouseWheel(int delta)
 {
-    if (m_selectedObject)
+    if (m_selection.Any())
     {
-        // ǰ/ƶѡ
-         // delta > 0ǰ߷delta < 0Զ
-        float moveStep = 0.5f; // λе
+        // 滚轮沿摄像机前/后方向移动选中物体
+         // delta > 0：向前靠近相机视线方向；delta < 0：远离
+        float moveStep = 0.5f; // 单位可自行调整
         float amount = (delta > 0) ? moveStep : -moveStep;
 
-        // 
+        // 相机参数
         XMVECTOR eye = XMLoadFloat3(&m_eyePos);
         XMVECTOR target = XMLoadFloat3(&m_lookAt);
 
-        // ǰ꣩
+        // 相机前方向（世界坐标）
         XMVECTOR forward = XMVector3Normalize(target - eye);
 
-        // ǰλ + ǰ * amount
-        XMFLOAT3 currentPos = m_selectedObject->GetPosition();
-        XMVECTOR pos = XMLoadFloat3(&currentPos);
-
-        pos += forward * amount;
-
-        XMStoreFloat3(&currentPos, pos);
-        m_selectedObject->SetPosition(currentPos);
+        // 当前位置 + 前方向 * amount
+        TranslateSelection(forward * amount);
+        m_sceneDirty = true;
     }
 }
 
 // ============================================================================
-// ʰȡ
+// 射线拾取对象
 // ============================================================================
 SceneObject* D3DManager::PickObject(int mouseX, int mouseY)
 {
+    PROFILE_SCOPE("PickObject");
+
     XMVECTOR rayOrigin, rayDir;
     ScreenToWorldRay(mouseX, mouseY, rayOrigin, rayDir);
 
     float minDistance = FLT_MAX;
     SceneObject* closestObject = nullptr;
 
-    // жҵཻ
-    for (auto& obj : m_sceneObjects)
+    // 先用空间网格筛出射线附近的候选（最远到远裁面）
+    XMFLOAT3 origin, dir;
+    XMStoreFloat3(&origin, rayOrigin);
+    XMStoreFloat3(&dir, rayDir);
+    std::vector<SceneObject*> candidates;
+    m_spatialGrid.QueryRay(origin, dir, 1000.0f, candidates);
+
+    // 在候选中找到最近的相交对象
+    for (SceneObject* obj : candidates)
     {
         float distance;
         if (obj->IntersectRay(rayOrigin, rayDir, distance))
@@ -1170,7 +2628,7 @@ SceneObject* D3DManager::PickObject(int mouseX, int mouseY)
             if (distance < minDistance)
             {
                 minDistance = distance;
-                closestObject = obj.get();
+                closestObject = obj;
             }
         }
     }
@@ -1179,191 +2637,234 @@ SceneObject* D3DManager::PickObject(int mouseX, int mouseY)
 }
 
 // ============================================================================
-// Ļת
+// 多选
 // ============================================================================
-void D3DManager::ScreenToWorldRay(int mouseX, int mouseY,
-    XMVECTOR& rayOrigin,
-    XMVECTOR& rayDir)
+int D3DManager::FindObjectIndex(const SceneObject* obj) const
 {
-    // Ļ -> NDC
-    float ndcX = (2.0f * mouseX) / m_clientWidth - 1.0f;
-    float ndcY = 1.0f - (2.0f * mouseY) / m_clientHeight;
-
-    // ׼
-    XMMATRIX proj = XMLoadFloat4x4(&m_proj);
-    XMMATRIX view = XMLoadFloat4x4(&m_view);
-    XMMATRIX invProj = XMMatrixInverse(nullptr, proj);
-    XMMATRIX invView = XMMatrixInverse(nullptr, view);
-
-    // Զϵĵ㣨NDC
-    XMVECTOR ndcNear = XMVectorSet(ndcX, ndcY, 0.0f, 1.0f);
-    XMVECTOR ndcFar = XMVectorSet(ndcX, ndcY, 1.0f, 1.0f);
-
-    // NDC -> ӿռ
-    XMVECTOR viewNear = XMVector4Transform(ndcNear, invProj);
-    XMVECTOR viewFar = XMVector4Transform(ndcFar, invProj);
-
-    viewNear = XMVectorScale(viewNear, 1.0f / XMVectorGetW(viewNear));
-    viewFar = XMVectorScale(viewFar, 1.0f / XMVectorGetW(viewFar));
-
-    // ӿռ -> ռ
-    XMVECTOR worldNear = XMVector4Transform(viewNear, invView);
-    XMVECTOR worldFar = XMVector4Transform(viewFar, invView);
-
-    worldNear = XMVectorSetW(worldNear, 1.0f);
-    worldFar = XMVectorSetW(worldFar, 1.0f);
+    if (!obj)
+    {
+        return -1;
+    }
 
-    rayOrigin = worldNear;
-    rayDir = XMVector3Normalize(worldFar - worldNear);
+    // 下标随对象保存，增删时维护；这里只核对它仍指向同一个对象
+    const uint32_t index = obj->GetSceneIndex();
+    return index < m_sceneObjects.size() && m_sceneObjects[index].get() == obj ? (int)index : -1;
 }
 
-bool D3DManager::CreateTextureFromFile(const std::wstring& path,
-    ComPtr<ID3D12Resource>& texture,
-    D3D12_CPU_DESCRIPTOR_HANDLE srvHandle)
+void D3DManager::ClearSelection()
 {
-    HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-    if (FAILED(hr) && hr != RPC_E_CHANGED_MODE)
+    m_selection.ForEach([&](size_t i)
     {
-        return false;
-    }
-
-    ComPtr<IWICImagingFactory> wicFactory;
-    hr = CoCreateInstance(CLSID_WICImagingFactory2, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wicFactory));
-    if (FAILED(hr))
+        if (i < m_sceneObjects.size())
+        {
+            m_sceneObjects[i]->SetSelected(false);
+        }
+    });
+    if (m_selectedObject)
     {
-        return false;
+        m_selectedObject->SetSelected(false);
     }
 
-    ComPtr<IWICBitmapDecoder> decoder;
-    hr = wicFactory->CreateDecoderFromFilename(path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &decoder);
-    if (FAILED(hr))
-    {
-        return false;
-    }
+    m_selection.Clear();
+    m_selectedObject = nullptr;
+}
 
-    ComPtr<IWICBitmapFrameDecode> frame;
-    hr = decoder->GetFrame(0, &frame);
-    if (FAILED(hr))
+void D3DManager::SelectInRect(int x0, int y0, int x1, int y1)
+{
+    PROFILE_SCOPE("SelectInRect");
+
+    ClearSelection();
+
+    Frustum subFrustum;
+    if (!Frustum::FromScreenRect(XMLoadFloat4x4(&m_view), XMLoadFloat4x4(&m_proj), m_clientWidth, m_clientHeight,
+        x0, y0, x1, y1, subFrustum))
     {
-        return false;
+        return; // 矩形太小，视为取消选择
     }
 
-    UINT width = 0, height = 0;
-    frame->GetSize(&width, &height);
-    if (width == 0 || height == 0)
+    // SoA 包围球，一次性批量测试，结果直接写入选中位集
+    const size_t count = m_sceneObjects.size();
+    std::vector<float> cx(count), cy(count), cz(count), radius(count);
+    for (size_t i = 0; i < count; ++i)
     {
-        return false;
+        XMFLOAT3 pos = m_sceneObjects[i]->GetPosition();
+        cx[i] = pos.x;
+        cy[i] = pos.y;
+        cz[i] = pos.z;
+        radius[i] = m_sceneObjects[i]->GetBoundingRadius();
     }
 
-    ComPtr<IWICFormatConverter> converter;
-    hr = wicFactory->CreateFormatConverter(&converter);
-    if (FAILED(hr))
+    m_selection.Resize(count);
+    subFrustum.TestSpheres(cx.data(), cy.data(), cz.data(), radius.data(), count, m_selection.Words());
+
+    m_selection.ForEach([&](size_t i)
     {
-        return false;
-    }
+        m_sceneObjects[i]->SetSelected(true);
+        if (!m_selectedObject)
+        {
+            m_selectedObject = m_sceneObjects[i].get();
+        }
+    });
+}
 
-    hr = converter->Initialize(
-        frame.Get(),
-        GUID_WICPixelFormat32bppRGBA,
-        WICBitmapDitherTypeNone,
-        nullptr,
-        0.0,
-        WICBitmapPaletteTypeCustom);
-    if (FAILED(hr))
+void D3DManager::TranslateSelection(FXMVECTOR delta)
+{
+    // 开启拖动碰撞时，整组只移动到首次接触处
+    XMVECTOR move = delta;
+    if (m_dragCollision)
     {
-        return false;
+        move = delta * ComputeSelectionContactTime(delta);
     }
 
-    std::vector<BYTE> pixelData(width * height * 4);
-    hr = converter->CopyPixels(nullptr, width * 4, static_cast<UINT>(pixelData.size()), pixelData.data());
-    if (FAILED(hr))
+    // 一次遍历位集，对整组施加同一位移
+    m_selection.ForEach([&](size_t i)
     {
-        return false;
-    }
+        if (i >= m_sceneObjects.size())
+        {
+            return;
+        }
 
-    CD3DX12_RESOURCE_DESC texDesc = CD3DX12_RESOURCE_DESC::Tex2D(
-        DXGI_FORMAT_R8G8B8A8_UNORM, width, height, 1, 1);
-    CD3DX12_HEAP_PROPERTIES defaultHeap(D3D12_HEAP_TYPE_DEFAULT);
+        SceneObject* obj = m_sceneObjects[i].get();
+        XMFLOAT3 currentPos = obj->GetPosition();
+        XMVECTOR pos = XMLoadFloat3(&currentPos) + move;
+        XMStoreFloat3(&currentPos, pos);
 
-    hr = m_d3dDevice->CreateCommittedResource(
-        &defaultHeap,
-        D3D12_HEAP_FLAG_NONE,
-        &texDesc,
-        D3D12_RESOURCE_STATE_COPY_DEST,
-        nullptr,
-        IID_PPV_ARGS(&texture));
-    if (FAILED(hr))
-    {
-        return false;
-    }
+        obj->SetPosition(currentPos);
+        UpdateSpatialEntry(obj);
+    });
+}
 
-    UINT64 uploadBufferSize = GetRequiredIntermediateSize(texture.Get(), 0, 1);
-    CD3DX12_HEAP_PROPERTIES uploadHeap(D3D12_HEAP_TYPE_UPLOAD);
-    CD3DX12_RESOURCE_DESC uploadDesc = CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize);
-    ComPtr<ID3D12Resource> uploadBuffer;
-    hr = m_d3dDevice->CreateCommittedResource(
-        &uploadHeap,
-        D3D12_HEAP_FLAG_NONE,
-        &uploadDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&uploadBuffer));
-    if (FAILED(hr))
+float D3DManager::ComputeSelectionContactTime(FXMVECTOR delta)
+{
+    XMFLOAT3 d;
+    XMStoreFloat3(&d, delta);
+    const float moveDelta[3] = { d.x, d.y, d.z };
+
+    // 进入距离在 ContactSlop 以内视为贴合：继续压入被阻挡，沿接触面滑动或反向离开放行
+    const float ContactSlop = 1e-3f;
+
+    float contactTime = 1.0f;
+    std::vector<SceneObject*> candidates;
+
+    m_selection.ForEach([&](size_t i)
     {
-        return false;
-    }
+        if (i >= m_sceneObjects.size())
+        {
+            return;
+        }
 
-    D3D12_SUBRESOURCE_DATA subResource{};
-    subResource.pData = pixelData.data();
-    subResource.RowPitch = width * 4;
-    subResource.SlicePitch = subResource.RowPitch * height;
+        SceneObject* obj = m_sceneObjects[i].get();
+        auto it = m_broadphaseHandles.find(obj);
+        if (it == m_broadphaseHandles.end())
+        {
+            return;
+        }
 
-    m_commandAllocator->Reset();
-    m_commandList->Reset(m_commandAllocator.Get(), nullptr);
+        XMFLOAT3 boxMin, boxMax;
+        obj->GetWorldAABB(boxMin, boxMax);
+        const float minA[3] = { boxMin.x, boxMin.y, boxMin.z };
+        const float maxA[3] = { boxMax.x, boxMax.y, boxMax.z };
+
+        // 用整段位移的扫掠包围盒更新宽相位，取出可能接触的对象；
+        // 移动结束后 UpdateSpatialEntry 会写回真实包围盒
+        XMFLOAT3 sweptMin(
+            boxMin.x + (d.x < 0.0f ? d.x : 0.0f),
+            boxMin.y + (d.y < 0.0f ? d.y : 0.0f),
+            boxMin.z + (d.z < 0.0f ? d.z : 0.0f));
+        XMFLOAT3 sweptMax(
+            boxMax.x + (d.x > 0.0f ? d.x : 0.0f),
+            boxMax.y + (d.y > 0.0f ? d.y : 0.0f),
+            boxMax.z + (d.z > 0.0f ? d.z : 0.0f));
+        m_broadphase.Update(it->second, sweptMin, sweptMax);
+
+        candidates.clear();
+        m_broadphase.QueryOverlaps(it->second, candidates);
+
+        for (SceneObject* other : candidates)
+        {
+            if (other->IsSelected())
+            {
+                continue; // 同组对象一起移动，互不阻挡
+            }
 
-    UpdateSubresources(m_commandList.Get(), texture.Get(), uploadBuffer.Get(), 0, 0, 1, &subResource);
-    auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-        texture.Get(),
-        D3D12_RESOURCE_STATE_COPY_DEST,
-        D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-    m_commandList->ResourceBarrier(1, &barrier);
+            XMFLOAT3 otherMin, otherMax;
+            other->GetWorldAABB(otherMin, otherMax);
+            const float minB[3] = { otherMin.x, otherMin.y, otherMin.z };
+            const float maxB[3] = { otherMax.x, otherMax.y, otherMax.z };
+
+            // 逐轴 slab 求进入/离开时刻，同时记下决定进入时刻的轴上的进入距离
+            float tEnter = -FLT_MAX;
+            float tExit = FLT_MAX;
+            float enterDistance = -FLT_MAX;
+            bool separated = false;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (moveDelta[axis] == 0.0f)
+                {
+                    if (maxA[axis] < minB[axis] || maxB[axis] < minA[axis])
+                    {
+                        separated = true;
+                    }
+                    continue;
+                }
+
+                float invD = 1.0f / moveDelta[axis];
+                float t0 = (minB[axis] - maxA[axis]) * invD;
+                float t1 = (maxB[axis] - minA[axis]) * invD;
+                if (t0 > t1)
+                {
+                    std::swap(t0, t1);
+                }
+                if (t0 > tEnter)
+                {
+                    tEnter = t0;
+                    enterDistance = t0 * fabsf(moveDelta[axis]);
+                }
+                tExit = (t1 < tExit) ? t1 : tExit;
+            }
 
-    m_commandList->Close();
-    ID3D12CommandList* cmdsLists[] = { m_commandList.Get() };
-    m_commandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
-    FlushCommandQueue();
+            // 已经嵌入（进入距离明显为负）的不阻挡，允许把对象拖出来
+            if (separated || enterDistance < -ContactSlop || tEnter > tExit)
+            {
+                continue;
+            }
 
-    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-    srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-    srvDesc.Texture2D.MostDetailedMip = 0;
-    srvDesc.Texture2D.MipLevels = 1;
+            if (tEnter < contactTime && tExit > 0.0f)
+            {
+                contactTime = (tEnter > 0.0f) ? tEnter : 0.0f;
+            }
+        }
+    });
 
-    m_d3dDevice->CreateShaderResourceView(texture.Get(), &srvDesc, srvHandle);
+    return contactTime;
+}
 
-    return true;
+// ============================================================================
+// 屏幕坐标转世界射线
+// ============================================================================
+void D3DManager::ScreenToWorldRay(int mouseX, int mouseY,
+    XMVECTOR& rayOrigin,
+    XMVECTOR& rayDir)
+{
+    ScreenPointToRay(XMLoadFloat4x4(&m_view), XMLoadFloat4x4(&m_proj), m_clientWidth, m_clientHeight,
+        mouseX, mouseY, rayOrigin, rayDir);
 }
 
-D3D12_CPU_DESCRIPTOR_HANDLE D3DManager::GetSrvCpuHandle(int index) const
+D3D12_CPU_DESCRIPTOR_HANDLE D3DManager::GetSrvCpuHandle(uint32_t offset) const
 {
-    return CD3DX12_CPU_DESCRIPTOR_HANDLE(
-        m_srvHeap->GetCPUDescriptorHandleForHeapStart(),
-        index,
-        m_cbvSrvUavDescriptorSize);
+    // 写入的是暂存堆，写完需要 m_srvAllocator->Publish
+    D3D12_CPU_DESCRIPTOR_HANDLE handle = { (SIZE_T)m_srvAllocator->GetCpuHandle(offset) };
+    return handle;
 }
 
-D3D12_GPU_DESCRIPTOR_HANDLE D3DManager::GetSrvGpuHandle(int index) const
+uint64_t D3DManager::GetSrvGpuHandle(uint32_t offset) const
 {
-    return CD3DX12_GPU_DESCRIPTOR_HANDLE(
-        m_srvHeap->GetGPUDescriptorHandleForHeapStart(),
-        index,
-        m_cbvSrvUavDescriptorSize);
+    return m_srvAllocator->GetGpuHandle(offset);
 }
 
-bool D3DManager::HasTexture(SceneObject* obj) const
+bool D3DManager::HasTexture(const SceneObject* key) const
 {
-    return m_objectSrvIndex.find(obj) != m_objectSrvIndex.end();
+    return m_objectSrvRanges.find(key) != m_objectSrvRanges.end();
 }
 
 void D3DManager::ReleaseTexture(SceneObject* obj)
@@ -1373,120 +2874,192 @@ void D3DManager::ReleaseTexture(SceneObject* obj)
         return;
     }
 
-    auto itIndex = m_objectSrvIndex.find(obj);
-    if (itIndex != m_objectSrvIndex.end())
+    const SceneObject* key = obj;
+    PostRenderCommand([this, key]()
+    {
+        DestroyTexture(key);
+    });
+}
+
+void D3DManager::DestroyTexture(const SceneObject* key)
+{
+    // 对象放掉引用；纹理和 SRV 槽在缓存淘汰时才延迟回收
+    ReleasePendingTexture(key);
+    m_objectSrvRanges.erase(key);
+
+    auto itTexture = m_objectTextures.find(key);
+    if (itTexture != m_objectTextures.end())
+    {
+        const TextureCacheId id = itTexture->second;
+        m_objectTextures.erase(itTexture);
+        ReleaseTextureReference(id);
+    }
+}
+
+void D3DManager::DestroyAllTextures()
+{
+    // 没有引用的纹理按缓存预算留在 LRU 中，重新添加使用同一图片的对象时直接命中
+    for (const auto& entry : m_objectPendingTextures)
+    {
+        ReleaseTextureReference(entry.second);
+    }
+    m_objectPendingTextures.clear();
+    for (const auto& entry : m_objectTextures)
+    {
+        ReleaseTextureReference(entry.second);
+    }
+    m_objectTextures.clear();
+    m_objectSrvRanges.clear();
+}
+
+void D3DManager::UpdateSpatialEntry(SceneObject* obj)
+{
+    auto it = m_spatialHandles.find(obj);
+    if (it != m_spatialHandles.end())
     {
-        m_freeSrvIndices.push_back(itIndex->second);
-        m_objectSrvIndex.erase(itIndex);
+        m_spatialGrid.Update(it->second, obj->GetPosition(), obj->GetBoundingRadius());
     }
 
-    m_objectTextures.erase(obj);
+    auto itBroadphase = m_broadphaseHandles.find(obj);
+    if (itBroadphase != m_broadphaseHandles.end())
+    {
+        XMFLOAT3 boxMin, boxMax;
+        obj->GetWorldAABB(boxMin, boxMax);
+        m_broadphase.Update(itBroadphase->second, boxMin, boxMax);
+    }
 }
 
 // ============================================================================
-// ˢУȴGPUɣ
+// 刷新命令队列（等待GPU完成）
 // ============================================================================
 void D3DManager::FlushCommandQueue()
 {
-    m_currentFence++;
+    PROFILE_SCOPE("FlushCommandQueue");
 
-    m_commandQueue->Signal(m_fence.Get(), m_currentFence);
-
-    if (m_fence->GetCompletedValue() < m_currentFence)
+    // 等 GPU 完成全部已提交工作，顺带执行所有延迟释放
+    if (m_frameRing)
     {
-        m_fence->SetEventOnCompletion(m_currentFence, m_fenceEvent);
-        WaitForSingleObject(m_fenceEvent, INFINITE);
+        m_frameRing->WaitIdle();
     }
 }
 
 // ============================================================================
-// ڴСı
+// 窗口大小改变
 // ============================================================================
 void D3DManager::OnResize(int width, int height)
 {
     if (width <= 0 || height <= 0)
         return;
 
+    // 投影与拾取立即使用新尺寸；交换链由渲染线程在下一帧开始前重建
     m_clientWidth = width;
     m_clientHeight = height;
+    m_sceneDirty = true;
+
+    PostRenderCommand([this, width, height]()
+    {
+        ResizeSwapChain(width, height);
+    }, InvalidateReason::Resize);
+}
+
+void D3DManager::ResizeSwapChain(int width, int height)
+{
+    PROFILE_SCOPE("ResizeSwapChain");
+
+    m_backBufferWidth = width;
+    m_backBufferHeight = height;
 
     FlushCommandQueue();
+    SetViewport(m_backBufferWidth, m_backBufferHeight);
 
-    m_commandList->Reset(m_commandAllocator.Get(), nullptr);
+    // 录制后端没有交换链，只更新尺寸
+    if (!m_swapChain)
+    {
+        return;
+    }
 
-    // ͷžԴ
+    // 释放旧资源
     for (int i = 0; i < SwapChainBufferCount; ++i)
         m_swapChainBuffer[i].Reset();
     m_depthStencilBuffer.Reset();
 
-    // С
+    // 调整交换链大小
     m_swapChain->ResizeBuffers(
         SwapChainBufferCount,
-        m_clientWidth, m_clientHeight,
+        m_backBufferWidth, m_backBufferHeight,
         DXGI_FORMAT_R8G8B8A8_UNORM,
         DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH
     );
 
     m_currBackBuffer = 0;
 
-    // ´RTV
+    // 重新创建RTV
     CreateRenderTargets();
 
-    // ´ģ建
+    // 重新创建深度模板缓冲区
     CreateDepthStencil();
-
-    m_commandList->Close();
-    ID3D12CommandList* cmdsLists[] = { m_commandList.Get() };
-    m_commandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
-
-    FlushCommandQueue();
-
-    // ӿ
-    m_screenViewport.TopLeftX = 0;
-    m_screenViewport.TopLeftY = 0;
-    m_screenViewport.Width = static_cast<float>(m_clientWidth);
-    m_screenViewport.Height = static_cast<float>(m_clientHeight);
-    m_screenViewport.MinDepth = 0.0f;
-    m_screenViewport.MaxDepth = 1.0f;
-
-    m_scissorRect = { 0, 0, m_clientWidth, m_clientHeight };
 }
 
 // ============================================================================
-// Դ
+// 清理资源
 // ============================================================================
 void D3DManager::Cleanup()
 {
-    if (m_d3dDevice != nullptr)
-        FlushCommandQueue();
+    StopRenderThread();
 
-    if (m_objectCB != nullptr && m_cbMappedData != nullptr)
-    {
-        m_objectCB->Unmap(0, nullptr);
-        m_cbMappedData = nullptr;
-    }
-    if (m_passCB != nullptr && m_passCbMappedData != nullptr)
-    {
-        m_passCB->Unmap(0, nullptr);
-        m_passCbMappedData = nullptr;
-    }
+    if (!m_backend)
+        return;
+
+    // 渲染线程已停止：丢弃未完成的加载，等拷贝队列空闲
+    if (m_textureLoader)
+        m_textureLoader->Shutdown(m_textureUploader.get());
+    if (m_textureUploader)
+        m_textureUploader->WaitIdle();
+
+    // 缓存中的纹理经帧环延迟释放，要赶在下面等 GPU 空闲之前交出去
+    m_objectTextures.clear();
+    m_objectPendingTextures.clear();
+    m_objectSrvRanges.clear();
+    m_textureCache.Clear();
+
+    FlushCommandQueue();
 
-    if (m_fenceEvent)
+    if (m_uploadAllocator)
+        m_uploadAllocator->ReleaseAll();
+    IUploadPageSource& pages = m_backend->GetUploadPageSource();
+    for (UINT f = 0; f < FrameCount; ++f)
     {
-        CloseHandle(m_fenceEvent);
-        m_fenceEvent = nullptr;
+        FrameContext& frame = m_frames[f];
+        if (frame.InstancePage.Handle)
+        {
+            pages.DestroyPage(frame.InstancePage);
+        }
+        if (frame.PassPage.Handle)
+        {
+            pages.DestroyPage(frame.PassPage);
+        }
+        frame.InstancePage = UploadPage{};
+        frame.InstanceCapacity = 0;
+        frame.PassPage = UploadPage{};
+        frame.PassStamp = 0;
     }
 
-    m_objectTextures.clear();
-    m_objectSrvIndex.clear();
-    m_freeSrvIndices.clear();
+    if (m_srvAllocator)
+        m_srvAllocator->ReleaseAll();
+    m_defaultSrv = InvalidDescriptorRange;
 }
 
 // ============================================================================
-// 
+// 辅助函数
 // ============================================================================
 D3D12_CPU_DESCRIPTOR_HANDLE D3DManager::CurrentBackBufferView() const
 {
+    // 录制后端没有 RTV 堆，用后台缓冲序号充当句柄
+    if (!m_rtvHeap)
+    {
+        D3D12_CPU_DESCRIPTOR_HANDLE handle = { (SIZE_T)(m_currBackBuffer + 1) };
+        return handle;
+    }
     return CD3DX12_CPU_DESCRIPTOR_HANDLE(
         m_rtvHeap->GetCPUDescriptorHandleForHeapStart(),
         m_currBackBuffer,
@@ -1496,6 +3069,11 @@ D3D12_CPU_DESCRIPTOR_HANDLE D3DManager::CurrentBackBufferView() const
 
 D3D12_CPU_DESCRIPTOR_HANDLE D3DManager::DepthStencilView() const
 {
+    if (!m_dsvHeap)
+    {
+        D3D12_CPU_DESCRIPTOR_HANDLE handle = { (SIZE_T)(SwapChainBufferCount + 1) };
+        return handle;
+    }
     return m_dsvHeap->GetCPUDescriptorHandleForHeapStart();
 }
 
@@ -12,168 +12,359 @@
 #include <memory>
 #include <vector>
 #include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include "SceneObject.h"
 #include"LightDialog.h"
+#include "SpatialGrid.h"
+#include "SweepAndPrune.h"
+#include "SelectionSet.h"
+#include "ThreadPool.h"
+#include "OcclusionCuller.h"
+#include "RenderQueue.h"
+#include "DrawStateCache.h"
+#include "ParallelRecorder.h"
+#include "RenderCommandQueue.h"
+#include "SnapshotBuffer.h"
+#include "ConstantUploadTracker.h"
+#include "FrameInvalidator.h"
+#include "D3D12GraphicsBackend.h"
+#include "D3D12TextureUploader.h"
+#include "TextureLoader.h"
+#include "TextureCache.h"
+#include "TextureStreamer.h"
+#include "WicTextureDecoder.h"
+#include "NullGraphicsBackend.h"
+#include "GpuProfiler.h"
+#include "RenderStats.h"
+#include "ShaderCache.h"
+#include "ShaderVariants.h"
+#include "ShaderConstants.h"
+#include "ShapeGeometry.h"
+#include "SoftwareRasterizer.h"
 
 using Microsoft::WRL::ComPtr;
 
-// ṹ
-struct Vertex
+// 渲染线程绘制一个对象所需的全部数据（从 SceneObject 拷贝）
+struct RenderItem
 {
-    DirectX::XMFLOAT3 Pos;
-    DirectX::XMFLOAT3 Normal;//
-    DirectX::XMFLOAT4 Color;
+    const SceneObject* Key = nullptr;   // 仅作纹理/SRV/常量槽位表的键，渲染线程不解引用
+    uint64_t Version = 0;               // SceneObject::GetVersion
+    PrimitiveShape* Shape = nullptr;    // 共享几何体模板，生命周期与 D3DManager 相同
+    ShapeType Type = ShapeType::None;
+    DirectX::XMFLOAT4X4 World;
+    DirectX::XMFLOAT3 Position;
+    float BoundingRadius = 0.0f;
+    bool Selected = false;
+    Material Mat;
+    TextureMappingMode Mapping = TextureMappingMode::Planar;
+    TextureStyle Style = TextureStyle::Checker;
 };
 
-// ṹ
-struct ObjectConstants
+// 一帧的相机与场景快照：UI 线程在状态变化后整体写入并发布，渲染线程每帧取最新一份
+struct RenderSnapshot
 {
-    DirectX::XMFLOAT4X4 WorldViewProj;
-    DirectX::XMFLOAT4 HighlightColor; // ڸѡж
-
-    DirectX::XMFLOAT3 BaseColor;
-    float SpecularStrength;
-	// 
-    float MatShininess;
-    float TexScale;
-    float TexOffsetU;
-    float TexOffsetV;
-	// ӳģʽ
-    int TexMappingMode;
-    int TexStyle;
-    int HasTexture;
-    float Pad0;
-};
-
-struct PassConstants
-{
-    DirectX::XMFLOAT3 LightPosW;
-    float Ambient;
-
-    float Diffuse;
-    float Specular;
-    float Shininess;
-    float Pad0;
-
-    DirectX::XMFLOAT3 EyePosW;
-    float Pad1;
+    DirectX::XMFLOAT4X4 View;
+    DirectX::XMFLOAT4X4 Proj;
+    PassConstants Pass{};
+    uint64_t PassVersion = 0;           // 视图投影/光照变化时递增
+    bool OcclusionCulling = true;
+    uint32_t SceneObjectCount = 0;      // 视锥剔除前的对象数
+    std::vector<RenderItem> Items;      // 已做过视锥剔除
 };
 
 class PrimitiveShape;
 
-class D3DManager
+// 线程划分：场景对象、选择、相机、空间网格等编辑状态只由 UI 线程访问；
+// D3D 对象、纹理表和绘制相关状态只由渲染线程访问（StartRenderThread 之前由初始化线程访问）。
+// 两边只通过 m_renderCommands（编辑 -> GPU 资源的命令）和 m_snapshots（相机与场景快照）交流。
+class D3DManager : private IDrawRecorder
 {
 public:
     D3DManager();
     ~D3DManager();
 
     bool InitD3D(HWND hWnd, int width, int height);
+    // 不创建设备与窗口，帧路径的命令只录进 NullGraphicsBackend：用于单独测量 CPU 端帧开销、
+    // 在没有 GPU 的机器上跑帧循环。此模式下没有纹理上传，纹理请求被忽略（对象用默认纹理）
+    bool InitHeadless(int width, int height);
+    // 录制后端下建一个 objectCount 个对象的场景，渲染 frameCount 帧，把每帧 CPU 耗时与命令计数写到标准输出
+    static bool RunHeadlessBenchmark(int objectCount, int frameCount);
+    // 对 size x size 的合成图生成完整 mip 链 iterations 次，把各滤波器的吞吐（MP/s）写到标准输出
+    static bool RunMipBenchmark(int size, int iterations);
+    // 对同一张图的 mip 链按各格式与质量档位压缩，把编码吞吐、PSNR、体积与读缓存耗时写到标准输出
+    static bool RunCompressionBenchmark(int size, int iterations);
+    // 录制后端下建一个 objectCount 个对象的场景，用软件光栅化按 width x height 渲染若干帧，
+    // 把每帧耗时（帧率）与各阶段统计写到标准输出，最后一帧存成 BMP
+    static bool RunSoftwareRender(const std::wstring& path, int width, int height, int objectCount);
+    // 录制后端（InitHeadless 之后有效，否则为空）
+    const NullGraphicsBackend* GetNullBackend() const { return m_nullBackend; }
+    // 不创建设备，只把着色器编译进磁盘缓存（安装/构建后运行一次，首次启动即命中）；
+    // 另在临时目录里各跑一遍冷缓存（全部编译）与热缓存（全部命中），把耗时对比写到标准输出
+    static bool PrecompileShaders();
     void Cleanup();
     void Render();
     void OnResize(int width, int height);
 
-    // 
+    // 独立渲染线程：按需渲染，只有发布了新快照或投递了资源命令才画一帧，其余时间阻塞
+    void StartRenderThread();
+    void StopRenderThread();
+    // UI 线程：本次消息若改动了相机或场景，发布一份新快照并唤醒渲染线程（未改动时直接返回）
+    void PublishSnapshot();
+    // 内容没变但窗口需要重画时（WM_PAINT）请求一帧
+    void RequestRedraw() { m_frameInvalidator.Invalidate(InvalidateReason::Expose); }
+    // 按需渲染的帧率上限，0 表示不限
+    void SetMaxFrameRate(uint32_t fps) { m_frameInvalidator.SetMaxFrameRate(fps); }
+    // 流式纹理的驻留预算（字节），超出时从最久未用的纹理开始淘汰高 mip
+    void SetTextureStreamingBudget(uint64_t bytes);
+
+    // UI 线程：用软件光栅化按当前相机把视锥内的场景画成与窗口同尺寸的 BMP（不需要 GPU）
+    bool SaveSoftwareRender(const std::wstring& path);
+    const SoftwareRasterStats& GetSoftwareRenderStats() const { return m_softwareRasterizer.GetStats(); }
+
+    // 场景对象管理
     void AddObject(ShapeType type, const DirectX::XMFLOAT3& position);
     void ClearScene();
 
-    // 꽻
+    // 鼠标交互
     void OnMouseDown(int x, int y);
     void OnMouseMove(int x, int y);
     void OnMouseUp();
     void OnMouseWheel(int delta);
 
-    // ȡ
+    // 获取对象数量
     int GetObjectCount() const { return (int)m_sceneObjects.size(); }
 private:
-    // D3D12 Ķ
+    // D3D12 核心对象
     ComPtr<IDXGIFactory4> m_dxgiFactory;
     ComPtr<ID3D12Device> m_d3dDevice;
     ComPtr<IDXGISwapChain3> m_swapChain;
     ComPtr<ID3D12CommandQueue> m_commandQueue;
-    ComPtr<ID3D12CommandAllocator> m_commandAllocator;
-    ComPtr<ID3D12GraphicsCommandList> m_commandList;
 
-    // ͬ
-    ComPtr<ID3D12Fence> m_fence;
-    UINT64 m_currentFence = 0;
-    HANDLE m_fenceEvent;
+    // 图形后端：帧路径的命令录制、缓冲创建、提交与栅栏都经过它。
+    // 必须在下面所有引用其资源的成员之前声明（最后析构）
+    std::unique_ptr<IGraphicsBackend> m_backend;
+    D3D12GraphicsBackend* m_d3d12Backend = nullptr;   // 指向 m_backend，录制后端下为空
+    NullGraphicsBackend* m_nullBackend = nullptr;
+
+    // 同步对象：帧上下文环（CPU 最多领先 GPU FrameCount 帧）+ 延迟释放
+    static const UINT FrameCount = 3;
+    std::unique_ptr<FrameRing> m_frameRing;
+    UINT m_frameIndex = 0;
 
-    // 
+    // 主命令列表：第 f 个分配器给帧上下文 f，最后一个给初始化/纹理上传这类立即等待完成的一次性录制
+    static const UINT ImmediateAllocator = FrameCount;
+    IGraphicsCommandList* m_commandList = nullptr;
+
+    // 描述符堆
     ComPtr<ID3D12DescriptorHeap> m_rtvHeap;
     ComPtr<ID3D12DescriptorHeap> m_dsvHeap;
     ComPtr<ID3D12DescriptorHeap> m_cbvHeap;
-    ComPtr<ID3D12DescriptorHeap> m_srvHeap;
 
     UINT m_rtvDescriptorSize = 0;
     UINT m_dsvDescriptorSize = 0;
     UINT m_cbvSrvUavDescriptorSize = 0;
 
-    // ȾĿȻ
+    // 渲染目标和深度缓冲
     static const int SwapChainBufferCount = 2;
     ComPtr<ID3D12Resource> m_swapChainBuffer[SwapChainBufferCount];
     ComPtr<ID3D12Resource> m_depthStencilBuffer;
     int m_currBackBuffer = 0;
 
-    // ӿںͲü
-    D3D12_VIEWPORT m_screenViewport;
-    D3D12_RECT m_scissorRect;
+    // 视口和裁剪矩形
+    GpuViewport m_screenViewport;
+    GpuRect m_scissorRect;
 
-    // ״̬
+    // 管线状态
     ComPtr<ID3D12RootSignature> m_rootSignature;
-    ComPtr<ID3D12PipelineState> m_pipelineState;
+    // 每个像素着色器变体一个 PSO，编号即排序键中的 pipeline 字段
+    ComPtr<ID3D12PipelineState> m_pipelineStates[ShaderVariant::VariantCount];
+    // 录制命令时使用的后端句柄（录制后端下为编号）
+    GpuHandle m_rootSignatureHandle = NullGpuHandle;
+    GpuHandle m_pipelineHandles[ShaderVariant::VariantCount] = {};
 
-    // ɫ
+    // 着色器（顶点着色器共用，像素着色器按变体）
     ComPtr<ID3DBlob> m_vsByteCode;
-    ComPtr<ID3DBlob> m_psByteCode;
-
-    // 
-    ComPtr<ID3D12Resource> m_objectCB;
-    BYTE* m_cbMappedData = nullptr;
+    ComPtr<ID3DBlob> m_psByteCodes[ShaderVariant::VariantCount];
+
+    // 磁盘缓存：着色器字节码按源文件哈希/入口/profile/宏/编译选项为键，
+    // PSO 缓存块按着色器键/根签名/管线描述版本/适配器与驱动为键。格式变化时递增版本号
+    static const uint32_t ShaderCacheFormatVersion = 1;
+    static const uint32_t PipelineCacheFormatVersion = 1;
+    static const uint32_t PipelineDescVersion = 1;   // BuildPSO 中的固定状态改动时递增
+    // 超过这么多天没有任何构建/实例读写的条目在启动时删除
+    static const int CacheEntryMaxAgeDays = 30;
+    std::unique_ptr<BlobCache> m_shaderCache;
+    std::unique_ptr<BlobCache> m_pipelineCache;
+    uint64_t m_vsKey = 0;
+    uint64_t m_psKeys[ShaderVariant::VariantCount] = {};
+    uint64_t m_rootSignatureHash = 0;
+
+    // 每帧上传分配器：实例数据（根 SRV）和 pass 常量（根 CBV）每帧从大页上线性分配，
+    // 页在该帧栅栏完成后回收复用
+    static const UINT64 UploadPageSize = 4 * 1024 * 1024;
+    std::unique_ptr<LinearUploadAllocator> m_uploadAllocator;
+    UploadAllocation m_frameInstanceSlots;   // 本帧按绘制顺序排列的实例槽位下标（根 SRV t2）
     UINT m_objCBByteSize = 0;
     static const UINT MaxObjects = 256;
-    static const UINT MaxTextureCount = MaxObjects + 1;
+
+    // 着色器可见 SRV 堆：持久区间放纹理，按需迁移到更大的堆；尾部是每帧临时描述符环。
+    // 排序键里的 SRV 字段存堆内偏移，上限不能超过该字段的位宽
+    static const UINT InitialSrvCapacity = MaxObjects + 1;
+    static const UINT TransientSrvCapacity = 256;
+    static const UINT MaxSrvCapacity = 1000000;
+    std::unique_ptr<DescriptorAllocator> m_srvAllocator;
+    DescriptorRangeId m_defaultSrv = InvalidDescriptorRange;
 
     ComPtr<ID3D12Resource> m_defaultTexture;
-    std::unordered_map<SceneObject*, Microsoft::WRL::ComPtr<ID3D12Resource>> m_objectTextures;
-    std::unordered_map<SceneObject*, int> m_objectSrvIndex;
-    std::vector<int> m_freeSrvIndices;
-    int m_nextSrvIndex = 1;
 
-    // ģ壨
+    // 纹理按文件共享：每个对象对当前使用的缓存条目（以及正在加载的条目）各持有一份引用，
+    // m_objectSrvRanges 是当前条目的 SRV 区间（同一图片的对象相同），录制时按对象查询
+    TextureCache m_textureCache{ [this](uint64_t texture, uint32_t view) { ReleaseCachedTexture(texture, view); } };
+    std::unordered_map<const SceneObject*, TextureCacheId> m_objectTextures;
+    std::unordered_map<const SceneObject*, TextureCacheId> m_objectPendingTextures;
+    std::unordered_map<const SceneObject*, DescriptorRangeId> m_objectSrvRanges;
+
+    // 异步纹理加载（以缓存条目为键）：解码在 m_threadPool 上，上传走独立的拷贝队列，
+    // 拷贝完成前对象继续用原来的纹理（没有时用默认纹理）。解码器与压缩结果的磁盘缓存必须比加载器和线程池都晚析构
+    static const uint32_t TextureCacheFormatVersion = 1;   // 编码器输出或缓存条目格式变化时递增
+    std::unique_ptr<BlobCache> m_encodedTextureCache;
+    WicTextureDecoder m_textureDecoder;
+    std::unique_ptr<D3D12TextureUploader> m_textureUploader;   // 录制后端下为空
+    std::unique_ptr<TextureLoader> m_textureLoader;
+    std::vector<TextureLoadResult> m_loadedTextures;
+
+    // 纹理流式驻留：先加载长边不超过 MinResidentSize 的级，之后按可见对象的投影尺寸换级（重新加载，
+    // 压缩后的完整 mip 链在磁盘缓存里，换级只需读缓存）。条目被缓存删除时随之注销
+    TextureStreamer m_textureStreamer;
+    std::unordered_map<TextureCacheId, std::wstring> m_texturePaths;   // 换级时重新加载的文件
+    std::vector<TextureStreamRequest> m_streamRequests;
+    uint64_t m_streamFrame = 0;
+
+    // 几何体模板（共享）
     std::shared_ptr<PrimitiveShape> m_sphereTemplate;
     std::shared_ptr<PrimitiveShape> m_cylinderTemplate;
     std::shared_ptr<PrimitiveShape> m_planeTemplate;
     std::shared_ptr<PrimitiveShape> m_cubeTemplate;
     std::shared_ptr<PrimitiveShape> m_tetrahedronTemplate;
 
-    // б
+    // 场景对象列表
     std::vector<std::unique_ptr<SceneObject>> m_sceneObjects;
     SceneObject* m_selectedObject = nullptr;
 
-    // Ϣ
+    // 空间网格（剔除、拾取、邻域查询共用）
+    SpatialGrid m_spatialGrid;
+    std::unordered_map<SceneObject*, uint32_t> m_spatialHandles;
+    std::vector<SceneObject*> m_frustumObjects;    // 发布快照时的视锥查询结果（UI 线程）
+    std::vector<const RenderItem*> m_visibleItems; // 本帧可见对象，指向当前快照（渲染线程）
+
+    // 宽相位（世界 AABB 的增量扫掠裁剪），用于拖动时的接触检测
+    SweepAndPrune m_broadphase;
+    std::unordered_map<SceneObject*, uint32_t> m_broadphaseHandles;
+    bool m_dragCollision = true;
+
+    // 软件遮挡剔除（在视锥剔除之后执行）
+    ThreadPool m_threadPool;
+    OcclusionCuller m_occlusionCuller;
+    bool m_occlusionCulling = true;
+
+    // 软件渲染导出（UI 线程）；网格按形状类型首次使用时生成
+    SoftwareRasterizer m_softwareRasterizer;
+    SoftwareMesh m_softwareMeshes[(int)ShapeType::Tetrahedron + 1];
+
+    // 排序后的绘制队列与冗余状态剔除
+    RenderQueue m_renderQueue;
+    std::vector<DrawBatch> m_drawBatches;
+    DrawStateStats m_drawStats;
+
+    // 多线程命令录制：批次切块后每块录制到独立的分配器/命令列表
+    static const UINT MaxRecordChunks = 8;
+    static const uint64_t MinRecordChunkCost = 256; // 每块至少的命令数，太少时不值得切分
+    IGraphicsCommandList* m_chunkLists[MaxRecordChunks] = {};
+    DrawStateCache m_chunkStateCaches[MaxRecordChunks];
+    IGraphicsCommandList* m_epilogueList = nullptr;
+
+    // 每帧重建的帧图（屏障直接提交到命令列表）
+    RenderGraph m_frameGraph;
+
+    // GPU 各 pass 的时间戳计时，结果进 FrameProfiler 的 "GPU" 轨道
+    GpuProfiler m_gpuProfiler;
+
+    // 每帧渲染统计：渲染线程在 Render 末尾写入，读取方加锁拷贝
+    static const uint32_t RenderStatsWindow = 120;
+    RenderStatsHistory m_renderStats{ RenderStatsWindow };
+    mutable std::mutex m_renderStatsMutex;
+    uint32_t m_frameTextureUploads = 0;     // 本帧（含帧开头执行的资源命令）的纹理上传
+    uint64_t m_frameTextureUploadBytes = 0;
+    uint32_t m_frameStreamRequests = 0;
+
+    void RecordFrameStats(const RenderSnapshot& snapshot, uint64_t frameStart);
+
+    // 每个帧上下文的对象常量/pass 常量副本（命令分配器由各命令列表按帧下标持有）
+    struct FrameContext
+    {
+        UploadPage InstancePage;        // 按持久槽位存放 ObjectConstants（根 SRV t1）
+        uint32_t InstanceCapacity = 0;
+        UploadPage PassPage;            // PassConstants（根 CBV b1）
+        uint64_t PassStamp = 0;         // 副本中 pass 常量对应的 PassVersion
+    };
+    FrameContext m_frames[FrameCount];
+
+    // 对象常量脏标记：只有打包结果变化的对象才写入当前帧的副本
+    static const uint32_t ConstantSlotEvictFrames = 120;
+    ConstantUploadTracker m_constantTracker{ FrameCount, ConstantSlotEvictFrames };
+    std::vector<uint32_t> m_itemSlots;
+    ParallelRecorder m_parallelRecorder;
+    std::vector<uint64_t> m_batchCosts;
+    uint64_t m_frameRtv = 0;
+    uint64_t m_frameDsv = 0;
+
+    // 多选：按 m_sceneObjects 下标的位集，m_selectedObject 为其中的主对象
+    SelectionSet m_selection;
+    bool m_boxSelectMode = false;
+    bool m_isBoxSelecting = false;
+    int m_boxStartX = 0;
+    int m_boxStartY = 0;
+
+    // 窗口信息（客户区尺寸由 UI 线程维护，后台缓冲尺寸由渲染线程维护）
     HWND m_hWnd;
     int m_clientWidth;
     int m_clientHeight;
-
-    // 
+    int m_backBufferWidth = 0;
+    int m_backBufferHeight = 0;
+
+    // UI 线程 -> 渲染线程
+    RenderCommandQueue m_renderCommands;
+    SnapshotBuffer<RenderSnapshot> m_snapshots;
+    bool m_sceneDirty = true;
+    PassConstants m_publishedPass{};
+    uint64_t m_passVersion = 0;
+    FrameInvalidator m_frameInvalidator;
+    std::thread m_renderThread;
+
+    // 摄像机
     DirectX::XMFLOAT3 m_eyePos;
     DirectX::XMFLOAT3 m_lookAt;
     DirectX::XMFLOAT4X4 m_view;
     DirectX::XMFLOAT4X4 m_proj;
 
-    // 꽻״̬
+    // 鼠标交互状态
     bool m_isDragging = false;
     int m_lastMouseX = 0;
     int m_lastMouseY = 0;
 public:
-    // ƶ
+    // 相机移动
     void MoveCamera(float dx, float dy, float dz);
-    // ɾǰѡж
+    // 删除当前选中对象
     void DeleteSelectedObject();
 private:
-    // ʼ
+    // 初始化辅助函数
     bool CreateDevice();
     bool CreateCommandObjects();
+    // 两种初始化共用：帧环、上传/SRV 分配器、命令列表与录制分块参数
+    bool CreateFrameResources();
+    void SetViewport(int width, int height);
     bool CreateSwapChain();
     bool CreateDescriptorHeaps();
     bool CreateRenderTargets();
@@ -181,30 +372,96 @@ private:
     bool CompileShaders();
     bool BuildRootSignature();
     bool BuildPSO();
+    uint64_t GetAdapterHash() const;
+    static std::filesystem::path GetExecutableDirectory();
+    static std::filesystem::path GetShaderCacheDirectory();
+    // 基准测试用的合成图：棋盘格叠加渐变与平滑的 alpha
+    static void MakeBenchmarkImage(uint32_t width, uint32_t height, std::vector<uint8_t>& out);
+    static bool LoadShaderSource(std::vector<uint8_t>& source, std::filesystem::path& path);
+    // 先查缓存，未命中时从源码编译并写回缓存
+    static bool CompileShaderCached(BlobCache& cache, const std::vector<uint8_t>& source,
+        const std::filesystem::path& sourcePath, const char* entry, const char* profile,
+        const std::vector<ShaderDefine>& defines, ComPtr<ID3DBlob>& out, uint64_t& outKey);
     bool BuildShapeGeometry();
     bool BuildConstantBuffers();
     bool CreateDefaultTexture();
-    bool LoadTextureForObject(SceneObject* obj);
-    bool CreateTextureFromFile(const std::wstring& path,
-        Microsoft::WRL::ComPtr<ID3D12Resource>& texture,
-        D3D12_CPU_DESCRIPTOR_HANDLE srvHandle);
-    D3D12_CPU_DESCRIPTOR_HANDLE GetSrvCpuHandle(int index) const;
-    D3D12_GPU_DESCRIPTOR_HANDLE GetSrvGpuHandle(int index) const;
-    bool HasTexture(SceneObject* obj) const;
+    // UI 线程：把纹理加载/释放投递给渲染线程
+    void LoadTextureForObject(SceneObject* obj);
     void ReleaseTexture(SceneObject* obj);
-
-    // Ⱦ
+    // 渲染线程：发起异步加载 / 释放纹理与 SRV 槽
+    bool LoadTexture(const SceneObject* key, const std::wstring& path);
+    void DestroyTexture(const SceneObject* key);
+    void DestroyAllTextures();
+    // 渲染线程每帧开头：推进异步加载，把拷贝完成的纹理换上
+    void UpdateTextureLoads();
+    // 为加载完成的条目创建 SRV 并登记为驻留，返回最终持有引用的条目（失败为 InvalidTextureCacheId）
+    TextureCacheId InstallTexture(TextureCacheId id, const TextureLoadResult& result);
+    // 已驻留条目换级完成：换上新纹理与 SRV，使用它的对象改用新描述符
+    void InstallStreamedTexture(TextureCacheId id, const TextureLoadResult& result);
+    // 取出加载结果的纹理并创建 SRV
+    bool CreateTextureView(const TextureLoadResult& result, ComPtr<ID3D12Resource>& texture, DescriptorRangeId& range);
+    // 按本帧可见对象的投影尺寸报告纹理使用，发出换级请求
+    void UpdateTextureStreaming(const RenderSnapshot& snapshot);
+    // 对象改用条目 id（接管一份引用）
+    void SetObjectTexture(const SceneObject* key, TextureCacheId id);
+    void ReleasePendingTexture(const SceneObject* key);
+    void ReleaseTextureReference(TextureCacheId id);
+    // TextureCache 的释放回调
+    void ReleaseCachedTexture(uint64_t texture, uint32_t view);
+    // TextureCache 的删除回调
+    void OnTextureErased(TextureCacheId id);
+    D3D12_CPU_DESCRIPTOR_HANDLE GetSrvCpuHandle(uint32_t offset) const;
+    uint64_t GetSrvGpuHandle(uint32_t offset) const;
+    bool HasTexture(const SceneObject* key) const;
+
+    // 对象位置/缩放变化后同步到空间网格与宽相位
+    void UpdateSpatialEntry(SceneObject* obj);
+
+    // 多选辅助
+    // 对象在 m_sceneObjects 中的下标（取自对象上保存的下标，O(1)），不在场景中为 -1
+    int FindObjectIndex(const SceneObject* obj) const;
+    void ClearSelection();
+    void SelectInRect(int x0, int y0, int x1, int y1);
+    void TranslateSelection(DirectX::FXMVECTOR delta);
+    // 选中组沿 delta 移动时首次接触其它对象的时刻（0~1，无接触为 1）
+    float ComputeSelectionContactTime(DirectX::FXMVECTOR delta);
+
+    // 基准场景：以原点为中心的方阵，间距 2，形状轮换
+    void AddBenchmarkGrid(int objectCount);
+
+    // 渲染辅助函数
     void UpdateCamera();
-    void UpdateObjectCB(SceneObject* obj, UINT objectIndex);
+    // 用软件光栅化按当前相机把视锥内的场景画进 m_softwareRasterizer（尺寸同客户区）
+    bool RenderSoftwareFrame();
+    // GPU 与软件渲染共用的常量打包
+    void BuildPassConstants(PassConstants& pass) const;
+    static void FillRenderItem(const SceneObject& obj, RenderItem& item);
+    // ObjectConstants::HasTexture：只有图片样式且纹理已加载时才采样
+    static int SamplesTexture(const RenderItem& item, bool hasTexture);
+    static void UpdateObjectCB(const RenderItem& item, bool hasTexture, uint8_t* dest);
+    bool EnsureInstanceCapacity(FrameContext& frame, uint32_t slotCount);
+    uint64_t CurrentInstanceBufferAddress() const;
+    uint64_t CurrentPassCBAddress() const;
+    void CullOccludedObjects(DirectX::FXMMATRIX viewProj, const DirectX::XMFLOAT3& eyePos);
+    void RecordScenePass(const RenderSnapshot& snapshot, FrameContext& frame);
+    // 渲染线程：按新的客户区尺寸重建交换链缓冲与深度缓冲
+    void ResizeSwapChain(int width, int height);
+    // UI 线程：投递一条渲染线程命令并唤醒渲染线程
+    void PostRenderCommand(std::function<void()> command, uint32_t reason = InvalidateReason::Resources);
+
+    // IDrawRecorder：录制一个块（可能在工作线程上调用）
+    void BeginChunk(uint32_t chunkIndex) override;
+    void RecordBatch(uint32_t chunkIndex, uint32_t batchIndex) override;
+    void EndChunk(uint32_t chunkIndex) override;
     void FlushCommandQueue();
 
-    // ʰȡ
+    // 射线拾取
     SceneObject* PickObject(int mouseX, int mouseY);
     void ScreenToWorldRay(int mouseX, int mouseY,
         DirectX::XMVECTOR& rayOrigin,
         DirectX::XMVECTOR& rayDir);
 
-    // ߺ
+    // 工具函数（录制后端下没有 RTV/DSV 堆，返回按缓冲编号的伪句柄）
     D3D12_CPU_DESCRIPTOR_HANDLE CurrentBackBufferView() const;
     D3D12_CPU_DESCRIPTOR_HANDLE DepthStencilView() const;
     ID3D12Resource* CurrentBackBuffer() const;
@@ -213,13 +470,26 @@ private:
 public:
         void SetEditMode(bool enabled) { m_editMode = enabled; }
         bool IsEditMode() const { return m_editMode; }
+        // 框选模式：拖出矩形选择多个对象
+        void SetBoxSelectMode(bool enabled) { m_boxSelectMode = enabled; }
+        bool IsBoxSelectMode() const { return m_boxSelectMode; }
+        int GetSelectedCount() const { return (int)m_selection.Count(); }
+        // 软件遮挡剔除开关；剔除数、绑定次数、常量上传量等每帧统计只经 GetRenderStats 读取
+        void SetOcclusionCulling(bool enabled) { m_occlusionCulling = enabled; m_sceneDirty = true; }
+        bool IsOcclusionCullingEnabled() const { return m_occlusionCulling; }
+        // 每帧渲染统计：最近一帧 + 最近 RenderStatsWindow 帧的最小/平均/最大值（任意线程可调用）
+        void GetRenderStats(RenderStatsSummary& out) const;
+        void ResetRenderStats();
+        // 拖动碰撞：开启时拖动/滚轮移动在接触处停下
+        void SetDragCollision(bool enabled) { m_dragCollision = enabled; }
+        bool IsDragCollisionEnabled() const { return m_dragCollision; }
+        // 当前所有包围盒重叠的对象对
+        void GetOverlappingPairs(std::vector<std::pair<SceneObject*, SceneObject*>>& out) { m_broadphase.GetOverlappingPairs(out); }
         void OnMouseDoubleClick(int x, int y);
-		// ʾöԻ
+		// 显示光照设置对话框
         void ShowLightSettingsDialog();
 private:
         bool m_editMode = false;
-        ComPtr<ID3D12Resource> m_passCB;
-        BYTE* m_passCbMappedData = nullptr;
         UINT m_passCBByteSize = 0;
         LightSettings m_lightSettings{};
 };
\ No newline at end of file
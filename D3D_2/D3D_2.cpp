@@ -1,9 +1,14 @@
 ﻿#include <windows.h>
 #include "D3DManager.h"
+#include "SelfTest.h"
+#include "StatsOverlay.h"
 #include "resource.h"
 
 // 全局变量
 D3DManager* g_pD3DManager = nullptr;
+HWND g_statsOverlay = nullptr;          // 渲染统计浮窗，关闭时为空
+const UINT_PTR StatsTimerId = 1;
+const UINT StatsRefreshMs = 250;
 
 // 窗口过程函数声明
 LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
@@ -25,10 +30,16 @@ HMENU CreateAppMenu()
     HMENU hSceneMenu = CreatePopupMenu();
     AppendMenu(hSceneMenu, MF_STRING, IDM_LIGHT_SETTINGS, L"光照设置(&L)");
     AppendMenu(hSceneMenu, MF_STRING, IDM_CLEAR_SCENE, L"清空场景(&C)");
+    AppendMenu(hSceneMenu, MF_STRING | MF_CHECKED, IDM_OCCLUSION_CULLING, L"遮挡剔除(&O)");
+    AppendMenu(hSceneMenu, MF_STRING, IDM_SOFTWARE_RENDER, L"软件渲染导出(&R)...");
+    AppendMenu(hSceneMenu, MF_STRING, IDM_EXPORT_TRACE, L"导出性能跟踪(&P)...");
+    AppendMenu(hSceneMenu, MF_STRING, IDM_RENDER_STATS, L"渲染统计(&T)");
 
 
     HMENU hPicMenu = CreatePopupMenu();
     AppendMenu(hPicMenu, MF_STRING, IDM_EDIT_TRANSFORM, L"编辑图形参数(&E)");
+    AppendMenu(hPicMenu, MF_STRING, IDM_BOX_SELECT, L"框选模式(&B)");
+    AppendMenu(hPicMenu, MF_STRING | MF_CHECKED, IDM_DRAG_COLLISION, L"拖动碰撞停止(&C)");
 
     AppendMenu(hMenu, MF_POPUP, (UINT_PTR)hAddMenu, L"添加形状(&A)");
     AppendMenu(hMenu, MF_POPUP, (UINT_PTR)hSceneMenu, L"场景(&S)");
@@ -36,10 +47,179 @@ HMENU CreateAppMenu()
     return hMenu;
 }
 
+// 只输出报告后退出的命令行模式
+static const char* const ConsoleOptions[] = {
+    "/precompile-shaders", "/self-test", "/headless-benchmark", "/mip-benchmark", "/compression-benchmark",
+    "/spatial-benchmark", "/sap-benchmark", "/upload-benchmark",
+    "/descriptor-benchmark", "/occlusion-benchmark", "/software-render" };
+
+// 程序是 Windows 子系统，从控制台启动时没有标准输出：附加到父进程的控制台并重新打开 stdout/stderr。
+// 输出已重定向到文件或管道时保持不变
+static void AttachParentConsole()
+{
+    HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+    if (output != nullptr && output != INVALID_HANDLE_VALUE && GetFileType(output) != FILE_TYPE_UNKNOWN)
+    {
+        return;
+    }
+    if (AttachConsole(ATTACH_PARENT_PROCESS))
+    {
+        FILE* stream = nullptr;
+        freopen_s(&stream, "CONOUT$", "w", stdout);
+        freopen_s(&stream, "CONOUT$", "w", stderr);
+    }
+}
+
 // WinMain 入口函数
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
     LPSTR lpCmdLine, int nCmdShow)
 {
+    if (lpCmdLine)
+    {
+        for (const char* option : ConsoleOptions)
+        {
+            if (strstr(lpCmdLine, option))
+            {
+                AttachParentConsole();
+                break;
+            }
+        }
+    }
+
+    // 只编译着色器到磁盘缓存后退出（构建后/安装时预热缓存）
+    if (lpCmdLine && strstr(lpCmdLine, "/precompile-shaders"))
+    {
+        return D3DManager::PrecompileShaders() ? 0 : 1;
+    }
+
+    // 各组件的确定性自检，任一失败返回非零：/self-test [名字过滤]
+    if (lpCmdLine)
+    {
+        const char* option = strstr(lpCmdLine, "/self-test");
+        if (option)
+        {
+            char filter[64] = {};
+            sscanf_s(option + strlen("/self-test"), "%63s", filter, (unsigned)_countof(filter));
+            return RunSelfTests(filter) ? 0 : 1;
+        }
+    }
+
+    // 录制后端下跑固定场景，输出 CPU 帧耗时与命令计数后退出：/headless-benchmark [对象数] [帧数]
+    if (lpCmdLine)
+    {
+        const char* option = strstr(lpCmdLine, "/headless-benchmark");
+        if (option)
+        {
+            int objects = 10000, frames = 300;
+            sscanf_s(option + strlen("/headless-benchmark"), "%d %d", &objects, &frames);
+            return D3DManager::RunHeadlessBenchmark(objects, frames) ? 0 : 1;
+        }
+
+        // 不需要 GPU 的软件渲染导出，输出帧率：/software-render <输出.bmp> [宽 高] [对象数]
+        option = strstr(lpCmdLine, "/software-render");
+        if (option)
+        {
+            const char* cursor = option + strlen("/software-render");
+            while (*cursor == ' ' || *cursor == '\t')
+            {
+                ++cursor;
+            }
+            // 路径可以带引号（含空格时）
+            std::string path;
+            if (*cursor == '"')
+            {
+                const char* end = strchr(++cursor, '"');
+                path.assign(cursor, end ? end : cursor + strlen(cursor));
+                cursor = end ? end + 1 : cursor + strlen(cursor);
+            }
+            else
+            {
+                const char* end = cursor;
+                while (*end && *end != ' ' && *end != '\t')
+                {
+                    ++end;
+                }
+                path.assign(cursor, end);
+                cursor = end;
+            }
+            if (path.empty())
+            {
+                printf("Usage: /software-render <out.bmp> [width height] [objects]\n");
+                return 1;
+            }
+
+            int width = 1920, height = 1080, objects = 10000;
+            sscanf_s(cursor, "%d %d %d", &width, &height, &objects);
+            int length = MultiByteToWideChar(CP_ACP, 0, path.c_str(), (int)path.size(), nullptr, 0);
+            std::wstring widePath(length, L'\0');
+            MultiByteToWideChar(CP_ACP, 0, path.c_str(), (int)path.size(), &widePath[0], length);
+            return D3DManager::RunSoftwareRender(widePath, width, height, objects) ? 0 : 1;
+        }
+
+        // 只测 CPU 端 mip 链生成：/mip-benchmark [边长] [次数]
+        option = strstr(lpCmdLine, "/mip-benchmark");
+        if (option)
+        {
+            int size = 2048, iterations = 10;
+            sscanf_s(option + strlen("/mip-benchmark"), "%d %d", &size, &iterations);
+            return D3DManager::RunMipBenchmark(size, iterations) ? 0 : 1;
+        }
+
+        // 只测 CPU 端块压缩：/compression-benchmark [边长] [次数]
+        option = strstr(lpCmdLine, "/compression-benchmark");
+        if (option)
+        {
+            int size = 2048, iterations = 3;
+            sscanf_s(option + strlen("/compression-benchmark"), "%d %d", &size, &iterations);
+            return D3DManager::RunCompressionBenchmark(size, iterations) ? 0 : 1;
+        }
+
+        // 空间网格：每帧 10% 对象移动后查询，/spatial-benchmark [对象数] [帧数]
+        option = strstr(lpCmdLine, "/spatial-benchmark");
+        if (option)
+        {
+            int objects = 100000, frames = 100;
+            sscanf_s(option + strlen("/spatial-benchmark"), "%d %d", &objects, &frames);
+            return RunSpatialGridBenchmark(objects, frames) ? 0 : 1;
+        }
+
+        // 扫掠裁剪：每帧 1% 对象小幅移动，输出每帧端点交换次数，/sap-benchmark [对象数] [帧数]
+        option = strstr(lpCmdLine, "/sap-benchmark");
+        if (option)
+        {
+            int objects = 100000, frames = 100;
+            sscanf_s(option + strlen("/sap-benchmark"), "%d %d", &objects, &frames);
+            return RunSweepAndPruneBenchmark(objects, frames) ? 0 : 1;
+        }
+
+        // 线性上传分配器：模拟栅栏落后两帧，/upload-benchmark [每帧分配数] [帧数]
+        option = strstr(lpCmdLine, "/upload-benchmark");
+        if (option)
+        {
+            int allocations = 10000, frames = 1000;
+            sscanf_s(option + strlen("/upload-benchmark"), "%d %d", &allocations, &frames);
+            return RunUploadAllocatorBenchmark(allocations, frames) ? 0 : 1;
+        }
+
+        // 描述符分配器：持久区间分配/释放与临时环，/descriptor-benchmark [操作数]
+        option = strstr(lpCmdLine, "/descriptor-benchmark");
+        if (option)
+        {
+            int operations = 1000000;
+            sscanf_s(option + strlen("/descriptor-benchmark"), "%d", &operations);
+            return RunDescriptorAllocatorBenchmark(operations) ? 0 : 1;
+        }
+
+        // 遮挡剔除：一排立方体墙，输出被剔除比例与光栅化/测试耗时，/occlusion-benchmark [对象数] [帧数]
+        option = strstr(lpCmdLine, "/occlusion-benchmark");
+        if (option)
+        {
+            int objects = 10000, frames = 200;
+            sscanf_s(option + strlen("/occlusion-benchmark"), "%d %d", &objects, &frames);
+            return RunOcclusionBenchmark(objects, frames) ? 0 : 1;
+        }
+    }
+
     // 注册窗口类
     WNDCLASSEX wcex = {};
     wcex.cbSize = sizeof(WNDCLASSEX);
@@ -79,6 +259,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
     }
 
     // 初始化 D3D
+    FrameProfiler::Instance().SetThreadName("UI");
     g_pD3DManager = new D3DManager();
     if (!g_pD3DManager->InitD3D(hWnd, screenWidth, screenHeight))
     {
@@ -89,6 +270,26 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
         return 0;
     }
 
+    // 运行参数
+    if (lpCmdLine)
+    {
+        // 流式纹理的驻留预算：/texture-budget [MB]
+        const char* option = strstr(lpCmdLine, "/texture-budget");
+        int megabytes = 0;
+        if (option && sscanf_s(option + strlen("/texture-budget"), "%d", &megabytes) == 1 && megabytes > 0)
+        {
+            g_pD3DManager->SetTextureStreamingBudget((uint64_t)megabytes * 1024 * 1024);
+        }
+
+        // 按需渲染的帧率上限：/max-fps N（默认不限）
+        option = strstr(lpCmdLine, "/max-fps");
+        int fps = 0;
+        if (option && sscanf_s(option + strlen("/max-fps"), "%d", &fps) == 1 && fps > 0)
+        {
+            g_pD3DManager->SetMaxFrameRate((uint32_t)fps);
+        }
+    }
+
     // 添加一些初始对象到场景
     g_pD3DManager->AddObject(ShapeType::Cube, DirectX::XMFLOAT3(-3.0f, 0.0f, 0.0f));
     g_pD3DManager->AddObject(ShapeType::Sphere, DirectX::XMFLOAT3(0.0f, 0.0f, 2.0f));
@@ -97,23 +298,15 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance,
     ShowWindow(hWnd, nCmdShow);
     UpdateWindow(hWnd);
 
+    // 渲染在独立线程上进行，模态对话框和窗口拖动/缩放不再阻塞画面
+    g_pD3DManager->StartRenderThread();
+
     // 消息循环
     MSG msg = {};
-    while (msg.message != WM_QUIT)
+    while (GetMessage(&msg, nullptr, 0, 0))
     {
-        if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
-        {
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
-        }
-        else
-        {
-            // 渲染场景
-            if (g_pD3DManager)
-            {
-                g_pD3DManager->Render();
-            }
-        }
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
     }
 
     // 清理
@@ -175,9 +368,101 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             CheckMenuItem(GetMenu(hWnd), IDM_EDIT_TRANSFORM, MF_BYCOMMAND | (enabled ? MF_CHECKED : MF_UNCHECKED));
             break;
         }
+        case IDM_BOX_SELECT: {
+            bool enabled = !g_pD3DManager->IsBoxSelectMode();
+            g_pD3DManager->SetBoxSelectMode(enabled);
+            CheckMenuItem(GetMenu(hWnd), IDM_BOX_SELECT, MF_BYCOMMAND | (enabled ? MF_CHECKED : MF_UNCHECKED));
+            break;
+        }
+        case IDM_DRAG_COLLISION: {
+            bool enabled = !g_pD3DManager->IsDragCollisionEnabled();
+            g_pD3DManager->SetDragCollision(enabled);
+            CheckMenuItem(GetMenu(hWnd), IDM_DRAG_COLLISION, MF_BYCOMMAND | (enabled ? MF_CHECKED : MF_UNCHECKED));
+            break;
+        }
+        case IDM_OCCLUSION_CULLING: {
+            bool enabled = !g_pD3DManager->IsOcclusionCullingEnabled();
+            g_pD3DManager->SetOcclusionCulling(enabled);
+            CheckMenuItem(GetMenu(hWnd), IDM_OCCLUSION_CULLING, MF_BYCOMMAND | (enabled ? MF_CHECKED : MF_UNCHECKED));
+            break;
+        }
         case IDM_LIGHT_SETTINGS:
             g_pD3DManager->ShowLightSettingsDialog();
             break;
+        case IDM_SOFTWARE_RENDER: {
+            wchar_t fileBuf[MAX_PATH] = L"render.bmp";
+            OPENFILENAMEW ofn{};
+            ofn.lStructSize = sizeof(ofn);
+            ofn.hwndOwner = hWnd;
+            ofn.lpstrFile = fileBuf;
+            ofn.nMaxFile = (DWORD)_countof(fileBuf);
+            ofn.lpstrFilter = L"位图 (*.bmp)\0*.bmp\0";
+            ofn.lpstrDefExt = L"bmp";
+            ofn.nFilterIndex = 1;
+            ofn.Flags = OFN_PATHMUSTEXIST | OFN_OVERWRITEPROMPT | OFN_NOCHANGEDIR;
+            if (!GetSaveFileNameW(&ofn))
+            {
+                break;
+            }
+
+            if (g_pD3DManager->SaveSoftwareRender(fileBuf))
+            {
+                const SoftwareRasterStats& stats = g_pD3DManager->GetSoftwareRenderStats();
+                wchar_t text[256];
+                swprintf_s(text, L"已保存。\n绘制 %u，三角形 %u，着色像素 %llu\n耗时 %.1f ms（几何 %.1f，光栅化 %.1f）",
+                    stats.Draws, stats.Triangles, (unsigned long long)stats.ShadedPixels,
+                    stats.TotalMs, stats.GeometryMs, stats.RasterMs);
+                MessageBoxW(hWnd, text, L"软件渲染导出", MB_OK | MB_ICONINFORMATION);
+            }
+            else
+            {
+                MessageBoxW(hWnd, L"软件渲染导出失败。", L"软件渲染导出", MB_OK | MB_ICONERROR);
+            }
+            break;
+        }
+        case IDM_RENDER_STATS: {
+            // 浮窗按定时器刷新；渲染按需进行，画面不变时统计也停在最后一帧
+            if (g_statsOverlay)
+            {
+                KillTimer(hWnd, StatsTimerId);
+                DestroyWindow(g_statsOverlay);
+                g_statsOverlay = nullptr;
+            }
+            else
+            {
+                g_statsOverlay = CreateStatsOverlay(hWnd);
+                if (g_statsOverlay)
+                {
+                    SetTimer(hWnd, StatsTimerId, StatsRefreshMs, nullptr);
+                    PostMessage(hWnd, WM_TIMER, StatsTimerId, 0);
+                }
+            }
+            CheckMenuItem(GetMenu(hWnd), IDM_RENDER_STATS, MF_BYCOMMAND | (g_statsOverlay ? MF_CHECKED : MF_UNCHECKED));
+            break;
+        }
+        case IDM_EXPORT_TRACE: {
+            // 各线程与 GPU 轨道最近的计时，chrome://tracing 或 ui.perfetto.dev 打开
+            wchar_t fileBuf[MAX_PATH] = L"trace.json";
+            OPENFILENAMEW ofn{};
+            ofn.lStructSize = sizeof(ofn);
+            ofn.hwndOwner = hWnd;
+            ofn.lpstrFile = fileBuf;
+            ofn.nMaxFile = (DWORD)_countof(fileBuf);
+            ofn.lpstrFilter = L"Chrome 跟踪 (*.json)\0*.json\0";
+            ofn.lpstrDefExt = L"json";
+            ofn.nFilterIndex = 1;
+            ofn.Flags = OFN_PATHMUSTEXIST | OFN_OVERWRITEPROMPT | OFN_NOCHANGEDIR;
+            if (!GetSaveFileNameW(&ofn))
+            {
+                break;
+            }
+
+            if (!FrameProfiler::Instance().ExportChromeTrace(fileBuf))
+            {
+                MessageBoxW(hWnd, L"性能跟踪导出失败。", L"导出性能跟踪", MB_OK | MB_ICONERROR);
+            }
+            break;
+        }
         default:
             return DefWindowProc(hWnd, message, wParam, lParam);
         }
@@ -283,10 +568,49 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         {
             g_pD3DManager->OnResize(width, height);
         }
+        if (g_statsOverlay)
+        {
+            PositionStatsOverlay(g_statsOverlay, hWnd);
+        }
         break;
     }
 
+    case WM_MOVE:
+        if (g_statsOverlay)
+        {
+            PositionStatsOverlay(g_statsOverlay, hWnd);
+        }
+        break;
+
+    case WM_TIMER:
+        if (wParam == StatsTimerId && g_statsOverlay && g_pD3DManager)
+        {
+            RenderStatsSummary summary;
+            g_pD3DManager->GetRenderStats(summary);
+            std::string text;
+            FormatRenderStats(summary, text);
+            SetStatsOverlayText(g_statsOverlay, text);
+        }
+        break;
+
+    case WM_PAINT:
+        // 画面由渲染线程 Present，这里只确认重画区域并请求一帧
+        ValidateRect(hWnd, nullptr);
+        if (g_pD3DManager)
+        {
+            g_pD3DManager->RequestRedraw();
+        }
+        break;
+
     case WM_DESTROY:
+        // 窗口销毁前停下渲染线程，避免继续向已销毁的窗口 Present
+        if (g_pD3DManager)
+        {
+            g_pD3DManager->StopRenderThread();
+        }
+        // 浮窗属于本窗口，会随之销毁
+        KillTimer(hWnd, StatsTimerId);
+        g_statsOverlay = nullptr;
         PostQuitMessage(0);
         break;
 
@@ -294,5 +618,11 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         return DefWindowProc(hWnd, message, wParam, lParam);
     }
 
+    // 本条消息改动了相机或场景时，发布新的快照给渲染线程
+    if (g_pD3DManager)
+    {
+        g_pD3DManager->PublishSnapshot();
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,386 @@
+#include "DescriptorAllocator.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+DescriptorAllocator::DescriptorAllocator(IDescriptorHeapSource& source, uint32_t transientCapacity, uint32_t maxCapacity)
+    : m_source(source)
+    , m_transientCapacity(transientCapacity)
+    , m_maxCapacity(maxCapacity)
+{
+}
+
+DescriptorAllocator::~DescriptorAllocator()
+{
+    ReleaseAll();
+}
+
+bool DescriptorAllocator::Initialize(uint32_t persistentCapacity)
+{
+    ReleaseAll();
+
+    if (persistentCapacity == 0 || (uint64_t)persistentCapacity + m_transientCapacity > m_maxCapacity)
+    {
+        return false;
+    }
+    if (!m_source.CreateHeap(persistentCapacity + m_transientCapacity, m_heap))
+    {
+        m_heap = DescriptorHeapPage{};
+        return false;
+    }
+
+    m_descriptorSize = m_source.GetDescriptorSize();
+    m_persistentCapacity = persistentCapacity;
+    m_freeBlocks.push_back({ 0, persistentCapacity });
+    return true;
+}
+
+// ============================================================================
+// 帧边界
+// ============================================================================
+void DescriptorAllocator::BeginFrame(uint64_t completedFenceValue)
+{
+    while (!m_transientMarks.empty() && m_transientMarks.front().FenceValue <= completedFenceValue)
+    {
+        m_transientTail = m_transientMarks.front().End;
+        m_transientMarks.pop_front();
+    }
+    if (m_transientMarks.empty())
+    {
+        m_transientTail = m_transientHead;
+    }
+    m_transientUsed = (uint32_t)(m_transientHead - m_transientTail);
+    m_frameStart = m_transientHead;
+
+    while (!m_retiredHeaps.empty() && m_retiredHeaps.front().FenceValue <= completedFenceValue)
+    {
+        m_source.DestroyHeap(m_retiredHeaps.front().Heap);
+        m_retiredHeaps.pop_front();
+    }
+}
+
+void DescriptorAllocator::EndFrame(uint64_t fenceValue)
+{
+    if (m_transientHead != m_frameStart)
+    {
+        m_transientMarks.push_back({ fenceValue, m_transientHead });
+    }
+    m_frameStart = m_transientHead;
+
+    for (const DescriptorHeapPage& heap : m_frameRetired)
+    {
+        m_retiredHeaps.push_back({ fenceValue, heap });
+    }
+    m_frameRetired.clear();
+}
+
+// ============================================================================
+// 持久区间
+// ============================================================================
+bool DescriptorAllocator::AllocatePersistent(uint32_t count, DescriptorRangeId& out)
+{
+    if (count == 0 || !m_heap.Handle)
+    {
+        return false;
+    }
+
+    uint32_t offset = 0;
+    if (!TakeFreeBlock(count, offset))
+    {
+        // 空闲总量够只是太碎：按原容量压缩；否则扩容（至少翻倍）
+        uint32_t needed = m_persistentUsed + count;
+        uint32_t capacity = m_persistentCapacity;
+        if (needed > capacity)
+        {
+            uint64_t grown = std::max<uint64_t>((uint64_t)capacity * 2, needed);
+            uint64_t limit = m_maxCapacity > m_transientCapacity ? m_maxCapacity - m_transientCapacity : 0;
+            capacity = (uint32_t)std::min<uint64_t>(grown, limit);
+            if (capacity < needed)
+            {
+                return false;
+            }
+        }
+
+        if (!Migrate(capacity) || !TakeFreeBlock(count, offset))
+        {
+            return false;
+        }
+    }
+
+    DescriptorRangeId id;
+    if (!m_freeIds.empty())
+    {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    }
+    else
+    {
+        id = (DescriptorRangeId)m_ranges.size();
+        m_ranges.push_back(Range{});
+    }
+
+    Range& range = m_ranges[id];
+    range.Offset = offset;
+    range.Count = count;
+    range.Live = true;
+    m_persistentUsed += count;
+    out = id;
+    return true;
+}
+
+void DescriptorAllocator::FreePersistent(DescriptorRangeId id)
+{
+    if (id >= m_ranges.size() || !m_ranges[id].Live)
+    {
+        return;
+    }
+
+    Range& range = m_ranges[id];
+    ReturnFreeBlock(range.Offset, range.Count);
+    m_persistentUsed -= range.Count;
+    range.Live = false;
+    m_freeIds.push_back(id);
+}
+
+bool DescriptorAllocator::TakeFreeBlock(uint32_t count, uint32_t& outOffset)
+{
+    for (size_t i = 0; i < m_freeBlocks.size(); ++i)
+    {
+        FreeBlock& block = m_freeBlocks[i];
+        if (block.Count < count)
+        {
+            continue;
+        }
+
+        outOffset = block.Offset;
+        block.Offset += count;
+        block.Count -= count;
+        if (block.Count == 0)
+        {
+            m_freeBlocks.erase(m_freeBlocks.begin() + i);
+        }
+        return true;
+    }
+    return false;
+}
+
+void DescriptorAllocator::ReturnFreeBlock(uint32_t offset, uint32_t count)
+{
+    auto it = std::lower_bound(m_freeBlocks.begin(), m_freeBlocks.end(), offset,
+        [](const FreeBlock& block, uint32_t value) { return block.Offset < value; });
+
+    // 与前后相邻的空闲块合并
+    bool mergePrev = it != m_freeBlocks.begin() && (it - 1)->Offset + (it - 1)->Count == offset;
+    bool mergeNext = it != m_freeBlocks.end() && offset + count == it->Offset;
+
+    if (mergePrev && mergeNext)
+    {
+        (it - 1)->Count += count + it->Count;
+        m_freeBlocks.erase(it);
+    }
+    else if (mergePrev)
+    {
+        (it - 1)->Count += count;
+    }
+    else if (mergeNext)
+    {
+        it->Offset = offset;
+        it->Count += count;
+    }
+    else
+    {
+        m_freeBlocks.insert(it, { offset, count });
+    }
+}
+
+uint32_t DescriptorAllocator::GetLargestFreeBlock() const
+{
+    uint32_t largest = 0;
+    for (const FreeBlock& block : m_freeBlocks)
+    {
+        largest = std::max(largest, block.Count);
+    }
+    return largest;
+}
+
+// ============================================================================
+// 迁移：把存活的持久区间按原顺序紧密复制到新堆，临时环在新堆上从空开始
+// ============================================================================
+bool DescriptorAllocator::Migrate(uint32_t persistentCapacity)
+{
+    if (persistentCapacity < m_persistentUsed)
+    {
+        return false;
+    }
+
+    DescriptorHeapPage heap;
+    if (!m_source.CreateHeap(persistentCapacity + m_transientCapacity, heap))
+    {
+        return false;
+    }
+
+    std::vector<DescriptorRangeId> live;
+    live.reserve(m_ranges.size() - m_freeIds.size());
+    for (DescriptorRangeId id = 0; id < (DescriptorRangeId)m_ranges.size(); ++id)
+    {
+        if (m_ranges[id].Live)
+        {
+            live.push_back(id);
+        }
+    }
+    std::sort(live.begin(), live.end(), [this](DescriptorRangeId a, DescriptorRangeId b)
+    {
+        return m_ranges[a].Offset < m_ranges[b].Offset;
+    });
+
+    // 源中相邻的区间在目标中也相邻，合并成一次复制
+    uint32_t dst = 0;
+    uint32_t runSrc = 0;
+    uint32_t runDst = 0;
+    uint32_t runCount = 0;
+    for (DescriptorRangeId id : live)
+    {
+        Range& range = m_ranges[id];
+        if (runCount > 0 && runSrc + runCount != range.Offset)
+        {
+            m_source.Copy(heap, runDst, m_heap, runSrc, runCount);
+            runCount = 0;
+        }
+        if (runCount == 0)
+        {
+            runSrc = range.Offset;
+            runDst = dst;
+        }
+        runCount += range.Count;
+
+        range.Offset = dst;
+        dst += range.Count;
+    }
+    if (runCount > 0)
+    {
+        m_source.Copy(heap, runDst, m_heap, runSrc, runCount);
+    }
+    if (dst > 0)
+    {
+        m_source.Publish(heap, 0, dst);
+    }
+
+    m_freeBlocks.clear();
+    if (dst < persistentCapacity)
+    {
+        m_freeBlocks.push_back({ dst, persistentCapacity - dst });
+    }
+
+    // 旧堆可能仍被在途帧引用（包括本帧已分配的临时描述符），随本帧栅栏退役
+    m_frameRetired.push_back(m_heap);
+    m_heap = heap;
+    m_persistentCapacity = persistentCapacity;
+
+    m_transientMarks.clear();
+    m_transientTail = m_transientHead;
+    m_frameStart = m_transientHead;
+    m_transientUsed = 0;
+
+    ++m_migrationCount;
+    return true;
+}
+
+// ============================================================================
+// 临时描述符环
+// ============================================================================
+bool DescriptorAllocator::AllocateTransient(uint32_t count, uint32_t& outOffset)
+{
+    if (count == 0 || count > m_transientCapacity || !m_heap.Handle)
+    {
+        return false;
+    }
+
+    // 区间不跨越环尾：放不下时跳过尾部剩余的部分
+    uint32_t position = (uint32_t)(m_transientHead % m_transientCapacity);
+    uint32_t skip = position + count > m_transientCapacity ? m_transientCapacity - position : 0;
+    if (m_transientHead + skip + count - m_transientTail > m_transientCapacity)
+    {
+        return false;
+    }
+
+    m_transientHead += skip;
+    outOffset = m_persistentCapacity + (uint32_t)(m_transientHead % m_transientCapacity);
+    m_transientHead += count;
+    m_transientUsed = (uint32_t)(m_transientHead - m_transientTail);
+    return true;
+}
+
+void DescriptorAllocator::Publish(uint32_t offset, uint32_t count)
+{
+    if (m_heap.Handle && count > 0)
+    {
+        m_source.Publish(m_heap, offset, count);
+    }
+}
+
+void DescriptorAllocator::ReleaseAll()
+{
+    for (const RetiredHeap& retired : m_retiredHeaps)
+    {
+        m_source.DestroyHeap(retired.Heap);
+    }
+    m_retiredHeaps.clear();
+    for (const DescriptorHeapPage& heap : m_frameRetired)
+    {
+        m_source.DestroyHeap(heap);
+    }
+    m_frameRetired.clear();
+    if (m_heap.Handle)
+    {
+        m_source.DestroyHeap(m_heap);
+    }
+    m_heap = DescriptorHeapPage{};
+
+    m_persistentCapacity = 0;
+    m_persistentUsed = 0;
+    m_ranges.clear();
+    m_freeIds.clear();
+    m_freeBlocks.clear();
+
+    m_transientHead = 0;
+    m_transientTail = 0;
+    m_transientUsed = 0;
+    m_frameStart = 0;
+    m_transientMarks.clear();
+}
+
+// ============================================================================
+// CPU 堆来源
+// ============================================================================
+bool CpuDescriptorHeapSource::CreateHeap(uint32_t capacity, DescriptorHeapPage& out)
+{
+    uint8_t* memory = new (std::nothrow) uint8_t[(size_t)capacity * m_descriptorSize]();
+    if (!memory)
+    {
+        return false;
+    }
+
+    out.CpuBase = reinterpret_cast<uint64_t>(memory);
+    out.GpuBase = out.CpuBase;
+    out.Capacity = capacity;
+    out.Handle = memory;
+    ++m_liveHeaps;
+    return true;
+}
+
+void CpuDescriptorHeapSource::DestroyHeap(const DescriptorHeapPage& heap)
+{
+    if (heap.Handle)
+    {
+        delete[] static_cast<uint8_t*>(heap.Handle);
+        --m_liveHeaps;
+    }
+}
+
+void CpuDescriptorHeapSource::Copy(const DescriptorHeapPage& dst, uint32_t dstOffset,
+    const DescriptorHeapPage& src, uint32_t srcOffset, uint32_t count)
+{
+    memcpy(reinterpret_cast<uint8_t*>(dst.CpuBase) + (size_t)dstOffset * m_descriptorSize,
+        reinterpret_cast<const uint8_t*>(src.CpuBase) + (size_t)srcOffset * m_descriptorSize,
+        (size_t)count * m_descriptorSize);
+}
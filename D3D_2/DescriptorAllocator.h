@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// 一个描述符堆：CpuBase 是写入描述符用的 CPU 句柄起点，GpuBase 是着色器可见的 GPU 句柄起点
+struct DescriptorHeapPage
+{
+    uint64_t CpuBase = 0;
+    uint64_t GpuBase = 0;
+    uint32_t Capacity = 0;
+    void* Handle = nullptr;       // 堆来源自己的标识
+};
+
+// 堆来源：D3D12 实现见 D3D12DescriptorHeapSource，CPU 实现见 CpuDescriptorHeapSource
+class IDescriptorHeapSource
+{
+public:
+    virtual ~IDescriptorHeapSource() = default;
+
+    virtual bool CreateHeap(uint32_t capacity, DescriptorHeapPage& out) = 0;
+    virtual void DestroyHeap(const DescriptorHeapPage& heap) = 0;
+
+    // 相邻两个描述符之间的字节跨度
+    virtual uint32_t GetDescriptorSize() const = 0;
+
+    // 把 src 中 [srcOffset, srcOffset + count) 的描述符复制到 dst 的 dstOffset（不同的堆）
+    virtual void Copy(const DescriptorHeapPage& dst, uint32_t dstOffset,
+        const DescriptorHeapPage& src, uint32_t srcOffset, uint32_t count) = 0;
+
+    // 在 CpuBase 写完 [offset, offset + count) 之后调用，使其对着色器可见
+    virtual void Publish(const DescriptorHeapPage& heap, uint32_t offset, uint32_t count) = 0;
+};
+
+// 持久区间句柄：区间在迁移/压缩时会移动，偏移需要每次用 GetOffset 重新查询
+typedef uint32_t DescriptorRangeId;
+const DescriptorRangeId InvalidDescriptorRange = 0xFFFFFFFFu;
+
+// 着色器可见描述符分配器。堆分两段：
+//   [0, persistentCapacity)                      持久区间，首次适配 + 相邻空闲合并
+//   [persistentCapacity, + transientCapacity)    每帧临时描述符环，按帧栅栏回收
+// 持久段放不下时迁移到新堆：空闲总量够就按原容量压缩，否则容量翻倍。
+// 迁移后旧堆挂上当前栅栏值，完成后才销毁，在途帧仍可以读它。
+class DescriptorAllocator
+{
+public:
+    DescriptorAllocator(IDescriptorHeapSource& source, uint32_t transientCapacity, uint32_t maxCapacity);
+    ~DescriptorAllocator();
+
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+    bool Initialize(uint32_t persistentCapacity);
+
+    // 回收栅栏值 <= completedFenceValue 的临时描述符与旧堆
+    void BeginFrame(uint64_t completedFenceValue);
+    // 本帧的临时描述符与本帧退役的堆在 fenceValue 完成后回收
+    void EndFrame(uint64_t fenceValue);
+
+    // 分配 count 个连续的持久描述符；需要时迁移到新堆，达到 maxCapacity 仍放不下时返回 false
+    bool AllocatePersistent(uint32_t count, DescriptorRangeId& out);
+    // 立即归还（在途帧仍可能引用时，由调用方推迟到栅栏完成后再调用）
+    void FreePersistent(DescriptorRangeId id);
+
+    uint32_t GetOffset(DescriptorRangeId id) const { return m_ranges[id].Offset; }
+    uint32_t GetCount(DescriptorRangeId id) const { return m_ranges[id].Count; }
+
+    // 分配本帧用的 count 个连续临时描述符，环满时返回 false
+    bool AllocateTransient(uint32_t count, uint32_t& outOffset);
+
+    // 把 [offset, offset + count) 的写入发布给着色器
+    void Publish(uint32_t offset, uint32_t count);
+    void Publish(DescriptorRangeId id) { Publish(m_ranges[id].Offset, m_ranges[id].Count); }
+
+    // 按当前容量迁移一次，把持久区间紧密排到堆头部
+    bool Compact() { return Migrate(m_persistentCapacity); }
+
+    // GPU 已空闲时调用：销毁全部堆
+    void ReleaseAll();
+
+    uint64_t GetCpuHandle(uint32_t offset) const { return m_heap.CpuBase + (uint64_t)offset * m_descriptorSize; }
+    uint64_t GetGpuHandle(uint32_t offset) const { return m_heap.GpuBase + (uint64_t)offset * m_descriptorSize; }
+    const DescriptorHeapPage& GetHeap() const { return m_heap; }
+
+    uint32_t GetPersistentCapacity() const { return m_persistentCapacity; }
+    uint32_t GetTransientCapacity() const { return m_transientCapacity; }
+    uint32_t GetPersistentUsed() const { return m_persistentUsed; }
+    uint32_t GetLargestFreeBlock() const;
+    uint32_t GetTransientUsed() const { return m_transientUsed; }
+    uint64_t GetMigrationCount() const { return m_migrationCount; }
+    size_t GetRetiredHeapCount() const { return m_retiredHeaps.size(); }
+
+private:
+    struct Range
+    {
+        uint32_t Offset = 0;
+        uint32_t Count = 0;
+        bool Live = false;
+    };
+
+    struct FreeBlock
+    {
+        uint32_t Offset;
+        uint32_t Count;
+    };
+
+    struct TransientMark
+    {
+        uint64_t FenceValue;
+        uint64_t End;         // 该帧结束时环的写位置（逻辑位置，不取模）
+    };
+
+    struct RetiredHeap
+    {
+        uint64_t FenceValue;
+        DescriptorHeapPage Heap;
+    };
+
+    bool TakeFreeBlock(uint32_t count, uint32_t& outOffset);
+    void ReturnFreeBlock(uint32_t offset, uint32_t count);
+    bool Migrate(uint32_t persistentCapacity);
+
+private:
+    IDescriptorHeapSource& m_source;
+    uint32_t m_descriptorSize = 0;
+    uint32_t m_transientCapacity;
+    uint32_t m_maxCapacity;
+
+    DescriptorHeapPage m_heap;
+    uint32_t m_persistentCapacity = 0;
+    uint32_t m_persistentUsed = 0;
+
+    std::vector<Range> m_ranges;
+    std::vector<DescriptorRangeId> m_freeIds;
+    std::vector<FreeBlock> m_freeBlocks;      // 按偏移排序，相邻块总是已合并
+
+    // 临时环：逻辑位置单调增长，取模得到段内偏移
+    uint64_t m_transientHead = 0;             // 下一个可分配的逻辑位置
+    uint64_t m_transientTail = 0;             // 仍被 GPU 使用的最早逻辑位置
+    uint32_t m_transientUsed = 0;
+    uint64_t m_frameStart = 0;
+    std::deque<TransientMark> m_transientMarks;
+
+    std::vector<DescriptorHeapPage> m_frameRetired;   // 本帧退役、尚未挂栅栏的堆
+    std::deque<RetiredHeap> m_retiredHeaps;
+    uint64_t m_migrationCount = 0;
+};
+
+// 纯 CPU 实现：描述符就是 descriptorSize 字节的内存块，GPU 句柄与 CPU 句柄相同。
+// 用于在没有 GPU 的平台上随机测试与压测分配模式
+class CpuDescriptorHeapSource : public IDescriptorHeapSource
+{
+public:
+    explicit CpuDescriptorHeapSource(uint32_t descriptorSize) : m_descriptorSize(descriptorSize) {}
+
+    bool CreateHeap(uint32_t capacity, DescriptorHeapPage& out) override;
+    void DestroyHeap(const DescriptorHeapPage& heap) override;
+    uint32_t GetDescriptorSize() const override { return m_descriptorSize; }
+    void Copy(const DescriptorHeapPage& dst, uint32_t dstOffset,
+        const DescriptorHeapPage& src, uint32_t srcOffset, uint32_t count) override;
+    void Publish(const DescriptorHeapPage&, uint32_t, uint32_t) override {}
+
+    size_t GetLiveHeapCount() const { return m_liveHeaps; }
+
+private:
+    uint32_t m_descriptorSize;
+    size_t m_liveHeaps = 0;
+};
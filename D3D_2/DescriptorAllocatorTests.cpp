@@ -0,0 +1,380 @@
+#include "SelfTest.h"
+#include "DescriptorAllocator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+
+// ============================================================================
+// DescriptorAllocator：持久段合并、临时环回绕、在途栅栏下的迁移，以及随机压测
+// ============================================================================
+namespace
+{
+    // 持久描述符里写入 tag * 16 + k，迁移/压缩后逐个核对
+    void WriteTag(const DescriptorAllocator& allocator, DescriptorRangeId id, uint64_t tag)
+    {
+        for (uint32_t k = 0; k < allocator.GetCount(id); ++k)
+        {
+            const uint64_t value = tag * 16 + k;
+            memcpy(reinterpret_cast<void*>(allocator.GetCpuHandle(allocator.GetOffset(id) + k)), &value, sizeof(value));
+        }
+    }
+
+    bool HasTag(const DescriptorAllocator& allocator, DescriptorRangeId id, uint64_t tag)
+    {
+        for (uint32_t k = 0; k < allocator.GetCount(id); ++k)
+        {
+            uint64_t value = 0;
+            memcpy(&value, reinterpret_cast<const void*>(allocator.GetCpuHandle(allocator.GetOffset(id) + k)), sizeof(value));
+            if (value != tag * 16 + k)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void TestPersistentCoalesce(SelfTestContext& ctx)
+    {
+        CpuDescriptorHeapSource source(8);
+        DescriptorAllocator allocator(source, 8, 1024);
+        SELF_CHECK(ctx, allocator.Initialize(16));
+
+        DescriptorRangeId ids[4];
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            SELF_CHECK(ctx, allocator.AllocatePersistent(4, ids[i]) && allocator.GetOffset(ids[i]) == i * 4);
+        }
+        SELF_CHECK(ctx, allocator.GetPersistentUsed() == 16 && allocator.GetLargestFreeBlock() == 0);
+
+        // 释放中间两块合并成一块，再释放头部一块与之合并
+        allocator.FreePersistent(ids[1]);
+        allocator.FreePersistent(ids[2]);
+        SELF_CHECK(ctx, allocator.GetLargestFreeBlock() == 8);
+        allocator.FreePersistent(ids[0]);
+        SELF_CHECK(ctx, allocator.GetLargestFreeBlock() == 12);
+
+        // 合并后的块放得下，不需要迁移
+        DescriptorRangeId big;
+        SELF_CHECK(ctx, allocator.AllocatePersistent(12, big) && allocator.GetOffset(big) == 0);
+        SELF_CHECK(ctx, allocator.GetMigrationCount() == 0);
+
+        allocator.FreePersistent(ids[3]);
+        allocator.FreePersistent(big);
+        SELF_CHECK(ctx, allocator.GetPersistentUsed() == 0 && allocator.GetLargestFreeBlock() == 16);
+
+        // 达到 maxCapacity 仍放不下时失败
+        DescriptorAllocator limited(source, 4, 20);
+        DescriptorRangeId id;
+        SELF_CHECK(ctx, limited.Initialize(8) && limited.AllocatePersistent(16, id));
+        SELF_CHECK(ctx, !limited.AllocatePersistent(1, id));
+    }
+
+    // 临时环：区间不跨越环尾，从不与在途帧的区间重叠，栅栏完成后空间回来
+    void TestTransientRing(SelfTestContext& ctx)
+    {
+        CpuDescriptorHeapSource source(8);
+        SimulatedFence fence;
+        DescriptorAllocator allocator(source, 8, 1024);
+        SELF_CHECK(ctx, allocator.Initialize(4));
+
+        uint32_t offset = 0;
+        int fits = 0;
+        allocator.BeginFrame(fence.GetCompletedValue());
+        while (allocator.AllocateTransient(3, offset))
+        {
+            SELF_CHECK(ctx, offset >= 4 && offset + 3 <= 12);
+            ++fits;
+        }
+        SELF_CHECK(ctx, fits == 2);
+        allocator.EndFrame(fence.Signal());
+        allocator.BeginFrame(fence.GetCompletedValue());
+        SELF_CHECK(ctx, !allocator.AllocateTransient(3, offset));
+        fence.Complete(1);
+        allocator.BeginFrame(fence.GetCompletedValue());
+        // 尾部剩 2 个放不下：跳过它们回绕到环头，跳过的部分也算占用
+        SELF_CHECK(ctx, allocator.AllocateTransient(3, offset) && offset == 4 && allocator.GetTransientUsed() == 5);
+        allocator.EndFrame(fence.Signal());
+
+        struct Span
+        {
+            uint32_t Offset;
+            uint32_t Count;
+            uint64_t FenceValue;
+        };
+        std::vector<Span> live;
+        std::mt19937 rng(5);
+        bool contiguous = true, disjoint = true;
+        uint64_t wraps = 0, lastOffset = 0;
+        DescriptorAllocator ring(source, 61, 1024);
+        SELF_CHECK(ctx, ring.Initialize(16));
+        for (int frame = 0; frame < 2000; ++frame)
+        {
+            const uint64_t lag = rng() % 3;
+            const uint64_t last = fence.GetLastSignaledValue();
+            fence.Complete(last > lag ? last - lag : 0);
+            ring.BeginFrame(fence.GetCompletedValue());
+
+            size_t keep = 0;
+            for (const Span& span : live)
+            {
+                if (span.FenceValue > fence.GetCompletedValue())
+                {
+                    live[keep++] = span;
+                }
+            }
+            live.resize(keep);
+            const size_t retired = live.size();
+
+            for (uint32_t n = rng() % 8; n > 0; --n)
+            {
+                const uint32_t count = 1 + rng() % 5;
+                if (!ring.AllocateTransient(count, offset))
+                {
+                    continue;
+                }
+                contiguous &= offset >= 16 && offset + count <= 16 + 61;
+                wraps += offset < lastOffset ? 1 : 0;
+                lastOffset = offset;
+                for (const Span& span : live)
+                {
+                    disjoint &= offset + count <= span.Offset || span.Offset + span.Count <= offset;
+                }
+                live.push_back(Span{ offset, count, 0 });
+            }
+
+            const uint64_t value = fence.Signal();
+            for (size_t i = retired; i < live.size(); ++i)
+            {
+                live[i].FenceValue = value;
+            }
+            ring.EndFrame(value);
+        }
+        SELF_CHECK(ctx, contiguous && disjoint);
+        SELF_CHECK(ctx, wraps > 100);
+    }
+
+    // 迁移时旧堆挂上当前帧的栅栏，在途帧完成前不销毁；迁移后内容不变
+    void TestMigrationUnderFences(SelfTestContext& ctx)
+    {
+        CpuDescriptorHeapSource source(8);
+        SimulatedFence fence;
+        {
+            DescriptorAllocator allocator(source, 16, 1024);
+            SELF_CHECK(ctx, allocator.Initialize(8));
+
+            allocator.BeginFrame(fence.GetCompletedValue());
+            DescriptorRangeId a, b, c;
+            SELF_CHECK(ctx, allocator.AllocatePersistent(4, a) && allocator.AllocatePersistent(4, b));
+            WriteTag(allocator, a, 1);
+            WriteTag(allocator, b, 2);
+            allocator.EndFrame(fence.Signal());
+
+            // 在途帧仍在读旧堆时迁移（容量翻倍）
+            allocator.BeginFrame(fence.GetCompletedValue());
+            const uint64_t oldHeap = allocator.GetHeap().CpuBase;
+            SELF_CHECK(ctx, allocator.AllocatePersistent(6, c));
+            WriteTag(allocator, c, 3);
+            SELF_CHECK(ctx, allocator.GetMigrationCount() == 1 && allocator.GetPersistentCapacity() == 16);
+            SELF_CHECK(ctx, allocator.GetHeap().CpuBase != oldHeap && source.GetLiveHeapCount() == 2);
+            SELF_CHECK(ctx, HasTag(allocator, a, 1) && HasTag(allocator, b, 2) && HasTag(allocator, c, 3));
+            const uint64_t migrationFence = fence.Signal();
+            allocator.EndFrame(migrationFence);
+            SELF_CHECK(ctx, allocator.GetRetiredHeapCount() == 1);
+
+            // 迁移那一帧完成前旧堆一直保留
+            fence.Complete(migrationFence - 1);
+            allocator.BeginFrame(fence.GetCompletedValue());
+            SELF_CHECK(ctx, allocator.GetRetiredHeapCount() == 1 && source.GetLiveHeapCount() == 2);
+            allocator.EndFrame(fence.Signal());
+            fence.Complete(migrationFence);
+            allocator.BeginFrame(fence.GetCompletedValue());
+            SELF_CHECK(ctx, allocator.GetRetiredHeapCount() == 0 && source.GetLiveHeapCount() == 1);
+
+            // 空闲够用时按原容量压缩：区间排到头部，内容不变
+            allocator.FreePersistent(a);
+            SELF_CHECK(ctx, allocator.Compact());
+            SELF_CHECK(ctx, allocator.GetPersistentCapacity() == 16 && allocator.GetLargestFreeBlock() == 6);
+            SELF_CHECK(ctx, HasTag(allocator, b, 2) && HasTag(allocator, c, 3));
+            allocator.EndFrame(fence.Signal());
+            SELF_CHECK(ctx, allocator.GetRetiredHeapCount() == 1);
+        }
+        // 析构时连同未到期的旧堆一起销毁
+        SELF_CHECK(ctx, source.GetLiveHeapCount() == 0);
+    }
+
+    // 随机分配/释放/临时分配/压缩，GPU 随机落后：内容、容量不重叠、旧堆按时回收
+    void TestRandomFuzz(SelfTestContext& ctx)
+    {
+        CpuDescriptorHeapSource source(8);
+        SimulatedFence fence;
+        std::mt19937 rng(1);
+        bool allocated = true, intact = true, disjoint = true, transient = true;
+        {
+            DescriptorAllocator allocator(source, 64, 1 << 16);
+            SELF_CHECK(ctx, allocator.Initialize(16));
+            std::map<DescriptorRangeId, std::pair<uint32_t, uint64_t>> live;
+            uint64_t tag = 1;
+
+            for (int frame = 0; frame < 3000; ++frame)
+            {
+                const uint64_t lag = rng() % 4;
+                const uint64_t last = fence.GetLastSignaledValue();
+                fence.Complete(last > lag ? last - lag : 0);
+                allocator.BeginFrame(fence.GetCompletedValue());
+
+                for (uint32_t n = rng() % 8; n > 0; --n)
+                {
+                    if (rng() % 3 != 0 && live.size() < 500)
+                    {
+                        const uint32_t count = 1 + rng() % 6;
+                        DescriptorRangeId id;
+                        if (!allocator.AllocatePersistent(count, id))
+                        {
+                            allocated = false;
+                            continue;
+                        }
+                        WriteTag(allocator, id, tag);
+                        allocator.Publish(id);
+                        live[id] = std::make_pair(count, tag++);
+                    }
+                    else if (!live.empty())
+                    {
+                        auto it = live.begin();
+                        std::advance(it, rng() % live.size());
+                        allocator.FreePersistent(it->first);
+                        live.erase(it);
+                    }
+                }
+
+                uint32_t offset = 0;
+                for (uint32_t n = rng() % 6; n > 0; --n)
+                {
+                    if (allocator.AllocateTransient(1 + rng() % 3, offset))
+                    {
+                        transient &= offset >= allocator.GetPersistentCapacity();
+                    }
+                }
+
+                if (frame % 20 == 0)
+                {
+                    std::vector<char> used(allocator.GetPersistentCapacity(), 0);
+                    for (const auto& entry : live)
+                    {
+                        const uint32_t start = allocator.GetOffset(entry.first);
+                        intact &= allocator.GetCount(entry.first) == entry.second.first &&
+                            HasTag(allocator, entry.first, entry.second.second);
+                        for (uint32_t k = 0; k < entry.second.first; ++k)
+                        {
+                            disjoint &= start + k < used.size() && !used[start + k];
+                            if (start + k < used.size())
+                            {
+                                used[start + k] = 1;
+                            }
+                        }
+                    }
+                }
+                if (frame % 500 == 250)
+                {
+                    allocator.Compact();
+                }
+                allocator.EndFrame(fence.Signal());
+            }
+
+            SELF_CHECK(ctx, allocator.GetMigrationCount() > 0);
+            fence.Complete(fence.GetLastSignaledValue());
+            allocator.BeginFrame(fence.GetCompletedValue());
+            SELF_CHECK(ctx, allocator.GetRetiredHeapCount() == 0 && source.GetLiveHeapCount() == 1);
+        }
+        SELF_CHECK(ctx, allocated && intact && disjoint && transient);
+        SELF_CHECK(ctx, source.GetLiveHeapCount() == 0);
+    }
+}
+
+void TestDescriptorAllocator(SelfTestContext& ctx)
+{
+    TestPersistentCoalesce(ctx);
+    TestTransientRing(ctx);
+    TestMigrationUnderFences(ctx);
+    TestRandomFuzz(ctx);
+}
+
+// ============================================================================
+// 基准：持久区间随机分配/释放（含迁移），以及每帧临时描述符分配
+// ============================================================================
+bool RunDescriptorAllocatorBenchmark(int operations)
+{
+    if (operations <= 0)
+    {
+        return false;
+    }
+
+    CpuDescriptorHeapSource source(32);
+    SimulatedFence fence;
+    DescriptorAllocator allocator(source, 16384, 1 << 20);
+    if (!allocator.Initialize(1024))
+    {
+        return false;
+    }
+
+    std::mt19937 rng(2);
+    std::vector<DescriptorRangeId> ids;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < operations; ++i)
+    {
+        if (ids.size() < 4096 && (rng() & 1))
+        {
+            DescriptorRangeId id;
+            if (!allocator.AllocatePersistent(1 + rng() % 4, id))
+            {
+                return false;
+            }
+            ids.push_back(id);
+        }
+        else if (!ids.empty())
+        {
+            const size_t k = rng() % ids.size();
+            allocator.FreePersistent(ids[k]);
+            ids[k] = ids.back();
+            ids.pop_back();
+        }
+    }
+    const double persistentMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // 每帧 2000 个 1~3 描述符的临时区间，GPU 落后两帧
+    const int frames = (std::max)(1, operations / 2000);
+    uint64_t transientCount = 0, transientFailures = 0;
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        const uint64_t last = fence.GetLastSignaledValue();
+        fence.Complete(last > 2 ? last - 2 : 0);
+        allocator.BeginFrame(fence.GetCompletedValue());
+        uint32_t offset = 0;
+        for (int n = 0; n < 2000; ++n)
+        {
+            if (allocator.AllocateTransient(1 + (uint32_t)(n % 3), offset))
+            {
+                ++transientCount;
+            }
+            else
+            {
+                ++transientFailures;
+            }
+        }
+        allocator.EndFrame(fence.Signal());
+    }
+    const double transientMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    printf("Descriptor allocator benchmark: %d persistent operations, %d transient frames\n"
+        "  persistent %.1f ns/op, capacity %u, used %u, largest free %u, %llu migrations\n"
+        "  transient %.1f ns/allocation, %llu ring-full failures\n",
+        operations, frames, persistentMs * 1e6 / operations, allocator.GetPersistentCapacity(),
+        allocator.GetPersistentUsed(), allocator.GetLargestFreeBlock(),
+        (unsigned long long)allocator.GetMigrationCount(),
+        transientMs * 1e6 / (double)(std::max)(transientCount, (uint64_t)1), (unsigned long long)transientFailures);
+    fflush(stdout);
+    return true;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+
+// 提交阶段的状态变化统计（每帧）
+struct DrawStateStats
+{
+    uint32_t Draws = 0;
+    uint32_t Instances = 0;           // 不做实例化时需要的绘制调用数
+    uint64_t Indices = 0;             // 所有实例提交的索引数
+    uint32_t RootParameterSets = 0;   // 根常量 + 根 CBV/SRV
+    uint32_t PipelineBinds = 0;
+    uint32_t GeometryBinds = 0;       // IASetVertexBuffers + IASetIndexBuffer
+    uint32_t TopologyBinds = 0;
+    uint32_t DescriptorTableBinds = 0;
+
+    uint32_t PipelineBindsSaved = 0;
+    uint32_t GeometryBindsSaved = 0;
+    uint32_t TopologyBindsSaved = 0;
+    uint32_t DescriptorTableBindsSaved = 0;
+
+    // 合并多条命令列表的统计
+    void Add(const DrawStateStats& other)
+    {
+        Draws += other.Draws;
+        Instances += other.Instances;
+        Indices += other.Indices;
+        RootParameterSets += other.RootParameterSets;
+        PipelineBinds += other.PipelineBinds;
+        GeometryBinds += other.GeometryBinds;
+        TopologyBinds += other.TopologyBinds;
+        DescriptorTableBinds += other.DescriptorTableBinds;
+        PipelineBindsSaved += other.PipelineBindsSaved;
+        GeometryBindsSaved += other.GeometryBindsSaved;
+        TopologyBindsSaved += other.TopologyBindsSaved;
+        DescriptorTableBindsSaved += other.DescriptorTableBindsSaved;
+    }
+};
+
+// 记录命令列表上当前绑定的状态，只有真正变化时才让调用者发出 Set 调用。
+// 不依赖 D3D12，状态用整数编号表示，便于在 CPU 上单独验证。
+class DrawStateCache
+{
+public:
+    static const uint32_t Unbound = 0xFFFFFFFFu;
+
+    // 命令列表 Reset 之后调用，所有状态视为未绑定
+    void Reset()
+    {
+        m_pipeline = Unbound;
+        m_geometry = Unbound;
+        m_topology = Unbound;
+        m_descriptorTable = Unbound;
+        m_stats = DrawStateStats{};
+    }
+
+    // 外部直接改了命令列表状态（例如 Reset 时传入了 PSO）时同步缓存
+    void NotePipeline(uint32_t pipeline) { m_pipeline = pipeline; }
+
+    // 返回 true 表示需要发出对应的绑定调用
+    bool SetPipeline(uint32_t pipeline)
+    {
+        return Apply(m_pipeline, pipeline, m_stats.PipelineBinds, m_stats.PipelineBindsSaved);
+    }
+
+    bool SetGeometry(uint32_t geometry)
+    {
+        return Apply(m_geometry, geometry, m_stats.GeometryBinds, m_stats.GeometryBindsSaved);
+    }
+
+    bool SetTopology(uint32_t topology)
+    {
+        return Apply(m_topology, topology, m_stats.TopologyBinds, m_stats.TopologyBindsSaved);
+    }
+
+    bool SetDescriptorTable(uint32_t table)
+    {
+        return Apply(m_descriptorTable, table, m_stats.DescriptorTableBinds, m_stats.DescriptorTableBindsSaved);
+    }
+
+    void CountDraw(uint32_t instanceCount = 1, uint32_t indexCount = 0)
+    {
+        ++m_stats.Draws;
+        m_stats.Instances += instanceCount;
+        m_stats.Indices += (uint64_t)indexCount * instanceCount;
+    }
+
+    // 根参数不经过缓存（每块开头和每次绘制都要设），只计数
+    void CountRootParameters(uint32_t count) { m_stats.RootParameterSets += count; }
+
+    const DrawStateStats& GetStats() const { return m_stats; }
+
+private:
+    static bool Apply(uint32_t& current, uint32_t value, uint32_t& binds, uint32_t& saved)
+    {
+        if (current == value)
+        {
+            ++saved;
+            return false;
+        }
+        current = value;
+        ++binds;
+        return true;
+    }
+
+private:
+    uint32_t m_pipeline = Unbound;
+    uint32_t m_geometry = Unbound;
+    uint32_t m_topology = Unbound;
+    uint32_t m_descriptorTable = Unbound;
+    DrawStateStats m_stats;
+};
@@ -0,0 +1,87 @@
+#include "FrameInvalidator.h"
+
+void FrameInvalidator::Invalidate(uint32_t reasons)
+{
+    if (reasons == 0)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending |= reasons;
+        ++m_pendingCount;
+    }
+    m_cv.notify_one();
+}
+
+uint32_t FrameInvalidator::WaitForFrame()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return m_stopped || m_pending != 0; });
+
+    // 帧率上限：没到最小间隔就继续睡，只有 Stop 能提前唤醒
+    if (!m_stopped && m_maxFps > 0 && m_hasLastFrame)
+    {
+        Clock::time_point next = m_lastFrame + std::chrono::microseconds(1000000 / m_maxFps);
+        m_cv.wait_until(lock, next, [this, next]() { return m_stopped || Clock::now() >= next; });
+    }
+    if (m_stopped)
+    {
+        return 0;
+    }
+
+    uint32_t reasons = m_pending;
+    m_coalescedCount += m_pendingCount - 1;
+    m_pending = 0;
+    m_pendingCount = 0;
+    m_lastFrame = Clock::now();
+    m_hasLastFrame = true;
+    ++m_frameCount;
+    return reasons;
+}
+
+void FrameInvalidator::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopped = true;
+    }
+    m_cv.notify_all();
+}
+
+void FrameInvalidator::Reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopped = false;
+    m_pending = 0;
+    m_pendingCount = 0;
+    m_hasLastFrame = false;
+}
+
+void FrameInvalidator::SetMaxFrameRate(uint32_t fps)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxFps = fps;
+    }
+    m_cv.notify_all();
+}
+
+uint32_t FrameInvalidator::GetMaxFrameRate() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxFps;
+}
+
+uint64_t FrameInvalidator::GetFrameCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_frameCount;
+}
+
+uint64_t FrameInvalidator::GetCoalescedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_coalescedCount;
+}
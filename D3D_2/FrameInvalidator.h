@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+// 失效原因（可按位组合），只用于统计与调试，任何一个都会产生一帧
+namespace InvalidateReason
+{
+    const uint32_t Scene = 1u << 0;       // 对象增删/变换/材质/选择
+    const uint32_t View = 1u << 1;        // 相机或光照（pass 常量）变化
+    const uint32_t Resize = 1u << 2;      // 窗口尺寸变化
+    const uint32_t Resources = 1u << 3;   // 纹理等 GPU 资源的增删
+    const uint32_t Expose = 1u << 4;      // 窗口被遮挡后重新露出等，需要重画但内容没变
+    const uint32_t All = Scene | View | Resize | Resources | Expose;
+}
+
+// 按需渲染的帧调度：任意线程调用 Invalidate 标记失效，渲染线程在 WaitForFrame 中阻塞，
+// 直到有失效原因才返回，期间积累的多次失效合并成一帧。
+// 可选帧率上限：两次返回之间至少间隔 1/maxFps 秒，等待中到来的失效继续合并。
+class FrameInvalidator
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // 任意线程：标记需要重新渲染
+    void Invalidate(uint32_t reasons);
+
+    // 渲染线程：返回本帧积累的失效原因；Stop 之后返回 0
+    uint32_t WaitForFrame();
+
+    // 唤醒 WaitForFrame 并让它返回 0；Reset 之后可以重新使用
+    void Stop();
+    void Reset();
+
+    // 0 表示不限帧率
+    void SetMaxFrameRate(uint32_t fps);
+    uint32_t GetMaxFrameRate() const;
+
+    // 产生的帧数，以及被合并掉的失效次数
+    uint64_t GetFrameCount() const;
+    uint64_t GetCoalescedCount() const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    uint32_t m_pending = 0;
+    uint32_t m_pendingCount = 0;
+    bool m_stopped = false;
+
+    uint32_t m_maxFps = 0;
+    Clock::time_point m_lastFrame{};
+    bool m_hasLastFrame = false;
+
+    uint64_t m_frameCount = 0;
+    uint64_t m_coalescedCount = 0;
+};
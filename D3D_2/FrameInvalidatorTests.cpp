@@ -0,0 +1,89 @@
+#include "SelfTest.h"
+#include "FrameInvalidator.h"
+#include <atomic>
+#include <thread>
+
+// ============================================================================
+// FrameInvalidator：失效合并、阻塞等待、帧率上限与 Stop
+// ============================================================================
+namespace
+{
+    double ElapsedMs(FrameInvalidator::Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(FrameInvalidator::Clock::now() - start).count();
+    }
+}
+
+void TestFrameInvalidator(SelfTestContext& ctx)
+{
+    FrameInvalidator invalidator;
+
+    // 多次失效合并成一帧，原因按位或
+    invalidator.Invalidate(InvalidateReason::Scene);
+    invalidator.Invalidate(InvalidateReason::View);
+    invalidator.Invalidate(0);
+    SELF_CHECK(ctx, invalidator.WaitForFrame() == (InvalidateReason::Scene | InvalidateReason::View));
+    SELF_CHECK(ctx, invalidator.GetFrameCount() == 1 && invalidator.GetCoalescedCount() == 1);
+
+    // 没有失效时阻塞，直到另一个线程失效
+    std::atomic<uint32_t> reasons{ 0xFFFFFFFFu };
+    std::thread waiter([&] { reasons = invalidator.WaitForFrame(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    SELF_CHECK(ctx, reasons == 0xFFFFFFFFu);
+    invalidator.Invalidate(InvalidateReason::Resize);
+    waiter.join();
+    SELF_CHECK(ctx, reasons == InvalidateReason::Resize);
+
+    // 帧率上限 20：相邻两帧至少间隔 50ms，等待中到来的失效合并进下一帧
+    invalidator.SetMaxFrameRate(20);
+    SELF_CHECK(ctx, invalidator.GetMaxFrameRate() == 20);
+    invalidator.Invalidate(InvalidateReason::Scene);
+    invalidator.WaitForFrame();
+    FrameInvalidator::Clock::time_point start = FrameInvalidator::Clock::now();
+    for (int i = 0; i < 4; ++i)
+    {
+        invalidator.Invalidate(InvalidateReason::Scene);
+        invalidator.WaitForFrame();
+    }
+    SELF_CHECK(ctx, ElapsedMs(start) >= 4 * 50 - 5);
+
+    const uint64_t coalesced = invalidator.GetCoalescedCount();
+    std::thread late([&]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        invalidator.Invalidate(InvalidateReason::View);
+        invalidator.Invalidate(InvalidateReason::Resources);
+    });
+    invalidator.Invalidate(InvalidateReason::Scene);
+    const uint32_t merged = invalidator.WaitForFrame();
+    late.join();
+    SELF_CHECK(ctx, merged == (InvalidateReason::Scene | InvalidateReason::View | InvalidateReason::Resources));
+    SELF_CHECK(ctx, invalidator.GetCoalescedCount() == coalesced + 2);
+
+    // Stop 提前结束限帧等待并返回 0
+    std::thread stopper([&]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        invalidator.Stop();
+    });
+    invalidator.SetMaxFrameRate(1);
+    invalidator.Invalidate(InvalidateReason::Expose);
+    start = FrameInvalidator::Clock::now();
+    SELF_CHECK(ctx, invalidator.WaitForFrame() == 0);
+    SELF_CHECK(ctx, ElapsedMs(start) < 500);
+    stopper.join();
+    SELF_CHECK(ctx, invalidator.WaitForFrame() == 0);
+
+    // Reset 后重新可用；不限帧率时不等待
+    invalidator.Reset();
+    invalidator.SetMaxFrameRate(0);
+    const uint64_t frames = invalidator.GetFrameCount();
+    start = FrameInvalidator::Clock::now();
+    for (int i = 0; i < 5; ++i)
+    {
+        invalidator.Invalidate(InvalidateReason::Expose);
+        SELF_CHECK(ctx, invalidator.WaitForFrame() == InvalidateReason::Expose);
+    }
+    SELF_CHECK(ctx, ElapsedMs(start) < 40);
+    SELF_CHECK(ctx, invalidator.GetFrameCount() == frames + 5);
+}
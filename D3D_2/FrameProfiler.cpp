@@ -0,0 +1,209 @@
+#include "FrameProfiler.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+    const std::chrono::steady_clock::time_point ProfilerEpoch = std::chrono::steady_clock::now();
+
+    void AppendJsonString(std::string& out, const char* text)
+    {
+        out += '"';
+        for (const char* c = text; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                out += '\\';
+                out += *c;
+            }
+            else if ((unsigned char)*c < 0x20)
+            {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)(unsigned char)*c);
+                out += escaped;
+            }
+            else
+            {
+                out += *c;
+            }
+        }
+        out += '"';
+    }
+}
+
+// ============================================================================
+// 轨道
+// ============================================================================
+ProfileTrack::ProfileTrack(uint32_t id, const std::string& name, uint32_t capacity)
+    : m_id(id)
+    , m_name(name)
+    , m_events(new ProfileEvent[capacity])
+    , m_mask(capacity - 1)
+{
+}
+
+void ProfileTrack::Snapshot(std::vector<ProfileEvent>& out) const
+{
+    const uint64_t capacity = m_mask + 1;
+    const uint64_t end = m_writeCount.load(std::memory_order_acquire);
+    const uint64_t begin = end > capacity ? end - capacity : 0;
+
+    const size_t base = out.size();
+    for (uint64_t i = begin; i < end; ++i)
+    {
+        out.push_back(m_events[i & m_mask]);
+    }
+
+    // 拷贝期间写者可能绕回来覆盖了最前面的几个槽：这些事件不完整，丢掉。
+    // 写计数在事件写完后才前进，写者此刻可能正在写第 after 个事件（第 after - capacity 个的槽），它也算被覆盖
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t after = m_writeCount.load(std::memory_order_relaxed);
+    const uint64_t firstValid = after >= capacity ? after - capacity + 1 : 0;
+    if (firstValid > begin)
+    {
+        const uint64_t dropped = firstValid - begin < end - begin ? firstValid - begin : end - begin;
+        out.erase(out.begin() + base, out.begin() + base + (size_t)dropped);
+    }
+}
+
+std::string ProfileTrack::GetName() const
+{
+    std::lock_guard<std::mutex> lock(m_nameMutex);
+    return m_name;
+}
+
+void ProfileTrack::SetName(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_nameMutex);
+    m_name = name;
+}
+
+// ============================================================================
+// 分析器
+// ============================================================================
+FrameProfiler::FrameProfiler()
+{
+}
+
+FrameProfiler& FrameProfiler::Instance()
+{
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+uint64_t FrameProfiler::Now()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - ProfilerEpoch).count();
+}
+
+uint64_t FrameProfiler::FromSteadyNanoseconds(uint64_t steadyNanoseconds)
+{
+    const uint64_t epoch = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        ProfilerEpoch.time_since_epoch()).count();
+    return steadyNanoseconds > epoch ? steadyNanoseconds - epoch : 0;
+}
+
+ProfileTrack& FrameProfiler::CreateTrack(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_trackMutex);
+    return AddTrack(name);
+}
+
+ProfileTrack& FrameProfiler::AddTrack(const std::string& name)
+{
+    const uint32_t id = (uint32_t)m_tracks.size() + 1;
+    m_tracks.push_back(std::make_unique<ProfileTrack>(id,
+        name.empty() ? "Thread " + std::to_string(id) : name, TrackCapacity));
+    return *m_tracks.back();
+}
+
+void FrameProfiler::SetThreadName(const std::string& name)
+{
+    GetThreadTrack().SetName(name);
+}
+
+ProfileTrack& FrameProfiler::GetTrack(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_trackMutex);
+    for (const auto& track : m_tracks)
+    {
+        if (track->GetName() == name)
+        {
+            return *track;
+        }
+    }
+    return AddTrack(name);
+}
+
+// ============================================================================
+// Chrome trace 导出
+// ============================================================================
+void FrameProfiler::WriteChromeTrace(std::string& out) const
+{
+    std::vector<const ProfileTrack*> tracks;
+    {
+        std::lock_guard<std::mutex> lock(m_trackMutex);
+        for (const auto& track : m_tracks)
+        {
+            tracks.push_back(track.get());
+        }
+    }
+
+    std::vector<std::vector<ProfileEvent>> events(tracks.size());
+    uint64_t origin = UINT64_MAX;
+    for (size_t t = 0; t < tracks.size(); ++t)
+    {
+        tracks[t]->Snapshot(events[t]);
+        for (const ProfileEvent& event : events[t])
+        {
+            origin = event.Start < origin ? event.Start : origin;
+        }
+    }
+    if (origin == UINT64_MAX)
+    {
+        origin = 0;
+    }
+
+    // "X" 为完整事件（起点 + 时长），时间单位微秒；"M" 给轨道命名
+    out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char number[96];
+    for (size_t t = 0; t < tracks.size(); ++t)
+    {
+        const uint32_t tid = tracks[t]->GetId();
+        out += first ? "\n" : ",\n";
+        first = false;
+        snprintf(number, sizeof(number), "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":", tid);
+        out += number;
+        AppendJsonString(out, tracks[t]->GetName().c_str());
+        out += "}}";
+
+        for (const ProfileEvent& event : events[t])
+        {
+            out += ",\n{\"ph\":\"X\",\"pid\":1,";
+            snprintf(number, sizeof(number), "\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":", tid,
+                (double)(event.Start - origin) / 1000.0,
+                (double)(event.End > event.Start ? event.End - event.Start : 0) / 1000.0);
+            out += number;
+            AppendJsonString(out, event.Name ? event.Name : "");
+            out += '}';
+        }
+    }
+    out += "\n]}\n";
+}
+
+bool FrameProfiler::ExportChromeTrace(const std::filesystem::path& path) const
+{
+    std::string json;
+    WriteChromeTrace(json);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        return false;
+    }
+    file.write(json.data(), (std::streamsize)json.size());
+    return file.good();
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 一次计时：名称必须是静态字符串（字面量），只存指针；时间为 FrameProfiler::Now 的纳秒
+struct ProfileEvent
+{
+    const char* Name = nullptr;
+    uint64_t Start = 0;
+    uint64_t End = 0;
+};
+
+// 一条时间线（一个线程，或 GPU 这类非线程的轨道）的环形缓冲。
+// 单写者：只有所属线程写入，写满后覆盖最旧的事件；读者无锁地拷贝，
+// 拷贝后再读一次写计数，把拷贝期间可能被覆盖的事件丢掉
+class ProfileTrack
+{
+public:
+    ProfileTrack(uint32_t id, const std::string& name, uint32_t capacity);
+
+    void Record(const char* name, uint64_t start, uint64_t end)
+    {
+        const uint64_t index = m_writeCount.load(std::memory_order_relaxed);
+        ProfileEvent& event = m_events[index & m_mask];
+        event.Name = name;
+        event.Start = start;
+        event.End = end;
+        m_writeCount.store(index + 1, std::memory_order_release);
+    }
+
+    // 可在任意线程调用：按写入顺序追加仍在缓冲中的事件。
+    // 写满后最旧的一个槽随时可能正被覆盖，所以最多返回 capacity - 1 个
+    void Snapshot(std::vector<ProfileEvent>& out) const;
+
+    uint32_t GetId() const { return m_id; }
+    std::string GetName() const;
+    void SetName(const std::string& name);
+    uint64_t GetWriteCount() const { return m_writeCount.load(std::memory_order_acquire); }
+
+private:
+    uint32_t m_id;
+    std::string m_name;
+    mutable std::mutex m_nameMutex;
+    std::unique_ptr<ProfileEvent[]> m_events;
+    uint64_t m_mask;
+    std::atomic<uint64_t> m_writeCount{ 0 };
+};
+
+// 进程内唯一的帧分析器：CPU 作用域记录到各线程自己的 ProfileTrack，
+// GPU 时间戳由 GpuProfiler 换算到同一时间轴后写进 "GPU" 轨道，按需导出为 Chrome trace JSON
+// （chrome://tracing 或 ui.perfetto.dev 直接打开）。
+// 记录路径没有锁和分配：线程第一次记录时注册轨道（加锁一次），之后只写本线程的环
+class FrameProfiler
+{
+public:
+    static FrameProfiler& Instance();
+
+    // 单调时钟的纳秒数（进程内同一起点）
+    static uint64_t Now();
+    // steady_clock 纪元下的纳秒换算到 Now 的时间轴（GPU 时钟校准用）
+    static uint64_t FromSteadyNanoseconds(uint64_t steadyNanoseconds);
+
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+    // 记录到调用线程的轨道
+    void Record(const char* name, uint64_t start, uint64_t end)
+    {
+        GetThreadTrack().Record(name, start, end);
+    }
+
+    // 给调用线程的轨道起名（导出时显示），未命名的轨道叫 "Thread N"
+    void SetThreadName(const std::string& name);
+    // 非线程轨道（如 GPU），同名返回同一条；写入方需自行保证单写者
+    ProfileTrack& GetTrack(const std::string& name);
+
+    // 导出全部轨道当前缓冲中的事件，时间以第一个事件为零点
+    bool ExportChromeTrace(const std::filesystem::path& path) const;
+    void WriteChromeTrace(std::string& out) const;
+
+    // 每条轨道的事件数上限（2 的幂）
+    static const uint32_t TrackCapacity = 16384;
+
+private:
+    FrameProfiler();
+
+    ProfileTrack& GetThreadTrack()
+    {
+        thread_local ProfileTrack* track = nullptr;
+        if (!track)
+        {
+            track = &CreateTrack(std::string());
+        }
+        return *track;
+    }
+    ProfileTrack& CreateTrack(const std::string& name);
+    // 调用者持有 m_trackMutex
+    ProfileTrack& AddTrack(const std::string& name);
+
+private:
+    std::atomic<bool> m_enabled{ true };
+    mutable std::mutex m_trackMutex;
+    // 轨道只增不删：线程退出后事件仍可导出，thread_local 指针也不会悬空
+    std::vector<std::unique_ptr<ProfileTrack>> m_tracks;
+};
+
+// 作用域计时：构造时取时间，析构时记录到本线程轨道；分析器关闭时只剩一次原子读
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name)
+        : m_name(name)
+        , m_active(FrameProfiler::Instance().IsEnabled())
+        , m_start(m_active ? FrameProfiler::Now() : 0)
+    {
+    }
+
+    ~ProfileScope()
+    {
+        if (m_active)
+        {
+            FrameProfiler::Instance().Record(m_name, m_start, FrameProfiler::Now());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_name;
+    bool m_active;
+    uint64_t m_start;
+};
+
+// 定义 DISABLE_FRAME_PROFILER 时作用域计时完全编译掉
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#ifndef DISABLE_FRAME_PROFILER
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
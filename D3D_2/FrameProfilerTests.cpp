@@ -0,0 +1,141 @@
+#include "SelfTest.h"
+#include "FrameProfiler.h"
+#include <atomic>
+#include <thread>
+
+// ============================================================================
+// ProfileTrack：环形缓冲绕回、并发快照丢弃被覆盖的事件；FrameProfiler 导出
+// ============================================================================
+namespace
+{
+    const char* const EventNames[] = { "A", "B", "C", "D", "E" };
+
+    // 第 i 个事件的各字段都由 i 决定，读到被写了一半的事件时字段对不上
+    void RecordNumbered(ProfileTrack& track, uint64_t i)
+    {
+        track.Record(EventNames[i % 5], i * 2, i * 2 + 1);
+    }
+
+    // events[begin, begin + count) 是否为从 first 开始连续编号、字段完整的事件
+    bool IsNumberedRun(const std::vector<ProfileEvent>& events, size_t begin, size_t count, uint64_t first)
+    {
+        if (begin + count > events.size())
+        {
+            return false;
+        }
+        for (size_t k = 0; k < count; ++k)
+        {
+            const uint64_t i = first + k;
+            const ProfileEvent& e = events[begin + k];
+            if (e.Name != EventNames[i % 5] || e.Start != i * 2 || e.End != i * 2 + 1)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void TestFrameProfiler(SelfTestContext& ctx)
+{
+    // 未写满：按写入顺序全部返回
+    {
+        ProfileTrack track(1, "Track", 16);
+        std::vector<ProfileEvent> events;
+        track.Snapshot(events);
+        SELF_CHECK(ctx, events.empty());
+
+        for (uint64_t i = 0; i < 10; ++i)
+        {
+            RecordNumbered(track, i);
+        }
+        track.Snapshot(events);
+        SELF_CHECK(ctx, events.size() == 10 && IsNumberedRun(events, 0, 10, 0));
+    }
+
+    // 写满与绕回：最旧的槽是写者下一个要覆盖的，不返回，只剩最近的 capacity - 1 个（最旧的在前）；
+    // 快照追加在 out 已有内容之后
+    {
+        ProfileTrack track(2, "Track", 16);
+        for (uint64_t i = 0; i < 15; ++i)
+        {
+            RecordNumbered(track, i);
+        }
+        std::vector<ProfileEvent> events;
+        track.Snapshot(events);
+        SELF_CHECK(ctx, events.size() == 15 && IsNumberedRun(events, 0, 15, 0));
+
+        RecordNumbered(track, 15);
+        events.clear();
+        track.Snapshot(events);
+        SELF_CHECK(ctx, events.size() == 15 && IsNumberedRun(events, 0, 15, 1));
+
+        for (uint64_t i = 16; i < 16 * 7 + 5; ++i)
+        {
+            RecordNumbered(track, i);
+        }
+        SELF_CHECK(ctx, track.GetWriteCount() == 16 * 7 + 5);
+        track.Snapshot(events);
+        SELF_CHECK(ctx, events.size() == 30);
+        SELF_CHECK(ctx, IsNumberedRun(events, 0, 15, 1));
+        SELF_CHECK(ctx, IsNumberedRun(events, 15, 15, 16 * 7 + 5 - 15));
+    }
+
+    // 并发快照：写者不停绕回，读者拿到的总是一段连续、完整的事件，
+    // 拷贝期间被覆盖（或正在被覆盖）的槽被丢掉而不是返回半新半旧的内容。
+    // 环不太小，拷贝占读者大部分时间，单核上写者被调度时读者也多半停在拷贝中间
+    {
+        const uint32_t capacity = 1024;
+        ProfileTrack track(3, "Track", capacity);
+        std::atomic<bool> stop{ false };
+        std::thread writer([&]
+        {
+            for (uint64_t i = 0; !stop.load(std::memory_order_relaxed); ++i)
+            {
+                RecordNumbered(track, i);
+            }
+        });
+
+        uint32_t snapshots = 0, broken = 0;
+        std::vector<ProfileEvent> events;
+        while (snapshots < 20000 || track.GetWriteCount() < capacity * 4)
+        {
+            events.clear();
+            const uint64_t before = track.GetWriteCount();
+            track.Snapshot(events);
+            const uint64_t after = track.GetWriteCount();
+            ++snapshots;
+            if (events.empty())
+            {
+                continue;
+            }
+            const uint64_t first = events[0].Start / 2;
+            const uint64_t last = first + events.size() - 1;
+            // 连续完整；丢弃只发生在最旧的一端，最新的一个不早于调用前的写计数，也不晚于返回后的
+            if (events.size() >= capacity || !IsNumberedRun(events, 0, events.size(), first) ||
+                last + 1 < before || last + 1 > after)
+            {
+                ++broken;
+            }
+        }
+        stop = true;
+        writer.join();
+        SELF_CHECK(ctx, broken == 0);
+        SELF_CHECK(ctx, track.GetWriteCount() >= capacity * 4);
+    }
+
+    // 命名轨道：同名返回同一条，导出时名字按 JSON 转义
+    {
+        FrameProfiler& profiler = FrameProfiler::Instance();
+        ProfileTrack& track = profiler.GetTrack("SelfTest \"GPU\"\\");
+        SELF_CHECK(ctx, &track == &profiler.GetTrack("SelfTest \"GPU\"\\"));
+        const uint64_t now = FrameProfiler::Now();
+        track.Record("SelfTestEvent", now, now + 1000);
+
+        std::string json;
+        profiler.WriteChromeTrace(json);
+        SELF_CHECK(ctx, json.find("\"SelfTest \\\"GPU\\\"\\\\\"") != std::string::npos);
+        SELF_CHECK(ctx, json.find("\"name\":\"SelfTestEvent\"") != std::string::npos);
+        SELF_CHECK(ctx, json.find("\"dur\":1.000") != std::string::npos);
+    }
+}
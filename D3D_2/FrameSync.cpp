@@ -0,0 +1,85 @@
+#include "FrameSync.h"
+
+// ============================================================================
+// 延迟释放队列
+// ============================================================================
+void DeferredReleaseQueue::Enqueue(uint64_t fenceValue, std::function<void()> release)
+{
+    m_entries.push_back({ fenceValue, std::move(release) });
+}
+
+size_t DeferredReleaseQueue::Collect(uint64_t completedValue)
+{
+    size_t count = 0;
+    while (!m_entries.empty() && m_entries.front().FenceValue <= completedValue)
+    {
+        // 先移出再执行，释放回调里再次入队也不会破坏迭代
+        std::function<void()> release = std::move(m_entries.front().Release);
+        m_entries.pop_front();
+        if (release)
+        {
+            release();
+        }
+        ++count;
+    }
+    return count;
+}
+
+size_t DeferredReleaseQueue::ReleaseAll()
+{
+    size_t count = 0;
+    while (!m_entries.empty())
+    {
+        std::function<void()> release = std::move(m_entries.front().Release);
+        m_entries.pop_front();
+        if (release)
+        {
+            release();
+        }
+        ++count;
+    }
+    return count;
+}
+
+// ============================================================================
+// 帧上下文环
+// ============================================================================
+FrameRing::FrameRing(IFence& fence, uint32_t frameCount)
+    : m_fence(fence)
+    , m_frameFenceValues(frameCount > 0 ? frameCount : 1, 0)
+{
+}
+
+uint32_t FrameRing::BeginFrame()
+{
+    m_frameIndex = (uint32_t)(m_frameSerial % m_frameFenceValues.size());
+
+    uint64_t pending = m_frameFenceValues[m_frameIndex];
+    if (pending != 0 && m_fence.GetCompletedValue() < pending)
+    {
+        ++m_stallCount;
+        m_fence.WaitForValue(pending);
+    }
+
+    m_releases.Collect(m_fence.GetCompletedValue());
+    return m_frameIndex;
+}
+
+uint64_t FrameRing::EndFrame()
+{
+    uint64_t value = m_fence.Signal();
+    m_frameFenceValues[m_frameIndex] = value;
+    ++m_frameSerial;
+    return value;
+}
+
+void FrameRing::DeferRelease(std::function<void()> release)
+{
+    m_releases.Enqueue(m_fence.GetLastSignaledValue() + 1, std::move(release));
+}
+
+void FrameRing::WaitIdle()
+{
+    m_fence.WaitForValue(m_fence.Signal());
+    m_releases.ReleaseAll();
+}
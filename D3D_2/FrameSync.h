@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+// 栅栏抽象：D3D12 实现见 D3D12Fence，也可以用模拟栅栏在没有 GPU 时驱动下面的逻辑
+class IFence
+{
+public:
+    virtual ~IFence() = default;
+
+    // 在队列上发出一个新的（单调递增的）栅栏值并返回
+    virtual uint64_t Signal() = 0;
+    // GPU 已完成的最大栅栏值
+    virtual uint64_t GetCompletedValue() const = 0;
+    // 阻塞直到 value 完成
+    virtual void WaitForValue(uint64_t value) = 0;
+    // 最近一次 Signal 返回的值
+    virtual uint64_t GetLastSignaledValue() const = 0;
+};
+
+// 延迟释放队列：资源在提交它最后一次使用之后的栅栏完成时才真正释放
+class DeferredReleaseQueue
+{
+public:
+    // 栅栏值必须单调不减（按提交顺序入队）
+    void Enqueue(uint64_t fenceValue, std::function<void()> release);
+
+    // 执行并移除所有 fenceValue <= completedValue 的释放，返回执行数
+    size_t Collect(uint64_t completedValue);
+
+    // 无条件执行全部释放（GPU 已空闲时调用）
+    size_t ReleaseAll();
+
+    size_t GetPendingCount() const { return m_entries.size(); }
+
+private:
+    struct Entry
+    {
+        uint64_t FenceValue;
+        std::function<void()> Release;
+    };
+
+    std::deque<Entry> m_entries;
+};
+
+// 帧上下文环：N 个帧槽轮流使用，每个槽记录上次提交时的栅栏值。
+// CPU 只有在要复用的槽仍被 GPU 占用（领先整整一圈）时才等待。
+class FrameRing
+{
+public:
+    FrameRing(IFence& fence, uint32_t frameCount);
+
+    // 开始新的一帧：等待本槽上次提交完成，回收已完成的延迟释放，返回槽下标
+    uint32_t BeginFrame();
+    // 本帧命令已提交：发出栅栏并记录到当前槽，返回栅栏值
+    uint64_t EndFrame();
+
+    // 把释放推迟到下一次 Signal 的栅栏完成之后
+    void DeferRelease(std::function<void()> release);
+
+    // 等 GPU 完成所有已提交的工作，并执行全部延迟释放
+    void WaitIdle();
+
+    uint32_t GetFrameCount() const { return (uint32_t)m_frameFenceValues.size(); }
+    uint32_t GetFrameIndex() const { return m_frameIndex; }
+    // 因领先 GPU 一整圈而在 BeginFrame 中等待的次数
+    uint64_t GetStallCount() const { return m_stallCount; }
+    size_t GetPendingReleaseCount() const { return m_releases.GetPendingCount(); }
+
+private:
+    IFence& m_fence;
+    std::vector<uint64_t> m_frameFenceValues;
+    uint32_t m_frameIndex = 0;
+    uint64_t m_frameSerial = 0;
+    uint64_t m_stallCount = 0;
+    DeferredReleaseQueue m_releases;
+};
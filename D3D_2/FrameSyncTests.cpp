@@ -0,0 +1,132 @@
+#include "SelfTest.h"
+#include "FrameSync.h"
+#include <random>
+
+// ============================================================================
+// DeferredReleaseQueue / FrameRing：模拟栅栏下的等待与延迟释放时机
+// ============================================================================
+namespace
+{
+    void TestDeferredReleaseQueue(SelfTestContext& ctx)
+    {
+        DeferredReleaseQueue queue;
+        std::vector<int> released;
+        queue.Enqueue(1, [&] { released.push_back(1); });
+        queue.Enqueue(2, [&] { released.push_back(2); });
+        queue.Enqueue(2, nullptr);
+        queue.Enqueue(4, [&] { released.push_back(4); });
+
+        SELF_CHECK(ctx, queue.Collect(0) == 0 && released.empty());
+        SELF_CHECK(ctx, queue.Collect(1) == 1 && released == std::vector<int>({ 1 }));
+        // 空回调也算一次释放
+        SELF_CHECK(ctx, queue.Collect(3) == 2 && released == std::vector<int>({ 1, 2 }));
+        SELF_CHECK(ctx, queue.GetPendingCount() == 1);
+
+        // 回调里再次入队：不破坏当前的回收，已完成的新条目同一次回收
+        queue.Enqueue(4, [&]
+        {
+            released.push_back(5);
+            queue.Enqueue(4, [&] { released.push_back(6); });
+            queue.Enqueue(9, [&] { released.push_back(9); });
+        });
+        SELF_CHECK(ctx, queue.Collect(4) == 3 && released == std::vector<int>({ 1, 2, 4, 5, 6 }));
+        SELF_CHECK(ctx, queue.GetPendingCount() == 1);
+        SELF_CHECK(ctx, queue.ReleaseAll() == 1 && released.back() == 9 && queue.GetPendingCount() == 0);
+    }
+
+    void TestFrameRingStalls(SelfTestContext& ctx)
+    {
+        // GPU 不前进：前 frameCount 帧不等待，之后每帧等最老的一帧
+        SimulatedFence fence;
+        FrameRing ring(fence, 3);
+        for (uint32_t f = 0; f < 3; ++f)
+        {
+            SELF_CHECK(ctx, ring.BeginFrame() == f);
+            SELF_CHECK(ctx, ring.EndFrame() == f + 1);
+        }
+        SELF_CHECK(ctx, ring.GetStallCount() == 0 && fence.GetCompletedValue() == 0);
+        SELF_CHECK(ctx, ring.BeginFrame() == 0);
+        SELF_CHECK(ctx, ring.GetStallCount() == 1 && fence.GetCompletedValue() == 1);
+        ring.EndFrame();
+
+        // GPU 每帧都跟上：不再等待
+        for (int f = 0; f < 10; ++f)
+        {
+            fence.Complete(fence.GetLastSignaledValue());
+            ring.BeginFrame();
+            ring.EndFrame();
+        }
+        SELF_CHECK(ctx, ring.GetStallCount() == 1 && fence.GetWaitCount() == 1);
+
+        // 延迟释放等到下一次 Signal 的栅栏完成
+        int released = 0;
+        ring.BeginFrame();
+        ring.DeferRelease([&] { ++released; });
+        const uint64_t value = ring.EndFrame();
+        fence.Complete(value - 1);
+        ring.BeginFrame();
+        SELF_CHECK(ctx, released == 0 && ring.GetPendingReleaseCount() == 1);
+        ring.EndFrame();
+        fence.Complete(value);
+        ring.BeginFrame();
+        SELF_CHECK(ctx, released == 1 && ring.GetPendingReleaseCount() == 0);
+        ring.EndFrame();
+
+        // WaitIdle 等全部完成并执行剩余释放
+        ring.DeferRelease([&] { ++released; });
+        ring.WaitIdle();
+        SELF_CHECK(ctx, released == 2 && fence.GetCompletedValue() == fence.GetLastSignaledValue());
+    }
+
+    // GPU 随机落后 0~4 帧：释放从不早于栅栏完成，只在领先整整一圈时等待
+    void TestFrameRingRandomLag(SelfTestContext& ctx)
+    {
+        std::mt19937 rng(7);
+        for (uint32_t frameCount : { 1u, 2u, 3u })
+        {
+            SimulatedFence fence;
+            FrameRing ring(fence, frameCount);
+            std::vector<uint64_t> releaseFence;
+            bool early = false;
+            uint64_t expectedStalls = 0;
+
+            for (int f = 0; f < 500; ++f)
+            {
+                const uint64_t lag = rng() % 5;
+                const uint64_t last = fence.GetLastSignaledValue();
+                fence.Complete(last > lag ? last - lag : 0);
+
+                // 要复用的槽上次提交的值 = 本帧之前第 frameCount 次 Signal
+                const uint64_t reused = last >= frameCount ? last - frameCount + 1 : 0;
+                if (reused != 0 && fence.GetCompletedValue() < reused)
+                {
+                    ++expectedStalls;
+                }
+                ring.BeginFrame();
+                SELF_CHECK(ctx, reused == 0 || fence.GetCompletedValue() >= reused);
+
+                for (uint32_t n = rng() % 3; n > 0; --n)
+                {
+                    const size_t index = releaseFence.size();
+                    releaseFence.push_back(fence.GetLastSignaledValue() + 1);
+                    ring.DeferRelease([&, index]
+                    {
+                        early |= fence.GetCompletedValue() < releaseFence[index];
+                    });
+                }
+                ring.EndFrame();
+            }
+            SELF_CHECK(ctx, !early);
+            SELF_CHECK(ctx, ring.GetStallCount() == expectedStalls);
+            ring.WaitIdle();
+            SELF_CHECK(ctx, ring.GetPendingReleaseCount() == 0);
+        }
+    }
+}
+
+void TestFrameSync(SelfTestContext& ctx)
+{
+    TestDeferredReleaseQueue(ctx);
+    TestFrameRingStalls(ctx);
+    TestFrameRingRandomLag(ctx);
+}
@@ -0,0 +1,197 @@
+#include "Frustum.h"
+
+using namespace DirectX;
+
+// ============================================================================
+// 从 view * proj 提取视锥平面
+// ============================================================================
+Frustum Frustum::FromViewProj(FXMMATRIX viewProj)
+{
+    // 行向量约定下 clip = v * M，平面来自 M 的列，转置后按行取即可
+    XMMATRIX m = XMMatrixTranspose(viewProj);
+
+    XMVECTOR planes[PlaneCount];
+    planes[Left] = m.r[3] + m.r[0];
+    planes[Right] = m.r[3] - m.r[0];
+    planes[Bottom] = m.r[3] + m.r[1];
+    planes[Top] = m.r[3] - m.r[1];
+    planes[Near] = m.r[2];              // D3D 深度范围 [0,1]
+    planes[Far] = m.r[3] - m.r[2];
+
+    Frustum f;
+    for (int i = 0; i < PlaneCount; ++i)
+    {
+        XMStoreFloat4(&f.Planes[i], XMPlaneNormalize(planes[i]));
+    }
+    return f;
+}
+
+// ============================================================================
+// 由角点射线构造子视锥（用于框选）
+// ============================================================================
+Frustum Frustum::FromCornerRays(const XMVECTOR origins[4], const XMVECTOR dirs[4], const Frustum& clip)
+{
+    // 矩形中心射线上的一点，用于确定侧平面朝向
+    XMVECTOR centerOrigin = (origins[0] + origins[1] + origins[2] + origins[3]) * 0.25f;
+    XMVECTOR centerDir = XMVector3Normalize(dirs[0] + dirs[1] + dirs[2] + dirs[3]);
+    XMVECTOR inner = XMVectorSetW(centerOrigin + centerDir * 10.0f, 1.0f);
+
+    // 左 = 左上/左下，右 = 右上/右下，下 = 左下/右下，上 = 左上/右上
+    const int edges[4][2] = { { 0, 3 }, { 1, 2 }, { 3, 2 }, { 0, 1 } };
+    const PlaneIndex sides[4] = { Left, Right, Bottom, Top };
+
+    Frustum f = clip;
+    for (int i = 0; i < 4; ++i)
+    {
+        XMVECTOR a = origins[edges[i][0]];
+        XMVECTOR b = origins[edges[i][1]];
+        XMVECTOR c = a + dirs[edges[i][0]];
+        if (XMVectorGetX(XMVector3LengthSq(b - a)) < 1e-12f)
+        {
+            b = a + dirs[edges[i][1]]; // 两射线同源（正交投影以外的退化情况）
+        }
+
+        XMVECTOR plane = XMPlaneFromPoints(a, b, c);
+        if (XMVectorGetX(XMPlaneDotCoord(plane, inner)) < 0.0f)
+        {
+            plane = -plane;
+        }
+        XMStoreFloat4(&f.Planes[sides[i]], plane);
+    }
+    return f;
+}
+
+bool Frustum::FromScreenRect(FXMMATRIX view, CXMMATRIX proj, int width, int height,
+    int x0, int y0, int x1, int y1, Frustum& out)
+{
+    const int left = (x0 < x1) ? x0 : x1;
+    const int right = (x0 < x1) ? x1 : x0;
+    const int top = (y0 < y1) ? y0 : y1;
+    const int bottom = (y0 < y1) ? y1 : y0;
+    if (right - left < 2 || bottom - top < 2)
+    {
+        return false;
+    }
+
+    // 左上、右上、右下、左下
+    XMVECTOR origins[4], dirs[4];
+    ScreenPointToRay(view, proj, width, height, left, top, origins[0], dirs[0]);
+    ScreenPointToRay(view, proj, width, height, right, top, origins[1], dirs[1]);
+    ScreenPointToRay(view, proj, width, height, right, bottom, origins[2], dirs[2]);
+    ScreenPointToRay(view, proj, width, height, left, bottom, origins[3], dirs[3]);
+    out = FromCornerRays(origins, dirs, FromViewProj(view * proj));
+    return true;
+}
+
+void ScreenPointToRay(FXMMATRIX view, CXMMATRIX proj, int width, int height,
+    int x, int y, XMVECTOR& origin, XMVECTOR& dir)
+{
+    // 屏幕 -> NDC
+    const float ndcX = (2.0f * x) / width - 1.0f;
+    const float ndcY = 1.0f - (2.0f * y) / height;
+
+    const XMMATRIX invProj = XMMatrixInverse(nullptr, proj);
+    const XMMATRIX invView = XMMatrixInverse(nullptr, view);
+
+    // 近裁面和远裁面上的点：NDC -> 视空间 -> 世界空间
+    XMVECTOR viewNear = XMVector4Transform(XMVectorSet(ndcX, ndcY, 0.0f, 1.0f), invProj);
+    XMVECTOR viewFar = XMVector4Transform(XMVectorSet(ndcX, ndcY, 1.0f, 1.0f), invProj);
+    viewNear = XMVectorScale(viewNear, 1.0f / XMVectorGetW(viewNear));
+    viewFar = XMVectorScale(viewFar, 1.0f / XMVectorGetW(viewFar));
+
+    const XMVECTOR worldNear = XMVectorSetW(XMVector4Transform(viewNear, invView), 1.0f);
+    const XMVECTOR worldFar = XMVectorSetW(XMVector4Transform(viewFar, invView), 1.0f);
+
+    origin = worldNear;
+    dir = XMVector3Normalize(worldFar - worldNear);
+}
+
+bool Frustum::IntersectsSphere(const XMFLOAT3& center, float radius) const
+{
+    XMVECTOR c = XMVectorSet(center.x, center.y, center.z, 1.0f);
+    for (int i = 0; i < PlaneCount; ++i)
+    {
+        XMVECTOR p = XMLoadFloat4(&Planes[i]);
+        if (XMVectorGetX(XMPlaneDotCoord(p, c)) < -radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+Frustum::Containment Frustum::ClassifyAABB(const XMFLOAT3& minP, const XMFLOAT3& maxP) const
+{
+    bool inside = true;
+    for (int i = 0; i < PlaneCount; ++i)
+    {
+        const XMFLOAT4& p = Planes[i];
+
+        // p-vertex：沿法线方向最远的角点；n-vertex：最近的角点
+        float px = (p.x >= 0.0f) ? maxP.x : minP.x;
+        float py = (p.y >= 0.0f) ? maxP.y : minP.y;
+        float pz = (p.z >= 0.0f) ? maxP.z : minP.z;
+        if (p.x * px + p.y * py + p.z * pz + p.w < 0.0f)
+        {
+            return Containment::Outside;
+        }
+
+        float nx = (p.x >= 0.0f) ? minP.x : maxP.x;
+        float ny = (p.y >= 0.0f) ? minP.y : maxP.y;
+        float nz = (p.z >= 0.0f) ? minP.z : maxP.z;
+        if (p.x * nx + p.y * ny + p.z * nz + p.w < 0.0f)
+        {
+            inside = false;
+        }
+    }
+    return inside ? Containment::Inside : Containment::Intersects;
+}
+
+// ============================================================================
+// 批量包围球测试（SIMD，4 路）
+// ============================================================================
+void Frustum::TestSpheres(const float* centerX, const float* centerY, const float* centerZ,
+    const float* radius, size_t count, uint64_t* outBits) const
+{
+    XMVECTOR px[PlaneCount], py[PlaneCount], pz[PlaneCount], pw[PlaneCount];
+    for (int p = 0; p < PlaneCount; ++p)
+    {
+        px[p] = XMVectorReplicate(Planes[p].x);
+        py[p] = XMVectorReplicate(Planes[p].y);
+        pz[p] = XMVectorReplicate(Planes[p].z);
+        pw[p] = XMVectorReplicate(Planes[p].w);
+    }
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        XMVECTOR x = XMVectorSet(centerX[i], centerX[i + 1], centerX[i + 2], centerX[i + 3]);
+        XMVECTOR y = XMVectorSet(centerY[i], centerY[i + 1], centerY[i + 2], centerY[i + 3]);
+        XMVECTOR z = XMVectorSet(centerZ[i], centerZ[i + 1], centerZ[i + 2], centerZ[i + 3]);
+        XMVECTOR negR = XMVectorNegate(XMVectorSet(radius[i], radius[i + 1], radius[i + 2], radius[i + 3]));
+
+        XMVECTOR inside = XMVectorTrueInt();
+        for (int p = 0; p < PlaneCount; ++p)
+        {
+            XMVECTOR dist = XMVectorMultiplyAdd(x, px[p],
+                XMVectorMultiplyAdd(y, py[p],
+                    XMVectorMultiplyAdd(z, pz[p], pw[p])));
+            inside = XMVectorAndInt(inside, XMVectorGreaterOrEqual(dist, negR));
+        }
+
+        uint32_t mask[4];
+        XMStoreInt4(mask, inside);
+        uint64_t bits = (mask[0] ? 1ull : 0ull) | (mask[1] ? 2ull : 0ull)
+            | (mask[2] ? 4ull : 0ull) | (mask[3] ? 8ull : 0ull);
+        outBits[i >> 6] |= bits << (i & 63);
+    }
+
+    // 尾部逐个处理
+    for (; i < count; ++i)
+    {
+        if (IntersectsSphere(XMFLOAT3(centerX[i], centerY[i], centerZ[i]), radius[i]))
+        {
+            outBits[i >> 6] |= 1ull << (i & 63);
+        }
+    }
+}
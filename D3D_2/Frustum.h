@@ -0,0 +1,57 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+
+// 视锥体：6 个平面，法线指向内侧（dot(n, p) + d >= 0 为内侧）
+struct Frustum
+{
+    enum PlaneIndex
+    {
+        Left = 0,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        PlaneCount
+    };
+
+    enum class Containment
+    {
+        Outside,
+        Intersects,
+        Inside
+    };
+
+    DirectX::XMFLOAT4 Planes[PlaneCount];
+
+    // 从 view * proj 矩阵提取平面（D3D 约定：行向量，z ∈ [0,1]）
+    static Frustum FromViewProj(DirectX::FXMMATRIX viewProj);
+
+    // 由四条角点射线（左上、右上、右下、左下）构造子视锥，近/远平面取自 clip
+    static Frustum FromCornerRays(const DirectX::XMVECTOR origins[4],
+        const DirectX::XMVECTOR dirs[4],
+        const Frustum& clip);
+
+    // 框选：屏幕矩形（两角顺序任意）的子视锥，近/远平面沿用相机视锥。
+    // 宽或高不足 2 像素时视为取消选择，返回 false
+    static bool FromScreenRect(DirectX::FXMMATRIX view, DirectX::CXMMATRIX proj, int width, int height,
+        int x0, int y0, int x1, int y1, Frustum& out);
+
+    // 包围球测试
+    bool IntersectsSphere(const DirectX::XMFLOAT3& center, float radius) const;
+
+    // AABB 测试（用于网格单元整体剔除）
+    Containment ClassifyAABB(const DirectX::XMFLOAT3& minP, const DirectX::XMFLOAT3& maxP) const;
+
+    // 批量包围球测试（SoA 布局，每次 4 个）：第 i 个球可见则置 outBits 第 i 位。
+    // outBits 至少 (count + 63) / 64 个字，调用前需清零。
+    void TestSpheres(const float* centerX, const float* centerY, const float* centerZ,
+        const float* radius, size_t count, uint64_t* outBits) const;
+};
+
+// 屏幕像素 (x, y) 对应的世界空间射线：起点在近裁面上，方向已归一化
+void ScreenPointToRay(DirectX::FXMMATRIX view, DirectX::CXMMATRIX proj, int width, int height,
+    int x, int y, DirectX::XMVECTOR& origin, DirectX::XMVECTOR& dir);
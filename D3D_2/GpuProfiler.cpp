@@ -0,0 +1,142 @@
+#include "GpuProfiler.h"
+#include <cstring>
+
+namespace
+{
+    // GPU 与 CPU 时钟会慢慢漂移，隔一段时间重新校准
+    const uint32_t CalibrationInterval = 120;
+}
+
+bool GpuProfiler::Initialize(IGraphicsBackend& backend, uint32_t frameCount)
+{
+    m_backend = nullptr;
+    m_frequency = backend.GetTimestampFrequency();
+    if (m_frequency == 0 || !backend.CreateTimestampQueries(frameCount * MaxScopesPerFrame * 2))
+    {
+        return false;
+    }
+
+    m_backend = &backend;
+    m_track = &FrameProfiler::Instance().GetTrack("GPU");
+    m_slots.assign(frameCount, FrameSlot{});
+    m_readback.resize(MaxScopesPerFrame * 2);
+    Calibrate();
+    return true;
+}
+
+void GpuProfiler::Calibrate()
+{
+    uint64_t gpu = 0, cpu = 0;
+    if (m_backend->GetTimestampCalibration(gpu, cpu))
+    {
+        m_calibrationGpu = gpu;
+        m_calibrationCpu = FrameProfiler::FromSteadyNanoseconds(cpu);
+    }
+    m_framesSinceCalibration = 0;
+}
+
+void GpuProfiler::BeginFrame(uint32_t frameIndex)
+{
+    if (!m_backend)
+    {
+        return;
+    }
+
+    m_frameIndex = frameIndex;
+    FrameSlot& slot = m_slots[frameIndex];
+    if (slot.Resolved && !slot.Names.empty())
+    {
+        if (++m_framesSinceCalibration >= CalibrationInterval)
+        {
+            Calibrate();
+        }
+
+        const uint32_t queryCount = (uint32_t)slot.Names.size() * 2;
+        const uint32_t base = frameIndex * MaxScopesPerFrame * 2;
+        if (m_backend->ReadTimestamps(base, queryCount, m_readback.data()))
+        {
+            m_lastResults.clear();
+            const double nsPerTick = 1e9 / (double)m_frequency;
+            for (size_t i = 0; i < slot.Names.size(); ++i)
+            {
+                const uint64_t begin = m_readback[i * 2];
+                const uint64_t end = m_readback[i * 2 + 1];
+                if (end < begin)
+                {
+                    continue; // 未写入结束时间戳（EndScope 漏调）
+                }
+
+                ProfileEvent event;
+                event.Name = slot.Names[i];
+                // 校准点之前的时间戳差为负
+                const double offset = (double)(int64_t)(begin - m_calibrationGpu) * nsPerTick;
+                event.Start = (uint64_t)((int64_t)m_calibrationCpu + (int64_t)offset);
+                event.End = event.Start + (uint64_t)((double)(end - begin) * nsPerTick);
+                m_lastResults.push_back(event);
+                m_track->Record(event.Name, event.Start, event.End);
+            }
+        }
+    }
+
+    slot.Names.clear();
+    slot.Resolved = false;
+}
+
+uint32_t GpuProfiler::BeginScope(IGraphicsCommandList& list, const char* name)
+{
+    if (!m_backend)
+    {
+        return InvalidScope;
+    }
+
+    FrameSlot& slot = m_slots[m_frameIndex];
+    if (slot.Names.size() >= MaxScopesPerFrame)
+    {
+        return InvalidScope;
+    }
+
+    const uint32_t scope = (uint32_t)slot.Names.size();
+    slot.Names.push_back(name);
+    const uint32_t base = m_frameIndex * MaxScopesPerFrame * 2;
+    list.WriteTimestamp(base + scope * 2);
+    return scope;
+}
+
+void GpuProfiler::EndScope(IGraphicsCommandList& list, uint32_t scope)
+{
+    if (!m_backend || scope == InvalidScope)
+    {
+        return;
+    }
+
+    const uint32_t base = m_frameIndex * MaxScopesPerFrame * 2;
+    list.WriteTimestamp(base + scope * 2 + 1);
+}
+
+void GpuProfiler::EndFrame(IGraphicsCommandList& list)
+{
+    if (!m_backend)
+    {
+        return;
+    }
+
+    FrameSlot& slot = m_slots[m_frameIndex];
+    if (!slot.Names.empty())
+    {
+        const uint32_t base = m_frameIndex * MaxScopesPerFrame * 2;
+        list.ResolveTimestamps(base, (uint32_t)slot.Names.size() * 2);
+        slot.Resolved = true;
+    }
+}
+
+double GpuProfiler::GetLastMilliseconds(const char* name) const
+{
+    for (const ProfileEvent& event : m_lastResults)
+    {
+        if (strcmp(event.Name, name) == 0)
+        {
+            return (double)(event.End - event.Start) / 1e6;
+        }
+    }
+    return 0.0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "GraphicsBackend.h"
+#include "FrameProfiler.h"
+
+// GPU 作用域计时：在命令列表里成对写时间戳，帧上下文的栅栏完成后读回，
+// 换算到 FrameProfiler 的时间轴写进 "GPU" 轨道。
+// 每个帧上下文占一段查询槽，BeginFrame(f) 时该槽上一轮的结果已经可读（由 FrameRing 保证）。
+// 只在渲染线程使用
+class GpuProfiler
+{
+public:
+    static const uint32_t MaxScopesPerFrame = 32;
+    static const uint32_t InvalidScope = UINT32_MAX;
+
+    // 结果为空（不可用）时各调用都直接返回
+    bool Initialize(IGraphicsBackend& backend, uint32_t frameCount);
+
+    // 帧上下文 frameIndex 开始录制前：读回该槽上一轮的时间戳
+    void BeginFrame(uint32_t frameIndex);
+    // 作用域可以跨命令列表（开头和结尾写在不同的列表里），只要提交顺序与时间顺序一致
+    uint32_t BeginScope(IGraphicsCommandList& list, const char* name);
+    void EndScope(IGraphicsCommandList& list, uint32_t scope);
+    // 录在本帧最后提交的列表末尾：把本帧用到的查询拷进回读缓冲
+    void EndFrame(IGraphicsCommandList& list);
+
+    // 最近一次读回的各作用域（FrameProfiler 时间轴的纳秒）
+    const std::vector<ProfileEvent>& GetLastResults() const { return m_lastResults; }
+    // 最近一次读回中名为 name 的作用域的耗时（毫秒），没有时返回 0
+    double GetLastMilliseconds(const char* name) const;
+
+private:
+    void Calibrate();
+
+private:
+    struct FrameSlot
+    {
+        std::vector<const char*> Names;     // 第 i 个作用域占查询 2i、2i+1
+        bool Resolved = false;
+    };
+
+    IGraphicsBackend* m_backend = nullptr;
+    ProfileTrack* m_track = nullptr;
+    std::vector<FrameSlot> m_slots;
+    uint32_t m_frameIndex = 0;
+
+    uint64_t m_frequency = 0;
+    uint64_t m_calibrationGpu = 0;
+    uint64_t m_calibrationCpu = 0;          // FrameProfiler 时间轴
+    uint32_t m_framesSinceCalibration = 0;
+
+    std::vector<uint64_t> m_readback;
+    std::vector<ProfileEvent> m_lastResults;
+};
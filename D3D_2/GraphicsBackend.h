@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "RenderGraph.h"
+
+class IFence;
+class IUploadPageSource;
+class IDescriptorHeapSource;
+struct DescriptorHeapPage;
+
+// 后端对象句柄：由后端解释（D3D12 实现中是 ID3D12PipelineState* / ID3D12RootSignature* / ID3D12Resource*），
+// 录制后端只把它当作编号记下来
+typedef uint64_t GpuHandle;
+const GpuHandle NullGpuHandle = 0;
+
+inline GpuHandle ToGpuHandle(const void* object) { return (GpuHandle)(uintptr_t)object; }
+
+struct GpuViewport
+{
+    float X = 0.0f;
+    float Y = 0.0f;
+    float Width = 0.0f;
+    float Height = 0.0f;
+    float MinDepth = 0.0f;
+    float MaxDepth = 1.0f;
+};
+
+struct GpuRect
+{
+    int32_t Left = 0;
+    int32_t Top = 0;
+    int32_t Right = 0;
+    int32_t Bottom = 0;
+};
+
+struct GpuVertexBufferView
+{
+    uint64_t Address = 0;
+    uint32_t SizeInBytes = 0;
+    uint32_t StrideInBytes = 0;
+};
+
+struct GpuIndexBufferView
+{
+    uint64_t Address = 0;
+    uint32_t SizeInBytes = 0;
+    uint32_t IndexSize = 2;         // 2 或 4 字节
+};
+
+enum class GpuTopology : uint32_t
+{
+    TriangleList
+};
+
+enum class GpuMemory : uint32_t
+{
+    Default,                        // GPU 专用
+    Upload                          // CPU 可写、GPU 可读，创建后一直映射
+};
+
+struct GpuBuffer
+{
+    GpuHandle Handle = NullGpuHandle;
+    uint64_t Address = 0;           // GPU 虚拟地址
+    uint64_t Size = 0;
+    uint8_t* Cpu = nullptr;         // 仅 Upload 内存
+};
+
+// 命令列表：D3DManager 与 PrimitiveShape 的帧路径只通过它录制命令。
+// 同时是渲染图的屏障提交端，graph.Execute(list) 把屏障直接写进这条列表。
+// 一条列表同一时间只能由一个线程录制；不同列表可以并发录制。
+class IGraphicsCommandList : public IRenderGraphBarrierSink
+{
+public:
+    // 开始录制：allocator 选择列表自己的第几个命令分配器（调用者保证 GPU 已用完它），
+    // pipeline 为初始管线（可为空）
+    virtual void Begin(uint32_t allocator, GpuHandle pipeline) = 0;
+    virtual void End() = 0;
+
+    virtual void SetViewport(const GpuViewport& viewport) = 0;
+    virtual void SetScissorRect(const GpuRect& rect) = 0;
+    // rtv/dsv 为 CPU 描述符句柄
+    virtual void SetRenderTarget(uint64_t rtv, uint64_t dsv) = 0;
+    virtual void ClearRenderTarget(uint64_t rtv, const float color[4]) = 0;
+    virtual void ClearDepthStencil(uint64_t dsv, float depth, uint8_t stencil) = 0;
+
+    virtual void SetRootSignature(GpuHandle rootSignature) = 0;
+    virtual void SetDescriptorHeap(const DescriptorHeapPage& heap) = 0;
+    virtual void SetPipelineState(GpuHandle pipeline) = 0;
+    virtual void SetRootConstant(uint32_t parameter, uint32_t value) = 0;
+    virtual void SetRootConstantBuffer(uint32_t parameter, uint64_t address) = 0;
+    virtual void SetRootShaderResource(uint32_t parameter, uint64_t address) = 0;
+    // gpuDescriptor 为着色器可见堆中的 GPU 描述符句柄
+    virtual void SetRootDescriptorTable(uint32_t parameter, uint64_t gpuDescriptor) = 0;
+
+    virtual void SetVertexBuffer(const GpuVertexBufferView& view) = 0;
+    virtual void SetIndexBuffer(const GpuIndexBufferView& view) = 0;
+    virtual void SetPrimitiveTopology(GpuTopology topology) = 0;
+    virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount,
+        uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) = 0;
+
+    virtual void CopyBuffer(const GpuBuffer& dst, uint64_t dstOffset,
+        const GpuBuffer& src, uint64_t srcOffset, uint64_t size) = 0;
+
+    // GPU 执行到此处时把时间戳写进后端查询槽 query（见 IGraphicsBackend::CreateTimestampQueries）
+    virtual void WriteTimestamp(uint32_t query) = 0;
+    // 把 [first, first + count) 的时间戳拷进回读缓冲，GPU 完成后可用 ReadTimestamps 读取
+    virtual void ResolveTimestamps(uint32_t first, uint32_t count) = 0;
+};
+
+// 图形后端：设备与队列上帧路径用到的那部分。
+// D3D12 实现见 D3D12GraphicsBackend；NullGraphicsBackend 不碰 GPU，只把命令录成紧凑的命令流并计数，
+// 用于单独测量 CPU 端的帧开销、在没有 GPU 的机器上跑完整的帧循环
+class IGraphicsBackend
+{
+public:
+    virtual ~IGraphicsBackend() = default;
+
+    // 列表由后端持有，生命周期与后端相同；allocatorCount 为 Begin 可选的分配器数（通常等于帧上下文数）
+    virtual IGraphicsCommandList* CreateCommandList(uint32_t allocatorCount) = 0;
+
+    virtual bool CreateBuffer(uint64_t size, GpuMemory memory, GpuBuffer& out) = 0;
+    virtual void DestroyBuffer(const GpuBuffer& buffer) = 0;
+
+    // 按顺序提交已 End 的列表
+    virtual void Submit(IGraphicsCommandList* const* lists, uint32_t count) = 0;
+    virtual void Present() = 0;
+
+    // 帧路径上其余与设备相关的部分
+    virtual IFence& GetFence() = 0;
+    virtual IUploadPageSource& GetUploadPageSource() = 0;
+    virtual IDescriptorHeapSource& GetDescriptorHeapSource() = 0;
+
+    // 时间戳查询：创建 count 个槽（只调用一次），失败时 GPU 计时不可用
+    virtual bool CreateTimestampQueries(uint32_t count) = 0;
+    // 读取已 Resolve 且 GPU 已执行完的时间戳（GPU 时钟刻度）
+    virtual bool ReadTimestamps(uint32_t first, uint32_t count, uint64_t* out) = 0;
+    // GPU 时钟每秒刻度数
+    virtual uint64_t GetTimestampFrequency() = 0;
+    // 同一时刻的 GPU 时间戳与 steady_clock 纳秒，用于把 GPU 时间换到 CPU 时间轴
+    virtual bool GetTimestampCalibration(uint64_t& gpuTimestamp, uint64_t& cpuNanoseconds) = 0;
+};
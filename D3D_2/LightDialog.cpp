@@ -73,13 +73,13 @@ namespace
                     !TryGetDlgItemFloat(hDlg, IDC_LIGHT_SPECULAR, settings->Specular) ||
                     !TryGetDlgItemFloat(hDlg, IDC_LIGHT_SHININESS, settings->Shininess))
                 {
-                    MessageBoxW(hDlg, L"Ч֡", L"", MB_OK | MB_ICONWARNING);
+                    MessageBoxW(hDlg, L"请输入有效数字。", L"输入错误", MB_OK | MB_ICONWARNING);
                     return TRUE;
                 }
 
                 if (settings->Shininess < 1.0f)
                 {
-                    MessageBoxW(hDlg, L"߹ָ >= 1", L"", MB_OK | MB_ICONWARNING);
+                    MessageBoxW(hDlg, L"高光指数建议 >= 1。", L"输入错误", MB_OK | MB_ICONWARNING);
                     return TRUE;
                 }
 
@@ -0,0 +1,302 @@
+#include "MipGenerator.h"
+#include <DirectXMath.h>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+    // 线性值 -> sRGB 编码的查表精度（线性 [0, 1] 分成这么多段，暗部误差也在 0.5 级以内）
+    const uint32_t LinearSteps = 16384;
+
+    // 编码值 <-> 线性值的查找表，sRGB 与线性（直接按 /255）各一套
+    struct ColorTables
+    {
+        float ToLinear[256];
+        uint8_t FromLinear[LinearSteps + 1];
+    };
+
+    float SrgbToLinear(float c)
+    {
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float LinearToSrgb(float c)
+    {
+        return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    }
+
+    ColorTables BuildTables(bool srgb)
+    {
+        ColorTables tables;
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            const float c = (float)i / 255.0f;
+            tables.ToLinear[i] = srgb ? SrgbToLinear(c) : c;
+        }
+        for (uint32_t i = 0; i <= LinearSteps; ++i)
+        {
+            const float c = (float)i / (float)LinearSteps;
+            const float encoded = srgb ? LinearToSrgb(c) : c;
+            tables.FromLinear[i] = (uint8_t)(encoded * 255.0f + 0.5f);
+        }
+        return tables;
+    }
+
+    const ColorTables& GetTables(bool srgb)
+    {
+        static const ColorTables srgbTables = BuildTables(true);
+        static const ColorTables linearTables = BuildTables(false);
+        return srgb ? srgbTables : linearTables;
+    }
+
+    // 一个方向上每个目标像素的源像素区间与权重（已归一化，越界的采样夹到边缘像素）
+    struct FilterTap
+    {
+        uint32_t First = 0;
+        uint32_t Count = 0;
+        uint32_t WeightOffset = 0;
+    };
+
+    struct FilterTable
+    {
+        std::vector<FilterTap> Taps;
+        std::vector<float> Weights;
+        uint32_t MaxCount = 0;
+    };
+
+    const double KaiserRadius = 3.0;   // 目标像素为单位
+    const double KaiserBeta = 4.0;
+
+    // 第一类零阶修正贝塞尔函数（级数展开）
+    double BesselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        const double halfSq = x * x * 0.25;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= halfSq / ((double)k * k);
+            sum += term;
+            if (term < sum * 1e-12)
+            {
+                break;
+            }
+        }
+        return sum;
+    }
+
+    double KaiserSinc(double t)
+    {
+        const double r = t / KaiserRadius;
+        if (r <= -1.0 || r >= 1.0)
+        {
+            return 0.0;
+        }
+        const double window = BesselI0(KaiserBeta * std::sqrt(1.0 - r * r)) / BesselI0(KaiserBeta);
+        const double x = 3.14159265358979323846 * t;
+        const double sinc = std::fabs(t) < 1e-9 ? 1.0 : std::sin(x) / x;
+        return sinc * window;
+    }
+
+    void BuildFilterTable(uint32_t srcSize, uint32_t dstSize, MipFilter filter, FilterTable& table)
+    {
+        table.Taps.resize(dstSize);
+        table.Weights.clear();
+        table.MaxCount = 0;
+
+        const double scale = (double)srcSize / (double)dstSize;
+        std::vector<double> weights(srcSize + 1);
+        for (uint32_t i = 0; i < dstSize; ++i)
+        {
+            // 源像素 j 覆盖 [j, j + 1)，目标像素 i 对应源区间 [i * scale, (i + 1) * scale)
+            int64_t first = 0, last = -1;
+            if (filter == MipFilter::Box || srcSize == dstSize)
+            {
+                const double x0 = i * scale, x1 = (i + 1) * scale;
+                first = (int64_t)std::floor(x0);
+                last = (int64_t)std::ceil(x1) - 1;
+                for (int64_t j = first; j <= last; ++j)
+                {
+                    weights[(size_t)(j - first)] = std::fmin((double)j + 1.0, x1) - std::fmax((double)j, x0);
+                }
+            }
+            else
+            {
+                const double center = (i + 0.5) * scale;
+                const double radius = KaiserRadius * scale;
+                first = (int64_t)std::floor(center - radius);
+                last = (int64_t)std::ceil(center + radius);
+                weights.resize((size_t)(last - first + 1));
+                for (int64_t j = first; j <= last; ++j)
+                {
+                    weights[(size_t)(j - first)] = KaiserSinc(((double)j + 0.5 - center) / scale);
+                }
+            }
+
+            // 越界的采样夹到边缘像素，然后归一化
+            const int64_t clampedFirst = first < 0 ? 0 : first;
+            const int64_t clampedLast = last >= (int64_t)srcSize ? (int64_t)srcSize - 1 : last;
+            FilterTap& tap = table.Taps[i];
+            tap.First = (uint32_t)clampedFirst;
+            tap.Count = (uint32_t)(clampedLast - clampedFirst + 1);
+            tap.WeightOffset = (uint32_t)table.Weights.size();
+            table.Weights.resize(table.Weights.size() + tap.Count, 0.0f);
+
+            double sum = 0.0;
+            for (int64_t j = first; j <= last; ++j)
+            {
+                sum += weights[(size_t)(j - first)];
+            }
+            for (int64_t j = first; j <= last; ++j)
+            {
+                const int64_t clamped = j < clampedFirst ? clampedFirst : (j > clampedLast ? clampedLast : j);
+                table.Weights[tap.WeightOffset + (size_t)(clamped - clampedFirst)] +=
+                    (float)(weights[(size_t)(j - first)] / sum);
+            }
+            table.MaxCount = tap.Count > table.MaxCount ? tap.Count : table.MaxCount;
+        }
+    }
+
+    // 一行源像素解码为线性值
+    void LoadRow(const uint8_t* src, uint32_t width, const ColorTables& tables, XMVECTOR* out)
+    {
+        const float alphaScale = 1.0f / 255.0f;
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            const uint8_t* p = src + (size_t)x * 4;
+            out[x] = XMVectorSet(tables.ToLinear[p[0]], tables.ToLinear[p[1]], tables.ToLinear[p[2]], p[3] * alphaScale);
+        }
+    }
+
+    void FilterRow(const XMVECTOR* src, const FilterTable& table, XMVECTOR* out)
+    {
+        const size_t count = table.Taps.size();
+        for (size_t x = 0; x < count; ++x)
+        {
+            const FilterTap& tap = table.Taps[x];
+            const float* weights = &table.Weights[tap.WeightOffset];
+            const XMVECTOR* taps = src + tap.First;
+            XMVECTOR sum = XMVectorZero();
+            for (uint32_t k = 0; k < tap.Count; ++k)
+            {
+                sum = XMVectorMultiplyAdd(XMVectorReplicate(weights[k]), taps[k], sum);
+            }
+            out[x] = sum;
+        }
+    }
+
+    void StoreRow(const XMVECTOR* row, uint32_t width, const ColorTables& tables, uint8_t* dst)
+    {
+        const XMVECTOR scale = XMVectorSet((float)LinearSteps, (float)LinearSteps, (float)LinearSteps, 255.0f);
+        const XMVECTOR half = XMVectorReplicate(0.5f);
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            // Kaiser 的负瓣可能越出 [0, 1]
+            XMFLOAT4 v;
+            XMStoreFloat4(&v, XMVectorMultiplyAdd(XMVectorSaturate(row[x]), scale, half));
+            uint8_t* p = dst + (size_t)x * 4;
+            p[0] = tables.FromLinear[(uint32_t)v.x];
+            p[1] = tables.FromLinear[(uint32_t)v.y];
+            p[2] = tables.FromLinear[(uint32_t)v.z];
+            p[3] = (uint8_t)v.w;
+        }
+    }
+}
+
+uint32_t GetMipLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t size = width > height ? width : height;
+    uint32_t levels = 1;
+    while (size > 1)
+    {
+        size >>= 1;
+        ++levels;
+    }
+    return levels;
+}
+
+// ============================================================================
+// 降采样：可分离滤波，先横向再纵向
+// ============================================================================
+void GenerateMipLevel(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight,
+    uint8_t* dst, uint32_t dstWidth, uint32_t dstHeight, const MipSettings& settings)
+{
+    const ColorTables& tables = GetTables(settings.SrgbColor);
+
+    FilterTable horizontal, vertical;
+    BuildFilterTable(srcWidth, dstWidth, settings.Filter, horizontal);
+    BuildFilterTable(srcHeight, dstHeight, settings.Filter, vertical);
+
+    // 横向滤波后的源行放在环里：目标行向下推进时需要的源行区间单调后移，
+    // 环的大小不小于纵向最大采样数即可保证窗口内的行都在
+    const uint32_t ringSize = vertical.MaxCount;
+    std::vector<XMVECTOR> ring((size_t)ringSize * dstWidth);
+    std::vector<int64_t> ringRows(ringSize, -1);
+    std::vector<XMVECTOR> linearRow(srcWidth);
+    std::vector<XMVECTOR> outRow(dstWidth);
+
+    for (uint32_t y = 0; y < dstHeight; ++y)
+    {
+        const FilterTap& tap = vertical.Taps[y];
+        const float* weights = &vertical.Weights[tap.WeightOffset];
+
+        for (uint32_t x = 0; x < dstWidth; ++x)
+        {
+            outRow[x] = XMVectorZero();
+        }
+
+        for (uint32_t k = 0; k < tap.Count; ++k)
+        {
+            const uint32_t row = tap.First + k;
+            const uint32_t slot = row % ringSize;
+            XMVECTOR* filtered = &ring[(size_t)slot * dstWidth];
+            if (ringRows[slot] != (int64_t)row)
+            {
+                LoadRow(src + (size_t)row * srcWidth * 4, srcWidth, tables, linearRow.data());
+                FilterRow(linearRow.data(), horizontal, filtered);
+                ringRows[slot] = row;
+            }
+
+            const XMVECTOR weight = XMVectorReplicate(weights[k]);
+            for (uint32_t x = 0; x < dstWidth; ++x)
+            {
+                outRow[x] = XMVectorMultiplyAdd(weight, filtered[x], outRow[x]);
+            }
+        }
+
+        StoreRow(outRow.data(), dstWidth, tables, dst + (size_t)y * dstWidth * 4);
+    }
+}
+
+void GenerateMipChain(std::vector<uint8_t>& pixels, uint32_t width, uint32_t height,
+    const MipSettings& settings, std::vector<MipLevel>& levels)
+{
+    uint32_t levelCount = GetMipLevelCount(width, height);
+    if (settings.MaxLevels != 0 && settings.MaxLevels < levelCount)
+    {
+        levelCount = settings.MaxLevels;
+    }
+
+    // 先算出各级位置，一次分配，再逐级从上一级降采样
+    levels.resize(levelCount);
+    size_t offset = 0;
+    uint32_t w = width, h = height;
+    for (uint32_t i = 0; i < levelCount; ++i)
+    {
+        levels[i].Width = w;
+        levels[i].Height = h;
+        levels[i].Offset = offset;
+        offset += (size_t)w * h * 4;
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+    }
+    pixels.resize(offset);
+
+    for (uint32_t i = 1; i < levelCount; ++i)
+    {
+        const MipLevel& src = levels[i - 1];
+        const MipLevel& dst = levels[i];
+        GenerateMipLevel(pixels.data() + src.Offset, src.Width, src.Height,
+            pixels.data() + dst.Offset, dst.Width, dst.Height, settings);
+    }
+}
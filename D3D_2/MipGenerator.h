@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 降采样滤波器
+enum class MipFilter : uint32_t
+{
+    Box,        // 按覆盖面积加权，非 2 的幂尺寸时落在半个像素上的源像素按比例计入
+    Kaiser      // Kaiser 窗 sinc，半径 3 个目标像素：更锐利、混叠更少，代价是更多的采样
+};
+
+struct MipSettings
+{
+    MipFilter Filter = MipFilter::Kaiser;
+    bool SrgbColor = true;      // RGB 按 sRGB 编码处理：先转线性再滤波，结果再编码回 sRGB；A 始终线性
+    uint32_t MaxLevels = 0;     // 0 表示完整的链（直到 1x1）
+};
+
+// 一级 mip 在像素缓冲中的位置（RGBA8，行紧密排列）
+struct MipLevel
+{
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    size_t Offset = 0;
+};
+
+// 完整 mip 链的级数：1 + floor(log2(max(width, height)))
+uint32_t GetMipLevelCount(uint32_t width, uint32_t height);
+
+// 从 src 降采样出 dst（RGBA8），尺寸任意（下一级为 max(1, size / 2)，与 D3D 一致）
+void GenerateMipLevel(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight,
+    uint8_t* dst, uint32_t dstWidth, uint32_t dstHeight, const MipSettings& settings);
+
+// pixels 开头是第 0 级（width x height RGBA8），在其后追加其余各级，levels 为每一级的位置。
+// 每一级由上一级降采样得到
+void GenerateMipChain(std::vector<uint8_t>& pixels, uint32_t width, uint32_t height,
+    const MipSettings& settings, std::vector<MipLevel>& levels);
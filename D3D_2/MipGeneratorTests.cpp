@@ -0,0 +1,201 @@
+#include "SelfTest.h"
+#include "MipGenerator.h"
+#include <cmath>
+#include <cstdlib>
+
+// ============================================================================
+// MipGenerator：常量图像精确、棋盘格在线性空间平均、Box 与双精度参考一致
+// ============================================================================
+namespace
+{
+    double SrgbToLinear(double c)
+    {
+        return c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+    }
+
+    double LinearToSrgb(double c)
+    {
+        return c <= 0.0031308 ? c * 12.92 : 1.055 * std::pow(c, 1.0 / 2.4) - 0.055;
+    }
+
+    // 固定种子的伪随机像素，与平台的 rand 无关
+    void FillNoise(std::vector<uint8_t>& pixels, uint32_t seed)
+    {
+        for (uint8_t& c : pixels)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            c = (uint8_t)(seed >> 24);
+        }
+    }
+
+    // 按覆盖面积加权的双精度参考：RGB 在线性空间平均（srgb 时），A 始终线性
+    int MaxBoxError(const std::vector<uint8_t>& src, uint32_t w, uint32_t h,
+        const std::vector<uint8_t>& dst, uint32_t dw, uint32_t dh, bool srgb)
+    {
+        const double sx = (double)w / dw;
+        const double sy = (double)h / dh;
+        int maxError = 0;
+        for (uint32_t y = 0; y < dh; ++y)
+        {
+            for (uint32_t x = 0; x < dw; ++x)
+            {
+                for (int c = 0; c < 4; ++c)
+                {
+                    const bool linearize = srgb && c < 3;
+                    double sum = 0.0, weight = 0.0;
+                    for (uint32_t j = 0; j < h; ++j)
+                    {
+                        const double oy = std::fmin(j + 1.0, (y + 1) * sy) - std::fmax((double)j, y * sy);
+                        if (oy <= 0.0)
+                        {
+                            continue;
+                        }
+                        for (uint32_t i = 0; i < w; ++i)
+                        {
+                            const double ox = std::fmin(i + 1.0, (x + 1) * sx) - std::fmax((double)i, x * sx);
+                            if (ox <= 0.0)
+                            {
+                                continue;
+                            }
+                            double v = src[((size_t)j * w + i) * 4 + c] / 255.0;
+                            sum += (linearize ? SrgbToLinear(v) : v) * ox * oy;
+                            weight += ox * oy;
+                        }
+                    }
+                    double r = sum / weight;
+                    if (linearize)
+                    {
+                        r = LinearToSrgb(r);
+                    }
+                    const int expected = (int)(r * 255.0 + 0.5);
+                    const int error = std::abs(expected - (int)dst[((size_t)y * dw + x) * 4 + c]);
+                    maxError = error > maxError ? error : maxError;
+                }
+            }
+        }
+        return maxError;
+    }
+}
+
+void TestMipGenerator(SelfTestContext& ctx)
+{
+    SELF_CHECK(ctx, GetMipLevelCount(1, 1) == 1);
+    SELF_CHECK(ctx, GetMipLevelCount(256, 256) == 9);
+    SELF_CHECK(ctx, GetMipLevelCount(300, 7) == 9);
+    SELF_CHECK(ctx, GetMipLevelCount(5, 3) == 3);
+
+    // 常量图像：两种滤波、sRGB 与否、任意尺寸，每一级的每个像素都原样不变，链一直到 1x1
+    {
+        const uint32_t widths[] = { 1, 2, 3, 7, 64, 100 };
+        const uint32_t heights[] = { 1, 5, 33, 64 };
+        uint32_t wrong = 0, badChains = 0;
+        for (MipFilter filter : { MipFilter::Box, MipFilter::Kaiser })
+        {
+            for (bool srgb : { true, false })
+            {
+                MipSettings settings;
+                settings.Filter = filter;
+                settings.SrgbColor = srgb;
+                for (uint32_t w : widths)
+                {
+                    for (uint32_t h : heights)
+                    {
+                        std::vector<uint8_t> pixels((size_t)w * h * 4);
+                        for (size_t i = 0; i < pixels.size(); i += 4)
+                        {
+                            pixels[i + 0] = 200;
+                            pixels[i + 1] = 17;
+                            pixels[i + 2] = 99;
+                            pixels[i + 3] = 128;
+                        }
+                        std::vector<MipLevel> levels;
+                        GenerateMipChain(pixels, w, h, settings, levels);
+                        if (levels.size() != GetMipLevelCount(w, h) ||
+                            levels.back().Width != 1 || levels.back().Height != 1)
+                        {
+                            ++badChains;
+                            continue;
+                        }
+                        for (const MipLevel& level : levels)
+                        {
+                            const uint8_t* p = pixels.data() + level.Offset;
+                            for (size_t i = 0; i < (size_t)level.Width * level.Height; ++i, p += 4)
+                            {
+                                wrong += p[0] != 200 || p[1] != 17 || p[2] != 99 || p[3] != 128;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        SELF_CHECK(ctx, badChains == 0);
+        SELF_CHECK(ctx, wrong == 0);
+    }
+
+    // 2x2 黑白棋盘（Box）：sRGB 下在线性空间取平均 0.5，编码回去是 188 而不是 128；A 线性平均为 128
+    {
+        SELF_CHECK(ctx, (int)(LinearToSrgb(0.5) * 255.0 + 0.5) == 188);
+        const std::vector<uint8_t> checker =
+        {
+            0, 0, 0, 0,             255, 255, 255, 255,
+            255, 255, 255, 255,     0, 0, 0, 0,
+        };
+        MipSettings settings;
+        settings.Filter = MipFilter::Box;
+        std::vector<uint8_t> pixels = checker;
+        std::vector<MipLevel> levels;
+        GenerateMipChain(pixels, 2, 2, settings, levels);
+        const uint8_t* p = pixels.data() + levels[1].Offset;
+        SELF_CHECK(ctx, levels.size() == 2 && levels[1].Width == 1 && levels[1].Height == 1);
+        SELF_CHECK(ctx, p[0] == 188 && p[1] == 188 && p[2] == 188 && p[3] == 128);
+
+        settings.SrgbColor = false;
+        pixels = checker;
+        GenerateMipChain(pixels, 2, 2, settings, levels);
+        p = pixels.data() + levels[1].Offset;
+        SELF_CHECK(ctx, p[0] == 128 && p[1] == 128 && p[2] == 128 && p[3] == 128);
+    }
+
+    // Box 非 2 的幂：37x23 -> 18x11，落在半个像素上的源像素按面积计入，与双精度参考相差不超过 1
+    {
+        const uint32_t w = 37, h = 23, dw = 18, dh = 11;
+        std::vector<uint8_t> src((size_t)w * h * 4);
+        FillNoise(src, 1);
+        for (bool srgb : { true, false })
+        {
+            MipSettings settings;
+            settings.Filter = MipFilter::Box;
+            settings.SrgbColor = srgb;
+            std::vector<uint8_t> dst((size_t)dw * dh * 4);
+            GenerateMipLevel(src.data(), w, h, dst.data(), dw, dh, settings);
+            SELF_CHECK(ctx, MaxBoxError(src, w, h, dst, dw, dh, srgb) <= 1);
+        }
+    }
+
+    // Kaiser：水平斜坡降采样后仍单调
+    {
+        const uint32_t w = 256, h = 4;
+        std::vector<uint8_t> pixels((size_t)w * h * 4);
+        for (uint32_t y = 0; y < h; ++y)
+        {
+            for (uint32_t x = 0; x < w; ++x)
+            {
+                for (int c = 0; c < 4; ++c)
+                {
+                    pixels[((size_t)y * w + x) * 4 + c] = (uint8_t)x;
+                }
+            }
+        }
+        MipSettings settings;
+        settings.SrgbColor = false;
+        std::vector<MipLevel> levels;
+        GenerateMipChain(pixels, w, h, settings, levels);
+        const uint8_t* p = pixels.data() + levels[1].Offset;
+        bool monotonic = true;
+        for (uint32_t x = 1; x < levels[1].Width; ++x)
+        {
+            monotonic &= p[x * 4] >= p[(x - 1) * 4];
+        }
+        SELF_CHECK(ctx, monotonic);
+    }
+}
@@ -0,0 +1,383 @@
+#include "NullGraphicsBackend.h"
+#include "ShaderCache.h"
+#include <chrono>
+#include <cstring>
+#include <new>
+
+namespace
+{
+    const uint64_t AddressBase = 0x10000000ull;
+    const uint64_t AddressAlignment = 64 * 1024;
+
+    uint64_t SteadyNanoseconds()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    uint32_t FloatBits(float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+}
+
+// ============================================================================
+// 命令流写入
+// ============================================================================
+uint32_t* NullCommandList::Emit(NullCommand command, uint32_t wordCount)
+{
+    const size_t offset = m_stream.size();
+    m_stream.resize(offset + 1 + wordCount);
+    m_stream[offset] = (uint32_t)command | (wordCount << 8);
+    ++m_stats.Commands;
+    return m_stream.data() + offset + 1;
+}
+
+void NullCommandList::Put64(uint32_t* words, uint64_t value)
+{
+    words[0] = (uint32_t)value;
+    words[1] = (uint32_t)(value >> 32);
+}
+
+// ============================================================================
+// 录制
+// ============================================================================
+void NullCommandList::Begin(uint32_t allocator, GpuHandle pipeline)
+{
+    m_stream.clear();
+    m_stats = NullBackendStats{};
+    m_recording = true;
+
+    uint32_t* words = Emit(NullCommand::Begin, 3);
+    words[0] = allocator;
+    Put64(words + 1, pipeline);
+}
+
+void NullCommandList::End()
+{
+    Emit(NullCommand::End, 0);
+    m_recording = false;
+    m_stats.StreamBytes = m_stream.size() * sizeof(uint32_t);
+}
+
+void NullCommandList::Submit(const RenderGraph&, const RGBarrier* barriers, size_t count)
+{
+    // 只记录资源编号与前后状态；userHandle 在录制后端里没有意义
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t* words = Emit(NullCommand::Barrier, 5);
+        words[0] = (uint32_t)barriers[i].Type;
+        words[1] = barriers[i].Resource;
+        words[2] = barriers[i].AliasBefore;
+        words[3] = barriers[i].Before;
+        words[4] = barriers[i].After;
+    }
+    m_stats.Barriers += (uint32_t)count;
+}
+
+void NullCommandList::SetViewport(const GpuViewport& viewport)
+{
+    uint32_t* words = Emit(NullCommand::SetViewport, 6);
+    words[0] = FloatBits(viewport.X);
+    words[1] = FloatBits(viewport.Y);
+    words[2] = FloatBits(viewport.Width);
+    words[3] = FloatBits(viewport.Height);
+    words[4] = FloatBits(viewport.MinDepth);
+    words[5] = FloatBits(viewport.MaxDepth);
+}
+
+void NullCommandList::SetScissorRect(const GpuRect& rect)
+{
+    uint32_t* words = Emit(NullCommand::SetScissorRect, 4);
+    words[0] = (uint32_t)rect.Left;
+    words[1] = (uint32_t)rect.Top;
+    words[2] = (uint32_t)rect.Right;
+    words[3] = (uint32_t)rect.Bottom;
+}
+
+void NullCommandList::SetRenderTarget(uint64_t rtv, uint64_t dsv)
+{
+    uint32_t* words = Emit(NullCommand::SetRenderTarget, 4);
+    Put64(words, rtv);
+    Put64(words + 2, dsv);
+    ++m_stats.RenderTargetBinds;
+}
+
+void NullCommandList::ClearRenderTarget(uint64_t rtv, const float color[4])
+{
+    uint32_t* words = Emit(NullCommand::ClearRenderTarget, 6);
+    Put64(words, rtv);
+    for (int i = 0; i < 4; ++i)
+    {
+        words[2 + i] = FloatBits(color[i]);
+    }
+    ++m_stats.Clears;
+}
+
+void NullCommandList::ClearDepthStencil(uint64_t dsv, float depth, uint8_t stencil)
+{
+    uint32_t* words = Emit(NullCommand::ClearDepthStencil, 4);
+    Put64(words, dsv);
+    words[2] = FloatBits(depth);
+    words[3] = stencil;
+    ++m_stats.Clears;
+}
+
+void NullCommandList::SetRootSignature(GpuHandle rootSignature)
+{
+    Put64(Emit(NullCommand::SetRootSignature, 2), rootSignature);
+    ++m_stats.RootSignatureBinds;
+}
+
+void NullCommandList::SetDescriptorHeap(const DescriptorHeapPage& heap)
+{
+    Put64(Emit(NullCommand::SetDescriptorHeap, 2), heap.GpuBase);
+    ++m_stats.DescriptorHeapBinds;
+}
+
+void NullCommandList::SetPipelineState(GpuHandle pipeline)
+{
+    Put64(Emit(NullCommand::SetPipelineState, 2), pipeline);
+    ++m_stats.PipelineBinds;
+}
+
+void NullCommandList::SetRootConstant(uint32_t parameter, uint32_t value)
+{
+    uint32_t* words = Emit(NullCommand::SetRootConstant, 2);
+    words[0] = parameter;
+    words[1] = value;
+    ++m_stats.RootParameterBinds;
+}
+
+void NullCommandList::SetRootConstantBuffer(uint32_t parameter, uint64_t address)
+{
+    uint32_t* words = Emit(NullCommand::SetRootConstantBuffer, 3);
+    words[0] = parameter;
+    Put64(words + 1, address);
+    ++m_stats.RootParameterBinds;
+}
+
+void NullCommandList::SetRootShaderResource(uint32_t parameter, uint64_t address)
+{
+    uint32_t* words = Emit(NullCommand::SetRootShaderResource, 3);
+    words[0] = parameter;
+    Put64(words + 1, address);
+    ++m_stats.RootParameterBinds;
+}
+
+void NullCommandList::SetRootDescriptorTable(uint32_t parameter, uint64_t gpuDescriptor)
+{
+    uint32_t* words = Emit(NullCommand::SetRootDescriptorTable, 3);
+    words[0] = parameter;
+    Put64(words + 1, gpuDescriptor);
+    ++m_stats.DescriptorTableBinds;
+}
+
+void NullCommandList::SetVertexBuffer(const GpuVertexBufferView& view)
+{
+    uint32_t* words = Emit(NullCommand::SetVertexBuffer, 4);
+    Put64(words, view.Address);
+    words[2] = view.SizeInBytes;
+    words[3] = view.StrideInBytes;
+    ++m_stats.VertexBufferBinds;
+}
+
+void NullCommandList::SetIndexBuffer(const GpuIndexBufferView& view)
+{
+    uint32_t* words = Emit(NullCommand::SetIndexBuffer, 4);
+    Put64(words, view.Address);
+    words[2] = view.SizeInBytes;
+    words[3] = view.IndexSize;
+    ++m_stats.IndexBufferBinds;
+}
+
+void NullCommandList::SetPrimitiveTopology(GpuTopology topology)
+{
+    Emit(NullCommand::SetPrimitiveTopology, 1)[0] = (uint32_t)topology;
+    ++m_stats.TopologyBinds;
+}
+
+void NullCommandList::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount,
+    uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+{
+    uint32_t* words = Emit(NullCommand::DrawIndexedInstanced, 5);
+    words[0] = indexCount;
+    words[1] = instanceCount;
+    words[2] = startIndex;
+    words[3] = (uint32_t)baseVertex;
+    words[4] = startInstance;
+    ++m_stats.Draws;
+    m_stats.Instances += instanceCount;
+    m_stats.Indices += (uint64_t)indexCount * instanceCount;
+}
+
+void NullCommandList::CopyBuffer(const GpuBuffer& dst, uint64_t dstOffset,
+    const GpuBuffer& src, uint64_t srcOffset, uint64_t size)
+{
+    uint32_t* words = Emit(NullCommand::CopyBuffer, 8);
+    Put64(words, dst.Address);
+    Put64(words + 2, dstOffset);
+    Put64(words + 4, src.Address);
+    Put64(words + 6, srcOffset);
+    ++m_stats.Copies;
+    m_stats.CopyBytes += size;
+}
+
+void NullCommandList::WriteTimestamp(uint32_t query)
+{
+    // 命令流只记槽号，时间值不进哈希
+    Emit(NullCommand::WriteTimestamp, 1)[0] = query;
+    if (query < m_timestamps.size())
+    {
+        m_timestamps[query] = SteadyNanoseconds();
+    }
+}
+
+void NullCommandList::ResolveTimestamps(uint32_t first, uint32_t count)
+{
+    uint32_t* words = Emit(NullCommand::ResolveTimestamps, 2);
+    words[0] = first;
+    words[1] = count;
+}
+
+// ============================================================================
+// 后端
+// ============================================================================
+NullGraphicsBackend::NullGraphicsBackend()
+    : m_nextAddress(AddressBase)
+    , m_frameHash(HashSeed)
+{
+}
+
+NullGraphicsBackend::~NullGraphicsBackend()
+{
+}
+
+uint64_t NullGraphicsBackend::AllocateAddress(uint64_t size)
+{
+    uint64_t address = m_nextAddress;
+    m_nextAddress += (size + AddressAlignment - 1) & ~(AddressAlignment - 1);
+    return address;
+}
+
+IGraphicsCommandList* NullGraphicsBackend::CreateCommandList(uint32_t)
+{
+    m_lists.push_back(std::make_unique<NullCommandList>(m_timestamps));
+    return m_lists.back().get();
+}
+
+bool NullGraphicsBackend::CreateBuffer(uint64_t size, GpuMemory memory, GpuBuffer& out)
+{
+    out = GpuBuffer{};
+    if (size == 0)
+    {
+        return false;
+    }
+
+    // 默认堆的内容只会被复制命令“写入”，不需要真正的内存
+    if (memory == GpuMemory::Upload)
+    {
+        out.Cpu = new (std::nothrow) uint8_t[(size_t)size];
+        if (!out.Cpu)
+        {
+            return false;
+        }
+    }
+
+    out.Address = AllocateAddress(size);
+    out.Handle = out.Address;
+    out.Size = size;
+    m_liveBufferBytes += size;
+    return true;
+}
+
+void NullGraphicsBackend::DestroyBuffer(const GpuBuffer& buffer)
+{
+    if (buffer.Handle == NullGpuHandle)
+    {
+        return;
+    }
+    delete[] buffer.Cpu;
+    m_liveBufferBytes -= buffer.Size;
+}
+
+void NullGraphicsBackend::Submit(IGraphicsCommandList* const* lists, uint32_t count)
+{
+    ++m_frame.Submits;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const NullCommandList* list = static_cast<const NullCommandList*>(lists[i]);
+        const std::vector<uint32_t>& stream = list->GetStream();
+        m_frame.Add(list->GetStats());
+        ++m_frame.CommandLists;
+        m_frameHash = HashBytes(stream.data(), stream.size() * sizeof(uint32_t), m_frameHash);
+    }
+}
+
+void NullGraphicsBackend::Present()
+{
+    ++m_presents;
+    m_total.Add(m_frame);
+    m_lastFrame = m_frame;
+    m_lastFrameHash = m_frameHash;
+    m_frame = NullBackendStats{};
+    m_frameHash = HashSeed;
+}
+
+bool NullGraphicsBackend::CreateTimestampQueries(uint32_t count)
+{
+    m_timestamps.assign(count, 0);
+    return true;
+}
+
+bool NullGraphicsBackend::ReadTimestamps(uint32_t first, uint32_t count, uint64_t* out)
+{
+    if ((uint64_t)first + count > m_timestamps.size())
+    {
+        return false;
+    }
+    memcpy(out, m_timestamps.data() + first, (size_t)count * sizeof(uint64_t));
+    return true;
+}
+
+bool NullGraphicsBackend::GetTimestampCalibration(uint64_t& gpuTimestamp, uint64_t& cpuNanoseconds)
+{
+    gpuTimestamp = cpuNanoseconds = SteadyNanoseconds();
+    return true;
+}
+
+// ============================================================================
+// 普通内存上的上传页与描述符堆
+// ============================================================================
+bool NullGraphicsBackend::UploadPages::CreatePage(uint64_t size, UploadPage& out)
+{
+    uint8_t* memory = new (std::nothrow) uint8_t[(size_t)size];
+    if (!memory)
+    {
+        return false;
+    }
+
+    out.CpuBase = memory;
+    out.GpuBase = m_owner.AllocateAddress(size);
+    out.Size = size;
+    out.Handle = memory;
+    return true;
+}
+
+void NullGraphicsBackend::UploadPages::DestroyPage(const UploadPage& page)
+{
+    delete[] static_cast<uint8_t*>(page.Handle);
+}
+
+bool NullGraphicsBackend::DescriptorHeaps::CreateHeap(uint32_t capacity, DescriptorHeapPage& out)
+{
+    if (!CpuDescriptorHeapSource::CreateHeap(capacity, out))
+    {
+        return false;
+    }
+    // CPU 句柄指向真实内存（分配器迁移时要复制），GPU 句柄换成与运行无关的伪地址
+    out.GpuBase = m_owner.AllocateAddress((uint64_t)capacity * DescriptorSize);
+    return true;
+}
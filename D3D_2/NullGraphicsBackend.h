@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "GraphicsBackend.h"
+#include "FrameSync.h"
+#include "UploadAllocator.h"
+#include "DescriptorAllocator.h"
+
+// 录制后端的计数（一条列表自 Begin 起，或一帧内提交的全部列表）
+struct NullBackendStats
+{
+    uint32_t Submits = 0;
+    uint32_t CommandLists = 0;
+    uint64_t Commands = 0;
+    uint64_t StreamBytes = 0;         // 命令流字节数
+
+    uint32_t PipelineBinds = 0;
+    uint32_t RootSignatureBinds = 0;
+    uint32_t DescriptorHeapBinds = 0;
+    uint32_t DescriptorTableBinds = 0;
+    uint32_t RootParameterBinds = 0;  // 根常量 + 根 CBV + 根 SRV
+    uint32_t VertexBufferBinds = 0;
+    uint32_t IndexBufferBinds = 0;
+    uint32_t TopologyBinds = 0;
+    uint32_t RenderTargetBinds = 0;
+
+    uint32_t Draws = 0;
+    uint64_t Instances = 0;
+    uint64_t Indices = 0;             // 所有实例的索引总数
+    uint32_t Clears = 0;
+    uint32_t Barriers = 0;
+    uint32_t Copies = 0;
+    uint64_t CopyBytes = 0;
+
+    void Add(const NullBackendStats& other)
+    {
+        Submits += other.Submits;
+        CommandLists += other.CommandLists;
+        Commands += other.Commands;
+        StreamBytes += other.StreamBytes;
+        PipelineBinds += other.PipelineBinds;
+        RootSignatureBinds += other.RootSignatureBinds;
+        DescriptorHeapBinds += other.DescriptorHeapBinds;
+        DescriptorTableBinds += other.DescriptorTableBinds;
+        RootParameterBinds += other.RootParameterBinds;
+        VertexBufferBinds += other.VertexBufferBinds;
+        IndexBufferBinds += other.IndexBufferBinds;
+        TopologyBinds += other.TopologyBinds;
+        RenderTargetBinds += other.RenderTargetBinds;
+        Draws += other.Draws;
+        Instances += other.Instances;
+        Indices += other.Indices;
+        Clears += other.Clears;
+        Barriers += other.Barriers;
+        Copies += other.Copies;
+        CopyBytes += other.CopyBytes;
+    }
+};
+
+// 命令流中的操作码。每条命令是一个 32 位头（低 8 位操作码，高 24 位为后面参数的字数）+ 参数字，
+// 64 位参数按低、高两个字存放
+enum class NullCommand : uint32_t
+{
+    Begin,
+    End,
+    Barrier,
+    SetViewport,
+    SetScissorRect,
+    SetRenderTarget,
+    ClearRenderTarget,
+    ClearDepthStencil,
+    SetRootSignature,
+    SetDescriptorHeap,
+    SetPipelineState,
+    SetRootConstant,
+    SetRootConstantBuffer,
+    SetRootShaderResource,
+    SetRootDescriptorTable,
+    SetVertexBuffer,
+    SetIndexBuffer,
+    SetPrimitiveTopology,
+    DrawIndexedInstanced,
+    CopyBuffer,
+    WriteTimestamp,
+    ResolveTimestamps
+};
+
+// 只录制不执行的命令列表
+class NullCommandList : public IGraphicsCommandList
+{
+public:
+    // timestamps 为后端的时间戳槽，WriteTimestamp 在录制时写入当前时间
+    explicit NullCommandList(std::vector<uint64_t>& timestamps) : m_timestamps(timestamps) {}
+
+    void Begin(uint32_t allocator, GpuHandle pipeline) override;
+    void End() override;
+
+    void Submit(const RenderGraph& graph, const RGBarrier* barriers, size_t count) override;
+
+    void SetViewport(const GpuViewport& viewport) override;
+    void SetScissorRect(const GpuRect& rect) override;
+    void SetRenderTarget(uint64_t rtv, uint64_t dsv) override;
+    void ClearRenderTarget(uint64_t rtv, const float color[4]) override;
+    void ClearDepthStencil(uint64_t dsv, float depth, uint8_t stencil) override;
+
+    void SetRootSignature(GpuHandle rootSignature) override;
+    void SetDescriptorHeap(const DescriptorHeapPage& heap) override;
+    void SetPipelineState(GpuHandle pipeline) override;
+    void SetRootConstant(uint32_t parameter, uint32_t value) override;
+    void SetRootConstantBuffer(uint32_t parameter, uint64_t address) override;
+    void SetRootShaderResource(uint32_t parameter, uint64_t address) override;
+    void SetRootDescriptorTable(uint32_t parameter, uint64_t gpuDescriptor) override;
+
+    void SetVertexBuffer(const GpuVertexBufferView& view) override;
+    void SetIndexBuffer(const GpuIndexBufferView& view) override;
+    void SetPrimitiveTopology(GpuTopology topology) override;
+    void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount,
+        uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) override;
+
+    void CopyBuffer(const GpuBuffer& dst, uint64_t dstOffset,
+        const GpuBuffer& src, uint64_t srcOffset, uint64_t size) override;
+
+    void WriteTimestamp(uint32_t query) override;
+    void ResolveTimestamps(uint32_t first, uint32_t count) override;
+
+    bool IsRecording() const { return m_recording; }
+    // 自上次 Begin 起录制的命令流与计数
+    const std::vector<uint32_t>& GetStream() const { return m_stream; }
+    const NullBackendStats& GetStats() const { return m_stats; }
+
+private:
+    // 写入一条命令的头，返回参数的写入位置
+    uint32_t* Emit(NullCommand command, uint32_t wordCount);
+    static void Put64(uint32_t* words, uint64_t value);
+
+private:
+    std::vector<uint32_t> m_stream;
+    NullBackendStats m_stats;
+    bool m_recording = false;
+    std::vector<uint64_t>& m_timestamps;
+};
+
+// IGraphicsBackend 的录制实现：不创建任何 GPU 对象。
+//   - 缓冲、上传页、描述符堆都用普通内存，GPU 地址/句柄按创建顺序分配，
+//     同样的调用序列每次运行得到同样的命令流
+//   - 栅栏在 Signal 时立即完成，帧环永远不会等待
+//   - 提交时累计计数并对命令流求哈希；Present 结束一帧
+//   - 没有 GPU 时钟，时间戳取录制时刻的 steady_clock 纳秒（频率 1GHz），反映的是 CPU 录制耗时
+class NullGraphicsBackend : public IGraphicsBackend
+{
+public:
+    NullGraphicsBackend();
+    ~NullGraphicsBackend() override;
+
+    IGraphicsCommandList* CreateCommandList(uint32_t allocatorCount) override;
+
+    bool CreateBuffer(uint64_t size, GpuMemory memory, GpuBuffer& out) override;
+    void DestroyBuffer(const GpuBuffer& buffer) override;
+
+    void Submit(IGraphicsCommandList* const* lists, uint32_t count) override;
+    void Present() override;
+
+    IFence& GetFence() override { return m_fence; }
+    IUploadPageSource& GetUploadPageSource() override { return m_uploadPages; }
+    IDescriptorHeapSource& GetDescriptorHeapSource() override { return m_descriptorHeaps; }
+
+    bool CreateTimestampQueries(uint32_t count) override;
+    bool ReadTimestamps(uint32_t first, uint32_t count, uint64_t* out) override;
+    uint64_t GetTimestampFrequency() override { return 1000000000ull; }
+    bool GetTimestampCalibration(uint64_t& gpuTimestamp, uint64_t& cpuNanoseconds) override;
+
+    // 上一次 Present 所在帧的计数与命令流哈希。哈希包含帧上下文序号与上传地址，
+    // 同一场景、同样的帧数每次运行结果相同，可用于回归比对
+    const NullBackendStats& GetFrameStats() const { return m_lastFrame; }
+    uint64_t GetFrameHash() const { return m_lastFrameHash; }
+    // 创建以来的累计值（包括初始化时的上传）
+    const NullBackendStats& GetTotalStats() const { return m_total; }
+    uint32_t GetPresentCount() const { return m_presents; }
+    uint64_t GetLiveBufferBytes() const { return m_liveBufferBytes; }
+
+private:
+    // 伪 GPU 地址：按 64KB 对齐顺序分配，不复用
+    uint64_t AllocateAddress(uint64_t size);
+
+    class ImmediateFence : public IFence
+    {
+    public:
+        uint64_t Signal() override { return ++m_value; }
+        uint64_t GetCompletedValue() const override { return m_value; }
+        void WaitForValue(uint64_t) override {}
+        uint64_t GetLastSignaledValue() const override { return m_value; }
+
+    private:
+        uint64_t m_value = 0;
+    };
+
+    class UploadPages : public IUploadPageSource
+    {
+    public:
+        explicit UploadPages(NullGraphicsBackend& owner) : m_owner(owner) {}
+        bool CreatePage(uint64_t size, UploadPage& out) override;
+        void DestroyPage(const UploadPage& page) override;
+
+    private:
+        NullGraphicsBackend& m_owner;
+    };
+
+    class DescriptorHeaps : public CpuDescriptorHeapSource
+    {
+    public:
+        explicit DescriptorHeaps(NullGraphicsBackend& owner) : CpuDescriptorHeapSource(DescriptorSize), m_owner(owner) {}
+        bool CreateHeap(uint32_t capacity, DescriptorHeapPage& out) override;
+
+    private:
+        static const uint32_t DescriptorSize = 32;
+        NullGraphicsBackend& m_owner;
+    };
+
+private:
+    std::vector<std::unique_ptr<NullCommandList>> m_lists;
+    ImmediateFence m_fence;
+    UploadPages m_uploadPages{ *this };
+    DescriptorHeaps m_descriptorHeaps{ *this };
+    std::vector<uint64_t> m_timestamps;
+
+    uint64_t m_nextAddress;
+    uint64_t m_liveBufferBytes = 0;
+
+    NullBackendStats m_frame;
+    NullBackendStats m_lastFrame;
+    NullBackendStats m_total;
+    uint64_t m_frameHash;
+    uint64_t m_lastFrameHash = 0;
+    uint32_t m_presents = 0;
+};
@@ -0,0 +1,184 @@
+#include "SelfTest.h"
+#include "NullGraphicsBackend.h"
+#include "ShaderCache.h"
+
+// ============================================================================
+// NullGraphicsBackend：录制一帧固定的命令，检查每种绑定/绘制/字节计数与帧哈希
+// ============================================================================
+namespace
+{
+    // 帧哈希的基准值。命令流编码或伪地址分配方式改动时需要重新生成
+    const uint64_t GoldenFrameHash = 0x0cfc4bc1156bb461ull;
+
+    struct FixedFrame
+    {
+        NullGraphicsBackend Backend;
+        IGraphicsCommandList* Setup = nullptr;
+        IGraphicsCommandList* Scene = nullptr;
+        GpuBuffer Upload;
+        GpuBuffer Vertices;
+        DescriptorHeapPage Heap;
+        RenderGraph Graph;
+
+        FixedFrame()
+        {
+            Setup = Backend.CreateCommandList(3);
+            Scene = Backend.CreateCommandList(3);
+            Backend.CreateBuffer(1000, GpuMemory::Upload, Upload);
+            Backend.CreateBuffer(70000, GpuMemory::Default, Vertices);
+            Backend.GetDescriptorHeapSource().CreateHeap(16, Heap);
+            Backend.CreateTimestampQueries(2);
+        }
+
+        ~FixedFrame()
+        {
+            Backend.DestroyBuffer(Upload);
+            Backend.DestroyBuffer(Vertices);
+            Backend.GetDescriptorHeapSource().DestroyHeap(Heap);
+        }
+
+        // 第一条列表：清屏、两个屏障、一次上传复制；第二条：公共状态 + 3 次实例化绘制
+        void Record(uint32_t lastInstanceCount)
+        {
+            GpuViewport viewport;
+            viewport.Width = 1280.0f;
+            viewport.Height = 720.0f;
+            GpuRect scissor;
+            scissor.Right = 1280;
+            scissor.Bottom = 720;
+            const float clearColor[4] = { 0.1f, 0.2f, 0.3f, 1.0f };
+            RGBarrier barriers[2];
+            barriers[0].Resource = 0;
+            barriers[0].Before = 1;
+            barriers[0].After = 2;
+            barriers[1].Resource = 1;
+            barriers[1].Before = 4;
+            barriers[1].After = 8;
+
+            Setup->Begin(0, 5);
+            Setup->SetViewport(viewport);
+            Setup->SetScissorRect(scissor);
+            Setup->SetRenderTarget(0x100, 0x200);
+            Setup->ClearRenderTarget(0x100, clearColor);
+            Setup->ClearDepthStencil(0x200, 1.0f, 0);
+            Setup->Submit(Graph, barriers, 2);
+            Setup->CopyBuffer(Vertices, 0, Upload, 0, 1000);
+            Setup->End();
+
+            Scene->Begin(1, 5);
+            Scene->WriteTimestamp(0);
+            Scene->SetRootSignature(9);
+            Scene->SetDescriptorHeap(Heap);
+            Scene->SetPipelineState(6);
+            Scene->SetRootConstantBuffer(1, Upload.Address);
+            Scene->SetRootShaderResource(3, Upload.Address + 256);
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                GpuVertexBufferView vb;
+                vb.Address = Vertices.Address + i * 1024;
+                vb.SizeInBytes = 1024;
+                vb.StrideInBytes = 32;
+                GpuIndexBufferView ib;
+                ib.Address = Vertices.Address + 60000;
+                ib.SizeInBytes = 72;
+                Scene->SetRootDescriptorTable(2, Heap.GpuBase + i * 32);
+                Scene->SetVertexBuffer(vb);
+                Scene->SetIndexBuffer(ib);
+                Scene->SetPrimitiveTopology(GpuTopology::TriangleList);
+                Scene->SetRootConstant(0, i);
+                Scene->DrawIndexedInstanced(36, i < 2 ? i + 1 : lastInstanceCount, 0, 0, 0);
+            }
+            Scene->WriteTimestamp(1);
+            Scene->ResolveTimestamps(0, 2);
+            Scene->End();
+
+            IGraphicsCommandList* lists[] = { Setup, Scene };
+            Backend.Submit(lists, 2);
+            Backend.Present();
+        }
+    };
+}
+
+void TestNullGraphicsBackend(SelfTestContext& ctx)
+{
+    FixedFrame frame;
+
+    // 伪地址按创建顺序、64KB 对齐分配
+    SELF_CHECK(ctx, frame.Upload.Address == 0x10000000ull && frame.Upload.Cpu != nullptr);
+    SELF_CHECK(ctx, frame.Vertices.Address == 0x10010000ull && frame.Vertices.Cpu == nullptr);
+    SELF_CHECK(ctx, frame.Heap.GpuBase == 0x10030000ull);
+    SELF_CHECK(ctx, frame.Backend.GetLiveBufferBytes() == 71000);
+
+    frame.Record(3);
+    const NullBackendStats& stats = frame.Backend.GetFrameStats();
+    SELF_CHECK(ctx, stats.Submits == 1 && stats.CommandLists == 2);
+    // 第一条 10 条命令 55 个字，第二条 7 + 3 x 6 + 3 = 28 条命令 104 个字
+    SELF_CHECK(ctx, stats.Commands == 38 && stats.StreamBytes == (55 + 104) * sizeof(uint32_t));
+    SELF_CHECK(ctx, stats.PipelineBinds == 1 && stats.RootSignatureBinds == 1 && stats.DescriptorHeapBinds == 1);
+    SELF_CHECK(ctx, stats.DescriptorTableBinds == 3 && stats.RootParameterBinds == 5);
+    SELF_CHECK(ctx, stats.VertexBufferBinds == 3 && stats.IndexBufferBinds == 3 && stats.TopologyBinds == 3);
+    SELF_CHECK(ctx, stats.RenderTargetBinds == 1 && stats.Clears == 2 && stats.Barriers == 2);
+    SELF_CHECK(ctx, stats.Draws == 3 && stats.Instances == 6 && stats.Indices == 6 * 36);
+    SELF_CHECK(ctx, stats.Copies == 1 && stats.CopyBytes == 1000);
+
+    // 第一条列表的命令流逐字比对（头：低 8 位操作码，高 24 位参数字数）
+    {
+        auto header = [](NullCommand command, uint32_t words) { return (uint32_t)command | (words << 8); };
+        const uint32_t one = 0x3F800000u;
+        const std::vector<uint32_t> expected =
+        {
+            header(NullCommand::Begin, 3), 0, 5, 0,
+            header(NullCommand::SetViewport, 6), 0, 0, 0x44A00000u, 0x44340000u, 0, one,
+            header(NullCommand::SetScissorRect, 4), 0, 0, 1280, 720,
+            header(NullCommand::SetRenderTarget, 4), 0x100, 0, 0x200, 0,
+            header(NullCommand::ClearRenderTarget, 6), 0x100, 0, 0x3DCCCCCDu, 0x3E4CCCCDu, 0x3E99999Au, one,
+            header(NullCommand::ClearDepthStencil, 4), 0x200, 0, one, 0,
+            header(NullCommand::Barrier, 5), 0, 0, InvalidRGResource, 1, 2,
+            header(NullCommand::Barrier, 5), 0, 1, InvalidRGResource, 4, 8,
+            header(NullCommand::CopyBuffer, 8), 0x10010000u, 0, 0, 0, 0x10000000u, 0, 0, 0,
+            header(NullCommand::End, 0),
+        };
+        const std::vector<uint32_t>& stream = static_cast<NullCommandList*>(frame.Setup)->GetStream();
+        SELF_CHECK(ctx, stream == expected);
+
+        // 帧哈希 = 按提交顺序对两条命令流依次求 FNV-1a
+        const std::vector<uint32_t>& scene = static_cast<NullCommandList*>(frame.Scene)->GetStream();
+        const uint64_t hash = HashBytes(scene.data(), scene.size() * sizeof(uint32_t),
+            HashBytes(expected.data(), expected.size() * sizeof(uint32_t)));
+        SELF_CHECK(ctx, frame.Backend.GetFrameHash() == hash);
+        SELF_CHECK(ctx, frame.Backend.GetFrameHash() == GoldenFrameHash);
+    }
+
+    // 另一个后端录同样的一帧：计数与哈希相同（时间戳的值不进哈希）
+    {
+        FixedFrame again;
+        again.Record(3);
+        SELF_CHECK(ctx, again.Backend.GetFrameHash() == frame.Backend.GetFrameHash());
+        SELF_CHECK(ctx, again.Backend.GetFrameStats().StreamBytes == stats.StreamBytes);
+
+        // 只改一个实例数：计数与哈希都变
+        FixedFrame changed;
+        changed.Record(4);
+        SELF_CHECK(ctx, changed.Backend.GetFrameHash() != frame.Backend.GetFrameHash());
+        SELF_CHECK(ctx, changed.Backend.GetFrameStats().Instances == 7);
+    }
+
+    // Present 结束一帧：空帧的计数为零、哈希回到种子；累计值包含两帧
+    {
+        const NullBackendStats first = frame.Backend.GetFrameStats();
+        frame.Backend.Present();
+        SELF_CHECK(ctx, frame.Backend.GetFrameStats().Commands == 0 && frame.Backend.GetFrameHash() == HashSeed);
+        frame.Record(3);
+        SELF_CHECK(ctx, frame.Backend.GetFrameHash() == GoldenFrameHash);
+        SELF_CHECK(ctx, frame.Backend.GetPresentCount() == 3);
+        SELF_CHECK(ctx, frame.Backend.GetTotalStats().Draws == 2 * first.Draws);
+        SELF_CHECK(ctx, frame.Backend.GetTotalStats().StreamBytes == 2 * first.StreamBytes);
+    }
+
+    // 时间戳：录制时写入，读回单调；越界读取失败
+    {
+        uint64_t times[2] = {};
+        SELF_CHECK(ctx, frame.Backend.ReadTimestamps(0, 2, times) && times[0] != 0 && times[1] >= times[0]);
+        SELF_CHECK(ctx, !frame.Backend.ReadTimestamps(1, 2, times));
+    }
+}
@@ -0,0 +1,315 @@
+#include "OcclusionCuller.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+    double ElapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+// ============================================================================
+// 构造与每帧初始化
+// ============================================================================
+OcclusionCuller::OcclusionCuller()
+    : m_depth(Width * Height, 1.0f)
+{
+    XMStoreFloat4x4(&m_viewProj, XMMatrixIdentity());
+}
+
+void OcclusionCuller::BeginFrame(FXMMATRIX viewProj)
+{
+    XMStoreFloat4x4(&m_viewProj, viewProj);
+    std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+    m_triangles.clear();
+    m_stats = OcclusionStats{};
+}
+
+// ============================================================================
+// 遮挡体三角形建立
+// ============================================================================
+void OcclusionCuller::AddOccluder(FXMMATRIX world,
+    const std::vector<XMFLOAT3>& positions,
+    const std::vector<uint16_t>& indices)
+{
+    if (positions.empty() || indices.size() < 3)
+    {
+        return;
+    }
+
+    XMMATRIX worldViewProj = world * XMLoadFloat4x4(&m_viewProj);
+
+    // 顶点变换到屏幕空间；w 过小（在近平面附近或之后）标记为无效
+    struct ScreenVertex
+    {
+        float X;
+        float Y;
+        float Z;
+        bool Valid;
+    };
+    std::vector<ScreenVertex> screen(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        XMVECTOR clip = XMVector4Transform(
+            XMVectorSet(positions[i].x, positions[i].y, positions[i].z, 1.0f), worldViewProj);
+        float w = XMVectorGetW(clip);
+        float z = XMVectorGetZ(clip);
+
+        ScreenVertex& sv = screen[i];
+        sv.Valid = (w > 1e-4f && z >= 0.0f);
+        if (!sv.Valid)
+        {
+            continue;
+        }
+
+        float invW = 1.0f / w;
+        sv.X = (XMVectorGetX(clip) * invW * 0.5f + 0.5f) * Width;
+        sv.Y = (0.5f - XMVectorGetY(clip) * invW * 0.5f) * Height;
+        sv.Z = z * invW;
+    }
+
+    ++m_stats.OccluderCount;
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const ScreenVertex& v0 = screen[indices[i]];
+        const ScreenVertex& v1 = screen[indices[i + 1]];
+        const ScreenVertex& v2 = screen[indices[i + 2]];
+
+        // 跨近平面的三角形直接丢弃（少画遮挡体只会更保守）
+        if (!v0.Valid || !v1.Valid || !v2.Valid)
+        {
+            continue;
+        }
+
+        // 与 GPU 默认光栅化状态一致：顺时针为正面，剔除背面
+        float area = (v1.X - v0.X) * (v2.Y - v0.Y) - (v2.X - v0.X) * (v1.Y - v0.Y);
+        if (area <= 1e-6f)
+        {
+            continue;
+        }
+
+        Triangle tri;
+        tri.MinX = std::max(0, (int)std::floor(std::min({ v0.X, v1.X, v2.X })));
+        tri.MaxX = std::min(Width - 1, (int)std::ceil(std::max({ v0.X, v1.X, v2.X })));
+        tri.MinY = std::max(0, (int)std::floor(std::min({ v0.Y, v1.Y, v2.Y })));
+        tri.MaxY = std::min(Height - 1, (int)std::ceil(std::max({ v0.Y, v1.Y, v2.Y })));
+        if (tri.MinX > tri.MaxX || tri.MinY > tri.MaxY)
+        {
+            continue;
+        }
+
+        const ScreenVertex* v[3] = { &v0, &v1, &v2 };
+        for (int e = 0; e < 3; ++e)
+        {
+            const ScreenVertex& a = *v[e];
+            const ScreenVertex& b = *v[(e + 1) % 3];
+            tri.EdgeA[e] = -(b.Y - a.Y);
+            tri.EdgeB[e] = (b.X - a.X);
+            tri.EdgeC[e] = (b.Y - a.Y) * a.X - (b.X - a.X) * a.Y;
+        }
+
+        float invArea = 1.0f / area;
+        tri.ZA = ((v1.Z - v0.Z) * (v2.Y - v0.Y) - (v2.Z - v0.Z) * (v1.Y - v0.Y)) * invArea;
+        tri.ZB = ((v2.Z - v0.Z) * (v1.X - v0.X) - (v1.Z - v0.Z) * (v2.X - v0.X)) * invArea;
+        tri.ZC = v0.Z - tri.ZA * v0.X - tri.ZB * v0.Y;
+
+        m_triangles.push_back(tri);
+    }
+
+    m_stats.TriangleCount = (uint32_t)m_triangles.size();
+}
+
+// ============================================================================
+// 光栅化
+// ============================================================================
+void OcclusionCuller::RasterizeOccluders(ThreadPool* pool)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    const int bandCount = Height / BandHeight;
+    if (pool && !m_triangles.empty())
+    {
+        // 每个条带由一个任务独占写入，无需同步
+        pool->ParallelFor((size_t)bandCount, 1, [this](size_t begin, size_t end)
+        {
+            for (size_t band = begin; band < end; ++band)
+            {
+                RasterizeBand((int)band);
+            }
+        });
+    }
+    else
+    {
+        for (int band = 0; band < bandCount; ++band)
+        {
+            RasterizeBand(band);
+        }
+    }
+
+    m_stats.RasterMs = ElapsedMs(start);
+}
+
+void OcclusionCuller::RasterizeBand(int band)
+{
+    const int y0 = band * BandHeight;
+    const int y1 = y0 + BandHeight - 1;
+
+    for (const Triangle& tri : m_triangles)
+    {
+        if (tri.MaxY < y0 || tri.MinY > y1)
+        {
+            continue;
+        }
+        RasterizeTriangle(tri, std::max(tri.MinY, y0), std::min(tri.MaxY, y1));
+    }
+}
+
+void OcclusionCuller::RasterizeTriangle(const Triangle& tri, int y0, int y1)
+{
+    const int xStart = tri.MinX & ~3;
+    const int xEnd = tri.MaxX;
+
+    // 采样点取像素中心
+    const XMVECTOR laneOffset = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+    const XMVECTOR zero = XMVectorZero();
+
+    XMVECTOR edgeA[3];
+    for (int e = 0; e < 3; ++e)
+    {
+        edgeA[e] = XMVectorReplicate(tri.EdgeA[e]);
+    }
+    const XMVECTOR zA = XMVectorReplicate(tri.ZA);
+
+    for (int y = y0; y <= y1; ++y)
+    {
+        const float py = (float)y + 0.5f;
+        float* row = &m_depth[(size_t)y * Width];
+
+        XMVECTOR rowEdge[3];
+        for (int e = 0; e < 3; ++e)
+        {
+            rowEdge[e] = XMVectorReplicate(tri.EdgeB[e] * py + tri.EdgeC[e]);
+        }
+        const XMVECTOR rowZ = XMVectorReplicate(tri.ZB * py + tri.ZC);
+
+        for (int x = xStart; x <= xEnd; x += 4)
+        {
+            XMVECTOR px = XMVectorAdd(XMVectorReplicate((float)x), laneOffset);
+
+            XMVECTOR e0 = XMVectorMultiplyAdd(edgeA[0], px, rowEdge[0]);
+            XMVECTOR e1 = XMVectorMultiplyAdd(edgeA[1], px, rowEdge[1]);
+            XMVECTOR e2 = XMVectorMultiplyAdd(edgeA[2], px, rowEdge[2]);
+
+            XMVECTOR inside = XMVectorAndInt(
+                XMVectorAndInt(XMVectorGreaterOrEqual(e0, zero), XMVectorGreaterOrEqual(e1, zero)),
+                XMVectorGreaterOrEqual(e2, zero));
+
+            XMFLOAT4* dst = reinterpret_cast<XMFLOAT4*>(row + x);
+            XMVECTOR oldDepth = XMLoadFloat4(dst);
+            XMVECTOR z = XMVectorMultiplyAdd(zA, px, rowZ);
+            XMVECTOR newDepth = XMVectorSelect(oldDepth, XMVectorMin(oldDepth, z), inside);
+            XMStoreFloat4(dst, newDepth);
+        }
+    }
+}
+
+// ============================================================================
+// 被遮挡体测试
+// ============================================================================
+bool OcclusionCuller::IsVisible(const XMFLOAT3& center, float radius) const
+{
+    XMMATRIX viewProj = XMLoadFloat4x4(&m_viewProj);
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    float minZ = FLT_MAX;
+
+    // 包围球的外接 AABB 八个角点
+    for (int i = 0; i < 8; ++i)
+    {
+        XMVECTOR corner = XMVectorSet(
+            center.x + ((i & 1) ? radius : -radius),
+            center.y + ((i & 2) ? radius : -radius),
+            center.z + ((i & 4) ? radius : -radius),
+            1.0f);
+        XMVECTOR clip = XMVector4Transform(corner, viewProj);
+        float w = XMVectorGetW(clip);
+        float z = XMVectorGetZ(clip);
+        if (w <= 1e-4f || z < 0.0f)
+        {
+            return true; // 与近平面相交，保守地视为可见
+        }
+
+        float invW = 1.0f / w;
+        float sx = (XMVectorGetX(clip) * invW * 0.5f + 0.5f) * Width;
+        float sy = (0.5f - XMVectorGetY(clip) * invW * 0.5f) * Height;
+        minX = std::min(minX, sx);
+        maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy);
+        maxY = std::max(maxY, sy);
+        minZ = std::min(minZ, z * invW);
+    }
+
+    int x0 = std::max(0, (int)std::floor(minX));
+    int x1 = std::min(Width - 1, (int)std::ceil(maxX));
+    int y0 = std::max(0, (int)std::floor(minY));
+    int y1 = std::min(Height - 1, (int)std::ceil(maxY));
+    if (x0 > x1 || y0 > y1)
+    {
+        return true; // 完全在屏幕外的情况交给视锥剔除
+    }
+
+    // 矩形内任一像素的遮挡深度不比对象最近点更近，则可能可见
+    for (int y = y0; y <= y1; ++y)
+    {
+        const float* row = &m_depth[(size_t)y * Width];
+        for (int x = x0; x <= x1; ++x)
+        {
+            if (row[x] >= minZ)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void OcclusionCuller::TestOccludees(const XMFLOAT3* centers, const float* radii, size_t count,
+    uint8_t* visible, ThreadPool* pool)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    auto testRange = [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            visible[i] = IsVisible(centers[i], radii[i]) ? 1 : 0;
+        }
+    };
+
+    if (pool)
+    {
+        pool->ParallelFor(count, 64, testRange);
+    }
+    else
+    {
+        testRange(0, count);
+    }
+
+    uint32_t occluded = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        occluded += visible[i] ? 0 : 1;
+    }
+
+    m_stats.TestedCount = (uint32_t)count;
+    m_stats.OccludedCount = occluded;
+    m_stats.TestMs = ElapsedMs(start);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// 遮挡剔除统计（每帧）
+struct OcclusionStats
+{
+    uint32_t OccluderCount = 0;
+    uint32_t TriangleCount = 0;
+    uint32_t TestedCount = 0;
+    uint32_t OccludedCount = 0;
+    double RasterMs = 0.0;
+    double TestMs = 0.0;
+};
+
+// 纯 CPU 的软件遮挡剔除：
+// 1. 把选中的遮挡体三角形光栅化到低分辨率深度缓冲（按水平条带多线程，4 像素一组 SIMD）
+// 2. 被遮挡体用包围盒投影出的屏幕矩形 + 最近深度做保守测试
+class OcclusionCuller
+{
+public:
+    static const int Width = 256;
+    static const int Height = 128;
+    static const int BandHeight = 16;
+
+    OcclusionCuller();
+
+    // 清空深度缓冲并设置本帧 view * proj
+    void BeginFrame(DirectX::FXMMATRIX viewProj);
+
+    // 添加遮挡体（模型空间顶点 + 三角形索引），背面与跨近平面的三角形被丢弃
+    void AddOccluder(DirectX::FXMMATRIX world,
+        const std::vector<DirectX::XMFLOAT3>& positions,
+        const std::vector<uint16_t>& indices);
+
+    // 光栅化所有遮挡体；pool 为空时单线程执行
+    void RasterizeOccluders(ThreadPool* pool);
+
+    // 单个包围球的可见性测试
+    bool IsVisible(const DirectX::XMFLOAT3& center, float radius) const;
+
+    // 批量测试，visible[i] 写 0/1
+    void TestOccludees(const DirectX::XMFLOAT3* centers, const float* radii, size_t count,
+        uint8_t* visible, ThreadPool* pool);
+
+    const float* GetDepthBuffer() const { return m_depth.data(); }
+    const OcclusionStats& GetStats() const { return m_stats; }
+
+private:
+    struct Triangle
+    {
+        // 边函数 E(x, y) = A * x + B * y + C，三角形内部 E >= 0
+        float EdgeA[3];
+        float EdgeB[3];
+        float EdgeC[3];
+        // 深度平面 z = ZA * x + ZB * y + ZC
+        float ZA;
+        float ZB;
+        float ZC;
+        int MinX;
+        int MaxX;
+        int MinY;
+        int MaxY;
+    };
+
+    void RasterizeBand(int band);
+    void RasterizeTriangle(const Triangle& tri, int y0, int y1);
+
+private:
+    std::vector<float> m_depth;
+    std::vector<Triangle> m_triangles;
+    DirectX::XMFLOAT4X4 m_viewProj;
+    OcclusionStats m_stats;
+};
@@ -0,0 +1,268 @@
+#include "SelfTest.h"
+#include "OcclusionCuller.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace DirectX;
+
+// ============================================================================
+// OcclusionCuller：手工构造的平面/立方体遮挡体，固定像素的深度与可见性判定
+// ============================================================================
+namespace
+{
+    const float NearZ = 1.0f;
+    const float FarZ = 100.0f;
+
+    // 相机在 z = -10 看向原点，竖直视角 60 度，宽高比与深度缓冲一致（2:1）
+    XMMATRIX MakeViewProj()
+    {
+        const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.0f, 0.0f, -10.0f, 1.0f), XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        const XMMATRIX proj = XMMatrixPerspectiveFovLH(XMConvertToRadians(60.0f),
+            (float)OcclusionCuller::Width / OcclusionCuller::Height, NearZ, FarZ);
+        return view * proj;
+    }
+
+    // 视空间距离 d 处的深度缓冲值 z / w
+    float DepthAt(float distance)
+    {
+        return FarZ / (FarZ - NearZ) * (1.0f - NearZ / distance);
+    }
+
+    float PixelDepth(const OcclusionCuller& culler, int x, int y)
+    {
+        return culler.GetDepthBuffer()[(size_t)y * OcclusionCuller::Width + x];
+    }
+
+    struct Mesh
+    {
+        std::vector<XMFLOAT3> Positions;
+        std::vector<uint16_t> Indices;
+
+        // 以 normal 为外法线、半边长 1 的正方形面；从外侧看去顺时针
+        void AddFace(FXMVECTOR center, FXMVECTOR normal, FXMVECTOR up)
+        {
+            const XMVECTOR right = XMVector3Cross(up, -normal);
+            const uint16_t base = (uint16_t)Positions.size();
+            const XMVECTOR corners[4] = { center - right - up, center - right + up, center + right + up, center + right - up };
+            for (const XMVECTOR& corner : corners)
+            {
+                XMFLOAT3 p;
+                XMStoreFloat3(&p, corner);
+                Positions.push_back(p);
+            }
+            const uint16_t quad[6] = { 0, 1, 2, 0, 2, 3 };
+            for (uint16_t i : quad)
+            {
+                Indices.push_back((uint16_t)(base + i));
+            }
+        }
+    };
+
+    // z = 0 上朝向 -z（面向相机）的正方形，半边长 1，用 world 缩放
+    Mesh MakePlane()
+    {
+        Mesh mesh;
+        mesh.AddFace(XMVectorZero(), XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        return mesh;
+    }
+
+    // 半边长 1 的立方体，六个面都从外侧看顺时针
+    Mesh MakeCube()
+    {
+        Mesh mesh;
+        const XMVECTOR axisY = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+        const XMVECTOR axisZ = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+        const XMVECTOR normals[6] =
+        {
+            XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(-1.0f, 0.0f, 0.0f, 0.0f),
+            axisY, -axisY, axisZ, -axisZ,
+        };
+        for (int i = 0; i < 6; ++i)
+        {
+            mesh.AddFace(normals[i], normals[i], (i == 2 || i == 3) ? axisZ : axisY);
+        }
+        return mesh;
+    }
+
+    uint32_t CountCovered(const OcclusionCuller& culler)
+    {
+        uint32_t covered = 0;
+        for (int i = 0; i < OcclusionCuller::Width * OcclusionCuller::Height; ++i)
+        {
+            covered += culler.GetDepthBuffer()[i] < 1.0f;
+        }
+        return covered;
+    }
+}
+
+void TestOcclusionCuller(SelfTestContext& ctx)
+{
+    const XMMATRIX viewProj = MakeViewProj();
+    const Mesh plane = MakePlane();
+    const Mesh cube = MakeCube();
+    OcclusionCuller culler;
+
+    // 4x4 的平面放在 z = 0（距相机 10）：投影到像素 [105.8, 150.2] x [41.8, 86.2]，
+    // 按像素中心采样覆盖 x 106..149、y 42..85 共 44 x 44 个像素，深度为 DepthAt(10)
+    culler.BeginFrame(viewProj);
+    culler.AddOccluder(XMMatrixScaling(2.0f, 2.0f, 1.0f), plane.Positions, plane.Indices);
+    culler.RasterizeOccluders(nullptr);
+    SELF_CHECK(ctx, culler.GetStats().OccluderCount == 1 && culler.GetStats().TriangleCount == 2);
+    SELF_CHECK(ctx, std::fabs(PixelDepth(culler, 128, 64) - DepthAt(10.0f)) < 1e-4f);
+    SELF_CHECK(ctx, std::fabs(PixelDepth(culler, 106, 42) - DepthAt(10.0f)) < 1e-4f);
+    SELF_CHECK(ctx, std::fabs(PixelDepth(culler, 149, 85) - DepthAt(10.0f)) < 1e-4f);
+    SELF_CHECK(ctx, PixelDepth(culler, 105, 64) == 1.0f && PixelDepth(culler, 150, 64) == 1.0f);
+    SELF_CHECK(ctx, PixelDepth(culler, 128, 41) == 1.0f && PixelDepth(culler, 128, 86) == 1.0f);
+    SELF_CHECK(ctx, CountCovered(culler) == 44 * 44);
+
+    // 可见性：完全藏在平面后面 / 部分露出边缘 / 在平面前面 / 跨过近平面 / 屏幕外
+    SELF_CHECK(ctx, !culler.IsVisible(XMFLOAT3(0.0f, 0.0f, 5.0f), 0.5f));
+    SELF_CHECK(ctx, !culler.IsVisible(XMFLOAT3(1.2f, -1.2f, 8.0f), 0.5f));
+    SELF_CHECK(ctx, culler.IsVisible(XMFLOAT3(3.0f, 0.0f, 5.0f), 1.0f));
+    SELF_CHECK(ctx, culler.IsVisible(XMFLOAT3(0.0f, 0.0f, -3.0f), 0.5f));
+    SELF_CHECK(ctx, culler.IsVisible(XMFLOAT3(0.0f, 0.0f, -0.6f), 0.5f));
+    SELF_CHECK(ctx, culler.IsVisible(XMFLOAT3(0.0f, 0.0f, -9.0f), 0.5f));
+    SELF_CHECK(ctx, culler.IsVisible(XMFLOAT3(0.0f, 40.0f, 5.0f), 0.5f));
+
+    // 背面剔除：同一平面绕 y 转半圈后背对相机，一个三角形都不留
+    culler.BeginFrame(viewProj);
+    culler.AddOccluder(XMMatrixScaling(2.0f, 2.0f, 1.0f) * XMMatrixRotationY(XM_PI), plane.Positions, plane.Indices);
+    culler.RasterizeOccluders(nullptr);
+    SELF_CHECK(ctx, culler.GetStats().TriangleCount == 0 && CountCovered(culler) == 0);
+    SELF_CHECK(ctx, culler.IsVisible(XMFLOAT3(0.0f, 0.0f, 5.0f), 0.5f));
+
+    // 跨近平面：y = -2 上朝上的地板，z 在 [2, 22] 时整块在相机前方，两个三角形都画（投影到像素行 71..82）；
+    // 一直延伸到相机后面时两个三角形都有顶点越过近平面，整体丢弃
+    {
+        Mesh floor;
+        floor.AddFace(XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f));
+        culler.BeginFrame(viewProj);
+        culler.AddOccluder(XMMatrixScaling(20.0f, 1.0f, 10.0f) * XMMatrixTranslation(0.0f, -2.0f, 12.0f), floor.Positions, floor.Indices);
+        culler.RasterizeOccluders(nullptr);
+        SELF_CHECK(ctx, culler.GetStats().TriangleCount == 2);
+        SELF_CHECK(ctx, PixelDepth(culler, 128, 76) < 1.0f && PixelDepth(culler, 128, 64) == 1.0f && PixelDepth(culler, 128, 90) == 1.0f);
+
+        culler.BeginFrame(viewProj);
+        culler.AddOccluder(XMMatrixScaling(20.0f, 1.0f, 20.0f) * XMMatrixTranslation(0.0f, -2.0f, 0.0f), floor.Positions, floor.Indices);
+        culler.RasterizeOccluders(nullptr);
+        SELF_CHECK(ctx, culler.GetStats().TriangleCount == 0 && CountCovered(culler) == 0);
+    }
+
+    // 立方体正对相机：只有朝 -z 的面是正面，中心深度为前表面距离 9
+    culler.BeginFrame(viewProj);
+    culler.AddOccluder(XMMatrixIdentity(), cube.Positions, cube.Indices);
+    culler.RasterizeOccluders(nullptr);
+    SELF_CHECK(ctx, culler.GetStats().TriangleCount == 2);
+    SELF_CHECK(ctx, std::fabs(PixelDepth(culler, 128, 64) - DepthAt(9.0f)) < 1e-4f);
+    SELF_CHECK(ctx, !culler.IsVisible(XMFLOAT3(0.0f, 0.0f, 3.0f), 0.3f));
+    SELF_CHECK(ctx, culler.IsVisible(XMFLOAT3(0.0f, 0.0f, -2.0f), 0.3f));
+
+    // 绕 y 转 45 度：两个侧面朝向相机，最近的竖棱在距离 10 - sqrt(2) 处
+    culler.BeginFrame(viewProj);
+    culler.AddOccluder(XMMatrixRotationY(XM_PIDIV4), cube.Positions, cube.Indices);
+    culler.RasterizeOccluders(nullptr);
+    SELF_CHECK(ctx, culler.GetStats().TriangleCount == 4);
+    SELF_CHECK(ctx, std::fabs(PixelDepth(culler, 128, 64) - DepthAt(10.0f - std::sqrt(2.0f))) < 2e-3f);
+
+    // 多线程：条带并行光栅化与批量测试，和单线程逐像素、逐项一致
+    {
+        std::mt19937 rng(28);
+        std::uniform_real_distribution<float> offset(-4.0f, 4.0f), depth(-8.0f, 20.0f), radius(0.1f, 1.0f);
+        std::vector<XMFLOAT3> centers(301);
+        std::vector<float> radii(centers.size());
+        for (size_t i = 0; i < centers.size(); ++i)
+        {
+            centers[i] = XMFLOAT3(offset(rng), offset(rng), depth(rng));
+            radii[i] = radius(rng);
+        }
+
+        ThreadPool pool(3);
+        OcclusionCuller serial, parallel;
+        std::vector<uint8_t> serialVisible(centers.size()), parallelVisible(centers.size());
+        for (OcclusionCuller* c : { &serial, &parallel })
+        {
+            c->BeginFrame(viewProj);
+            c->AddOccluder(XMMatrixRotationY(0.3f) * XMMatrixTranslation(-1.5f, 0.0f, 1.0f), cube.Positions, cube.Indices);
+            c->AddOccluder(XMMatrixScaling(1.5f, 3.0f, 1.0f) * XMMatrixTranslation(2.0f, 0.5f, 0.0f), plane.Positions, plane.Indices);
+        }
+        serial.RasterizeOccluders(nullptr);
+        parallel.RasterizeOccluders(&pool);
+        SELF_CHECK(ctx, std::equal(serial.GetDepthBuffer(), serial.GetDepthBuffer() + OcclusionCuller::Width * OcclusionCuller::Height,
+            parallel.GetDepthBuffer()));
+
+        serial.TestOccludees(centers.data(), radii.data(), centers.size(), serialVisible.data(), nullptr);
+        parallel.TestOccludees(centers.data(), radii.data(), centers.size(), parallelVisible.data(), &pool);
+        SELF_CHECK(ctx, serialVisible == parallelVisible);
+        uint32_t occluded = 0;
+        for (size_t i = 0; i < centers.size(); ++i)
+        {
+            occluded += serialVisible[i] ? 0 : 1;
+        }
+        SELF_CHECK(ctx, parallel.GetStats().OccluderCount == 2 && parallel.GetStats().TestedCount == centers.size());
+        SELF_CHECK(ctx, parallel.GetStats().OccludedCount == occluded && occluded > 0 && occluded < centers.size());
+    }
+}
+
+// ============================================================================
+// 基准：一排立方体墙挡在相机前，objectCount 个包围球散布在墙前后；
+// 相机每帧左右平移，统计被剔除比例与光栅化 / 测试耗时
+// ============================================================================
+bool RunOcclusionBenchmark(int objectCount, int frameCount)
+{
+    if (objectCount <= 0 || frameCount <= 0)
+    {
+        return false;
+    }
+
+    const Mesh cube = MakeCube();
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> spread(-40.0f, 40.0f), depth(-5.0f, 80.0f), radius(0.2f, 1.5f);
+    std::vector<XMFLOAT3> centers((size_t)objectCount);
+    std::vector<float> radii(centers.size());
+    for (size_t i = 0; i < centers.size(); ++i)
+    {
+        centers[i] = XMFLOAT3(spread(rng), spread(rng) * 0.25f, depth(rng));
+        radii[i] = radius(rng);
+    }
+    std::vector<uint8_t> visible(centers.size());
+
+    const XMMATRIX proj = XMMatrixPerspectiveFovLH(XMConvertToRadians(60.0f),
+        (float)OcclusionCuller::Width / OcclusionCuller::Height, NearZ, FarZ);
+    ThreadPool pool;
+    OcclusionCuller culler;
+    for (ThreadPool* p : { (ThreadPool*)nullptr, &pool })
+    {
+        double rasterMs = 0.0, testMs = 0.0, occludedFraction = 0.0;
+        uint32_t triangles = 0;
+        for (int frame = 0; frame < frameCount; ++frame)
+        {
+            const float x = std::sin(frame * 0.05f) * 10.0f;
+            const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(x, 2.0f, -20.0f, 1.0f),
+                XMVectorSet(x, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+            culler.BeginFrame(view * proj);
+            for (int i = 0; i < 12; ++i)
+            {
+                culler.AddOccluder(XMMatrixScaling(2.0f, 4.0f, 0.5f) * XMMatrixTranslation(-22.0f + i * 4.0f, 0.0f, 0.0f),
+                    cube.Positions, cube.Indices);
+            }
+            culler.RasterizeOccluders(p);
+            culler.TestOccludees(centers.data(), radii.data(), centers.size(), visible.data(), p);
+
+            const OcclusionStats& stats = culler.GetStats();
+            rasterMs += stats.RasterMs;
+            testMs += stats.TestMs;
+            occludedFraction += (double)stats.OccludedCount / stats.TestedCount;
+            triangles = stats.TriangleCount;
+        }
+
+        printf("Occlusion benchmark (%s): %d objects, %d frames, %u occluder triangles\n"
+            "  occluded %.1f%%; raster avg %.3f ms, test avg %.3f ms per frame\n",
+            p ? "thread pool" : "single thread", objectCount, frameCount, triangles,
+            occludedFraction * 100.0 / frameCount, rasterMs / frameCount, testMs / frameCount);
+    }
+    fflush(stdout);
+    return true;
+}
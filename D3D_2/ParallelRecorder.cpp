@@ -0,0 +1,107 @@
+#include "ParallelRecorder.h"
+#include "ThreadPool.h"
+#include "FrameProfiler.h"
+#include <algorithm>
+
+// ============================================================================
+// 参数
+// ============================================================================
+void ParallelRecorder::Configure(uint32_t maxChunks, uint64_t minChunkCost)
+{
+    m_maxChunks = (maxChunks > 0) ? maxChunks : 1;
+    m_minChunkCost = (minChunkCost > 0) ? minChunkCost : 1;
+}
+
+// ============================================================================
+// 按代价分块
+// ============================================================================
+const std::vector<RecordChunk>& ParallelRecorder::Partition(const std::vector<uint64_t>& costs)
+{
+    m_chunks.clear();
+
+    const uint32_t batchCount = (uint32_t)costs.size();
+    if (batchCount == 0)
+    {
+        return m_chunks;
+    }
+
+    uint64_t total = 0;
+    for (uint64_t c : costs)
+    {
+        total += c;
+    }
+
+    uint64_t chunkCount = total / m_minChunkCost;
+    if (chunkCount > m_maxChunks)
+    {
+        chunkCount = m_maxChunks;
+    }
+    if (chunkCount > batchCount)
+    {
+        chunkCount = batchCount;
+    }
+    if (chunkCount == 0)
+    {
+        chunkCount = 1;
+    }
+
+    // 每块的目标代价 = 剩余代价 / 剩余块数；单个批次特别重时，后面的块会自动重新均分
+    uint64_t chunksLeft = chunkCount;
+    uint64_t remainingCost = total;
+    uint64_t target = remainingCost / chunksLeft;
+
+    RecordChunk current{ 0, 0, 0 };
+    for (uint32_t i = 0; i < batchCount; ++i)
+    {
+        current.BatchCount++;
+        current.Cost += costs[i];
+
+        const uint32_t remainingBatches = batchCount - i - 1;
+        if (chunksLeft > 1 && remainingBatches > 0 &&
+            (current.Cost >= target || remainingBatches < chunksLeft))
+        {
+            m_chunks.push_back(current);
+            remainingCost -= current.Cost;
+            current = RecordChunk{ i + 1, 0, 0 };
+
+            chunksLeft = std::min<uint64_t>(chunksLeft - 1, std::max<uint64_t>(remainingCost / m_minChunkCost, 1));
+            target = remainingCost / chunksLeft;
+        }
+    }
+
+    if (current.BatchCount > 0)
+    {
+        m_chunks.push_back(current);
+    }
+    return m_chunks;
+}
+
+// ============================================================================
+// 录制
+// ============================================================================
+void ParallelRecorder::Record(IDrawRecorder& recorder, ThreadPool* pool) const
+{
+    auto recordRange = [&](size_t begin, size_t end)
+    {
+        for (size_t c = begin; c < end; ++c)
+        {
+            PROFILE_SCOPE("RecordChunk");
+            const RecordChunk& chunk = m_chunks[c];
+            recorder.BeginChunk((uint32_t)c);
+            for (uint32_t b = 0; b < chunk.BatchCount; ++b)
+            {
+                recorder.RecordBatch((uint32_t)c, chunk.FirstBatch + b);
+            }
+            recorder.EndChunk((uint32_t)c);
+        }
+    };
+
+    if (pool && m_chunks.size() > 1)
+    {
+        pool->ParallelFor(m_chunks.size(), 1, recordRange);
+    }
+    else
+    {
+        recordRange(0, m_chunks.size());
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// 录制块：批次列表中的一段连续区间，由一个线程录制到一条命令列表
+struct RecordChunk
+{
+    uint32_t FirstBatch;
+    uint32_t BatchCount;
+    uint64_t Cost;
+};
+
+// 命令录制接口：D3DManager 用命令分配器/命令列表实现，
+// 也可以用只记录调用的桩实现，在没有 GPU 的环境下检查分块与调度结果。
+// 同一个 chunk 的三个调用总在同一线程上按顺序发生，不同 chunk 可能并发。
+class IDrawRecorder
+{
+public:
+    virtual ~IDrawRecorder() = default;
+
+    virtual void BeginChunk(uint32_t chunkIndex) = 0;
+    virtual void RecordBatch(uint32_t chunkIndex, uint32_t batchIndex) = 0;
+    virtual void EndChunk(uint32_t chunkIndex) = 0;
+};
+
+// 把一帧的绘制批次按代价切成若干连续块，并在线程池上并行录制。
+// 分块只取决于代价序列与参数，与线程数和执行顺序无关；提交时按块顺序即可保证结果确定。
+class ParallelRecorder
+{
+public:
+    // maxChunks：最多切成几块（通常等于可用的命令列表数）
+    // minChunkCost：每块至少的代价，总代价太小时少切或不切
+    void Configure(uint32_t maxChunks, uint64_t minChunkCost);
+
+    // costs[i] 为第 i 个批次的录制代价
+    const std::vector<RecordChunk>& Partition(const std::vector<uint64_t>& costs);
+
+    // 录制 Partition 得到的全部块；pool 为空时在调用线程上顺序执行
+    void Record(IDrawRecorder& recorder, ThreadPool* pool) const;
+
+    const std::vector<RecordChunk>& GetChunks() const { return m_chunks; }
+    uint32_t GetMaxChunks() const { return m_maxChunks; }
+
+private:
+    uint32_t m_maxChunks = 1;
+    uint64_t m_minChunkCost = 1;
+    std::vector<RecordChunk> m_chunks;
+};
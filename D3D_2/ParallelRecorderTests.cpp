@@ -0,0 +1,176 @@
+#include "SelfTest.h"
+#include "ParallelRecorder.h"
+#include "ThreadPool.h"
+#include <random>
+
+// ============================================================================
+// ParallelRecorder：分块覆盖全部批次且负载均衡，录制结果与线程数无关
+// ============================================================================
+namespace
+{
+    // 只记录调用的录制桩：每块一条批次序列，外加调用顺序是否正确
+    class RecordingStub : public IDrawRecorder
+    {
+    public:
+        explicit RecordingStub(size_t chunkCount)
+            : m_batches(chunkCount), m_state(chunkCount, 0), m_valid(chunkCount, 1)
+        {
+        }
+
+        void BeginChunk(uint32_t chunkIndex) override
+        {
+            m_valid[chunkIndex] &= m_state[chunkIndex] == 0;
+            m_state[chunkIndex] = 1;
+        }
+        void RecordBatch(uint32_t chunkIndex, uint32_t batchIndex) override
+        {
+            m_valid[chunkIndex] &= m_state[chunkIndex] == 1;
+            m_batches[chunkIndex].push_back(batchIndex);
+        }
+        void EndChunk(uint32_t chunkIndex) override
+        {
+            m_valid[chunkIndex] &= m_state[chunkIndex] == 1;
+            m_state[chunkIndex] = 2;
+        }
+
+        bool IsValid() const
+        {
+            for (size_t c = 0; c < m_state.size(); ++c)
+            {
+                if (!m_valid[c] || m_state[c] != 2)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        const std::vector<std::vector<uint32_t>>& GetBatches() const { return m_batches; }
+
+    private:
+        std::vector<std::vector<uint32_t>> m_batches;
+        std::vector<int> m_state;
+        std::vector<int> m_valid;
+    };
+
+    // 分块连续、非空、覆盖全部批次，代价与批次之和一致；每块在达到均分目标后立即结束
+    void CheckChunks(SelfTestContext& ctx, const std::vector<RecordChunk>& chunks,
+        const std::vector<uint64_t>& costs, uint32_t maxChunks, uint64_t minChunkCost)
+    {
+        if (costs.empty())
+        {
+            SELF_CHECK(ctx, chunks.empty());
+            return;
+        }
+
+        uint64_t total = 0;
+        for (uint64_t c : costs)
+        {
+            total += c;
+        }
+        SELF_CHECK(ctx, !chunks.empty() && chunks.size() <= maxChunks && chunks.size() <= costs.size());
+        SELF_CHECK(ctx, chunks.size() == 1 || total / chunks.size() >= minChunkCost);
+
+        uint32_t next = 0;
+        for (const RecordChunk& chunk : chunks)
+        {
+            SELF_CHECK(ctx, chunk.FirstBatch == next && chunk.BatchCount > 0);
+            uint64_t cost = 0;
+            for (uint32_t b = 0; b < chunk.BatchCount && next + b < costs.size(); ++b)
+            {
+                cost += costs[next + b];
+            }
+            SELF_CHECK(ctx, cost == chunk.Cost);
+            next += chunk.BatchCount;
+        }
+        SELF_CHECK(ctx, next == costs.size());
+    }
+}
+
+void TestParallelRecorder(SelfTestContext& ctx)
+{
+    ParallelRecorder recorder;
+    recorder.Configure(8, 256);
+
+    // 均匀代价恰好均分
+    std::vector<uint64_t> costs(1000, 4);
+    const std::vector<RecordChunk>& uniform = recorder.Partition(costs);
+    CheckChunks(ctx, uniform, costs, 8, 256);
+    SELF_CHECK(ctx, uniform.size() == 8);
+    for (const RecordChunk& chunk : uniform)
+    {
+        SELF_CHECK(ctx, chunk.Cost == 500);
+    }
+
+    // 总代价不足 minChunkCost 时不切
+    costs.assign(20, 4);
+    SELF_CHECK(ctx, recorder.Partition(costs).size() == 1);
+    costs.assign(200, 4);
+    SELF_CHECK(ctx, recorder.Partition(costs).size() == 3);
+    costs.clear();
+    CheckChunks(ctx, recorder.Partition(costs), costs, 8, 256);
+
+    // 批次少于块数时每块一个批次
+    recorder.Configure(8, 1);
+    costs.assign(3, 100);
+    SELF_CHECK(ctx, recorder.Partition(costs).size() == 3);
+
+    // 随机代价（含一个超重批次）：除最后一个批次外，每块的代价都小于当时的均分目标，
+    // 因此最重的块不超过 均值 + 最重批次
+    std::mt19937 rng(1);
+    recorder.Configure(8, 256);
+    for (uint32_t count : { 1u, 7u, 100u, 1000u, 5000u })
+    {
+        costs.resize(count);
+        uint64_t total = 0, heaviest = 0;
+        for (uint64_t& c : costs)
+        {
+            c = 2 + rng() % 30;
+        }
+        if (count > 10)
+        {
+            costs[5] = 3000;
+        }
+        for (uint64_t c : costs)
+        {
+            total += c;
+            heaviest = c > heaviest ? c : heaviest;
+        }
+
+        const std::vector<RecordChunk> chunks = recorder.Partition(costs);
+        CheckChunks(ctx, chunks, costs, 8, 256);
+        for (const RecordChunk& chunk : chunks)
+        {
+            SELF_CHECK(ctx, chunk.Cost <= total / chunks.size() + heaviest);
+        }
+
+        // 同样的代价序列得到同样的分块
+        const std::vector<RecordChunk>& again = recorder.Partition(costs);
+        SELF_CHECK(ctx, again.size() == chunks.size());
+        for (size_t c = 0; c < chunks.size() && c < again.size(); ++c)
+        {
+            SELF_CHECK(ctx, again[c].FirstBatch == chunks[c].FirstBatch && again[c].BatchCount == chunks[c].BatchCount);
+        }
+
+        // 顺序录制与不同线程数的并行录制结果一致
+        RecordingStub serial(chunks.size());
+        recorder.Record(serial, nullptr);
+        SELF_CHECK(ctx, serial.IsValid());
+        uint32_t next = 0;
+        for (const std::vector<uint32_t>& batches : serial.GetBatches())
+        {
+            for (uint32_t b : batches)
+            {
+                SELF_CHECK(ctx, b == next++);
+            }
+        }
+        SELF_CHECK(ctx, next == count);
+
+        for (unsigned threads : { 1u, 3u, 7u })
+        {
+            ThreadPool pool(threads);
+            RecordingStub parallel(chunks.size());
+            recorder.Record(parallel, &pool);
+            SELF_CHECK(ctx, parallel.IsValid() && parallel.GetBatches() == serial.GetBatches());
+        }
+    }
+}
@@ -1,13 +1,12 @@
 #include "PrimitiveShape.h"
-#include "D3DManager.h"
+#include <cfloat>
 #include <cmath>
+#include <cstring>
 
 using namespace DirectX;
 
-const float PI = 3.14159265359f;
-
 // ============================================================================
-// 캯
+// 构造函数和析构函数
 // ============================================================================
 PrimitiveShape::PrimitiveShape()
 {
@@ -15,587 +14,133 @@ PrimitiveShape::PrimitiveShape()
 
 PrimitiveShape::~PrimitiveShape()
 {
+    DisposeUploaders();
+    DestroyBuffer(m_vertexBufferGPU);
+    DestroyBuffer(m_indexBufferGPU);
 }
 
 // ============================================================================
-// ʼ״
+// 初始化形状
 // ============================================================================
-bool PrimitiveShape::Initialize(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, int shapeType)
+bool PrimitiveShape::Initialize(IGraphicsBackend& backend, IGraphicsCommandList& commandList, int shapeType)
 {
+    m_backend = &backend;
+
     std::vector<Vertex> vertices;
     std::vector<std::uint16_t> indices;
 
-    // ״ɼ
-    switch (shapeType)
+    // 根据形状类型生成几何数据
+    if (!GenerateShapeGeometry(shapeType, vertices, indices))
     {
-    case 1: // Sphere
-        BuildSphere(vertices, indices);
-        break;
-    case 2: // Cylinder
-        BuildCylinder(vertices, indices);
-        break;
-    case 3: // Plane
-        BuildPlane(vertices, indices);
-        break;
-    case 4: // Cube
-        BuildCube(vertices, indices);
-        break;
-    case 5: // Tetrahedron
-        BuildTetrahedron(vertices, indices);
-        break;
-    default:
         return false;
     }
 
-    // ϴݵGPU
-    return UploadGeometry(device, commandList, vertices, indices);
-}
-
-// ============================================================================
-// 
-// ============================================================================
-void PrimitiveShape::BuildSphere(std::vector<Vertex>& vertices, std::vector<std::uint16_t>& indices)
-{
-    const float radius = 1.0f;
-    const UINT sliceCount = 20;
-    const UINT stackCount = 20;
-
-    // 㣺
-    Vertex topVertex;
-    topVertex.Pos = XMFLOAT3(0.0f, radius, 0.0f);
-    topVertex.Normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
-    topVertex.Color = XMFLOAT4(0.5f, 0.5f, 0.5f, 1.0f); // ɫ
-    vertices.push_back(topVertex);
-
-    float phiStep = PI / stackCount;
-    float thetaStep = 2.0f * PI / sliceCount;
-
-    for (UINT i = 1; i <= stackCount - 1; ++i)
-    {
-        float phi = i * phiStep;
-        for (UINT j = 0; j <= sliceCount; ++j)
-        {
-            float theta = j * thetaStep;
-
-            Vertex v;
-            float x = radius * sinf(phi) * cosf(theta);
-            float y = radius * cosf(phi);
-            float z = radius * sinf(phi) * sinf(theta);
-
-            v.Pos = XMFLOAT3(x, y, z);
-
-            //  = һ (x, y, z) / radius뾶Ϊ 1 ֱõλ
-            XMVECTOR n = XMVector3Normalize(XMLoadFloat3(&v.Pos));
-            XMStoreFloat3(&v.Normal, n);
-
-            v.Color = XMFLOAT4(0.5f, 0.5f, 0.5f, 1.0f); // ɫ
-
-            vertices.push_back(v);
-        }
-    }
-
-    // 㣺ϼ
-    Vertex bottomVertex;
-    bottomVertex.Pos = XMFLOAT3(0.0f, -radius, 0.0f);
-    bottomVertex.Normal = XMFLOAT3(0.0f, -1.0f, 0.0f);
-    bottomVertex.Color = XMFLOAT4(0.5f, 0.5f, 0.5f, 1.0f); // ɫ
-    vertices.push_back(bottomVertex);
-
-    //  - 
-    for (UINT i = 1; i <= sliceCount; ++i)
-    {
-        indices.push_back(0);
-        indices.push_back(i + 1);
-        indices.push_back(i);
-    }
-
-    //  - м
-    UINT baseIndex = 1;
-    UINT ringVertexCount = sliceCount + 1;
-    for (UINT i = 0; i < stackCount - 2; ++i)
-    {
-        for (UINT j = 0; j < sliceCount; ++j)
-        {
-            indices.push_back(baseIndex + i * ringVertexCount + j);
-            indices.push_back(baseIndex + i * ringVertexCount + j + 1);
-            indices.push_back(baseIndex + (i + 1) * ringVertexCount + j);
-
-            indices.push_back(baseIndex + (i + 1) * ringVertexCount + j);
-            indices.push_back(baseIndex + i * ringVertexCount + j + 1);
-            indices.push_back(baseIndex + (i + 1) * ringVertexCount + j + 1);
-        }
-    }
-
-    //  - ײ
-    UINT southPoleIndex = (UINT)vertices.size() - 1;
-    baseIndex = southPoleIndex - ringVertexCount;
-    for (UINT i = 0; i < sliceCount; ++i)
-    {
-        indices.push_back(southPoleIndex);
-        indices.push_back(baseIndex + i);
-        indices.push_back(baseIndex + i + 1);
-    }
-}
-
-// ============================================================================
-// 
-// ============================================================================
-void PrimitiveShape::BuildCylinder(std::vector<Vertex>& vertices, std::vector<std::uint16_t>& indices)
-{
-    const float topRadius = 1.0f;
-    const float bottomRadius = 1.0f;
-    const float height = 2.0f;
-    const UINT sliceCount = 20;
-    const UINT stackCount = 10;
-
-    float stackHeight = height / stackCount;
-    float radiusStep = (topRadius - bottomRadius) / stackCount;
-    UINT ringCount = stackCount + 1;
-
-    XMFLOAT4 gray(0.5f, 0.5f, 0.5f, 1.0f);
-    XMFLOAT3 n(0.0f, 1.0f, 0.0f);
-
-
-    // ------------------ 涥 ------------------
-    for (UINT i = 0; i < ringCount; ++i)
-    {
-        float y = -0.5f * height + i * stackHeight;
-        float r = bottomRadius + i * radiusStep;
-        float dTheta = 2.0f * PI / sliceCount;
-
-        for (UINT j = 0; j <= sliceCount; ++j)
-        {
-            Vertex vertex;
-            float c = cosf(j * dTheta);
-            float s = sinf(j * dTheta);
-
-            vertex.Pos = XMFLOAT3(r * c, y, r * s);
-			vertex.Normal = XMFLOAT3(c, 0.0f, s); // 淨
-            vertex.Color = gray;
-
-            vertices.push_back(vertex);
-        }
-    }
-
-    // ------------------  ------------------
-    UINT ringVertexCount = sliceCount + 1;
-    for (UINT i = 0; i < stackCount; ++i)
-    {
-        for (UINT j = 0; j < sliceCount; ++j)
-        {
-            indices.push_back(i * ringVertexCount + j);
-            indices.push_back((i + 1) * ringVertexCount + j);
-            indices.push_back((i + 1) * ringVertexCount + j + 1);
-
-            indices.push_back(i * ringVertexCount + j);
-            indices.push_back((i + 1) * ringVertexCount + j + 1);
-            indices.push_back(i * ringVertexCount + j + 1);
-        }
-    }
-
-    float dTheta = 2.0f * PI / sliceCount;
-
-    // ------------------  ------------------
-    // Բʼ
-    UINT topBaseIndex = (UINT)vertices.size();
-    float topY = 0.5f * height;
-
-    for (UINT i = 0; i <= sliceCount; ++i)
-    {
-        float x = topRadius * cosf(i * dTheta);
-        float z = topRadius * sinf(i * dTheta);
-
-        Vertex v;
-        v.Pos = XMFLOAT3(x, topY, z);
-        v.Normal = n;
-        v.Color = gray;
-        vertices.push_back(v);
-    }
-
-    // ĵ
-    Vertex topCenter;
-    topCenter.Pos = XMFLOAT3(0.0f, topY, 0.0f);
-	topCenter.Normal = n;
-    topCenter.Color = gray;
-    vertices.push_back(topCenter);
-
-    UINT topCenterIndex = (UINT)vertices.size() - 1;
-
-    // עγ˳
-    for (UINT i = 0; i < sliceCount; ++i)
+    // 保留 CPU 端位置与索引，并统计模型空间包围盒
+    m_cpuPositions.resize(vertices.size());
+    XMVECTOR minP = XMVectorReplicate(FLT_MAX);
+    XMVECTOR maxP = XMVectorReplicate(-FLT_MAX);
+    for (size_t i = 0; i < vertices.size(); ++i)
     {
-        indices.push_back(topCenterIndex);
-        indices.push_back(topBaseIndex + i + 1);
-        indices.push_back(topBaseIndex + i);
-    }
-
-    // ------------------ ׸ ------------------
-    // ׸Բʼ
-    UINT bottomBaseIndex = (UINT)vertices.size();
-    float bottomY = -0.5f * height;
-
-    for (UINT i = 0; i <= sliceCount; ++i)
-    {
-        float x = bottomRadius * cosf(i * dTheta);
-        float z = bottomRadius * sinf(i * dTheta);
-
-        Vertex v;
-        v.Pos = XMFLOAT3(x, bottomY, z);
-		v.Normal = XMFLOAT3(0.0f, -1.0f, 0.0f);
-        v.Color = gray;
-        vertices.push_back(v);
+        m_cpuPositions[i] = vertices[i].Pos;
+        XMVECTOR p = XMLoadFloat3(&vertices[i].Pos);
+        minP = XMVectorMin(minP, p);
+        maxP = XMVectorMax(maxP, p);
     }
+    m_cpuIndices = indices;
+    XMStoreFloat3(&m_localMin, minP);
+    XMStoreFloat3(&m_localMax, maxP);
 
-    // ׸ĵ
-    Vertex bottomCenter;
-    bottomCenter.Pos = XMFLOAT3(0.0f, bottomY, 0.0f);
-	bottomCenter.Normal = XMFLOAT3(0.0f, -1.0f, 0.0f);
-    bottomCenter.Color = gray;
-    vertices.push_back(bottomCenter);
-
-    UINT bottomCenterIndex = (UINT)vertices.size() - 1;
-
-    // ׸˳򣬱ַ߳⣩
-    for (UINT i = 0; i < sliceCount; ++i)
-    {
-        indices.push_back(bottomCenterIndex);
-        indices.push_back(bottomBaseIndex + i);
-        indices.push_back(bottomBaseIndex + i + 1);
-    }
-}
-
-// ============================================================================
-// ƽ
-// ============================================================================
-void PrimitiveShape::BuildPlane(std::vector<Vertex>& vertices, std::vector<std::uint16_t>& indices)
-{
-    const float width = 2.0f;
-    const float depth = 2.0f;
-
-    vertices.resize(4);
-    XMFLOAT3 n(0.0f, 1.0f, 0.0f);
-
-    vertices[0].Pos = XMFLOAT3(-width / 2, 0.0f, -depth / 2);
-    vertices[0].Normal = n;
-    vertices[0].Color = XMFLOAT4(0.5f, 0.5f, 0.5f, 1.0f);
-
-    vertices[1].Pos = XMFLOAT3(-width / 2, 0.0f, depth / 2);
-    vertices[1].Normal = n;
-    vertices[1].Color = XMFLOAT4(0.5f, 0.5f, 0.5f, 1.0f);
-
-    vertices[2].Pos = XMFLOAT3(width / 2, 0.0f, depth / 2);
-    vertices[2].Normal = n;
-    vertices[2].Color = XMFLOAT4(0.5f, 0.5f, 0.5f, 1.0f);
-
-    vertices[3].Pos = XMFLOAT3(width / 2, 0.0f, -depth / 2);
-    vertices[3].Normal = n;
-    vertices[3].Color = XMFLOAT4(0.5f, 0.5f, 0.5f, 1.0f);
-
-    indices = { 0, 1, 2, 0, 2, 3 };
-}
-
-// ============================================================================
-// 
-// ============================================================================
-void PrimitiveShape::BuildCube(std::vector<Vertex>& vertices, std::vector<std::uint16_t>& indices)
-{
-    XMFLOAT4 gray(0.5f, 0.5f, 0.5f, 1.0f);
-
-    vertices.clear();
-    vertices.reserve(24);
-
-    indices.clear();
-    indices.reserve(36);
-
-    auto addFace = [&](const XMFLOAT3& desiredN, XMFLOAT3 v0, XMFLOAT3 v1, XMFLOAT3 v2, XMFLOAT3 v3)
-        {
-            // Զ winding Ƿ desiredN һ£һת
-            XMVECTOR p0 = XMLoadFloat3(&v0);
-            XMVECTOR p1 = XMLoadFloat3(&v1);
-            XMVECTOR p2 = XMLoadFloat3(&v2);
-
-            XMVECTOR geomN = XMVector3Normalize(XMVector3Cross(p1 - p0, p2 - p0));
-            XMVECTOR wantN = XMLoadFloat3(&desiredN);
-
-            if (XMVectorGetX(XMVector3Dot(geomN, wantN)) < 0.0f)
-            {
-                // תıΣ v1  v3
-                std::swap(v1, v3);
-            }
-
-            std::uint16_t base = static_cast<std::uint16_t>(vertices.size());
-
-            vertices.push_back(Vertex{ v0, desiredN, gray });
-            vertices.push_back(Vertex{ v1, desiredN, gray });
-            vertices.push_back(Vertex{ v2, desiredN, gray });
-            vertices.push_back(Vertex{ v3, desiredN, gray });
-
-            // 
-            indices.push_back(base + 0);
-            indices.push_back(base + 1);
-            indices.push_back(base + 2);
-
-            indices.push_back(base + 0);
-            indices.push_back(base + 2);
-            indices.push_back(base + 3);
-        };
-
-    // ÿҪⷨߡ + 4 㣨˳豣֤addFace ԶУ
-
-    // +Z
-    addFace(XMFLOAT3(0.0f, 0.0f, 1.0f),
-        XMFLOAT3(-1.0f, -1.0f, 1.0f),
-        XMFLOAT3(-1.0f, 1.0f, 1.0f),
-        XMFLOAT3(1.0f, 1.0f, 1.0f),
-        XMFLOAT3(1.0f, -1.0f, 1.0f));
-
-    // -Z
-    addFace(XMFLOAT3(0.0f, 0.0f, -1.0f),
-        XMFLOAT3(-1.0f, -1.0f, -1.0f),
-        XMFLOAT3(-1.0f, 1.0f, -1.0f),
-        XMFLOAT3(1.0f, 1.0f, -1.0f),
-        XMFLOAT3(1.0f, -1.0f, -1.0f));
-
-    // -X
-    addFace(XMFLOAT3(-1.0f, 0.0f, 0.0f),
-        XMFLOAT3(-1.0f, -1.0f, -1.0f),
-        XMFLOAT3(-1.0f, -1.0f, 1.0f),
-        XMFLOAT3(-1.0f, 1.0f, 1.0f),
-        XMFLOAT3(-1.0f, 1.0f, -1.0f));
-
-    // +X
-    addFace(XMFLOAT3(1.0f, 0.0f, 0.0f),
-        XMFLOAT3(1.0f, -1.0f, -1.0f),
-        XMFLOAT3(1.0f, 1.0f, -1.0f),
-        XMFLOAT3(1.0f, 1.0f, 1.0f),
-        XMFLOAT3(1.0f, -1.0f, 1.0f));
-
-    // +Y
-    addFace(XMFLOAT3(0.0f, 1.0f, 0.0f),
-        XMFLOAT3(-1.0f, 1.0f, -1.0f),
-        XMFLOAT3(-1.0f, 1.0f, 1.0f),
-        XMFLOAT3(1.0f, 1.0f, 1.0f),
-        XMFLOAT3(1.0f, 1.0f, -1.0f));
-
-    // -Y
-    addFace(XMFLOAT3(0.0f, -1.0f, 0.0f),
-        XMFLOAT3(-1.0f, -1.0f, 1.0f),
-        XMFLOAT3(-1.0f, -1.0f, -1.0f),
-        XMFLOAT3(1.0f, -1.0f, -1.0f),
-        XMFLOAT3(1.0f, -1.0f, 1.0f));
-}
-
-// ============================================================================
-// 
-// ============================================================================
-void PrimitiveShape::BuildTetrahedron(std::vector<Vertex>& vertices, std::vector<std::uint16_t>& indices)
-{
-    // ʹԭĶλ
-    const float a = 1.5f;
-    const float h = sqrtf(2.0f / 3.0f) * a;
-
-    XMFLOAT3 p0(0.0f, h, 0.0f);
-    XMFLOAT3 p1(-a / 2, -h / 3, a * sqrtf(3.0f) / 6);
-    XMFLOAT3 p2(a / 2, -h / 3, a * sqrtf(3.0f) / 6);
-    XMFLOAT3 p3(0.0f, -h / 3, -a * sqrtf(3.0f) / 3);
-
-    XMFLOAT4 gray(0.5f, 0.5f, 0.5f, 1.0f);
-
-    vertices.clear();
-    vertices.reserve(12);
-
-    auto faceNormal = [](const XMFLOAT3& a, const XMFLOAT3& b, const XMFLOAT3& c)
-        {
-            XMVECTOR va = XMLoadFloat3(&a);
-            XMVECTOR vb = XMLoadFloat3(&b);
-            XMVECTOR vc = XMLoadFloat3(&c);
-
-            XMVECTOR n = XMVector3Normalize(XMVector3Cross(vb - va, vc - va));
-            XMFLOAT3 out;
-            XMStoreFloat3(&out, n);
-            return out;
-        };
-
-    auto addTri = [&](const XMFLOAT3& a, const XMFLOAT3& b, const XMFLOAT3& c)
-        {
-            XMFLOAT3 n = faceNormal(a, b, c);
-            vertices.push_back(Vertex{ a, n, gray });
-            vertices.push_back(Vertex{ b, n, gray });
-            vertices.push_back(Vertex{ c, n, gray });
-        };
-
-    // 4 棨ȷ winding һ£ĳڣ b/c ɣ
-    addTri(p0, p2, p1);
-    addTri(p0, p1, p3);
-    addTri(p0, p3, p2);
-    addTri(p1, p2, p3);
-
-    indices.clear();
-    indices.reserve(12);
-    for (std::uint16_t i = 0; i < 12; ++i)
-    {
-        indices.push_back(i);
-    }
+    // 上传几何数据到GPU
+    return UploadGeometry(commandList, vertices, indices);
 }
 
 // ============================================================================
-// ϴݵGPU
+// 上传几何数据到GPU
 // ============================================================================
-bool PrimitiveShape::UploadGeometry(ID3D12Device* device,
-    ID3D12GraphicsCommandList* commandList,
+bool PrimitiveShape::UploadGeometry(IGraphicsCommandList& commandList,
     const std::vector<Vertex>& vertices,
     const std::vector<std::uint16_t>& indices)
 {
     m_vertexByteStride = sizeof(Vertex);
-    m_vertexBufferByteSize = (UINT)vertices.size() * sizeof(Vertex);
-    m_indexFormat = DXGI_FORMAT_R16_UINT;
-    m_indexBufferByteSize = (UINT)indices.size() * sizeof(std::uint16_t);
-    m_indexCount = (UINT)indices.size();
+    m_vertexBufferByteSize = (uint32_t)vertices.size() * sizeof(Vertex);
+    m_indexSize = sizeof(std::uint16_t);
+    m_indexBufferByteSize = (uint32_t)indices.size() * sizeof(std::uint16_t);
+    m_indexCount = (uint32_t)indices.size();
 
-    // Ĭ϶ѣGPUרãĶ㻺
-    CD3DX12_HEAP_PROPERTIES defaultHeapProps(D3D12_HEAP_TYPE_DEFAULT);
-    CD3DX12_RESOURCE_DESC vertexBufferDesc = CD3DX12_RESOURCE_DESC::Buffer(m_vertexBufferByteSize);
-
-    if (FAILED(device->CreateCommittedResource(
-        &defaultHeapProps,
-        D3D12_HEAP_FLAG_NONE,
-        &vertexBufferDesc,
-        D3D12_RESOURCE_STATE_COMMON,
-        nullptr,
-        IID_PPV_ARGS(&m_vertexBufferGPU))))
-    {
-        return false;
-    }
-
-    // ϴѵĶ㻺
-    CD3DX12_HEAP_PROPERTIES uploadHeapProps(D3D12_HEAP_TYPE_UPLOAD);
-
-    if (FAILED(device->CreateCommittedResource(
-        &uploadHeapProps,
-        D3D12_HEAP_FLAG_NONE,
-        &vertexBufferDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&m_vertexBufferUploader))))
+    // 默认堆（GPU专用）的顶点/索引缓冲区，以及上传堆中的中转缓冲区
+    if (!m_backend->CreateBuffer(m_vertexBufferByteSize, GpuMemory::Default, m_vertexBufferGPU) ||
+        !m_backend->CreateBuffer(m_vertexBufferByteSize, GpuMemory::Upload, m_vertexBufferUploader) ||
+        !m_backend->CreateBuffer(m_indexBufferByteSize, GpuMemory::Default, m_indexBufferGPU) ||
+        !m_backend->CreateBuffer(m_indexBufferByteSize, GpuMemory::Upload, m_indexBufferUploader))
     {
         return false;
     }
 
-    // Ĭ϶ѵ
-    CD3DX12_RESOURCE_DESC indexBufferDesc = CD3DX12_RESOURCE_DESC::Buffer(m_indexBufferByteSize);
-
-    if (FAILED(device->CreateCommittedResource(
-        &defaultHeapProps,
-        D3D12_HEAP_FLAG_NONE,
-        &indexBufferDesc,
-        D3D12_RESOURCE_STATE_COMMON,
-        nullptr,
-        IID_PPV_ARGS(&m_indexBufferGPU))))
-    {
-        return false;
-    }
+    // 两个缓冲的状态转换由渲染图合并：复制前一次、复制后一次
+    RenderGraph graph;
+    RGResource vertexBuffer = graph.Import("VertexBuffer",
+        ResourceState::Common, ResourceState::GenericRead, reinterpret_cast<void*>(m_vertexBufferGPU.Handle));
+    RGResource indexBuffer = graph.Import("IndexBuffer",
+        ResourceState::Common, ResourceState::GenericRead, reinterpret_cast<void*>(m_indexBufferGPU.Handle));
 
-    // ϴѵ
-    if (FAILED(device->CreateCommittedResource(
-        &uploadHeapProps,
-        D3D12_HEAP_FLAG_NONE,
-        &indexBufferDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&m_indexBufferUploader))))
+    uint32_t upload = graph.AddPass("Upload", [&]()
     {
-        return false;
-    }
-
-    // ݸƵϴ
-    D3D12_SUBRESOURCE_DATA vertexData = {};
-    vertexData.pData = vertices.data();
-    vertexData.RowPitch = m_vertexBufferByteSize;
-    vertexData.SlicePitch = vertexData.RowPitch;
-
-    // תԴ״̬
-    CD3DX12_RESOURCE_BARRIER vertexBarrier1 = CD3DX12_RESOURCE_BARRIER::Transition(
-        m_vertexBufferGPU.Get(),
-        D3D12_RESOURCE_STATE_COMMON,
-        D3D12_RESOURCE_STATE_COPY_DEST
-    );
-    commandList->ResourceBarrier(1, &vertexBarrier1);
-
-    // ʹøԴ
-    BYTE* pVertexDataBegin;
-    CD3DX12_RANGE readRange(0, 0);
-    m_vertexBufferUploader->Map(0, &readRange, reinterpret_cast<void**>(&pVertexDataBegin));
-    memcpy(pVertexDataBegin, vertices.data(), m_vertexBufferByteSize);
-    m_vertexBufferUploader->Unmap(0, nullptr);
-
-    commandList->CopyBufferRegion(m_vertexBufferGPU.Get(), 0, m_vertexBufferUploader.Get(), 0, m_vertexBufferByteSize);
-
-    CD3DX12_RESOURCE_BARRIER vertexBarrier2 = CD3DX12_RESOURCE_BARRIER::Transition(
-        m_vertexBufferGPU.Get(),
-        D3D12_RESOURCE_STATE_COPY_DEST,
-        D3D12_RESOURCE_STATE_GENERIC_READ
-    );
-    commandList->ResourceBarrier(1, &vertexBarrier2);
+        // 将顶点、索引数据复制到上传堆（已映射），再复制到默认堆
+        memcpy(m_vertexBufferUploader.Cpu, vertices.data(), m_vertexBufferByteSize);
+        commandList.CopyBuffer(m_vertexBufferGPU, 0, m_vertexBufferUploader, 0, m_vertexBufferByteSize);
 
-    // ݸƵϴ
-    D3D12_SUBRESOURCE_DATA indexData = {};
-    indexData.pData = indices.data();
-    indexData.RowPitch = m_indexBufferByteSize;
-    indexData.SlicePitch = indexData.RowPitch;
+        memcpy(m_indexBufferUploader.Cpu, indices.data(), m_indexBufferByteSize);
+        commandList.CopyBuffer(m_indexBufferGPU, 0, m_indexBufferUploader, 0, m_indexBufferByteSize);
+    });
+    graph.Write(upload, vertexBuffer, ResourceState::CopyDest, true);
+    graph.Write(upload, indexBuffer, ResourceState::CopyDest, true);
+    graph.Compile();
 
-    CD3DX12_RESOURCE_BARRIER indexBarrier1 = CD3DX12_RESOURCE_BARRIER::Transition(
-        m_indexBufferGPU.Get(),
-        D3D12_RESOURCE_STATE_COMMON,
-        D3D12_RESOURCE_STATE_COPY_DEST
-    );
-    commandList->ResourceBarrier(1, &indexBarrier1);
-
-    BYTE* pIndexDataBegin;
-    m_indexBufferUploader->Map(0, &readRange, reinterpret_cast<void**>(&pIndexDataBegin));
-    memcpy(pIndexDataBegin, indices.data(), m_indexBufferByteSize);
-    m_indexBufferUploader->Unmap(0, nullptr);
-
-    commandList->CopyBufferRegion(m_indexBufferGPU.Get(), 0, m_indexBufferUploader.Get(), 0, m_indexBufferByteSize);
-
-    CD3DX12_RESOURCE_BARRIER indexBarrier2 = CD3DX12_RESOURCE_BARRIER::Transition(
-        m_indexBufferGPU.Get(),
-        D3D12_RESOURCE_STATE_COPY_DEST,
-        D3D12_RESOURCE_STATE_GENERIC_READ
-    );
-    commandList->ResourceBarrier(1, &indexBarrier2);
+    // 命令列表本身就是屏障提交端
+    graph.Execute(commandList);
+    graph.SubmitFinalBarriers(commandList);
 
     return true;
 }
 
 // ============================================================================
-// ȡ㻺ͼ
+// 获取顶点缓冲区视图
 // ============================================================================
-D3D12_VERTEX_BUFFER_VIEW PrimitiveShape::GetVertexBufferView() const
+GpuVertexBufferView PrimitiveShape::GetVertexBufferView() const
 {
-    D3D12_VERTEX_BUFFER_VIEW vbv;
-    vbv.BufferLocation = m_vertexBufferGPU->GetGPUVirtualAddress();
+    GpuVertexBufferView vbv;
+    vbv.Address = m_vertexBufferGPU.Address;
     vbv.StrideInBytes = m_vertexByteStride;
     vbv.SizeInBytes = m_vertexBufferByteSize;
     return vbv;
 }
 
 // ============================================================================
-// ȡͼ
+// 获取索引缓冲区视图
 // ============================================================================
-D3D12_INDEX_BUFFER_VIEW PrimitiveShape::GetIndexBufferView() const
+GpuIndexBufferView PrimitiveShape::GetIndexBufferView() const
 {
-    D3D12_INDEX_BUFFER_VIEW ibv;
-    ibv.BufferLocation = m_indexBufferGPU->GetGPUVirtualAddress();
-    ibv.Format = m_indexFormat;
+    GpuIndexBufferView ibv;
+    ibv.Address = m_indexBufferGPU.Address;
+    ibv.IndexSize = m_indexSize;
     ibv.SizeInBytes = m_indexBufferByteSize;
     return ibv;
 }
 
 // ============================================================================
-// ͷϴ
+// 释放上传缓冲区
 // ============================================================================
 void PrimitiveShape::DisposeUploaders()
 {
-    m_vertexBufferUploader.Reset();
-    m_indexBufferUploader.Reset();
+    DestroyBuffer(m_vertexBufferUploader);
+    DestroyBuffer(m_indexBufferUploader);
+}
+
+void PrimitiveShape::DestroyBuffer(GpuBuffer& buffer)
+{
+    if (m_backend && buffer.Handle != NullGpuHandle)
+    {
+        m_backend->DestroyBuffer(buffer);
+    }
+    buffer = GpuBuffer{};
 }
\ No newline at end of file
@@ -1,76 +1,73 @@
 #pragma once
-#include <wrl/client.h>
-#include <d3d12.h>
 #include <DirectXMath.h>
 #include <vector>
 #include <cstdint>
-#include "d3dx12.h"
+#include "GraphicsBackend.h"
+#include "ShapeGeometry.h"
 
-using Microsoft::WRL::ComPtr;
-
-// ṹ D3DManager.h еĶͬ
-struct Vertex;
-
-// 
+// 几何体数据类
 class PrimitiveShape
 {
 public:
     PrimitiveShape();
     ~PrimitiveShape();
 
-    // ʼָ͵״
-    bool Initialize(ID3D12Device* device,
-        ID3D12GraphicsCommandList* commandList,
-        int shapeType);
+    PrimitiveShape(const PrimitiveShape&) = delete;
+    PrimitiveShape& operator=(const PrimitiveShape&) = delete;
 
-    // ȡ㻺ͼ
-    D3D12_VERTEX_BUFFER_VIEW GetVertexBufferView() const;
+    // 初始化指定类型的形状；backend 必须比形状活得久（缓冲在析构时通过它释放）
+    bool Initialize(IGraphicsBackend& backend,
+        IGraphicsCommandList& commandList,
+        int shapeType);
 
-    // ȡͼ
-    D3D12_INDEX_BUFFER_VIEW GetIndexBufferView() const;
+    // 获取顶点缓冲区视图
+    GpuVertexBufferView GetVertexBufferView() const;
 
-    // ȡ
-    UINT GetIndexCount() const { return m_indexCount; }
+    // 获取索引缓冲区视图
+    GpuIndexBufferView GetIndexBufferView() const;
 
-    // ͷϴGPUɺã
-    void DisposeUploaders();
+    // 获取索引数量
+    uint32_t GetIndexCount() const { return m_indexCount; }
 
-private:
-    // GPU Դ
-    ComPtr<ID3D12Resource> m_vertexBufferGPU;
-    ComPtr<ID3D12Resource> m_indexBufferGPU;
+    // CPU 端几何副本（软件遮挡剔除等使用）
+    const std::vector<DirectX::XMFLOAT3>& GetCpuPositions() const { return m_cpuPositions; }
+    const std::vector<std::uint16_t>& GetCpuIndices() const { return m_cpuIndices; }
 
-    // ϴѣʱݴ䣩
-    ComPtr<ID3D12Resource> m_vertexBufferUploader;
-    ComPtr<ID3D12Resource> m_indexBufferUploader;
+    // 模型空间包围盒
+    const DirectX::XMFLOAT3& GetLocalMin() const { return m_localMin; }
+    const DirectX::XMFLOAT3& GetLocalMax() const { return m_localMax; }
 
-    // 
-    UINT m_vertexByteStride = 0;
-    UINT m_vertexBufferByteSize = 0;
-    DXGI_FORMAT m_indexFormat = DXGI_FORMAT_R16_UINT;
-    UINT m_indexBufferByteSize = 0;
-    UINT m_indexCount = 0;
+    // 释放上传缓冲区（在GPU复制完成后调用）
+    void DisposeUploaders();
 
 private:
-    // ɺ
-    void BuildSphere(std::vector<Vertex>& vertices,
-        std::vector<std::uint16_t>& indices);
+    IGraphicsBackend* m_backend = nullptr;
 
-    void BuildCylinder(std::vector<Vertex>& vertices,
-        std::vector<std::uint16_t>& indices);
+    // GPU 资源
+    GpuBuffer m_vertexBufferGPU;
+    GpuBuffer m_indexBufferGPU;
 
-    void BuildPlane(std::vector<Vertex>& vertices,
-        std::vector<std::uint16_t>& indices);
+    // 上传堆（临时用于数据传输）
+    GpuBuffer m_vertexBufferUploader;
+    GpuBuffer m_indexBufferUploader;
 
-    void BuildCube(std::vector<Vertex>& vertices,
-        std::vector<std::uint16_t>& indices);
+    // 缓冲区属性
+    uint32_t m_vertexByteStride = 0;
+    uint32_t m_vertexBufferByteSize = 0;
+    uint32_t m_indexSize = sizeof(std::uint16_t);
+    uint32_t m_indexBufferByteSize = 0;
+    uint32_t m_indexCount = 0;
 
-    void BuildTetrahedron(std::vector<Vertex>& vertices,
-        std::vector<std::uint16_t>& indices);
+    // CPU 端几何副本
+    std::vector<DirectX::XMFLOAT3> m_cpuPositions;
+    std::vector<std::uint16_t> m_cpuIndices;
+    DirectX::XMFLOAT3 m_localMin = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+    DirectX::XMFLOAT3 m_localMax = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
 
-    // ϴݵGPU
-    bool UploadGeometry(ID3D12Device* device,
-        ID3D12GraphicsCommandList* commandList,
+private:
+    // 上传几何数据到GPU
+    bool UploadGeometry(IGraphicsCommandList& commandList,
         const std::vector<Vertex>& vertices,
         const std::vector<std::uint16_t>& indices);
+    void DestroyBuffer(GpuBuffer& buffer);
 };
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "RenderCommandQueue.h"
+#include <thread>
+
+// ============================================================================
+// 构造
+// ============================================================================
+RenderCommandQueue::RenderCommandQueue(size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+
+    m_slots.reset(new Slot[size]);
+    m_mask = size - 1;
+    for (size_t i = 0; i < size; ++i)
+    {
+        m_slots[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+// ============================================================================
+// 入队
+// ============================================================================
+bool RenderCommandQueue::TryPush(Command command)
+{
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot& slot = m_slots[pos & m_mask];
+        size_t seq = slot.Sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0)
+        {
+            // 槽位空闲：抢占这个位置
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                slot.Payload = std::move(command);
+                slot.Sequence.store(pos + 1, std::memory_order_release);
+                m_pushedCount.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // 消费者还没取走上一圈的命令：队列满
+            return false;
+        }
+        else
+        {
+            // 其他生产者已经占用，重新读取位置
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void RenderCommandQueue::Push(Command command)
+{
+    while (!TryPush(command))
+    {
+        std::this_thread::yield();
+    }
+}
+
+// ============================================================================
+// 出队
+// ============================================================================
+bool RenderCommandQueue::TryPop(Command& out)
+{
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    Slot& slot = m_slots[pos & m_mask];
+    size_t seq = slot.Sequence.load(std::memory_order_acquire);
+    if ((intptr_t)seq - (intptr_t)(pos + 1) < 0)
+    {
+        return false;
+    }
+
+    // 单消费者：位置只由本线程推进
+    out = std::move(slot.Payload);
+    slot.Payload = nullptr;
+    m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    slot.Sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+}
+
+size_t RenderCommandQueue::Drain()
+{
+    size_t count = 0;
+    Command command;
+    while (TryPop(command))
+    {
+        if (command)
+        {
+            command();
+        }
+        command = nullptr;
+        ++count;
+    }
+    return count;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// 有界无锁命令队列（多生产者/单消费者）：UI 线程投递编辑命令，渲染线程在帧开始时统一执行。
+// 每个槽位带序号，生产者与消费者各自只推进自己的位置，不需要互斥锁。
+class RenderCommandQueue
+{
+public:
+    using Command = std::function<void()>;
+
+    // 容量向上取整到 2 的幂
+    explicit RenderCommandQueue(size_t capacity = 4096);
+
+    RenderCommandQueue(const RenderCommandQueue&) = delete;
+    RenderCommandQueue& operator=(const RenderCommandQueue&) = delete;
+
+    // 队列满时返回 false
+    bool TryPush(Command command);
+    // 队列满时让出时间片重试，直到放入为止（消费者线程自身不要调用）
+    void Push(Command command);
+
+    // 仅消费者线程调用
+    bool TryPop(Command& out);
+    // 依次执行当前可取出的命令，返回执行数
+    size_t Drain();
+
+    size_t GetCapacity() const { return m_mask + 1; }
+    // 累计成功入队的命令数
+    uint64_t GetPushedCount() const { return m_pushedCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> Sequence;
+        Command Payload;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask = 0;
+
+    // 生产者与消费者的位置放在不同缓存行，避免伪共享
+    alignas(64) std::atomic<size_t> m_enqueuePos{ 0 };
+    alignas(64) std::atomic<size_t> m_dequeuePos{ 0 };
+    std::atomic<uint64_t> m_pushedCount{ 0 };
+};
@@ -0,0 +1,523 @@
+#include "RenderGraph.h"
+#include <algorithm>
+
+namespace
+{
+    const uint32_t NoPass = 0xFFFFFFFFu;
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    std::string StateName(uint32_t state)
+    {
+        static const struct { uint32_t Bit; const char* Name; } names[] =
+        {
+            { ResourceState::VertexAndConstantBuffer, "VertexAndConstantBuffer" },
+            { ResourceState::IndexBuffer, "IndexBuffer" },
+            { ResourceState::RenderTarget, "RenderTarget" },
+            { ResourceState::UnorderedAccess, "UnorderedAccess" },
+            { ResourceState::DepthWrite, "DepthWrite" },
+            { ResourceState::DepthRead, "DepthRead" },
+            { ResourceState::NonPixelShaderResource, "NonPixelShaderResource" },
+            { ResourceState::PixelShaderResource, "PixelShaderResource" },
+            { ResourceState::IndirectArgument, "IndirectArgument" },
+            { ResourceState::CopyDest, "CopyDest" },
+            { ResourceState::CopySource, "CopySource" },
+        };
+
+        if (state == ResourceState::Common)
+        {
+            return "Common";
+        }
+
+        std::string text;
+        for (const auto& entry : names)
+        {
+            if (state & entry.Bit)
+            {
+                if (!text.empty())
+                {
+                    text += "|";
+                }
+                text += entry.Name;
+            }
+        }
+        return text;
+    }
+}
+
+void RenderGraph::Reset()
+{
+    m_passes.clear();
+    m_resources.clear();
+    m_finalBarriers.clear();
+    m_transientHeapSize = 0;
+}
+
+// ============================================================================
+// 声明
+// ============================================================================
+RGResource RenderGraph::Import(const char* name, uint32_t initialState, uint32_t finalState, void* userHandle)
+{
+    Resource resource;
+    resource.Name = name;
+    resource.Imported = true;
+    resource.InitialState = initialState;
+    resource.FinalState = finalState;
+    resource.UserHandle = userHandle;
+    m_resources.push_back(resource);
+    return (RGResource)(m_resources.size() - 1);
+}
+
+RGResource RenderGraph::CreateTransient(const char* name, uint64_t size, uint64_t alignment)
+{
+    Resource resource;
+    resource.Name = name;
+    resource.Size = size;
+    resource.Alignment = alignment > 0 ? alignment : 1;
+    m_resources.push_back(resource);
+    return (RGResource)(m_resources.size() - 1);
+}
+
+uint32_t RenderGraph::AddPass(const char* name, PassFn execute)
+{
+    Pass pass;
+    pass.Name = name;
+    pass.Execute = std::move(execute);
+    m_passes.push_back(std::move(pass));
+    return (uint32_t)(m_passes.size() - 1);
+}
+
+void RenderGraph::Read(uint32_t pass, RGResource resource, uint32_t state)
+{
+    m_passes[pass].Accesses.push_back({ resource, state, false, false });
+}
+
+void RenderGraph::Write(uint32_t pass, RGResource resource, uint32_t state, bool discard)
+{
+    m_passes[pass].Accesses.push_back({ resource, state, true, discard });
+}
+
+void RenderGraph::SetSideEffects(uint32_t pass)
+{
+    m_passes[pass].SideEffects = true;
+}
+
+// ============================================================================
+// 编译
+// ============================================================================
+bool RenderGraph::ResolvePassState(const Pass& pass, RGResource resource, uint32_t& state, bool& write) const
+{
+    uint32_t readState = 0;
+    uint32_t writeState = 0;
+    bool hasRead = false;
+    write = false;
+
+    for (const Access& access : pass.Accesses)
+    {
+        if (access.Resource != resource)
+        {
+            continue;
+        }
+        if (access.Write)
+        {
+            if (write && writeState != access.State)
+            {
+                return false;
+            }
+            write = true;
+            writeState = access.State;
+        }
+        else
+        {
+            hasRead = true;
+            readState |= access.State;
+        }
+    }
+
+    if (!write)
+    {
+        state = readState;
+        return true;
+    }
+
+    // 同时读写：只允许读状态被写状态覆盖（UAV 读写、深度写时的深度测试）
+    if (hasRead && readState != writeState &&
+        !(writeState == ResourceState::DepthWrite && readState == ResourceState::DepthRead))
+    {
+        return false;
+    }
+    state = writeState;
+    return true;
+}
+
+void RenderGraph::CullPasses()
+{
+    // 从后往前：写了“之后还需要”的资源的 pass 才保留，保留的 pass 所读的资源之前也需要
+    std::vector<bool> needed(m_resources.size(), false);
+    for (size_t r = 0; r < m_resources.size(); ++r)
+    {
+        needed[r] = m_resources[r].Imported;
+    }
+
+    for (size_t p = m_passes.size(); p-- > 0;)
+    {
+        Pass& pass = m_passes[p];
+        bool live = pass.SideEffects;
+        for (const Access& access : pass.Accesses)
+        {
+            if (access.Write && needed[access.Resource])
+            {
+                live = true;
+            }
+        }
+
+        pass.Culled = !live;
+        if (!live)
+        {
+            continue;
+        }
+
+        // 整块覆盖的写让之前的内容变得无用；读与保留内容的写则需要之前的内容
+        for (const Access& access : pass.Accesses)
+        {
+            if (access.Write && access.Discard)
+            {
+                needed[access.Resource] = false;
+            }
+        }
+        for (const Access& access : pass.Accesses)
+        {
+            if (!access.Write || !access.Discard)
+            {
+                needed[access.Resource] = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::PlaceTransients()
+{
+    std::vector<RGResource> order;
+    for (RGResource r = 0; r < (RGResource)m_resources.size(); ++r)
+    {
+        Resource& resource = m_resources[r];
+        resource.HeapOffset = 0;
+        if (!resource.Imported && resource.FirstPass != NoPass)
+        {
+            order.push_back(r);
+        }
+    }
+
+    // 从大到小放置，每个资源取与它生命周期重叠的已放置资源都不冲突的最低偏移
+    std::sort(order.begin(), order.end(), [this](RGResource a, RGResource b)
+    {
+        if (m_resources[a].Size != m_resources[b].Size)
+        {
+            return m_resources[a].Size > m_resources[b].Size;
+        }
+        return a < b;
+    });
+
+    std::vector<RGResource> placed;
+    for (RGResource r : order)
+    {
+        Resource& resource = m_resources[r];
+
+        std::vector<uint64_t> candidates(1, 0);
+        for (RGResource other : placed)
+        {
+            const Resource& o = m_resources[other];
+            if (o.FirstPass <= resource.LastPass && resource.FirstPass <= o.LastPass)
+            {
+                candidates.push_back(AlignUp(o.HeapOffset + o.Size, resource.Alignment));
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (uint64_t offset : candidates)
+        {
+            bool fits = true;
+            for (RGResource other : placed)
+            {
+                const Resource& o = m_resources[other];
+                bool timeOverlap = o.FirstPass <= resource.LastPass && resource.FirstPass <= o.LastPass;
+                bool memoryOverlap = offset < o.HeapOffset + o.Size && o.HeapOffset < offset + resource.Size;
+                if (timeOverlap && memoryOverlap)
+                {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits)
+            {
+                resource.HeapOffset = offset;
+                break;
+            }
+        }
+
+        m_transientHeapSize = std::max(m_transientHeapSize, resource.HeapOffset + resource.Size);
+        placed.push_back(r);
+    }
+}
+
+bool RenderGraph::Compile()
+{
+    m_finalBarriers.clear();
+    m_transientHeapSize = 0;
+    for (Pass& pass : m_passes)
+    {
+        pass.Barriers.clear();
+    }
+    for (Resource& resource : m_resources)
+    {
+        resource.FirstPass = NoPass;
+        resource.LastPass = 0;
+    }
+
+    CullPasses();
+
+    // 每个保留的 pass 对每个资源合并成一个（状态，是否写）
+    struct Use
+    {
+        uint32_t Pass;
+        uint32_t State;
+        bool Write;
+    };
+    std::vector<std::vector<Use>> uses(m_resources.size());
+    for (uint32_t p = 0; p < (uint32_t)m_passes.size(); ++p)
+    {
+        const Pass& pass = m_passes[p];
+        if (pass.Culled)
+        {
+            continue;
+        }
+        for (const Access& access : pass.Accesses)
+        {
+            std::vector<Use>& list = uses[access.Resource];
+            if (!list.empty() && list.back().Pass == p)
+            {
+                continue;
+            }
+
+            Use use{ p, 0, false };
+            if (!ResolvePassState(pass, access.Resource, use.State, use.Write))
+            {
+                return false;
+            }
+            list.push_back(use);
+
+            Resource& resource = m_resources[access.Resource];
+            resource.FirstPass = std::min(resource.FirstPass, p);
+            resource.LastPass = std::max(resource.LastPass, p);
+        }
+    }
+
+    PlaceTransients();
+
+    for (RGResource r = 0; r < (RGResource)m_resources.size(); ++r)
+    {
+        Resource& resource = m_resources[r];
+        const std::vector<Use>& list = uses[r];
+        uint32_t current = resource.InitialState;
+        bool lastWasUavWrite = false;
+        bool lastWasUavRead = false;
+
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            const Use& use = list[i];
+            std::vector<RGBarrier>& barriers = m_passes[use.Pass].Barriers;
+
+            // 连续的只读使用合并：第一次读就转换到之后所有读者状态的并集（UAV、Common 等不能组合的读不参与）
+            uint32_t target = use.State;
+            if (!use.Write && ResourceState::IsReadOnly(use.State))
+            {
+                for (size_t j = i + 1; j < list.size() && !list[j].Write && ResourceState::IsReadOnly(list[j].State); ++j)
+                {
+                    target |= list[j].State;
+                }
+            }
+
+            if (!resource.Imported && i == 0)
+            {
+                // 临时资源按首次使用的状态创建；与之前使用同一块内存的资源之间需要别名屏障
+                resource.InitialState = target;
+                current = target;
+
+                RGResource before = InvalidRGResource;
+                uint32_t beforeLast = 0;
+                for (RGResource o = 0; o < (RGResource)m_resources.size(); ++o)
+                {
+                    const Resource& other = m_resources[o];
+                    if (o == r || other.Imported || other.FirstPass == NoPass || other.LastPass >= resource.FirstPass)
+                    {
+                        continue;
+                    }
+                    bool memoryOverlap = resource.HeapOffset < other.HeapOffset + other.Size &&
+                        other.HeapOffset < resource.HeapOffset + resource.Size;
+                    if (memoryOverlap && (before == InvalidRGResource || other.LastPass >= beforeLast))
+                    {
+                        before = o;
+                        beforeLast = other.LastPass;
+                    }
+                }
+                if (before != InvalidRGResource)
+                {
+                    RGBarrier barrier;
+                    barrier.Type = RGBarrier::Aliasing;
+                    barrier.Resource = r;
+                    barrier.AliasBefore = before;
+                    barriers.push_back(barrier);
+                }
+            }
+            else if (use.Write)
+            {
+                if (current != use.State)
+                {
+                    RGBarrier barrier;
+                    barrier.Resource = r;
+                    barrier.Before = current;
+                    barrier.After = use.State;
+                    barriers.push_back(barrier);
+                    current = use.State;
+                }
+                else if (use.State == ResourceState::UnorderedAccess && (lastWasUavWrite || lastWasUavRead))
+                {
+                    // 写之前的 UAV 读写都要完成
+                    RGBarrier barrier;
+                    barrier.Type = RGBarrier::UnorderedAccess;
+                    barrier.Resource = r;
+                    barriers.push_back(barrier);
+                }
+            }
+            else if (current == target || (ResourceState::IsReadOnly(current) && (current & use.State) == use.State))
+            {
+                // 已处于需要的状态：不转换，只有 UAV 写之后的 UAV 读需要等写完成
+                if (use.State == ResourceState::UnorderedAccess && lastWasUavWrite)
+                {
+                    RGBarrier barrier;
+                    barrier.Type = RGBarrier::UnorderedAccess;
+                    barrier.Resource = r;
+                    barriers.push_back(barrier);
+                }
+            }
+            else
+            {
+                RGBarrier barrier;
+                barrier.Resource = r;
+                barrier.Before = current;
+                barrier.After = target;
+                barriers.push_back(barrier);
+                current = target;
+            }
+
+            lastWasUavWrite = use.Write && use.State == ResourceState::UnorderedAccess;
+            lastWasUavRead = !use.Write && use.State == ResourceState::UnorderedAccess;
+        }
+
+        if (resource.Imported && current != resource.FinalState)
+        {
+            RGBarrier barrier;
+            barrier.Resource = r;
+            barrier.Before = current;
+            barrier.After = resource.FinalState;
+            m_finalBarriers.push_back(barrier);
+        }
+    }
+
+    // 别名屏障排在同一 pass 的状态转换之前
+    for (Pass& pass : m_passes)
+    {
+        std::stable_sort(pass.Barriers.begin(), pass.Barriers.end(), [](const RGBarrier& a, const RGBarrier& b)
+        {
+            return a.Type == RGBarrier::Aliasing && b.Type != RGBarrier::Aliasing;
+        });
+    }
+    return true;
+}
+
+// ============================================================================
+// 执行
+// ============================================================================
+void RenderGraph::Execute(IRenderGraphBarrierSink& sink) const
+{
+    for (const Pass& pass : m_passes)
+    {
+        if (pass.Culled)
+        {
+            continue;
+        }
+        if (!pass.Barriers.empty())
+        {
+            sink.Submit(*this, pass.Barriers.data(), pass.Barriers.size());
+        }
+        if (pass.Execute)
+        {
+            pass.Execute();
+        }
+    }
+}
+
+void RenderGraph::SubmitFinalBarriers(IRenderGraphBarrierSink& sink) const
+{
+    if (!m_finalBarriers.empty())
+    {
+        sink.Submit(*this, m_finalBarriers.data(), m_finalBarriers.size());
+    }
+}
+
+size_t RenderGraph::GetBarrierCount() const
+{
+    size_t count = m_finalBarriers.size();
+    for (const Pass& pass : m_passes)
+    {
+        count += pass.Barriers.size();
+    }
+    return count;
+}
+
+std::string RenderGraph::Describe() const
+{
+    std::string text;
+    auto describeBarriers = [this, &text](const std::vector<RGBarrier>& barriers)
+    {
+        for (const RGBarrier& barrier : barriers)
+        {
+            const std::string& name = m_resources[barrier.Resource].Name;
+            switch (barrier.Type)
+            {
+            case RGBarrier::Transition:
+                text += "  transition " + name + " " + StateName(barrier.Before) + " -> " + StateName(barrier.After) + "\n";
+                break;
+            case RGBarrier::Aliasing:
+                text += "  aliasing " + (barrier.AliasBefore != InvalidRGResource ? m_resources[barrier.AliasBefore].Name : std::string("*")) +
+                    " -> " + name + "\n";
+                break;
+            case RGBarrier::UnorderedAccess:
+                text += "  uav " + name + "\n";
+                break;
+            }
+        }
+    };
+
+    for (const Pass& pass : m_passes)
+    {
+        text += "pass " + pass.Name + (pass.Culled ? " (culled)\n" : "\n");
+        describeBarriers(pass.Barriers);
+    }
+    text += "final\n";
+    describeBarriers(m_finalBarriers);
+
+    text += "transient heap " + std::to_string(m_transientHeapSize) + "\n";
+    for (const Resource& resource : m_resources)
+    {
+        if (!resource.Imported && resource.FirstPass != NoPass)
+        {
+            text += "  " + resource.Name + " offset " + std::to_string(resource.HeapOffset) +
+                " size " + std::to_string(resource.Size) + " initial " + StateName(resource.InitialState) + "\n";
+        }
+    }
+    return text;
+}
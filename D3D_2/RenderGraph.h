@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 资源状态位，取值与 D3D12_RESOURCE_STATES 相同，D3D12 端可以直接强转
+namespace ResourceState
+{
+    const uint32_t Common = 0;
+    const uint32_t Present = 0;
+    const uint32_t VertexAndConstantBuffer = 0x1;
+    const uint32_t IndexBuffer = 0x2;
+    const uint32_t RenderTarget = 0x4;
+    const uint32_t UnorderedAccess = 0x8;
+    const uint32_t DepthWrite = 0x10;
+    const uint32_t DepthRead = 0x20;
+    const uint32_t NonPixelShaderResource = 0x40;
+    const uint32_t PixelShaderResource = 0x80;
+    const uint32_t IndirectArgument = 0x200;
+    const uint32_t CopyDest = 0x400;
+    const uint32_t CopySource = 0x800;
+
+    // 只读状态可以按位组合成一个状态同时满足多个读者
+    const uint32_t ReadOnlyMask = VertexAndConstantBuffer | IndexBuffer | DepthRead |
+        NonPixelShaderResource | PixelShaderResource | IndirectArgument | CopySource;
+    const uint32_t GenericRead = VertexAndConstantBuffer | IndexBuffer |
+        NonPixelShaderResource | PixelShaderResource | IndirectArgument | CopySource;
+
+    inline bool IsReadOnly(uint32_t state) { return state != Common && (state & ~ReadOnlyMask) == 0; }
+}
+
+typedef uint32_t RGResource;
+const RGResource InvalidRGResource = 0xFFFFFFFFu;
+
+struct RGBarrier
+{
+    enum Kind
+    {
+        Transition,
+        Aliasing,       // Before 为同一块内存上一个使用者（可能为 InvalidRGResource），Resource 为新使用者
+        UnorderedAccess // 同一资源前后两次 UAV 访问之间的依赖（写后读、写后写、读后写）
+    };
+
+    Kind Type = Transition;
+    RGResource Resource = InvalidRGResource;
+    RGResource AliasBefore = InvalidRGResource;
+    uint32_t Before = 0;
+    uint32_t After = 0;
+};
+
+class RenderGraph;
+
+// 屏障提交：每个 pass 前的全部屏障一次提交（D3D12 实现见 D3D12BarrierSink）
+class IRenderGraphBarrierSink
+{
+public:
+    virtual ~IRenderGraphBarrierSink() = default;
+    virtual void Submit(const RenderGraph& graph, const RGBarrier* barriers, size_t count) = 0;
+};
+
+// 渲染图：pass 声明对资源的读写，Compile 计算
+//   1. 剔除结果不被任何输出用到的 pass（外部导入资源、带副作用的 pass 视为输出）
+//   2. 每个 pass 前需要的最少状态转换，合并后一次提交；连续的只读使用合并成一个组合读状态
+//   3. 临时资源的生命周期与内存别名：生命周期不重叠的临时资源共用同一段堆内存
+// 图本身是纯 CPU 数据结构，不依赖 D3D12；每帧 Reset 后重新声明。
+class RenderGraph
+{
+public:
+    typedef std::function<void()> PassFn;
+
+    void Reset();
+
+    // 外部资源：图开始时处于 initialState，结束时转换回 finalState；userHandle 由执行端解释（如 ID3D12Resource*）
+    RGResource Import(const char* name, uint32_t initialState, uint32_t finalState, void* userHandle);
+    // 临时资源：只在图内使用，按 size/alignment 分配在共享的临时堆里
+    RGResource CreateTransient(const char* name, uint64_t size, uint64_t alignment);
+
+    uint32_t AddPass(const char* name, PassFn execute);
+    void Read(uint32_t pass, RGResource resource, uint32_t state);
+    // discard 表示整块覆盖，之前的内容不再需要（例如清屏）
+    void Write(uint32_t pass, RGResource resource, uint32_t state, bool discard = false);
+    // 即使没有输出被用到也保留该 pass（例如回读、调试输出）
+    void SetSideEffects(uint32_t pass);
+
+    // 同一 pass 对同一资源要求了互相冲突的状态时返回 false
+    bool Compile();
+
+    // 按顺序对每个保留的 pass：先提交它的屏障，再调用 execute
+    void Execute(IRenderGraphBarrierSink& sink) const;
+    // 把外部资源转换回 finalState
+    void SubmitFinalBarriers(IRenderGraphBarrierSink& sink) const;
+
+    // 编译结果
+    bool IsPassCulled(uint32_t pass) const { return m_passes[pass].Culled; }
+    const std::vector<RGBarrier>& GetPassBarriers(uint32_t pass) const { return m_passes[pass].Barriers; }
+    const std::vector<RGBarrier>& GetFinalBarriers() const { return m_finalBarriers; }
+    uint64_t GetTransientHeapSize() const { return m_transientHeapSize; }
+    uint64_t GetTransientOffset(RGResource resource) const { return m_resources[resource].HeapOffset; }
+    // 临时资源首次使用时的状态，执行端按此状态创建
+    uint32_t GetTransientInitialState(RGResource resource) const { return m_resources[resource].InitialState; }
+    size_t GetBarrierCount() const;
+
+    void* GetUserHandle(RGResource resource) const { return m_resources[resource].UserHandle; }
+    // 执行端为临时资源创建实际对象后回填
+    void SetUserHandle(RGResource resource, void* handle) { m_resources[resource].UserHandle = handle; }
+    const std::string& GetResourceName(RGResource resource) const { return m_resources[resource].Name; }
+    uint32_t GetPassCount() const { return (uint32_t)m_passes.size(); }
+
+    // 编译结果的文本形式（pass、屏障、临时堆布局），用于对照检查
+    std::string Describe() const;
+
+private:
+    struct Access
+    {
+        RGResource Resource;
+        uint32_t State;
+        bool Write;
+        bool Discard;
+    };
+
+    struct Pass
+    {
+        std::string Name;
+        PassFn Execute;
+        std::vector<Access> Accesses;
+        bool SideEffects = false;
+        bool Culled = false;
+        std::vector<RGBarrier> Barriers;
+    };
+
+    struct Resource
+    {
+        std::string Name;
+        bool Imported = false;
+        uint32_t InitialState = 0;
+        uint32_t FinalState = 0;
+        void* UserHandle = nullptr;
+
+        uint64_t Size = 0;
+        uint64_t Alignment = 1;
+        uint64_t HeapOffset = 0;
+        uint32_t FirstPass = 0xFFFFFFFFu;
+        uint32_t LastPass = 0;
+    };
+
+    // 合并同一 pass 对同一资源的多次声明；冲突时返回 false
+    bool ResolvePassState(const Pass& pass, RGResource resource, uint32_t& state, bool& write) const;
+    void CullPasses();
+    void PlaceTransients();
+
+private:
+    std::vector<Pass> m_passes;
+    std::vector<Resource> m_resources;
+    std::vector<RGBarrier> m_finalBarriers;
+    uint64_t m_transientHeapSize = 0;
+};
@@ -0,0 +1,231 @@
+#include "SelfTest.h"
+#include "RenderGraph.h"
+#include <cstdio>
+
+using namespace ResourceState;
+
+// ============================================================================
+// RenderGraph：编译结果与 Describe() 的参考文本逐字比较
+// ============================================================================
+namespace
+{
+    bool MatchesGolden(const RenderGraph& graph, const char* expected)
+    {
+        const std::string text = graph.Describe();
+        if (text == expected)
+        {
+            return true;
+        }
+        printf("  --- Describe()\n%s  --- expected\n%s", text.c_str(), expected);
+        return false;
+    }
+
+    class CountingSink : public IRenderGraphBarrierSink
+    {
+    public:
+        void Submit(const RenderGraph&, const RGBarrier*, size_t count) override
+        {
+            ++Calls;
+            Barriers += count;
+        }
+
+        size_t Calls = 0;
+        size_t Barriers = 0;
+    };
+
+    // 清屏 + 场景：只在第一次写时转换，深度测试读不需要额外转换
+    void TestClearAndScene(SelfTestContext& ctx)
+    {
+        RenderGraph graph;
+        const RGResource backBuffer = graph.Import("BackBuffer", Present, Present, nullptr);
+        const RGResource depth = graph.Import("Depth", DepthWrite, DepthWrite, nullptr);
+        std::vector<int> order;
+        const uint32_t clear = graph.AddPass("Clear", [&] { order.push_back(1); });
+        graph.Write(clear, backBuffer, RenderTarget, true);
+        graph.Write(clear, depth, DepthWrite, true);
+        const uint32_t scene = graph.AddPass("Scene", [&] { order.push_back(2); });
+        graph.Write(scene, backBuffer, RenderTarget);
+        graph.Write(scene, depth, DepthWrite);
+        graph.Read(scene, depth, DepthRead);
+
+        SELF_CHECK(ctx, graph.Compile());
+        SELF_CHECK(ctx, MatchesGolden(graph,
+            "pass Clear\n"
+            "  transition BackBuffer Common -> RenderTarget\n"
+            "pass Scene\n"
+            "final\n"
+            "  transition BackBuffer RenderTarget -> Common\n"
+            "transient heap 0\n"));
+
+        CountingSink sink;
+        graph.Execute(sink);
+        graph.SubmitFinalBarriers(sink);
+        SELF_CHECK(ctx, order == std::vector<int>({ 1, 2 }));
+        SELF_CHECK(ctx, sink.Calls == 2 && sink.Barriers == 2);
+    }
+
+    // 同一 pass 的多个转换一次提交，结束时转回通用读状态
+    void TestUploadBatch(SelfTestContext& ctx)
+    {
+        RenderGraph graph;
+        const RGResource vb = graph.Import("VB", Common, GenericRead, nullptr);
+        const RGResource ib = graph.Import("IB", Common, GenericRead, nullptr);
+        const uint32_t upload = graph.AddPass("Upload", nullptr);
+        graph.Write(upload, vb, CopyDest, true);
+        graph.Write(upload, ib, CopyDest, true);
+
+        SELF_CHECK(ctx, graph.Compile());
+        SELF_CHECK(ctx, MatchesGolden(graph,
+            "pass Upload\n"
+            "  transition VB Common -> CopyDest\n"
+            "  transition IB Common -> CopyDest\n"
+            "final\n"
+            "  transition VB CopyDest -> VertexAndConstantBuffer|IndexBuffer|NonPixelShaderResource|PixelShaderResource|IndirectArgument|CopySource\n"
+            "  transition IB CopyDest -> VertexAndConstantBuffer|IndexBuffer|NonPixelShaderResource|PixelShaderResource|IndirectArgument|CopySource\n"
+            "transient heap 0\n"));
+    }
+
+    // 剔除无输出的 pass、连续读合并成组合读状态、生命周期不重叠的临时资源共用内存
+    void TestCullingAndAliasing(SelfTestContext& ctx)
+    {
+        RenderGraph graph;
+        const RGResource backBuffer = graph.Import("BackBuffer", Present, Present, nullptr);
+        const RGResource gbuffer = graph.CreateTransient("GBuffer", 1000, 256);
+        const RGResource bloom = graph.CreateTransient("Bloom", 500, 256);
+        const RGResource debug = graph.CreateTransient("Debug", 64, 64);
+        const RGResource post = graph.CreateTransient("Post", 800, 256);
+
+        const uint32_t p0 = graph.AddPass("GBuffer", nullptr);
+        graph.Write(p0, gbuffer, RenderTarget, true);
+        const uint32_t p1 = graph.AddPass("Lighting", nullptr);
+        graph.Read(p1, gbuffer, PixelShaderResource);
+        graph.Write(p1, backBuffer, RenderTarget, true);
+        const uint32_t p2 = graph.AddPass("Debug", nullptr);
+        graph.Read(p2, gbuffer, PixelShaderResource);
+        graph.Write(p2, debug, RenderTarget, true);
+        const uint32_t p3 = graph.AddPass("Bloom", nullptr);
+        graph.Read(p3, gbuffer, NonPixelShaderResource);
+        graph.Write(p3, bloom, UnorderedAccess, true);
+        const uint32_t p4 = graph.AddPass("BloomBlur", nullptr);
+        graph.Write(p4, bloom, UnorderedAccess);
+        const uint32_t p5 = graph.AddPass("Post", nullptr);
+        graph.Read(p5, bloom, PixelShaderResource);
+        graph.Write(p5, post, RenderTarget, true);
+        const uint32_t p6 = graph.AddPass("Composite", nullptr);
+        graph.Read(p6, post, PixelShaderResource);
+        graph.Write(p6, backBuffer, RenderTarget);
+
+        SELF_CHECK(ctx, graph.Compile());
+        SELF_CHECK(ctx, graph.IsPassCulled(p2) && !graph.IsPassCulled(p0));
+        SELF_CHECK(ctx, MatchesGolden(graph,
+            "pass GBuffer\n"
+            "pass Lighting\n"
+            "  transition BackBuffer Common -> RenderTarget\n"
+            "  transition GBuffer RenderTarget -> NonPixelShaderResource|PixelShaderResource\n"
+            "pass Debug (culled)\n"
+            "pass Bloom\n"
+            "pass BloomBlur\n"
+            "  uav Bloom\n"
+            "pass Post\n"
+            "  aliasing GBuffer -> Post\n"
+            "  transition Bloom UnorderedAccess -> PixelShaderResource\n"
+            "pass Composite\n"
+            "  transition Post RenderTarget -> PixelShaderResource\n"
+            "final\n"
+            "  transition BackBuffer RenderTarget -> Common\n"
+            "transient heap 1524\n"
+            "  GBuffer offset 0 size 1000 initial RenderTarget\n"
+            "  Bloom offset 1024 size 500 initial UnorderedAccess\n"
+            "  Post offset 0 size 800 initial RenderTarget\n"));
+    }
+
+    // 已处于所需状态的读不产生 X -> X 的转换：UAV 写之后的 UAV 读只要 UAV 屏障，
+    // 连续的 UAV 读之间什么都不要，UAV 读之后的写要等读完成；UAV 不与只读状态组合
+    void TestSameStateReads(SelfTestContext& ctx)
+    {
+        RenderGraph graph;
+        const RGResource particles = graph.Import("Particles", Common, Common, nullptr);
+        const uint32_t clear = graph.AddPass("Clear", nullptr);
+        graph.Write(clear, particles, UnorderedAccess, true);
+        const uint32_t count = graph.AddPass("Count", nullptr);
+        graph.Read(count, particles, UnorderedAccess);
+        graph.SetSideEffects(count);
+        const uint32_t inspect = graph.AddPass("Inspect", nullptr);
+        graph.Read(inspect, particles, UnorderedAccess);
+        graph.SetSideEffects(inspect);
+        const uint32_t simulate = graph.AddPass("Simulate", nullptr);
+        graph.Write(simulate, particles, UnorderedAccess);
+        const uint32_t sort = graph.AddPass("Sort", nullptr);
+        graph.Read(sort, particles, UnorderedAccess);
+        graph.Write(sort, particles, UnorderedAccess);
+        const uint32_t draw = graph.AddPass("Draw", nullptr);
+        graph.Read(draw, particles, NonPixelShaderResource);
+        graph.Read(draw, particles, PixelShaderResource);
+        graph.SetSideEffects(draw);
+
+        SELF_CHECK(ctx, graph.Compile());
+        SELF_CHECK(ctx, MatchesGolden(graph,
+            "pass Clear\n"
+            "  transition Particles Common -> UnorderedAccess\n"
+            "pass Count\n"
+            "  uav Particles\n"
+            "pass Inspect\n"
+            "pass Simulate\n"
+            "  uav Particles\n"
+            "pass Sort\n"
+            "  uav Particles\n"
+            "pass Draw\n"
+            "  transition Particles UnorderedAccess -> NonPixelShaderResource|PixelShaderResource\n"
+            "final\n"
+            "  transition Particles NonPixelShaderResource|PixelShaderResource -> Common\n"
+            "transient heap 0\n"));
+
+        // Common 状态下的读（如回读缓冲）不转换
+        RenderGraph readback;
+        const RGResource buffer = readback.Import("Readback", Common, Common, nullptr);
+        const uint32_t map = readback.AddPass("Map", nullptr);
+        readback.Read(map, buffer, Common);
+        readback.SetSideEffects(map);
+        const uint32_t mapAgain = readback.AddPass("MapAgain", nullptr);
+        readback.Read(mapAgain, buffer, Common);
+        readback.SetSideEffects(mapAgain);
+
+        SELF_CHECK(ctx, readback.Compile());
+        SELF_CHECK(ctx, readback.GetBarrierCount() == 0);
+        SELF_CHECK(ctx, MatchesGolden(readback,
+            "pass Map\n"
+            "pass MapAgain\n"
+            "final\n"
+            "transient heap 0\n"));
+    }
+
+    void TestConflictsAndOverwrite(SelfTestContext& ctx)
+    {
+        // 同一 pass 既读为 SRV 又写为 RTV：编译失败
+        RenderGraph conflict;
+        const RGResource texture = conflict.Import("T", Common, Common, nullptr);
+        const uint32_t bad = conflict.AddPass("Bad", nullptr);
+        conflict.Read(bad, texture, PixelShaderResource);
+        conflict.Write(bad, texture, RenderTarget);
+        SELF_CHECK(ctx, !conflict.Compile());
+
+        // 清屏被之后的整块覆盖：清屏被剔除
+        RenderGraph overwrite;
+        const RGResource backBuffer = overwrite.Import("BB", Present, Present, nullptr);
+        const uint32_t clear = overwrite.AddPass("Clear", nullptr);
+        overwrite.Write(clear, backBuffer, RenderTarget, true);
+        const uint32_t full = overwrite.AddPass("Full", nullptr);
+        overwrite.Write(full, backBuffer, RenderTarget, true);
+        SELF_CHECK(ctx, overwrite.Compile());
+        SELF_CHECK(ctx, overwrite.IsPassCulled(clear) && overwrite.GetBarrierCount() == 2);
+    }
+}
+
+void TestRenderGraph(SelfTestContext& ctx)
+{
+    TestClearAndScene(ctx);
+    TestUploadBatch(ctx);
+    TestCullingAndAliasing(ctx);
+    TestSameStateReads(ctx);
+    TestConflictsAndOverwrite(ctx);
+}
@@ -0,0 +1,121 @@
+#include "RenderQueue.h"
+#include <cstring>
+
+// ============================================================================
+// 排序键
+// ============================================================================
+uint64_t DrawKey::Make(uint32_t pass, uint32_t pipeline, uint32_t shape, uint32_t srv, float depth01)
+{
+    if (!(depth01 > 0.0f))
+    {
+        depth01 = 0.0f; // 同时处理 NaN
+    }
+    else if (depth01 > 1.0f)
+    {
+        depth01 = 1.0f;
+    }
+
+    const uint32_t depthMax = (1u << DepthBits) - 1;
+    uint64_t depth = (uint64_t)(depth01 * (float)depthMax);
+
+    return ((uint64_t)(pass & ((1u << PassBits) - 1)) << PassShift) |
+        ((uint64_t)(pipeline & ((1u << PipelineBits) - 1)) << PipelineShift) |
+        ((uint64_t)(shape & ((1u << ShapeBits) - 1)) << ShapeShift) |
+        ((uint64_t)(srv & ((1u << SrvBits) - 1)) << SrvShift) |
+        ((depth & depthMax) << DepthShift);
+}
+
+// ============================================================================
+// 实例化批次
+// ============================================================================
+void RenderQueue::BuildBatches(uint32_t maxBatchSize, std::vector<DrawBatch>& out) const
+{
+    out.clear();
+
+    const uint64_t stateMask = ~((1ull << DrawKey::DepthBits) - 1);
+    for (uint32_t i = 0; i < (uint32_t)m_items.size(); ++i)
+    {
+        uint64_t stateKey = m_items[i].Key & stateMask;
+        if (!out.empty())
+        {
+            DrawBatch& last = out.back();
+            if (last.StateKey == stateKey && (maxBatchSize == 0 || last.ItemCount < maxBatchSize))
+            {
+                ++last.ItemCount;
+                continue;
+            }
+        }
+        out.push_back({ stateKey, i, 1 });
+    }
+}
+
+// ============================================================================
+// 基数排序
+// ============================================================================
+void RenderQueue::Sort()
+{
+    m_lastSortPasses = RadixSort(m_items, m_scratch);
+}
+
+int RenderQueue::RadixSort(std::vector<DrawItem>& items, std::vector<DrawItem>& scratch)
+{
+    const size_t count = items.size();
+    if (count < 2)
+    {
+        return 0;
+    }
+
+    // 一次遍历统计全部 8 个字节的直方图
+    uint32_t histograms[8][256];
+    memset(histograms, 0, sizeof(histograms));
+    for (const DrawItem& item : items)
+    {
+        uint64_t key = item.Key;
+        for (int b = 0; b < 8; ++b)
+        {
+            ++histograms[b][(key >> (b * 8)) & 0xFF];
+        }
+    }
+
+    scratch.resize(count);
+    DrawItem* src = items.data();
+    DrawItem* dst = scratch.data();
+    int passes = 0;
+
+    for (int b = 0; b < 8; ++b)
+    {
+        uint32_t* histogram = histograms[b];
+
+        // 所有键在该字节上相同，这一趟不会改变顺序
+        if (histogram[(src[0].Key >> (b * 8)) & 0xFF] == count)
+        {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            uint32_t c = histogram[i];
+            histogram[i] = offset;
+            offset += c;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t bucket = (uint32_t)((src[i].Key >> (b * 8)) & 0xFF);
+            dst[histogram[bucket]++] = src[i];
+        }
+
+        DrawItem* tmp = src;
+        src = dst;
+        dst = tmp;
+        ++passes;
+    }
+
+    // 奇数趟时结果在 scratch 中
+    if (src != items.data())
+    {
+        items.swap(scratch);
+    }
+    return passes;
+}
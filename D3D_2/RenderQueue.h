@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 64 位绘制排序键（高位优先）：
+//   [63:60] pass      绘制阶段（不透明/透明等）
+//   [59:52] pipeline  PSO 编号
+//   [51:44] shape     几何体模板编号
+//   [43:24] srv       纹理 SRV 堆下标
+//   [23:0]  depth     量化后的视空间深度（不透明由近到远）
+namespace DrawKey
+{
+    const int PassBits = 4;
+    const int PipelineBits = 8;
+    const int ShapeBits = 8;
+    const int SrvBits = 20;
+    const int DepthBits = 24;
+
+    const int DepthShift = 0;
+    const int SrvShift = DepthShift + DepthBits;
+    const int ShapeShift = SrvShift + SrvBits;
+    const int PipelineShift = ShapeShift + ShapeBits;
+    const int PassShift = PipelineShift + PipelineBits;
+
+    // depth01 为 [0, 1] 的线性深度，超出范围会被截断
+    uint64_t Make(uint32_t pass, uint32_t pipeline, uint32_t shape, uint32_t srv, float depth01);
+
+    inline uint32_t Field(uint64_t key, int shift, int bits)
+    {
+        return (uint32_t)((key >> shift) & ((1ull << bits) - 1));
+    }
+
+    inline uint32_t Pass(uint64_t key) { return Field(key, PassShift, PassBits); }
+    inline uint32_t Pipeline(uint64_t key) { return Field(key, PipelineShift, PipelineBits); }
+    inline uint32_t Shape(uint64_t key) { return Field(key, ShapeShift, ShapeBits); }
+    inline uint32_t Srv(uint64_t key) { return Field(key, SrvShift, SrvBits); }
+    inline uint32_t Depth(uint64_t key) { return Field(key, DepthShift, DepthBits); }
+}
+
+struct DrawItem
+{
+    uint64_t Key;
+    uint32_t ObjectIndex;
+};
+
+// 一次实例化绘制：排序后 [FirstItem, FirstItem + ItemCount) 的绘制项共享同一状态
+struct DrawBatch
+{
+    uint64_t StateKey;   // 去掉深度位后的键
+    uint32_t FirstItem;
+    uint32_t ItemCount;
+};
+
+// 每帧的绘制队列：收集绘制项，按键做 LSD 基数排序（每趟 8 位，键值全相同的字节跳过）
+class RenderQueue
+{
+public:
+    void Clear() { m_items.clear(); }
+    void Reserve(size_t count) { m_items.reserve(count); }
+    void Add(uint64_t key, uint32_t objectIndex) { m_items.push_back({ key, objectIndex }); }
+
+    void Sort();
+
+    const std::vector<DrawItem>& GetItems() const { return m_items; }
+    size_t GetCount() const { return m_items.size(); }
+
+    // 上次排序实际执行的趟数（0~8）
+    int GetLastSortPasses() const { return m_lastSortPasses; }
+
+    // 把排序后相邻、除深度外键值相同的绘制项合并为批次；maxBatchSize 为 0 表示不限
+    void BuildBatches(uint32_t maxBatchSize, std::vector<DrawBatch>& out) const;
+
+    // 稳定的 LSD 基数排序；scratch 作为乒乓缓冲
+    static int RadixSort(std::vector<DrawItem>& items, std::vector<DrawItem>& scratch);
+
+private:
+    std::vector<DrawItem> m_items;
+    std::vector<DrawItem> m_scratch;
+    int m_lastSortPasses = 0;
+};
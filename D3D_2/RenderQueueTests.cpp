@@ -0,0 +1,237 @@
+#include "SelfTest.h"
+#include "RenderQueue.h"
+#include "DrawStateCache.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+// ============================================================================
+// RenderQueue：排序键的字段打包与优先级、基数排序与 std::stable_sort 一致、
+// 实例化批次的合并与拆分、DrawStateCache 对一段已知绑定序列的计数
+// ============================================================================
+namespace
+{
+    bool SameOrder(const std::vector<DrawItem>& a, const std::vector<DrawItem>& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].Key != b[i].Key || a[i].ObjectIndex != b[i].ObjectIndex)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 基数排序结果与按键的稳定排序逐项一致（相同键保持加入顺序），返回实际趟数
+    int SortMatchesStable(const std::vector<uint64_t>& keys, bool& match)
+    {
+        RenderQueue queue;
+        std::vector<DrawItem> expected;
+        for (uint32_t i = 0; i < (uint32_t)keys.size(); ++i)
+        {
+            queue.Add(keys[i], i);
+            expected.push_back({ keys[i], i });
+        }
+        std::stable_sort(expected.begin(), expected.end(),
+            [](const DrawItem& a, const DrawItem& b) { return a.Key < b.Key; });
+        queue.Sort();
+        match = SameOrder(queue.GetItems(), expected);
+        return queue.GetLastSortPasses();
+    }
+}
+
+void TestRenderQueue(SelfTestContext& ctx)
+{
+    // 字段打包：各字段取回原值，越界的值只保留低位，不会串到相邻字段
+    {
+        const uint64_t key = DrawKey::Make(3, 0xAB, 0x12, 0x54321, 0.5f);
+        SELF_CHECK(ctx, DrawKey::Pass(key) == 3 && DrawKey::Pipeline(key) == 0xAB && DrawKey::Shape(key) == 0x12);
+        SELF_CHECK(ctx, DrawKey::Srv(key) == 0x54321 && DrawKey::Depth(key) == (uint32_t)(0.5f * 0xFFFFFF));
+        SELF_CHECK(ctx, key == ((3ull << 60) | (0xABull << 52) | (0x12ull << 44) | (0x54321ull << 24) | (uint64_t)(0.5f * 0xFFFFFF)));
+
+        const uint64_t wide = DrawKey::Make(0x1F, 0x1FF, 0x1FF, 0x1FFFFF, 1.0f);
+        SELF_CHECK(ctx, wide == ~0ull);
+        SELF_CHECK(ctx, DrawKey::Make(0x10, 0x100, 0x100, 0x100000, 0.0f) == 0);
+    }
+
+    // 深度截断到 [0, 1]，NaN 当 0
+    SELF_CHECK(ctx, DrawKey::Depth(DrawKey::Make(0, 0, 0, 0, -3.0f)) == 0);
+    SELF_CHECK(ctx, DrawKey::Depth(DrawKey::Make(0, 0, 0, 0, std::nanf(""))) == 0);
+    SELF_CHECK(ctx, DrawKey::Depth(DrawKey::Make(0, 0, 0, 0, 7.0f)) == 0xFFFFFF);
+
+    // 排序优先级：pass > pipeline > shape > srv > depth，高位字段只差 1 就压过低位全满
+    SELF_CHECK(ctx, DrawKey::Make(1, 0, 0, 0, 0.0f) > DrawKey::Make(0, 0xFF, 0xFF, 0xFFFFF, 1.0f));
+    SELF_CHECK(ctx, DrawKey::Make(0, 1, 0, 0, 0.0f) > DrawKey::Make(0, 0, 0xFF, 0xFFFFF, 1.0f));
+    SELF_CHECK(ctx, DrawKey::Make(0, 0, 1, 0, 0.0f) > DrawKey::Make(0, 0, 0, 0xFFFFF, 1.0f));
+    SELF_CHECK(ctx, DrawKey::Make(0, 0, 0, 1, 0.0f) > DrawKey::Make(0, 0, 0, 0, 1.0f));
+    SELF_CHECK(ctx, DrawKey::Make(0, 0, 0, 0, 0.25f) < DrawKey::Make(0, 0, 0, 0, 0.75f));
+
+    // 随机键：全部字段随机、只有少量不同状态（大量重复键考验稳定性）、只有深度不同
+    {
+        std::mt19937_64 rng(30);
+        bool match = false;
+        std::vector<uint64_t> keys;
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            keys.push_back(rng());
+        }
+        SELF_CHECK(ctx, SortMatchesStable(keys, match) == 8 && match);
+
+        keys.clear();
+        for (int i = 0; i < 777; ++i)
+        {
+            keys.push_back(DrawKey::Make(0, (uint32_t)(rng() % 3), (uint32_t)(rng() % 4), (uint32_t)(rng() % 2), 0.0f));
+        }
+        SortMatchesStable(keys, match);
+        SELF_CHECK(ctx, match);
+
+        // 状态位全相同：高 5 个字节的趟全部跳过
+        keys.clear();
+        for (int i = 0; i < 500; ++i)
+        {
+            keys.push_back(DrawKey::Make(1, 2, 3, 4, (float)(rng() % 1000) / 1000.0f));
+        }
+        const int passes = SortMatchesStable(keys, match);
+        SELF_CHECK(ctx, match && passes >= 1 && passes <= 3);
+
+        // 只有最低字节不同：奇数趟，结果在乒乓缓冲里也要换回来
+        keys.clear();
+        for (int i = 0; i < 300; ++i)
+        {
+            keys.push_back(0x1234567800000000ull | (rng() & 0xFF));
+        }
+        SELF_CHECK(ctx, SortMatchesStable(keys, match) == 1 && match);
+
+        // 全部相同或不足两个：一趟都不跑，顺序不变
+        keys.assign(50, 42);
+        SELF_CHECK(ctx, SortMatchesStable(keys, match) == 0 && match);
+        keys.assign(1, 7);
+        SELF_CHECK(ctx, SortMatchesStable(keys, match) == 0 && match);
+    }
+
+    // 实例化批次：键按 D3DManager 的方式生成（pipeline = 着色器变体，shape = 几何体模板），
+    // 排序后共享变体/几何体/SRV 的对象合并为一批，深度不同不影响合并
+    {
+        RenderQueue queue;
+        uint32_t object = 0;
+        auto add = [&](uint32_t variant, uint32_t shape, uint32_t srv, int count)
+        {
+            for (int i = 0; i < count; ++i, ++object)
+            {
+                queue.Add(DrawKey::Make(0, variant, shape, srv, (float)((object * 37) % 100) / 100.0f), object);
+            }
+        };
+        add(2, 1, 10, 5);   // 基准：5 个实例
+        add(2, 1, 11, 3);   // 只有 SRV 不同
+        add(3, 1, 10, 2);   // 只有变体不同
+        add(2, 4, 10, 4);   // 只有几何体不同
+        add(2, 1, 10, 2);   // 与基准相同，加入顺序不相邻，排序后应并回基准批次
+        queue.Sort();
+
+        std::vector<DrawBatch> batches;
+        queue.BuildBatches(0, batches);
+        SELF_CHECK(ctx, batches.size() == 4);
+        uint32_t covered = 0;
+        bool contiguous = true, sameState = true;
+        for (const DrawBatch& batch : batches)
+        {
+            contiguous &= batch.FirstItem == covered;
+            covered += batch.ItemCount;
+            for (uint32_t i = batch.FirstItem; i < batch.FirstItem + batch.ItemCount; ++i)
+            {
+                const uint64_t key = queue.GetItems()[i].Key;
+                sameState &= DrawKey::Pipeline(key) == DrawKey::Pipeline(batch.StateKey) &&
+                    DrawKey::Shape(key) == DrawKey::Shape(batch.StateKey) && DrawKey::Srv(key) == DrawKey::Srv(batch.StateKey);
+            }
+            SELF_CHECK(ctx, DrawKey::Depth(batch.StateKey) == 0);
+        }
+        SELF_CHECK(ctx, contiguous && sameState && covered == object);
+
+        // 排序后批次顺序跟随键：(2,1,10) x7、(2,1,11) x3、(2,4,10) x4、(3,1,10) x2
+        auto batchIs = [&](size_t i, uint32_t variant, uint32_t shape, uint32_t srv, uint32_t count)
+        {
+            return i < batches.size() && DrawKey::Pipeline(batches[i].StateKey) == variant &&
+                DrawKey::Shape(batches[i].StateKey) == shape && DrawKey::Srv(batches[i].StateKey) == srv &&
+                batches[i].ItemCount == count;
+        };
+        SELF_CHECK(ctx, batchIs(0, 2, 1, 10, 7));
+        SELF_CHECK(ctx, batchIs(1, 2, 1, 11, 3));
+        SELF_CHECK(ctx, batchIs(2, 2, 4, 10, 4));
+        SELF_CHECK(ctx, batchIs(3, 3, 1, 10, 2));
+
+        // 批次上限：7 个实例按 3 拆成 3 + 3 + 1，恰好等于上限的不拆
+        queue.BuildBatches(3, batches);
+        SELF_CHECK(ctx, batches.size() == 7);
+        SELF_CHECK(ctx, batchIs(0, 2, 1, 10, 3) && batchIs(1, 2, 1, 10, 3) && batchIs(2, 2, 1, 10, 1));
+        SELF_CHECK(ctx, batchIs(3, 2, 1, 11, 3) && batchIs(4, 2, 4, 10, 3) && batchIs(5, 2, 4, 10, 1));
+        SELF_CHECK(ctx, batchIs(6, 3, 1, 10, 2) && batches[1].FirstItem == 3 && batches[2].FirstItem == 6);
+
+        // 上限 1 等于不做实例化
+        queue.BuildBatches(1, batches);
+        SELF_CHECK(ctx, batches.size() == object);
+
+        queue.Clear();
+        queue.BuildBatches(0, batches);
+        SELF_CHECK(ctx, batches.empty());
+    }
+
+    // DrawStateCache：按 RecordBatch 的顺序绑定 (pipeline, srv, shape, 拓扑)，
+    // 命令列表 Begin 时已绑定变体 0
+    {
+        struct Step
+        {
+            uint32_t Pipeline, Srv, Shape, Instances;
+            bool Pso, Table, Geometry, Topology;
+        };
+        const Step steps[] =
+        {
+            { 0, 5, 1, 3,   false, true, true, true },
+            { 0, 5, 2, 1,   false, false, true, false },
+            { 1, 5, 2, 2,   true, false, false, false },
+            { 1, 7, 2, 4,   false, true, false, false },
+            { 0, 7, 1, 1,   true, false, true, false },
+        };
+        const uint32_t triangleList = 4;
+
+        DrawStateCache cache;
+        cache.Reset();
+        cache.NotePipeline(0);
+        cache.CountRootParameters(3);
+        bool returnsMatch = true;
+        for (const Step& step : steps)
+        {
+            returnsMatch &= cache.SetPipeline(step.Pipeline) == step.Pso;
+            returnsMatch &= cache.SetDescriptorTable(step.Srv) == step.Table;
+            returnsMatch &= cache.SetGeometry(step.Shape) == step.Geometry;
+            returnsMatch &= cache.SetTopology(triangleList) == step.Topology;
+            cache.CountRootParameters(1);
+            cache.CountDraw(step.Instances, 36);
+        }
+        SELF_CHECK(ctx, returnsMatch);
+
+        const DrawStateStats& stats = cache.GetStats();
+        SELF_CHECK(ctx, stats.PipelineBinds == 2 && stats.PipelineBindsSaved == 3);
+        SELF_CHECK(ctx, stats.DescriptorTableBinds == 2 && stats.DescriptorTableBindsSaved == 3);
+        SELF_CHECK(ctx, stats.GeometryBinds == 3 && stats.GeometryBindsSaved == 2);
+        SELF_CHECK(ctx, stats.TopologyBinds == 1 && stats.TopologyBindsSaved == 4);
+        SELF_CHECK(ctx, stats.Draws == 5 && stats.Instances == 11 && stats.Indices == 11 * 36);
+        SELF_CHECK(ctx, stats.RootParameterSets == 8);
+
+        // 两条命令列表的统计合并
+        DrawStateStats total = stats;
+        total.Add(stats);
+        SELF_CHECK(ctx, total.PipelineBinds == 4 && total.GeometryBindsSaved == 4 && total.Indices == 2 * 11 * 36);
+
+        // Reset 后计数清零、所有状态重新视为未绑定
+        cache.Reset();
+        SELF_CHECK(ctx, cache.GetStats().Draws == 0 && cache.GetStats().PipelineBinds == 0);
+        SELF_CHECK(ctx, cache.SetPipeline(1) && cache.SetGeometry(2) && cache.SetDescriptorTable(7) && cache.SetTopology(triangleList));
+        SELF_CHECK(ctx, !cache.SetPipeline(1) && cache.GetStats().PipelineBindsSaved == 1);
+    }
+}
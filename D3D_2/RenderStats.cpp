@@ -0,0 +1,112 @@
+#include "RenderStats.h"
+#include <cstdio>
+
+namespace
+{
+    const char* const CounterNames[RenderCounter::Count] = {
+        "CPU frame ms",
+        "GPU frame ms",
+        "Draw calls",
+        "Instances",
+        "Indices",
+        "Triangles",
+        "Pipeline binds",
+        "Geometry binds",
+        "Root parameter sets",
+        "Descriptor tables",
+        "Constant bytes",
+        "Objects written",
+        "Texture uploads",
+        "Texture bytes",
+        "Texture memory",
+        "Texture stream requests",
+        "Scene objects",
+        "Frustum culled",
+        "Occlusion culled",
+        "Visible",
+    };
+}
+
+const char* RenderCounter::GetName(Id id)
+{
+    return id < Count ? CounterNames[id] : "";
+}
+
+RenderStatsHistory::RenderStatsHistory(uint32_t window)
+    : m_frames(window > 0 ? window : 1)
+{
+}
+
+void RenderStatsHistory::Push(const RenderFrameStats& frame)
+{
+    m_frames[m_next] = frame;
+    m_next = (m_next + 1) % (uint32_t)m_frames.size();
+    if (m_count < m_frames.size())
+    {
+        ++m_count;
+    }
+    ++m_total;
+}
+
+void RenderStatsHistory::Summarize(RenderStatsSummary& out) const
+{
+    out = RenderStatsSummary{};
+    out.WindowFrames = m_count;
+    out.TotalFrames = m_total;
+    if (m_count == 0)
+    {
+        return;
+    }
+
+    const uint32_t window = (uint32_t)m_frames.size();
+    out.Last = m_frames[(m_next + window - 1) % window];
+
+    // 窗口只有一两百帧，查询时直接扫描
+    for (uint32_t c = 0; c < RenderCounter::Count; ++c)
+    {
+        RenderStatRange& range = out.Ranges[c];
+        range.Min = range.Max = m_frames[(m_next + window - m_count) % window].Values[c];
+        double sum = 0.0;
+        for (uint32_t i = 0; i < m_count; ++i)
+        {
+            const double value = m_frames[(m_next + window - m_count + i) % window].Values[c];
+            range.Min = value < range.Min ? value : range.Min;
+            range.Max = value > range.Max ? value : range.Max;
+            sum += value;
+        }
+        range.Avg = sum / m_count;
+    }
+}
+
+void RenderStatsHistory::Clear()
+{
+    m_next = 0;
+    m_count = 0;
+    m_total = 0;
+}
+
+void FormatRenderStats(const RenderStatsSummary& summary, std::string& out)
+{
+    char line[160];
+    snprintf(line, sizeof(line), "Frames: %llu (window %u)  last / min / avg / max\n",
+        (unsigned long long)summary.TotalFrames, summary.WindowFrames);
+    out = line;
+
+    for (uint32_t c = 0; c < RenderCounter::Count; ++c)
+    {
+        const RenderCounter::Id id = (RenderCounter::Id)c;
+        const RenderStatRange& range = summary.Ranges[c];
+        // 毫秒项保留小数，其余是整数计数
+        if (id == RenderCounter::CpuFrameMs || id == RenderCounter::GpuFrameMs)
+        {
+            snprintf(line, sizeof(line), "%-20s %9.3f  %9.3f / %9.3f / %9.3f\n",
+                RenderCounter::GetName(id), summary.Last[id], range.Min, range.Avg, range.Max);
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "%-20s %9.0f  %9.0f / %9.1f / %9.0f\n",
+                RenderCounter::GetName(id), summary.Last[id], range.Min, range.Avg, range.Max);
+        }
+        out += line;
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 每帧统计的计数项
+namespace RenderCounter
+{
+    enum Id : uint32_t
+    {
+        CpuFrameMs,             // Render 从取快照到提交完成
+        GpuFrameMs,             // GPU 时间戳量出的整帧耗时（比 CPU 晚帧上下文数帧）
+        DrawCalls,
+        Instances,              // 不做实例化时需要的绘制调用数
+        Indices,                // 所有实例提交的索引数
+        Triangles,
+        PipelineBinds,
+        GeometryBinds,          // 顶点 + 索引缓冲绑定
+        RootParameterSets,      // 根常量 + 根 CBV/SRV
+        DescriptorTableBinds,
+        ConstantBytes,          // 写入上传内存的常量字节数（对象常量 + pass 常量 + 槽位表）
+        ObjectsWritten,         // 常量有变化、实际重写的对象数
+        TextureUploads,
+        TextureUploadBytes,
+        TextureMemory,          // 纹理缓存中驻留纹理的字节数（块压缩后）
+        TextureStreamRequests,  // 流式驻留本帧发出的换级请求（加载、淘汰与取消）
+        SceneObjects,           // 发布快照时场景中的对象数
+        FrustumCulled,
+        OcclusionCulled,
+        Visible,
+        Count
+    };
+
+    const char* GetName(Id id);
+}
+
+struct RenderFrameStats
+{
+    double Values[RenderCounter::Count] = {};
+
+    double& operator[](RenderCounter::Id id) { return Values[id]; }
+    double operator[](RenderCounter::Id id) const { return Values[id]; }
+};
+
+struct RenderStatRange
+{
+    double Min = 0.0;
+    double Avg = 0.0;
+    double Max = 0.0;
+};
+
+// 最近一帧 + 窗口内各计数项的最小/平均/最大值
+struct RenderStatsSummary
+{
+    RenderFrameStats Last;
+    RenderStatRange Ranges[RenderCounter::Count];
+    uint32_t WindowFrames = 0;      // 窗口内实际帧数（刚开始时少于窗口大小）
+    uint64_t TotalFrames = 0;
+};
+
+// 最近 window 帧统计的环形历史。不加锁，由使用者保证同步
+class RenderStatsHistory
+{
+public:
+    explicit RenderStatsHistory(uint32_t window = 120);
+
+    void Push(const RenderFrameStats& frame);
+    void Summarize(RenderStatsSummary& out) const;
+    void Clear();
+
+    uint32_t GetWindow() const { return (uint32_t)m_frames.size(); }
+
+private:
+    std::vector<RenderFrameStats> m_frames;
+    uint32_t m_next = 0;
+    uint32_t m_count = 0;
+    uint64_t m_total = 0;
+};
+
+// 多行文本：每项一行 "名称  最近值  (最小 / 平均 / 最大)"
+void FormatRenderStats(const RenderStatsSummary& summary, std::string& out);
@@ -0,0 +1,119 @@
+#include "SelfTest.h"
+#include "RenderStats.h"
+#include <cmath>
+#include <cstring>
+#include <set>
+
+// ============================================================================
+// RenderStats：环形窗口的部分填充、回绕后旧帧移出，最小/平均/最大值与文本输出
+// ============================================================================
+namespace
+{
+    // DrawCalls 取 draws，CpuFrameMs 取 draws 的四分之一，Visible 取其相反数，检查各项互不串
+    RenderFrameStats MakeFrame(double draws)
+    {
+        RenderFrameStats frame;
+        frame[RenderCounter::DrawCalls] = draws;
+        frame[RenderCounter::CpuFrameMs] = draws * 0.25;
+        frame[RenderCounter::Visible] = -draws;
+        return frame;
+    }
+
+    bool RangeIs(const RenderStatsSummary& summary, RenderCounter::Id id, double min, double avg, double max)
+    {
+        const RenderStatRange& range = summary.Ranges[id];
+        return range.Min == min && std::fabs(range.Avg - avg) < 1e-12 && range.Max == max;
+    }
+
+    bool DrawsAre(const RenderStatsSummary& summary, double last, double min, double avg, double max)
+    {
+        return summary.Last[RenderCounter::DrawCalls] == last &&
+            RangeIs(summary, RenderCounter::DrawCalls, min, avg, max) &&
+            RangeIs(summary, RenderCounter::CpuFrameMs, min * 0.25, avg * 0.25, max * 0.25) &&
+            RangeIs(summary, RenderCounter::Visible, -max, -avg, -min) &&
+            RangeIs(summary, RenderCounter::Triangles, 0.0, 0.0, 0.0);
+    }
+}
+
+void TestRenderStats(SelfTestContext& ctx)
+{
+    // 名称：每项都有且互不相同，越界返回空串
+    {
+        std::set<std::string> names;
+        for (uint32_t c = 0; c < RenderCounter::Count; ++c)
+        {
+            names.insert(RenderCounter::GetName((RenderCounter::Id)c));
+        }
+        SELF_CHECK(ctx, names.size() == RenderCounter::Count && names.count("") == 0);
+        SELF_CHECK(ctx, strcmp(RenderCounter::GetName(RenderCounter::Count), "") == 0);
+    }
+
+    RenderStatsHistory history(4);
+    RenderStatsSummary summary;
+    SELF_CHECK(ctx, history.GetWindow() == 4);
+
+    // 空窗口：全部为 0
+    history.Summarize(summary);
+    SELF_CHECK(ctx, summary.WindowFrames == 0 && summary.TotalFrames == 0 && DrawsAre(summary, 0, 0, 0, 0));
+
+    // 部分填充：只统计已推入的 3 帧（没写过的槽位不能把最小值拉到 0）
+    history.Push(MakeFrame(5));
+    history.Push(MakeFrame(1));
+    history.Push(MakeFrame(3));
+    history.Summarize(summary);
+    SELF_CHECK(ctx, summary.WindowFrames == 3 && summary.TotalFrames == 3);
+    SELF_CHECK(ctx, DrawsAre(summary, 3, 1, 3, 5));
+
+    // 刚好填满
+    history.Push(MakeFrame(7));
+    history.Summarize(summary);
+    SELF_CHECK(ctx, summary.WindowFrames == 4 && DrawsAre(summary, 7, 1, 4, 7));
+
+    // 回绕：最早的 5、1 移出窗口，剩 3、7、10、2
+    history.Push(MakeFrame(10));
+    history.Push(MakeFrame(2));
+    history.Summarize(summary);
+    SELF_CHECK(ctx, summary.WindowFrames == 4 && summary.TotalFrames == 6);
+    SELF_CHECK(ctx, DrawsAre(summary, 2, 2, 5.5, 10));
+
+    // 再推满一整圈：窗口里只剩新帧，之前的最大值 10 不再出现
+    for (double draws : { 4.0, 4.0, 6.0, 6.0 })
+    {
+        history.Push(MakeFrame(draws));
+    }
+    history.Summarize(summary);
+    SELF_CHECK(ctx, summary.WindowFrames == 4 && summary.TotalFrames == 10);
+    SELF_CHECK(ctx, DrawsAre(summary, 6, 4, 5, 6));
+
+    // 文本：表头 + 每项一行
+    {
+        std::string text;
+        FormatRenderStats(summary, text);
+        size_t lines = 0;
+        for (char c : text)
+        {
+            lines += c == '\n';
+        }
+        SELF_CHECK(ctx, lines == RenderCounter::Count + 1);
+        SELF_CHECK(ctx, text.find("Frames: 10 (window 4)") == 0);
+        SELF_CHECK(ctx, text.find("Draw calls") != std::string::npos && text.find("5.0") != std::string::npos);
+    }
+
+    // Clear 后重新开始计数
+    history.Clear();
+    history.Summarize(summary);
+    SELF_CHECK(ctx, summary.WindowFrames == 0 && summary.TotalFrames == 0);
+    history.Push(MakeFrame(9));
+    history.Summarize(summary);
+    SELF_CHECK(ctx, summary.WindowFrames == 1 && DrawsAre(summary, 9, 9, 9, 9));
+
+    // 窗口大小 0 按 1 处理：只保留最近一帧
+    {
+        RenderStatsHistory single(0);
+        SELF_CHECK(ctx, single.GetWindow() == 1);
+        single.Push(MakeFrame(8));
+        single.Push(MakeFrame(2));
+        single.Summarize(summary);
+        SELF_CHECK(ctx, summary.WindowFrames == 1 && summary.TotalFrames == 2 && DrawsAre(summary, 2, 2, 2, 2));
+    }
+}
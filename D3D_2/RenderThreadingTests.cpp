@@ -0,0 +1,143 @@
+#include "SelfTest.h"
+#include "RenderCommandQueue.h"
+#include "SnapshotBuffer.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// RenderCommandQueue / SnapshotBuffer：UI 线程与渲染线程之间交接的压力测试
+// ============================================================================
+namespace
+{
+    // 多生产者在小容量队列上反复挤满：每个生产者的命令恰好执行一次且保持投递顺序
+    void TestCommandQueueStress(SelfTestContext& ctx)
+    {
+        RenderCommandQueue queue(64);
+        SELF_CHECK(ctx, queue.GetCapacity() == 64);
+
+        const int producerCount = 4;
+        const uint64_t commandsPerProducer = 100000;
+        std::vector<uint64_t> last(producerCount, 0);
+        uint64_t executed = 0;
+        bool ordered = true;
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < producerCount; ++p)
+        {
+            producers.emplace_back([&, p]
+            {
+                for (uint64_t i = 1; i <= commandsPerProducer; ++i)
+                {
+                    // 命令只在消费者线程上执行，不需要同步
+                    queue.Push([&, p, i]
+                    {
+                        ordered &= last[p] + 1 == i;
+                        last[p] = i;
+                        ++executed;
+                    });
+                }
+            });
+        }
+        while (executed < producerCount * commandsPerProducer)
+        {
+            if (queue.Drain() == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        for (std::thread& producer : producers)
+        {
+            producer.join();
+        }
+
+        SELF_CHECK(ctx, ordered);
+        SELF_CHECK(ctx, executed == producerCount * commandsPerProducer);
+        SELF_CHECK(ctx, queue.GetPushedCount() == producerCount * commandsPerProducer);
+        SELF_CHECK(ctx, queue.Drain() == 0);
+
+        // 满时 TryPush 失败，取走一个后又能放入
+        RenderCommandQueue small(4);
+        int ran = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            SELF_CHECK(ctx, small.TryPush([&] { ++ran; }));
+        }
+        SELF_CHECK(ctx, !small.TryPush([&] { ++ran; }));
+        RenderCommandQueue::Command command;
+        SELF_CHECK(ctx, small.TryPop(command) && command);
+        command();
+        SELF_CHECK(ctx, small.TryPush([&] { ++ran; }));
+        SELF_CHECK(ctx, small.Drain() == 4 && ran == 5);
+    }
+
+    struct Snapshot
+    {
+        uint64_t Serial = 0;
+        std::vector<uint64_t> Values;
+    };
+
+    // 写端高速发布、读端不断换入：读到的快照总是完整的一份且序号不回退，最后一份一定能读到
+    void TestSnapshotBufferStress(SelfTestContext& ctx)
+    {
+        SnapshotBuffer<Snapshot> buffer;
+        const uint64_t publishCount = 300000;
+        std::atomic<bool> done{ false };
+
+        std::thread writer([&]
+        {
+            for (uint64_t serial = 1; serial <= publishCount; ++serial)
+            {
+                Snapshot& snapshot = buffer.BeginWrite();
+                snapshot.Serial = serial;
+                snapshot.Values.resize(1 + serial % 17);
+                for (size_t k = 0; k < snapshot.Values.size(); ++k)
+                {
+                    snapshot.Values[k] = serial * 31 + k;
+                }
+                buffer.Publish();
+            }
+            done.store(true, std::memory_order_release);
+        });
+
+        uint64_t previous = 0, swaps = 0;
+        bool complete = true, monotonic = true;
+        for (;;)
+        {
+            const bool finished = done.load(std::memory_order_acquire);
+            bool changed = false;
+            const Snapshot& snapshot = buffer.Acquire(&changed);
+            swaps += changed ? 1 : 0;
+            monotonic &= snapshot.Serial >= previous && (changed || snapshot.Serial == previous);
+            previous = snapshot.Serial;
+            if (snapshot.Serial != 0)
+            {
+                complete &= snapshot.Values.size() == 1 + snapshot.Serial % 17;
+                for (size_t k = 0; k < snapshot.Values.size(); ++k)
+                {
+                    complete &= snapshot.Values[k] == snapshot.Serial * 31 + k;
+                }
+            }
+            if (finished)
+            {
+                break;
+            }
+        }
+        writer.join();
+
+        // 写端结束后的一次 Acquire 换到最后一份
+        const Snapshot& last = buffer.Acquire();
+        SELF_CHECK(ctx, complete && monotonic);
+        SELF_CHECK(ctx, last.Serial == publishCount);
+        SELF_CHECK(ctx, swaps > 0 && buffer.GetPublishCount() == publishCount);
+
+        bool changed = true;
+        SELF_CHECK(ctx, &buffer.Acquire(&changed) == &last && !changed);
+    }
+}
+
+void TestRenderThreading(SelfTestContext& ctx)
+{
+    TestCommandQueueStress(ctx);
+    TestSnapshotBufferStress(ctx);
+}
@@ -20,8 +20,14 @@
 #define IDD_TRANSFORM_DIALOG            129
 #define IDD_LIGHT_DIALOG                130
 #define IDM_CLEAR_SCENE                 201
+#define IDM_OCCLUSION_CULLING           202
+#define IDM_SOFTWARE_RENDER             203
+#define IDM_EXPORT_TRACE                204
+#define IDM_RENDER_STATS                205
 #define IDM_EDIT_TRANSFORM              301
 #define IDM_LIGHT_SETTINGS              302
+#define IDM_BOX_SELECT                  303
+#define IDM_DRAG_COLLISION              304
 #define IDC_POS_X                       1001
 #define IDC_POS_Y                       1002
 #define IDC_POS_Z                       1003
@@ -1,7 +1,13 @@
 #include "SceneObject.h"
 #include "PrimitiveShape.h"
+#include <atomic>
 using namespace DirectX;
 
+namespace
+{
+    std::atomic<uint64_t> g_nextVersion{ 0 };
+}
+
 SceneObject::SceneObject(ShapeType type, std::shared_ptr<PrimitiveShape> shape)
     : m_type(type)
     , m_shape(shape)
@@ -10,6 +16,7 @@ SceneObject::SceneObject(ShapeType type, std::shared_ptr<PrimitiveShape> shape)
     , m_scale(1.0f)
     , m_isSelected(false)
 {
+    Touch();
 }
 
 SceneObject::~SceneObject()
@@ -19,16 +26,24 @@ SceneObject::~SceneObject()
 void SceneObject::SetPosition(const XMFLOAT3& pos)
 {
     m_position = pos;
+    Touch();
 }
 
 void SceneObject::SetScale(float scale)
 {
     m_scale = scale;
+    Touch();
 }
 
 void SceneObject::SetRotation(const XMFLOAT3& rotation)
 {
     m_rotation = rotation;
+    Touch();
+}
+
+void SceneObject::Touch()
+{
+    m_version = g_nextVersion.fetch_add(1, std::memory_order_relaxed) + 1;
 }
 
 XMMATRIX SceneObject::GetWorldMatrix() const
@@ -43,10 +58,37 @@ XMMATRIX SceneObject::GetWorldMatrix() const
     return scale * rotation * translation;
 }
 
+void SceneObject::GetWorldAABB(XMFLOAT3& outMin, XMFLOAT3& outMax) const
+{
+    if (!m_shape)
+    {
+        float r = GetBoundingRadius();
+        outMin = XMFLOAT3(m_position.x - r, m_position.y - r, m_position.z - r);
+        outMax = XMFLOAT3(m_position.x + r, m_position.y + r, m_position.z + r);
+        return;
+    }
+
+    // 中心 + 半长：新半长 = |M| * 旧半长
+    XMVECTOR localMin = XMLoadFloat3(&m_shape->GetLocalMin());
+    XMVECTOR localMax = XMLoadFloat3(&m_shape->GetLocalMax());
+    XMVECTOR center = (localMin + localMax) * 0.5f;
+    XMVECTOR extent = (localMax - localMin) * 0.5f;
+
+    XMMATRIX world = GetWorldMatrix();
+    XMVECTOR worldCenter = XMVector3Transform(center, world);
+    XMVECTOR worldExtent =
+        XMVectorAbs(world.r[0]) * XMVectorSplatX(extent) +
+        XMVectorAbs(world.r[1]) * XMVectorSplatY(extent) +
+        XMVectorAbs(world.r[2]) * XMVectorSplatZ(extent);
+
+    XMStoreFloat3(&outMin, worldCenter - worldExtent);
+    XMStoreFloat3(&outMax, worldCenter + worldExtent);
+}
+
 float SceneObject::GetBoundingRadius() const
 {
-    // ؽƱ߽뾶
-    float baseRadius = 1.5f; // 뾶
+    // 返回近似边界球半径
+    float baseRadius = 1.5f; // 基础半径
 
     switch (m_type)
     {
@@ -72,26 +114,26 @@ float SceneObject::GetBoundingRadius() const
 
 bool SceneObject::IntersectRay(const XMVECTOR& rayOrigin, const XMVECTOR& rayDir, float& distance) const
 {
-    // 򵥵-ཻ
+    // 简单的射线-球体相交测试
     XMVECTOR objPos = XMLoadFloat3(&m_position);
     XMVECTOR toObject = objPos - rayOrigin;
 
     float radius = GetBoundingRadius();
 
-    // ͶӰ
+    // 投影距离
     float projDist = XMVectorGetX(XMVector3Dot(toObject, rayDir));
 
-    // ͶӰΪߺ
+    // 如果投影为负，物体在射线后方
     if (projDist < 0)
         return false;
 
-    // 㵽ĵľ
+    // 最近点到物体中心的距离
     XMVECTOR closestPoint = rayOrigin + rayDir * projDist;
     float distToCenter = XMVectorGetX(XMVector3Length(closestPoint - objPos));
 
     if (distToCenter <= radius)
     {
-        // 㽻
+        // 计算交点距离
         float offset = sqrtf(radius * radius - distToCenter * distToCenter);
         distance = projDist - offset;
         return true;
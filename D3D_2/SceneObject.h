@@ -1,6 +1,7 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -37,58 +38,78 @@ struct Material
     float Shininess = 32.0f;
 };
 
-// еһɽ
+// 场景中的一个可交互对象
 class SceneObject
 {
 public:
     SceneObject(ShapeType type, std::shared_ptr<PrimitiveShape> shape);
     ~SceneObject();
 
-    // /ȡλ
+    // 设置/获取位置
     void SetPosition(const DirectX::XMFLOAT3& pos);
     DirectX::XMFLOAT3 GetPosition() const { return m_position; }
 
-    // /ȡ
+    // 设置/获取缩放
     void SetScale(float scale);
     float GetScale() const { return m_scale; }
 
-    // /ȡתڲȣ
+    // 设置/获取旋转（内部弧度）
     void SetRotation(const DirectX::XMFLOAT3& rotation);
     DirectX::XMFLOAT3 GetRotation() const { return m_rotation; }
 
-    // 
+    // 材质
     const Material& GetMaterial() const { return m_material; }
-    void SetMaterial(const Material& material) { m_material = material; }
+    void SetMaterial(const Material& material) { m_material = material; Touch(); }
 
-    // A · +  + ӳ䷽ʽ
-    void SetTexturePath(const std::wstring& path) { m_texturePath = path; }
+    // 纹理（A 方案：保存路径 + 风格 + 映射方式）
+    void SetTexturePath(const std::wstring& path) { m_texturePath = path; Touch(); }
     const std::wstring& GetTexturePath() const { return m_texturePath; }
 
-    void SetTextureMappingMode(TextureMappingMode mode) { m_textureMappingMode = mode; }
+    void SetTextureMappingMode(TextureMappingMode mode) { m_textureMappingMode = mode; Touch(); }
     TextureMappingMode GetTextureMappingMode() const { return m_textureMappingMode; }
 
-    void SetTextureStyle(TextureStyle style) { m_textureStyle = style; }
+    void SetTextureStyle(TextureStyle style) { m_textureStyle = style; Touch(); }
     TextureStyle GetTextureStyle() const { return m_textureStyle; }
 
-    // ѡ״̬
-    void SetSelected(bool selected) { m_isSelected = selected; }
+    // 选中状态
+    void SetSelected(bool selected)
+    {
+        if (m_isSelected != selected)
+        {
+            m_isSelected = selected;
+            Touch();
+        }
+    }
     bool IsSelected() const { return m_isSelected; }
 
-    // ȡ״
+    // 在场景对象数组中的下标（即选中位集的位号），由场景增删对象时维护；不影响渲染，不换版本号
+    void SetSceneIndex(uint32_t index) { m_sceneIndex = index; }
+    uint32_t GetSceneIndex() const { return m_sceneIndex; }
+
+    // 变换、材质、选中或纹理状态每次变化都换一个新版本号（全局递增，不同对象间也不会重复）
+    uint64_t GetVersion() const { return m_version; }
+
+    // 获取形状类型
     ShapeType GetType() const { return m_type; }
 
-    // ȡ
+    // 获取几何体
     PrimitiveShape* GetShape() const { return m_shape.get(); }
 
-    // ȡ
+    // 获取世界矩阵
     DirectX::XMMATRIX GetWorldMatrix() const;
 
-    // ߽⣨ʰȡ
+    // 世界空间轴对齐包围盒（由几何体模型空间包围盒经世界矩阵变换得到）
+    void GetWorldAABB(DirectX::XMFLOAT3& outMin, DirectX::XMFLOAT3& outMax) const;
+
+    // 边界球检测（用于鼠标拾取）
     float GetBoundingRadius() const;
     bool IntersectRay(const DirectX::XMVECTOR& rayOrigin,
         const DirectX::XMVECTOR& rayDir,
         float& distance) const;
 
+private:
+    void Touch();
+
 private:
     ShapeType m_type;
     std::shared_ptr<PrimitiveShape> m_shape;
@@ -97,6 +118,8 @@ private:
     DirectX::XMFLOAT3 m_rotation;
     float m_scale;
     bool m_isSelected;
+    uint32_t m_sceneIndex = 0;
+    uint64_t m_version = 0;
 
     Material m_material{};
 
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#include <intrin.h>
+#endif
+
+// 稠密位集：按对象在 m_sceneObjects 中的下标记录选中状态
+class SelectionSet
+{
+public:
+    // 调整容量（新增位为 0）
+    void Resize(size_t count)
+    {
+        m_count = count;
+        m_words.resize((count + 63) / 64, 0);
+        TrimTail();
+    }
+
+    size_t Size() const { return m_count; }
+
+    void Set(size_t index)
+    {
+        if (index >= m_count)
+        {
+            Resize(index + 1);
+        }
+        m_words[index >> 6] |= (1ull << (index & 63));
+    }
+
+    void Reset(size_t index)
+    {
+        if (index < m_count)
+        {
+            m_words[index >> 6] &= ~(1ull << (index & 63));
+        }
+    }
+
+    bool Test(size_t index) const
+    {
+        return index < m_count && (m_words[index >> 6] & (1ull << (index & 63))) != 0;
+    }
+
+    void Clear()
+    {
+        m_words.clear();
+        m_count = 0;
+    }
+
+    bool Any() const
+    {
+        for (uint64_t w : m_words)
+        {
+            if (w) return true;
+        }
+        return false;
+    }
+
+    size_t Count() const
+    {
+        size_t n = 0;
+        for (uint64_t w : m_words)
+        {
+            while (w)
+            {
+                w &= w - 1;
+                ++n;
+            }
+        }
+        return n;
+    }
+
+    // 按升序遍历所有置位下标
+    template <typename Fn>
+    void ForEach(Fn&& fn) const
+    {
+        for (size_t wi = 0; wi < m_words.size(); ++wi)
+        {
+            uint64_t w = m_words[wi];
+            while (w)
+            {
+                fn(wi * 64 + LowestBit(w));
+                w &= w - 1;
+            }
+        }
+    }
+
+    // 直接访问底层字，供批量测试写入
+    uint64_t* Words() { return m_words.data(); }
+    const uint64_t* Words() const { return m_words.data(); }
+
+private:
+    static unsigned LowestBit(uint64_t w)
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long index;
+        _BitScanForward64(&index, w);
+        return (unsigned)index;
+#elif defined(__GNUC__)
+        return (unsigned)__builtin_ctzll(w);
+#else
+        unsigned bit = 0;
+        while (((w >> bit) & 1ull) == 0)
+        {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    // 保证超出 m_count 的位始终为 0
+    void TrimTail()
+    {
+        if (!m_words.empty() && (m_count & 63) != 0)
+        {
+            m_words.back() &= (1ull << (m_count & 63)) - 1;
+        }
+    }
+
+private:
+    std::vector<uint64_t> m_words;
+    size_t m_count = 0;
+};
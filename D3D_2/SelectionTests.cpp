@@ -0,0 +1,230 @@
+#include "SelfTest.h"
+#include "Frustum.h"
+#include "SelectionSet.h"
+#include <cmath>
+#include <random>
+
+using namespace DirectX;
+
+// ============================================================================
+// 框选：屏幕矩形的子视锥 + 批量包围球测试写入选中位集
+// ============================================================================
+namespace
+{
+    const int ScreenWidth = 800;
+    const int ScreenHeight = 600;
+
+    // 9 列 x 8 行、间距 1 的小球铺在 z = 0 上，相机在 z = -10 看向 +z；
+    // 再加上少量特意摆放的球（总数不是 4 的倍数且超过 64，覆盖 SIMD 尾部与多个字）
+    struct SphereLayout
+    {
+        std::vector<float> X, Y, Z, Radius;
+
+        size_t Add(float x, float y, float z, float radius)
+        {
+            X.push_back(x);
+            Y.push_back(y);
+            Z.push_back(z);
+            Radius.push_back(radius);
+            return X.size() - 1;
+        }
+
+        size_t Size() const { return X.size(); }
+    };
+
+    float GridX(int column) { return -4.0f + column; }
+    float GridY(int row) { return -3.5f + row; }
+    size_t GridIndex(int column, int row) { return (size_t)row * 9 + column; }
+
+    struct Camera
+    {
+        XMMATRIX View;
+        XMMATRIX Proj;
+    };
+
+    Camera MakeCamera()
+    {
+        Camera camera;
+        camera.View = XMMatrixLookAtLH(XMVectorSet(0.0f, 0.0f, -10.0f, 1.0f), XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        camera.Proj = XMMatrixPerspectiveFovLH(XMConvertToRadians(60.0f), (float)ScreenWidth / ScreenHeight, 1.0f, 100.0f);
+        return camera;
+    }
+
+    // 世界坐标投影到屏幕像素
+    XMFLOAT2 Project(const Camera& camera, float x, float y, float z)
+    {
+        const XMVECTOR ndc = XMVector3TransformCoord(XMVectorSet(x, y, z, 1.0f), camera.View * camera.Proj);
+        return XMFLOAT2((XMVectorGetX(ndc) + 1.0f) * 0.5f * ScreenWidth, (1.0f - XMVectorGetY(ndc)) * 0.5f * ScreenHeight);
+    }
+
+    // 框选结果写入一个位集
+    bool SelectRect(const Camera& camera, const SphereLayout& layout, int x0, int y0, int x1, int y1, SelectionSet& out)
+    {
+        out.Clear();
+        Frustum frustum;
+        if (!Frustum::FromScreenRect(camera.View, camera.Proj, ScreenWidth, ScreenHeight, x0, y0, x1, y1, frustum))
+        {
+            return false;
+        }
+        out.Resize(layout.Size());
+        frustum.TestSpheres(layout.X.data(), layout.Y.data(), layout.Z.data(), layout.Radius.data(), layout.Size(), out.Words());
+        return true;
+    }
+
+    bool SameBits(const SelectionSet& set, const std::vector<size_t>& expected)
+    {
+        if (set.Count() != expected.size())
+        {
+            return false;
+        }
+        for (size_t index : expected)
+        {
+            if (!set.Test(index))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void TestSelection(SelfTestContext& ctx)
+{
+    // SelectionSet：越界 Set 自动扩容、Reset、按升序遍历、Resize 截掉尾部的位
+    {
+        SelectionSet set;
+        SELF_CHECK(ctx, !set.Any() && set.Count() == 0 && !set.Test(5));
+        set.Set(3);
+        set.Set(130);
+        set.Set(64);
+        set.Set(63);
+        SELF_CHECK(ctx, set.Size() == 131 && set.Count() == 4 && set.Test(64) && !set.Test(65));
+        std::vector<size_t> order;
+        set.ForEach([&](size_t i) { order.push_back(i); });
+        SELF_CHECK(ctx, (order == std::vector<size_t>{ 3, 63, 64, 130 }));
+        set.Reset(63);
+        set.Reset(1000);
+        SELF_CHECK(ctx, set.Count() == 3 && !set.Test(63));
+        set.Resize(100);
+        SELF_CHECK(ctx, set.Count() == 2 && !set.Test(130));
+        set.Resize(200);
+        SELF_CHECK(ctx, set.Count() == 2 && !set.Test(130));
+        set.Clear();
+        SELF_CHECK(ctx, !set.Any() && set.Size() == 0);
+    }
+
+    const Camera camera = MakeCamera();
+    SphereLayout layout;
+    for (int row = 0; row < 8; ++row)
+    {
+        for (int column = 0; column < 9; ++column)
+        {
+            layout.Add(GridX(column), GridY(row), 0.0f, 0.1f);
+        }
+    }
+    // 与第 0 列同一视线方向，但在相机后面 / 远平面之外
+    const size_t behind = layout.Add(GridX(0) * -1.0f, 0.0f, -20.0f, 0.1f);
+    const size_t beyondFar = layout.Add(GridX(0) * 20.0f, 0.0f, 190.0f, 0.1f);
+    // 球心在第 1、2 列之间那条边界外侧：半径够大的跨过边界算选中，小的不算
+    const size_t straddling = layout.Add(-3.3f, 0.0f, 5.0f, 0.6f);
+    const size_t nearMiss = layout.Add(-3.0f, 0.0f, 5.0f, 0.6f);
+    // 屏幕外
+    const size_t offscreen = layout.Add(30.0f, 0.0f, 0.0f, 0.1f);
+    SELF_CHECK(ctx, layout.Size() % 4 != 0 && layout.Size() > 64);
+
+    // 列、行之间的屏幕分界线：相邻两列（行）投影的中点
+    auto columnEdge = [&](int column)
+    {
+        return (int)std::lround((Project(camera, GridX(column), 0, 0).x + Project(camera, GridX(column + 1), 0, 0).x) * 0.5f);
+    };
+    auto rowEdge = [&](int row)
+    {
+        return (int)std::lround((Project(camera, 0, GridY(row), 0).y + Project(camera, 0, GridY(row + 1), 0).y) * 0.5f);
+    };
+
+    // 左侧两列的全部行：恰好这 16 个球，外加跨边界的大球；相机后面与远平面外的不选
+    SelectionSet selection;
+    std::vector<size_t> expected;
+    for (int row = 0; row < 8; ++row)
+    {
+        expected.push_back(GridIndex(0, row));
+        expected.push_back(GridIndex(1, row));
+    }
+    expected.push_back(straddling);
+    SELF_CHECK(ctx, SelectRect(camera, layout, 0, 0, columnEdge(1), ScreenHeight, selection));
+    SELF_CHECK(ctx, SameBits(selection, expected));
+    SELF_CHECK(ctx, !selection.Test(behind) && !selection.Test(beyondFar) && !selection.Test(nearMiss));
+
+    // 反向拖动（从右下拖到左上）得到同样的集合
+    SELF_CHECK(ctx, SelectRect(camera, layout, columnEdge(1), ScreenHeight, 0, 0, selection));
+    SELF_CHECK(ctx, SameBits(selection, expected));
+
+    // 只框住正中一个球（第 4 列第 3 行），四种拖动方向都一样
+    {
+        const int left = columnEdge(3), right = columnEdge(4);
+        const int top = rowEdge(3), bottom = rowEdge(2);   // 屏幕 y 向下，行号大的在上
+        const std::vector<size_t> single = { GridIndex(4, 3) };
+        SELF_CHECK(ctx, SelectRect(camera, layout, left, top, right, bottom, selection) && SameBits(selection, single));
+        SELF_CHECK(ctx, SelectRect(camera, layout, right, bottom, left, top, selection) && SameBits(selection, single));
+        SELF_CHECK(ctx, SelectRect(camera, layout, right, top, left, bottom, selection) && SameBits(selection, single));
+        SELF_CHECK(ctx, SelectRect(camera, layout, left, bottom, right, top, selection) && SameBits(selection, single));
+    }
+
+    // 零面积与不足 2 像素的矩形视为取消选择
+    SELF_CHECK(ctx, !SelectRect(camera, layout, 400, 300, 400, 300, selection) && !selection.Any());
+    SELF_CHECK(ctx, !SelectRect(camera, layout, 100, 100, 100, 500, selection));
+    SELF_CHECK(ctx, !SelectRect(camera, layout, 100, 100, 700, 101, selection));
+    SELF_CHECK(ctx, SelectRect(camera, layout, 100, 100, 102, 102, selection));
+
+    // 全屏框选：屏幕内的全部选中（跨边界的两个大球在屏幕内）
+    {
+        SELF_CHECK(ctx, SelectRect(camera, layout, 0, 0, ScreenWidth, ScreenHeight, selection));
+        std::vector<size_t> all;
+        for (size_t i = 0; i < 72; ++i)
+        {
+            all.push_back(i);
+        }
+        all.push_back(straddling);
+        all.push_back(nearMiss);
+        SELF_CHECK(ctx, SameBits(selection, all) && !selection.Test(offscreen));
+    }
+
+    // 屏幕射线：像素中心的射线穿过投影到该像素的点
+    {
+        const XMFLOAT2 pixel = Project(camera, GridX(2), GridY(6), 0.0f);
+        XMVECTOR origin, dir;
+        ScreenPointToRay(camera.View, camera.Proj, ScreenWidth, ScreenHeight, (int)std::lround(pixel.x), (int)std::lround(pixel.y), origin, dir);
+        const float t = -XMVectorGetZ(origin) / XMVectorGetZ(dir);
+        const XMVECTOR hit = origin + dir * t;
+        SELF_CHECK(ctx, std::fabs(XMVectorGetX(hit) - GridX(2)) < 0.03f && std::fabs(XMVectorGetY(hit) - GridY(6)) < 0.03f);
+    }
+
+    // 批量测试与逐个 IntersectsSphere 一致（随机子视锥、随机球）
+    {
+        std::mt19937 rng(27);
+        std::uniform_int_distribution<int> px(0, ScreenWidth), py(0, ScreenHeight);
+        std::uniform_real_distribution<float> coord(-12.0f, 12.0f), depth(-15.0f, 110.0f), radius(0.0f, 2.0f);
+        SphereLayout random;
+        for (int i = 0; i < 203; ++i)
+        {
+            random.Add(coord(rng), coord(rng), depth(rng), radius(rng));
+        }
+        uint32_t mismatches = 0;
+        for (int round = 0; round < 50; ++round)
+        {
+            Frustum frustum;
+            if (!Frustum::FromScreenRect(camera.View, camera.Proj, ScreenWidth, ScreenHeight, px(rng), py(rng), px(rng), py(rng), frustum))
+            {
+                continue;
+            }
+            SelectionSet bits;
+            bits.Resize(random.Size());
+            frustum.TestSpheres(random.X.data(), random.Y.data(), random.Z.data(), random.Radius.data(), random.Size(), bits.Words());
+            for (size_t i = 0; i < random.Size(); ++i)
+            {
+                mismatches += bits.Test(i) != frustum.IntersectsSphere(XMFLOAT3(random.X[i], random.Y[i], random.Z[i]), random.Radius[i]);
+            }
+        }
+        SELF_CHECK(ctx, mismatches == 0);
+    }
+}
@@ -0,0 +1,77 @@
+#include "SelfTest.h"
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    struct SelfTestCase
+    {
+        const char* Name;
+        void (*Run)(SelfTestContext& ctx);
+    };
+
+    const SelfTestCase SelfTestCases[] = {
+        { "SpatialGrid", TestSpatialGrid },
+        { "SweepAndPrune", TestSweepAndPrune },
+        { "ParallelRecorder", TestParallelRecorder },
+        { "FrameSync", TestFrameSync },
+        { "RenderThreading", TestRenderThreading },
+        { "UploadAllocator", TestUploadAllocator },
+        { "DescriptorAllocator", TestDescriptorAllocator },
+        { "FrameInvalidator", TestFrameInvalidator },
+        { "RenderGraph", TestRenderGraph },
+        { "SoftwareRasterizer", TestSoftwareRasterizer },
+        { "FrameProfiler", TestFrameProfiler },
+        { "TextureLoader", TestTextureLoader },
+        { "TextureCache", TestTextureCache },
+        { "MipGenerator", TestMipGenerator },
+        { "TextureCompressor", TestTextureCompressor },
+        { "TextureStreamer", TestTextureStreamer },
+        { "Selection", TestSelection },
+        { "OcclusionCuller", TestOcclusionCuller },
+        { "RenderQueue", TestRenderQueue },
+        { "ConstantUploadTracker", TestConstantUploadTracker },
+        { "ShaderCache", TestShaderCache },
+        { "NullGraphicsBackend", TestNullGraphicsBackend },
+        { "RenderStats", TestRenderStats },
+    };
+}
+
+void SelfTestContext::Check(bool condition, const char* expression, const char* file, int line)
+{
+    ++m_checks;
+    if (!condition)
+    {
+        ++m_failures;
+        printf("  FAILED: %s (%s:%d)\n", expression, file, line);
+    }
+}
+
+bool RunSelfTests(const char* filter)
+{
+    uint32_t passed = 0, failed = 0;
+    for (const SelfTestCase& test : SelfTestCases)
+    {
+        if (filter && filter[0] && !strstr(test.Name, filter))
+        {
+            continue;
+        }
+
+        SelfTestContext ctx;
+        test.Run(ctx);
+        printf("[%s] %s: %u checks\n", ctx.GetFailures() ? "FAIL" : " OK ", test.Name, ctx.GetChecks());
+        fflush(stdout);
+        if (ctx.GetFailures())
+        {
+            ++failed;
+        }
+        else
+        {
+            ++passed;
+        }
+    }
+
+    printf("Self-test: %u passed, %u failed\n", passed, failed);
+    fflush(stdout);
+    return failed == 0 && passed > 0;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include "FrameSync.h"
+
+// 命令行自检：/self-test [名字过滤]
+// 各组件不依赖 GPU 的确定性检查（模拟栅栏、桩解码器、参考结果），失败时打印表达式与位置，
+// 任一检查失败则进程返回非零，可直接接在构建后或 CI 里跑
+class SelfTestContext
+{
+public:
+    void Check(bool condition, const char* expression, const char* file, int line);
+    uint32_t GetFailures() const { return m_failures; }
+    uint32_t GetChecks() const { return m_checks; }
+
+private:
+    uint32_t m_failures = 0;
+    uint32_t m_checks = 0;
+};
+
+#define SELF_CHECK(ctx, condition) (ctx).Check(!!(condition), #condition, __FILE__, __LINE__)
+
+// 模拟栅栏：GPU 只在测试调用 Complete 时前进，WaitForValue 视为 GPU 立即追上
+class SimulatedFence : public IFence
+{
+public:
+    uint64_t Signal() override { return ++m_lastSignaled; }
+    uint64_t GetCompletedValue() const override { return m_completed; }
+    void WaitForValue(uint64_t value) override
+    {
+        ++m_waits;
+        Complete(value);
+    }
+    uint64_t GetLastSignaledValue() const override { return m_lastSignaled; }
+
+    // GPU 完成到 value（不超过已发出的值，不回退）
+    void Complete(uint64_t value)
+    {
+        value = value < m_lastSignaled ? value : m_lastSignaled;
+        m_completed = value > m_completed ? value : m_completed;
+    }
+    uint64_t GetWaitCount() const { return m_waits; }
+
+private:
+    uint64_t m_lastSignaled = 0;
+    uint64_t m_completed = 0;
+    uint64_t m_waits = 0;
+};
+
+// 运行名字包含 filter 的自检（filter 为空时全部运行），全部通过返回 true
+bool RunSelfTests(const char* filter);
+
+// ============================================================================
+// 各组件的自检（实现在对应的 *Tests.cpp）
+// ============================================================================
+void TestSpatialGrid(SelfTestContext& ctx);
+void TestSweepAndPrune(SelfTestContext& ctx);
+void TestParallelRecorder(SelfTestContext& ctx);
+void TestFrameSync(SelfTestContext& ctx);
+void TestRenderThreading(SelfTestContext& ctx);
+void TestUploadAllocator(SelfTestContext& ctx);
+void TestDescriptorAllocator(SelfTestContext& ctx);
+void TestFrameInvalidator(SelfTestContext& ctx);
+void TestRenderGraph(SelfTestContext& ctx);
+void TestSoftwareRasterizer(SelfTestContext& ctx);
+void TestFrameProfiler(SelfTestContext& ctx);
+void TestTextureLoader(SelfTestContext& ctx);
+void TestTextureCache(SelfTestContext& ctx);
+void TestMipGenerator(SelfTestContext& ctx);
+void TestTextureCompressor(SelfTestContext& ctx);
+void TestTextureStreamer(SelfTestContext& ctx);
+void TestSelection(SelfTestContext& ctx);
+void TestOcclusionCuller(SelfTestContext& ctx);
+void TestRenderQueue(SelfTestContext& ctx);
+void TestConstantUploadTracker(SelfTestContext& ctx);
+void TestShaderCache(SelfTestContext& ctx);
+void TestNullGraphicsBackend(SelfTestContext& ctx);
+void TestRenderStats(SelfTestContext& ctx);
+
+// ============================================================================
+// 组件级命令行基准（只跑 CPU 端数据结构，结果写到 stdout）
+// ============================================================================
+bool RunSpatialGridBenchmark(int objectCount, int frameCount);
+bool RunSweepAndPruneBenchmark(int objectCount, int frameCount);
+bool RunUploadAllocatorBenchmark(int allocationsPerFrame, int frameCount);
+bool RunDescriptorAllocatorBenchmark(int operations);
+bool RunOcclusionBenchmark(int objectCount, int frameCount);
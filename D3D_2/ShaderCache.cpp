@@ -0,0 +1,213 @@
+#include "ShaderCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+    const uint32_t BlobMagic = 0x42435344; // "DSCB"
+
+    struct BlobHeader
+    {
+        uint32_t Magic;
+        uint32_t FormatVersion;
+        uint64_t Key;
+        uint64_t Size;
+        uint64_t ContentHash;
+    };
+}
+
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+uint64_t HashString(const std::string& text, uint64_t seed)
+{
+    // 带上长度，避免 "ab"+"c" 与 "a"+"bc" 这类拼接得到相同的哈希
+    uint64_t length = text.size();
+    return HashBytes(text.data(), text.size(), HashBytes(&length, sizeof(length), seed));
+}
+
+uint64_t MakeShaderKey(uint64_t sourceHash, const std::string& entry, const std::string& profile,
+    const std::vector<ShaderDefine>& defines, uint32_t compileFlags)
+{
+    std::vector<ShaderDefine> sorted = defines;
+    std::sort(sorted.begin(), sorted.end(), [](const ShaderDefine& a, const ShaderDefine& b)
+    {
+        return a.Name < b.Name;
+    });
+
+    uint64_t hash = HashBytes(&sourceHash, sizeof(sourceHash));
+    hash = HashString(entry, hash);
+    hash = HashString(profile, hash);
+    for (const ShaderDefine& define : sorted)
+    {
+        hash = HashString(define.Name, hash);
+        hash = HashString(define.Value, hash);
+    }
+    return HashBytes(&compileFlags, sizeof(compileFlags), hash);
+}
+
+// ============================================================================
+// 磁盘缓存
+// ============================================================================
+BlobCache::BlobCache(const std::filesystem::path& directory, uint32_t formatVersion)
+    : m_directory(directory)
+    , m_formatVersion(formatVersion)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+}
+
+std::filesystem::path BlobCache::PathFor(uint64_t key) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return m_directory / name;
+}
+
+bool BlobCache::Load(uint64_t key, std::vector<uint8_t>& out)
+{
+    std::filesystem::path path = PathFor(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        ++m_misses;
+        return false;
+    }
+
+    BlobHeader header{};
+    bool valid = file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+        header.Magic == BlobMagic && header.FormatVersion == m_formatVersion && header.Key == key;
+    if (valid)
+    {
+        out.resize((size_t)header.Size);
+        valid = file.read(reinterpret_cast<char*>(out.data()), (std::streamsize)out.size()) &&
+            file.peek() == std::char_traits<char>::eof() &&
+            HashBytes(out.data(), out.size()) == header.ContentHash;
+    }
+    file.close();
+
+    std::error_code ec;
+    if (!valid)
+    {
+        out.clear();
+        std::filesystem::remove(path, ec);
+        ++m_misses;
+        return false;
+    }
+
+    // 修改时间充当最近使用时间，其他构建或实例据此判断条目是否还有人用
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    Touch(key);
+    ++m_hits;
+    return true;
+}
+
+bool BlobCache::Store(uint64_t key, const void* data, size_t size)
+{
+    std::filesystem::path path = PathFor(key);
+    std::filesystem::path temp = path;
+    temp += "." + std::to_string(m_nextTemp.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+
+    BlobHeader header{ BlobMagic, m_formatVersion, key, (uint64_t)size, HashBytes(data, size) };
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file ||
+            !file.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+            !file.write(static_cast<const char*>(data), (std::streamsize)size))
+        {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(temp, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+
+    Touch(key);
+    return true;
+}
+
+void BlobCache::Touch(uint64_t key)
+{
+    std::lock_guard<std::mutex> lock(m_touchedMutex);
+    m_touched.insert(key);
+}
+
+void BlobCache::Remove(uint64_t key)
+{
+    std::error_code ec;
+    std::filesystem::remove(PathFor(key), ec);
+    std::lock_guard<std::mutex> lock(m_touchedMutex);
+    m_touched.erase(key);
+}
+
+size_t BlobCache::RemoveUnused(std::chrono::seconds maxAge)
+{
+    const std::filesystem::file_time_type cutoff = std::filesystem::file_time_type::clock::now() - maxAge;
+    std::vector<std::filesystem::path> stale;
+    std::lock_guard<std::mutex> lock(m_touchedMutex);
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(m_directory, ec), end; !ec && it != end; it.increment(ec))
+    {
+        const std::filesystem::path& path = it->path();
+        const std::string extension = path.extension().string();
+        std::error_code timeError;
+        const bool old = std::filesystem::last_write_time(path, timeError) < cutoff && !timeError;
+        if (extension == ".tmp")
+        {
+            if (old)
+            {
+                stale.push_back(path);
+            }
+            continue;
+        }
+        if (extension != ".bin")
+        {
+            continue;
+        }
+
+        unsigned long long key = 0;
+        if (sscanf(path.stem().string().c_str(), "%16llx", &key) != 1)
+        {
+            continue;
+        }
+        if (m_touched.count((uint64_t)key) != 0)
+        {
+            continue;
+        }
+
+        // 其他版本的程序写下的条目本版本永远读不了，不必等到过期
+        BlobHeader header{};
+        std::ifstream file(path, std::ios::binary);
+        const bool current = file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+            header.Magic == BlobMagic && header.FormatVersion == m_formatVersion;
+        file.close();
+        if (!current || old)
+        {
+            stale.push_back(path);
+        }
+    }
+
+    for (const std::filesystem::path& path : stale)
+    {
+        std::filesystem::remove(path, ec);
+    }
+    return stale.size();
+}
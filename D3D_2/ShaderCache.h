@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// 64 位 FNV-1a，用于源文件内容与缓存键
+const uint64_t HashSeed = 0xCBF29CE484222325ull;
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed = HashSeed);
+uint64_t HashString(const std::string& text, uint64_t seed = HashSeed);
+
+struct ShaderDefine
+{
+    std::string Name;
+    std::string Value;
+};
+
+// 着色器缓存键：源文件内容哈希 + 入口 + 目标 profile + 宏（与声明顺序无关）+ 编译选项。
+// 源文件任何改动都会得到新键，旧条目自然失效
+uint64_t MakeShaderKey(uint64_t sourceHash, const std::string& entry, const std::string& profile,
+    const std::vector<ShaderDefine>& defines, uint32_t compileFlags);
+
+// 磁盘上的二进制缓存：每个键一个文件 <16 位十六进制键>.bin，
+// 文件头带格式版本、键、长度和内容哈希，读取时校验，不匹配（损坏或旧格式）的文件当作未命中并删除。
+// 写入先写临时文件再改名，进程中途退出不会留下半个文件。命中时刷新文件的修改时间，
+// 目录可以被多个构建（Debug/Release 的编译选项不同，键也不同）和同时运行的多个实例共用。
+// 可在多个线程上并发调用（纹理加载在工作线程上读写）
+class BlobCache
+{
+public:
+    BlobCache(const std::filesystem::path& directory, uint32_t formatVersion);
+
+    bool Load(uint64_t key, std::vector<uint8_t>& out);
+    bool Store(uint64_t key, const void* data, size_t size);
+    void Remove(uint64_t key);
+
+    // 删除本次运行没有用到、且超过 maxAge 没有被读写的条目（源文件或设置变化后留下的旧键），
+    // 以及格式版本不符的条目；临时文件同样超过 maxAge 才删（可能是其他实例正在写的）
+    size_t RemoveUnused(std::chrono::seconds maxAge);
+
+    const std::filesystem::path& GetDirectory() const { return m_directory; }
+    uint32_t GetHitCount() const { return m_hits.load(std::memory_order_relaxed); }
+    uint32_t GetMissCount() const { return m_misses.load(std::memory_order_relaxed); }
+
+private:
+    std::filesystem::path PathFor(uint64_t key) const;
+    void Touch(uint64_t key);
+
+private:
+    std::filesystem::path m_directory;
+    uint32_t m_formatVersion;
+    std::mutex m_touchedMutex;
+    std::unordered_set<uint64_t> m_touched;
+    std::atomic<uint32_t> m_nextTemp{ 0 };      // 临时文件名序号：并发写同一个键时互不覆盖
+    std::atomic<uint32_t> m_hits{ 0 };
+    std::atomic<uint32_t> m_misses{ 0 };
+};
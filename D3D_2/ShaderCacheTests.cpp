@@ -0,0 +1,172 @@
+#include "SelfTest.h"
+#include "ShaderCache.h"
+#include <cstdio>
+#include <fstream>
+
+// ============================================================================
+// ShaderCache：缓存键覆盖全部输入；磁盘条目往返、损坏/截断/旧格式当作未命中；
+// 清理只删长期没人用的条目与旧格式条目
+// ============================================================================
+namespace
+{
+    std::filesystem::path EntryPath(const std::filesystem::path& dir, uint64_t key)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+        return dir / name;
+    }
+
+    std::vector<uint8_t> MakeBlob(size_t size, uint8_t seed)
+    {
+        std::vector<uint8_t> blob(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            blob[i] = (uint8_t)(seed + i * 31);
+        }
+        return blob;
+    }
+
+    // 把文件的修改时间往前拨
+    void Age(const std::filesystem::path& path, std::chrono::hours age)
+    {
+        std::error_code ec;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now() - age, ec);
+    }
+}
+
+void TestShaderCache(SelfTestContext& ctx)
+{
+    // 键：任一输入变化都得到新键；宏与声明顺序无关；字符串拼接边界不混淆
+    {
+        const std::vector<ShaderDefine> defines = { { "USE_TEXTURE", "1" }, { "MAPPING", "2" } };
+        const uint64_t base = MakeShaderKey(1234, "PS", "ps_5_0", defines, 0);
+        SELF_CHECK(ctx, base == MakeShaderKey(1234, "PS", "ps_5_0", defines, 0));
+        SELF_CHECK(ctx, base != MakeShaderKey(1235, "PS", "ps_5_0", defines, 0));
+        SELF_CHECK(ctx, base != MakeShaderKey(1234, "VS", "ps_5_0", defines, 0));
+        SELF_CHECK(ctx, base != MakeShaderKey(1234, "PS", "ps_5_1", defines, 0));
+        SELF_CHECK(ctx, base != MakeShaderKey(1234, "PS", "ps_5_0", { { "USE_TEXTURE", "0" }, { "MAPPING", "2" } }, 0));
+        SELF_CHECK(ctx, base != MakeShaderKey(1234, "PS", "ps_5_0", { { "USE_TEXTURE", "1" } }, 0));
+        SELF_CHECK(ctx, base != MakeShaderKey(1234, "PS", "ps_5_0", defines, 1));
+        SELF_CHECK(ctx, base == MakeShaderKey(1234, "PS", "ps_5_0", { { "MAPPING", "2" }, { "USE_TEXTURE", "1" } }, 0));
+        SELF_CHECK(ctx, MakeShaderKey(0, "PSa", "b", {}, 0) != MakeShaderKey(0, "PS", "ab", {}, 0));
+        SELF_CHECK(ctx, MakeShaderKey(0, "PS", "ps_5_0", { { "AB", "" } }, 0) != MakeShaderKey(0, "PS", "ps_5_0", { { "A", "B" } }, 0));
+
+        const std::vector<uint8_t> source = MakeBlob(100, 1);
+        std::vector<uint8_t> edited = source;
+        edited[50] ^= 1;
+        SELF_CHECK(ctx, HashBytes(source.data(), source.size()) != HashBytes(edited.data(), edited.size()));
+    }
+
+    std::error_code error;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path(error) / "D3D_2-ShaderCacheTest";
+    std::filesystem::remove_all(dir, error);
+
+    // 往返：写入后另一个实例（下一次运行）读回逐字节相同；没有的键未命中
+    const std::vector<uint8_t> blobA = MakeBlob(1000, 7), blobB = MakeBlob(3, 9);
+    {
+        BlobCache cache(dir, 1);
+        SELF_CHECK(ctx, cache.Store(0xA, blobA.data(), blobA.size()) && cache.Store(0xB, blobB.data(), blobB.size()));
+        SELF_CHECK(ctx, cache.Store(0xE, nullptr, 0));
+    }
+    {
+        BlobCache cache(dir, 1);
+        std::vector<uint8_t> out;
+        SELF_CHECK(ctx, cache.Load(0xA, out) && out == blobA);
+        SELF_CHECK(ctx, cache.Load(0xB, out) && out == blobB);
+        SELF_CHECK(ctx, cache.Load(0xE, out) && out.empty());
+        SELF_CHECK(ctx, !cache.Load(0xC, out));
+        SELF_CHECK(ctx, cache.GetHitCount() == 3 && cache.GetMissCount() == 1);
+    }
+
+    // 损坏：截断、内容翻转一位、尾部多出数据、文件名与头中的键不符，都当作未命中并删除
+    {
+        auto corrupt = [&](uint64_t key, auto&& edit)
+        {
+            std::ifstream in(EntryPath(dir, key), std::ios::binary);
+            std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            in.close();
+            edit(bytes);
+            std::ofstream(EntryPath(dir, key), std::ios::binary | std::ios::trunc).write(bytes.data(), (std::streamsize)bytes.size());
+        };
+
+        BlobCache cache(dir, 1);
+        std::vector<uint8_t> out;
+        const uint64_t keys[] = { 0x10, 0x11, 0x12, 0x13 };
+        for (uint64_t key : keys)
+        {
+            cache.Store(key, blobA.data(), blobA.size());
+        }
+        corrupt(0x10, [](std::vector<char>& b) { b.resize(b.size() - 10); });
+        corrupt(0x11, [](std::vector<char>& b) { b[b.size() - 100] ^= 4; });
+        corrupt(0x12, [](std::vector<char>& b) { b.push_back(0); });
+        std::filesystem::copy_file(EntryPath(dir, 0x13), EntryPath(dir, 0x14), error);
+
+        uint32_t misses = 0;
+        for (uint64_t key : { 0x10ull, 0x11ull, 0x12ull, 0x14ull })
+        {
+            misses += !cache.Load(key, out) && out.empty() && !std::filesystem::exists(EntryPath(dir, key));
+        }
+        SELF_CHECK(ctx, misses == 4);
+        SELF_CHECK(ctx, cache.Load(0x13, out) && out == blobA);
+
+        // 只剩半个文件头
+        corrupt(0x13, [](std::vector<char>& b) { b.resize(12); });
+        SELF_CHECK(ctx, !cache.Load(0x13, out));
+    }
+
+    // 格式版本变化：旧条目对新版本是未命中（并删除），新版本写入的对旧版本同样无效
+    {
+        {
+            BlobCache v1(dir, 1);
+            v1.Store(0x20, blobA.data(), blobA.size());
+        }
+        BlobCache v2(dir, 2);
+        std::vector<uint8_t> out;
+        SELF_CHECK(ctx, !v2.Load(0x20, out) && !std::filesystem::exists(EntryPath(dir, 0x20)));
+        v2.Store(0x21, blobB.data(), blobB.size());
+        BlobCache v1(dir, 1);
+        SELF_CHECK(ctx, !v1.Load(0x21, out));
+    }
+
+    // 清理：本次用到的、最近被别的构建/实例读写过的、正在写的临时文件都保留；
+    // 过期未用的、旧格式的、过期的临时文件删除
+    {
+        std::filesystem::remove_all(dir, error);
+        {
+            BlobCache other(dir, 1);    // 另一个构建（键不同）
+            other.Store(0x30, blobA.data(), blobA.size());
+            other.Store(0x31, blobA.data(), blobA.size());
+            other.Store(0x32, blobA.data(), blobA.size());
+            BlobCache old(dir, 0);      // 旧版本的程序
+            old.Store(0x33, blobA.data(), blobA.size());
+        }
+        std::ofstream(dir / "0000000000000034.bin.0.tmp", std::ios::binary) << "partial";
+        std::ofstream(dir / "0000000000000035.bin.7.tmp", std::ios::binary) << "partial";
+        std::ofstream(dir / "readme.txt") << "not a cache entry";
+
+        const std::chrono::hours maxAge(24 * 30);
+        Age(EntryPath(dir, 0x31), maxAge * 2);
+        Age(EntryPath(dir, 0x32), maxAge * 2);
+        Age(dir / "0000000000000035.bin.7.tmp", maxAge * 2);
+
+        BlobCache cache(dir, 1);
+        std::vector<uint8_t> out;
+        SELF_CHECK(ctx, cache.Load(0x32, out));   // 命中刷新修改时间，也算本次用到
+        cache.Store(0x36, blobB.data(), blobB.size());
+        SELF_CHECK(ctx, cache.RemoveUnused(maxAge) == 3);
+
+        SELF_CHECK(ctx, std::filesystem::exists(EntryPath(dir, 0x30)));
+        SELF_CHECK(ctx, !std::filesystem::exists(EntryPath(dir, 0x31)));
+        SELF_CHECK(ctx, std::filesystem::exists(EntryPath(dir, 0x32)));
+        SELF_CHECK(ctx, !std::filesystem::exists(EntryPath(dir, 0x33)));
+        SELF_CHECK(ctx, std::filesystem::exists(dir / "0000000000000034.bin.0.tmp"));
+        SELF_CHECK(ctx, !std::filesystem::exists(dir / "0000000000000035.bin.7.tmp"));
+        SELF_CHECK(ctx, std::filesystem::exists(EntryPath(dir, 0x36)) && std::filesystem::exists(dir / "readme.txt"));
+
+        // 下一次运行没有用到 0x32，但它刚被读过，不算过期
+        BlobCache next(dir, 1);
+        SELF_CHECK(ctx, next.RemoveUnused(maxAge) == 0 && std::filesystem::exists(EntryPath(dir, 0x32)));
+    }
+
+    std::filesystem::remove_all(dir, error);
+}
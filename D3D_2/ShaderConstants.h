@@ -0,0 +1,43 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+// 着色器常量的 C++ 端布局，GPU 上传与软件光栅化（SoftwareRasterizer）共用。
+// 矩阵按 HLSL 默认的列主序打包，写入前已转置
+
+// 每实例数据（对应 Shaders.hlsl 中的 InstanceData，StructuredBuffer 中紧密排列）
+// 只含对象自身的状态，相机不动、对象不变时内容不变
+struct ObjectConstants
+{
+    DirectX::XMFLOAT4X4 World;
+    DirectX::XMFLOAT4 HighlightColor; // 用于高亮选中对象
+
+    DirectX::XMFLOAT3 BaseColor;
+    float SpecularStrength;
+	// 材质属性
+    float MatShininess;
+    float TexScale;
+    float TexOffsetU;
+    float TexOffsetV;
+	// 纹理映射模式
+    int TexMappingMode;
+    int TexStyle;
+    int HasTexture;
+    float Pad0;
+};
+
+struct PassConstants
+{
+    DirectX::XMFLOAT4X4 ViewProj;
+
+    DirectX::XMFLOAT3 LightPosW;
+    float Ambient;
+
+    float Diffuse;
+    float Specular;
+    float Shininess;
+    float Pad0;
+
+    DirectX::XMFLOAT3 EyePosW;
+    float Pad1;
+};
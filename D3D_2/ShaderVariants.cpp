@@ -0,0 +1,22 @@
+#include "ShaderVariants.h"
+
+namespace ShaderVariant
+{
+    std::vector<ShaderDefine> GetDefines(uint32_t variant)
+    {
+        std::vector<ShaderDefine> defines;
+        if (variant >= VariantCount)
+        {
+            return defines;
+        }
+
+        const Desc& desc = Variants[variant];
+        defines.push_back({ "TEX_MAPPING_MODE", std::to_string(desc.Mapping) });
+        if (desc.Style != StyleUnused)
+        {
+            defines.push_back({ "TEX_STYLE", std::to_string(desc.Style) });
+        }
+        defines.push_back({ "HAS_TEXTURE", std::to_string(desc.HasTexture) });
+        return defines;
+    }
+}
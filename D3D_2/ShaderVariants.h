@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "ShaderCache.h"
+
+// 像素着色器变体：按纹理映射方式、图案样式和是否采样纹理特化编译，
+// 对应 Shaders.hlsl 中的 TEX_MAPPING_MODE / TEX_STYLE / HAS_TEXTURE 宏。
+// 编码与选择表都在编译期生成，下方的 static_assert 检查每种可能的输入都有对应的变体。
+namespace ShaderVariant
+{
+    const uint32_t MappingCount = 3;    // Planar / Cylindrical / Spherical
+    const uint32_t StyleCount = 3;      // Checker / Stripes / ImagePlaceholder
+    const uint32_t StyleUnused = 0xFF;  // 采样纹理时图案样式不参与着色，不定义 TEX_STYLE
+
+    struct Desc
+    {
+        uint8_t Mapping;
+        uint8_t Style;
+        uint8_t HasTexture;
+    };
+
+    // 与 HLSL 分支一致的归一化：0/1 之外的映射方式和样式都落到最后一个 else 分支，HasTexture 只认 1
+    constexpr uint32_t NormalizeMapping(int mode) { return mode == 0 ? 0u : mode == 1 ? 1u : 2u; }
+    constexpr uint32_t NormalizeStyle(int style) { return style == 0 ? 0u : style == 1 ? 1u : 2u; }
+    constexpr uint32_t NormalizeHasTexture(int hasTexture) { return hasTexture == 1 ? 1u : 0u; }
+
+    // 原始输入编码：mapping + style * 3 + hasTexture * 9
+    const uint32_t InputCount = MappingCount * StyleCount * 2;
+    constexpr uint32_t EncodeInput(uint32_t mapping, uint32_t style, uint32_t hasTexture)
+    {
+        return mapping + style * MappingCount + hasTexture * MappingCount * StyleCount;
+    }
+
+    // 输入实际需要的特化：采样纹理时样式无关
+    constexpr Desc Canonical(uint32_t input)
+    {
+        const uint32_t mapping = input % MappingCount;
+        const uint32_t style = (input / MappingCount) % StyleCount;
+        const uint32_t hasTexture = input / (MappingCount * StyleCount);
+        return Desc{ (uint8_t)mapping, (uint8_t)(hasTexture ? StyleUnused : style), (uint8_t)hasTexture };
+    }
+
+    constexpr bool Equal(const Desc& a, const Desc& b)
+    {
+        return a.Mapping == b.Mapping && a.Style == b.Style && a.HasTexture == b.HasTexture;
+    }
+
+    // 变体编号：[0, 9) 为图案（mapping + style * 3），[9, 12) 为纹理（9 + mapping）
+    const uint32_t VariantCount = MappingCount * StyleCount + MappingCount;
+
+    constexpr std::array<Desc, VariantCount> MakeVariants()
+    {
+        std::array<Desc, VariantCount> variants{};
+        for (uint32_t i = 0; i < VariantCount; ++i)
+        {
+            if (i < MappingCount * StyleCount)
+            {
+                variants[i] = Desc{ (uint8_t)(i % MappingCount), (uint8_t)(i / MappingCount), 0 };
+            }
+            else
+            {
+                variants[i] = Desc{ (uint8_t)(i - MappingCount * StyleCount), (uint8_t)StyleUnused, 1 };
+            }
+        }
+        return variants;
+    }
+
+    constexpr std::array<Desc, VariantCount> Variants = MakeVariants();
+
+    // 输入 -> 变体编号；找不到时为 VariantCount（由下方断言保证不会出现）
+    constexpr std::array<uint8_t, InputCount> MakeSelectionTable()
+    {
+        std::array<uint8_t, InputCount> table{};
+        for (uint32_t input = 0; input < InputCount; ++input)
+        {
+            table[input] = (uint8_t)VariantCount;
+            for (uint32_t v = 0; v < VariantCount; ++v)
+            {
+                if (Equal(Variants[v], Canonical(input)))
+                {
+                    table[input] = (uint8_t)v;
+                    break;
+                }
+            }
+        }
+        return table;
+    }
+
+    constexpr std::array<uint8_t, InputCount> SelectionTable = MakeSelectionTable();
+
+    // 参数取 ObjectConstants 中的 TexMappingMode / TexStyle / HasTexture
+    constexpr uint32_t Select(int mappingMode, int style, int hasTexture)
+    {
+        return SelectionTable[EncodeInput(NormalizeMapping(mappingMode), NormalizeStyle(style), NormalizeHasTexture(hasTexture))];
+    }
+
+    // ---- 编译期检查 ----
+    constexpr bool EveryInputHasVariant()
+    {
+        for (uint32_t input = 0; input < InputCount; ++input)
+        {
+            if (SelectionTable[input] >= VariantCount || !Equal(Variants[SelectionTable[input]], Canonical(input)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 每个变体至少被一种输入选中，且互不相同（不编译用不到或重复的变体）
+    constexpr bool EveryVariantReachable()
+    {
+        for (uint32_t v = 0; v < VariantCount; ++v)
+        {
+            bool reached = false;
+            for (uint32_t input = 0; input < InputCount; ++input)
+            {
+                reached = reached || SelectionTable[input] == v;
+            }
+            for (uint32_t w = v + 1; w < VariantCount; ++w)
+            {
+                if (Equal(Variants[v], Variants[w]))
+                {
+                    return false;
+                }
+            }
+            if (!reached)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(EveryInputHasVariant(), "shader variant table misses an input combination");
+    static_assert(EveryVariantReachable(), "shader variant table has unreachable or duplicate variants");
+    static_assert(Select(0, 0, 0) == 0 && Select(2, 2, 0) == 8 && Select(1, 2, 1) == 10, "variant numbering changed");
+    static_assert(Select(5, -1, 0) == Select(2, 2, 0) && Select(0, 1, 2) == Select(0, 1, 0), "out-of-range inputs must follow the HLSL else branches");
+    static_assert(Select(1, 0, 1) == Select(1, 2, 1), "textured variants must ignore the pattern style");
+
+    // 编译该变体用的宏
+    std::vector<ShaderDefine> GetDefines(uint32_t variant);
+}
@@ -1,24 +1,33 @@
-cbuffer cbPerObject : register(b0)
+// 每个实例的数据（与 C++ 端 ObjectConstants 布局一致）
+struct InstanceData
 {
-    float4x4 gWorldViewProj;
-    float4 gHighlightColor;
+    float4x4 World;
+    float4 HighlightColor;
 
-    float3 gBaseColor;
-    float gSpecularStrength;
+    float3 BaseColor;
+    float SpecularStrength;
 
-    float gMatShininess;
-    float gTexScale;
-    float gTexOffsetU;
-    float gTexOffsetV;
+    float MatShininess;
+    float TexScale;
+    float TexOffsetU;
+    float TexOffsetV;
 
-    int gTexMappingMode;
-    int gTexStyle;
-    int gHasTexture;
-    float _padObj;
+    int TexMappingMode;
+    int TexStyle;
+    int HasTexture;
+    float Pad0;
+};
+
+// 每次绘制的根常量：本批次第一个实例在槽位下标表中的位置
+cbuffer cbPerDraw : register(b0)
+{
+    uint gInstanceBase;
 };
 
 cbuffer cbPerPass : register(b1)
 {
+    float4x4 gViewProj;
+
     float3 gLightPosW;
     float gAmbient;
 
@@ -43,26 +52,55 @@ struct VertexOut
     float4 PosH : SV_POSITION;
     float3 NormalW : NORMAL;
     float3 PosW : POSITION1;
+    nointerpolation uint InstanceIndex : INSTANCEINDEX;
 };
 
 Texture2D gTexture : register(t0);
+StructuredBuffer<InstanceData> gInstances : register(t1);   // 按对象的持久槽位存放
+StructuredBuffer<uint> gInstanceSlots : register(t2);       // 本帧按绘制顺序排列的槽位下标
 SamplerState gSampler : register(s0);
 
-VertexOut VS(VertexIn vin)
+VertexOut VS(VertexIn vin, uint instanceID : SV_InstanceID)
 {
     VertexOut vout;
-    vout.PosH = mul(float4(vin.PosL, 1.0f), gWorldViewProj);
 
-    // ȷ=AģͿռռ䣨ʾ༭
+    // SV_InstanceID 每次绘制都从 0 开始，需要加上批次起始下标，再经槽位表找到对象常量
+    uint index = gInstanceSlots[gInstanceBase + instanceID];
+    float4 posW = mul(float4(vin.PosL, 1.0f), gInstances[index].World);
+    vout.PosH = mul(posW, gViewProj);
+    vout.InstanceIndex = index;
+
+    // 正确性=A：模型空间≈世界空间（演示编辑）
     vout.PosW = vin.PosL;
     vout.NormalW = normalize(vin.Normal);
     return vout;
 }
 
-//  UV mapping mode λúͷ
+// 着色器变体：C++ 端按 TexMappingMode / TexStyle / HasTexture 编译特化版本（见 ShaderVariants.h），
+// 定义了对应的宏时分支在编译期确定，用不到的 atan2/acos 和采样路径不会进入变体；
+// 未定义时回退为按实例常量的运行时分支
+#ifdef TEX_MAPPING_MODE
+#define INST_TEX_MAPPING_MODE(inst) TEX_MAPPING_MODE
+#else
+#define INST_TEX_MAPPING_MODE(inst) (inst).TexMappingMode
+#endif
+
+#ifdef TEX_STYLE
+#define INST_TEX_STYLE(inst) TEX_STYLE
+#else
+#define INST_TEX_STYLE(inst) (inst).TexStyle
+#endif
+
+#ifdef HAS_TEXTURE
+#define INST_HAS_TEXTURE(inst) HAS_TEXTURE
+#else
+#define INST_HAS_TEXTURE(inst) (inst).HasTexture
+#endif
+
+// 生成 UV：按 mapping mode 从位置和法线生成
 float2 CalcUV(float3 posW, float3 normalW, int mode)
 {
-    // posW  [-1,1] or [-radius,radius]һ
+    // posW 大致在 [-1,1] or [-radius,radius]，先做一个缩放
     float3 p = posW;
 
     if (mode == 0) // Planar: pick best axis by normal
@@ -84,7 +122,7 @@ float2 CalcUV(float3 posW, float3 normalW, int mode)
 
         float theta = atan2(p.z, p.x); // [-pi,pi]
         float u = (theta / 6.2831853f) + 0.5f;
-        float v = p.y; // ֱ yʾ
+        float v = p.y; // 直接用 y，演示用
         return float2(u, v);
     }
     else // Spherical
@@ -100,7 +138,7 @@ float2 CalcUV(float3 posW, float3 normalW, int mode)
 
 float Pattern(float2 uv, int style)
 {
-    // ͳһ gTexScale ƣֻͼ̬
+    // 统一缩放由 TexScale 控制，这里只决定图案形态
     if (style == 0) // Checker
     {
         float2 t = floor(uv * 8.0f);
@@ -111,7 +149,7 @@ float Pattern(float2 uv, int style)
         float v = floor(uv.x * 12.0f);
         return fmod(v, 2.0f);
     }
-    else // ImagePlaceholderѡͼƬأԵġСͼ
+    else // ImagePlaceholder（选了图片但不加载，给个更明显的“噪声感”图案）
     {
         float v = sin(uv.x * 30.0f) * cos(uv.y * 30.0f);
         return step(0.0f, v);
@@ -120,38 +158,40 @@ float Pattern(float2 uv, int style)
 
 float4 PS(VertexOut pin) : SV_Target
 {
+    InstanceData inst = gInstances[pin.InstanceIndex];
+
     float3 N = normalize(pin.NormalW);
     float3 L = normalize(gLightPosW - pin.PosW);
     float3 V = normalize(gEyePosW - pin.PosW);
     float3 H = normalize(L + V);
 
     float ndotl = saturate(dot(N, L));
-    float spec = pow(saturate(dot(N, H)), gMatShininess);
+    float spec = pow(saturate(dot(N, H)), inst.MatShininess);
 
     float3 ambient = gAmbient.xxx;
     float3 diffuse = (gDiffuse * ndotl).xxx;
-    float3 specular = (gSpecular * gSpecularStrength * spec).xxx;
+    float3 specular = (gSpecular * inst.SpecularStrength * spec).xxx;
 
-    float2 uv = CalcUV(pin.PosW, pin.NormalW, gTexMappingMode);
-    uv = uv * gTexScale + float2(gTexOffsetU, gTexOffsetV);
+    float2 uv = CalcUV(pin.PosW, pin.NormalW, INST_TEX_MAPPING_MODE(inst));
+    uv = uv * inst.TexScale + float2(inst.TexOffsetU, inst.TexOffsetV);
 
     float3 texColor;
-    if (gHasTexture == 1)
+    if (INST_HAS_TEXTURE(inst) == 1)
     {
         texColor = gTexture.Sample(gSampler, uv).rgb;
     }
     else
     {
-        float p = Pattern(uv, gTexStyle);
+        float p = Pattern(uv, INST_TEX_STYLE(inst));
         texColor = lerp(float3(0.1f, 0.1f, 0.1f), float3(1.0f, 1.0f, 1.0f), p);
     }
 
-    float3 baseColor = (gBaseColor * texColor) * (ambient + diffuse) + specular;
+    float3 baseColor = (inst.BaseColor * texColor) * (ambient + diffuse) + specular;
     float4 finalColor = float4(baseColor, 1.0f);
 
-    if (gHighlightColor.a > 0.0f)
+    if (inst.HighlightColor.a > 0.0f)
     {
-        finalColor = lerp(finalColor, gHighlightColor, gHighlightColor.a);
+        finalColor = lerp(finalColor, inst.HighlightColor, inst.HighlightColor.a);
     }
 
     return finalColor;
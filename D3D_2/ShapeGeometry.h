@@ -0,0 +1,17 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+// 顶点结构体（与 Shaders.hlsl 的 VertexIn 布局一致）
+struct Vertex
+{
+    DirectX::XMFLOAT3 Pos;
+    DirectX::XMFLOAT3 Normal;//法线
+    DirectX::XMFLOAT4 Color;
+};
+
+// 生成基本形状的模型空间几何（shapeType 取 ShapeType 的值：1 球体 ~ 5 四面体）。
+// 只依赖 DirectXMath，GPU 端（PrimitiveShape）和软件光栅化共用同一份几何
+bool GenerateShapeGeometry(int shapeType, std::vector<Vertex>& vertices, std::vector<std::uint16_t>& indices);
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// 双缓冲快照：写端（UI 线程）整体写入后台缓冲并发布，读端（渲染线程）在帧开始时换到最新一份。
+// 两端各持有一个缓冲，只通过一个原子状态字交换：
+//   - 读端只在有新数据且写端不在写入时交换，否则继续使用当前缓冲，从不等待；
+//   - 写端写入期间读端不会交换，写端也从不等待。
+// 写端每次必须写入完整状态（后台缓冲里是更早的旧数据），可以复用其中容器的容量。
+template <typename T>
+class SnapshotBuffer
+{
+public:
+    // ---- 写端（单线程）----
+    T& BeginWrite()
+    {
+        uint32_t state = m_state.fetch_or(WritingBit, std::memory_order_acq_rel);
+        return m_buffers[state & BackBit];
+    }
+
+    void Publish()
+    {
+        uint32_t state = m_state.load(std::memory_order_relaxed);
+        while (!m_state.compare_exchange_weak(state, (state | DirtyBit) & ~WritingBit,
+            std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+        }
+        m_publishCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // ---- 读端（单线程）----
+    // 返回的引用在下一次 Acquire 之前有效；changed 表示是否换到了新快照
+    const T& Acquire(bool* changed = nullptr)
+    {
+        uint32_t state = m_state.load(std::memory_order_acquire);
+        bool swapped = false;
+        if ((state & DirtyBit) && !(state & WritingBit))
+        {
+            // 写端此时开始写入会让 CAS 失败，本帧沿用旧快照
+            swapped = m_state.compare_exchange_strong(state, (state ^ BackBit) & ~DirtyBit,
+                std::memory_order_acq_rel, std::memory_order_acquire);
+            if (swapped)
+            {
+                state = (state ^ BackBit) & ~DirtyBit;
+            }
+        }
+
+        if (changed)
+        {
+            *changed = swapped;
+        }
+        return m_buffers[(state & BackBit) ^ 1];
+    }
+
+    uint64_t GetPublishCount() const { return m_publishCount.load(std::memory_order_relaxed); }
+
+private:
+    enum : uint32_t
+    {
+        BackBit = 1,     // 写端缓冲下标，读端用另一个
+        DirtyBit = 2,    // 写端缓冲里有尚未被读端取走的发布
+        WritingBit = 4,  // 写端正在写入
+    };
+
+    T m_buffers[2];
+    std::atomic<uint32_t> m_state{ 0 };
+    std::atomic<uint64_t> m_publishCount{ 0 };
+};
@@ -0,0 +1,803 @@
+#include "SoftwareRasterizer.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+
+using namespace DirectX;
+
+namespace
+{
+    double ElapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    float Saturate(float v)
+    {
+        return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+    }
+
+    void Normalize3(float* v)
+    {
+        float length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        float inv = 1.0f / length;
+        v[0] *= inv;
+        v[1] *= inv;
+        v[2] *= inv;
+    }
+
+    float Dot3(const float* a, const float* b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    // 以下三个函数与 Shaders.hlsl 中的同名函数逐行对应
+    void CalcUV(const float* p, const float* normalW, int mode, float* uv)
+    {
+        if (mode == 0) // Planar: pick best axis by normal
+        {
+            float nx = std::fabs(normalW[0]);
+            float ny = std::fabs(normalW[1]);
+            float nz = std::fabs(normalW[2]);
+            if (ny >= nx && ny >= nz)
+            {
+                uv[0] = p[0];
+                uv[1] = p[2];
+            }
+            else if (nx >= ny && nx >= nz)
+            {
+                uv[0] = p[2];
+                uv[1] = p[1];
+            }
+            else
+            {
+                uv[0] = p[0];
+                uv[1] = p[1];
+            }
+        }
+        else if (mode == 1) // Cylindrical: around Y; caps fall back to planar
+        {
+            if (std::fabs(normalW[1]) > 0.75f)
+            {
+                uv[0] = p[0];
+                uv[1] = p[2];
+                return;
+            }
+
+            float theta = std::atan2(p[2], p[0]);
+            uv[0] = (theta / 6.2831853f) + 0.5f;
+            uv[1] = p[1];
+        }
+        else // Spherical
+        {
+            float r = std::max(std::sqrt(Dot3(p, p)), 1e-5f);
+            float theta = std::atan2(p[2], p[0]);
+            float phi = std::acos(Saturate(p[1] / r));
+            uv[0] = (theta / 6.2831853f) + 0.5f;
+            uv[1] = phi / 3.1415926f;
+        }
+    }
+
+    float Pattern(const float* uv, int style)
+    {
+        if (style == 0) // Checker
+        {
+            float tx = std::floor(uv[0] * 8.0f);
+            float ty = std::floor(uv[1] * 8.0f);
+            return std::fmod(tx + ty, 2.0f);
+        }
+        else if (style == 1) // Stripes
+        {
+            float v = std::floor(uv[0] * 12.0f);
+            return std::fmod(v, 2.0f);
+        }
+        else // ImagePlaceholder
+        {
+            float v = std::sin(uv[0] * 30.0f) * std::cos(uv[1] * 30.0f);
+            return v >= 0.0f ? 1.0f : 0.0f;
+        }
+    }
+
+    // 与静态采样器一致：双线性（纹理只有一级 mip）+ WRAP 寻址
+    void SampleLinearWrap(const SoftwareTexture* texture, const float* uv, float* out)
+    {
+        if (!texture || texture->Width == 0 || texture->Height == 0)
+        {
+            out[0] = out[1] = out[2] = 0.0f;
+            return;
+        }
+
+        const int w = (int)texture->Width;
+        const int h = (int)texture->Height;
+        float x = uv[0] * w - 0.5f;
+        float y = uv[1] * h - 0.5f;
+        float fx = std::floor(x);
+        float fy = std::floor(y);
+        float tx = x - fx;
+        float ty = y - fy;
+
+        auto wrap = [](int v, int size) { int r = v % size; return r < 0 ? r + size : r; };
+        int x0 = wrap((int)fx, w);
+        int y0 = wrap((int)fy, h);
+        int x1 = wrap(x0 + 1, w);
+        int y1 = wrap(y0 + 1, h);
+
+        const uint8_t* p00 = &texture->Pixels[((size_t)y0 * w + x0) * 4];
+        const uint8_t* p10 = &texture->Pixels[((size_t)y0 * w + x1) * 4];
+        const uint8_t* p01 = &texture->Pixels[((size_t)y1 * w + x0) * 4];
+        const uint8_t* p11 = &texture->Pixels[((size_t)y1 * w + x1) * 4];
+        for (int c = 0; c < 3; ++c)
+        {
+            float top = p00[c] + (p10[c] - p00[c]) * tx;
+            float bottom = p01[c] + (p11[c] - p01[c]) * tx;
+            out[c] = (top + (bottom - top) * ty) * (1.0f / 255.0f);
+        }
+    }
+
+    // 顶点吸附到 1/256 像素（GPU 光栅化的定点精度）
+    float Snap(float v)
+    {
+        return std::round(v * 256.0f) * (1.0f / 256.0f);
+    }
+}
+
+// ============================================================================
+// 构造与尺寸
+// ============================================================================
+SoftwareRasterizer::SoftwareRasterizer()
+{
+    SetClearColor(0.2f, 0.3f, 0.4f, 1.0f);
+}
+
+bool SoftwareRasterizer::Resize(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return false;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_depthPitch = (width + 3) & ~3;
+    m_tilesX = (width + TileSize - 1) / TileSize;
+    m_tilesY = (height + TileSize - 1) / TileSize;
+
+    m_color.assign((size_t)width * height * 4, 0);
+    m_depth.assign((size_t)m_depthPitch * height, 1.0f);
+    m_tileStart.assign((size_t)m_tilesX * m_tilesY + 1, 0);
+    m_tileShaded.assign((size_t)m_tilesX * m_tilesY, 0);
+    return true;
+}
+
+void SoftwareRasterizer::SetClearColor(float r, float g, float b, float a)
+{
+    m_clearColor[0] = r;
+    m_clearColor[1] = g;
+    m_clearColor[2] = b;
+    m_clearColor[3] = a;
+}
+
+// ============================================================================
+// 一帧：按三角形预算把绘制切成批次，每批先并行做几何再按 tile 并行光栅化
+// ============================================================================
+void SoftwareRasterizer::Render(const PassConstants& pass, const std::vector<SoftwareDraw>& draws, ThreadPool* pool)
+{
+    auto frameStart = std::chrono::steady_clock::now();
+    m_stats = SoftwareRasterStats{};
+    m_stats.Draws = (uint32_t)draws.size();
+    if (m_width == 0)
+    {
+        return;
+    }
+
+    const uint32_t tileCount = (uint32_t)(m_tilesX * m_tilesY);
+    std::fill(m_tileShaded.begin(), m_tileShaded.end(), 0);
+    XMStoreFloat4x4(&m_viewProj, XMMatrixTranspose(XMLoadFloat4x4(&pass.ViewProj)));
+
+    auto parallelFor = [pool](size_t count, const std::function<void(size_t begin, size_t end)>& fn)
+    {
+        if (pool)
+        {
+            pool->ParallelFor(count, 1, fn);
+        }
+        else if (count > 0)
+        {
+            fn(0, count);
+        }
+    };
+
+    size_t batchBegin = 0;
+    bool firstBatch = true;
+    while (firstBatch || batchBegin < draws.size())
+    {
+        // 至少放入一个绘制，避免单个大网格卡住
+        size_t batchEnd = batchBegin;
+        uint64_t batchTriangles = 0;
+        while (batchEnd < draws.size() && (batchEnd == batchBegin || batchTriangles < MaxBatchTriangles))
+        {
+            if (draws[batchEnd].Mesh)
+            {
+                batchTriangles += draws[batchEnd].Mesh->Indices.size() / 3;
+            }
+            ++batchEnd;
+        }
+
+        // 几何：绘制均分给各任务，任务号越小绘制越靠前，合并分箱时保持绘制顺序
+        auto geometryStart = std::chrono::steady_clock::now();
+        const size_t batchDraws = batchEnd - batchBegin;
+        const uint32_t jobCount = (uint32_t)std::min<size_t>(std::max<size_t>(batchDraws, 1), MaxGeometryJobs);
+        const size_t drawsPerJob = (batchDraws + jobCount - 1) / jobCount;
+        if (m_jobs.size() < jobCount)
+        {
+            m_jobs.resize(jobCount);
+        }
+        parallelFor(jobCount, [&](size_t begin, size_t end)
+        {
+            for (size_t j = begin; j < end; ++j)
+            {
+                size_t first = std::min(batchBegin + j * drawsPerJob, batchEnd);
+                size_t last = std::min(first + drawsPerJob, batchEnd);
+                ProcessDraws(m_jobs[j], first, last, draws);
+            }
+        });
+        m_stats.GeometryMs += ElapsedMs(geometryStart);
+
+        auto binningStart = std::chrono::steady_clock::now();
+        BuildTileBins(jobCount);
+        m_stats.BinningMs += ElapsedMs(binningStart);
+
+        // 光栅化：一个 tile 一个任务，第一批顺带清屏
+        auto rasterStart = std::chrono::steady_clock::now();
+        const bool clear = firstBatch;
+        parallelFor(tileCount, [&](size_t begin, size_t end)
+        {
+            for (size_t t = begin; t < end; ++t)
+            {
+                RasterizeTile((uint32_t)t, clear, pass, draws);
+            }
+        });
+        m_stats.RasterMs += ElapsedMs(rasterStart);
+
+        ++m_stats.Batches;
+        firstBatch = false;
+        batchBegin = batchEnd;
+    }
+
+    for (uint64_t shaded : m_tileShaded)
+    {
+        m_stats.ShadedPixels += shaded;
+    }
+    m_stats.TotalMs = ElapsedMs(frameStart);
+}
+
+// ============================================================================
+// 几何阶段
+// ============================================================================
+void SoftwareRasterizer::ProcessDraws(GeometryJob& job, size_t drawBegin, size_t drawEnd, const std::vector<SoftwareDraw>& draws)
+{
+    job.Triangles.clear();
+    job.Bins.clear();
+
+    for (size_t d = drawBegin; d < drawEnd; ++d)
+    {
+        const SoftwareDraw& draw = draws[d];
+        if (!draw.Mesh || draw.Mesh->Indices.size() < 3)
+        {
+            continue;
+        }
+
+        // VS：位置经 World * ViewProj 变换；PosW/NormalW 直接取模型空间值（与 Shaders.hlsl 相同）
+        XMMATRIX world = XMMatrixTranspose(XMLoadFloat4x4(&draw.Constants.World));
+        XMMATRIX worldViewProj = XMMatrixMultiply(world, XMLoadFloat4x4(&m_viewProj));
+
+        const std::vector<Vertex>& vertices = draw.Mesh->Vertices;
+        job.Vertices.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            const Vertex& vin = vertices[i];
+            ClipVertex& out = job.Vertices[i];
+
+            XMFLOAT4 clip;
+            XMStoreFloat4(&clip, XMVector4Transform(XMVectorSet(vin.Pos.x, vin.Pos.y, vin.Pos.z, 1.0f), worldViewProj));
+            out.Clip[0] = clip.x;
+            out.Clip[1] = clip.y;
+            out.Clip[2] = clip.z;
+            out.Clip[3] = clip.w;
+
+            out.Pos[0] = vin.Pos.x;
+            out.Pos[1] = vin.Pos.y;
+            out.Pos[2] = vin.Pos.z;
+            out.Normal[0] = vin.Normal.x;
+            out.Normal[1] = vin.Normal.y;
+            out.Normal[2] = vin.Normal.z;
+            Normalize3(out.Normal);
+            ProjectVertex(out);
+        }
+
+        const std::vector<std::uint16_t>& indices = draw.Mesh->Indices;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            ClipAndSetup(job, job.Vertices[indices[i]], job.Vertices[indices[i + 1]], job.Vertices[indices[i + 2]], (uint32_t)d);
+        }
+    }
+}
+
+void SoftwareRasterizer::ClipAndSetup(GeometryJob& job, const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, uint32_t draw)
+{
+    const ClipVertex* in[3] = { &v0, &v1, &v2 };
+
+    // 三个顶点都在视锥某一侧平面之外时整体丢弃（x/y 方向不做真正的裁剪，交给包围盒截断）
+    int outLeft = 0, outRight = 0, outBottom = 0, outTop = 0, outNear = 0, outFar = 0;
+    for (const ClipVertex* v : in)
+    {
+        outLeft += v->Clip[0] < -v->Clip[3];
+        outRight += v->Clip[0] > v->Clip[3];
+        outBottom += v->Clip[1] < -v->Clip[3];
+        outTop += v->Clip[1] > v->Clip[3];
+        outNear += v->Clip[2] < 0.0f;
+        outFar += v->Clip[2] > v->Clip[3];
+    }
+    if (outLeft == 3 || outRight == 3 || outBottom == 3 || outTop == 3 || outNear == 3 || outFar == 3)
+    {
+        return;
+    }
+
+    if (outNear == 0)
+    {
+        SetupTriangle(job, in, draw);
+        return;
+    }
+
+    // 按 z >= 0 裁剪（D3D 的近平面），得到 3 或 4 个顶点的多边形再按扇形拆分
+    ClipVertex clipped[4];
+    int count = 0;
+    for (int e = 0; e < 3; ++e)
+    {
+        const ClipVertex& a = *in[e];
+        const ClipVertex& b = *in[(e + 1) % 3];
+        const bool aInside = a.Clip[2] >= 0.0f;
+        const bool bInside = b.Clip[2] >= 0.0f;
+
+        if (aInside)
+        {
+            clipped[count++] = a;
+        }
+        if (aInside != bInside)
+        {
+            const float t = a.Clip[2] / (a.Clip[2] - b.Clip[2]);
+            ClipVertex& v = clipped[count++];
+            for (int k = 0; k < 4; ++k)
+            {
+                v.Clip[k] = a.Clip[k] + (b.Clip[k] - a.Clip[k]) * t;
+            }
+            for (int k = 0; k < 3; ++k)
+            {
+                v.Pos[k] = a.Pos[k] + (b.Pos[k] - a.Pos[k]) * t;
+                v.Normal[k] = a.Normal[k] + (b.Normal[k] - a.Normal[k]) * t;
+            }
+            v.Clip[2] = 0.0f;
+            ProjectVertex(v);
+        }
+    }
+
+    for (int i = 1; i + 1 < count; ++i)
+    {
+        const ClipVertex* fan[3] = { &clipped[0], &clipped[i], &clipped[i + 1] };
+        SetupTriangle(job, fan, draw);
+    }
+}
+
+void SoftwareRasterizer::ProjectVertex(ClipVertex& v) const
+{
+    // w <= 0 的顶点只会出现在被近平面裁掉的一侧，标记为无效
+    if (v.Clip[3] <= 1e-6f)
+    {
+        v.InvW = 0.0f;
+        return;
+    }
+    v.InvW = 1.0f / v.Clip[3];
+    v.ScreenX = Snap((v.Clip[0] * v.InvW * 0.5f + 0.5f) * m_width);
+    v.ScreenY = Snap((0.5f - v.Clip[1] * v.InvW * 0.5f) * m_height);
+}
+
+void SoftwareRasterizer::SetupTriangle(GeometryJob& job, const ClipVertex* v[3], uint32_t draw)
+{
+    if (job.Triangles.size() >= (1u << 24) || v[0]->InvW == 0.0f || v[1]->InvW == 0.0f || v[2]->InvW == 0.0f)
+    {
+        return;
+    }
+
+    const float sx[3] = { v[0]->ScreenX, v[1]->ScreenX, v[2]->ScreenX };
+    const float sy[3] = { v[0]->ScreenY, v[1]->ScreenY, v[2]->ScreenY };
+
+    // 与 GPU 默认光栅化状态一致：顺时针为正面，剔除背面和退化三角形
+    const float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sx[2] - sx[0]) * (sy[1] - sy[0]);
+    if (!(area > 0.0f))
+    {
+        return;
+    }
+
+    // 包围盒内的像素中心：x + 0.5 落在 [min, max] 内
+    Triangle tri;
+    tri.MinX = std::max(0, (int)std::ceil(std::min({ sx[0], sx[1], sx[2] }) - 0.5f));
+    tri.MaxX = std::min(m_width - 1, (int)std::floor(std::max({ sx[0], sx[1], sx[2] }) - 0.5f));
+    tri.MinY = std::max(0, (int)std::ceil(std::min({ sy[0], sy[1], sy[2] }) - 0.5f));
+    tri.MaxY = std::min(m_height - 1, (int)std::floor(std::max({ sy[0], sy[1], sy[2] }) - 0.5f));
+    if (tri.MinX > tri.MaxX || tri.MinY > tri.MaxY)
+    {
+        return; // 不覆盖任何像素中心（远处的小三角形大多在这里被丢弃）
+    }
+
+    tri.TopLeft = 0;
+    for (int e = 0; e < 3; ++e)
+    {
+        const int a = e;
+        const int b = (e + 1) % 3;
+        const float dx = sx[b] - sx[a];
+        const float dy = sy[b] - sy[a];
+        tri.EdgeA[e] = -dy;
+        tri.EdgeB[e] = dx;
+        tri.EdgeC[e] = dy * sx[a] - dx * sy[a];
+
+        // y 向下、顺时针环绕时：上边水平且向右，左边向上
+        if (dy < 0.0f || (dy == 0.0f && dx > 0.0f))
+        {
+            tri.TopLeft |= 1u << e;
+        }
+    }
+
+    float values[PlaneCount][3];
+    for (int i = 0; i < 3; ++i)
+    {
+        const float invW = v[i]->InvW;
+        values[PlaneDepth][i] = v[i]->Clip[2] * invW;
+        values[PlaneInvW][i] = invW;
+        for (int k = 0; k < 3; ++k)
+        {
+            values[PlanePos + k][i] = v[i]->Pos[k] * invW;
+            values[PlaneNormal + k][i] = v[i]->Normal[k] * invW;
+        }
+    }
+
+    const float invArea = 1.0f / area;
+    for (int p = 0; p < PlaneCount; ++p)
+    {
+        const float* f = values[p];
+        const float a = ((f[1] - f[0]) * (sy[2] - sy[0]) - (f[2] - f[0]) * (sy[1] - sy[0])) * invArea;
+        const float b = ((f[2] - f[0]) * (sx[1] - sx[0]) - (f[1] - f[0]) * (sx[2] - sx[0])) * invArea;
+        tri.Plane[p][0] = a;
+        tri.Plane[p][1] = b;
+        tri.Plane[p][2] = f[0] - a * sx[0] - b * sy[0];
+    }
+    tri.Draw = draw;
+
+    const uint32_t index = (uint32_t)job.Triangles.size();
+    job.Triangles.push_back(tri);
+
+    const int tx0 = tri.MinX / TileSize;
+    const int tx1 = tri.MaxX / TileSize;
+    const int ty0 = tri.MinY / TileSize;
+    const int ty1 = tri.MaxY / TileSize;
+    for (int ty = ty0; ty <= ty1; ++ty)
+    {
+        for (int tx = tx0; tx <= tx1; ++tx)
+        {
+            job.Bins.push_back({ (uint32_t)(ty * m_tilesX + tx), index });
+        }
+    }
+}
+
+// ============================================================================
+// 分箱：各任务的登记按任务顺序计数排序到 tile，tile 内保持绘制顺序
+// ============================================================================
+void SoftwareRasterizer::BuildTileBins(uint32_t jobCount)
+{
+    const size_t tileCount = (size_t)m_tilesX * m_tilesY;
+    std::fill(m_tileStart.begin(), m_tileStart.end(), 0);
+
+    size_t total = 0;
+    for (uint32_t j = 0; j < jobCount; ++j)
+    {
+        for (const BinEntry& entry : m_jobs[j].Bins)
+        {
+            ++m_tileStart[entry.Tile + 1];
+        }
+        total += m_jobs[j].Bins.size();
+        m_stats.Triangles += (uint32_t)m_jobs[j].Triangles.size();
+    }
+    m_stats.BinnedTriangles += (uint32_t)total;
+
+    for (size_t t = 0; t < tileCount; ++t)
+    {
+        m_tileStart[t + 1] += m_tileStart[t];
+    }
+
+    m_tileTriangles.resize(total);
+    m_tileCursor.assign(m_tileStart.begin(), m_tileStart.end() - 1);
+    for (uint32_t j = 0; j < jobCount; ++j)
+    {
+        for (const BinEntry& entry : m_jobs[j].Bins)
+        {
+            m_tileTriangles[m_tileCursor[entry.Tile]++] = (j << 24) | entry.Triangle;
+        }
+    }
+}
+
+// ============================================================================
+// 光栅化阶段
+// ============================================================================
+void SoftwareRasterizer::RasterizeTile(uint32_t tile, bool clear, const PassConstants& pass, const std::vector<SoftwareDraw>& draws)
+{
+    const int x0 = (int)(tile % m_tilesX) * TileSize;
+    const int y0 = (int)(tile / m_tilesX) * TileSize;
+    const int x1 = std::min(x0 + TileSize, m_width) - 1;
+    const int y1 = std::min(y0 + TileSize, m_height) - 1;
+
+    if (clear)
+    {
+        uint8_t clearColor[4];
+        for (int c = 0; c < 4; ++c)
+        {
+            clearColor[c] = (uint8_t)(Saturate(m_clearColor[c]) * 255.0f + 0.5f);
+        }
+        for (int y = y0; y <= y1; ++y)
+        {
+            uint8_t* color = &m_color[((size_t)y * m_width + x0) * 4];
+            for (int x = x0; x <= x1; ++x, color += 4)
+            {
+                memcpy(color, clearColor, 4);
+            }
+            std::fill_n(&m_depth[(size_t)y * m_depthPitch + x0], x1 - x0 + 1, 1.0f);
+        }
+    }
+
+    for (uint32_t i = m_tileStart[tile]; i < m_tileStart[tile + 1]; ++i)
+    {
+        const uint32_t ref = m_tileTriangles[i];
+        const Triangle& tri = m_jobs[ref >> 24].Triangles[ref & 0xFFFFFFu];
+        RasterizeTriangle(tri,
+            std::max(tri.MinX, x0), std::min(tri.MaxX, x1),
+            std::max(tri.MinY, y0), std::min(tri.MaxY, y1),
+            pass, draws[tri.Draw], tile);
+    }
+}
+
+void SoftwareRasterizer::RasterizeTriangle(const Triangle& tri, int x0, int x1, int y0, int y1,
+    const PassConstants& pass, const SoftwareDraw& draw, uint32_t tile)
+{
+    // 采样点取像素中心；x 从 4 的倍数开始，每组 4 个像素
+    const XMVECTOR laneOffset = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+    const XMVECTOR zero = XMVectorZero();
+    const XMVECTOR one = XMVectorSplatOne();
+
+    XMVECTOR edgeA[3];
+    for (int e = 0; e < 3; ++e)
+    {
+        edgeA[e] = XMVectorReplicate(tri.EdgeA[e]);
+    }
+    XMVECTOR planeA[PlaneCount];
+    for (int p = 0; p < PlaneCount; ++p)
+    {
+        planeA[p] = XMVectorReplicate(tri.Plane[p][0]);
+    }
+
+    uint64_t shaded = 0;
+    const int xStart = x0 & ~3;
+    for (int y = y0; y <= y1; ++y)
+    {
+        const float py = (float)y + 0.5f;
+        float* depthRow = &m_depth[(size_t)y * m_depthPitch];
+        uint8_t* colorRow = &m_color[(size_t)y * m_width * 4];
+
+        XMVECTOR rowEdge[3];
+        for (int e = 0; e < 3; ++e)
+        {
+            rowEdge[e] = XMVectorReplicate(tri.EdgeB[e] * py + tri.EdgeC[e]);
+        }
+        XMVECTOR rowPlane[PlaneCount];
+        for (int p = 0; p < PlaneCount; ++p)
+        {
+            rowPlane[p] = XMVectorReplicate(tri.Plane[p][1] * py + tri.Plane[p][2]);
+        }
+
+        for (int x = xStart; x <= x1; x += 4)
+        {
+            const XMVECTOR px = XMVectorAdd(XMVectorReplicate((float)x), laneOffset);
+
+            XMVECTOR inside = XMVectorTrueInt();
+            for (int e = 0; e < 3; ++e)
+            {
+                XMVECTOR value = XMVectorMultiplyAdd(edgeA[e], px, rowEdge[e]);
+                XMVECTOR test = (tri.TopLeft & (1u << e)) ? XMVectorGreaterOrEqual(value, zero) : XMVectorGreater(value, zero);
+                inside = XMVectorAndInt(inside, test);
+            }
+
+            // 深度：在 [0, 1] 内且小于已有值（D3D12_COMPARISON_FUNC_LESS）
+            XMFLOAT4* depthDst = reinterpret_cast<XMFLOAT4*>(depthRow + x);
+            const XMVECTOR oldDepth = XMLoadFloat4(depthDst);
+            const XMVECTOR z = XMVectorMultiplyAdd(planeA[PlaneDepth], px, rowPlane[PlaneDepth]);
+            inside = XMVectorAndInt(inside, XMVectorLess(z, oldDepth));
+            inside = XMVectorAndInt(inside, XMVectorGreaterOrEqual(z, zero));
+            inside = XMVectorAndInt(inside, XMVectorLessOrEqual(z, one));
+
+            uint32_t mask[4];
+            XMStoreInt4(mask, inside);
+            for (int k = 0; k < 4; ++k)
+            {
+                if (x + k < x0 || x + k > x1)
+                {
+                    mask[k] = 0;
+                }
+            }
+            if ((mask[0] | mask[1] | mask[2] | mask[3]) == 0)
+            {
+                continue;
+            }
+
+            XMStoreFloat4(depthDst, XMVectorSelect(oldDepth, z, XMLoadInt4(mask)));
+
+            // 透视校正插值：属性/w 与 1/w 在屏幕空间线性
+            XMFLOAT4 invW;
+            XMStoreFloat4(&invW, XMVectorMultiplyAdd(planeA[PlaneInvW], px, rowPlane[PlaneInvW]));
+            XMFLOAT4 attrs[6];
+            for (int a = 0; a < 6; ++a)
+            {
+                XMStoreFloat4(&attrs[a], XMVectorMultiplyAdd(planeA[PlanePos + a], px, rowPlane[PlanePos + a]));
+            }
+
+            const float* invWLanes = &invW.x;
+            for (int k = 0; k < 4; ++k)
+            {
+                if (!mask[k])
+                {
+                    continue;
+                }
+
+                const float w = 1.0f / invWLanes[k];
+                PixelInput in;
+                for (int c = 0; c < 3; ++c)
+                {
+                    in.Pos[c] = (&attrs[c].x)[k] * w;
+                    in.Normal[c] = (&attrs[3 + c].x)[k] * w;
+                }
+                ShadePixel(in, pass, draw, colorRow + (size_t)(x + k) * 4);
+                ++shaded;
+            }
+        }
+    }
+
+    m_tileShaded[tile] += shaded;
+}
+
+// ============================================================================
+// 像素着色（Shaders.hlsl 中 PS 的逐行对应）
+// ============================================================================
+void SoftwareRasterizer::ShadePixel(const PixelInput& in, const PassConstants& pass, const SoftwareDraw& draw, uint8_t* out)
+{
+    const ObjectConstants& inst = draw.Constants;
+
+    float N[3] = { in.Normal[0], in.Normal[1], in.Normal[2] };
+    Normalize3(N);
+    float L[3] = { pass.LightPosW.x - in.Pos[0], pass.LightPosW.y - in.Pos[1], pass.LightPosW.z - in.Pos[2] };
+    Normalize3(L);
+    float V[3] = { pass.EyePosW.x - in.Pos[0], pass.EyePosW.y - in.Pos[1], pass.EyePosW.z - in.Pos[2] };
+    Normalize3(V);
+    float H[3] = { L[0] + V[0], L[1] + V[1], L[2] + V[2] };
+    Normalize3(H);
+
+    const float ndotl = Saturate(Dot3(N, L));
+    const float spec = std::pow(Saturate(Dot3(N, H)), inst.MatShininess);
+
+    const float ambient = pass.Ambient;
+    const float diffuse = pass.Diffuse * ndotl;
+    const float specular = pass.Specular * inst.SpecularStrength * spec;
+
+    float uv[2];
+    CalcUV(in.Pos, in.Normal, inst.TexMappingMode, uv);
+    uv[0] = uv[0] * inst.TexScale + inst.TexOffsetU;
+    uv[1] = uv[1] * inst.TexScale + inst.TexOffsetV;
+
+    float texColor[3];
+    if (inst.HasTexture == 1)
+    {
+        SampleLinearWrap(draw.Texture, uv, texColor);
+    }
+    else
+    {
+        const float p = Pattern(uv, inst.TexStyle);
+        const float t = 0.1f + (1.0f - 0.1f) * p;
+        texColor[0] = texColor[1] = texColor[2] = t;
+    }
+
+    const float* base = &inst.BaseColor.x;
+    float color[4];
+    for (int c = 0; c < 3; ++c)
+    {
+        color[c] = (base[c] * texColor[c]) * (ambient + diffuse) + specular;
+    }
+    color[3] = 1.0f;
+
+    if (inst.HighlightColor.w > 0.0f)
+    {
+        const float* highlight = &inst.HighlightColor.x;
+        for (int c = 0; c < 4; ++c)
+        {
+            color[c] = color[c] + (highlight[c] - color[c]) * inst.HighlightColor.w;
+        }
+    }
+
+    // R8G8B8A8_UNORM：截断到 [0, 1] 后四舍五入
+    for (int c = 0; c < 4; ++c)
+    {
+        out[c] = (uint8_t)(Saturate(color[c]) * 255.0f + 0.5f);
+    }
+}
+
+// ============================================================================
+// 输出
+// ============================================================================
+bool SoftwareRasterizer::SaveBmp(const std::filesystem::path& path) const
+{
+    if (m_width == 0)
+    {
+        return false;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        return false;
+    }
+
+    // 行按 4 字节对齐，自下而上存放，像素顺序为 BGR
+    const uint32_t rowBytes = ((uint32_t)m_width * 3 + 3) & ~3u;
+    const uint32_t imageBytes = rowBytes * (uint32_t)m_height;
+    const uint32_t headerBytes = 14 + 40;
+
+    uint8_t header[headerBytes] = {};
+    auto put16 = [&header](size_t offset, uint32_t value)
+    {
+        header[offset] = (uint8_t)value;
+        header[offset + 1] = (uint8_t)(value >> 8);
+    };
+    auto put32 = [&header](size_t offset, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            header[offset + i] = (uint8_t)(value >> (8 * i));
+        }
+    };
+
+    header[0] = 'B';
+    header[1] = 'M';
+    put32(2, headerBytes + imageBytes);
+    put32(10, headerBytes);
+    put32(14, 40);
+    put32(18, (uint32_t)m_width);
+    put32(22, (uint32_t)m_height);
+    put16(26, 1);
+    put16(28, 24);
+    put32(34, imageBytes);
+    put32(38, 2835);   // 72 DPI
+    put32(42, 2835);
+    file.write(reinterpret_cast<const char*>(header), headerBytes);
+
+    std::vector<uint8_t> row(rowBytes, 0);
+    for (int y = m_height - 1; y >= 0; --y)
+    {
+        const uint8_t* src = &m_color[(size_t)y * m_width * 4];
+        for (int x = 0; x < m_width; ++x)
+        {
+            row[x * 3 + 0] = src[x * 4 + 2];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 0];
+        }
+        file.write(reinterpret_cast<const char*>(row.data()), rowBytes);
+    }
+
+    return (bool)file;
+}
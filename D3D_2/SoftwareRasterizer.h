@@ -0,0 +1,168 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include "ShaderConstants.h"
+#include "ShapeGeometry.h"
+
+class ThreadPool;
+
+// RGBA8 纹理，字节顺序与 GPU 端 DXGI_FORMAT_R8G8B8A8_UNORM 相同
+struct SoftwareTexture
+{
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    std::vector<uint8_t> Pixels;
+};
+
+struct SoftwareMesh
+{
+    std::vector<Vertex> Vertices;
+    std::vector<std::uint16_t> Indices;
+};
+
+// 一次绘制：Constants 与上传给 GPU 的 ObjectConstants 完全相同（World 已转置）
+struct SoftwareDraw
+{
+    const SoftwareMesh* Mesh = nullptr;
+    const SoftwareTexture* Texture = nullptr;   // Constants.HasTexture 为 1 时采样；为空时按黑色处理
+    ObjectConstants Constants{};
+};
+
+// 一帧的统计
+struct SoftwareRasterStats
+{
+    uint32_t Draws = 0;
+    uint32_t Batches = 0;             // 为限制三角形缓冲大小切分的几何批次数
+    uint32_t Triangles = 0;           // 裁剪、背面剔除后进入分箱的三角形
+    uint32_t BinnedTriangles = 0;     // 三角形与其覆盖的 tile 的组合数
+    uint64_t ShadedPixels = 0;
+    double GeometryMs = 0.0;
+    double BinningMs = 0.0;
+    double RasterMs = 0.0;
+    double TotalMs = 0.0;
+};
+
+// 软件渲染后端：在没有 GPU 的机器上按 Shaders.hlsl 的 VS/PS 计算出图。
+//   1. 几何阶段：绘制按块并行做顶点变换、近平面裁剪、背面剔除和三角形建立，
+//      三角形按屏幕包围盒登记到覆盖的 tile
+//   2. 光栅化阶段：每个 tile 由一个工作线程独占（颜色/深度写入无需同步），
+//      边函数、深度和插值按 4 像素一组 SIMD 计算，通过深度测试的像素按 PS 着色
+// 光栅化规则与 GPU 端默认状态一致：顶点吸附到 1/256 像素、在像素中心采样、左上填充规则、
+// 顺时针为正面并剔除背面、深度 LESS。三角形很多时按批处理，三角形缓冲有上限。
+class SoftwareRasterizer
+{
+public:
+    static const int TileSize = 64;
+    static const uint32_t MaxBatchTriangles = 1u << 16;   // 单批次的三角形数（按索引数估算）
+    static const uint32_t MaxGeometryJobs = 64;
+
+    SoftwareRasterizer();
+
+    // 宽高必须大于 0
+    bool Resize(int width, int height);
+    void SetClearColor(float r, float g, float b, float a);
+
+    // 按 draws 的顺序绘制（深度相同时先画的保留，与 GPU 一致）；pool 为空时单线程执行
+    void Render(const PassConstants& pass, const std::vector<SoftwareDraw>& draws, ThreadPool* pool);
+
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    // RGBA8，行跨度 width * 4
+    const std::vector<uint8_t>& GetColorBuffer() const { return m_color; }
+    const SoftwareRasterStats& GetStats() const { return m_stats; }
+
+    // 保存为 24 位 BMP
+    bool SaveBmp(const std::filesystem::path& path) const;
+
+private:
+    // 屏幕空间线性插值的量（值 = A * x + B * y + C）：深度、1/w、模型空间位置/w、法线/w
+    enum
+    {
+        PlaneDepth,
+        PlaneInvW,
+        PlanePos,                   // 3 个分量
+        PlaneNormal = PlanePos + 3, // 3 个分量
+        PlaneCount = PlaneNormal + 3
+    };
+
+    struct ClipVertex
+    {
+        float Clip[4];
+        float Pos[3];
+        float Normal[3];
+        // 屏幕坐标（已吸附）与 1/w；每个顶点只算一次，被多个三角形共用
+        float ScreenX;
+        float ScreenY;
+        float InvW;
+    };
+
+    struct Triangle
+    {
+        // 边函数 E(x, y) = A * x + B * y + C，三角形内部 E >= 0（非上/左边 E > 0）
+        float EdgeA[3];
+        float EdgeB[3];
+        float EdgeC[3];
+        float Plane[PlaneCount][3];
+        int MinX;
+        int MaxX;
+        int MinY;
+        int MaxY;
+        uint32_t Draw;
+        uint32_t TopLeft;           // 第 e 位为 1 表示第 e 条边是上边或左边
+    };
+
+    struct BinEntry
+    {
+        uint32_t Tile;
+        uint32_t Triangle;
+    };
+
+    // 一个几何任务的输出，只由该任务写入
+    struct GeometryJob
+    {
+        std::vector<ClipVertex> Vertices;
+        std::vector<Triangle> Triangles;
+        std::vector<BinEntry> Bins;
+    };
+
+    // 已变换到屏幕空间、准备插值的像素着色输入
+    struct PixelInput
+    {
+        float Pos[3];
+        float Normal[3];
+    };
+
+    void ProcessDraws(GeometryJob& job, size_t drawBegin, size_t drawEnd, const std::vector<SoftwareDraw>& draws);
+    void ProjectVertex(ClipVertex& v) const;
+    void ClipAndSetup(GeometryJob& job, const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, uint32_t draw);
+    void SetupTriangle(GeometryJob& job, const ClipVertex* v[3], uint32_t draw);
+    void BuildTileBins(uint32_t jobCount);
+    void RasterizeTile(uint32_t tile, bool clear, const PassConstants& pass, const std::vector<SoftwareDraw>& draws);
+    void RasterizeTriangle(const Triangle& tri, int x0, int x1, int y0, int y1,
+        const PassConstants& pass, const SoftwareDraw& draw, uint32_t tile);
+
+    static void ShadePixel(const PixelInput& in, const PassConstants& pass, const SoftwareDraw& draw, uint8_t* out);
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_depthPitch = 0;           // 对齐到 4，最后一组像素整组读写不越界
+    int m_tilesX = 0;
+    int m_tilesY = 0;
+    float m_clearColor[4];
+    DirectX::XMFLOAT4X4 m_viewProj;         // 本帧 ViewProj（未转置）
+
+    std::vector<uint8_t> m_color;
+    std::vector<float> m_depth;
+
+    std::vector<GeometryJob> m_jobs;
+    std::vector<uint32_t> m_tileStart;      // 第 t 个 tile 的三角形在 m_tileTriangles 中的区间 [t], [t + 1]
+    std::vector<uint32_t> m_tileTriangles;  // 高 8 位为任务号，低 24 位为任务内三角形下标
+    std::vector<uint32_t> m_tileCursor;
+    std::vector<uint64_t> m_tileShaded;
+
+    SoftwareRasterStats m_stats;
+};
@@ -0,0 +1,260 @@
+#include "SelfTest.h"
+#include "SoftwareRasterizer.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+using namespace DirectX;
+
+// ============================================================================
+// SoftwareRasterizer：填充规则、线程数无关、参考图
+// ============================================================================
+namespace
+{
+    ObjectConstants MakeObject(FXMMATRIX world, int mapping, int style, const XMFLOAT3& color, bool selected)
+    {
+        ObjectConstants c{};
+        XMStoreFloat4x4(&c.World, XMMatrixTranspose(world));
+        c.HighlightColor = selected ? XMFLOAT4(1.0f, 1.0f, 0.0f, 0.3f) : XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+        c.BaseColor = color;
+        c.SpecularStrength = 0.5f;
+        c.MatShininess = 32.0f;
+        c.TexScale = 1.0f;
+        c.TexMappingMode = mapping;
+        c.TexStyle = style;
+        return c;
+    }
+
+    // 与 D3DManager 默认相机、默认光照相同
+    PassConstants MakePass(int width, int height, const XMFLOAT3& eye, const XMFLOAT3& at)
+    {
+        PassConstants pass{};
+        XMMATRIX view = XMMatrixLookAtLH(XMLoadFloat3(&eye), XMLoadFloat3(&at), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        XMMATRIX proj = XMMatrixPerspectiveFovLH(XMConvertToRadians(60.0f), (float)width / height, 1.0f, 1000.0f);
+        XMStoreFloat4x4(&pass.ViewProj, XMMatrixTranspose(view * proj));
+        pass.LightPosW = XMFLOAT3(2.0f, 4.0f, -2.0f);
+        pass.Ambient = 0.2f;
+        pass.Diffuse = 1.0f;
+        pass.Specular = 0.5f;
+        pass.Shininess = 32.0f;
+        pass.EyePosW = eye;
+        return pass;
+    }
+
+    // 5 x (count / 5) 的方阵，各种形状、映射方式、纹理样式轮换；第 7 个选中，图片样式的采样 texture
+    void BuildScene(const SoftwareMesh* meshes, const SoftwareTexture* texture, int count, std::vector<SoftwareDraw>& draws)
+    {
+        draws.clear();
+        for (int i = 0; i < count; ++i)
+        {
+            SoftwareDraw draw;
+            draw.Mesh = &meshes[1 + i % 5];
+            XMMATRIX world = XMMatrixRotationY(0.3f * i) *
+                XMMatrixTranslation((float)(i % 5 - 2) * 3.0f, 0.0f, (float)(i / 5 - 2) * 3.0f);
+            const int style = (i / 3) % 3;
+            draw.Constants = MakeObject(world, i % 3, style, XMFLOAT3(0.4f + 0.1f * (i % 6), 0.7f, 0.9f - 0.1f * (i % 4)), i == 7);
+            if (style == 2)
+            {
+                draw.Texture = texture;
+                draw.Constants.HasTexture = 1;
+            }
+            draws.push_back(draw);
+        }
+    }
+
+    void MakeCheckerTexture(SoftwareTexture& texture)
+    {
+        texture.Width = 8;
+        texture.Height = 8;
+        texture.Pixels.resize(8 * 8 * 4);
+        for (uint32_t y = 0; y < 8; ++y)
+        {
+            for (uint32_t x = 0; x < 8; ++x)
+            {
+                uint8_t* p = &texture.Pixels[(y * 8 + x) * 4];
+                const bool on = ((x ^ y) & 1) != 0;
+                p[0] = on ? 230 : 40;
+                p[1] = (uint8_t)(x * 32);
+                p[2] = (uint8_t)(y * 32);
+                p[3] = 255;
+            }
+        }
+    }
+
+    // 参考图：BuildScene(25) 在 128x64、相机 (0, 5, -9) 看原点时，按 8x8 块求平均的 RGB（16x8 块，逐行）。
+    // 按块比较而不是逐像素比较：编译器的浮点差异只会让边缘上个别像素翻转，块平均几乎不动；
+    // 着色或覆盖真的变了时总有块偏离超过容差
+    const int GoldenWidth = 128;
+    const int GoldenHeight = 64;
+    const int GoldenBlock = 8;
+    const int GoldenTolerance = 2;
+    const char* const GoldenBlocks =
+        "334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66"
+        "334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66334d66"
+        "334d66334d66334d66334d663445593c495d3431412c40533c4b5b303333283a4f314a60334d66334d66334d66334d66"
+        "334d66334d66334d662f3a481a1b1c43393334262a39475139334b212f361720262639462f465b334d66334d66334d66"
+        "334d663e51684a4a5b2228312c3d3b2a3740242d35445e64303e4b242529492e1c42602b344e5b263748334d66334d66"
+        "334d66655f722f252a232d3921373a0d14142d424c728539717b3a292f40252720242f1a283b4d1b1e24324c64334d66"
+        "2c455b31475e19232e212e363e56641c28323149603e5565354f5931485f1e252c0707070d0e0e404f58344d65334d66"
+        "29485d14212a06090a202d333b535f283c4d2b3f525b6a6b5d6d6d4358660d121608080744443a58584c4f5756171e27";
+
+    int HexValue(char c)
+    {
+        return c <= '9' ? c - '0' : c - 'a' + 10;
+    }
+}
+
+void TestSoftwareRasterizer(SelfTestContext& ctx)
+{
+    SoftwareMesh meshes[6];
+    for (int type = 1; type <= 5; ++type)
+    {
+        SELF_CHECK(ctx, GenerateShapeGeometry(type, meshes[type].Vertices, meshes[type].Indices));
+    }
+
+    // 填充规则：随机扰动的网格铺满屏幕，顶点吸附在半像素上（常落在像素中心线上），
+    // 每个三角形单独一个绘制且一个比一个近。共享边上的像素若被画两次或漏画，着色像素数就不等于屏幕像素数
+    {
+        const int width = 257, height = 131, cells = 9;
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> jitter(-0.3f, 0.3f);
+        std::vector<XMFLOAT2> grid((cells + 1) * (cells + 1));
+        for (int y = 0; y <= cells; ++y)
+        {
+            for (int x = 0; x <= cells; ++x)
+            {
+                float fx = (float)x, fy = (float)y;
+                if (x > 0 && x < cells) fx += jitter(rng);
+                if (y > 0 && y < cells) fy += jitter(rng);
+                const float px = std::round(fx / cells * width * 2.0f) / 2.0f;
+                const float py = std::round(fy / cells * height * 2.0f) / 2.0f;
+                grid[y * (cells + 1) + x] = XMFLOAT2(px / width * 2.0f - 1.0f, 1.0f - py / height * 2.0f);
+            }
+        }
+
+        std::vector<SoftwareMesh> triangles;
+        triangles.reserve(cells * cells * 2);
+        auto addTriangle = [&](int a, int b, int c)
+        {
+            SoftwareMesh mesh;
+            for (int i : { a, b, c })
+            {
+                Vertex v{};
+                v.Pos = XMFLOAT3(grid[i].x, grid[i].y, 0.5f);
+                v.Normal = XMFLOAT3(0.0f, 0.0f, -1.0f);
+                mesh.Vertices.push_back(v);
+            }
+            mesh.Indices = { 0, 1, 2 };
+            triangles.push_back(mesh);
+        };
+        // 屏幕 y 向下，顺时针为正面；对角线方向交替
+        for (int y = 0; y < cells; ++y)
+        {
+            for (int x = 0; x < cells; ++x)
+            {
+                const int i00 = y * (cells + 1) + x, i10 = i00 + 1, i01 = i00 + cells + 1, i11 = i01 + 1;
+                if ((x + y) & 1)
+                {
+                    addTriangle(i00, i10, i01);
+                    addTriangle(i10, i11, i01);
+                }
+                else
+                {
+                    addTriangle(i00, i10, i11);
+                    addTriangle(i00, i11, i01);
+                }
+            }
+        }
+
+        PassConstants pass{};
+        XMStoreFloat4x4(&pass.ViewProj, XMMatrixIdentity());
+        pass.EyePosW = XMFLOAT3(0.0f, 0.0f, -5.0f);
+        pass.LightPosW = XMFLOAT3(0.0f, 0.0f, -5.0f);
+        std::vector<SoftwareDraw> draws;
+        for (size_t i = 0; i < triangles.size(); ++i)
+        {
+            SoftwareDraw draw;
+            draw.Mesh = &triangles[i];
+            draw.Constants = MakeObject(XMMatrixTranslation(0.0f, 0.0f, -0.4f * (float)i / triangles.size()),
+                0, 0, XMFLOAT3(1.0f, 1.0f, 1.0f), false);
+            draws.push_back(draw);
+        }
+
+        SoftwareRasterizer rasterizer;
+        SELF_CHECK(ctx, rasterizer.Resize(width, height));
+        rasterizer.Render(pass, draws, nullptr);
+        SELF_CHECK(ctx, rasterizer.GetStats().Triangles == triangles.size());
+        SELF_CHECK(ctx, rasterizer.GetStats().ShadedPixels == (uint64_t)width * height);
+    }
+
+    SoftwareTexture texture;
+    MakeCheckerTexture(texture);
+    std::vector<SoftwareDraw> scene;
+
+    // 线程数无关：尺寸不是 tile 的整数倍、对象足够多以分成多个几何任务，
+    // 单线程与 1/3/7 个工作线程的结果逐字节相同
+    {
+        const int width = 333, height = 197;
+        BuildScene(meshes, &texture, 200, scene);
+        const PassConstants pass = MakePass(width, height, XMFLOAT3(0.0f, 12.0f, -20.0f), XMFLOAT3(0.0f, 0.0f, 20.0f));
+
+        SoftwareRasterizer serial;
+        SELF_CHECK(ctx, serial.Resize(width, height));
+        serial.Render(pass, scene, nullptr);
+        SELF_CHECK(ctx, serial.GetStats().ShadedPixels > 0);
+
+        for (unsigned threads : { 1u, 3u, 7u })
+        {
+            ThreadPool pool(threads);
+            SoftwareRasterizer parallel;
+            SELF_CHECK(ctx, parallel.Resize(width, height));
+            parallel.Render(pass, scene, &pool);
+            SELF_CHECK(ctx, parallel.GetColorBuffer() == serial.GetColorBuffer());
+            SELF_CHECK(ctx, parallel.GetStats().ShadedPixels == serial.GetStats().ShadedPixels);
+            // 同一个光栅化器画第二帧也不受上一帧影响
+            parallel.Render(pass, scene, &pool);
+            SELF_CHECK(ctx, parallel.GetColorBuffer() == serial.GetColorBuffer());
+        }
+    }
+
+    // 参考图
+    {
+        BuildScene(meshes, &texture, 25, scene);
+        const PassConstants pass = MakePass(GoldenWidth, GoldenHeight, XMFLOAT3(0.0f, 5.0f, -9.0f), XMFLOAT3(0.0f, 0.0f, 0.0f));
+        SoftwareRasterizer rasterizer;
+        SELF_CHECK(ctx, rasterizer.Resize(GoldenWidth, GoldenHeight));
+        rasterizer.Render(pass, scene, nullptr);
+
+        const std::vector<uint8_t>& color = rasterizer.GetColorBuffer();
+        const int blocksX = GoldenWidth / GoldenBlock, blocksY = GoldenHeight / GoldenBlock;
+        SELF_CHECK(ctx, std::strlen(GoldenBlocks) == (size_t)blocksX * blocksY * 3 * 2);
+        int mismatched = 0;
+        for (int by = 0; by < blocksY; ++by)
+        {
+            for (int bx = 0; bx < blocksX; ++bx)
+            {
+                for (int channel = 0; channel < 3; ++channel)
+                {
+                    int sum = 0;
+                    for (int y = 0; y < GoldenBlock; ++y)
+                    {
+                        for (int x = 0; x < GoldenBlock; ++x)
+                        {
+                            sum += color[((by * GoldenBlock + y) * GoldenWidth + bx * GoldenBlock + x) * 4 + channel];
+                        }
+                    }
+                    const int mean = (sum + GoldenBlock * GoldenBlock / 2) / (GoldenBlock * GoldenBlock);
+                    const size_t at = ((size_t)(by * blocksX + bx) * 3 + channel) * 2;
+                    if (at + 1 < std::strlen(GoldenBlocks))
+                    {
+                        const int expected = HexValue(GoldenBlocks[at]) * 16 + HexValue(GoldenBlocks[at + 1]);
+                        mismatched += std::abs(mean - expected) > GoldenTolerance ? 1 : 0;
+                    }
+                }
+            }
+        }
+        SELF_CHECK(ctx, mismatched == 0);
+    }
+}
@@ -0,0 +1,460 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <unordered_set>
+
+using namespace DirectX;
+
+namespace
+{
+    // 坐标偏移后按 21 位打包，范围 ±1M 个单元
+    const int CoordBias = 1 << 20;
+    const uint64_t CoordMask = (1ull << 21) - 1;
+
+    // 单元外扩超过该值时，逐单元哈希查找比直接遍历全部单元更慢
+    const int MaxLooseReach = 2;
+
+    bool SphereOverlapsAABB(const XMFLOAT3& c, float r, const XMFLOAT3& minP, const XMFLOAT3& maxP)
+    {
+        float dx = std::max(std::max(minP.x - c.x, 0.0f), c.x - maxP.x);
+        float dy = std::max(std::max(minP.y - c.y, 0.0f), c.y - maxP.y);
+        float dz = std::max(std::max(minP.z - c.z, 0.0f), c.z - maxP.z);
+        return dx * dx + dy * dy + dz * dz <= r * r;
+    }
+
+    bool RayHitsSphere(const XMFLOAT3& o, const XMFLOAT3& d, float maxDistance, const XMFLOAT3& c, float r)
+    {
+        float tx = c.x - o.x;
+        float ty = c.y - o.y;
+        float tz = c.z - o.z;
+        float proj = tx * d.x + ty * d.y + tz * d.z;
+        if (proj < -r || proj - r > maxDistance)
+            return false;
+
+        float distSq = tx * tx + ty * ty + tz * tz - proj * proj;
+        return distSq <= r * r;
+    }
+
+    // 射线与 AABB 的 slab 测试，输出进入/离开参数
+    bool RayAABB(const XMFLOAT3& o, const XMFLOAT3& d, const XMFLOAT3& minP, const XMFLOAT3& maxP,
+        float& tEnter, float& tExit)
+    {
+        const float origin[3] = { o.x, o.y, o.z };
+        const float dir[3] = { d.x, d.y, d.z };
+        const float lo[3] = { minP.x, minP.y, minP.z };
+        const float hi[3] = { maxP.x, maxP.y, maxP.z };
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (std::fabs(dir[axis]) < 1e-8f)
+            {
+                if (origin[axis] < lo[axis] || origin[axis] > hi[axis])
+                    return false;
+                continue;
+            }
+
+            float inv = 1.0f / dir[axis];
+            float t0 = (lo[axis] - origin[axis]) * inv;
+            float t1 = (hi[axis] - origin[axis]) * inv;
+            if (t0 > t1) std::swap(t0, t1);
+
+            tEnter = std::max(tEnter, t0);
+            tExit = std::min(tExit, t1);
+            if (tEnter > tExit)
+                return false;
+        }
+        return true;
+    }
+}
+
+// ============================================================================
+// 构造与基础操作
+// ============================================================================
+SpatialGrid::SpatialGrid(float cellSize)
+    : m_cellSize(cellSize > 0.0f ? cellSize : 4.0f)
+    , m_invCellSize(1.0f / (cellSize > 0.0f ? cellSize : 4.0f))
+{
+}
+
+int SpatialGrid::ToCellCoord(float v) const
+{
+    return (int)std::floor(v * m_invCellSize);
+}
+
+uint64_t SpatialGrid::MakeKey(int x, int y, int z)
+{
+    return ((uint64_t)((x + CoordBias) & CoordMask))
+        | ((uint64_t)((y + CoordBias) & CoordMask) << 21)
+        | ((uint64_t)((z + CoordBias) & CoordMask) << 42);
+}
+
+uint32_t SpatialGrid::Insert(SceneObject* obj, const XMFLOAT3& center, float radius)
+{
+    uint32_t handle;
+    if (!m_freeEntries.empty())
+    {
+        handle = m_freeEntries.back();
+        m_freeEntries.pop_back();
+    }
+    else
+    {
+        handle = (uint32_t)m_entries.size();
+        m_entries.emplace_back();
+    }
+
+    Entry& e = m_entries[handle];
+    e.Object = obj;
+    e.Center = center;
+    e.Radius = radius;
+    e.Alive = true;
+    AddRadius(radius);
+
+    AddToCell(handle);
+    return handle;
+}
+
+void SpatialGrid::Update(uint32_t handle, const XMFLOAT3& center, float radius)
+{
+    if (handle >= m_entries.size() || !m_entries[handle].Alive)
+        return;
+
+    Entry& e = m_entries[handle];
+    if (radius != e.Radius)
+    {
+        AddRadius(radius);
+        RemoveRadius(e.Radius);
+        e.Radius = radius;
+    }
+
+    uint64_t newKey = MakeKey(ToCellCoord(center.x), ToCellCoord(center.y), ToCellCoord(center.z));
+    e.Center = center;
+    if (newKey == e.CellKey)
+        return; // 仍在同一单元，只更新包围球
+
+    RemoveFromCell(handle);
+    AddToCell(handle);
+}
+
+void SpatialGrid::Remove(uint32_t handle)
+{
+    if (handle >= m_entries.size() || !m_entries[handle].Alive)
+        return;
+
+    RemoveFromCell(handle);
+    RemoveRadius(m_entries[handle].Radius);
+    m_entries[handle] = Entry{};
+    m_freeEntries.push_back(handle);
+}
+
+void SpatialGrid::Clear()
+{
+    m_entries.clear();
+    m_freeEntries.clear();
+    m_cells.clear();
+    m_radiusCounts.clear();
+    m_maxRadius = 0.0f;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        m_minCell[axis] = INT32_MAX;
+        m_maxCell[axis] = INT32_MIN;
+    }
+}
+
+void SpatialGrid::AddRadius(float radius)
+{
+    ++m_radiusCounts[radius];
+    m_maxRadius = std::max(m_maxRadius, radius);
+}
+
+void SpatialGrid::RemoveRadius(float radius)
+{
+    auto it = m_radiusCounts.find(radius);
+    if (it == m_radiusCounts.end())
+        return;
+
+    if (--it->second == 0)
+    {
+        m_radiusCounts.erase(it);
+        m_maxRadius = m_radiusCounts.empty() ? 0.0f : m_radiusCounts.rbegin()->first;
+    }
+}
+
+void SpatialGrid::AddToCell(uint32_t handle)
+{
+    Entry& e = m_entries[handle];
+    int x = ToCellCoord(e.Center.x);
+    int y = ToCellCoord(e.Center.y);
+    int z = ToCellCoord(e.Center.z);
+    e.CellKey = MakeKey(x, y, z);
+
+    Cell& cell = m_cells[e.CellKey];
+    if (cell.Entries.empty())
+    {
+        cell.X = x;
+        cell.Y = y;
+        cell.Z = z;
+        const int c[3] = { x, y, z };
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            m_minCell[axis] = std::min(m_minCell[axis], c[axis]);
+            m_maxCell[axis] = std::max(m_maxCell[axis], c[axis]);
+        }
+    }
+    e.IndexInCell = (uint32_t)cell.Entries.size();
+    cell.Entries.push_back(handle);
+}
+
+void SpatialGrid::RemoveFromCell(uint32_t handle)
+{
+    Entry& e = m_entries[handle];
+    auto it = m_cells.find(e.CellKey);
+    if (it == m_cells.end())
+        return;
+
+    // swap-pop，修正被挪动条目的下标
+    std::vector<uint32_t>& list = it->second.Entries;
+    uint32_t last = list.back();
+    list[e.IndexInCell] = last;
+    m_entries[last].IndexInCell = e.IndexInCell;
+    list.pop_back();
+
+    if (list.empty())
+    {
+        m_cells.erase(it);
+    }
+}
+
+int SpatialGrid::LooseCellReach(float queryRadius) const
+{
+    return (int)std::ceil((queryRadius + m_maxRadius) * m_invCellSize);
+}
+
+void SpatialGrid::CellBounds(const Cell& cell, XMFLOAT3& minP, XMFLOAT3& maxP) const
+{
+    // 松散边界：单元本身外扩最大对象半径
+    minP = XMFLOAT3(cell.X * m_cellSize - m_maxRadius,
+        cell.Y * m_cellSize - m_maxRadius,
+        cell.Z * m_cellSize - m_maxRadius);
+    maxP = XMFLOAT3((cell.X + 1) * m_cellSize + m_maxRadius,
+        (cell.Y + 1) * m_cellSize + m_maxRadius,
+        (cell.Z + 1) * m_cellSize + m_maxRadius);
+}
+
+template <typename CellFn>
+void SpatialGrid::ForEachCellInRange(int x0, int y0, int z0, int x1, int y1, int z1, CellFn&& fn) const
+{
+    uint64_t rangeCount = (uint64_t)(x1 - x0 + 1) * (uint64_t)(y1 - y0 + 1) * (uint64_t)(z1 - z0 + 1);
+
+    // 范围内单元数多于已占用单元时，直接遍历已占用单元
+    if (rangeCount > m_cells.size())
+    {
+        for (const auto& kv : m_cells)
+        {
+            const Cell& c = kv.second;
+            if (c.X >= x0 && c.X <= x1 && c.Y >= y0 && c.Y <= y1 && c.Z >= z0 && c.Z <= z1)
+            {
+                fn(c);
+            }
+        }
+        return;
+    }
+
+    for (int z = z0; z <= z1; ++z)
+    {
+        for (int y = y0; y <= y1; ++y)
+        {
+            for (int x = x0; x <= x1; ++x)
+            {
+                auto it = m_cells.find(MakeKey(x, y, z));
+                if (it != m_cells.end())
+                {
+                    fn(it->second);
+                }
+            }
+        }
+    }
+}
+
+// ============================================================================
+// 查询
+// ============================================================================
+void SpatialGrid::QuerySphere(const XMFLOAT3& center, float radius, std::vector<SceneObject*>& out) const
+{
+    float reach = radius + m_maxRadius;
+    ForEachCellInRange(
+        ToCellCoord(center.x - reach), ToCellCoord(center.y - reach), ToCellCoord(center.z - reach),
+        ToCellCoord(center.x + reach), ToCellCoord(center.y + reach), ToCellCoord(center.z + reach),
+        [&](const Cell& cell)
+        {
+            for (uint32_t h : cell.Entries)
+            {
+                const Entry& e = m_entries[h];
+                float dx = e.Center.x - center.x;
+                float dy = e.Center.y - center.y;
+                float dz = e.Center.z - center.z;
+                float r = radius + e.Radius;
+                if (dx * dx + dy * dy + dz * dz <= r * r)
+                {
+                    out.push_back(e.Object);
+                }
+            }
+        });
+}
+
+void SpatialGrid::QueryAABB(const XMFLOAT3& minP, const XMFLOAT3& maxP, std::vector<SceneObject*>& out) const
+{
+    ForEachCellInRange(
+        ToCellCoord(minP.x - m_maxRadius), ToCellCoord(minP.y - m_maxRadius), ToCellCoord(minP.z - m_maxRadius),
+        ToCellCoord(maxP.x + m_maxRadius), ToCellCoord(maxP.y + m_maxRadius), ToCellCoord(maxP.z + m_maxRadius),
+        [&](const Cell& cell)
+        {
+            for (uint32_t h : cell.Entries)
+            {
+                const Entry& e = m_entries[h];
+                if (SphereOverlapsAABB(e.Center, e.Radius, minP, maxP))
+                {
+                    out.push_back(e.Object);
+                }
+            }
+        });
+}
+
+void SpatialGrid::QueryFrustum(const Frustum& frustum, std::vector<SceneObject*>& out) const
+{
+    for (const auto& kv : m_cells)
+    {
+        const Cell& cell = kv.second;
+
+        XMFLOAT3 minP, maxP;
+        CellBounds(cell, minP, maxP);
+
+        Frustum::Containment c = frustum.ClassifyAABB(minP, maxP);
+        if (c == Frustum::Containment::Outside)
+            continue;
+
+        for (uint32_t h : cell.Entries)
+        {
+            const Entry& e = m_entries[h];
+            if (c == Frustum::Containment::Inside || frustum.IntersectsSphere(e.Center, e.Radius))
+            {
+                out.push_back(e.Object);
+            }
+        }
+    }
+}
+
+void SpatialGrid::QueryRay(const XMFLOAT3& origin, const XMFLOAT3& dir, float maxDistance,
+    std::vector<SceneObject*>& out) const
+{
+    if (m_cells.empty())
+        return;
+
+    auto testCell = [&](const Cell& cell)
+    {
+        for (uint32_t h : cell.Entries)
+        {
+            const Entry& e = m_entries[h];
+            if (RayHitsSphere(origin, dir, maxDistance, e.Center, e.Radius))
+            {
+                out.push_back(e.Object);
+            }
+        }
+    };
+
+    int reach = LooseCellReach(0.0f);
+    if (reach > MaxLooseReach)
+    {
+        // 存在超大对象：逐单元做射线-松散包围盒测试
+        for (const auto& kv : m_cells)
+        {
+            XMFLOAT3 minP, maxP;
+            CellBounds(kv.second, minP, maxP);
+            float t0 = 0.0f, t1 = maxDistance;
+            if (RayAABB(origin, dir, minP, maxP, t0, t1))
+            {
+                testCell(kv.second);
+            }
+        }
+        return;
+    }
+
+    // 3D DDA 沿射线遍历单元，每步检查 reach 邻域
+    const float d[3] = { dir.x, dir.y, dir.z };
+    const float o[3] = { origin.x, origin.y, origin.z };
+    int cellCoord[3] = { ToCellCoord(origin.x), ToCellCoord(origin.y), ToCellCoord(origin.z) };
+    int step[3];
+    float tMax[3];
+    float tDelta[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (d[axis] > 1e-8f)
+        {
+            step[axis] = 1;
+            tMax[axis] = ((cellCoord[axis] + 1) * m_cellSize - o[axis]) / d[axis];
+            tDelta[axis] = m_cellSize / d[axis];
+        }
+        else if (d[axis] < -1e-8f)
+        {
+            step[axis] = -1;
+            tMax[axis] = (cellCoord[axis] * m_cellSize - o[axis]) / d[axis];
+            tDelta[axis] = -m_cellSize / d[axis];
+        }
+        else
+        {
+            step[axis] = 0;
+            tMax[axis] = FLT_MAX;
+            tDelta[axis] = FLT_MAX;
+        }
+    }
+
+    // 已占用单元的包围范围，用于提前结束遍历
+    const int* minC = m_minCell;
+    const int* maxC = m_maxCell;
+
+    std::unordered_set<uint64_t> visited;
+    float t = 0.0f;
+    while (t <= maxDistance)
+    {
+        bool leaving = false;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if ((step[axis] > 0 && cellCoord[axis] - reach > maxC[axis]) ||
+                (step[axis] < 0 && cellCoord[axis] + reach < minC[axis]) ||
+                (step[axis] == 0 && (cellCoord[axis] + reach < minC[axis] || cellCoord[axis] - reach > maxC[axis])))
+            {
+                leaving = true;
+            }
+        }
+        if (leaving)
+            break;
+
+        for (int z = cellCoord[2] - reach; z <= cellCoord[2] + reach; ++z)
+        {
+            for (int y = cellCoord[1] - reach; y <= cellCoord[1] + reach; ++y)
+            {
+                for (int x = cellCoord[0] - reach; x <= cellCoord[0] + reach; ++x)
+                {
+                    uint64_t key = MakeKey(x, y, z);
+                    if (!visited.insert(key).second)
+                        continue;
+
+                    auto it = m_cells.find(key);
+                    if (it != m_cells.end())
+                    {
+                        testCell(it->second);
+                    }
+                }
+            }
+        }
+
+        // 前进到下一个单元
+        int axis = 0;
+        if (tMax[1] < tMax[axis]) axis = 1;
+        if (tMax[2] < tMax[axis]) axis = 2;
+        t = tMax[axis];
+        tMax[axis] += tDelta[axis];
+        cellCoord[axis] += step[axis];
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "Frustum.h"
+
+class SceneObject;
+
+// 哈希均匀网格（松散）：对象按包围球球心落入单元，查询时按最大半径外扩。
+// 对象移动时只在跨单元时做一次 swap-pop 删除 + 追加，摊还 O(1)，适合拖拽时每帧更新。
+class SpatialGrid
+{
+public:
+    static const uint32_t InvalidHandle = 0xFFFFFFFFu;
+
+    explicit SpatialGrid(float cellSize = 4.0f);
+
+    // 插入/更新/删除
+    uint32_t Insert(SceneObject* obj, const DirectX::XMFLOAT3& center, float radius);
+    void Update(uint32_t handle, const DirectX::XMFLOAT3& center, float radius);
+    void Remove(uint32_t handle);
+    void Clear();
+
+    // 查询（结果追加到 out，不清空）
+    void QuerySphere(const DirectX::XMFLOAT3& center, float radius,
+        std::vector<SceneObject*>& out) const;
+    void QueryAABB(const DirectX::XMFLOAT3& minP, const DirectX::XMFLOAT3& maxP,
+        std::vector<SceneObject*>& out) const;
+    void QueryFrustum(const Frustum& frustum,
+        std::vector<SceneObject*>& out) const;
+    // 返回包围球与射线相交的候选对象（未排序，精确测试由调用者完成）
+    void QueryRay(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& dir, float maxDistance,
+        std::vector<SceneObject*>& out) const;
+
+    size_t GetObjectCount() const { return m_entries.size() - m_freeEntries.size(); }
+    size_t GetCellCount() const { return m_cells.size(); }
+    float GetCellSize() const { return m_cellSize; }
+    // 当前对象的最大半径（决定查询外扩），删除或缩小最大的对象后随之回落
+    float GetMaxRadius() const { return m_maxRadius; }
+
+private:
+    struct Entry
+    {
+        SceneObject* Object = nullptr;
+        DirectX::XMFLOAT3 Center{};
+        float Radius = 0.0f;
+        uint64_t CellKey = 0;
+        uint32_t IndexInCell = 0;
+        bool Alive = false;
+    };
+
+    struct Cell
+    {
+        int X = 0;
+        int Y = 0;
+        int Z = 0;
+        std::vector<uint32_t> Entries;
+    };
+
+    int ToCellCoord(float v) const;
+    static uint64_t MakeKey(int x, int y, int z);
+
+    void AddToCell(uint32_t handle);
+    void RemoveFromCell(uint32_t handle);
+
+    // 按半径计数，维护 m_maxRadius
+    void AddRadius(float radius);
+    void RemoveRadius(float radius);
+
+    // 单元外扩半径（单元数），超过阈值时查询退化为遍历全部单元
+    int LooseCellReach(float queryRadius) const;
+    void CellBounds(const Cell& cell, DirectX::XMFLOAT3& minP, DirectX::XMFLOAT3& maxP) const;
+
+    template <typename CellFn>
+    void ForEachCellInRange(int x0, int y0, int z0, int x1, int y1, int z1, CellFn&& fn) const;
+
+private:
+    float m_cellSize;
+    float m_invCellSize;
+    float m_maxRadius = 0.0f;
+    std::map<float, uint32_t> m_radiusCounts; // 半径 -> 对象数，最大键即 m_maxRadius
+    // 曾占用过的单元坐标范围（只在 Clear 时收缩），射线查询据此提前结束
+    int m_minCell[3] = { INT32_MAX, INT32_MAX, INT32_MAX };
+    int m_maxCell[3] = { INT32_MIN, INT32_MIN, INT32_MIN };
+
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_freeEntries;
+    std::unordered_map<uint64_t, Cell> m_cells;
+};
@@ -0,0 +1,257 @@
+#include "SelfTest.h"
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace DirectX;
+
+// ============================================================================
+// SpatialGrid：随机场景下各类查询与暴力遍历的结果一致
+// ============================================================================
+namespace
+{
+    struct GridObject
+    {
+        XMFLOAT3 Center;
+        float Radius;
+        uint32_t Handle;
+        bool Alive;
+    };
+
+    SceneObject* ToObject(size_t index)
+    {
+        return reinterpret_cast<SceneObject*>((uintptr_t)(index + 1) * 16);
+    }
+
+    // 查询结果与期望集合一致（无遗漏、无重复、无多余）
+    bool SameSet(std::vector<SceneObject*> result, std::vector<SceneObject*> expected)
+    {
+        std::sort(result.begin(), result.end());
+        std::sort(expected.begin(), expected.end());
+        return result == expected;
+    }
+
+    bool SphereHit(const GridObject& o, const XMFLOAT3& c, float r)
+    {
+        const float dx = o.Center.x - c.x, dy = o.Center.y - c.y, dz = o.Center.z - c.z;
+        const float rr = r + o.Radius;
+        return dx * dx + dy * dy + dz * dz <= rr * rr;
+    }
+
+    bool RayHit(const GridObject& o, const XMFLOAT3& origin, const XMFLOAT3& dir, float maxDistance)
+    {
+        const float tx = o.Center.x - origin.x, ty = o.Center.y - origin.y, tz = o.Center.z - origin.z;
+        const float proj = tx * dir.x + ty * dir.y + tz * dir.z;
+        if (proj < -o.Radius || proj - o.Radius > maxDistance)
+        {
+            return false;
+        }
+        return tx * tx + ty * ty + tz * tz - proj * proj <= o.Radius * o.Radius;
+    }
+
+    // 与暴力遍历比较一轮球、盒、射线查询
+    void CheckQueries(SelfTestContext& ctx, const SpatialGrid& grid, const std::vector<GridObject>& objects,
+        std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+        std::vector<SceneObject*> result, expected;
+        for (int q = 0; q < 20; ++q)
+        {
+            const XMFLOAT3 center(position(rng), position(rng) * 0.2f, position(rng));
+            const float radius = 6.0f;
+            result.clear();
+            expected.clear();
+            grid.QuerySphere(center, radius, result);
+            for (size_t i = 0; i < objects.size(); ++i)
+            {
+                if (objects[i].Alive && SphereHit(objects[i], center, radius))
+                {
+                    expected.push_back(ToObject(i));
+                }
+            }
+            SELF_CHECK(ctx, SameSet(result, expected));
+
+            const XMFLOAT3 minP(center.x - 5.0f, center.y - 5.0f, center.z - 5.0f);
+            const XMFLOAT3 maxP(center.x + 5.0f, center.y + 5.0f, center.z + 5.0f);
+            result.clear();
+            expected.clear();
+            grid.QueryAABB(minP, maxP, result);
+            for (size_t i = 0; i < objects.size(); ++i)
+            {
+                const GridObject& o = objects[i];
+                const float dx = (std::max)((std::max)(minP.x - o.Center.x, 0.0f), o.Center.x - maxP.x);
+                const float dy = (std::max)((std::max)(minP.y - o.Center.y, 0.0f), o.Center.y - maxP.y);
+                const float dz = (std::max)((std::max)(minP.z - o.Center.z, 0.0f), o.Center.z - maxP.z);
+                if (o.Alive && dx * dx + dy * dy + dz * dz <= o.Radius * o.Radius)
+                {
+                    expected.push_back(ToObject(i));
+                }
+            }
+            SELF_CHECK(ctx, SameSet(result, expected));
+
+            const XMFLOAT3 origin(position(rng), position(rng) * 0.2f, -100.0f);
+            XMFLOAT3 dir;
+            XMStoreFloat3(&dir, XMVector3Normalize(XMVectorSet(position(rng) * 0.004f, 0.0f, 1.0f, 0.0f)));
+            result.clear();
+            expected.clear();
+            grid.QueryRay(origin, dir, 250.0f, result);
+            for (size_t i = 0; i < objects.size(); ++i)
+            {
+                if (objects[i].Alive && RayHit(objects[i], origin, dir, 250.0f))
+                {
+                    expected.push_back(ToObject(i));
+                }
+            }
+            SELF_CHECK(ctx, SameSet(result, expected));
+        }
+    }
+}
+
+void TestSpatialGrid(SelfTestContext& ctx)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-60.0f, 60.0f), radius(0.25f, 2.0f), step(-1.5f, 1.5f);
+
+    SpatialGrid grid(4.0f);
+    std::vector<GridObject> objects(4000);
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        GridObject& o = objects[i];
+        o.Center = XMFLOAT3(position(rng), position(rng) * 0.2f, position(rng));
+        o.Radius = radius(rng);
+        o.Handle = grid.Insert(ToObject(i), o.Center, o.Radius);
+        o.Alive = true;
+    }
+    SELF_CHECK(ctx, grid.GetObjectCount() == objects.size());
+    CheckQueries(ctx, grid, objects, rng);
+
+    // 每帧移动 10%，其中一部分跨单元
+    for (int frame = 0; frame < 5; ++frame)
+    {
+        for (size_t n = 0; n < objects.size() / 10; ++n)
+        {
+            GridObject& o = objects[rng() % objects.size()];
+            o.Center.x += step(rng);
+            o.Center.z += step(rng);
+            grid.Update(o.Handle, o.Center, o.Radius);
+        }
+    }
+    CheckQueries(ctx, grid, objects, rng);
+
+    // 删除一半，句柄复用后重新插入一部分
+    for (size_t i = 0; i < objects.size(); i += 2)
+    {
+        grid.Remove(objects[i].Handle);
+        objects[i].Alive = false;
+    }
+    SELF_CHECK(ctx, grid.GetObjectCount() == objects.size() / 2);
+    for (size_t i = 0; i < objects.size(); i += 4)
+    {
+        GridObject& o = objects[i];
+        o.Center = XMFLOAT3(position(rng), 0.0f, position(rng));
+        o.Handle = grid.Insert(ToObject(i), o.Center, o.Radius);
+        o.Alive = true;
+    }
+    CheckQueries(ctx, grid, objects, rng);
+
+    // 超大对象让查询外扩超过阈值（射线改为遍历全部单元），结果仍一致
+    objects.push_back(GridObject{ XMFLOAT3(0.0f, 0.0f, 0.0f), 40.0f, 0, true });
+    objects.back().Handle = grid.Insert(ToObject(objects.size() - 1), objects.back().Center, objects.back().Radius);
+    SELF_CHECK(ctx, grid.GetMaxRadius() == 40.0f);
+    CheckQueries(ctx, grid, objects, rng);
+
+    // 最大半径随缩小与删除回落，查询不再按超大对象外扩
+    objects.back().Radius = 10.0f;
+    grid.Update(objects.back().Handle, objects.back().Center, objects.back().Radius);
+    SELF_CHECK(ctx, grid.GetMaxRadius() == 10.0f);
+    CheckQueries(ctx, grid, objects, rng);
+    grid.Remove(objects.back().Handle);
+    objects.back().Alive = false;
+    SELF_CHECK(ctx, grid.GetMaxRadius() <= 2.0f);
+    CheckQueries(ctx, grid, objects, rng);
+
+    for (const GridObject& o : objects)
+    {
+        if (o.Alive)
+        {
+            grid.Remove(o.Handle);
+        }
+    }
+    SELF_CHECK(ctx, grid.GetObjectCount() == 0 && grid.GetMaxRadius() == 0.0f);
+
+    grid.Clear();
+    SELF_CHECK(ctx, grid.GetObjectCount() == 0 && grid.GetCellCount() == 0);
+    std::vector<SceneObject*> result;
+    grid.QuerySphere(XMFLOAT3(0.0f, 0.0f, 0.0f), 100.0f, result);
+    SELF_CHECK(ctx, result.empty());
+}
+
+// ============================================================================
+// 基准：objectCount 个对象，每帧 10% 移动，再做一组球与射线查询
+// ============================================================================
+bool RunSpatialGridBenchmark(int objectCount, int frameCount)
+{
+    if (objectCount <= 0 || frameCount <= 0)
+    {
+        return false;
+    }
+
+    // 密度与对象数无关：约每 16 平方单位一个对象
+    const float extent = std::sqrt((float)objectCount) * 2.0f;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-extent, extent), radius(0.5f, 2.0f), step(-0.5f, 0.5f);
+
+    SpatialGrid grid(4.0f);
+    std::vector<GridObject> objects((size_t)objectCount);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        GridObject& o = objects[i];
+        o.Center = XMFLOAT3(position(rng), position(rng) * 0.05f, position(rng));
+        o.Radius = radius(rng);
+        o.Handle = grid.Insert(ToObject(i), o.Center, o.Radius);
+        o.Alive = true;
+    }
+    const double insertMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    const size_t moving = (std::max)((size_t)1, objects.size() / 10);
+    double updateMs = 0.0, queryMs = 0.0;
+    size_t results = 0;
+    std::vector<SceneObject*> out;
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+        start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < moving; ++n)
+        {
+            GridObject& o = objects[rng() % objects.size()];
+            o.Center.x += step(rng);
+            o.Center.z += step(rng);
+            grid.Update(o.Handle, o.Center, o.Radius);
+        }
+        auto mid = std::chrono::steady_clock::now();
+
+        for (int q = 0; q < 64; ++q)
+        {
+            out.clear();
+            grid.QuerySphere(XMFLOAT3(position(rng), 0.0f, position(rng)), 8.0f, out);
+            results += out.size();
+            out.clear();
+            grid.QueryRay(XMFLOAT3(position(rng), 0.0f, -extent), XMFLOAT3(0.0f, 0.0f, 1.0f), extent * 2.0f, out);
+            results += out.size();
+        }
+        auto end = std::chrono::steady_clock::now();
+        updateMs += std::chrono::duration<double, std::milli>(mid - start).count();
+        queryMs += std::chrono::duration<double, std::milli>(end - mid).count();
+    }
+
+    printf("SpatialGrid benchmark: %d objects, %d frames, %zu moving/frame, %zu cells\n"
+        "  insert %.3f ms; per frame: update %.3f ms (%.1f ns/object), 64 sphere + 64 ray queries %.3f ms (%.1f results)\n",
+        objectCount, frameCount, moving, grid.GetCellCount(),
+        insertMs, updateMs / frameCount, updateMs * 1e6 / ((double)frameCount * moving),
+        queryMs / frameCount, (double)results / frameCount);
+    fflush(stdout);
+    return true;
+}
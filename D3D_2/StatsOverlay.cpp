@@ -0,0 +1,114 @@
+#include "StatsOverlay.h"
+
+namespace
+{
+    const wchar_t* OverlayClassName = L"D3D2StatsOverlay";
+    const int OverlayMargin = 8;
+    const int OverlayPadding = 6;
+
+    std::string* GetOverlayText(HWND hWnd)
+    {
+        return reinterpret_cast<std::string*>(GetWindowLongPtrW(hWnd, GWLP_USERDATA));
+    }
+
+    LRESULT CALLBACK OverlayWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
+    {
+        switch (msg)
+        {
+        case WM_NCHITTEST:
+            // 鼠标穿透到下面的主窗口
+            return HTTRANSPARENT;
+
+        case WM_MOUSEACTIVATE:
+            return MA_NOACTIVATE;
+
+        case WM_PAINT:
+        {
+            PAINTSTRUCT ps;
+            HDC hdc = BeginPaint(hWnd, &ps);
+            RECT rc;
+            GetClientRect(hWnd, &rc);
+            FillRect(hdc, &rc, (HBRUSH)GetStockObject(BLACK_BRUSH));
+
+            if (const std::string* text = GetOverlayText(hWnd))
+            {
+                HGDIOBJ oldFont = SelectObject(hdc, GetStockObject(ANSI_FIXED_FONT));
+                SetBkMode(hdc, TRANSPARENT);
+                SetTextColor(hdc, RGB(230, 230, 230));
+                InflateRect(&rc, -OverlayPadding, -OverlayPadding);
+                DrawTextA(hdc, text->c_str(), (int)text->size(), &rc, DT_LEFT | DT_TOP | DT_NOPREFIX);
+                SelectObject(hdc, oldFont);
+            }
+            EndPaint(hWnd, &ps);
+            return 0;
+        }
+
+        case WM_NCDESTROY:
+            delete GetOverlayText(hWnd);
+            SetWindowLongPtrW(hWnd, GWLP_USERDATA, 0);
+            break;
+        }
+        return DefWindowProcW(hWnd, msg, wParam, lParam);
+    }
+}
+
+HWND CreateStatsOverlay(HWND owner)
+{
+    HINSTANCE instance = (HINSTANCE)GetWindowLongPtrW(owner, GWLP_HINSTANCE);
+
+    WNDCLASSEXW wcex = {};
+    wcex.cbSize = sizeof(wcex);
+    wcex.lpfnWndProc = OverlayWndProc;
+    wcex.hInstance = instance;
+    wcex.hCursor = LoadCursor(nullptr, IDC_ARROW);
+    wcex.lpszClassName = OverlayClassName;
+    // 已注册时失败，直接沿用
+    RegisterClassExW(&wcex);
+
+    // 有所有者的弹出窗口始终在所有者之上，随所有者最小化
+    HWND overlay = CreateWindowExW(
+        WS_EX_LAYERED | WS_EX_TOOLWINDOW | WS_EX_NOACTIVATE,
+        OverlayClassName, L"", WS_POPUP,
+        0, 0, 1, 1, owner, nullptr, instance, nullptr);
+    if (!overlay)
+    {
+        return nullptr;
+    }
+
+    SetWindowLongPtrW(overlay, GWLP_USERDATA, (LONG_PTR)new std::string());
+    SetLayeredWindowAttributes(overlay, 0, 200, LWA_ALPHA);
+    PositionStatsOverlay(overlay, owner);
+    ShowWindow(overlay, SW_SHOWNOACTIVATE);
+    return overlay;
+}
+
+void SetStatsOverlayText(HWND overlay, const std::string& text)
+{
+    std::string* stored = GetOverlayText(overlay);
+    if (!stored)
+    {
+        return;
+    }
+    *stored = text;
+
+    // 按文本算出窗口大小
+    HDC hdc = GetDC(overlay);
+    HGDIOBJ oldFont = SelectObject(hdc, GetStockObject(ANSI_FIXED_FONT));
+    RECT rc = { 0, 0, 0, 0 };
+    DrawTextA(hdc, text.c_str(), (int)text.size(), &rc, DT_LEFT | DT_TOP | DT_NOPREFIX | DT_CALCRECT);
+    SelectObject(hdc, oldFont);
+    ReleaseDC(overlay, hdc);
+
+    SetWindowPos(overlay, nullptr, 0, 0,
+        rc.right + OverlayPadding * 2, rc.bottom + OverlayPadding * 2,
+        SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
+    InvalidateRect(overlay, nullptr, FALSE);
+}
+
+void PositionStatsOverlay(HWND overlay, HWND owner)
+{
+    POINT origin = { OverlayMargin, OverlayMargin };
+    ClientToScreen(owner, &origin);
+    SetWindowPos(overlay, nullptr, origin.x, origin.y, 0, 0,
+        SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE);
+}
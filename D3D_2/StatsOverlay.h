@@ -0,0 +1,12 @@
+#pragma once
+
+#include <windows.h>
+#include <string>
+
+// 渲染统计浮窗：贴在主窗口客户区左上角的半透明弹出窗口，不抢焦点、不接收鼠标。
+// 画面由交换链直接 Present，GDI 画不到客户区里，所以用一个单独的顶层窗口盖在上面
+HWND CreateStatsOverlay(HWND owner);
+// 更新显示的文本（多行），窗口按文本大小调整
+void SetStatsOverlayText(HWND overlay, const std::string& text);
+// 主窗口移动或改变大小后调用
+void PositionStatsOverlay(HWND overlay, HWND owner);
@@ -0,0 +1,351 @@
+#include "SweepAndPrune.h"
+#include <algorithm>
+
+using namespace DirectX;
+
+// ============================================================================
+// 插入/更新/删除
+// ============================================================================
+uint32_t SweepAndPrune::Insert(SceneObject* obj, const XMFLOAT3& minP, const XMFLOAT3& maxP)
+{
+    uint32_t handle;
+    if (!m_freeBoxes.empty())
+    {
+        handle = m_freeBoxes.back();
+        m_freeBoxes.pop_back();
+    }
+    else
+    {
+        handle = (uint32_t)m_boxes.size();
+        m_boxes.emplace_back();
+    }
+
+    Box& box = m_boxes[handle];
+    box = Box{};
+    box.Object = obj;
+    box.Min[0] = minP.x; box.Min[1] = minP.y; box.Min[2] = minP.z;
+    box.Max[0] = maxP.x; box.Max[1] = maxP.y; box.Max[2] = maxP.z;
+    box.Alive = true;
+
+    // 新端点在下次查询时随重建一起排序，连续插入不会退化成 O(N^2)
+    m_needsRebuild = true;
+    return handle;
+}
+
+void SweepAndPrune::Update(uint32_t handle, const XMFLOAT3& minP, const XMFLOAT3& maxP)
+{
+    if (handle >= m_boxes.size() || !m_boxes[handle].Alive)
+    {
+        return;
+    }
+
+    Box& box = m_boxes[handle];
+    const float newMin[3] = { minP.x, minP.y, minP.z };
+    const float newMax[3] = { maxP.x, maxP.y, maxP.z };
+
+    float oldMin[3];
+    float oldMax[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        oldMin[axis] = box.Min[axis];
+        oldMax[axis] = box.Max[axis];
+        box.Min[axis] = newMin[axis];
+        box.Max[axis] = newMax[axis];
+    }
+
+    if (m_needsRebuild)
+    {
+        return;
+    }
+
+    // 先写入完整的新包围盒，再逐轴挪动端点；重叠测试始终使用新盒
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        std::vector<Endpoint>& endpoints = m_axes[axis];
+        endpoints[box.MinIndex[axis]].Value = newMin[axis];
+        endpoints[box.MaxIndex[axis]].Value = newMax[axis];
+
+        // 扩张方向先处理，收缩方向后处理，保证 min 始终排在自身 max 之前
+        if (newMin[axis] < oldMin[axis])
+        {
+            SiftDown(axis, box.MinIndex[axis]);
+        }
+        if (newMax[axis] > oldMax[axis])
+        {
+            SiftUp(axis, box.MaxIndex[axis], false);
+        }
+        if (newMin[axis] > oldMin[axis])
+        {
+            SiftUp(axis, box.MinIndex[axis], false);
+        }
+        if (newMax[axis] < oldMax[axis])
+        {
+            SiftDown(axis, box.MaxIndex[axis]);
+        }
+    }
+}
+
+void SweepAndPrune::Remove(uint32_t handle)
+{
+    if (handle >= m_boxes.size() || !m_boxes[handle].Alive)
+    {
+        return;
+    }
+
+    Box& box = m_boxes[handle];
+    if (!m_needsRebuild)
+    {
+        // 把两个端点挪到表尾（途中移除重叠对），再直接弹出
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            SiftUp(axis, box.MaxIndex[axis], true);
+            SiftUp(axis, box.MinIndex[axis], true);
+            m_axes[axis].pop_back();
+            m_axes[axis].pop_back();
+        }
+    }
+
+    box = Box{};
+    m_freeBoxes.push_back(handle);
+}
+
+void SweepAndPrune::Clear()
+{
+    m_boxes.clear();
+    m_freeBoxes.clear();
+    for (auto& endpoints : m_axes)
+    {
+        endpoints.clear();
+    }
+    m_pairs.clear();
+    m_needsRebuild = false;
+}
+
+// ============================================================================
+// 查询
+// ============================================================================
+void SweepAndPrune::Flush()
+{
+    if (m_needsRebuild)
+    {
+        Rebuild();
+    }
+}
+
+void SweepAndPrune::GetOverlappingPairs(std::vector<std::pair<SceneObject*, SceneObject*>>& out)
+{
+    Flush();
+
+    out.reserve(out.size() + m_pairs.size());
+    for (uint64_t key : m_pairs)
+    {
+        uint32_t a = (uint32_t)(key >> 32);
+        uint32_t b = (uint32_t)(key & 0xFFFFFFFFu);
+        out.emplace_back(m_boxes[a].Object, m_boxes[b].Object);
+    }
+}
+
+void SweepAndPrune::QueryOverlaps(uint32_t handle, std::vector<SceneObject*>& out)
+{
+    Flush();
+
+    if (handle >= m_boxes.size() || !m_boxes[handle].Alive)
+    {
+        return;
+    }
+
+    for (uint64_t key : m_pairs)
+    {
+        uint32_t a = (uint32_t)(key >> 32);
+        uint32_t b = (uint32_t)(key & 0xFFFFFFFFu);
+        if (a == handle)
+        {
+            out.push_back(m_boxes[b].Object);
+        }
+        else if (b == handle)
+        {
+            out.push_back(m_boxes[a].Object);
+        }
+    }
+}
+
+uint64_t SweepAndPrune::ConsumeSwapCount()
+{
+    uint64_t count = m_swapCount;
+    m_swapCount = 0;
+    return count;
+}
+
+// ============================================================================
+// 内部辅助
+// ============================================================================
+uint64_t SweepAndPrune::PairKey(uint32_t a, uint32_t b)
+{
+    if (a > b)
+    {
+        std::swap(a, b);
+    }
+    return ((uint64_t)a << 32) | b;
+}
+
+bool SweepAndPrune::Overlaps(uint32_t a, uint32_t b) const
+{
+    const Box& boxA = m_boxes[a];
+    const Box& boxB = m_boxes[b];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (boxA.Max[axis] < boxB.Min[axis] || boxB.Max[axis] < boxA.Min[axis])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SweepAndPrune::SetEndpointIndex(int axis, const Endpoint& ep, uint32_t index)
+{
+    Box& box = m_boxes[ep.Handle()];
+    if (ep.IsMax())
+    {
+        box.MaxIndex[axis] = index;
+    }
+    else
+    {
+        box.MinIndex[axis] = index;
+    }
+}
+
+// 端点向左移动：min 越过他人 max 时开始重叠，max 越过他人 min 时分离
+void SweepAndPrune::SiftDown(int axis, uint32_t index)
+{
+    std::vector<Endpoint>& endpoints = m_axes[axis];
+    const Endpoint moving = endpoints[index];
+    const uint32_t handle = moving.Handle();
+
+    while (index > 0 && Less(moving, endpoints[index - 1]))
+    {
+        const Endpoint& prev = endpoints[index - 1];
+        uint32_t other = prev.Handle();
+        if (other != handle)
+        {
+            if (!moving.IsMax() && prev.IsMax())
+            {
+                if (Overlaps(handle, other))
+                {
+                    m_pairs.insert(PairKey(handle, other));
+                }
+            }
+            else if (moving.IsMax() && !prev.IsMax())
+            {
+                m_pairs.erase(PairKey(handle, other));
+            }
+        }
+
+        endpoints[index] = prev;
+        SetEndpointIndex(axis, prev, index);
+        --index;
+        ++m_swapCount;
+    }
+
+    endpoints[index] = moving;
+    SetEndpointIndex(axis, moving, index);
+}
+
+// 端点向右移动：max 越过他人 min 时开始重叠，min 越过他人 max 时分离。
+// toEnd 为 true 时无条件移到表尾（删除用），只移除重叠对
+void SweepAndPrune::SiftUp(int axis, uint32_t index, bool toEnd)
+{
+    std::vector<Endpoint>& endpoints = m_axes[axis];
+    const Endpoint moving = endpoints[index];
+    const uint32_t handle = moving.Handle();
+    const uint32_t last = (uint32_t)endpoints.size() - 1;
+
+    while (index < last && (toEnd || Less(endpoints[index + 1], moving)))
+    {
+        const Endpoint& next = endpoints[index + 1];
+        uint32_t other = next.Handle();
+        if (other != handle)
+        {
+            if (moving.IsMax() && !next.IsMax())
+            {
+                if (!toEnd && Overlaps(handle, other))
+                {
+                    m_pairs.insert(PairKey(handle, other));
+                }
+            }
+            else if (!moving.IsMax() && next.IsMax())
+            {
+                m_pairs.erase(PairKey(handle, other));
+            }
+        }
+
+        endpoints[index] = next;
+        SetEndpointIndex(axis, next, index);
+        ++index;
+        ++m_swapCount;
+    }
+
+    endpoints[index] = moving;
+    SetEndpointIndex(axis, moving, index);
+}
+
+// ============================================================================
+// 整体重建：三轴排序 + 沿 X 轴扫描生成重叠对
+// ============================================================================
+void SweepAndPrune::Rebuild()
+{
+    m_needsRebuild = false;
+    m_pairs.clear();
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        std::vector<Endpoint>& endpoints = m_axes[axis];
+        endpoints.clear();
+        endpoints.reserve(GetObjectCount() * 2);
+
+        for (uint32_t handle = 0; handle < (uint32_t)m_boxes.size(); ++handle)
+        {
+            const Box& box = m_boxes[handle];
+            if (!box.Alive)
+            {
+                continue;
+            }
+            endpoints.push_back({ box.Min[axis], handle << 1 });
+            endpoints.push_back({ box.Max[axis], (handle << 1) | 1u });
+        }
+
+        std::sort(endpoints.begin(), endpoints.end(), Less);
+        for (uint32_t i = 0; i < (uint32_t)endpoints.size(); ++i)
+        {
+            SetEndpointIndex(axis, endpoints[i], i);
+        }
+    }
+
+    // 活动集合：X 轴上区间已开始但未结束的对象
+    std::vector<uint32_t> active;
+    std::vector<uint32_t> activeSlot(m_boxes.size(), 0);
+    for (const Endpoint& ep : m_axes[0])
+    {
+        uint32_t handle = ep.Handle();
+        if (!ep.IsMax())
+        {
+            for (uint32_t other : active)
+            {
+                if (Overlaps(handle, other))
+                {
+                    m_pairs.insert(PairKey(handle, other));
+                }
+            }
+            activeSlot[handle] = (uint32_t)active.size();
+            active.push_back(handle);
+        }
+        else
+        {
+            uint32_t slot = activeSlot[handle];
+            uint32_t moved = active.back();
+            active[slot] = moved;
+            activeSlot[moved] = slot;
+            active.pop_back();
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+class SceneObject;
+
+// 增量式扫掠裁剪（Sweep and Prune）宽相位：
+// 三个轴各维护一条按坐标排序的端点表，对象移动时用插入排序把端点挪到新位置，
+// 端点交错时增删重叠对。帧间移动量小时每次更新接近 O(1)。
+// 批量插入/删除只做标记，下次查询前整体重建一次（排序 + 单轴扫描）。
+class SweepAndPrune
+{
+public:
+    static const uint32_t InvalidHandle = 0xFFFFFFFFu;
+
+    SweepAndPrune() = default;
+
+    // 插入/更新/删除（包围盒为世界空间 AABB）
+    uint32_t Insert(SceneObject* obj, const DirectX::XMFLOAT3& minP, const DirectX::XMFLOAT3& maxP);
+    void Update(uint32_t handle, const DirectX::XMFLOAT3& minP, const DirectX::XMFLOAT3& maxP);
+    void Remove(uint32_t handle);
+    void Clear();
+
+    // 处理挂起的批量插入/删除（查询会自动调用）
+    void Flush();
+
+    // 当前全部重叠对（结果追加到 out，不清空）
+    void GetOverlappingPairs(std::vector<std::pair<SceneObject*, SceneObject*>>& out);
+    // 与指定对象重叠的其它对象（结果追加到 out，不清空）
+    void QueryOverlaps(uint32_t handle, std::vector<SceneObject*>& out);
+
+    size_t GetObjectCount() const { return m_boxes.size() - m_freeBoxes.size(); }
+    size_t GetPairCount() { Flush(); return m_pairs.size(); }
+
+    // 自上次读取以来插入排序的端点交换次数（衡量增量更新开销）
+    uint64_t ConsumeSwapCount();
+
+private:
+    struct Endpoint
+    {
+        float Value;
+        uint32_t Data; // (handle << 1) | isMax
+
+        uint32_t Handle() const { return Data >> 1; }
+        bool IsMax() const { return (Data & 1u) != 0; }
+    };
+
+    struct Box
+    {
+        SceneObject* Object = nullptr;
+        float Min[3] = {};
+        float Max[3] = {};
+        uint32_t MinIndex[3] = {};
+        uint32_t MaxIndex[3] = {};
+        bool Alive = false;
+    };
+
+    // 同值时 min 端点排在 max 之前，使相接触的盒子算作重叠
+    static bool Less(const Endpoint& a, const Endpoint& b)
+    {
+        return a.Value < b.Value || (a.Value == b.Value && !a.IsMax() && b.IsMax());
+    }
+
+    static uint64_t PairKey(uint32_t a, uint32_t b);
+    bool Overlaps(uint32_t a, uint32_t b) const;
+
+    void SetEndpointIndex(int axis, const Endpoint& ep, uint32_t index);
+    void SiftDown(int axis, uint32_t index);
+    void SiftUp(int axis, uint32_t index, bool toEnd);
+
+    void Rebuild();
+
+private:
+    std::vector<Box> m_boxes;
+    std::vector<uint32_t> m_freeBoxes;
+    std::vector<Endpoint> m_axes[3];
+    std::unordered_set<uint64_t> m_pairs;
+
+    bool m_needsRebuild = false;
+    uint64_t m_swapCount = 0;
+};
@@ -0,0 +1,198 @@
+#include "SelfTest.h"
+#include "SweepAndPrune.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <set>
+
+using namespace DirectX;
+
+// ============================================================================
+// SweepAndPrune：随机移动、删除、重新插入后，重叠对与暴力两两测试一致
+// ============================================================================
+namespace
+{
+    struct SapBox
+    {
+        XMFLOAT3 Min;
+        XMFLOAT3 Max;
+        uint32_t Handle;
+        bool Alive;
+    };
+
+    SceneObject* ToObject(size_t index)
+    {
+        return reinterpret_cast<SceneObject*>((uintptr_t)(index + 1) * 16);
+    }
+
+    size_t ToIndex(SceneObject* obj)
+    {
+        return (size_t)(reinterpret_cast<uintptr_t>(obj) / 16 - 1);
+    }
+
+    bool BoxesOverlap(const SapBox& a, const SapBox& b)
+    {
+        return a.Min.x <= b.Max.x && b.Min.x <= a.Max.x &&
+            a.Min.y <= b.Max.y && b.Min.y <= a.Max.y &&
+            a.Min.z <= b.Max.z && b.Min.z <= a.Max.z;
+    }
+
+    bool PairsMatch(SweepAndPrune& sap, const std::vector<SapBox>& boxes)
+    {
+        std::set<std::pair<size_t, size_t>> expected, actual;
+        for (size_t a = 0; a < boxes.size(); ++a)
+        {
+            for (size_t b = a + 1; b < boxes.size(); ++b)
+            {
+                if (boxes[a].Alive && boxes[b].Alive && BoxesOverlap(boxes[a], boxes[b]))
+                {
+                    expected.insert(std::make_pair(a, b));
+                }
+            }
+        }
+
+        std::vector<std::pair<SceneObject*, SceneObject*>> pairs;
+        sap.GetOverlappingPairs(pairs);
+        for (const auto& pair : pairs)
+        {
+            size_t a = ToIndex(pair.first), b = ToIndex(pair.second);
+            if (a > b)
+            {
+                std::swap(a, b);
+            }
+            actual.insert(std::make_pair(a, b));
+        }
+        return pairs.size() == actual.size() && actual == expected;
+    }
+}
+
+void TestSweepAndPrune(SelfTestContext& ctx)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-30.0f, 30.0f), size(0.2f, 2.0f), delta(-0.5f, 0.5f);
+
+    // 移动幅度逐轮增大，覆盖端点交错多的情况
+    for (int round = 0; round < 3; ++round)
+    {
+        SweepAndPrune sap;
+        std::vector<SapBox> boxes(800);
+        auto place = [&](size_t i)
+        {
+            const float x = position(rng), y = position(rng) * 0.2f, z = position(rng), s = size(rng);
+            boxes[i].Min = XMFLOAT3(x - s, y - s, z - s);
+            boxes[i].Max = XMFLOAT3(x + s, y + s, z + s);
+            boxes[i].Handle = sap.Insert(ToObject(i), boxes[i].Min, boxes[i].Max);
+            boxes[i].Alive = true;
+        };
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            place(i);
+        }
+        SELF_CHECK(ctx, PairsMatch(sap, boxes));
+
+        for (int step = 0; step < 100; ++step)
+        {
+            for (int n = 0; n < 40; ++n)
+            {
+                SapBox& box = boxes[rng() % boxes.size()];
+                if (!box.Alive)
+                {
+                    continue;
+                }
+                const float scale = (float)(round + 1);
+                const float dx = delta(rng) * scale, dy = delta(rng), dz = delta(rng) * scale;
+                box.Min = XMFLOAT3(box.Min.x + dx, box.Min.y + dy, box.Min.z + dz);
+                box.Max = XMFLOAT3(box.Max.x + dx, box.Max.y + dy, box.Max.z + dz);
+                sap.Update(box.Handle, box.Min, box.Max);
+            }
+            if (step % 10 == 3)
+            {
+                const size_t i = rng() % boxes.size();
+                if (boxes[i].Alive)
+                {
+                    sap.Remove(boxes[i].Handle);
+                    boxes[i].Alive = false;
+                }
+            }
+            if (step % 25 == 7)
+            {
+                const size_t i = rng() % boxes.size();
+                if (!boxes[i].Alive)
+                {
+                    place(i);
+                }
+            }
+            if (step % 20 == 0)
+            {
+                SELF_CHECK(ctx, PairsMatch(sap, boxes));
+            }
+        }
+        SELF_CHECK(ctx, PairsMatch(sap, boxes));
+        SELF_CHECK(ctx, sap.ConsumeSwapCount() > 0 && sap.ConsumeSwapCount() == 0);
+    }
+}
+
+// ============================================================================
+// 基准：objectCount 个对象，每帧 1% 小幅移动，统计增量更新耗时与端点交换次数
+// ============================================================================
+bool RunSweepAndPruneBenchmark(int objectCount, int frameCount)
+{
+    if (objectCount <= 0 || frameCount <= 0)
+    {
+        return false;
+    }
+
+    const float extent = std::sqrt((float)objectCount) * 1.5f;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-extent, extent), delta(-0.1f, 0.1f);
+
+    SweepAndPrune sap;
+    std::vector<SapBox> boxes((size_t)objectCount);
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+        const float x = position(rng), y = position(rng) * 0.1f, z = position(rng);
+        boxes[i].Min = XMFLOAT3(x - 1.0f, y - 1.0f, z - 1.0f);
+        boxes[i].Max = XMFLOAT3(x + 1.0f, y + 1.0f, z + 1.0f);
+        boxes[i].Handle = sap.Insert(ToObject(i), boxes[i].Min, boxes[i].Max);
+    }
+    auto start = std::chrono::steady_clock::now();
+    sap.Flush();
+    const double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const size_t initialPairs = sap.GetPairCount();
+    sap.ConsumeSwapCount();
+
+    const size_t moving = (std::max)((size_t)1, boxes.size() / 100);
+    double totalMs = 0.0, maxMs = 0.0;
+    uint64_t totalSwaps = 0, maxSwaps = 0;
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+        start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < moving; ++n)
+        {
+            SapBox& box = boxes[rng() % boxes.size()];
+            const float dx = delta(rng), dz = delta(rng);
+            box.Min.x += dx;
+            box.Max.x += dx;
+            box.Min.z += dz;
+            box.Max.z += dz;
+            sap.Update(box.Handle, box.Min, box.Max);
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const uint64_t swaps = sap.ConsumeSwapCount();
+        totalMs += ms;
+        maxMs = (std::max)(maxMs, ms);
+        totalSwaps += swaps;
+        maxSwaps = (std::max)(maxSwaps, swaps);
+    }
+
+    printf("SweepAndPrune benchmark: %d objects, %d frames, %zu moving/frame\n"
+        "  build %.3f ms, %zu pairs; update avg %.3f / max %.3f ms per frame\n"
+        "  swaps per frame: avg %.1f / max %llu (%.2f per moved object); %zu pairs after\n",
+        objectCount, frameCount, moving, buildMs, initialPairs, totalMs / frameCount, maxMs,
+        (double)totalSwaps / frameCount, (unsigned long long)maxSwaps,
+        (double)totalSwaps / ((double)frameCount * moving), sap.GetPairCount());
+    fflush(stdout);
+    return true;
+}
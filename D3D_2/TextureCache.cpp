@@ -0,0 +1,295 @@
+#include "TextureCache.h"
+#include <cwctype>
+#include <filesystem>
+
+bool MakeTextureCacheKey(const std::wstring& path, std::wstring& key)
+{
+    namespace fs = std::filesystem;
+
+    std::error_code ec;
+    const fs::path canonical = fs::weakly_canonical(fs::path(path), ec);
+    if (ec)
+    {
+        return false;
+    }
+    const uintmax_t size = fs::file_size(canonical, ec);
+    if (ec)
+    {
+        return false;
+    }
+    const fs::file_time_type writeTime = fs::last_write_time(canonical, ec);
+    if (ec)
+    {
+        return false;
+    }
+
+    // Windows 路径不区分大小写：同一文件不同写法要落到同一个键上
+    std::wstring text = canonical.wstring();
+    for (wchar_t& c : text)
+    {
+        c = (wchar_t)std::towlower(c);
+    }
+
+    key = text + L"|" + std::to_wstring(size) + L"|" + std::to_wstring(writeTime.time_since_epoch().count());
+    return true;
+}
+
+// ============================================================================
+// 引用
+// ============================================================================
+TextureCache::TextureCache(ReleaseCallback release)
+    : m_release(std::move(release))
+{
+}
+
+TextureCacheId TextureCache::Acquire(const std::wstring& key, bool& created)
+{
+    auto itKey = m_keys.find(key);
+    if (itKey != m_keys.end())
+    {
+        ++m_hits;
+        created = false;
+        AddRef(itKey->second);
+        return itKey->second;
+    }
+
+    ++m_misses;
+    created = true;
+    const TextureCacheId id = m_nextId++;
+    TextureCacheEntry& entry = m_entries[id];
+    entry.Keys.push_back(key);
+    entry.RefCount = 1;
+    entry.LruPosition = m_lru.end();
+    m_keys[key] = id;
+    return id;
+}
+
+void TextureCache::AddRef(TextureCacheId id)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    TextureCacheEntry& entry = it->second;
+    if (entry.RefCount == 0 && entry.LruPosition != m_lru.end())
+    {
+        m_lru.erase(entry.LruPosition);
+        entry.LruPosition = m_lru.end();
+        m_unreferencedBytes -= entry.Bytes;
+    }
+    ++entry.RefCount;
+}
+
+bool TextureCache::Release(TextureCacheId id)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end() || it->second.RefCount == 0)
+    {
+        return false;
+    }
+
+    TextureCacheEntry& entry = it->second;
+    if (--entry.RefCount > 0)
+    {
+        return false;
+    }
+
+    if (!entry.Resident)
+    {
+        Erase(id);
+        return true;
+    }
+
+    entry.LruPosition = m_lru.insert(m_lru.end(), id);
+    m_unreferencedBytes += entry.Bytes;
+    Trim();
+    return false;
+}
+
+// ============================================================================
+// 驻留与合并
+// ============================================================================
+TextureCacheId TextureCache::SetResident(TextureCacheId id, uint64_t texture, uint32_t view,
+    uint64_t bytes, uint64_t contentHash)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end() || it->second.Resident)
+    {
+        m_release(texture, view);
+        return id;
+    }
+
+    TextureCacheEntry& entry = it->second;
+
+    // 内容相同（哈希与大小都一致）的纹理已经驻留：引用和键转过去，新纹理不要了
+    auto itContent = contentHash != 0 ? m_contents.find(contentHash) : m_contents.end();
+    if (itContent != m_contents.end() && itContent->second != id)
+    {
+        const TextureCacheId survivorId = itContent->second;
+        TextureCacheEntry& survivor = m_entries[survivorId];
+        if (survivor.Bytes == bytes)
+        {
+            for (const std::wstring& key : entry.Keys)
+            {
+                m_keys[key] = survivorId;
+                survivor.Keys.push_back(key);
+            }
+            const uint32_t refs = entry.RefCount;
+            m_entries.erase(it);
+            for (uint32_t i = 0; i < refs; ++i)
+            {
+                AddRef(survivorId);
+            }
+
+            ++m_merges;
+            m_release(texture, view);
+            if (m_erased)
+            {
+                m_erased(id);
+            }
+            return survivorId;
+        }
+    }
+
+    entry.Resident = true;
+    entry.Texture = texture;
+    entry.View = view;
+    entry.Bytes = bytes;
+    entry.ContentHash = contentHash;
+    m_residentBytes += bytes;
+    if (contentHash != 0 && itContent == m_contents.end())
+    {
+        m_contents[contentHash] = id;
+    }
+
+    // 新驻留的纹理可能把总量推过预算，先淘汰没人用的
+    Trim();
+    return id;
+}
+
+bool TextureCache::UpdateResident(TextureCacheId id, uint64_t texture, uint32_t view, uint64_t bytes)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end() || !it->second.Resident)
+    {
+        m_release(texture, view);
+        return false;
+    }
+
+    TextureCacheEntry& entry = it->second;
+    m_release(entry.Texture, entry.View);
+    m_residentBytes = m_residentBytes - entry.Bytes + bytes;
+    if (entry.LruPosition != m_lru.end())
+    {
+        m_unreferencedBytes = m_unreferencedBytes - entry.Bytes + bytes;
+    }
+    entry.Texture = texture;
+    entry.View = view;
+    entry.Bytes = bytes;
+
+    Trim();
+    return true;
+}
+
+const TextureCacheEntry* TextureCache::Find(TextureCacheId id) const
+{
+    auto it = m_entries.find(id);
+    return it != m_entries.end() ? &it->second : nullptr;
+}
+
+// ============================================================================
+// 淘汰
+// ============================================================================
+void TextureCache::SetBudget(uint64_t bytes)
+{
+    m_budget = bytes;
+    Trim();
+}
+
+void TextureCache::Trim()
+{
+    while (m_residentBytes > m_budget && !m_lru.empty())
+    {
+        const TextureCacheId id = m_lru.front();
+        Erase(id);
+        ++m_evictions;
+    }
+}
+
+void TextureCache::Erase(TextureCacheId id)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    TextureCacheEntry& entry = it->second;
+    for (const std::wstring& key : entry.Keys)
+    {
+        auto itKey = m_keys.find(key);
+        if (itKey != m_keys.end() && itKey->second == id)
+        {
+            m_keys.erase(itKey);
+        }
+    }
+
+    if (entry.ContentHash != 0)
+    {
+        auto itContent = m_contents.find(entry.ContentHash);
+        if (itContent != m_contents.end() && itContent->second == id)
+        {
+            m_contents.erase(itContent);
+        }
+    }
+
+    if (entry.LruPosition != m_lru.end())
+    {
+        m_lru.erase(entry.LruPosition);
+        m_unreferencedBytes -= entry.Bytes;
+    }
+
+    if (entry.Resident)
+    {
+        m_residentBytes -= entry.Bytes;
+        m_release(entry.Texture, entry.View);
+    }
+    m_entries.erase(it);
+    if (m_erased)
+    {
+        m_erased(id);
+    }
+}
+
+void TextureCache::Clear()
+{
+    for (const auto& pair : m_entries)
+    {
+        if (pair.second.Resident)
+        {
+            m_release(pair.second.Texture, pair.second.View);
+        }
+    }
+    m_entries.clear();
+    m_keys.clear();
+    m_contents.clear();
+    m_lru.clear();
+    m_residentBytes = 0;
+    m_unreferencedBytes = 0;
+}
+
+TextureCacheStats TextureCache::GetStats() const
+{
+    TextureCacheStats stats;
+    stats.Entries = (uint32_t)m_entries.size();
+    stats.Unreferenced = (uint32_t)m_lru.size();
+    stats.ResidentBytes = m_residentBytes;
+    stats.UnreferencedBytes = m_unreferencedBytes;
+    stats.Hits = m_hits;
+    stats.Misses = m_misses;
+    stats.Evictions = m_evictions;
+    stats.ContentMerges = m_merges;
+    return stats;
+}
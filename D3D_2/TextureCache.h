@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef uint32_t TextureCacheId;
+const TextureCacheId InvalidTextureCacheId = 0;
+
+// 规范化路径（小写）+ 文件大小 + 修改时间。文件不存在时返回 false；
+// 文件被改写后键随之变化，旧条目没有引用后按 LRU 淘汰
+bool MakeTextureCacheKey(const std::wstring& path, std::wstring& key);
+
+// 一张共享纹理
+struct TextureCacheEntry
+{
+    std::vector<std::wstring> Keys;   // 指向本条目的键（内容相同的不同文件会合并到同一条）
+    uint32_t RefCount = 0;
+    bool Resident = false;            // 加载完成前 Texture/View 无效
+    uint64_t Texture = 0;             // 后端纹理句柄
+    uint32_t View = 0;                // 描述符区间
+    uint64_t Bytes = 0;
+    uint64_t ContentHash = 0;         // 源文件内容的哈希，0 表示未知
+    std::list<TextureCacheId>::iterator LruPosition;
+};
+
+struct TextureCacheStats
+{
+    uint32_t Entries = 0;
+    uint32_t Unreferenced = 0;        // 留在 LRU 中、随时可淘汰的条目
+    uint64_t ResidentBytes = 0;
+    uint64_t UnreferencedBytes = 0;
+    uint64_t Hits = 0;                // Acquire 命中已有条目（驻留或加载中）
+    uint64_t Misses = 0;
+    uint64_t Evictions = 0;
+    uint64_t ContentMerges = 0;       // 加载完成后发现内容与已驻留条目相同而合并
+};
+
+// 按文件键共享的纹理表：同一张图片只解码、上传一次，所有使用它的对象共用同一个纹理和描述符。
+// 每个使用者持有一份引用；引用归零的已驻留条目进入 LRU，只有驻留总量超出预算时才从最久未用的开始淘汰，
+// 期间再次请求同一文件直接命中。被淘汰或合并掉的纹理交给 release 回调释放（回调负责等 GPU 用完）。
+// 只在渲染线程使用
+class TextureCache
+{
+public:
+    typedef std::function<void(uint64_t texture, uint32_t view)> ReleaseCallback;
+    typedef std::function<void(TextureCacheId id)> EraseCallback;
+
+    explicit TextureCache(ReleaseCallback release);
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // 按键取一份引用。没有条目时新建（created 为 true），调用者应以返回的 id 发起加载
+    TextureCacheId Acquire(const std::wstring& key, bool& created);
+    void AddRef(TextureCacheId id);
+    // 放掉一份引用。返回 true 表示条目尚未驻留就没有了引用、已被删除，调用者应取消它的加载
+    bool Release(TextureCacheId id);
+
+    // 加载完成：内容与另一个已驻留条目相同时把本条目的引用和键合并过去，新纹理直接交给 release 回调。
+    // 返回最终持有这些引用的条目
+    TextureCacheId SetResident(TextureCacheId id, uint64_t texture, uint32_t view,
+        uint64_t bytes, uint64_t contentHash);
+
+    // 流式换级：已驻留条目换成同一内容的另一份纹理（mip 级数不同），旧纹理交给 release 回调。
+    // 条目已不存在或尚未驻留时新纹理直接交给回调，返回 false
+    bool UpdateResident(TextureCacheId id, uint64_t texture, uint32_t view, uint64_t bytes);
+
+    const TextureCacheEntry* Find(TextureCacheId id) const;
+
+    // 条目被淘汰、合并或删除时调用（Clear 除外），用于清理调用者按 id 记录的状态
+    void SetEraseCallback(EraseCallback callback) { m_erased = std::move(callback); }
+
+    // 驻留总量预算（字节）。只淘汰没有引用的条目，有引用的不受限制
+    void SetBudget(uint64_t bytes);
+    uint64_t GetBudget() const { return m_budget; }
+
+    // 释放全部已驻留纹理并清空（关闭时调用）
+    void Clear();
+
+    TextureCacheStats GetStats() const;
+
+    static const uint64_t DefaultBudget = 256ull * 1024 * 1024;
+
+private:
+    void Erase(TextureCacheId id);
+    void Trim();
+
+private:
+    ReleaseCallback m_release;
+    EraseCallback m_erased;
+    uint64_t m_budget = DefaultBudget;
+    TextureCacheId m_nextId = 1;
+
+    std::unordered_map<TextureCacheId, TextureCacheEntry> m_entries;
+    std::unordered_map<std::wstring, TextureCacheId> m_keys;
+    std::unordered_map<uint64_t, TextureCacheId> m_contents;   // 已驻留条目的内容哈希
+    std::list<TextureCacheId> m_lru;                           // 无引用的已驻留条目，最近使用的在尾部
+
+    uint64_t m_residentBytes = 0;
+    uint64_t m_unreferencedBytes = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+    uint64_t m_merges = 0;
+};
@@ -0,0 +1,295 @@
+#include "SelfTest.h"
+#include "TextureCache.h"
+#include "TextureLoader.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+
+// ============================================================================
+// TextureCache：多个对象共用一个路径时只解码、上传一次
+// ============================================================================
+namespace
+{
+    // 数解码次数的替身解码器：任意非空文件都解成 4x4
+    class CountingDecoder : public ITextureDecoder
+    {
+    public:
+        bool Decode(const uint8_t* data, size_t size, DecodedImage& out) override
+        {
+            ++m_decodes;
+            if (size == 0)
+            {
+                return false;
+            }
+            out.Width = 4;
+            out.Height = 4;
+            out.Pixels.assign(4 * 4 * 4, data[0]);
+            return true;
+        }
+
+        uint32_t GetDecodes() const { return m_decodes; }
+
+    private:
+        std::atomic<uint32_t> m_decodes{ 0 };
+    };
+
+    class CountingUploader : public ITextureUploader
+    {
+    public:
+        bool Upload(const DecodedImage&, uint64_t& texture) override
+        {
+            texture = m_nextTexture++;
+            m_live.insert(texture);
+            ++m_uploads;
+            return true;
+        }
+        uint64_t Flush() override { return m_fence.Signal(); }
+        IFence& GetFence() override { return m_fence; }
+        void Release(uint64_t texture) override { m_live.erase(texture); }
+
+        SimulatedFence& Fence() { return m_fence; }
+        std::set<uint64_t>& Live() { return m_live; }
+        uint32_t GetUploads() const { return m_uploads; }
+
+    private:
+        SimulatedFence m_fence;
+        std::set<uint64_t> m_live;
+        uint64_t m_nextTexture = 100;
+        uint32_t m_uploads = 0;
+    };
+
+    // 按 D3DManager::LoadTexture / OnTextureLoaded 的做法记录每个对象的纹理：
+    // 取一份缓存引用，只有新建的条目才发起加载；驻留后等着它的对象全部换上
+    class ObjectTextures
+    {
+    public:
+        ObjectTextures()
+            : m_cache([this](uint64_t texture, uint32_t) { m_uploader.Live().erase(texture); })
+            , m_loader(m_decoder, nullptr)
+        {
+        }
+
+        ~ObjectTextures()
+        {
+            m_loader.Shutdown(&m_uploader);
+            m_cache.Clear();
+        }
+
+        bool Load(int object, const std::wstring& path)
+        {
+            std::wstring key;
+            if (!MakeTextureCacheKey(path, key))
+            {
+                return false;
+            }
+            bool created = false;
+            const TextureCacheId id = m_cache.Acquire(key, created);
+            ReleasePending(object);
+            if (m_cache.Find(id)->Resident)
+            {
+                SetCurrent(object, id);
+                return true;
+            }
+            m_pending[object] = id;
+            if (created)
+            {
+                m_loader.Request(id, path);
+            }
+            return true;
+        }
+
+        void Destroy(int object)
+        {
+            ReleasePending(object);
+            auto it = m_current.find(object);
+            if (it != m_current.end())
+            {
+                const TextureCacheId id = it->second;
+                m_current.erase(it);
+                Release(id);
+            }
+        }
+
+        // 推进加载直到没有等待的对象（拷贝栅栏每次都完成）
+        void Pump()
+        {
+            for (int i = 0; i < 100 && (!m_pending.empty() || m_loader.NeedsUpdate()); ++i)
+            {
+                Update(true);
+            }
+        }
+
+        void Update(bool completeCopies)
+        {
+            std::vector<TextureLoadResult> results;
+            m_loader.Update(m_uploader, results);
+            if (completeCopies)
+            {
+                m_uploader.Fence().Complete(m_uploader.Fence().GetLastSignaledValue());
+            }
+            for (const TextureLoadResult& result : results)
+            {
+                const TextureCacheId id = (TextureCacheId)result.Key;
+                const TextureCacheId resident = result.Succeeded ?
+                    m_cache.SetResident(id, result.Texture, m_nextView++, result.Bytes, result.ContentHash) :
+                    InvalidTextureCacheId;
+                for (auto it = m_pending.begin(); it != m_pending.end();)
+                {
+                    if (it->second != id)
+                    {
+                        ++it;
+                        continue;
+                    }
+                    const int object = it->first;
+                    it = m_pending.erase(it);
+                    if (resident != InvalidTextureCacheId)
+                    {
+                        SetCurrent(object, resident);
+                    }
+                    else
+                    {
+                        Release(id);
+                    }
+                }
+            }
+        }
+
+        TextureCacheId GetCurrent(int object) const
+        {
+            auto it = m_current.find(object);
+            return it != m_current.end() ? it->second : InvalidTextureCacheId;
+        }
+
+        TextureCache& Cache() { return m_cache; }
+        const CountingDecoder& Decoder() const { return m_decoder; }
+        CountingUploader& Uploader() { return m_uploader; }
+
+    private:
+        void SetCurrent(int object, TextureCacheId id)
+        {
+            auto it = m_current.find(object);
+            if (it == m_current.end())
+            {
+                m_current[object] = id;
+                return;
+            }
+            const TextureCacheId previous = it->second;
+            it->second = id;
+            Release(previous);
+        }
+
+        void ReleasePending(int object)
+        {
+            auto it = m_pending.find(object);
+            if (it != m_pending.end())
+            {
+                const TextureCacheId id = it->second;
+                m_pending.erase(it);
+                Release(id);
+            }
+        }
+
+        void Release(TextureCacheId id)
+        {
+            if (m_cache.Release(id))
+            {
+                m_loader.Cancel(id);
+            }
+        }
+
+    private:
+        CountingDecoder m_decoder;
+        CountingUploader m_uploader;
+        TextureCache m_cache;
+        TextureLoader m_loader;
+        std::map<int, TextureCacheId> m_current;
+        std::map<int, TextureCacheId> m_pending;
+        uint32_t m_nextView = 1;
+    };
+
+    std::wstring WriteFile(const std::filesystem::path& dir, const char* name, const char* content)
+    {
+        std::ofstream(dir / name, std::ios::binary | std::ios::trunc) << content;
+        return (dir / name).wstring();
+    }
+}
+
+void TestTextureCache(SelfTestContext& ctx)
+{
+    std::error_code error;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path(error) / "D3D_2-TextureCacheTest";
+    std::filesystem::create_directories(dir, error);
+    const std::wstring a = WriteFile(dir, "a.img", "AAAA");
+    const std::wstring copyOfA = WriteFile(dir, "copy_of_a.img", "AAAA");
+    const std::wstring b = WriteFile(dir, "b.img", "BBBB");
+    // 同一文件的另一种写法
+    const std::wstring aRespelled = (dir / ".." / dir.filename() / "." / "a.img").wstring();
+
+    {
+        ObjectTextures objects;
+
+        // N 个对象、同一路径（含另一种写法）：恰好一次解码、一次上传、一个条目，全部共用同一个纹理
+        const int count = 16;
+        for (int object = 0; object < count; ++object)
+        {
+            SELF_CHECK(ctx, objects.Load(object, object == count - 1 ? aRespelled : a));
+        }
+        objects.Pump();
+        SELF_CHECK(ctx, objects.Decoder().GetDecodes() == 1);
+        SELF_CHECK(ctx, objects.Uploader().GetUploads() == 1 && objects.Uploader().Live().size() == 1);
+        const TextureCacheId shared = objects.GetCurrent(0);
+        bool same = shared != InvalidTextureCacheId;
+        for (int object = 1; object < count; ++object)
+        {
+            same &= objects.GetCurrent(object) == shared;
+        }
+        SELF_CHECK(ctx, same);
+        SELF_CHECK(ctx, objects.Cache().Find(shared)->RefCount == (uint32_t)count);
+        TextureCacheStats stats = objects.Cache().GetStats();
+        SELF_CHECK(ctx, stats.Entries == 1 && stats.Misses == 1 && stats.Hits == count - 1);
+
+        // 已驻留：新对象立即换上，不再解码
+        SELF_CHECK(ctx, objects.Load(count, a) && objects.GetCurrent(count) == shared);
+        SELF_CHECK(ctx, objects.Decoder().GetDecodes() == 1);
+
+        // 内容相同的另一个文件：键不同要解码一次，驻留时合并到已有条目，不多留纹理
+        SELF_CHECK(ctx, objects.Load(count + 1, copyOfA));
+        objects.Pump();
+        SELF_CHECK(ctx, objects.Decoder().GetDecodes() == 2 && objects.GetCurrent(count + 1) == shared);
+        SELF_CHECK(ctx, objects.Uploader().Live().size() == 1 && objects.Cache().GetStats().ContentMerges == 1);
+        SELF_CHECK(ctx, objects.Load(count + 2, copyOfA) && objects.GetCurrent(count + 2) == shared);
+        SELF_CHECK(ctx, objects.Decoder().GetDecodes() == 2);
+
+        // 全部放掉后留在 LRU 里，再次请求直接命中
+        for (int object = 0; object <= count + 2; ++object)
+        {
+            objects.Destroy(object);
+        }
+        stats = objects.Cache().GetStats();
+        SELF_CHECK(ctx, stats.Entries == 1 && stats.Unreferenced == 1 && objects.Uploader().Live().size() == 1);
+        SELF_CHECK(ctx, objects.Load(0, a) && objects.GetCurrent(0) == shared);
+        SELF_CHECK(ctx, objects.Decoder().GetDecodes() == 2);
+
+        // 加载中所有对象都放掉：条目删除、加载取消，拷贝未完成的纹理在栅栏完成后释放
+        for (int object = 1; object <= 4; ++object)
+        {
+            SELF_CHECK(ctx, objects.Load(object, b));
+        }
+        objects.Update(false);
+        SELF_CHECK(ctx, objects.Decoder().GetDecodes() == 3 && objects.Uploader().Live().size() == 2);
+        for (int object = 1; object <= 4; ++object)
+        {
+            objects.Destroy(object);
+        }
+        objects.Pump();
+        SELF_CHECK(ctx, objects.Cache().GetStats().Entries == 1 && objects.Uploader().Live().size() == 1);
+        SELF_CHECK(ctx, objects.Decoder().GetDecodes() == 3 && objects.GetCurrent(0) == shared);
+
+        // 文件不存在时立即失败
+        SELF_CHECK(ctx, !objects.Load(5, (dir / "missing.img").wstring()));
+    }
+
+    std::filesystem::remove_all(dir, error);
+}
@@ -0,0 +1,937 @@
+#include "TextureCompressor.h"
+#include "ThreadPool.h"
+#include <DirectXMath.h>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+namespace
+{
+    const uint32_t BlockPixels = 16;
+
+    // BC7 4 位索引的插值权重（/64）
+    const int Bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // 小端、低位在前的位流（块内字段按 D3D 规范的顺序）
+    struct BitWriter
+    {
+        uint8_t* Out;
+        uint32_t Position = 0;
+
+        void Write(uint32_t value, uint32_t bits)
+        {
+            for (uint32_t i = 0; i < bits; ++i, ++Position)
+            {
+                if ((value >> i) & 1)
+                {
+                    Out[Position >> 3] |= (uint8_t)(1u << (Position & 7));
+                }
+            }
+        }
+    };
+
+    struct BitReader
+    {
+        const uint8_t* In;
+        uint32_t Position = 0;
+
+        uint32_t Read(uint32_t bits)
+        {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < bits; ++i, ++Position)
+            {
+                value |= (uint32_t)((In[Position >> 3] >> (Position & 7)) & 1) << i;
+            }
+            return value;
+        }
+    };
+
+    // 读一个 4x4 块（0~255 的浮点），越过边缘的像素取边缘像素
+    void LoadBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, XMVECTOR* pixels)
+    {
+        for (uint32_t y = 0; y < 4; ++y)
+        {
+            const uint32_t sy = by * 4 + y < height ? by * 4 + y : height - 1;
+            for (uint32_t x = 0; x < 4; ++x)
+            {
+                const uint32_t sx = bx * 4 + x < width ? bx * 4 + x : width - 1;
+                const uint8_t* p = rgba + ((size_t)sy * width + sx) * 4;
+                pixels[y * 4 + x] = XMVectorSet(p[0], p[1], p[2], p[3]);
+            }
+        }
+    }
+
+    void StoreBlock(const uint8_t (*texels)[4], uint32_t width, uint32_t height, uint32_t bx, uint32_t by, uint8_t* rgba)
+    {
+        for (uint32_t y = 0; y < 4 && by * 4 + y < height; ++y)
+        {
+            for (uint32_t x = 0; x < 4 && bx * 4 + x < width; ++x)
+            {
+                memcpy(rgba + ((size_t)(by * 4 + y) * width + bx * 4 + x) * 4, texels[y * 4 + x], 4);
+            }
+        }
+    }
+
+    float DistanceSq(FXMVECTOR a, FXMVECTOR b, FXMVECTOR mask)
+    {
+        const XMVECTOR d = XMVectorMultiply(XMVectorSubtract(a, b), mask);
+        return XMVectorGetX(XMVector4Dot(d, d));
+    }
+
+    // 给 active 的像素选最近的调色板项，返回误差平方和
+    float FitIndices(const XMVECTOR* pixels, const bool* active, const XMVECTOR* palette, uint32_t paletteCount,
+        FXMVECTOR mask, uint8_t* indices)
+    {
+        float total = 0.0f;
+        for (uint32_t i = 0; i < BlockPixels; ++i)
+        {
+            if (active && !active[i])
+            {
+                continue;
+            }
+            float best = DistanceSq(pixels[i], palette[0], mask);
+            uint8_t bestIndex = 0;
+            for (uint32_t k = 1; k < paletteCount; ++k)
+            {
+                const float d = DistanceSq(pixels[i], palette[k], mask);
+                if (d < best)
+                {
+                    best = d;
+                    bestIndex = (uint8_t)k;
+                }
+            }
+            indices[i] = bestIndex;
+            total += best;
+        }
+        return total;
+    }
+
+    // ========================================================================
+    // 端点估计
+    // ========================================================================
+    // 返回 false 表示没有 active 的像素
+    bool FindEndpoints(const XMVECTOR* pixels, const bool* active, FXMVECTOR mask, CompressionQuality quality,
+        XMVECTOR& e0, XMVECTOR& e1)
+    {
+        uint32_t count = 0;
+        XMVECTOR minimum = XMVectorReplicate(255.0f), maximum = XMVectorZero(), sum = XMVectorZero();
+        for (uint32_t i = 0; i < BlockPixels; ++i)
+        {
+            if (active && !active[i])
+            {
+                continue;
+            }
+            minimum = XMVectorMin(minimum, pixels[i]);
+            maximum = XMVectorMax(maximum, pixels[i]);
+            sum = XMVectorAdd(sum, pixels[i]);
+            ++count;
+        }
+        if (count == 0)
+        {
+            return false;
+        }
+
+        if (quality == CompressionQuality::Fast)
+        {
+            const XMVECTOR inset = XMVectorScale(XMVectorSubtract(maximum, minimum), 1.0f / 16.0f);
+            e0 = XMVectorAdd(minimum, inset);
+            e1 = XMVectorSubtract(maximum, inset);
+            return true;
+        }
+
+        // 协方差矩阵按行累加（对称，C * v = sum(row_i * v_i)），幂迭代求主轴
+        const XMVECTOR mean = XMVectorScale(sum, 1.0f / (float)count);
+        XMVECTOR rows[4] = { XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero() };
+        for (uint32_t i = 0; i < BlockPixels; ++i)
+        {
+            if (active && !active[i])
+            {
+                continue;
+            }
+            const XMVECTOR d = XMVectorMultiply(XMVectorSubtract(pixels[i], mean), mask);
+            rows[0] = XMVectorMultiplyAdd(d, XMVectorSplatX(d), rows[0]);
+            rows[1] = XMVectorMultiplyAdd(d, XMVectorSplatY(d), rows[1]);
+            rows[2] = XMVectorMultiplyAdd(d, XMVectorSplatZ(d), rows[2]);
+            rows[3] = XMVectorMultiplyAdd(d, XMVectorSplatW(d), rows[3]);
+        }
+
+        XMVECTOR axis = XMVectorMultiply(XMVectorSubtract(maximum, minimum), mask);
+        for (int iteration = 0; iteration < 8; ++iteration)
+        {
+            XMVECTOR next = XMVectorMultiply(rows[0], XMVectorSplatX(axis));
+            next = XMVectorMultiplyAdd(rows[1], XMVectorSplatY(axis), next);
+            next = XMVectorMultiplyAdd(rows[2], XMVectorSplatZ(axis), next);
+            next = XMVectorMultiplyAdd(rows[3], XMVectorSplatW(axis), next);
+            // 按最大分量归一，只防止溢出，方向不变
+            XMFLOAT4 a;
+            XMStoreFloat4(&a, XMVectorAbs(next));
+            const float largest = fmaxf(fmaxf(a.x, a.y), fmaxf(a.z, a.w));
+            if (largest < 1e-6f)
+            {
+                break;
+            }
+            axis = XMVectorScale(next, 1.0f / largest);
+        }
+
+        const float lengthSq = XMVectorGetX(XMVector4Dot(axis, axis));
+        if (lengthSq < 1e-6f)
+        {
+            e0 = e1 = mean;
+            return true;
+        }
+
+        float tMin = FLT_MAX, tMax = -FLT_MAX;
+        for (uint32_t i = 0; i < BlockPixels; ++i)
+        {
+            if (active && !active[i])
+            {
+                continue;
+            }
+            const float t = XMVectorGetX(XMVector4Dot(XMVectorSubtract(pixels[i], mean), axis));
+            tMin = fminf(tMin, t);
+            tMax = fmaxf(tMax, t);
+        }
+        const XMVECTOR zero = XMVectorZero(), top = XMVectorReplicate(255.0f);
+        e0 = XMVectorClamp(XMVectorMultiplyAdd(axis, XMVectorReplicate(tMin / lengthSq), mean), zero, top);
+        e1 = XMVectorClamp(XMVectorMultiplyAdd(axis, XMVectorReplicate(tMax / lengthSq), mean), zero, top);
+        return true;
+    }
+
+    // 索引固定时端点的最小二乘解：像素 i 近似为 (1 - t_i) * e0 + t_i * e1
+    bool RefineEndpoints(const XMVECTOR* pixels, const bool* active, const uint8_t* indices, const float* weights,
+        XMVECTOR& e0, XMVECTOR& e1)
+    {
+        float a = 0.0f, b = 0.0f, c = 0.0f;
+        XMVECTOR x0 = XMVectorZero(), x1 = XMVectorZero();
+        for (uint32_t i = 0; i < BlockPixels; ++i)
+        {
+            if (active && !active[i])
+            {
+                continue;
+            }
+            const float t = weights[indices[i]];
+            const float s = 1.0f - t;
+            a += s * s;
+            b += s * t;
+            c += t * t;
+            x0 = XMVectorMultiplyAdd(pixels[i], XMVectorReplicate(s), x0);
+            x1 = XMVectorMultiplyAdd(pixels[i], XMVectorReplicate(t), x1);
+        }
+
+        const float det = a * c - b * b;
+        if (fabsf(det) < 1e-6f)
+        {
+            return false;
+        }
+        const float inv = 1.0f / det;
+        const XMVECTOR zero = XMVectorZero(), top = XMVectorReplicate(255.0f);
+        e0 = XMVectorClamp(XMVectorScale(XMVectorSubtract(XMVectorScale(x0, c), XMVectorScale(x1, b)), inv), zero, top);
+        e1 = XMVectorClamp(XMVectorScale(XMVectorSubtract(XMVectorScale(x1, a), XMVectorScale(x0, b)), inv), zero, top);
+        return true;
+    }
+
+    // ========================================================================
+    // BC1 颜色块（BC3 的颜色部分相同，但总是按 4 色解释）
+    // ========================================================================
+    enum class ColorBlockMode
+    {
+        FourColor,      // BC3：无论端点顺序都是 4 色
+        Opaque,         // BC1 不透明：需要 c0 > c1
+        Transparent     // BC1 带透明像素：需要 c0 <= c1，索引 3 为透明
+    };
+
+    uint32_t Expand5(uint32_t v) { return (v << 3) | (v >> 2); }
+    uint32_t Expand6(uint32_t v) { return (v << 2) | (v >> 4); }
+
+    uint16_t To565(FXMVECTOR color)
+    {
+        XMFLOAT4 c;
+        XMStoreFloat4(&c, color);
+        const uint32_t r = (uint32_t)(c.x * 31.0f / 255.0f + 0.5f);
+        const uint32_t g = (uint32_t)(c.y * 63.0f / 255.0f + 0.5f);
+        const uint32_t b = (uint32_t)(c.z * 31.0f / 255.0f + 0.5f);
+        return (uint16_t)((r << 11) | (g << 5) | b);
+    }
+
+    void Unpack565(uint16_t c, uint32_t rgb[3])
+    {
+        rgb[0] = Expand5(c >> 11);
+        rgb[1] = Expand6((c >> 5) & 63);
+        rgb[2] = Expand5(c & 31);
+    }
+
+    // 与 DecompressLevel 一致的整数调色板，count 为 3 时第 4 项是透明黑
+    uint32_t BuildColorPalette(uint16_t c0, uint16_t c1, bool fourColor, uint8_t palette[4][4])
+    {
+        uint32_t a[3], b[3];
+        Unpack565(c0, a);
+        Unpack565(c1, b);
+        for (int ch = 0; ch < 3; ++ch)
+        {
+            palette[0][ch] = (uint8_t)a[ch];
+            palette[1][ch] = (uint8_t)b[ch];
+            if (fourColor)
+            {
+                palette[2][ch] = (uint8_t)((2 * a[ch] + b[ch]) / 3);
+                palette[3][ch] = (uint8_t)((a[ch] + 2 * b[ch]) / 3);
+            }
+            else
+            {
+                palette[2][ch] = (uint8_t)((a[ch] + b[ch]) / 2);
+                palette[3][ch] = 0;
+            }
+        }
+        palette[0][3] = palette[1][3] = palette[2][3] = 255;
+        palette[3][3] = fourColor ? 255 : 0;
+        return fourColor ? 4 : 3;
+    }
+
+    // 单色块的最优端点：对每个 8 位值找 (e0, e1) 使 2/3 插值点最接近它（比直接量化到 565 精确得多）
+    struct SingleColorTable
+    {
+        uint8_t Fit5[256][2];
+        uint8_t Fit6[256][2];
+    };
+
+    void BuildSingleColorFit(uint32_t bits, uint8_t (*fit)[2])
+    {
+        const uint32_t count = 1u << bits;
+        for (uint32_t v = 0; v < 256; ++v)
+        {
+            int bestError = 256;
+            for (uint32_t e0 = 0; e0 < count; ++e0)
+            {
+                for (uint32_t e1 = 0; e1 < count; ++e1)
+                {
+                    const uint32_t a = bits == 5 ? Expand5(e0) : Expand6(e0);
+                    const uint32_t b = bits == 5 ? Expand5(e1) : Expand6(e1);
+                    const int error = abs((int)((2 * a + b) / 3) - (int)v);
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        fit[v][0] = (uint8_t)e0;
+                        fit[v][1] = (uint8_t)e1;
+                    }
+                }
+            }
+        }
+    }
+
+    const SingleColorTable& GetSingleColorTable()
+    {
+        static const SingleColorTable table = []()
+        {
+            SingleColorTable t;
+            BuildSingleColorFit(5, t.Fit5);
+            BuildSingleColorFit(6, t.Fit6);
+            return t;
+        }();
+        return table;
+    }
+
+    // 按模式整理端点顺序、选索引，返回误差；block 为 8 字节
+    float TryColorEndpoints(uint16_t c0, uint16_t c1, ColorBlockMode mode, const XMVECTOR* pixels,
+        const bool* opaque, uint8_t* block)
+    {
+        if ((mode == ColorBlockMode::Opaque && c0 < c1) || (mode == ColorBlockMode::Transparent && c0 > c1))
+        {
+            const uint16_t t = c0;
+            c0 = c1;
+            c1 = t;
+        }
+
+        // c0 == c1 时 BC1 按 3 色解释；所有像素都取索引 0，结果一样
+        uint8_t palette[4][4];
+        const uint32_t count = BuildColorPalette(c0, c1, mode == ColorBlockMode::FourColor || c0 > c1, palette);
+        XMVECTOR paletteColors[4];
+        for (uint32_t k = 0; k < 4; ++k)
+        {
+            paletteColors[k] = XMVectorSet(palette[k][0], palette[k][1], palette[k][2], 0.0f);
+        }
+
+        uint8_t indices[BlockPixels] = {};
+        const float error = FitIndices(pixels, opaque, paletteColors, count == 4 ? 4 : 3,
+            XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f), indices);
+
+        uint32_t bits = 0;
+        for (uint32_t i = 0; i < BlockPixels; ++i)
+        {
+            const uint32_t index = opaque && !opaque[i] ? 3 : indices[i];
+            bits |= index << (i * 2);
+        }
+        block[0] = (uint8_t)(c0 & 0xFF);
+        block[1] = (uint8_t)(c0 >> 8);
+        block[2] = (uint8_t)(c1 & 0xFF);
+        block[3] = (uint8_t)(c1 >> 8);
+        memcpy(block + 4, &bits, 4);
+        return error;
+    }
+
+    void EncodeColorBlock(const XMVECTOR* pixels, const bool* opaque, ColorBlockMode mode,
+        CompressionQuality quality, uint8_t* block)
+    {
+        const XMVECTOR rgbMask = XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f);
+        XMVECTOR e0, e1;
+        if (!FindEndpoints(pixels, opaque, rgbMask, quality, e0, e1))
+        {
+            // 整块透明
+            TryColorEndpoints(0, 0, mode, pixels, opaque, block);
+            return;
+        }
+
+        uint16_t c0, c1;
+        if (mode != ColorBlockMode::Transparent && DistanceSq(e0, e1, rgbMask) < 1e-2f)
+        {
+            const SingleColorTable& table = GetSingleColorTable();
+            XMFLOAT4 c;
+            XMStoreFloat4(&c, e0);
+            const uint32_t r = (uint32_t)(c.x + 0.5f), g = (uint32_t)(c.y + 0.5f), b = (uint32_t)(c.z + 0.5f);
+            c0 = (uint16_t)((table.Fit5[r][0] << 11) | (table.Fit6[g][0] << 5) | table.Fit5[b][0]);
+            c1 = (uint16_t)((table.Fit5[r][1] << 11) | (table.Fit6[g][1] << 5) | table.Fit5[b][1]);
+        }
+        else
+        {
+            c0 = To565(e0);
+            c1 = To565(e1);
+        }
+
+        float bestError = TryColorEndpoints(c0, c1, mode, pixels, opaque, block);
+        if (quality != CompressionQuality::High || bestError == 0.0f)
+        {
+            return;
+        }
+
+        // 索引 -> 偏向 c1 的比例（c0 > c1 的 4 色与 c0 <= c1 的 3 色）
+        static const float fourColorWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+        static const float threeColorWeights[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+        for (int iteration = 0; iteration < 2; ++iteration)
+        {
+            uint16_t b0 = (uint16_t)(block[0] | (block[1] << 8));
+            uint16_t b1 = (uint16_t)(block[2] | (block[3] << 8));
+            uint32_t bits;
+            memcpy(&bits, block + 4, 4);
+            uint8_t indices[BlockPixels];
+            for (uint32_t i = 0; i < BlockPixels; ++i)
+            {
+                indices[i] = (uint8_t)((bits >> (i * 2)) & 3);
+            }
+            const bool fourColor = mode == ColorBlockMode::FourColor || b0 > b1;
+            if (!RefineEndpoints(pixels, opaque, indices, fourColor ? fourColorWeights : threeColorWeights, e0, e1))
+            {
+                return;
+            }
+
+            uint8_t candidate[8];
+            const float error = TryColorEndpoints(To565(e0), To565(e1), mode, pixels, opaque, candidate);
+            if (error >= bestError)
+            {
+                return;
+            }
+            bestError = error;
+            memcpy(block, candidate, 8);
+        }
+    }
+
+    // ========================================================================
+    // BC3 alpha 块：两个 8 位端点 + 16 个 3 位索引
+    // ========================================================================
+    // a0 > a1 时 8 个插值点，否则 6 个插值点加 0 与 255
+    void BuildAlphaPalette(uint32_t a0, uint32_t a1, uint8_t palette[8])
+    {
+        palette[0] = (uint8_t)a0;
+        palette[1] = (uint8_t)a1;
+        if (a0 > a1)
+        {
+            for (uint32_t i = 1; i < 7; ++i)
+            {
+                palette[i + 1] = (uint8_t)(((7 - i) * a0 + i * a1) / 7);
+            }
+        }
+        else
+        {
+            for (uint32_t i = 1; i < 5; ++i)
+            {
+                palette[i + 1] = (uint8_t)(((5 - i) * a0 + i * a1) / 5);
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    uint32_t TryAlphaEndpoints(uint32_t a0, uint32_t a1, const uint8_t* alpha, uint8_t* block)
+    {
+        uint8_t palette[8];
+        BuildAlphaPalette(a0, a1, palette);
+
+        uint32_t error = 0;
+        uint64_t bits = 0;
+        for (uint32_t i = 0; i < BlockPixels; ++i)
+        {
+            uint32_t best = 256 * 256, bestIndex = 0;
+            for (uint32_t k = 0; k < 8; ++k)
+            {
+                const int d = (int)alpha[i] - (int)palette[k];
+                if ((uint32_t)(d * d) < best)
+                {
+                    best = (uint32_t)(d * d);
+                    bestIndex = k;
+                }
+            }
+            error += best;
+            bits |= (uint64_t)bestIndex << (i * 3);
+        }
+
+        block[0] = (uint8_t)a0;
+        block[1] = (uint8_t)a1;
+        for (uint32_t i = 0; i < 6; ++i)
+        {
+            block[2 + i] = (uint8_t)(bits >> (i * 8));
+        }
+        return error;
+    }
+
+    void EncodeAlphaBlock(const XMVECTOR* pixels, CompressionQuality quality, uint8_t* block)
+    {
+        uint8_t alpha[BlockPixels];
+        uint32_t minimum = 255, maximum = 0;
+        uint32_t innerMin = 255, innerMax = 0;
+        for (uint32_t i = 0; i < BlockPixels; ++i)
+        {
+            alpha[i] = (uint8_t)XMVectorGetW(pixels[i]);
+            minimum = alpha[i] < minimum ? alpha[i] : minimum;
+            maximum = alpha[i] > maximum ? alpha[i] : maximum;
+            if (alpha[i] != 0 && alpha[i] != 255)
+            {
+                innerMin = alpha[i] < innerMin ? alpha[i] : innerMin;
+                innerMax = alpha[i] > innerMax ? alpha[i] : innerMax;
+            }
+        }
+
+        const uint32_t error = TryAlphaEndpoints(maximum, minimum, alpha, block);
+        // 块里同时有 0/255 与中间值时，6 点模式把两端让给 0 与 255，中间值插值更细
+        if (quality == CompressionQuality::High && error > 0 && innerMin <= innerMax)
+        {
+            uint8_t candidate[8];
+            if (TryAlphaEndpoints(innerMin, innerMax, alpha, candidate) < error)
+            {
+                memcpy(block, candidate, 8);
+            }
+        }
+    }
+
+    // ========================================================================
+    // BC7 mode 6：单子集，RGBA 各 7 位端点 + 每端点 1 个 p 位，16 个 4 位索引
+    // ========================================================================
+    void QuantizeMode6(FXMVECTOR endpoint, uint32_t pbit, int out[4])
+    {
+        XMFLOAT4 e;
+        XMStoreFloat4(&e, endpoint);
+        const float values[4] = { e.x, e.y, e.z, e.w };
+        for (int ch = 0; ch < 4; ++ch)
+        {
+            int q = (int)floorf((values[ch] - (float)pbit) * 0.5f + 0.5f);
+            q = q < 0 ? 0 : (q > 127 ? 127 : q);
+            out[ch] = (q << 1) | (int)pbit;
+        }
+    }
+
+    float QuantizationError(FXMVECTOR endpoint, const int quantized[4])
+    {
+        return DistanceSq(endpoint, XMVectorSet((float)quantized[0], (float)quantized[1], (float)quantized[2],
+            (float)quantized[3]), XMVectorReplicate(1.0f));
+    }
+
+    float TryMode6(const XMVECTOR* pixels, const int e0[4], const int e1[4], uint8_t* indices)
+    {
+        XMVECTOR palette[16];
+        for (int k = 0; k < 16; ++k)
+        {
+            const int w = Bc7Weights4[k];
+            int c[4];
+            for (int ch = 0; ch < 4; ++ch)
+            {
+                c[ch] = ((64 - w) * e0[ch] + w * e1[ch] + 32) >> 6;
+            }
+            palette[k] = XMVectorSet((float)c[0], (float)c[1], (float)c[2], (float)c[3]);
+        }
+        return FitIndices(pixels, nullptr, palette, 16, XMVectorReplicate(1.0f), indices);
+    }
+
+    struct Mode6Block
+    {
+        int E0[4];
+        int E1[4];
+        uint8_t Indices[BlockPixels];
+        float Error = FLT_MAX;
+    };
+
+    // 量化端点并选索引，High 穷举 4 种 p 位组合，其余各端点取量化误差小的 p 位。
+    // 不透明的块两个 p 位都取 1，alpha 才能精确落在 255
+    void FitMode6(const XMVECTOR* pixels, FXMVECTOR e0, FXMVECTOR e1, CompressionQuality quality, bool opaque,
+        Mode6Block& best)
+    {
+        int quantized0[2][4], quantized1[2][4];
+        for (uint32_t pbit = 0; pbit < 2; ++pbit)
+        {
+            QuantizeMode6(e0, pbit, quantized0[pbit]);
+            QuantizeMode6(e1, pbit, quantized1[pbit]);
+        }
+
+        const uint32_t comboCount = quality == CompressionQuality::High ? 4 : 1;
+        for (uint32_t combo = 0; combo < comboCount; ++combo)
+        {
+            uint32_t p0 = combo & 1, p1 = combo >> 1;
+            if (opaque)
+            {
+                p0 = p1 = 1;
+                combo = comboCount;
+            }
+            else if (quality != CompressionQuality::High)
+            {
+                p0 = QuantizationError(e0, quantized0[1]) < QuantizationError(e0, quantized0[0]) ? 1 : 0;
+                p1 = QuantizationError(e1, quantized1[1]) < QuantizationError(e1, quantized1[0]) ? 1 : 0;
+            }
+
+            Mode6Block candidate;
+            memcpy(candidate.E0, quantized0[p0], sizeof(candidate.E0));
+            memcpy(candidate.E1, quantized1[p1], sizeof(candidate.E1));
+            candidate.Error = TryMode6(pixels, candidate.E0, candidate.E1, candidate.Indices);
+            if (candidate.Error < best.Error)
+            {
+                best = candidate;
+            }
+        }
+    }
+
+    void EncodeBc7Block(const XMVECTOR* pixels, CompressionQuality quality, uint8_t* block)
+    {
+        bool opaque = true;
+        for (uint32_t i = 0; i < BlockPixels; ++i)
+        {
+            opaque &= XMVectorGetW(pixels[i]) == 255.0f;
+        }
+
+        XMVECTOR e0, e1;
+        FindEndpoints(pixels, nullptr, XMVectorReplicate(1.0f), quality, e0, e1);
+
+        Mode6Block best;
+        FitMode6(pixels, e0, e1, quality, opaque, best);
+        if (quality == CompressionQuality::High)
+        {
+            float weights[16];
+            for (int k = 0; k < 16; ++k)
+            {
+                weights[k] = (float)Bc7Weights4[k] / 64.0f;
+            }
+            for (int iteration = 0; iteration < 2 && best.Error > 0.0f; ++iteration)
+            {
+                const float previous = best.Error;
+                if (!RefineEndpoints(pixels, nullptr, best.Indices, weights, e0, e1))
+                {
+                    break;
+                }
+                FitMode6(pixels, e0, e1, quality, opaque, best);
+                if (best.Error >= previous)
+                {
+                    break;
+                }
+            }
+        }
+
+        // 第 0 个像素的索引（锚点）只存 3 位，最高位必须为 0：否则交换端点、索引取反
+        if (best.Indices[0] & 8)
+        {
+            for (int ch = 0; ch < 4; ++ch)
+            {
+                const int t = best.E0[ch];
+                best.E0[ch] = best.E1[ch];
+                best.E1[ch] = t;
+            }
+            for (uint32_t i = 0; i < BlockPixels; ++i)
+            {
+                best.Indices[i] = (uint8_t)(15 - best.Indices[i]);
+            }
+        }
+
+        memset(block, 0, 16);
+        BitWriter writer{ block };
+        writer.Write(1u << 6, 7);
+        for (int ch = 0; ch < 4; ++ch)
+        {
+            writer.Write((uint32_t)best.E0[ch] >> 1, 7);
+            writer.Write((uint32_t)best.E1[ch] >> 1, 7);
+        }
+        writer.Write((uint32_t)best.E0[0] & 1, 1);
+        writer.Write((uint32_t)best.E1[0] & 1, 1);
+        for (uint32_t i = 0; i < BlockPixels; ++i)
+        {
+            writer.Write(best.Indices[i], i == 0 ? 3 : 4);
+        }
+    }
+
+    // ========================================================================
+    // 解码
+    // ========================================================================
+    void DecodeColorBlock(const uint8_t* block, bool forceFourColor, uint8_t (*texels)[4])
+    {
+        const uint16_t c0 = (uint16_t)(block[0] | (block[1] << 8));
+        const uint16_t c1 = (uint16_t)(block[2] | (block[3] << 8));
+        uint8_t palette[4][4];
+        BuildColorPalette(c0, c1, forceFourColor || c0 > c1, palette);
+        uint32_t bits;
+        memcpy(&bits, block + 4, 4);
+        for (uint32_t i = 0; i < BlockPixels; ++i)
+        {
+            memcpy(texels[i], palette[(bits >> (i * 2)) & 3], 4);
+        }
+    }
+
+    void DecodeAlphaBlock(const uint8_t* block, uint8_t (*texels)[4])
+    {
+        uint8_t palette[8];
+        BuildAlphaPalette(block[0], block[1], palette);
+        uint64_t bits = 0;
+        for (uint32_t i = 0; i < 6; ++i)
+        {
+            bits |= (uint64_t)block[2 + i] << (i * 8);
+        }
+        for (uint32_t i = 0; i < BlockPixels; ++i)
+        {
+            texels[i][3] = palette[(bits >> (i * 3)) & 7];
+        }
+    }
+
+    bool DecodeBc7Block(const uint8_t* block, uint8_t (*texels)[4])
+    {
+        BitReader reader{ block };
+        if (reader.Read(7) != (1u << 6))
+        {
+            return false;
+        }
+        uint32_t e0[4], e1[4];
+        for (int ch = 0; ch < 4; ++ch)
+        {
+            e0[ch] = reader.Read(7) << 1;
+            e1[ch] = reader.Read(7) << 1;
+        }
+        const uint32_t p0 = reader.Read(1), p1 = reader.Read(1);
+        for (int ch = 0; ch < 4; ++ch)
+        {
+            e0[ch] |= p0;
+            e1[ch] |= p1;
+        }
+        for (uint32_t i = 0; i < BlockPixels; ++i)
+        {
+            const int w = Bc7Weights4[reader.Read(i == 0 ? 3 : 4)];
+            for (int ch = 0; ch < 4; ++ch)
+            {
+                texels[i][ch] = (uint8_t)(((64 - w) * (int)e0[ch] + w * (int)e1[ch] + 32) >> 6);
+            }
+        }
+        return true;
+    }
+
+    void EncodeBlock(TextureFormat format, CompressionQuality quality, const XMVECTOR* pixels, uint8_t* block)
+    {
+        switch (format)
+        {
+        case TextureFormat::BC1:
+        {
+            // 有 alpha < 128 的像素时用 3 色模式，这些像素取透明索引
+            bool opaque[BlockPixels];
+            bool anyTransparent = false;
+            for (uint32_t i = 0; i < BlockPixels; ++i)
+            {
+                opaque[i] = XMVectorGetW(pixels[i]) >= 128.0f;
+                anyTransparent |= !opaque[i];
+            }
+            if (anyTransparent)
+            {
+                EncodeColorBlock(pixels, opaque, ColorBlockMode::Transparent, quality, block);
+            }
+            else
+            {
+                EncodeColorBlock(pixels, nullptr, ColorBlockMode::Opaque, quality, block);
+            }
+            break;
+        }
+        case TextureFormat::BC3:
+            EncodeAlphaBlock(pixels, quality, block);
+            EncodeColorBlock(pixels, nullptr, ColorBlockMode::FourColor, quality, block + 8);
+            break;
+        case TextureFormat::BC7:
+            EncodeBc7Block(pixels, quality, block);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// ============================================================================
+// 格式
+// ============================================================================
+uint32_t GetBlockBytes(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1:
+        return 8;
+    case TextureFormat::BC3:
+    case TextureFormat::BC7:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+size_t GetRowPitch(TextureFormat format, uint32_t width)
+{
+    const uint32_t blockBytes = GetBlockBytes(format);
+    return blockBytes ? (size_t)((width + 3) / 4) * blockBytes : (size_t)width * 4;
+}
+
+uint32_t GetRowCount(TextureFormat format, uint32_t height)
+{
+    return GetBlockBytes(format) ? (height + 3) / 4 : height;
+}
+
+bool IsValidTopLevel(TextureFormat format, uint32_t width, uint32_t height)
+{
+    return !GetBlockBytes(format) || (width % 4 == 0 && height % 4 == 0);
+}
+
+TextureFormat ChooseTextureFormat(const CompressionSettings& settings, const uint8_t* rgba,
+    uint32_t width, uint32_t height)
+{
+    if (settings.Mode == CompressionMode::None || width % 4 != 0 || height % 4 != 0)
+    {
+        return TextureFormat::RGBA8;
+    }
+
+    switch (settings.Mode)
+    {
+    case CompressionMode::BC1:
+        return TextureFormat::BC1;
+    case CompressionMode::BC3:
+        return TextureFormat::BC3;
+    case CompressionMode::BC7:
+        return TextureFormat::BC7;
+    default:
+        break;
+    }
+
+    if (settings.Quality == CompressionQuality::High)
+    {
+        return TextureFormat::BC7;
+    }
+    const size_t pixelCount = (size_t)width * height;
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        if (rgba[i * 4 + 3] != 255)
+        {
+            return TextureFormat::BC3;
+        }
+    }
+    return TextureFormat::BC1;
+}
+
+// ============================================================================
+// 压缩与解压
+// ============================================================================
+void CompressLevel(TextureFormat format, CompressionQuality quality, const uint8_t* rgba,
+    uint32_t width, uint32_t height, uint8_t* out, ThreadPool* pool)
+{
+    const uint32_t blockBytes = GetBlockBytes(format);
+    if (blockBytes == 0)
+    {
+        return;
+    }
+
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    auto encodeRows = [&](size_t begin, size_t end)
+    {
+        XMVECTOR pixels[BlockPixels];
+        for (size_t by = begin; by < end; ++by)
+        {
+            uint8_t* row = out + by * blocksX * blockBytes;
+            for (uint32_t bx = 0; bx < blocksX; ++bx)
+            {
+                LoadBlock(rgba, width, height, bx, (uint32_t)by, pixels);
+                EncodeBlock(format, quality, pixels, row + (size_t)bx * blockBytes);
+            }
+        }
+    };
+
+    // 每个任务大约 256 块，小的 mip 级直接在调用线程上做
+    const size_t grain = blocksX >= 256 ? 1 : 256 / blocksX;
+    if (pool)
+    {
+        pool->ParallelFor(blocksY, grain, encodeRows);
+    }
+    else
+    {
+        encodeRows(0, blocksY);
+    }
+}
+
+void CompressMipChain(TextureFormat format, CompressionQuality quality, const std::vector<uint8_t>& rgba,
+    std::vector<MipLevel>& levels, std::vector<uint8_t>& out, ThreadPool* pool)
+{
+    size_t total = 0;
+    for (const MipLevel& level : levels)
+    {
+        total += GetRowPitch(format, level.Width) * GetRowCount(format, level.Height);
+    }
+    out.resize(total);
+
+    size_t offset = 0;
+    for (MipLevel& level : levels)
+    {
+        CompressLevel(format, quality, rgba.data() + level.Offset, level.Width, level.Height, out.data() + offset, pool);
+        level.Offset = offset;
+        offset += GetRowPitch(format, level.Width) * GetRowCount(format, level.Height);
+    }
+}
+
+bool DecompressLevel(TextureFormat format, const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* rgba)
+{
+    const uint32_t blockBytes = GetBlockBytes(format);
+    if (blockBytes == 0)
+    {
+        memcpy(rgba, blocks, (size_t)width * height * 4);
+        return true;
+    }
+
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    uint8_t texels[BlockPixels][4];
+    for (uint32_t by = 0; by < blocksY; ++by)
+    {
+        for (uint32_t bx = 0; bx < blocksX; ++bx)
+        {
+            const uint8_t* block = blocks + ((size_t)by * blocksX + bx) * blockBytes;
+            switch (format)
+            {
+            case TextureFormat::BC1:
+                DecodeColorBlock(block, false, texels);
+                break;
+            case TextureFormat::BC3:
+                DecodeColorBlock(block + 8, true, texels);
+                DecodeAlphaBlock(block, texels);
+                break;
+            default:
+                if (!DecodeBc7Block(block, texels))
+                {
+                    return false;
+                }
+                break;
+            }
+            StoreBlock(texels, width, height, bx, by, rgba);
+        }
+    }
+    return true;
+}
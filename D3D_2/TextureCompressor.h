@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MipGenerator.h"
+
+class ThreadPool;
+
+// 纹理在显存中的格式：RGBA8 或 4x4 块压缩（均为 UNORM，与未压缩时的 R8G8B8A8_UNORM 对应）
+enum class TextureFormat : uint32_t
+{
+    RGBA8,
+    BC1,        // 每块 8 字节：RGB 两个 565 端点 + 2 位索引，可带 1 位透明
+    BC3,        // 每块 16 字节：BC1 的颜色块 + 独立插值的 8 位 alpha
+    BC7         // 每块 16 字节：只用 mode 6（单子集，RGBA 7 位端点 + p 位，4 位索引）
+};
+
+enum class CompressionMode : uint32_t
+{
+    None,       // 保持 RGBA8
+    Auto,       // Fast/Normal：不透明用 BC1、有 alpha 用 BC3；High：BC7
+    BC1,
+    BC3,
+    BC7
+};
+
+// 质量档位：端点的求法不同，编码速度大致逐档慢一个数量级
+enum class CompressionQuality : uint32_t
+{
+    Fast,       // 包围盒对角线（内缩 1/16）
+    Normal,     // 协方差主轴上的投影极值
+    High        // 主轴 + 按索引最小二乘反复修正端点；BC7 穷举 p 位，BC3 的 alpha 两种模式都试
+};
+
+struct CompressionSettings
+{
+    CompressionMode Mode = CompressionMode::Auto;
+    CompressionQuality Quality = CompressionQuality::Normal;
+};
+
+// 每块字节数（RGBA8 为 0）
+uint32_t GetBlockBytes(TextureFormat format);
+// 一行（块压缩时为一行块）的字节数与行数，与 D3D12 子资源的 RowPitch / 行数一致
+size_t GetRowPitch(TextureFormat format, uint32_t width);
+uint32_t GetRowCount(TextureFormat format, uint32_t height);
+// 这个尺寸的一级能否作为纹理的第 0 级（流式加载时跳过更精细的级）：块压缩格式要求宽高是 4 的倍数
+bool IsValidTopLevel(TextureFormat format, uint32_t width, uint32_t height);
+
+// 按设置与图像内容选择格式。D3D12 要求块压缩纹理第 0 级的宽高是 4 的倍数，不满足时返回 RGBA8
+TextureFormat ChooseTextureFormat(const CompressionSettings& settings, const uint8_t* rgba,
+    uint32_t width, uint32_t height);
+
+// 压缩一级（不足 4 的边按边缘像素补齐）。pool 不为空时按块行并行，调用线程也参与
+void CompressLevel(TextureFormat format, CompressionQuality quality, const uint8_t* rgba,
+    uint32_t width, uint32_t height, uint8_t* out, ThreadPool* pool);
+
+// 压缩 MipGenerator 布局的整条 RGBA8 链，levels 的 Offset 改为在 out 中的位置
+void CompressMipChain(TextureFormat format, CompressionQuality quality, const std::vector<uint8_t>& rgba,
+    std::vector<MipLevel>& levels, std::vector<uint8_t>& out, ThreadPool* pool);
+
+// 解压一级到 RGBA8（用于误差统计）。BC7 只支持本编码器产生的 mode 6 块，其他模式返回 false
+bool DecompressLevel(TextureFormat format, const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* rgba);
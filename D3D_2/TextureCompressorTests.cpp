@@ -0,0 +1,220 @@
+#include "SelfTest.h"
+#include "TextureCompressor.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// ============================================================================
+// TextureCompressor：BC1/BC3/BC7 各质量档的 PSNR 不低于阈值；并行与串行逐字节一致
+// ============================================================================
+namespace
+{
+    enum class TestImage
+    {
+        Smooth,     // 平滑的“照片”：低频渐变叠一点高频纹理
+        Edges       // 6 像素棋盘，三种饱和色，块内硬边
+    };
+
+    void MakeImage(uint32_t width, uint32_t height, TestImage kind, bool alpha, std::vector<uint8_t>& out)
+    {
+        out.resize((size_t)width * height * 4);
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                uint8_t* p = &out[((size_t)y * width + x) * 4];
+                const double fx = x / (double)width, fy = y / (double)height;
+                if (kind == TestImage::Smooth)
+                {
+                    p[0] = (uint8_t)(127 + 100 * std::sin(fx * 9 + fy * 3) + 20 * std::sin(x * 0.7) * std::sin(y * 0.5));
+                    p[1] = (uint8_t)(127 + 90 * std::cos(fy * 7 - fx * 2) + 15 * std::sin(x * 0.3 + y * 0.9));
+                    p[2] = (uint8_t)(60 + 60 * fx + 60 * fy + 10 * std::sin(x * 1.3));
+                }
+                else
+                {
+                    const uint32_t c = (x / 6 + y / 6) % 3;
+                    p[0] = c == 0 ? 230 : 20;
+                    p[1] = c == 1 ? 210 : 30;
+                    p[2] = c == 2 ? 250 : 10;
+                }
+                p[3] = alpha ? (uint8_t)(255 * (0.5 + 0.5 * std::sin(fx * 6.28 * 2) * std::cos(fy * 6.28))) : 255;
+            }
+        }
+    }
+
+    // 通道 [first, last) 的 PSNR（dB），无误差时返回 99
+    double Psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, int first, int last)
+    {
+        double error = 0.0;
+        size_t count = 0;
+        for (size_t p = 0; p < a.size(); p += 4)
+        {
+            for (int c = first; c < last; ++c)
+            {
+                const double d = (double)a[p + c] - (double)b[p + c];
+                error += d * d;
+                ++count;
+            }
+        }
+        return error > 0.0 ? 10.0 * std::log10(255.0 * 255.0 * count / error) : 99.0;
+    }
+
+    // 最低 PSNR（256x256 实测值往下留约 1 dB）。棋盘每块最多三种饱和色，单条端点线放不下，
+    // Fast 的包围盒对角线尤其差；Normal 与 High 用同一个阈值
+    double MinRgbPsnr(TestImage kind, TextureFormat format, CompressionQuality quality)
+    {
+        const bool fast = quality == CompressionQuality::Fast;
+        if (kind == TestImage::Edges)
+        {
+            return fast ? 11.0 : 21.0;
+        }
+        if (format == TextureFormat::BC7)
+        {
+            return fast ? 30.5 : 33.5;
+        }
+        return fast ? 30.0 : 32.5;
+    }
+
+    // BC1 不参与渐变 alpha；BC7 的 alpha 与颜色共用端点与索引，比 BC3 的独立 alpha 块差
+    double MinAlphaPsnr(TextureFormat format, CompressionQuality quality)
+    {
+        if (format == TextureFormat::BC3)
+        {
+            return 52.0;
+        }
+        if (format == TextureFormat::BC7)
+        {
+            return quality == CompressionQuality::Fast ? 34.5 : 38.0;
+        }
+        return 0.0;
+    }
+
+    const char* FormatName(TextureFormat format)
+    {
+        return format == TextureFormat::BC1 ? "BC1" : (format == TextureFormat::BC3 ? "BC3" : "BC7");
+    }
+}
+
+void TestTextureCompressor(SelfTestContext& ctx)
+{
+    ThreadPool pool(3);
+    const TextureFormat formats[] = { TextureFormat::BC1, TextureFormat::BC3, TextureFormat::BC7 };
+    const CompressionQuality qualities[] = { CompressionQuality::Fast, CompressionQuality::Normal, CompressionQuality::High };
+
+    // PSNR 阈值：低于阈值即失败；档位越高 RGB 不应变差；并行结果与串行逐字节一致
+    {
+        // 阈值按 256x256 定：图像的频率随尺寸变，换尺寸要重新定阈值
+        const uint32_t w = 256, h = 256;
+        std::vector<uint8_t> image, blocks, serial, decoded(w * h * 4);
+        for (TestImage kind : { TestImage::Smooth, TestImage::Edges })
+        {
+            for (bool alpha : { false, true })
+            {
+                MakeImage(w, h, kind, alpha, image);
+                for (TextureFormat format : formats)
+                {
+                    // BC1 的 alpha 只有 1 位，渐变 alpha 不适用
+                    if (format == TextureFormat::BC1 && alpha)
+                    {
+                        continue;
+                    }
+                    double previous = 0.0;
+                    for (CompressionQuality quality : qualities)
+                    {
+                        blocks.assign(GetRowPitch(format, w) * GetRowCount(format, h), 0);
+                        serial.assign(blocks.size(), 0);
+                        CompressLevel(format, quality, image.data(), w, h, blocks.data(), &pool);
+                        CompressLevel(format, quality, image.data(), w, h, serial.data(), nullptr);
+                        SELF_CHECK(ctx, blocks == serial);
+                        SELF_CHECK(ctx, DecompressLevel(format, blocks.data(), w, h, decoded.data()));
+
+                        const double rgb = Psnr(image, decoded, 0, 3);
+                        const double a = Psnr(image, decoded, 3, 4);
+                        const bool rgbOk = rgb >= MinRgbPsnr(kind, format, quality);
+                        const bool alphaOk = a >= MinAlphaPsnr(format, quality);
+                        if (!rgbOk || !alphaOk || rgb < previous - 0.05)
+                        {
+                            printf("  %s %s quality %u: PSNR rgb %.2f / alpha %.2f dB\n",
+                                kind == TestImage::Smooth ? "smooth" : "edges", FormatName(format),
+                                (uint32_t)quality, rgb, a);
+                        }
+                        SELF_CHECK(ctx, rgbOk);
+                        SELF_CHECK(ctx, alphaOk);
+                        SELF_CHECK(ctx, rgb >= previous - 0.05);
+                        previous = rgb;
+                    }
+                }
+            }
+        }
+    }
+
+    // 纯色块：各格式都在 2 级以内
+    {
+        std::vector<uint8_t> image(16 * 4), decoded(16 * 4);
+        uint8_t blocks[16];
+        int maxError = 0;
+        for (int v : { 0, 1, 37, 128, 200, 254, 255 })
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                image[i * 4 + 0] = (uint8_t)v;
+                image[i * 4 + 1] = (uint8_t)(255 - v);
+                image[i * 4 + 2] = (uint8_t)(v / 2);
+                image[i * 4 + 3] = 255;
+            }
+            for (TextureFormat format : formats)
+            {
+                CompressLevel(format, CompressionQuality::Normal, image.data(), 4, 4, blocks, nullptr);
+                DecompressLevel(format, blocks, 4, 4, decoded.data());
+                for (int i = 0; i < 64; ++i)
+                {
+                    const int error = std::abs((int)decoded[i] - (int)image[i]);
+                    maxError = error > maxError ? error : maxError;
+                }
+            }
+        }
+        SELF_CHECK(ctx, maxError <= 2);
+    }
+
+    // BC1 1 位透明：0/255 的 alpha 原样保留
+    {
+        const uint32_t w = 64, h = 64;
+        std::vector<uint8_t> image, decoded(w * h * 4);
+        MakeImage(w, h, TestImage::Smooth, true, image);
+        for (size_t i = 3; i < image.size(); i += 4)
+        {
+            image[i] = image[i] < 128 ? 0 : 255;
+        }
+        std::vector<uint8_t> blocks(GetRowPitch(TextureFormat::BC1, w) * GetRowCount(TextureFormat::BC1, h));
+        CompressLevel(TextureFormat::BC1, CompressionQuality::High, image.data(), w, h, blocks.data(), nullptr);
+        DecompressLevel(TextureFormat::BC1, blocks.data(), w, h, decoded.data());
+        bool alphaKept = true;
+        for (size_t i = 3; i < image.size(); i += 4)
+        {
+            alphaKept &= decoded[i] == image[i];
+        }
+        SELF_CHECK(ctx, alphaKept);
+    }
+
+    // 格式选择与整条链：块压缩要求第 0 级是 4 的倍数，链的偏移落在输出里
+    {
+        CompressionSettings settings;
+        std::vector<uint8_t> opaque, translucent;
+        MakeImage(64, 64, TestImage::Smooth, false, opaque);
+        MakeImage(64, 64, TestImage::Smooth, true, translucent);
+        SELF_CHECK(ctx, ChooseTextureFormat(settings, opaque.data(), 64, 64) == TextureFormat::BC1);
+        SELF_CHECK(ctx, ChooseTextureFormat(settings, translucent.data(), 64, 64) == TextureFormat::BC3);
+        SELF_CHECK(ctx, ChooseTextureFormat(settings, translucent.data(), 66, 64) == TextureFormat::RGBA8);
+        settings.Quality = CompressionQuality::High;
+        SELF_CHECK(ctx, ChooseTextureFormat(settings, opaque.data(), 64, 64) == TextureFormat::BC7);
+
+        std::vector<MipLevel> levels;
+        GenerateMipChain(opaque, 64, 64, MipSettings(), levels);
+        std::vector<uint8_t> out;
+        CompressMipChain(TextureFormat::BC1, CompressionQuality::Normal, opaque, levels, out, &pool);
+        SELF_CHECK(ctx, levels.size() == 7);
+        SELF_CHECK(ctx, out.size() == (size_t)(16 * 16 + 8 * 8 + 4 * 4 + 2 * 2 + 1 + 1 + 1) * 8);
+        SELF_CHECK(ctx, levels.back().Offset == out.size() - 8);
+    }
+}
@@ -0,0 +1,488 @@
+#include "TextureLoader.h"
+#include "ThreadPool.h"
+#include "FrameProfiler.h"
+#include "ShaderCache.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    // 缓存条目：头 + 各级位置 + 数据
+    struct EncodedTextureHeader
+    {
+        uint32_t Format;
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t LevelCount;
+    };
+
+    struct EncodedTextureLevel
+    {
+        uint32_t Width;
+        uint32_t Height;
+        uint64_t Offset;
+    };
+
+    // 文件内容 + 会改变处理结果的全部设置
+    uint64_t MakeEncodedTextureKey(uint64_t contentHash, const MipSettings& mips, const CompressionSettings& compression)
+    {
+        const uint32_t settings[] = {
+            (uint32_t)mips.Filter, mips.SrgbColor ? 1u : 0u, mips.MaxLevels,
+            (uint32_t)compression.Mode, (uint32_t)compression.Quality };
+        return HashBytes(settings, sizeof(settings), HashBytes(&contentHash, sizeof(contentHash)));
+    }
+
+    void SerializeEncodedTexture(const DecodedImage& image, std::vector<uint8_t>& out)
+    {
+        const EncodedTextureHeader header{ (uint32_t)image.Format, image.Width, image.Height, (uint32_t)image.Levels.size() };
+        const size_t levelsSize = image.Levels.size() * sizeof(EncodedTextureLevel);
+        out.resize(sizeof(header) + levelsSize + image.Pixels.size());
+        memcpy(out.data(), &header, sizeof(header));
+        for (size_t i = 0; i < image.Levels.size(); ++i)
+        {
+            const EncodedTextureLevel level{ image.Levels[i].Width, image.Levels[i].Height, (uint64_t)image.Levels[i].Offset };
+            memcpy(out.data() + sizeof(header) + i * sizeof(level), &level, sizeof(level));
+        }
+        memcpy(out.data() + sizeof(header) + levelsSize, image.Pixels.data(), image.Pixels.size());
+    }
+
+    // BlobCache 已校验过内容哈希，这里只防格式不符（各级必须落在数据范围内）
+    bool DeserializeEncodedTexture(const std::vector<uint8_t>& data, DecodedImage& out)
+    {
+        EncodedTextureHeader header;
+        if (data.size() < sizeof(header))
+        {
+            return false;
+        }
+        memcpy(&header, data.data(), sizeof(header));
+        const size_t levelsSize = (size_t)header.LevelCount * sizeof(EncodedTextureLevel);
+        if (header.Format > (uint32_t)TextureFormat::BC7 || header.LevelCount == 0 || header.LevelCount > 32 ||
+            data.size() < sizeof(header) + levelsSize)
+        {
+            return false;
+        }
+
+        const TextureFormat format = (TextureFormat)header.Format;
+        const size_t pixelsSize = data.size() - sizeof(header) - levelsSize;
+        out.Levels.resize(header.LevelCount);
+        for (uint32_t i = 0; i < header.LevelCount; ++i)
+        {
+            EncodedTextureLevel level;
+            memcpy(&level, data.data() + sizeof(header) + (size_t)i * sizeof(level), sizeof(level));
+            const uint64_t size = (uint64_t)GetRowPitch(format, level.Width) * GetRowCount(format, level.Height);
+            if (level.Width == 0 || level.Height == 0 || level.Offset > pixelsSize || size > pixelsSize - level.Offset)
+            {
+                return false;
+            }
+            out.Levels[i] = MipLevel{ level.Width, level.Height, (size_t)level.Offset };
+        }
+
+        out.Width = header.Width;
+        out.Height = header.Height;
+        out.Format = format;
+        out.Pixels.assign(data.begin() + (ptrdiff_t)(sizeof(header) + levelsSize), data.end());
+        return true;
+    }
+}
+
+bool ReadFileBytes(const std::wstring& path, std::vector<uint8_t>& out)
+{
+    std::ifstream file(std::filesystem::path(path), std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return false;
+    }
+    const std::streamoff size = file.tellg();
+    if (size <= 0 || size > 0x7FFFFFFF)
+    {
+        return false;
+    }
+    out.resize((size_t)size);
+    file.seekg(0);
+    return (bool)file.read(reinterpret_cast<char*>(out.data()), size);
+}
+
+bool ITextureDecoder::DecodeFile(const std::wstring& path, DecodedImage& out)
+{
+    std::vector<uint8_t> data;
+    if (!ReadFileBytes(path, data) || !Decode(data.data(), data.size(), out))
+    {
+        return false;
+    }
+    // 0 留作“未知”
+    out.ContentHash = HashBytes(data.data(), data.size());
+    out.ContentHash = out.ContentHash ? out.ContentHash : 1;
+    return true;
+}
+
+// ============================================================================
+// 构造与析构
+// ============================================================================
+TextureLoader::TextureLoader(ITextureDecoder& decoder, ThreadPool* pool)
+    : m_decoder(decoder)
+    , m_pool(pool)
+{
+}
+
+TextureLoader::~TextureLoader()
+{
+    WaitDecodes();
+}
+
+// ============================================================================
+// 请求与取消
+// ============================================================================
+void TextureLoader::Request(uint64_t key, const std::wstring& path, uint32_t maxSize)
+{
+    auto job = std::make_shared<Job>();
+    job->Key = key;
+    job->Path = path;
+    job->MaxSize = maxSize;
+    job->Generation = m_nextGeneration++;
+    job->Mips = m_mipSettings;
+    job->Compression = m_compression;
+    m_latest[key] = job->Generation;
+    m_queued.push_back(std::move(job));
+    StartDecodes();
+}
+
+void TextureLoader::Cancel(uint64_t key)
+{
+    // 各阶段的旧任务在推进时发现代号不符自行丢弃
+    m_latest.erase(key);
+}
+
+bool TextureLoader::IsCurrent(const Job& job) const
+{
+    auto it = m_latest.find(job.Key);
+    return it != m_latest.end() && it->second == job.Generation;
+}
+
+// ============================================================================
+// 解码（工作线程）
+// ============================================================================
+void TextureLoader::StartDecodes()
+{
+    if (!m_pool)
+    {
+        return;
+    }
+
+    while (!m_queued.empty())
+    {
+        std::shared_ptr<Job> job = m_queued.front();
+        if (!IsCurrent(*job))
+        {
+            m_queued.pop_front();
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_shared.Mutex);
+            if (m_shared.Decoding >= m_maxConcurrentDecodes)
+            {
+                return;
+            }
+            ++m_shared.Decoding;
+            ++m_shared.InFlight;
+        }
+        m_queued.pop_front();
+        m_pool->Submit([this, job]()
+        {
+            RunDecode(job);
+        });
+    }
+}
+
+void TextureLoader::Decode(Job& job)
+{
+    std::vector<uint8_t> file;
+    {
+        PROFILE_SCOPE("ReadTextureFile");
+        if (!ReadFileBytes(job.Path, file))
+        {
+            return;
+        }
+    }
+    uint64_t contentHash = HashBytes(file.data(), file.size());
+    contentHash = contentHash ? contentHash : 1;
+
+    // 内容与设置都没变时直接用上次处理好的 mip 链
+    const uint64_t cacheKey = MakeEncodedTextureKey(contentHash, job.Mips, job.Compression);
+    if (m_encodedCache)
+    {
+        PROFILE_SCOPE("LoadEncodedTexture");
+        std::vector<uint8_t> cached;
+        if (m_encodedCache->Load(cacheKey, cached) && DeserializeEncodedTexture(cached, job.Image))
+        {
+            job.Image.ContentHash = contentHash;
+            job.Decoded = true;
+            SelectLevels(job);
+            return;
+        }
+    }
+
+    {
+        PROFILE_SCOPE("DecodeImage");
+        job.Decoded = m_decoder.Decode(file.data(), file.size(), job.Image);
+    }
+    if (!job.Decoded)
+    {
+        return;
+    }
+    job.Image.ContentHash = contentHash;
+    file.clear();
+    file.shrink_to_fit();
+
+    DecodedImage& image = job.Image;
+    {
+        PROFILE_SCOPE("GenerateMips");
+        GenerateMipChain(image.Pixels, image.Width, image.Height, job.Mips, image.Levels);
+    }
+
+    const TextureFormat format = ChooseTextureFormat(job.Compression, image.Pixels.data(), image.Width, image.Height);
+    if (format != TextureFormat::RGBA8)
+    {
+        PROFILE_SCOPE("CompressTexture");
+        std::vector<uint8_t> blocks;
+        CompressMipChain(format, job.Compression.Quality, image.Pixels, image.Levels, blocks, m_pool);
+        image.Pixels.swap(blocks);
+        image.Format = format;
+    }
+
+    // 未压缩的结果不存盘：体积是源文件的数倍，读盘未必比解码快
+    if (m_encodedCache && image.Format != TextureFormat::RGBA8)
+    {
+        PROFILE_SCOPE("StoreEncodedTexture");
+        std::vector<uint8_t> encoded;
+        SerializeEncodedTexture(image, encoded);
+        m_encodedCache->Store(cacheKey, encoded.data(), encoded.size());
+    }
+    SelectLevels(job);
+}
+
+void TextureLoader::SelectLevels(Job& job)
+{
+    DecodedImage& image = job.Image;
+    if (image.Levels.empty())
+    {
+        image.Levels.push_back(MipLevel{ image.Width, image.Height, 0 });
+    }
+    job.SourceWidth = image.Width;
+    job.SourceHeight = image.Height;
+    job.SourceMipLevels = (uint32_t)image.Levels.size();
+
+    uint32_t first = 0;
+    if (job.MaxSize != 0)
+    {
+        while (first + 1 < image.Levels.size() &&
+            (std::max)(image.Levels[first].Width, image.Levels[first].Height) > job.MaxSize)
+        {
+            ++first;
+        }
+        while (first > 0 && !IsValidTopLevel(image.Format, image.Levels[first].Width, image.Levels[first].Height))
+        {
+            --first;
+        }
+    }
+    job.FirstMip = first;
+    if (first == 0)
+    {
+        return;
+    }
+
+    const size_t offset = image.Levels[first].Offset;
+    image.Pixels.erase(image.Pixels.begin(), image.Pixels.begin() + (ptrdiff_t)offset);
+    image.Levels.erase(image.Levels.begin(), image.Levels.begin() + first);
+    for (MipLevel& level : image.Levels)
+    {
+        level.Offset -= offset;
+    }
+    image.Width = image.Levels[0].Width;
+    image.Height = image.Levels[0].Height;
+}
+
+void TextureLoader::RunDecode(const std::shared_ptr<Job>& job)
+{
+    Decode(*job);
+
+    // 先入队再通知：被唤醒的 Update 一定能取到结果并开始下一个解码。
+    // 回调之后才减少在途计数，析构等待结束时不会有回调还在执行
+    {
+        std::lock_guard<std::mutex> lock(m_shared.Mutex);
+        m_shared.Decoded.push_back(job);
+        --m_shared.Decoding;
+    }
+    if (m_decodedCallback)
+    {
+        m_decodedCallback();
+    }
+
+    std::lock_guard<std::mutex> lock(m_shared.Mutex);
+    --m_shared.InFlight;
+    if (m_shared.InFlight == 0)
+    {
+        m_shared.IdleCv.notify_all();
+    }
+}
+
+void TextureLoader::WaitDecodes()
+{
+    std::unique_lock<std::mutex> lock(m_shared.Mutex);
+    m_shared.IdleCv.wait(lock, [this]() { return m_shared.InFlight == 0; });
+}
+
+// ============================================================================
+// 推进（渲染线程）
+// ============================================================================
+void TextureLoader::Update(ITextureUploader& uploader, std::vector<TextureLoadResult>& out)
+{
+    PROFILE_SCOPE("TextureLoaderUpdate");
+
+    m_lastUploads = 0;
+    m_lastUploadBytes = 0;
+
+    // 1. 拷贝已完成的纹理交出去；其间被取代或取消的直接释放
+    const uint64_t completed = uploader.GetFence().GetCompletedValue();
+    while (!m_uploading.empty() && m_uploading.front()->FenceValue <= completed)
+    {
+        std::shared_ptr<Job> job = std::move(m_uploading.front());
+        m_uploading.pop_front();
+        if (!IsCurrent(*job))
+        {
+            uploader.Release(job->Texture);
+            continue;
+        }
+
+        m_latest.erase(job->Key);
+        TextureLoadResult result;
+        result.Key = job->Key;
+        result.Texture = job->Texture;
+        result.Width = job->Image.Width;
+        result.Height = job->Image.Height;
+        result.MipLevels = (uint32_t)job->Image.Levels.size();
+        result.Format = job->Image.Format;
+        result.Bytes = job->UploadBytes;
+        result.ContentHash = job->Image.ContentHash;
+        result.FirstMip = job->FirstMip;
+        result.SourceWidth = job->SourceWidth;
+        result.SourceHeight = job->SourceHeight;
+        result.SourceMipLevels = job->SourceMipLevels;
+        result.Succeeded = true;
+        out.push_back(result);
+    }
+
+    // 2. 取回解码完成的任务；没有线程池时在这里同步解码一个
+    if (!m_pool)
+    {
+        while (!m_queued.empty())
+        {
+            std::shared_ptr<Job> job = std::move(m_queued.front());
+            m_queued.pop_front();
+            if (IsCurrent(*job))
+            {
+                Decode(*job);
+                m_readyToUpload.push_back(std::move(job));
+                break;
+            }
+        }
+    }
+    else
+    {
+        std::vector<std::shared_ptr<Job>> decoded;
+        {
+            std::lock_guard<std::mutex> lock(m_shared.Mutex);
+            decoded.swap(m_shared.Decoded);
+        }
+        for (auto& job : decoded)
+        {
+            m_readyToUpload.push_back(std::move(job));
+        }
+        StartDecodes();
+    }
+
+    // 3. 在预算内录制上传（至少一张，避免大图永远排不上），一次提交
+    std::vector<std::shared_ptr<Job>> batch;
+    while (!m_readyToUpload.empty())
+    {
+        std::shared_ptr<Job>& front = m_readyToUpload.front();
+        if (!IsCurrent(*front))
+        {
+            m_readyToUpload.pop_front();
+            continue;
+        }
+
+        if (!front->Decoded)
+        {
+            m_latest.erase(front->Key);
+            TextureLoadResult result;
+            result.Key = front->Key;
+            out.push_back(result);
+            m_readyToUpload.pop_front();
+            continue;
+        }
+
+        const uint64_t bytes = (uint64_t)front->Image.Pixels.size();
+        if (m_lastUploads > 0 && m_lastUploadBytes + bytes > m_uploadBudget)
+        {
+            break;
+        }
+
+        std::shared_ptr<Job> job = std::move(front);
+        m_readyToUpload.pop_front();
+        if (!uploader.Upload(job->Image, job->Texture))
+        {
+            m_latest.erase(job->Key);
+            TextureLoadResult result;
+            result.Key = job->Key;
+            result.Width = job->Image.Width;
+            result.Height = job->Image.Height;
+            out.push_back(result);
+            continue;
+        }
+
+        ++m_lastUploads;
+        m_lastUploadBytes += bytes;
+        job->UploadBytes = bytes;
+        batch.push_back(std::move(job));
+    }
+
+    if (batch.empty())
+    {
+        return;
+    }
+
+    const uint64_t fenceValue = uploader.Flush();
+    for (auto& job : batch)
+    {
+        // 像素已经拷进上传缓冲，不必再留着
+        job->Image.Pixels.clear();
+        job->Image.Pixels.shrink_to_fit();
+        job->FenceValue = fenceValue;
+        m_uploading.push_back(std::move(job));
+    }
+}
+
+void TextureLoader::Shutdown(ITextureUploader* uploader)
+{
+    m_latest.clear();
+    m_queued.clear();
+    WaitDecodes();
+    {
+        std::lock_guard<std::mutex> lock(m_shared.Mutex);
+        m_shared.Decoded.clear();
+    }
+    m_readyToUpload.clear();
+
+    if (uploader && !m_uploading.empty())
+    {
+        uploader->GetFence().WaitForValue(m_uploading.back()->FenceValue);
+        for (const auto& job : m_uploading)
+        {
+            uploader->Release(job->Texture);
+        }
+    }
+    m_uploading.clear();
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "FrameSync.h"
+#include "MipGenerator.h"
+#include "TextureCompressor.h"
+
+class ThreadPool;
+class BlobCache;
+
+// 解码结果：行紧密排列（块压缩时一行为一行块）。解码器只填 RGBA8 的第 0 级；
+// 加载器在其后追加 mip 链、按设置压缩，Levels 记录每一级的位置（为空时视为只有第 0 级）
+struct DecodedImage
+{
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    TextureFormat Format = TextureFormat::RGBA8;
+    std::vector<uint8_t> Pixels;
+    std::vector<MipLevel> Levels;
+    uint64_t ContentHash = 0;     // 源文件内容的哈希（解码器不提供时为 0）
+};
+
+// 读入整个文件
+bool ReadFileBytes(const std::wstring& path, std::vector<uint8_t>& out);
+
+// 图片解码器：可能在多个工作线程上并发调用
+class ITextureDecoder
+{
+public:
+    virtual ~ITextureDecoder() = default;
+    // 从内存中的文件内容解码为 RGBA8
+    virtual bool Decode(const uint8_t* data, size_t size, DecodedImage& out) = 0;
+    // 读文件并解码，ContentHash 为文件内容哈希
+    bool DecodeFile(const std::wstring& path, DecodedImage& out);
+};
+
+// 纹理上传（渲染线程）：把解码结果录制到独立的拷贝队列上，一批 Upload 之后 Flush 提交并发出栅栏。
+// 纹理句柄由实现解释（D3D12 为持有一个引用的 ID3D12Resource*）
+class ITextureUploader
+{
+public:
+    virtual ~ITextureUploader() = default;
+
+    // 创建纹理并把拷贝录制到当前批次，失败时不改动 texture
+    virtual bool Upload(const DecodedImage& image, uint64_t& texture) = 0;
+    // 提交当前批次并发出拷贝队列的栅栏，返回栅栏值（批次为空时返回上一次的值）
+    virtual uint64_t Flush() = 0;
+    // 拷贝队列的栅栏：栅栏值完成后对应批次的纹理可以被图形队列采样
+    virtual IFence& GetFence() = 0;
+    // 释放一张拷贝已完成、但不再需要的纹理
+    virtual void Release(uint64_t texture) = 0;
+};
+
+// 一张已驻留（拷贝完成）或加载失败的纹理
+struct TextureLoadResult
+{
+    uint64_t Key = 0;
+    uint64_t Texture = 0;         // 失败时为 0
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint32_t MipLevels = 0;
+    TextureFormat Format = TextureFormat::RGBA8;
+    uint64_t Bytes = 0;           // 全部 mip 级的数据字节数（压缩后）
+    uint64_t ContentHash = 0;
+    // 按 maxSize 只上传了较粗的级时，纹理的第 0 级是源图的第 FirstMip 级；Source* 为源图完整的 mip 链
+    uint32_t FirstMip = 0;
+    uint32_t SourceWidth = 0;
+    uint32_t SourceHeight = 0;
+    uint32_t SourceMipLevels = 0;
+    bool Succeeded = false;
+};
+
+// 异步纹理加载：解码在线程池上，上传走拷贝队列，渲染线程每帧调用 Update 推进并取回已驻留的纹理。
+//   请求 -> 排队 -> 读文件、解码、生成 mip 链、块压缩（工作线程，同时最多 MaxConcurrentDecodes 个）
+//   -> 上传（渲染线程录制，每次 Update 最多上传 UploadBudget 字节）-> 拷贝栅栏完成 -> 交给调用者
+// 设置了磁盘缓存时，压缩后的 mip 链按文件内容哈希与处理设置存盘，之后加载同样的内容直接读缓存，
+// 跳过解码、mip 生成和压缩。
+// 流式加载只上传长边不超过 maxSize 的各级；磁盘缓存里存的总是完整的链，换级时只需读缓存再截取。
+// 同一个键的新请求会取代旧请求：旧任务在下一个阶段被丢弃，已上传的纹理等拷贝完成后释放。
+// 除解码外的所有函数只能在渲染线程调用
+class TextureLoader
+{
+public:
+    // pool 为空时在 Update 中同步解码（不依赖工作线程）
+    TextureLoader(ITextureDecoder& decoder, ThreadPool* pool);
+    // 等待在途的解码结束（解码任务引用了 decoder）
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    // maxSize 不为 0 时跳过长边超过它的级（块压缩格式的第 0 级宽高须为 4 的倍数，不满足时多留一级）
+    void Request(uint64_t key, const std::wstring& path, uint32_t maxSize = 0);
+    // 丢弃该键尚未完成的请求
+    void Cancel(uint64_t key);
+
+    // 推进流水线：已完成拷贝的纹理与解码失败的请求追加到 out
+    void Update(ITextureUploader& uploader, std::vector<TextureLoadResult>& out);
+    // 丢弃全部请求，等解码结束、拷贝队列空闲后释放已上传的纹理（关闭时调用）
+    void Shutdown(ITextureUploader* uploader);
+
+    bool IsPending(uint64_t key) const { return m_latest.find(key) != m_latest.end(); }
+    size_t GetPendingCount() const { return m_latest.size(); }
+    // 还有不需要等解码就能推进的工作（待上传、拷贝在途）：调用者应继续调用 Update
+    bool NeedsUpdate() const
+    {
+        return !m_uploading.empty() || !m_readyToUpload.empty() || (!m_pool && !m_queued.empty());
+    }
+
+    // 解码完成时在工作线程上调用（用于唤醒按需渲染的渲染线程）
+    void SetDecodedCallback(std::function<void()> callback) { m_decodedCallback = std::move(callback); }
+
+    void SetMaxConcurrentDecodes(uint32_t count) { m_maxConcurrentDecodes = count ? count : 1; }
+    void SetUploadBudget(uint64_t bytes) { m_uploadBudget = bytes; }
+    // 之后的请求按此生成 mip 链（MaxLevels = 1 时只上传原图）与压缩
+    void SetMipSettings(const MipSettings& settings) { m_mipSettings = settings; }
+    void SetCompression(const CompressionSettings& settings) { m_compression = settings; }
+    // 处理结果的磁盘缓存（不持有，须比加载器活得久）；在第一次 Request 之前设置
+    void SetEncodedCache(BlobCache* cache) { m_encodedCache = cache; }
+
+    // 上一次 Update 的上传数与字节数
+    uint32_t GetLastUploadCount() const { return m_lastUploads; }
+    uint64_t GetLastUploadBytes() const { return m_lastUploadBytes; }
+
+    static const uint32_t DefaultMaxConcurrentDecodes = 2;
+    static const uint64_t DefaultUploadBudget = 32ull * 1024 * 1024;
+
+private:
+    struct Job
+    {
+        uint64_t Key = 0;
+        std::wstring Path;
+        uint64_t Generation = 0;
+        MipSettings Mips;
+        CompressionSettings Compression;
+        uint32_t MaxSize = 0;
+        DecodedImage Image;
+        uint32_t FirstMip = 0;
+        uint32_t SourceWidth = 0;
+        uint32_t SourceHeight = 0;
+        uint32_t SourceMipLevels = 0;
+        bool Decoded = false;
+        uint64_t Texture = 0;
+        uint64_t UploadBytes = 0;
+        uint64_t FenceValue = 0;
+    };
+
+    // 工作线程与渲染线程共享的部分：解码完成的任务与在途计数
+    struct Shared
+    {
+        std::mutex Mutex;
+        std::condition_variable IdleCv;
+        std::vector<std::shared_ptr<Job>> Decoded;
+        uint32_t Decoding = 0;    // 正在解码（限制并发）
+        uint32_t InFlight = 0;    // 已提交、任务函数尚未返回（析构等待）
+    };
+
+    bool IsCurrent(const Job& job) const;
+    void StartDecodes();
+    void RunDecode(const std::shared_ptr<Job>& job);
+    // 读缓存或解码、生成 mip 链并压缩（工作线程，或没有线程池时在渲染线程）
+    void Decode(Job& job);
+    // 按 MaxSize 去掉更精细的级
+    static void SelectLevels(Job& job);
+    void WaitDecodes();
+
+private:
+    ITextureDecoder& m_decoder;
+    ThreadPool* m_pool;
+    std::function<void()> m_decodedCallback;
+    uint32_t m_maxConcurrentDecodes = DefaultMaxConcurrentDecodes;
+    uint64_t m_uploadBudget = DefaultUploadBudget;
+    MipSettings m_mipSettings;
+    CompressionSettings m_compression;
+    BlobCache* m_encodedCache = nullptr;
+
+    uint64_t m_nextGeneration = 1;
+    std::unordered_map<uint64_t, uint64_t> m_latest;       // 每个键最新请求的代号
+    std::deque<std::shared_ptr<Job>> m_queued;             // 等待解码
+    std::deque<std::shared_ptr<Job>> m_readyToUpload;      // 已解码，超出上传预算留到下一次
+    std::deque<std::shared_ptr<Job>> m_uploading;          // 已提交拷贝，按栅栏值递增
+    Shared m_shared;
+
+    uint32_t m_lastUploads = 0;
+    uint64_t m_lastUploadBytes = 0;
+};
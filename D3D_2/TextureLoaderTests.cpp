@@ -0,0 +1,374 @@
+#include "SelfTest.h"
+#include "TextureLoader.h"
+#include "ThreadPool.h"
+#include "UploadAllocator.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <thread>
+
+// ============================================================================
+// TextureLoader：替身解码器 + 模拟拷贝栅栏下的任务交接
+// ============================================================================
+namespace
+{
+    // 替身“图片文件”：宽、高、填充值三个字节；更短的文件解码失败
+    class StandInDecoder : public ITextureDecoder
+    {
+    public:
+        bool Decode(const uint8_t* data, size_t size, DecodedImage& out) override
+        {
+            ++m_decodes;
+            if (m_delayMs > 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(m_delayMs));
+            }
+            if (size < 3 || data[0] == 0 || data[1] == 0)
+            {
+                return false;
+            }
+            out.Width = data[0];
+            out.Height = data[1];
+            out.Format = TextureFormat::RGBA8;
+            out.Pixels.assign((size_t)out.Width * out.Height * 4, data[2]);
+            return true;
+        }
+
+        void SetDelay(int ms) { m_delayMs = ms; }
+        uint32_t GetDecodes() const { return m_decodes; }
+
+    private:
+        std::atomic<uint32_t> m_decodes{ 0 };
+        int m_delayMs = 0;
+    };
+
+    class HeapPageSource : public IUploadPageSource
+    {
+    public:
+        bool CreatePage(uint64_t size, UploadPage& out) override
+        {
+            out.CpuBase = new uint8_t[(size_t)size];
+            out.GpuBase = (uint64_t)(uintptr_t)out.CpuBase;
+            out.Size = size;
+            out.Handle = out.CpuBase;
+            ++m_live;
+            ++m_created;
+            return true;
+        }
+
+        void DestroyPage(const UploadPage& page) override
+        {
+            delete[] static_cast<uint8_t*>(page.Handle);
+            --m_live;
+        }
+
+        int GetLive() const { return m_live; }
+        int GetCreated() const { return m_created; }
+
+    private:
+        int m_live = 0;
+        int m_created = 0;
+    };
+
+    // 与 D3D12TextureUploader 同样的结构：一个批次的数据从分页分配器拷进上传页，
+    // Flush 发出拷贝栅栏并把用过的页挂上去；栅栏只在测试调用 Complete 时前进
+    class SimulatedUploader : public ITextureUploader
+    {
+    public:
+        SimulatedUploader() : m_staging(m_pages, 64 * 1024) {}
+
+        bool Upload(const DecodedImage& image, uint64_t& texture) override
+        {
+            if (m_failNext)
+            {
+                m_failNext = false;
+                return false;
+            }
+            if (!m_recording)
+            {
+                m_staging.BeginFrame(m_fence.GetCompletedValue());
+                m_recording = true;
+            }
+            UploadAllocation staging;
+            if (!m_staging.Allocate(image.Pixels.size(), 512, staging))
+            {
+                return false;
+            }
+            memcpy(staging.Cpu, image.Pixels.data(), image.Pixels.size());
+            texture = m_nextTexture++;
+            m_live.insert(texture);
+            return true;
+        }
+
+        uint64_t Flush() override
+        {
+            if (!m_recording)
+            {
+                return m_fence.GetLastSignaledValue();
+            }
+            m_recording = false;
+            const uint64_t value = m_fence.Signal();
+            m_staging.EndFrame(value);
+            ++m_batches;
+            return value;
+        }
+
+        IFence& GetFence() override { return m_fence; }
+
+        void Release(uint64_t texture) override
+        {
+            m_badReleases += m_live.erase(texture) == 1 ? 0 : 1;
+            ++m_releases;
+        }
+
+        // 调用者用完交出的纹理
+        bool Discard(uint64_t texture) { return m_live.erase(texture) == 1; }
+
+        SimulatedFence& Fence() { return m_fence; }
+        const HeapPageSource& Pages() const { return m_pages; }
+        void FailNext() { m_failNext = true; }
+        size_t GetLiveCount() const { return m_live.size(); }
+        int GetReleases() const { return m_releases; }
+        int GetBadReleases() const { return m_badReleases; }
+        int GetBatches() const { return m_batches; }
+
+    private:
+        SimulatedFence m_fence;
+        HeapPageSource m_pages;
+        LinearUploadAllocator m_staging;
+        bool m_recording = false;
+        bool m_failNext = false;
+        uint64_t m_nextTexture = 100;
+        std::set<uint64_t> m_live;
+        int m_releases = 0;
+        int m_badReleases = 0;
+        int m_batches = 0;
+    };
+
+    std::wstring WriteImage(const std::filesystem::path& dir, const char* name, uint8_t width, uint8_t height, uint8_t fill)
+    {
+        const std::filesystem::path path = dir / name;
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        const uint8_t bytes[] = { width, height, fill };
+        file.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+        return path.wstring();
+    }
+
+    const TextureLoadResult* FindResult(const std::vector<TextureLoadResult>& results, uint64_t key)
+    {
+        for (const TextureLoadResult& result : results)
+        {
+            if (result.Key == key)
+            {
+                return &result;
+            }
+        }
+        return nullptr;
+    }
+
+    void ConfigureLoader(TextureLoader& loader)
+    {
+        MipSettings mips;
+        mips.Filter = MipFilter::Box;
+        loader.SetMipSettings(mips);
+        CompressionSettings compression;
+        compression.Mode = CompressionMode::None;
+        loader.SetCompression(compression);
+    }
+}
+
+void TestTextureLoader(SelfTestContext& ctx)
+{
+    std::error_code error;
+    const std::filesystem::path dir = std::filesystem::temp_directory_path(error) / "D3D_2-TextureLoaderTest";
+    std::filesystem::create_directories(dir, error);
+    const std::wstring small = WriteImage(dir, "small.img", 4, 4, 10);
+    const std::wstring wide = WriteImage(dir, "wide.img", 32, 8, 20);
+    const std::wstring big = WriteImage(dir, "big.img", 64, 64, 30);
+    const std::wstring broken = WriteImage(dir, "broken.img", 0, 4, 0);
+    const std::wstring missing = (dir / "missing.img").wstring();
+
+    // 没有线程池：每次 Update 同步解码一个，交接顺序完全确定。
+    // 拷贝栅栏未完成时纹理不交出；解码失败立即回报
+    {
+        StandInDecoder decoder;
+        SimulatedUploader uploader;
+        TextureLoader loader(decoder, nullptr);
+        ConfigureLoader(loader);
+        std::vector<TextureLoadResult> results;
+
+        loader.Request(1, small);
+        loader.Request(2, broken);
+        loader.Request(3, wide);
+        loader.Request(4, missing);
+        SELF_CHECK(ctx, loader.GetPendingCount() == 4 && loader.NeedsUpdate());
+        for (int i = 0; i < 6; ++i)
+        {
+            loader.Update(uploader, results);
+        }
+        SELF_CHECK(ctx, decoder.GetDecodes() == 3);
+        SELF_CHECK(ctx, results.size() == 2);
+        SELF_CHECK(ctx, FindResult(results, 2) && !FindResult(results, 2)->Succeeded && !FindResult(results, 2)->Texture);
+        SELF_CHECK(ctx, FindResult(results, 4) && !FindResult(results, 4)->Succeeded);
+        SELF_CHECK(ctx, loader.IsPending(1) && loader.IsPending(3) && loader.NeedsUpdate());
+        SELF_CHECK(ctx, uploader.GetLiveCount() == 2 && uploader.GetBatches() == 2);
+
+        uploader.Fence().Complete(1);
+        results.clear();
+        loader.Update(uploader, results);
+        SELF_CHECK(ctx, results.size() == 1 && results[0].Key == 1 && results[0].Succeeded);
+        SELF_CHECK(ctx, results[0].Width == 4 && results[0].Height == 4 && results[0].MipLevels == 3);
+        SELF_CHECK(ctx, results[0].Bytes == (16 + 4 + 1) * 4 && results[0].ContentHash != 0);
+
+        uploader.Fence().Complete(2);
+        results.clear();
+        loader.Update(uploader, results);
+        SELF_CHECK(ctx, results.size() == 1 && results[0].Key == 3 && results[0].Succeeded);
+        SELF_CHECK(ctx, results[0].Width == 32 && results[0].Height == 8 && results[0].MipLevels == 6);
+        SELF_CHECK(ctx, loader.GetPendingCount() == 0 && !loader.NeedsUpdate());
+        SELF_CHECK(ctx, uploader.Discard(100) && uploader.Discard(101) && uploader.GetBadReleases() == 0);
+    }
+
+    // 上传页挂在拷贝栅栏上：栅栏不前进时每个批次都要新页，完成后复用旧页而不再新建
+    {
+        StandInDecoder decoder;
+        SimulatedUploader uploader;
+        TextureLoader loader(decoder, nullptr);
+        ConfigureLoader(loader);
+        std::vector<TextureLoadResult> results;
+
+        for (uint64_t key = 1; key <= 3; ++key)
+        {
+            loader.Request(key, big);
+            loader.Update(uploader, results);
+        }
+        SELF_CHECK(ctx, uploader.GetBatches() == 3 && uploader.Pages().GetCreated() == 3);
+
+        uploader.Fence().Complete(3);
+        for (uint64_t key = 4; key <= 6; ++key)
+        {
+            loader.Request(key, big);
+            loader.Update(uploader, results);
+        }
+        SELF_CHECK(ctx, uploader.GetBatches() == 6 && uploader.Pages().GetCreated() == 3);
+        SELF_CHECK(ctx, results.size() == 3);
+
+        // 之后的批次照常推进，栅栏完成后一并交出
+        for (uint64_t key = 7; key <= 11; ++key)
+        {
+            loader.Request(key, small);
+        }
+        for (int i = 0; i < 5; ++i)
+        {
+            loader.Update(uploader, results);
+        }
+        SELF_CHECK(ctx, uploader.GetBatches() == 11);
+        uploader.Fence().Complete(uploader.Fence().GetLastSignaledValue());
+        loader.Update(uploader, results);
+        SELF_CHECK(ctx, results.size() == 11 && loader.GetPendingCount() == 0);
+        for (const TextureLoadResult& result : results)
+        {
+            uploader.Discard(result.Texture);
+        }
+        SELF_CHECK(ctx, uploader.GetLiveCount() == 0);
+    }
+
+    // 取代与取消：拷贝在途时同一个键的新请求取代旧请求，旧纹理在栅栏完成后释放而不交出；
+    // 取消的请求同样只释放；上传失败回报失败
+    {
+        StandInDecoder decoder;
+        SimulatedUploader uploader;
+        TextureLoader loader(decoder, nullptr);
+        ConfigureLoader(loader);
+        std::vector<TextureLoadResult> results;
+
+        loader.Request(1, small);
+        loader.Update(uploader, results);
+        loader.Request(1, wide);
+        loader.Request(2, small);
+        loader.Update(uploader, results);
+        loader.Update(uploader, results);
+        loader.Cancel(2);
+        SELF_CHECK(ctx, uploader.GetLiveCount() == 3 && loader.IsPending(1) && !loader.IsPending(2));
+
+        uploader.Fence().Complete(uploader.Fence().GetLastSignaledValue());
+        loader.Update(uploader, results);
+        SELF_CHECK(ctx, results.size() == 1 && results[0].Key == 1 && results[0].Width == 32);
+        SELF_CHECK(ctx, uploader.GetReleases() == 2 && uploader.GetBadReleases() == 0);
+        SELF_CHECK(ctx, uploader.Discard(results[0].Texture) && uploader.GetLiveCount() == 0);
+
+        results.clear();
+        uploader.FailNext();
+        loader.Request(3, wide);
+        loader.Update(uploader, results);
+        SELF_CHECK(ctx, results.size() == 1 && !results[0].Succeeded && results[0].Width == 32);
+        SELF_CHECK(ctx, !loader.IsPending(3) && uploader.GetLiveCount() == 0);
+    }
+
+    // 线程池：解码在工作线程上并发，渲染线程轮询取回；每个键恰好交出一次，
+    // Shutdown 等解码结束、等拷贝栅栏后释放在途的纹理
+    {
+        StandInDecoder decoder;
+        decoder.SetDelay(2);
+        SimulatedUploader uploader;
+        ThreadPool pool(3);
+        std::atomic<uint32_t> callbacks{ 0 };
+        std::vector<TextureLoadResult> results;
+        {
+            TextureLoader loader(decoder, &pool);
+            ConfigureLoader(loader);
+            loader.SetMaxConcurrentDecodes(2);
+            loader.SetDecodedCallback([&callbacks]() { ++callbacks; });
+
+            const uint64_t keyCount = 12;
+            for (uint64_t key = 1; key <= keyCount; ++key)
+            {
+                loader.Request(key, key % 4 == 0 ? broken : (key % 2 ? small : wide));
+            }
+            for (int i = 0; i < 2000 && loader.GetPendingCount() > 0; ++i)
+            {
+                loader.Update(uploader, results);
+                uploader.Fence().Complete(uploader.Fence().GetLastSignaledValue());
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            SELF_CHECK(ctx, results.size() == keyCount && decoder.GetDecodes() == keyCount);
+            bool each = true;
+            for (uint64_t key = 1; key <= keyCount; ++key)
+            {
+                const TextureLoadResult* result = FindResult(results, key);
+                each &= result && result->Succeeded == (key % 4 != 0);
+            }
+            SELF_CHECK(ctx, each);
+            for (const TextureLoadResult& result : results)
+            {
+                if (result.Succeeded)
+                {
+                    uploader.Discard(result.Texture);
+                }
+            }
+
+            // 拷贝在途与解码在途时关闭
+            loader.Request(100, small);
+            loader.Request(101, wide);
+            for (int i = 0; i < 200 && uploader.GetLiveCount() == 0; ++i)
+            {
+                loader.Update(uploader, results);
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            loader.Request(102, small);
+            const uint64_t waits = uploader.Fence().GetWaitCount();
+            loader.Shutdown(&uploader);
+            SELF_CHECK(ctx, uploader.Fence().GetWaitCount() > waits);
+            SELF_CHECK(ctx, loader.GetPendingCount() == 0 && !loader.NeedsUpdate());
+        }
+        // 加载器析构时已等解码结束：每次解码都回调过一次
+        SELF_CHECK(ctx, callbacks == decoder.GetDecodes());
+        SELF_CHECK(ctx, uploader.GetLiveCount() == 0 && uploader.GetBadReleases() == 0);
+    }
+
+    std::filesystem::remove_all(dir, error);
+}
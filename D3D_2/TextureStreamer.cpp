@@ -0,0 +1,309 @@
+#include "TextureStreamer.h"
+#include <algorithm>
+
+// ============================================================================
+// 登记
+// ============================================================================
+void TextureStreamer::Register(TextureCacheId id, TextureFormat format, uint32_t width, uint32_t height,
+    uint32_t mipLevels, uint32_t residentMip)
+{
+    Unregister(id);
+
+    const uint32_t levels = mipLevels ? mipLevels : 1;
+    Entry& entry = m_entries[id];
+    entry.Id = id;
+    entry.Width = width;
+    entry.Height = height;
+    entry.Bytes.assign(levels + 1, 0);
+    entry.ValidTop.assign(levels, false);
+
+    // 从最粗的一级往前累加
+    for (uint32_t i = levels; i-- > 0;)
+    {
+        const uint32_t w = (std::max)(1u, width >> i);
+        const uint32_t h = (std::max)(1u, height >> i);
+        entry.Bytes[i] = entry.Bytes[i + 1] + (uint64_t)GetRowPitch(format, w) * GetRowCount(format, h);
+        entry.ValidTop[i] = i == 0 || IsValidTopLevel(format, w, h);
+    }
+    entry.Bytes.pop_back();
+
+    uint32_t minMip = 0;
+    while (minMip + 1 < levels && (std::max)((std::max)(1u, width >> minMip), (std::max)(1u, height >> minMip)) > m_minResidentSize)
+    {
+        ++minMip;
+    }
+    entry.MinMip = ClampToValid(entry, minMip);
+    entry.ResidentMip = ClampToValid(entry, (std::min)(residentMip, levels - 1));
+    entry.TargetMip = entry.ResidentMip;
+}
+
+void TextureStreamer::Unregister(TextureCacheId id)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end())
+    {
+        return;
+    }
+    if (it->second.PendingMip != NoMip)
+    {
+        --m_pendingLoads;
+    }
+    m_entries.erase(it);
+}
+
+void TextureStreamer::ReportUsage(TextureCacheId id, float screenSize)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    Entry& entry = it->second;
+    if (entry.LastUsedFrame != m_frame)
+    {
+        entry.LastUsedFrame = m_frame;
+        entry.ScreenSize = screenSize;
+    }
+    else
+    {
+        entry.ScreenSize = (std::max)(entry.ScreenSize, screenSize);
+    }
+}
+
+uint32_t TextureStreamer::ComputeWantedMip(uint32_t width, uint32_t height, uint32_t mipLevels, float screenSize)
+{
+    const uint32_t maxDim = (std::max)(width, height);
+    uint32_t mip = 0;
+    while (mip + 1 < mipLevels && (float)(std::max)(1u, maxDim >> (mip + 1)) >= screenSize)
+    {
+        ++mip;
+    }
+    return mip;
+}
+
+// ============================================================================
+// 分配与请求
+// ============================================================================
+uint32_t TextureStreamer::ClampToValid(const Entry& entry, uint32_t mip)
+{
+    while (mip > 0 && !entry.ValidTop[mip])
+    {
+        --mip;
+    }
+    return mip;
+}
+
+uint32_t TextureStreamer::FitMip(const Entry& entry, uint32_t finest, uint32_t coarsest, uint64_t& remaining)
+{
+    for (uint32_t mip = finest; mip < coarsest; ++mip)
+    {
+        const uint64_t extra = entry.Bytes[mip] - entry.Bytes[coarsest];
+        if (entry.ValidTop[mip] && extra <= remaining)
+        {
+            remaining -= extra;
+            return mip;
+        }
+    }
+    return coarsest;
+}
+
+bool TextureStreamer::HasPriority(const Entry& a, const Entry& b) const
+{
+    const bool visibleA = a.LastUsedFrame == m_frame;
+    const bool visibleB = b.LastUsedFrame == m_frame;
+    if (visibleA != visibleB)
+    {
+        return visibleA;
+    }
+    if (a.LastUsedFrame != b.LastUsedFrame)
+    {
+        return a.LastUsedFrame > b.LastUsedFrame;
+    }
+    if (a.ScreenSize != b.ScreenSize)
+    {
+        return a.ScreenSize > b.ScreenSize;
+    }
+    return a.Id < b.Id;
+}
+
+void TextureStreamer::Update(std::vector<TextureStreamRequest>& requests)
+{
+    m_order.clear();
+    for (auto& pair : m_entries)
+    {
+        m_order.push_back(&pair.second);
+    }
+    std::sort(m_order.begin(), m_order.end(), [this](const Entry* a, const Entry* b)
+    {
+        return HasPriority(*a, *b);
+    });
+
+    // 1. 最低驻留（加载失败的纹理固定在当前级）
+    uint64_t baseBytes = 0;
+    for (Entry* entry : m_order)
+    {
+        entry->TargetMip = entry->Failed ? entry->ResidentMip : entry->MinMip;
+        baseBytes += entry->Bytes[entry->TargetMip];
+    }
+    uint64_t remaining = m_budget > baseBytes ? m_budget - baseBytes : 0;
+
+    // 2. 本帧可见的纹理按优先级分到需要的级
+    m_lastVisible = 0;
+    for (Entry* entry : m_order)
+    {
+        if (entry->LastUsedFrame != m_frame)
+        {
+            break;
+        }
+        ++m_lastVisible;
+        if (entry->Failed)
+        {
+            continue;
+        }
+        const uint32_t wanted = ClampToValid(*entry, (std::min)(entry->MinMip,
+            ComputeWantedMip(entry->Width, entry->Height, (uint32_t)entry->ValidTop.size(), entry->ScreenSize)));
+        entry->TargetMip = FitMip(*entry, wanted, entry->TargetMip, remaining);
+    }
+
+    // 3. 剩余预算按最近使用顺序留住已驻留（或正在加载）的更精细级
+    m_lastTargetBytes = 0;
+    for (Entry* entry : m_order)
+    {
+        const uint32_t keep = (std::min)(entry->ResidentMip, entry->PendingMip);
+        if (!entry->Failed && keep < entry->TargetMip)
+        {
+            entry->TargetMip = FitMip(*entry, keep, entry->TargetMip, remaining);
+        }
+        m_lastTargetBytes += entry->Bytes[entry->TargetMip];
+    }
+
+    // 4. 请求：先淘汰（最久未用的在前）腾出预算，再按优先级加载
+    auto request = [this, &requests](Entry& entry)
+    {
+        const uint32_t mip = entry.TargetMip;
+        if (entry.PendingMip == mip)
+        {
+            return;
+        }
+        if (mip == entry.ResidentMip)
+        {
+            // 在途的请求会换上不需要（或放不下）的级
+            if (entry.PendingMip != NoMip)
+            {
+                entry.PendingMip = NoMip;
+                --m_pendingLoads;
+                TextureStreamRequest cancel;
+                cancel.Id = entry.Id;
+                cancel.Mip = mip;
+                cancel.Cancel = true;
+                requests.push_back(cancel);
+            }
+            return;
+        }
+        // 在途请求的方向一致且不超出分配时等它完成，避免反复取代导致永远完成不了
+        if (entry.PendingMip != NoMip)
+        {
+            const bool sameDirection = (entry.PendingMip < entry.ResidentMip) == (mip < entry.ResidentMip);
+            if (sameDirection && entry.PendingMip > mip)
+            {
+                return;
+            }
+        }
+        else if (m_pendingLoads >= m_maxPendingLoads)
+        {
+            return;
+        }
+        else
+        {
+            ++m_pendingLoads;
+        }
+
+        entry.PendingMip = mip;
+        if (mip < entry.ResidentMip)
+        {
+            ++m_loads;
+        }
+        else
+        {
+            ++m_evictions;
+        }
+        const uint32_t maxDim = (std::max)(entry.Width, entry.Height);
+        requests.push_back(TextureStreamRequest{ entry.Id, mip, (std::max)(1u, maxDim >> mip), false });
+    };
+
+    for (auto it = m_order.rbegin(); it != m_order.rend(); ++it)
+    {
+        if ((*it)->TargetMip >= (*it)->ResidentMip)
+        {
+            request(**it);
+        }
+    }
+    for (Entry* entry : m_order)
+    {
+        if (entry->TargetMip < entry->ResidentMip)
+        {
+            request(*entry);
+        }
+    }
+}
+
+// ============================================================================
+// 加载回报
+// ============================================================================
+void TextureStreamer::OnLoaded(TextureCacheId id, uint32_t mip)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    Entry& entry = it->second;
+    if (entry.PendingMip != NoMip)
+    {
+        entry.PendingMip = NoMip;
+        --m_pendingLoads;
+    }
+    entry.ResidentMip = ClampToValid(entry, (std::min)(mip, (uint32_t)entry.ValidTop.size() - 1));
+}
+
+void TextureStreamer::OnLoadFailed(TextureCacheId id)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    Entry& entry = it->second;
+    if (entry.PendingMip != NoMip)
+    {
+        entry.PendingMip = NoMip;
+        --m_pendingLoads;
+    }
+    entry.Failed = true;
+}
+
+uint32_t TextureStreamer::GetResidentMip(TextureCacheId id) const
+{
+    auto it = m_entries.find(id);
+    return it != m_entries.end() ? it->second.ResidentMip : 0;
+}
+
+TextureStreamStats TextureStreamer::GetStats() const
+{
+    TextureStreamStats stats;
+    stats.Textures = (uint32_t)m_entries.size();
+    stats.Visible = m_lastVisible;
+    stats.PendingLoads = m_pendingLoads;
+    for (const auto& pair : m_entries)
+    {
+        stats.ResidentBytes += pair.second.Bytes[pair.second.ResidentMip];
+    }
+    stats.TargetBytes = m_lastTargetBytes;
+    stats.Budget = m_budget;
+    stats.Loads = m_loads;
+    stats.Evictions = m_evictions;
+    return stats;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "TextureCache.h"
+#include "TextureCompressor.h"
+
+// 让一张纹理换成以 Mip 级为第 0 级的版本：比当前驻留的更精细是加载，更粗是淘汰高 mip。
+// Cancel 为 true 时当前驻留的级正合适，调用者应取消这张纹理在途的加载
+struct TextureStreamRequest
+{
+    TextureCacheId Id = InvalidTextureCacheId;
+    uint32_t Mip = 0;
+    uint32_t MaxSize = 0;         // 该级的长边，即 TextureLoader::Request 的 maxSize
+    bool Cancel = false;
+};
+
+struct TextureStreamStats
+{
+    uint32_t Textures = 0;
+    uint32_t Visible = 0;         // 最近一次 Update 时本帧报告过使用的纹理
+    uint32_t PendingLoads = 0;
+    uint64_t ResidentBytes = 0;
+    uint64_t TargetBytes = 0;     // 最近一次 Update 分配的驻留量
+    uint64_t Budget = 0;
+    uint64_t Loads = 0;           // 累计发出的加载（更精细）
+    uint64_t Evictions = 0;       // 累计发出的淘汰（更粗）
+};
+
+// 纹理流式驻留：纹理先以长边不超过 MinResidentSize 的一级驻留，之后按屏幕上的投影尺寸只加载需要的 mip。
+// 驻留总量受预算限制：
+//   1. 每张纹理的最低驻留总是保留（预算再小也不会比它更粗）
+//   2. 本帧可见的纹理按优先级（投影尺寸大的在前）分到需要的级，放不下时逐级退到更粗
+//   3. 剩余预算按最近使用顺序留住已驻留的更精细级；留不住的（最久未用的先轮到）淘汰高 mip
+// 纯 CPU 逻辑，不碰 GPU 资源：调用者按 Update 给出的请求重新加载并在完成后回报 OnLoaded。
+// 结果只取决于调用序列（排序以 id 兜底），同样的输入总得到同样的请求。只在渲染线程使用
+class TextureStreamer
+{
+public:
+    TextureStreamer() = default;
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // 纹理第一次驻留后登记：width/height/mipLevels 为源图完整 mip 链，residentMip 为已驻留的第 0 级
+    void Register(TextureCacheId id, TextureFormat format, uint32_t width, uint32_t height,
+        uint32_t mipLevels, uint32_t residentMip);
+    void Unregister(TextureCacheId id);
+    bool IsRegistered(TextureCacheId id) const { return m_entries.find(id) != m_entries.end(); }
+
+    // 每帧开始时调用，之后 ReportUsage 记为这一帧的使用
+    void BeginFrame(uint64_t frame) { m_frame = frame; }
+    // 可见对象使用了纹理，screenSize 为它在屏幕上的投影尺寸（像素）；同一纹理多次报告取最大
+    void ReportUsage(TextureCacheId id, float screenSize);
+
+    // 重新分配预算，把需要换级的纹理按优先级追加到 requests（淘汰在前，总数受在途上限约束）。
+    // 已有同级请求在途的纹理不重复请求；在途请求不再需要时追加取消
+    void Update(std::vector<TextureStreamRequest>& requests);
+
+    // 加载完成：mip 为新纹理的第 0 级在源图中的级号
+    void OnLoaded(TextureCacheId id, uint32_t mip);
+    // 加载失败：保留当前纹理，之后不再为它发请求
+    void OnLoadFailed(TextureCacheId id);
+
+    // 当前驻留的第 0 级（未登记时为 0）
+    uint32_t GetResidentMip(TextureCacheId id) const;
+
+    void SetBudget(uint64_t bytes) { m_budget = bytes; }
+    uint64_t GetBudget() const { return m_budget; }
+    void SetMinResidentSize(uint32_t size) { m_minResidentSize = size ? size : 1; }
+    uint32_t GetMinResidentSize() const { return m_minResidentSize; }
+    void SetMaxPendingLoads(uint32_t count) { m_maxPendingLoads = count ? count : 1; }
+
+    TextureStreamStats GetStats() const;
+
+    // 投影尺寸为 screenSize 时需要的级：长边仍不小于 screenSize 的最粗一级
+    static uint32_t ComputeWantedMip(uint32_t width, uint32_t height, uint32_t mipLevels, float screenSize);
+
+    static const uint64_t DefaultBudget = 128ull * 1024 * 1024;
+    static const uint32_t DefaultMinResidentSize = 64;
+    static const uint32_t DefaultMaxPendingLoads = 4;
+    static const uint32_t NoMip = 0xFFFFFFFF;
+
+private:
+    struct Entry
+    {
+        TextureCacheId Id = InvalidTextureCacheId;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        std::vector<uint64_t> Bytes;  // 以第 i 级为第 0 级时的总字节数（第 i 级及更粗的各级之和）
+        std::vector<bool> ValidTop;   // 第 i 级能否作为第 0 级
+        uint32_t MinMip = 0;          // 最低驻留
+        uint32_t ResidentMip = 0;
+        uint32_t PendingMip = NoMip;  // 在途请求的级
+        uint32_t TargetMip = 0;       // 最近一次 Update 分配的级
+        uint64_t LastUsedFrame = 0;   // 0 表示从未被报告使用
+        float ScreenSize = 0.0f;      // LastUsedFrame 那一帧报告的最大投影尺寸
+        bool Failed = false;
+    };
+
+    // mip 不能作为第 0 级时换成更精细的最近一级（第 0 级总是可以）
+    static uint32_t ClampToValid(const Entry& entry, uint32_t mip);
+    // 从 coarsest 换到更精细的级、多用的字节不超过 remaining 时，最精细能到哪一级（不超过 finest），并扣掉多用的字节
+    static uint32_t FitMip(const Entry& entry, uint32_t finest, uint32_t coarsest, uint64_t& remaining);
+    // 优先级：本帧可见在前，再按最近使用、投影尺寸、id
+    bool HasPriority(const Entry& a, const Entry& b) const;
+
+private:
+    uint64_t m_budget = DefaultBudget;
+    uint32_t m_minResidentSize = DefaultMinResidentSize;
+    uint32_t m_maxPendingLoads = DefaultMaxPendingLoads;
+    uint64_t m_frame = 1;
+
+    std::unordered_map<TextureCacheId, Entry> m_entries;
+    std::vector<Entry*> m_order;      // Update 的临时排序，避免每帧分配
+
+    uint32_t m_pendingLoads = 0;
+    uint32_t m_lastVisible = 0;
+    uint64_t m_lastTargetBytes = 0;
+    uint64_t m_loads = 0;
+    uint64_t m_evictions = 0;
+};
@@ -0,0 +1,245 @@
+#include "SelfTest.h"
+#include "TextureStreamer.h"
+#include <algorithm>
+
+// ============================================================================
+// TextureStreamer：确定性模拟——需要的级、BC 第 0 级、预算优先级、LRU 淘汰、在途上限与取代、重放
+// ============================================================================
+namespace
+{
+    // 以第 first 级为第 0 级时整条链的字节数
+    uint64_t ChainBytes(TextureFormat format, uint32_t width, uint32_t height, uint32_t levels, uint32_t first)
+    {
+        uint64_t bytes = 0;
+        for (uint32_t i = first; i < levels; ++i)
+        {
+            const uint32_t w = (std::max)(1u, width >> i);
+            const uint32_t h = (std::max)(1u, height >> i);
+            bytes += (uint64_t)GetRowPitch(format, w) * GetRowCount(format, h);
+        }
+        return bytes;
+    }
+
+    struct Usage
+    {
+        TextureCacheId Id;
+        float ScreenSize;
+    };
+
+    // 模拟一帧：报告使用、Update；complete 时请求立即完成
+    void RunFrame(TextureStreamer& streamer, uint64_t frame, std::initializer_list<Usage> usage,
+        std::vector<TextureStreamRequest>& requests, bool complete = true)
+    {
+        streamer.BeginFrame(frame);
+        for (const Usage& u : usage)
+        {
+            streamer.ReportUsage(u.Id, u.ScreenSize);
+        }
+        requests.clear();
+        streamer.Update(requests);
+        if (complete)
+        {
+            for (const TextureStreamRequest& request : requests)
+            {
+                streamer.OnLoaded(request.Id, request.Mip);
+            }
+        }
+    }
+
+    bool IsRequest(const TextureStreamRequest& request, TextureCacheId id, uint32_t mip)
+    {
+        return request.Id == id && request.Mip == mip && !request.Cancel;
+    }
+
+    // 20 张纹理、伪随机使用 200 帧，每两个请求完成一个；记录请求序列与预算是否被超出
+    std::vector<uint32_t> SimulateRandomUsage(bool& overBudget)
+    {
+        TextureStreamer streamer;
+        streamer.SetBudget(3u << 20);
+        for (TextureCacheId id = 1; id <= 20; ++id)
+        {
+            streamer.Register(id, TextureFormat::BC1, 1024 >> (id % 3), 1024, id % 3 ? 10 : 11, 4);
+        }
+
+        std::vector<uint32_t> log;
+        std::vector<TextureStreamRequest> requests;
+        uint32_t seed = 1;
+        overBudget = false;
+        for (uint64_t frame = 1; frame < 200; ++frame)
+        {
+            streamer.BeginFrame(frame);
+            for (int k = 0; k < 8; ++k)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                streamer.ReportUsage(1 + (seed >> 8) % 20, (float)((seed >> 16) % 1200));
+            }
+            requests.clear();
+            streamer.Update(requests);
+            for (size_t i = 0; i < requests.size(); ++i)
+            {
+                log.push_back(requests[i].Id * 1000 + requests[i].Mip * 10 + (requests[i].Cancel ? 1 : 0));
+                if (i % 2 == 0)
+                {
+                    streamer.OnLoaded(requests[i].Id, requests[i].Mip);
+                }
+            }
+            overBudget |= streamer.GetStats().TargetBytes > streamer.GetBudget();
+        }
+        return log;
+    }
+}
+
+void TestTextureStreamer(SelfTestContext& ctx)
+{
+    // 需要的级：长边仍不小于投影尺寸的最粗一级，夹在链内
+    SELF_CHECK(ctx, TextureStreamer::ComputeWantedMip(1024, 1024, 11, 300.0f) == 1);
+    SELF_CHECK(ctx, TextureStreamer::ComputeWantedMip(1024, 1024, 11, 1024.0f) == 0);
+    SELF_CHECK(ctx, TextureStreamer::ComputeWantedMip(1024, 1024, 11, 5000.0f) == 0);
+    SELF_CHECK(ctx, TextureStreamer::ComputeWantedMip(1024, 512, 11, 64.0f) == 4);
+    SELF_CHECK(ctx, TextureStreamer::ComputeWantedMip(1024, 512, 11, 1.0f) == 10);
+    SELF_CHECK(ctx, TextureStreamer::ComputeWantedMip(1024, 512, 11, 0.5f) == 10);
+
+    // 从最低驻留（64 -> 第 4 级）加载到需要的级；预算够时变远不淘汰，预算收紧后不可见的淘汰回最低驻留
+    {
+        const TextureFormat format = TextureFormat::BC1;
+        TextureStreamer streamer;
+        streamer.SetBudget(1ull << 30);
+        streamer.Register(1, format, 1024, 1024, 11, 4);
+        std::vector<TextureStreamRequest> requests;
+
+        RunFrame(streamer, 1, {}, requests);
+        SELF_CHECK(ctx, requests.empty());
+        RunFrame(streamer, 2, { { 1, 300.0f } }, requests);
+        SELF_CHECK(ctx, requests.size() == 1 && IsRequest(requests[0], 1, 1) && requests[0].MaxSize == 512);
+        SELF_CHECK(ctx, streamer.GetResidentMip(1) == 1);
+
+        RunFrame(streamer, 3, { { 1, 10.0f } }, requests);
+        SELF_CHECK(ctx, requests.empty() && streamer.GetResidentMip(1) == 1);
+
+        streamer.SetBudget(ChainBytes(format, 1024, 1024, 11, 4));
+        RunFrame(streamer, 4, {}, requests);
+        SELF_CHECK(ctx, requests.size() == 1 && IsRequest(requests[0], 1, 4));
+        const TextureStreamStats stats = streamer.GetStats();
+        SELF_CHECK(ctx, stats.Loads == 1 && stats.Evictions == 1);
+        SELF_CHECK(ctx, stats.ResidentBytes == ChainBytes(format, 1024, 1024, 11, 4));
+    }
+
+    // BC 第 0 级必须是 4 的倍数：36x36 的第 1、2 级（18、9）不行，最低驻留夹到第 3 级（4），
+    // 需要第 1 级时夹回第 0 级
+    {
+        TextureStreamer streamer;
+        streamer.SetMinResidentSize(8);
+        streamer.SetBudget(0);
+        streamer.Register(7, TextureFormat::BC1, 36, 36, 6, 0);
+        std::vector<TextureStreamRequest> requests;
+        RunFrame(streamer, 1, {}, requests);
+        SELF_CHECK(ctx, requests.size() == 1 && IsRequest(requests[0], 7, 3) && requests[0].MaxSize == 4);
+
+        streamer.SetBudget(1 << 20);
+        RunFrame(streamer, 2, { { 7, 10.0f } }, requests);
+        SELF_CHECK(ctx, requests.size() == 1 && IsRequest(requests[0], 7, 0));
+    }
+
+    // 预算优先级：两张可见纹理只放得下一张完整的，投影大的先拿到第 0 级，另一张拿剩下能放下的最精细级；
+    // 之后大的那张不再可见，它的高 mip 淘汰让给另一张
+    {
+        const TextureFormat format = TextureFormat::BC3;
+        const uint64_t full = ChainBytes(format, 512, 512, 10, 0);
+        TextureStreamer streamer;
+        streamer.SetBudget(full + ChainBytes(format, 512, 512, 10, 2));
+        streamer.Register(1, format, 512, 512, 10, 3);
+        streamer.Register(2, format, 512, 512, 10, 3);
+        std::vector<TextureStreamRequest> requests;
+
+        RunFrame(streamer, 1, { { 1, 400.0f }, { 2, 800.0f } }, requests);
+        SELF_CHECK(ctx, requests.size() == 2 && IsRequest(requests[0], 2, 0) && IsRequest(requests[1], 1, 2));
+        SELF_CHECK(ctx, streamer.GetStats().ResidentBytes <= streamer.GetBudget());
+
+        RunFrame(streamer, 2, { { 1, 800.0f } }, requests);
+        SELF_CHECK(ctx, requests.size() == 2 && IsRequest(requests[0], 2, 2) && IsRequest(requests[1], 1, 0));
+        SELF_CHECK(ctx, streamer.GetResidentMip(1) == 0 && streamer.GetResidentMip(2) == 2);
+        SELF_CHECK(ctx, streamer.GetStats().ResidentBytes <= streamer.GetBudget());
+    }
+
+    // LRU：三张都不可见时，预算每收紧一档，最久未用的先淘汰，最近用过的留住
+    {
+        const TextureFormat format = TextureFormat::RGBA8;
+        const uint64_t full = ChainBytes(format, 256, 256, 9, 0);
+        const uint64_t min = ChainBytes(format, 256, 256, 9, 2);
+        TextureStreamer streamer;
+        streamer.SetBudget(1ull << 30);
+        for (TextureCacheId id = 1; id <= 3; ++id)
+        {
+            streamer.Register(id, format, 256, 256, 9, 2);
+        }
+        std::vector<TextureStreamRequest> requests;
+        RunFrame(streamer, 1, { { 1, 256.0f } }, requests);
+        RunFrame(streamer, 2, { { 2, 256.0f } }, requests);
+        RunFrame(streamer, 3, { { 3, 256.0f } }, requests);
+        SELF_CHECK(ctx, streamer.GetResidentMip(1) == 0 && streamer.GetResidentMip(2) == 0 && streamer.GetResidentMip(3) == 0);
+
+        streamer.SetBudget(2 * full + min);
+        RunFrame(streamer, 4, {}, requests);
+        SELF_CHECK(ctx, requests.size() == 1 && IsRequest(requests[0], 1, 2));
+
+        streamer.SetBudget(full + 2 * min);
+        RunFrame(streamer, 5, {}, requests);
+        SELF_CHECK(ctx, requests.size() == 1 && IsRequest(requests[0], 2, 2));
+        SELF_CHECK(ctx, streamer.GetResidentMip(3) == 0);
+    }
+
+    // 在途上限与取代（请求不立即完成）
+    {
+        const TextureFormat format = TextureFormat::BC1;
+        TextureStreamer streamer;
+        streamer.SetBudget(1ull << 30);
+        streamer.SetMaxPendingLoads(2);
+        for (TextureCacheId id = 1; id <= 4; ++id)
+        {
+            streamer.Register(id, format, 1024, 1024, 11, 4);
+        }
+        std::vector<TextureStreamRequest> requests;
+
+        // 只发优先级最高的两个
+        RunFrame(streamer, 1, { { 1, 100.0f }, { 2, 200.0f }, { 3, 300.0f }, { 4, 1000.0f } }, requests, false);
+        SELF_CHECK(ctx, requests.size() == 2 && requests[0].Id == 4 && requests[1].Id == 3);
+        SELF_CHECK(ctx, streamer.GetStats().PendingLoads == 2);
+
+        // 同样的输入不重复请求
+        RunFrame(streamer, 2, { { 1, 100.0f }, { 2, 200.0f }, { 3, 300.0f }, { 4, 1000.0f } }, requests, false);
+        SELF_CHECK(ctx, requests.empty());
+
+        // 一个完成后空出的名额给下一个
+        streamer.OnLoaded(4, 0);
+        RunFrame(streamer, 3, { { 1, 100.0f }, { 2, 200.0f }, { 3, 300.0f }, { 4, 1000.0f } }, requests, false);
+        SELF_CHECK(ctx, requests.size() == 1 && requests[0].Id == 2);
+
+        // 预算收紧，3 的在途请求超出分配：取消，回到当前驻留的级，在途数不超过上限
+        streamer.SetBudget(ChainBytes(format, 1024, 1024, 11, 0) + 3 * ChainBytes(format, 1024, 1024, 11, 4));
+        RunFrame(streamer, 4, { { 1, 100.0f }, { 2, 200.0f }, { 3, 300.0f }, { 4, 1000.0f } }, requests, false);
+        bool cancelled = false;
+        for (const TextureStreamRequest& request : requests)
+        {
+            cancelled |= request.Id == 3 && request.Mip == 4 && request.Cancel;
+        }
+        SELF_CHECK(ctx, cancelled);
+        SELF_CHECK(ctx, streamer.GetStats().PendingLoads <= 2);
+
+        // 注销在途的纹理归还名额；加载失败的纹理不再请求
+        streamer.Unregister(3);
+        streamer.Unregister(2);
+        SELF_CHECK(ctx, streamer.GetStats().PendingLoads == 0);
+        streamer.OnLoadFailed(1);
+        RunFrame(streamer, 5, { { 1, 1000.0f } }, requests, false);
+        SELF_CHECK(ctx, requests.empty());
+    }
+
+    // 重放：同样的调用序列得到逐个相同的请求，分配始终不超预算
+    {
+        bool overA = false, overB = false;
+        const std::vector<uint32_t> a = SimulateRandomUsage(overA);
+        const std::vector<uint32_t> b = SimulateRandomUsage(overB);
+        SELF_CHECK(ctx, !a.empty() && a == b);
+        SELF_CHECK(ctx, !overA && !overB);
+    }
+}
@@ -0,0 +1,157 @@
+#include "ThreadPool.h"
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+
+// ============================================================================
+// 构造函数和析构函数
+// ============================================================================
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+    if (threadCount == 0)
+    {
+        unsigned hw = std::thread::hardware_concurrency();
+        threadCount = (hw > 1) ? hw - 1 : 1;
+    }
+
+    m_workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+    {
+        m_workers.emplace_back([this, i]()
+        {
+            FrameProfiler::Instance().SetThreadName("Worker " + std::to_string(i));
+            WorkerLoop();
+        });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_taskCv.notify_all();
+
+    for (auto& t : m_workers)
+    {
+        if (t.joinable())
+        {
+            t.join();
+        }
+    }
+}
+
+// ============================================================================
+// 任务提交
+// ============================================================================
+void ThreadPool::Submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_taskCv.notify_one();
+}
+
+void ThreadPool::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCv.wait(lock, [this]() { return m_tasks.empty() && m_activeTasks == 0; });
+}
+
+void ThreadPool::WorkerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskCv.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            if (m_stopping && m_tasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            ++m_activeTasks;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_activeTasks;
+            if (m_tasks.empty() && m_activeTasks == 0)
+            {
+                m_idleCv.notify_all();
+            }
+        }
+    }
+}
+
+// ============================================================================
+// 并行循环
+// ============================================================================
+void ThreadPool::ParallelFor(size_t count, size_t grain,
+    const std::function<void(size_t begin, size_t end)>& fn)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunkCount = (count + grain - 1) / grain;
+    if (chunkCount == 1 || m_workers.empty())
+    {
+        fn(0, count);
+        return;
+    }
+
+    // 共享状态用 shared_ptr 持有：晚启动的辅助任务可能在本函数返回后才执行
+    struct State
+    {
+        std::atomic<size_t> NextChunk{ 0 };
+        std::atomic<size_t> DoneChunks{ 0 };
+        std::mutex Mutex;
+        std::condition_variable DoneCv;
+    };
+    auto state = std::make_shared<State>();
+
+    auto runChunks = [state, count, grain, chunkCount, &fn]()
+    {
+        for (;;)
+        {
+            size_t chunk = state->NextChunk.fetch_add(1);
+            if (chunk >= chunkCount)
+            {
+                return;
+            }
+
+            size_t begin = chunk * grain;
+            size_t end = std::min(begin + grain, count);
+            fn(begin, end);
+
+            if (state->DoneChunks.fetch_add(1) + 1 == chunkCount)
+            {
+                std::lock_guard<std::mutex> lock(state->Mutex);
+                state->DoneCv.notify_all();
+            }
+        }
+    };
+
+    const size_t helpers = std::min<size_t>(m_workers.size(), chunkCount - 1);
+    for (size_t i = 0; i < helpers; ++i)
+    {
+        // 辅助任务只在还有剩余块时才会调用 fn，此时本函数仍在等待，引用有效
+        Submit(runChunks);
+    }
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(state->Mutex);
+    state->DoneCv.wait(lock, [&]() { return state->DoneChunks.load() == chunkCount; });
+}
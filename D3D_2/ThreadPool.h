@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 简单的工作线程池：异步任务 + 阻塞式 ParallelFor（调用线程也参与执行）
+class ThreadPool
+{
+public:
+    // threadCount 为 0 时取硬件线程数 - 1（至少 1 个）
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned GetWorkerCount() const { return (unsigned)m_workers.size(); }
+
+    // 提交异步任务
+    void Submit(std::function<void()> task);
+
+    // 把 [0, count) 按 grain 切块并行执行 fn(begin, end)，全部完成后返回
+    void ParallelFor(size_t count, size_t grain,
+        const std::function<void(size_t begin, size_t end)>& fn);
+
+    // 等待队列中所有任务执行完毕
+    void WaitIdle();
+
+private:
+    void WorkerLoop();
+
+private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_taskCv;
+    std::condition_variable m_idleCv;
+    unsigned m_activeTasks = 0;
+    bool m_stopping = false;
+};
@@ -42,8 +42,8 @@ namespace
         if (v < 0.0f || v > 1.0f)
         {
             wchar_t msg[128]{};
-            swprintf_s(msg, L"%s  0~1 ֮䡣", name);
-            MessageBoxW(hDlg, msg, L"", MB_OK | MB_ICONWARNING);
+            swprintf_s(msg, L"%s 必须在 0~1 之间。", name);
+            MessageBoxW(hDlg, msg, L"输入错误", MB_OK | MB_ICONWARNING);
             SetFocus(GetDlgItem(hDlg, ctrlId));
             SendDlgItemMessageW(hDlg, ctrlId, EM_SETSEL, 0, -1);
             return false;
@@ -61,9 +61,9 @@ namespace
         }
 
         SendMessageW(hCombo, CB_RESETCONTENT, 0, 0);
-        SendMessageW(hCombo, CB_ADDSTRING, 0, (LPARAM)L"ƽ(Planar)");
-        SendMessageW(hCombo, CB_ADDSTRING, 0, (LPARAM)L"(Cylindrical)");
-        SendMessageW(hCombo, CB_ADDSTRING, 0, (LPARAM)L"(Spherical)");
+        SendMessageW(hCombo, CB_ADDSTRING, 0, (LPARAM)L"平面(Planar)");
+        SendMessageW(hCombo, CB_ADDSTRING, 0, (LPARAM)L"柱面(Cylindrical)");
+        SendMessageW(hCombo, CB_ADDSTRING, 0, (LPARAM)L"球面(Spherical)");
 
         int curSel = 0;
         if (obj)
@@ -87,9 +87,9 @@ namespace
         }
 
         SendMessageW(hCombo, CB_RESETCONTENT, 0, 0);
-        SendMessageW(hCombo, CB_ADDSTRING, 0, (LPARAM)L"̸(Checker)");
-        SendMessageW(hCombo, CB_ADDSTRING, 0, (LPARAM)L"(Stripes)");
-        SendMessageW(hCombo, CB_ADDSTRING, 0, (LPARAM)L"ͼƬ(ռλ)");
+        SendMessageW(hCombo, CB_ADDSTRING, 0, (LPARAM)L"棋盘格(Checker)");
+        SendMessageW(hCombo, CB_ADDSTRING, 0, (LPARAM)L"条纹(Stripes)");
+        SendMessageW(hCombo, CB_ADDSTRING, 0, (LPARAM)L"图片(占位)");
 
         int curSel = 0;
         if (obj)
@@ -106,7 +106,7 @@ namespace
 
     void BrowseTextureFile(HWND hDlg)
     {
-        // A ѡļ·棬Դ
+        // A 方案：仅选择文件路径并保存，不负责加载纹理资源
         wchar_t fileBuf[MAX_PATH]{};
 
         OPENFILENAMEW ofn{};
@@ -115,8 +115,8 @@ namespace
         ofn.lpstrFile = fileBuf;
         ofn.nMaxFile = (DWORD)_countof(fileBuf);
 
-        // չɰҪս
-        ofn.lpstrFilter = L"ļ (*.*)\0*.*\0";
+        // 不限制扩展名（后续你可按需要收紧）
+        ofn.lpstrFilter = L"所有文件 (*.*)\0*.*\0";
         ofn.nFilterIndex = 1;
         ofn.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST | OFN_NOCHANGEDIR;
 
@@ -147,7 +147,7 @@ namespace
                 return TRUE;
             }
 
-            // 任
+            // 变换
             XMFLOAT3 pos = state->Obj->GetPosition();
             XMFLOAT3 rotRad = state->Obj->GetRotation();
             float scale = state->Obj->GetScale();
@@ -167,7 +167,7 @@ namespace
 
             SetDlgItemFloat(hDlg, IDC_SCALE, scale);
 
-            // ʣ1+2+3
+            // 材质（1+2+3）
             const auto& mat = state->Obj->GetMaterial();
             SetDlgItemFloat(hDlg, IDC_MAT_R, mat.BaseColor.x);
             SetDlgItemFloat(hDlg, IDC_MAT_G, mat.BaseColor.y);
@@ -175,7 +175,7 @@ namespace
             SetDlgItemFloat(hDlg, IDC_MAT_SPECULAR, mat.SpecularStrength);
             SetDlgItemFloat(hDlg, IDC_MAT_SHININESS, mat.Shininess);
 
-            // A · + ѡӳ䷽ʽ
+            // 纹理（A 方案：仅保存路径 + 选择映射方式）
             SetDlgItemTextW(hDlg, IDC_TEX_PATH, state->Obj->GetTexturePath().c_str());
             InitTextureMappingCombo(hDlg, state->Obj);
             InitTextureStyleCombo(hDlg, state->Obj);
@@ -199,12 +199,12 @@ namespace
                     return TRUE;
                 }
 
-                // 任
+                // 变换输入
                 float px, py, pz;
                 float rxDeg, ryDeg, rzDeg;
                 float scale;
 
-                // 
+                // 材质输入
                 float r, g, b;
                 float specularStrength;
                 float shininess;
@@ -222,13 +222,13 @@ namespace
                     !TryGetDlgItemFloat(hDlg, IDC_MAT_SPECULAR, specularStrength) ||
                     !TryGetDlgItemFloat(hDlg, IDC_MAT_SHININESS, shininess))
                 {
-                    MessageBoxW(hDlg, L"Ч֡", L"", MB_OK | MB_ICONWARNING);
+                    MessageBoxW(hDlg, L"请输入有效数字。", L"输入错误", MB_OK | MB_ICONWARNING);
                     return TRUE;
                 }
 
                 if (scale <= 0.0f)
                 {
-                    MessageBoxW(hDlg, L"ű 0", L"", MB_OK | MB_ICONWARNING);
+                    MessageBoxW(hDlg, L"缩放必须大于 0。", L"输入错误", MB_OK | MB_ICONWARNING);
                     return TRUE;
                 }
 
@@ -242,18 +242,18 @@ namespace
 
                 if (shininess < 1.0f)
                 {
-                    MessageBoxW(hDlg, L"Shininess  >= 1", L"", MB_OK | MB_ICONWARNING);
+                    MessageBoxW(hDlg, L"Shininess 必须 >= 1。", L"输入错误", MB_OK | MB_ICONWARNING);
                     SetFocus(GetDlgItem(hDlg, IDC_MAT_SHININESS));
                     SendDlgItemMessageW(hDlg, IDC_MAT_SHININESS, EM_SETSEL, 0, -1);
                     return TRUE;
                 }
 
-                // ·A ַ
+                // 纹理路径（A 方案：保存字符串）
                 wchar_t texPath[512]{};
                 GetDlgItemTextW(hDlg, IDC_TEX_PATH, texPath, (int)_countof(texPath));
                 state->Obj->SetTexturePath(texPath);
 
-                // ӳ䷽ʽ
+                // 纹理映射方式
                 int mappingIndex = 0;
                 HWND hCombo = GetDlgItem(hDlg, IDC_TEX_MAPPING);
                 if (hCombo)
@@ -278,7 +278,7 @@ namespace
                 }
                 state->Obj->SetTextureStyle((TextureStyle)styleIndex);
 
-                // Ӧñ任
+                // 应用变换
                 XMFLOAT3 pos(px, py, pz);
                 XMFLOAT3 rotRad(
                     XMConvertToRadians(rxDeg),
@@ -289,7 +289,7 @@ namespace
                 state->Obj->SetRotation(rotRad);
                 state->Obj->SetScale(scale);
 
-                // Ӧò
+                // 应用材质
                 Material mat = state->Obj->GetMaterial();
                 mat.BaseColor = XMFLOAT3(r, g, b);
                 mat.SpecularStrength = specularStrength;
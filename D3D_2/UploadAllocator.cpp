@@ -0,0 +1,173 @@
+#include "UploadAllocator.h"
+
+// ============================================================================
+// 构造函数和析构函数
+// ============================================================================
+LinearUploadAllocator::LinearUploadAllocator(IUploadPageSource& source, uint64_t pageSize)
+    : m_source(source)
+    , m_pageSize(pageSize > 0 ? pageSize : 1)
+{
+}
+
+LinearUploadAllocator::~LinearUploadAllocator()
+{
+    ReleaseAll();
+}
+
+// ============================================================================
+// 帧边界
+// ============================================================================
+void LinearUploadAllocator::BeginFrame(uint64_t completedFenceValue)
+{
+    while (!m_retiredPages.empty() && m_retiredPages.front().FenceValue <= completedFenceValue)
+    {
+        uint32_t index = m_retiredPages.front().PageIndex;
+        m_retiredPages.pop_front();
+
+        if (m_pages[index].Large)
+        {
+            DestroyEntry(index);
+        }
+        else
+        {
+            m_freePages.push_back(index);
+        }
+    }
+
+    m_frameBytes = 0;
+}
+
+void LinearUploadAllocator::EndFrame(uint64_t fenceValue)
+{
+    for (uint32_t index : m_framePages)
+    {
+        m_retiredPages.push_back({ fenceValue, index });
+    }
+    m_framePages.clear();
+    m_currentPage = NoPage;
+    m_offset = 0;
+
+    if (m_frameBytes > m_peakFrameBytes)
+    {
+        m_peakFrameBytes = m_frameBytes;
+    }
+}
+
+// ============================================================================
+// 分配
+// ============================================================================
+bool LinearUploadAllocator::Allocate(uint64_t size, uint64_t alignment, UploadAllocation& out)
+{
+    if (alignment == 0)
+    {
+        alignment = 1;
+    }
+
+    uint64_t aligned = (m_offset + alignment - 1) & ~(alignment - 1);
+    if (m_currentPage == NoPage || aligned + size > m_pages[m_currentPage].Page.Size)
+    {
+        // 当前页放不下：普通请求换一整页，超大请求单独建页（不成为当前页）
+        uint32_t index = NoPage;
+        if (!AcquirePage(size, index))
+        {
+            return false;
+        }
+        m_framePages.push_back(index);
+
+        if (m_pages[index].Large)
+        {
+            const UploadPage& page = m_pages[index].Page;
+            out.Cpu = page.CpuBase;
+            out.Gpu = page.GpuBase;
+            out.Size = size;
+            out.PageHandle = page.Handle;
+            out.PageOffset = 0;
+            m_frameBytes += size;
+            return true;
+        }
+
+        m_currentPage = index;
+        m_offset = 0;
+        aligned = 0;
+    }
+
+    const UploadPage& page = m_pages[m_currentPage].Page;
+    out.Cpu = page.CpuBase + aligned;
+    out.Gpu = page.GpuBase + aligned;
+    out.Size = size;
+    out.PageHandle = page.Handle;
+    out.PageOffset = aligned;
+
+    m_frameBytes += (aligned + size) - m_offset;
+    m_offset = aligned + size;
+    return true;
+}
+
+bool LinearUploadAllocator::AcquirePage(uint64_t minSize, uint32_t& outIndex)
+{
+    const bool large = minSize > m_pageSize;
+    if (!large && !m_freePages.empty())
+    {
+        outIndex = m_freePages.back();
+        m_freePages.pop_back();
+        return true;
+    }
+
+    UploadPage page;
+    if (!m_source.CreatePage(large ? minSize : m_pageSize, page))
+    {
+        return false;
+    }
+
+    uint32_t index;
+    if (!m_deadSlots.empty())
+    {
+        index = m_deadSlots.back();
+        m_deadSlots.pop_back();
+    }
+    else
+    {
+        index = (uint32_t)m_pages.size();
+        m_pages.emplace_back();
+    }
+
+    PageEntry& entry = m_pages[index];
+    entry.Page = page;
+    entry.Large = large;
+    entry.Alive = true;
+    outIndex = index;
+    return true;
+}
+
+// ============================================================================
+// 释放
+// ============================================================================
+void LinearUploadAllocator::DestroyEntry(uint32_t index)
+{
+    PageEntry& entry = m_pages[index];
+    if (!entry.Alive)
+    {
+        return;
+    }
+
+    m_source.DestroyPage(entry.Page);
+    entry = PageEntry{};
+    m_deadSlots.push_back(index);
+}
+
+void LinearUploadAllocator::ReleaseAll()
+{
+    for (uint32_t i = 0; i < (uint32_t)m_pages.size(); ++i)
+    {
+        DestroyEntry(i);
+    }
+
+    m_pages.clear();
+    m_freePages.clear();
+    m_deadSlots.clear();
+    m_framePages.clear();
+    m_retiredPages.clear();
+    m_currentPage = NoPage;
+    m_offset = 0;
+    m_frameBytes = 0;
+}
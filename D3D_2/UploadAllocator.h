@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// 一块持久映射的上传内存页
+struct UploadPage
+{
+    uint8_t* CpuBase = nullptr;
+    uint64_t GpuBase = 0;
+    uint64_t Size = 0;
+    void* Handle = nullptr;       // 页来源自己的标识（例如 ID3D12Resource*）
+};
+
+// 页来源：D3D12 实现见 D3D12UploadPageSource，也可以用普通内存模拟，在没有 GPU 时检查分配与回收
+class IUploadPageSource
+{
+public:
+    virtual ~IUploadPageSource() = default;
+
+    virtual bool CreatePage(uint64_t size, UploadPage& out) = 0;
+    virtual void DestroyPage(const UploadPage& page) = 0;
+};
+
+// 一次分配的结果：CPU 写入地址与对应的 GPU 虚拟地址。
+// 按资源 + 偏移寻址的拷贝（如纹理的 CopyTextureRegion）用所在页的 Handle 与页内偏移
+struct UploadAllocation
+{
+    uint8_t* Cpu = nullptr;
+    uint64_t Gpu = 0;
+    uint64_t Size = 0;
+    void* PageHandle = nullptr;   // 所在页的 UploadPage::Handle
+    uint64_t PageOffset = 0;
+};
+
+// 每帧线性上传分配器：在大页上移动指针分配，不逐个释放。
+// 一帧内用过的页在 EndFrame 时挂上该帧的栅栏值，栅栏完成后由 BeginFrame 回收复用；
+// 当前页不够时换下一页，超过页大小的请求单独建一页，回收时销毁。
+class LinearUploadAllocator
+{
+public:
+    LinearUploadAllocator(IUploadPageSource& source, uint64_t pageSize);
+    ~LinearUploadAllocator();
+
+    LinearUploadAllocator(const LinearUploadAllocator&) = delete;
+    LinearUploadAllocator& operator=(const LinearUploadAllocator&) = delete;
+
+    // 回收栅栏值 <= completedFenceValue 的页
+    void BeginFrame(uint64_t completedFenceValue);
+
+    // alignment 必须是 2 的幂；页创建失败时返回 false
+    bool Allocate(uint64_t size, uint64_t alignment, UploadAllocation& out);
+
+    // 本帧用过的页在 fenceValue 完成前不会再分配出去
+    void EndFrame(uint64_t fenceValue);
+
+    // GPU 已空闲时调用：销毁全部页
+    void ReleaseAll();
+
+    uint64_t GetPageSize() const { return m_pageSize; }
+    size_t GetPageCount() const { return m_pages.size() - m_deadSlots.size(); }
+    size_t GetFreePageCount() const { return m_freePages.size(); }
+    // 本帧已分配的字节数（含对齐填充）与单帧峰值
+    uint64_t GetFrameBytes() const { return m_frameBytes; }
+    uint64_t GetPeakFrameBytes() const { return m_peakFrameBytes; }
+
+private:
+    static const uint32_t NoPage = 0xFFFFFFFFu;
+
+    struct PageEntry
+    {
+        UploadPage Page;
+        bool Large = false;       // 超大请求专用页，回收时销毁
+        bool Alive = false;
+    };
+
+    struct RetiredPage
+    {
+        uint64_t FenceValue;
+        uint32_t PageIndex;
+    };
+
+    bool AcquirePage(uint64_t minSize, uint32_t& outIndex);
+    void DestroyEntry(uint32_t index);
+
+private:
+    IUploadPageSource& m_source;
+    uint64_t m_pageSize;
+
+    std::vector<PageEntry> m_pages;
+    std::vector<uint32_t> m_freePages;        // 可立即复用的普通页
+    std::vector<uint32_t> m_deadSlots;        // m_pages 中已销毁、可重用的下标
+    std::vector<uint32_t> m_framePages;       // 本帧用过的页
+    std::deque<RetiredPage> m_retiredPages;   // 等待栅栏的页（栅栏值递增）
+
+    uint32_t m_currentPage = NoPage;
+    uint64_t m_offset = 0;
+    uint64_t m_frameBytes = 0;
+    uint64_t m_peakFrameBytes = 0;
+};
@@ -0,0 +1,235 @@
+#include "SelfTest.h"
+#include "UploadAllocator.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+// ============================================================================
+// LinearUploadAllocator：模拟栅栏下的分配、退役与回收
+// ============================================================================
+namespace
+{
+    // 普通内存页，GPU 地址为互不重叠、按 64KB 对齐的假地址（与 D3D12 缓冲一致）
+    class MemoryPageSource : public IUploadPageSource
+    {
+    public:
+        bool CreatePage(uint64_t size, UploadPage& out) override
+        {
+            if (m_failNext)
+            {
+                m_failNext = false;
+                return false;
+            }
+            m_storage.emplace_back(new uint8_t[(size_t)size]);
+            out.CpuBase = m_storage.back().get();
+            out.GpuBase = m_nextGpu;
+            out.Size = size;
+            out.Handle = out.CpuBase;
+            m_nextGpu += (size + 0x1FFFF) & ~0xFFFFull;
+            ++m_live;
+            ++m_created;
+            return true;
+        }
+
+        void DestroyPage(const UploadPage& page) override
+        {
+            for (auto it = m_storage.begin(); it != m_storage.end(); ++it)
+            {
+                if (it->get() == page.Handle)
+                {
+                    m_storage.erase(it);
+                    --m_live;
+                    return;
+                }
+            }
+            ++m_badDestroys;
+        }
+
+        void FailNext() { m_failNext = true; }
+        int GetLive() const { return m_live; }
+        int GetCreated() const { return m_created; }
+        int GetBadDestroys() const { return m_badDestroys; }
+
+    private:
+        std::vector<std::unique_ptr<uint8_t[]>> m_storage;
+        uint64_t m_nextGpu = 0x10000;
+        int m_live = 0;
+        int m_created = 0;
+        int m_badDestroys = 0;
+        bool m_failNext = false;
+    };
+
+    void TestBasicPaging(SelfTestContext& ctx)
+    {
+        MemoryPageSource source;
+        SimulatedFence fence;
+        {
+            LinearUploadAllocator allocator(source, 4096);
+            UploadAllocation a, b, c, large;
+
+            allocator.BeginFrame(fence.GetCompletedValue());
+            SELF_CHECK(ctx, allocator.Allocate(100, 256, a) && a.Gpu % 256 == 0 && a.Size == 100);
+            SELF_CHECK(ctx, allocator.Allocate(10, 256, b) && b.Gpu == a.Gpu + 256 && b.Cpu == a.Cpu + 256);
+            // 当前页放不下：换新页
+            SELF_CHECK(ctx, allocator.Allocate(4000, 16, c) && source.GetLive() == 2);
+            // 超过页大小：单独建页，不影响当前页
+            SELF_CHECK(ctx, allocator.Allocate(10000, 256, large) && large.Size == 10000 && source.GetLive() == 3);
+            SELF_CHECK(ctx, allocator.Allocate(16, 16, b) && b.Gpu == c.Gpu + 4000);
+            // 页标识与页内偏移（MemoryPageSource 的 Handle 就是页的 CPU 基址）
+            SELF_CHECK(ctx, b.PageHandle == c.PageHandle && b.PageOffset == 4000);
+            SELF_CHECK(ctx, b.Cpu == static_cast<uint8_t*>(b.PageHandle) + b.PageOffset);
+            SELF_CHECK(ctx, large.PageHandle == large.Cpu && large.PageOffset == 0);
+            allocator.EndFrame(fence.Signal());
+
+            // GPU 还没完成上一帧：不能复用，再建一页
+            allocator.BeginFrame(fence.GetCompletedValue());
+            SELF_CHECK(ctx, allocator.Allocate(100, 256, a) && source.GetLive() == 4);
+            allocator.EndFrame(fence.Signal());
+
+            // 第一帧完成：两张普通页回到空闲表，超大页销毁
+            fence.Complete(1);
+            allocator.BeginFrame(fence.GetCompletedValue());
+            SELF_CHECK(ctx, source.GetLive() == 3 && allocator.GetFreePageCount() == 2);
+            SELF_CHECK(ctx, allocator.Allocate(100, 256, a) && source.GetCreated() == 4);
+            SELF_CHECK(ctx, allocator.GetFrameBytes() == 100);
+            allocator.EndFrame(fence.Signal());
+            SELF_CHECK(ctx, allocator.GetPeakFrameBytes() >= 10000 + 4000 + 256 + 10);
+
+            // 页创建失败时分配失败，之后恢复正常
+            allocator.BeginFrame(fence.GetCompletedValue());
+            source.FailNext();
+            SELF_CHECK(ctx, !allocator.Allocate(100000, 16, large));
+            SELF_CHECK(ctx, allocator.Allocate(100000, 16, large));
+            allocator.EndFrame(fence.Signal());
+        }
+        // 析构时销毁全部页
+        SELF_CHECK(ctx, source.GetLive() == 0 && source.GetBadDestroys() == 0);
+    }
+
+    struct LiveAllocation
+    {
+        uint64_t Gpu;
+        uint64_t Size;
+        uint64_t FenceValue;      // 0 表示本帧
+    };
+
+    // GPU 随机落后 0~3 帧、随机大小与对齐：分配从不与未完成帧的分配重叠，页数有上界
+    void TestRandomFences(SelfTestContext& ctx)
+    {
+        MemoryPageSource source;
+        SimulatedFence fence;
+        std::mt19937 rng(3);
+        bool aligned = true, disjoint = true;
+        {
+            LinearUploadAllocator allocator(source, 64 * 1024);
+            std::vector<LiveAllocation> live;
+
+            for (int frame = 0; frame < 300; ++frame)
+            {
+                const uint64_t lag = rng() % 4;
+                const uint64_t last = fence.GetLastSignaledValue();
+                fence.Complete(last > lag ? last - lag : 0);
+                const uint64_t completed = fence.GetCompletedValue();
+                allocator.BeginFrame(completed);
+
+                size_t keep = 0;
+                for (const LiveAllocation& allocation : live)
+                {
+                    if (allocation.FenceValue > completed)
+                    {
+                        live[keep++] = allocation;
+                    }
+                }
+                live.resize(keep);
+                const size_t retired = live.size();
+
+                for (uint32_t n = rng() % 200; n > 0; --n)
+                {
+                    const uint64_t size = (rng() % 50 == 0) ? 70000 + rng() % 1000 : 1 + rng() % 2000;
+                    const uint64_t alignment = 1ull << (rng() % 9);
+                    UploadAllocation out;
+                    if (!allocator.Allocate(size, alignment, out))
+                    {
+                        aligned = false;
+                        continue;
+                    }
+                    aligned &= out.Gpu % alignment == 0 && out.Size == size;
+                    for (const LiveAllocation& other : live)
+                    {
+                        disjoint &= out.Gpu + size <= other.Gpu || other.Gpu + other.Size <= out.Gpu;
+                    }
+                    live.push_back(LiveAllocation{ out.Gpu, size, 0 });
+                }
+
+                const uint64_t value = fence.Signal();
+                for (size_t i = retired; i < live.size(); ++i)
+                {
+                    live[i].FenceValue = value;
+                }
+                allocator.EndFrame(value);
+            }
+
+            // 最多 4 帧在途，每帧不超过 200 * 2000 字节 + 对齐：普通页数有上界
+            SELF_CHECK(ctx, allocator.GetPageCount() <= 4 * (200 * 2300 / (64 * 1024) + 2) + 4 * 8);
+        }
+        SELF_CHECK(ctx, aligned && disjoint);
+        SELF_CHECK(ctx, source.GetLive() == 0 && source.GetBadDestroys() == 0);
+    }
+}
+
+void TestUploadAllocator(SelfTestContext& ctx)
+{
+    TestBasicPaging(ctx);
+    TestRandomFences(ctx);
+}
+
+// ============================================================================
+// 基准：每帧 allocationsPerFrame 次常量大小的分配，GPU 落后两帧
+// ============================================================================
+bool RunUploadAllocatorBenchmark(int allocationsPerFrame, int frameCount)
+{
+    if (allocationsPerFrame <= 0 || frameCount <= 0)
+    {
+        return false;
+    }
+
+    MemoryPageSource source;
+    SimulatedFence fence;
+    uint64_t allocations = 0;
+    double seconds = 0.0;
+    size_t pages = 0;
+    uint64_t peak = 0;
+    {
+        LinearUploadAllocator allocator(source, 2 * 1024 * 1024);
+        UploadAllocation out;
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frameCount; ++frame)
+        {
+            const uint64_t last = fence.GetLastSignaledValue();
+            fence.Complete(last > 2 ? last - 2 : 0);
+            allocator.BeginFrame(fence.GetCompletedValue());
+            for (int i = 0; i < allocationsPerFrame; ++i)
+            {
+                // 对象常量：256 字节对齐的小块
+                if (!allocator.Allocate(112, 256, out))
+                {
+                    return false;
+                }
+                out.Cpu[0] = (uint8_t)i;
+                ++allocations;
+            }
+            allocator.EndFrame(fence.Signal());
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        pages = allocator.GetPageCount();
+        peak = allocator.GetPeakFrameBytes();
+    }
+
+    printf("Upload allocator benchmark: %d allocations/frame, %d frames\n"
+        "  %.1f M allocations/s (%.1f ns each), %zu pages of 2 MB, peak %.2f MB/frame, %d pages created\n",
+        allocationsPerFrame, frameCount, allocations / seconds / 1e6, seconds * 1e9 / allocations,
+        pages, peak / (1024.0 * 1024.0), source.GetCreated());
+    fflush(stdout);
+    return true;
+}
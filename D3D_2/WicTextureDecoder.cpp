@@ -0,0 +1,129 @@
+#include "WicTextureDecoder.h"
+
+#pragma comment(lib, "windowscodecs.lib")
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+    // 线程退出时配对 CoUninitialize
+    struct ComApartment
+    {
+        bool Entered = false;
+        bool Failed = false;
+
+        ~ComApartment()
+        {
+            if (Entered)
+            {
+                CoUninitialize();
+            }
+        }
+    };
+}
+
+bool WicTextureDecoder::EnterComApartment()
+{
+    thread_local ComApartment apartment;
+    if (!apartment.Entered && !apartment.Failed)
+    {
+        HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+        if (SUCCEEDED(hr))
+        {
+            apartment.Entered = true;
+        }
+        else if (hr != RPC_E_CHANGED_MODE)
+        {
+            // 线程已在 STA 中时（RPC_E_CHANGED_MODE）照常可用，只是不由我们配对释放
+            apartment.Failed = true;
+        }
+    }
+    return !apartment.Failed;
+}
+
+IWICImagingFactory* WicTextureDecoder::GetFactory()
+{
+    std::call_once(m_factoryOnce, [this]()
+    {
+        CoCreateInstance(CLSID_WICImagingFactory2, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&m_factory));
+    });
+    return m_factory.Get();
+}
+
+bool WicTextureDecoder::Decode(const uint8_t* data, size_t size, DecodedImage& out)
+{
+    if (!EnterComApartment())
+    {
+        return false;
+    }
+
+    IWICImagingFactory* wicFactory = GetFactory();
+    if (!wicFactory)
+    {
+        return false;
+    }
+
+    if (size == 0 || size > 0x7FFFFFFF)
+    {
+        return false;
+    }
+
+    // WIC 的内存流不拷贝数据：data 在解码期间必须有效
+    ComPtr<IWICStream> stream;
+    HRESULT hr = wicFactory->CreateStream(&stream);
+    if (FAILED(hr))
+    {
+        return false;
+    }
+    hr = stream->InitializeFromMemory(const_cast<BYTE*>(data), static_cast<DWORD>(size));
+    if (FAILED(hr))
+    {
+        return false;
+    }
+
+    ComPtr<IWICBitmapDecoder> decoder;
+    hr = wicFactory->CreateDecoderFromStream(stream.Get(), nullptr, WICDecodeMetadataCacheOnLoad, &decoder);
+    if (FAILED(hr))
+    {
+        return false;
+    }
+
+    ComPtr<IWICBitmapFrameDecode> frame;
+    hr = decoder->GetFrame(0, &frame);
+    if (FAILED(hr))
+    {
+        return false;
+    }
+
+    UINT frameWidth = 0, frameHeight = 0;
+    frame->GetSize(&frameWidth, &frameHeight);
+    if (frameWidth == 0 || frameHeight == 0)
+    {
+        return false;
+    }
+
+    ComPtr<IWICFormatConverter> converter;
+    hr = wicFactory->CreateFormatConverter(&converter);
+    if (FAILED(hr))
+    {
+        return false;
+    }
+
+    hr = converter->Initialize(
+        frame.Get(),
+        GUID_WICPixelFormat32bppRGBA,
+        WICBitmapDitherTypeNone,
+        nullptr,
+        0.0,
+        WICBitmapPaletteTypeCustom);
+    if (FAILED(hr))
+    {
+        return false;
+    }
+
+    out.Width = frameWidth;
+    out.Height = frameHeight;
+    out.Pixels.resize((size_t)frameWidth * frameHeight * 4);
+    hr = converter->CopyPixels(nullptr, frameWidth * 4, static_cast<UINT>(out.Pixels.size()), out.Pixels.data());
+    return SUCCEEDED(hr);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl/client.h>
+#include <wincodec.h>
+#include <mutex>
+#include "TextureLoader.h"
+
+// ITextureDecoder 的 WIC 实现：从内存中的文件内容解码任意格式并转换为 RGBA8。
+// 工厂只创建一次，各线程共享（WIC 工厂是线程安全的）；每个调用线程第一次解码时进入 MTA，
+// 线程退出时离开
+class WicTextureDecoder : public ITextureDecoder
+{
+public:
+    bool Decode(const uint8_t* data, size_t size, DecodedImage& out) override;
+
+private:
+    static bool EnterComApartment();
+    IWICImagingFactory* GetFactory();
+
+private:
+    std::once_flag m_factoryOnce;
+    Microsoft::WRL::ComPtr<IWICImagingFactory> m_factory;
+};